@@ -0,0 +1,1059 @@
+/*
+ * Microbenchmarks for every vector, matrix and quaternion function and
+ * for the dispatched batch kernels.
+ *
+ * Every benchmark runs over n elements whose inputs and output together
+ * fill a working set of --hot-kib (stays in L1/L2) or --cold-mib (larger
+ * than the last level cache). The single element functions (and their
+ * value versions from vector_value.h) are called once per element, the
+ * batch functions once per pass over all n elements. The dispatched ones
+ * run once for every instruction set the CPU supports (smath_set_isa).
+ *
+ * One repetition runs enough passes to last --min-time-ms, after a warmup
+ * the median and p99 of --reps repetitions are written as JSON to stdout
+ * (or --out), a short summary goes to stderr.
+ *
+ * The _parallel functions run on the built-in pool with --threads threads
+ * (parallel.h), 0 starts one per core.
+ *
+ *   bench [--filter name] [--reps n] [--min-time-ms ms] [--hot-kib n]
+ *         [--cold-mib n] [--no-cold] [--threads n] [--out file] [--list]
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "../include/smath.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <malloc.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define BENCH_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_TSC 1
+#endif
+
+
+/** @brief Inputs and output of one benchmark, every buffer holds at least n elements of its type. */
+typedef struct bench_args {
+        void *a, *b, *out;
+        f32 *t;
+        size_t n;
+
+        /** @brief Structure of arrays views over a, b and out. */
+        vec3_soa a3, b3, o3;
+        vec4_soa a4, b4, o4;
+} bench_args;
+
+/** @brief What a benchmark calls, the batch kinds process all n elements in one call. */
+typedef enum bench_kind {
+        BENCH_SINGLE = 0,       /**< a pointer function of vector/matrix/quat.h */
+        BENCH_VALUE,            /**< a value function of vector_value.h */
+        BENCH_ARRAY,            /**< a batch function of vector_value.h */
+        BENCH_DISPATCH          /**< a dispatched batch kernel */
+} bench_kind;
+
+static const char *bench_kind_names[] = { "single", "value", "array", "batch" };
+
+/** @brief One benchmark, run does a single pass over the n elements. */
+typedef struct bench {
+        const char *name;
+
+        /** @brief Bytes of input and output per element, sets n for a working set. */
+        size_t bytes;
+
+        bench_kind kind;
+
+        void (*run)(const bench_args *x);
+} bench;
+
+/** @brief The measurements of one benchmark in one configuration. */
+typedef struct bench_result {
+        double ns_median, ns_p99, ns_min;
+        double tsc_median;
+        size_t passes;
+} bench_result;
+
+
+/** @brief Written after every repetition so the passes can not be optimized away. */
+static volatile f32 bench_sink;
+
+/** @brief The frustum of the culling benchmarks, the -1 to 1 cube, which cuts through the inputs. */
+static frustum bench_frustum;
+
+/** @brief The ray, box and sphere of the ray benchmarks, they cut through the inputs. */
+static const ray bench_ray = { { 0.1f, -0.2f, -2.0f }, { 0.05f, 0.1f, 1.0f } };
+static const aabb bench_box = { { -0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, 0.5f } };
+static const sphere bench_sphere = { { 0.0f, 0.0f, 0.0f }, 0.5f };
+static size_t bench_hit;
+
+/** @brief The hierarchy of the build benchmark, built over the boxes of a and freed again every pass. */
+static smath_bvh bench_bvh;
+
+/** @brief The grid of the build benchmark, recreated for every working set so the buckets match n. */
+static smath_grid bench_grid;
+
+static bool bench_grid_build(const bench_args *x) {
+        if (bench_grid.capacity != x->n) {
+                smath_grid_destroy(&bench_grid);
+                smath_grid_create(&bench_grid, 0.1f, x->n);
+        }
+        return smath_grid_build(&bench_grid, x->a, x->n);
+}
+
+/** @brief The palettes of the skinning benchmarks and the 4 influences of every vertex, 4 random bones each. */
+#define BENCH_BONES 64
+static mat3x4 bench_palette[BENCH_BONES];
+static dual_quat bench_dual_palette[BENCH_BONES];
+static skin_influence *bench_influences;
+
+
+/*
+ * The single element functions, grouped by signature. Every X(fn, ...)
+ * generates a bench_<fn> that calls fn once for each element.
+ */
+
+/** @brief void fn(T *v) */
+#define BENCH_INPLACE1(X) \
+        X(vec2_square_root, vec2) \
+        X(vec2_normalize, vec2) \
+        X(vec3_square_root, vec3) \
+        X(vec3_normalize, vec3) \
+        X(vec3_fast_normalize, vec3) \
+        X(vec4_square_root, vec4) \
+        X(vec4_normalize, vec4) \
+        X(vec4_fast_normalize, vec4) \
+        BENCH_SSE_INPLACE1(X)
+
+/** @brief void fn(T *v, const T *v1) */
+#define BENCH_INPLACE2(X) \
+        X(vec2_add, vec2) \
+        X(vec2_sub, vec2) \
+        X(vec3_add, vec3) \
+        X(vec3_sub, vec3) \
+        X(vec4_add, vec4) \
+        X(vec4_sub, vec4) \
+        BENCH_SSE_INPLACE2(X)
+
+/** @brief void fn(T *v, f32 s) */
+#define BENCH_INPLACE_S(X) \
+        X(vec2_scalar_mult, vec2) \
+        X(vec2_scalar_div, vec2) \
+        X(vec3_scalar_mult, vec3) \
+        X(vec3_scalar_div, vec3) \
+        X(vec3_fast_scalar_div, vec3) \
+        X(vec4_scalar_mult, vec4) \
+        X(vec4_scalar_div, vec4) \
+        X(vec4_fast_scalar_div, vec4) \
+        BENCH_SSE_INPLACE_S(X)
+
+/** @brief f32 fn(const T *v) */
+#define BENCH_REDUCE1(X) \
+        X(vec2_magnitude, vec2) \
+        X(vec3_magnitude, vec3) \
+        X(vec4_magnitude, vec4) \
+        X(mat2x2_determinant, mat2x2) \
+        X(mat3x3_determinant, mat3x3) \
+        X(mat3x4_determinant, mat3x4) \
+        X(mat4x3_determinant, mat4x3) \
+        X(mat4x4_determinant, mat4x4) \
+        BENCH_SSE_REDUCE1(X)
+
+/** @brief f32 fn(const T *v, const T *v1) */
+#define BENCH_REDUCE2(X) \
+        X(vec2_dot, vec2) \
+        X(vec3_dot, vec3) \
+        X(vec4_dot, vec4) \
+        X(vec3_cross_product_magnitude, vec3) \
+        BENCH_SSE_REDUCE2(X)
+
+/** @brief R fn(const T *v) */
+#define BENCH_MAP1(X) \
+        X(vec2_create_from_vec3, vec2, vec3) \
+        X(vec2_create_from_vec4, vec2, vec4) \
+        X(vec3_create_from_vec2, vec3, vec2) \
+        X(vec3_create_from_vec4, vec3, vec4) \
+        X(vec4_create_from_vec2, vec4, vec2) \
+        X(vec4_create_from_vec3, vec4, vec3) \
+        X(mat2x2_transpose, mat2x2, mat2x2) \
+        X(mat2x2_inverse, mat2x2, mat2x2) \
+        X(mat2x3_transpose, mat3x2, mat2x3) \
+        X(mat2x4_transpose, mat4x2, mat2x4) \
+        X(mat3x2_transpose, mat2x3, mat3x2) \
+        X(mat3x3_transpose, mat3x3, mat3x3) \
+        X(mat3x3_inverse, mat3x3, mat3x3) \
+        X(mat3x4_transpose, mat4x3, mat3x4) \
+        X(mat3x4_inverse_affine, mat3x4, mat3x4) \
+        X(mat4x2_transpose, mat2x4, mat4x2) \
+        X(mat4x3_from_mat4x4, mat4x3, mat4x4) \
+        X(mat4x3_to_mat4x4, mat4x4, mat4x3) \
+        X(mat4x3_transpose, mat3x4, mat4x3) \
+        X(mat4x3_inverse_affine, mat4x3, mat4x3) \
+        X(mat4x4_inverse, mat4x4, mat4x4) \
+        X(mat4x4_inverse_affine, mat4x4, mat4x4) \
+        X(mat4x4_inverse_rigid, mat4x4, mat4x4) \
+        X(quat_conjugate, quat, quat) \
+        X(quat_to_mat4x4, mat4x4, quat) \
+        X(quat_from_mat4x4, quat, mat4x4) \
+        BENCH_SSE_MAP1(X)
+
+/** @brief R fn(const A *a, const B *b) */
+#define BENCH_MAP2(X) \
+        X(vec3_cross_product, vec3, vec3, vec3) \
+        X(mat2x2_mult, mat2x2, mat2x2, mat2x2) \
+        X(mat2x2_vec2_mult, vec2, mat2x2, vec2) \
+        X(mat2x3_vec2_mult, vec3, mat2x3, vec2) \
+        X(mat2x3_mult, mat3x3, mat2x3, mat3x2) \
+        X(mat2x4_vec2_mult, vec4, mat2x4, vec2) \
+        X(mat2x4_mult, mat4x4, mat2x4, mat4x2) \
+        X(mat3x2_vec3_mult, vec2, mat3x2, vec3) \
+        X(mat3x2_mult, mat2x2, mat3x2, mat2x3) \
+        X(mat3x3_mult, mat3x3, mat3x3, mat3x3) \
+        X(mat3x3_vec3_mult, vec3, mat3x3, vec3) \
+        X(mat3x4_vec3_mult, vec4, mat3x4, vec3) \
+        X(mat3x4_mult, mat4x4, mat3x4, mat4x3) \
+        X(mat3x4_mult_affine, mat3x4, mat3x4, mat3x4) \
+        X(mat3x4_transform_point, vec3, mat3x4, vec3) \
+        X(mat3x4_transform_direction, vec3, mat3x4, vec3) \
+        X(mat4x2_vec4_mult, vec2, mat4x2, vec4) \
+        X(mat4x2_mult, mat2x2, mat4x2, mat2x4) \
+        X(mat4x3_vec4_mult, vec3, mat4x3, vec4) \
+        X(mat4x3_mult, mat3x3, mat4x3, mat3x4) \
+        X(mat4x3_mult_affine, mat4x3, mat4x3, mat4x3) \
+        X(mat4x3_transform_point, vec3, mat4x3, vec3) \
+        X(mat4x3_transform_direction, vec3, mat4x3, vec3) \
+        X(mat4x4_mult, mat4x4, mat4x4, mat4x4) \
+        X(mat4x4_vec4_mult, vec4, mat4x4, vec4) \
+        X(quat_mult, quat, quat, quat) \
+        X(quat_rotate_vec3, vec3, quat, vec3) \
+        BENCH_SSE_MAP2(X)
+
+/** @brief R fn(const T *v, const T *v1, const T *v2), v2 is read from out. */
+#define BENCH_MAP3(X) \
+        X(vec3_triple_product, vec3, vec3) \
+        X(vec3_scalar_triple_product, f32, vec3)
+
+/** @brief R fn(const T *v, const T *v1, f32 t) */
+#define BENCH_LERP(X) \
+        X(quat_nlerp) \
+        X(quat_slerp)
+
+/** @brief mat4x4 fn(const mat4x4 *m, f32 *det) */
+#define BENCH_INVERSE_DET(X) \
+        X(mat4x4_inverse_det) \
+        BENCH_SSE_INVERSE_DET(X)
+
+
+#ifdef SMATH_SSE
+
+#define BENCH_SSE_INPLACE1(X) \
+        X(vec4_sse_square_root, vec4) \
+        X(vec4_sse_normalize, vec4)
+
+#define BENCH_SSE_INPLACE2(X) \
+        X(vec4_sse_add, vec4) \
+        X(vec4_sse_sub, vec4)
+
+#define BENCH_SSE_INPLACE_S(X) \
+        X(vec4_sse_scalar_mult, vec4) \
+        X(vec4_sse_scalar_div, vec4)
+
+#define BENCH_SSE_REDUCE1(X) \
+        X(vec4_sse_magnitude, vec4)
+
+#define BENCH_SSE_REDUCE2(X) \
+        X(vec4_sse_dot, vec4)
+
+#define BENCH_SSE_MAP1(X) \
+        X(mat2x2_sse_inverse, mat2x2, mat2x2) \
+        X(mat3x3_sse_inverse, mat3x3, mat3x3) \
+        X(mat3x4_sse_inverse_affine, mat3x4, mat3x4) \
+        X(mat4x3_sse_inverse_affine, mat4x3, mat4x3) \
+        X(mat4x4_sse_inverse, mat4x4, mat4x4) \
+        X(mat4x4_sse_inverse_affine, mat4x4, mat4x4) \
+        X(mat4x4_sse_inverse_rigid, mat4x4, mat4x4)
+
+#define BENCH_SSE_MAP2(X) \
+        X(mat2x2_sse_mult, mat2x2, mat2x2, mat2x2) \
+        X(mat3x3_sse_mult, mat3x3, mat3x3, mat3x3) \
+        X(mat3x3_sse_vec3_mult, vec3, mat3x3, vec3) \
+        X(mat3x4_sse_mult_affine, mat3x4, mat3x4, mat3x4) \
+        X(mat3x4_sse_transform_point, vec3, mat3x4, vec3) \
+        X(mat4x3_sse_vec4_mult, vec3, mat4x3, vec4) \
+        X(mat4x3_sse_mult_affine, mat4x3, mat4x3, mat4x3) \
+        X(mat4x3_sse_transform_point, vec3, mat4x3, vec3) \
+        X(mat4x4_sse_mult, mat4x4, mat4x4, mat4x4) \
+        X(mat4x4_sse_vec4_mult, vec4, mat4x4, vec4) \
+        X(quat_sse_mult, quat, quat, quat)
+
+#define BENCH_SSE_INVERSE_DET(X) \
+        X(mat4x4_sse_inverse_det)
+
+#else
+
+#define BENCH_SSE_INPLACE1(X)
+#define BENCH_SSE_INPLACE2(X)
+#define BENCH_SSE_INPLACE_S(X)
+#define BENCH_SSE_REDUCE1(X)
+#define BENCH_SSE_REDUCE2(X)
+#define BENCH_SSE_MAP1(X)
+#define BENCH_SSE_MAP2(X)
+#define BENCH_SSE_INVERSE_DET(X)
+
+#endif // SMATH_SSE
+
+
+/** @brief The value functions, loaded from and stored to the same arrays as the pointer versions. */
+#define BENCH_VALUES(X) \
+        X(vec4_addv, 3 * sizeof(vec4), \
+                vec4_storev(&((vec4*)x->out)[i], vec4_addv(vec4_loadv(&a4[i]), vec4_loadv(&b4[i])))) \
+        X(vec4_normalizev, 2 * sizeof(vec4), \
+                vec4_storev(&((vec4*)x->out)[i], vec4_normalizev(vec4_loadv(&a4[i])))) \
+        X(vec4_fast_normalizev, 2 * sizeof(vec4), \
+                vec4_storev(&((vec4*)x->out)[i], vec4_fast_normalizev(vec4_loadv(&a4[i])))) \
+        X(vec4_dotv, 2 * sizeof(vec4) + sizeof(f32), \
+                ((f32*)x->out)[i] = vec4_dotv(vec4_loadv(&a4[i]), vec4_loadv(&b4[i]))) \
+        X(vec3_cross_productv, 3 * sizeof(vec3), \
+                vec3_storev(&((vec3*)x->out)[i], vec3_cross_productv(vec3_loadv(&a3[i]), vec3_loadv(&b3[i])))) \
+        X(vec3_normalizev, 2 * sizeof(vec3), \
+                vec3_storev(&((vec3*)x->out)[i], vec3_normalizev(vec3_loadv(&a3[i])))) \
+        X(vec3_fast_normalizev, 2 * sizeof(vec3), \
+                vec3_storev(&((vec3*)x->out)[i], vec3_fast_normalizev(vec3_loadv(&a3[i])))) \
+        X(mat4x4_multv, 3 * sizeof(mat4x4), \
+                mat4x4_storev(&((mat4x4*)x->out)[i], mat4x4_multv(mat4x4_loadv(&am[i]), mat4x4_loadv(&bm[i])))) \
+        X(mat4x4_vec4_multv, sizeof(mat4x4) + 2 * sizeof(vec4), \
+                vec4_storev(&((vec4*)x->out)[i], mat4x4_vec4_multv(mat4x4_loadv(&am[i]), vec4_loadv(&b4[i])))) \
+        X(mat4x4_transposev, 2 * sizeof(mat4x4), \
+                mat4x4_storev(&((mat4x4*)x->out)[i], mat4x4_transposev(mat4x4_loadv(&am[i]))))
+
+/** @brief The restrict batch functions of vector_value.h. */
+#define BENCH_ARRAYS(X) \
+        X(vec4_add_array, 3 * sizeof(vec4), \
+                vec4_add_array(x->out, x->a, x->b, x->n)) \
+        X(vec4_sub_array, 3 * sizeof(vec4), \
+                vec4_sub_array(x->out, x->a, x->b, x->n)) \
+        X(vec4_scalar_mult_array, 2 * sizeof(vec4), \
+                vec4_scalar_mult_array(x->out, x->a, 1.0f, x->n)) \
+        X(vec4_dot_array, 2 * sizeof(vec4) + sizeof(f32), \
+                vec4_dot_array(x->out, x->a, x->b, x->n))
+
+/** @brief The dispatched kernels, one call processes all n elements. */
+#define BENCH_BATCH(X) \
+        X(mat4x4_mult_array, 3 * sizeof(mat4x4), \
+                mat4x4_mult_array(x->out, x->a, x->b, x->n)) \
+        X(mat4x4_transform_points, 2 * sizeof(vec3), \
+                mat4x4_transform_points(x->b, x->a, x->out, x->n)) \
+        X(mat4x4_transform_directions, 2 * sizeof(vec3), \
+                mat4x4_transform_directions(x->b, x->a, x->out, x->n)) \
+        X(mat4x4_transform_points_stream, 2 * sizeof(vec3), \
+                mat4x4_transform_points_stream(x->b, x->a, x->out, x->n)) \
+        X(mat4x4_transform_vec4s, 2 * sizeof(vec4), \
+                mat4x4_transform_vec4s(x->b, x->a, x->out, x->n)) \
+        X(mat4x4_transform_vec4s_stream, 2 * sizeof(vec4), \
+                mat4x4_transform_vec4s_stream(x->b, x->a, x->out, x->n)) \
+        X(mat4x4_from_trs_array, 2 * sizeof(vec3) + sizeof(quat) + sizeof(mat4x4), \
+                mat4x4_from_trs_array(x->out, x->a, x->b, (vec3*)x->a + x->n, x->n)) \
+        X(mat4x4_from_trs_mult_array, 2 * sizeof(vec3) + sizeof(quat) + sizeof(mat4x4), \
+                mat4x4_from_trs_mult_array(x->out, x->b, x->a, x->b, (vec3*)x->a + x->n, x->n)) \
+        X(mat4x3_from_trs_array, 2 * sizeof(vec3) + sizeof(quat) + sizeof(mat4x3), \
+                mat4x3_from_trs_array(x->out, x->a, x->b, (vec3*)x->a + x->n, x->n)) \
+        X(mat4x4_mult_array_parallel, 3 * sizeof(mat4x4), \
+                mat4x4_mult_array_parallel(x->out, x->a, x->b, x->n)) \
+        X(mat4x4_transform_points_parallel, 2 * sizeof(vec3), \
+                mat4x4_transform_points_parallel(x->b, x->a, x->out, x->n)) \
+        X(mat4x4_transform_vec4s_parallel, 2 * sizeof(vec4), \
+                mat4x4_transform_vec4s_parallel(x->b, x->a, x->out, x->n)) \
+        X(vec3_soa_from_aos, 2 * sizeof(vec3), \
+                vec3_soa_from_aos((vec3_soa*)&x->o3, x->a, x->n)) \
+        X(vec3_soa_to_aos, 2 * sizeof(vec3), \
+                vec3_soa_to_aos(x->out, &x->a3)) \
+        X(vec3_soa_add, 2 * sizeof(vec3), \
+                vec3_soa_add((vec3_soa*)&x->a3, &x->b3)) \
+        X(vec3_soa_sub, 2 * sizeof(vec3), \
+                vec3_soa_sub((vec3_soa*)&x->a3, &x->b3)) \
+        X(vec3_soa_scalar_mult, sizeof(vec3), \
+                vec3_soa_scalar_mult((vec3_soa*)&x->a3, 1.0f)) \
+        X(vec3_soa_magnitude, sizeof(vec3) + sizeof(f32), \
+                vec3_soa_magnitude(&x->a3, x->out)) \
+        X(vec3_soa_normalize, sizeof(vec3), \
+                vec3_soa_normalize((vec3_soa*)&x->a3)) \
+        X(vec3_soa_fast_normalize, sizeof(vec3), \
+                vec3_soa_fast_normalize((vec3_soa*)&x->a3)) \
+        X(vec3_soa_normalize_parallel, sizeof(vec3), \
+                vec3_soa_normalize_parallel((vec3_soa*)&x->a3)) \
+        X(vec3_soa_dot, 2 * sizeof(vec3) + sizeof(f32), \
+                vec3_soa_dot(&x->a3, &x->b3, x->out)) \
+        X(vec3_soa_cross_product, 3 * sizeof(vec3), \
+                vec3_soa_cross_product((vec3_soa*)&x->o3, &x->a3, &x->b3)) \
+        X(vec4_soa_from_aos, 2 * sizeof(vec4), \
+                vec4_soa_from_aos((vec4_soa*)&x->o4, x->a, x->n)) \
+        X(vec4_soa_to_aos, 2 * sizeof(vec4), \
+                vec4_soa_to_aos(x->out, &x->a4)) \
+        X(vec4_soa_add, 2 * sizeof(vec4), \
+                vec4_soa_add((vec4_soa*)&x->a4, &x->b4)) \
+        X(vec4_soa_sub, 2 * sizeof(vec4), \
+                vec4_soa_sub((vec4_soa*)&x->a4, &x->b4)) \
+        X(vec4_soa_scalar_mult, sizeof(vec4), \
+                vec4_soa_scalar_mult((vec4_soa*)&x->a4, 1.0f)) \
+        X(vec4_soa_magnitude, sizeof(vec4) + sizeof(f32), \
+                vec4_soa_magnitude(&x->a4, x->out)) \
+        X(vec4_soa_normalize, sizeof(vec4), \
+                vec4_soa_normalize((vec4_soa*)&x->a4)) \
+        X(vec4_soa_fast_normalize, sizeof(vec4), \
+                vec4_soa_fast_normalize((vec4_soa*)&x->a4)) \
+        X(vec4_soa_dot, 2 * sizeof(vec4) + sizeof(f32), \
+                vec4_soa_dot(&x->a4, &x->b4, x->out)) \
+        X(quat_soa_nlerp, 3 * sizeof(quat) + sizeof(f32), \
+                quat_soa_nlerp((vec4_soa*)&x->o4, &x->a4, &x->b4, x->t)) \
+        X(quat_soa_slerp, 3 * sizeof(quat) + sizeof(f32), \
+                quat_soa_slerp((vec4_soa*)&x->o4, &x->a4, &x->b4, x->t)) \
+        X(frustum_cull_spheres, sizeof(sphere), \
+                frustum_cull_spheres(&bench_frustum, &x->a4, x->out)) \
+        X(frustum_cull_aabbs, sizeof(aabb), \
+                frustum_cull_aabbs(&bench_frustum, &(aabb_soa){ x->a3, x->b3 }, x->out)) \
+        X(ray_intersect_triangles, sizeof(triangle), \
+                ray_intersect_triangles(&bench_ray, &(triangle_soa){ x->a3, x->b3, x->o3 }, INFINITY, x->out, &bench_hit)) \
+        X(ray_intersect_spheres, sizeof(sphere), \
+                ray_intersect_spheres(&bench_ray, &x->a4, INFINITY, x->out, &bench_hit)) \
+        X(ray_intersect_aabbs, sizeof(aabb), \
+                ray_intersect_aabbs(&bench_ray, &(aabb_soa){ x->a3, x->b3 }, INFINITY, x->out, &bench_hit)) \
+        X(ray_soa_intersect_aabb, sizeof(ray) + 2 * sizeof(f32), \
+                ray_soa_intersect_aabb(&(ray_soa){ x->a3, x->b3 }, &bench_box, x->t, x->out, (u32*)x->out + x->n)) \
+        X(ray_soa_intersect_sphere, sizeof(ray) + 2 * sizeof(f32), \
+                ray_soa_intersect_sphere(&(ray_soa){ x->a3, x->b3 }, &bench_sphere, x->t, x->out, (u32*)x->out + x->n)) \
+        X(smath_bvh_create, 2 * sizeof(aabb) + 2 * sizeof(aabb_node) + sizeof(u32), \
+                (smath_bvh_create(&bench_bvh, x->a, x->n), smath_bvh_destroy(&bench_bvh))) \
+        X(smath_grid_build, 2 * sizeof(vec3) + 4 * sizeof(u32), \
+                bench_grid_build(x)) \
+        X(skin_linear, 4 * sizeof(vec3) + sizeof(skin_influence), \
+                skin_linear(bench_palette, bench_influences, x->a, x->b, x->out, (vec3*)x->out + x->n, x->n)) \
+        X(skin_dual_quat, 4 * sizeof(vec3) + sizeof(skin_influence), \
+                skin_dual_quat(bench_dual_palette, bench_influences, x->a, x->b, x->out, (vec3*)x->out + x->n, x->n)) \
+        X(dmat4x4_mult_array, 3 * sizeof(dmat4x4), \
+                dmat4x4_mult_array(x->out, x->a, x->b, x->n)) \
+        X(dmat4x4_to_mat4x4_relative_array, sizeof(dmat4x4) + sizeof(mat4x4), \
+                dmat4x4_to_mat4x4_relative_array(x->out, x->a, &(dvec3){ 1.0, 2.0, 3.0 }, x->n)) \
+        X(dvec3_to_vec3_relative_array, sizeof(dvec3) + sizeof(vec3), \
+                dvec3_to_vec3_relative_array(x->out, x->a, &(dvec3){ 1.0, 2.0, 3.0 }, x->n)) \
+        X(smath_pack_array_f16, sizeof(f32) + sizeof(u16), \
+                smath_pack_array(x->out, x->a, x->n, SMATH_PACK_F16)) \
+        X(smath_unpack_array_f16, sizeof(f32) + sizeof(u16), \
+                smath_unpack_array(x->out, x->t, x->n, SMATH_PACK_F16)) \
+        X(smath_pack_array_snorm16, sizeof(f32) + sizeof(i16), \
+                smath_pack_array(x->out, x->a, x->n, SMATH_PACK_SNORM16)) \
+        X(smath_pack_array_unorm8, sizeof(f32) + sizeof(u8), \
+                smath_pack_array(x->out, x->a, x->n, SMATH_PACK_UNORM8)) \
+        X(vec3_soa_encode_octahedral, sizeof(vec3) + sizeof(u32), \
+                vec3_soa_encode_octahedral((u32*)x->out, &x->a3)) \
+        X(vec3_soa_decode_octahedral, sizeof(vec3) + sizeof(u32), \
+                vec3_soa_decode_octahedral((vec3_soa*)&x->o3, (const u32*)x->t, x->n)) \
+        X(quat_soa_pack_smallest3, sizeof(quat) + sizeof(u32), \
+                quat_soa_pack_smallest3((u32*)x->out, &x->a4)) \
+        X(quat_soa_unpack_smallest3, sizeof(quat) + sizeof(u32), \
+                quat_soa_unpack_smallest3((vec4_soa*)&x->o4, (const u32*)x->t, x->n)) \
+        X(smath_sin_array, 2 * sizeof(f32), \
+                smath_sin_array(x->out, x->a, x->n, SMATH_ACCURACY_HIGH)) \
+        X(smath_sin_array_fast, 2 * sizeof(f32), \
+                smath_sin_array(x->out, x->a, x->n, SMATH_ACCURACY_FAST)) \
+        X(smath_cos_array, 2 * sizeof(f32), \
+                smath_cos_array(x->out, x->a, x->n, SMATH_ACCURACY_HIGH)) \
+        X(smath_cos_array_fast, 2 * sizeof(f32), \
+                smath_cos_array(x->out, x->a, x->n, SMATH_ACCURACY_FAST)) \
+        X(smath_sincos_array, 3 * sizeof(f32), \
+                smath_sincos_array(x->out, x->b, x->a, x->n, SMATH_ACCURACY_HIGH)) \
+        X(smath_sincos_array_fast, 3 * sizeof(f32), \
+                smath_sincos_array(x->out, x->b, x->a, x->n, SMATH_ACCURACY_FAST)) \
+        X(smath_atan2_array, 3 * sizeof(f32), \
+                smath_atan2_array(x->out, x->a, x->b, x->n, SMATH_ACCURACY_HIGH)) \
+        X(smath_atan2_array_fast, 3 * sizeof(f32), \
+                smath_atan2_array(x->out, x->a, x->b, x->n, SMATH_ACCURACY_FAST)) \
+        X(smath_exp_array, 2 * sizeof(f32), \
+                smath_exp_array(x->out, x->a, x->n, SMATH_ACCURACY_HIGH)) \
+        X(smath_exp_array_fast, 2 * sizeof(f32), \
+                smath_exp_array(x->out, x->a, x->n, SMATH_ACCURACY_FAST)) \
+        X(smath_log_array, 2 * sizeof(f32), \
+                smath_log_array(x->out, x->a, x->n, SMATH_ACCURACY_HIGH)) \
+        X(smath_log_array_fast, 2 * sizeof(f32), \
+                smath_log_array(x->out, x->a, x->n, SMATH_ACCURACY_FAST)) \
+        X(smath_pow_array, 3 * sizeof(f32), \
+                smath_pow_array(x->out, x->a, x->b, x->n, SMATH_ACCURACY_HIGH)) \
+        X(smath_pow_array_fast, 3 * sizeof(f32), \
+                smath_pow_array(x->out, x->a, x->b, x->n, SMATH_ACCURACY_FAST))
+
+
+#define X(fn, T) \
+static void bench_##fn(const bench_args *x) { \
+        T *a = x->a; \
+        for (size_t i = 0; i < x->n; ++i) \
+                fn(&a[i]); \
+}
+BENCH_INPLACE1(X)
+#undef X
+
+#define X(fn, T) \
+static void bench_##fn(const bench_args *x) { \
+        T *a = x->a; \
+        const T *b = x->b; \
+        for (size_t i = 0; i < x->n; ++i) \
+                fn(&a[i], &b[i]); \
+}
+BENCH_INPLACE2(X)
+#undef X
+
+#define X(fn, T) \
+static void bench_##fn(const bench_args *x) { \
+        T *a = x->a; \
+        for (size_t i = 0; i < x->n; ++i) \
+                fn(&a[i], 1.0f); \
+}
+BENCH_INPLACE_S(X)
+#undef X
+
+#define X(fn, T) \
+static void bench_##fn(const bench_args *x) { \
+        const T *a = x->a; \
+        f32 *o = x->out; \
+        for (size_t i = 0; i < x->n; ++i) \
+                o[i] = fn(&a[i]); \
+}
+BENCH_REDUCE1(X)
+#undef X
+
+#define X(fn, T) \
+static void bench_##fn(const bench_args *x) { \
+        const T *a = x->a; \
+        const T *b = x->b; \
+        f32 *o = x->out; \
+        for (size_t i = 0; i < x->n; ++i) \
+                o[i] = fn(&a[i], &b[i]); \
+}
+BENCH_REDUCE2(X)
+#undef X
+
+#define X(fn, R, T) \
+static void bench_##fn(const bench_args *x) { \
+        const T *a = x->a; \
+        R *o = x->out; \
+        for (size_t i = 0; i < x->n; ++i) \
+                o[i] = fn(&a[i]); \
+}
+BENCH_MAP1(X)
+#undef X
+
+#define X(fn, R, A, B) \
+static void bench_##fn(const bench_args *x) { \
+        const A *a = x->a; \
+        const B *b = x->b; \
+        R *o = x->out; \
+        for (size_t i = 0; i < x->n; ++i) \
+                o[i] = fn(&a[i], &b[i]); \
+}
+BENCH_MAP2(X)
+#undef X
+
+// The third input is the output buffer, so the result is written to a fourth array of R after it.
+#define X(fn, R, T) \
+static void bench_##fn(const bench_args *x) { \
+        const T *a = x->a; \
+        const T *b = x->b; \
+        const T *c = x->out; \
+        R *o = (R*)(c + x->n); \
+        for (size_t i = 0; i < x->n; ++i) \
+                o[i] = fn(&a[i], &b[i], &c[i]); \
+}
+BENCH_MAP3(X)
+#undef X
+
+#define X(fn) \
+static void bench_##fn(const bench_args *x) { \
+        const quat *a = x->a; \
+        const quat *b = x->b; \
+        quat *o = x->out; \
+        for (size_t i = 0; i < x->n; ++i) \
+                o[i] = fn(&a[i], &b[i], x->t[i]); \
+}
+BENCH_LERP(X)
+#undef X
+
+#define X(fn) \
+static void bench_##fn(const bench_args *x) { \
+        const mat4x4 *a = x->a; \
+        mat4x4 *o = x->out; \
+        f32 *det = x->b; \
+        for (size_t i = 0; i < x->n; ++i) \
+                o[i] = fn(&a[i], &det[i]); \
+}
+BENCH_INVERSE_DET(X)
+#undef X
+
+static void bench_quat_create_from_axis_angle(const bench_args *x) {
+        const vec3 *a = x->a;
+        quat *o = x->out;
+        for (size_t i = 0; i < x->n; ++i)
+                o[i] = quat_create_from_axis_angle(&a[i], x->t[i]);
+}
+
+static void bench_mat4x4_create(const bench_args *x) {
+        const vec4 *a = x->a;
+        mat4x4 *o = x->out;
+        for (size_t i = 0; i < x->n; ++i)
+                o[i] = mat4x4_create(&a[4 * i], &a[4 * i + 1], &a[4 * i + 2], &a[4 * i + 3]);
+}
+
+static void bench_mat4x4_parse(const bench_args *x) {
+        const vec4 *a = x->a;
+        mat4x4 *o = x->out;
+        for (size_t i = 0; i < x->n; ++i)
+                mat4x4_parse(&o[i], &a[4 * i], &a[4 * i + 1], &a[4 * i + 2], &a[4 * i + 3]);
+}
+
+#define X(fn, bytes, call) \
+static void bench_##fn(const bench_args *x) { \
+        const vec3 *a3 = x->a, *b3 = x->b; \
+        const vec4 *a4 = x->a, *b4 = x->b; \
+        const mat4x4 *am = x->a, *bm = x->b; \
+        (void)a3, (void)b3, (void)a4, (void)b4, (void)am, (void)bm; \
+        for (size_t i = 0; i < x->n; ++i) \
+                call; \
+}
+BENCH_VALUES(X)
+#undef X
+
+#define X(fn, bytes, call) \
+static void bench_##fn(const bench_args *x) { \
+        call; \
+}
+BENCH_ARRAYS(X)
+BENCH_BATCH(X)
+#undef X
+
+
+static const bench bench_table[] = {
+#define X(fn, T) { #fn, sizeof(T), BENCH_SINGLE, bench_##fn },
+        BENCH_INPLACE1(X)
+        BENCH_INPLACE_S(X)
+#undef X
+#define X(fn, T) { #fn, 2 * sizeof(T), BENCH_SINGLE, bench_##fn },
+        BENCH_INPLACE2(X)
+#undef X
+#define X(fn, T) { #fn, sizeof(T) + sizeof(f32), BENCH_SINGLE, bench_##fn },
+        BENCH_REDUCE1(X)
+#undef X
+#define X(fn, T) { #fn, 2 * sizeof(T) + sizeof(f32), BENCH_SINGLE, bench_##fn },
+        BENCH_REDUCE2(X)
+#undef X
+#define X(fn, R, T) { #fn, sizeof(T) + sizeof(R), BENCH_SINGLE, bench_##fn },
+        BENCH_MAP1(X)
+#undef X
+#define X(fn, R, A, B) { #fn, sizeof(A) + sizeof(B) + sizeof(R), BENCH_SINGLE, bench_##fn },
+        BENCH_MAP2(X)
+#undef X
+#define X(fn, R, T) { #fn, 3 * sizeof(T) + sizeof(R), BENCH_SINGLE, bench_##fn },
+        BENCH_MAP3(X)
+#undef X
+#define X(fn) { #fn, 3 * sizeof(quat) + sizeof(f32), BENCH_SINGLE, bench_##fn },
+        BENCH_LERP(X)
+#undef X
+#define X(fn) { #fn, 2 * sizeof(mat4x4) + sizeof(f32), BENCH_SINGLE, bench_##fn },
+        BENCH_INVERSE_DET(X)
+#undef X
+        { "quat_create_from_axis_angle", sizeof(vec3) + sizeof(f32) + sizeof(quat), BENCH_SINGLE, bench_quat_create_from_axis_angle },
+        { "mat4x4_create", 2 * sizeof(mat4x4), BENCH_SINGLE, bench_mat4x4_create },
+        { "mat4x4_parse", 2 * sizeof(mat4x4), BENCH_SINGLE, bench_mat4x4_parse },
+#define X(fn, bytes, call) { #fn, bytes, BENCH_VALUE, bench_##fn },
+        BENCH_VALUES(X)
+#undef X
+#define X(fn, bytes, call) { #fn, bytes, BENCH_ARRAY, bench_##fn },
+        BENCH_ARRAYS(X)
+#undef X
+#define X(fn, bytes, call) { #fn, bytes, BENCH_DISPATCH, bench_##fn },
+        BENCH_BATCH(X)
+#undef X
+};
+
+#define BENCH_COUNT (sizeof(bench_table) / sizeof(bench_table[0]))
+
+
+/** @brief Monotonic time in nanoseconds. */
+static double bench_now_ns(void) {
+#if defined(_WIN32)
+        static LARGE_INTEGER freq;
+        LARGE_INTEGER c;
+
+        if (!freq.QuadPart)
+                QueryPerformanceFrequency(&freq);
+
+        QueryPerformanceCounter(&c);
+        return (double)c.QuadPart * 1e9 / (double)freq.QuadPart;
+#else
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+#endif
+}
+
+/** @brief The time stamp counter, 0 when the target has none. */
+static u64 bench_tsc(void) {
+#ifdef BENCH_TSC
+        return (u64)__rdtsc();
+#else
+        return 0;
+#endif
+}
+
+
+/** @brief Allocate size bytes aligned to 64, size is a multiple of 64. */
+static void *bench_alloc(size_t size) {
+#if defined(_WIN32)
+        return _aligned_malloc(size, 64);
+#else
+        return aligned_alloc(64, size);
+#endif
+}
+
+/** @brief Free memory from bench_alloc. */
+static void bench_free(void *p) {
+#if defined(_WIN32)
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+}
+
+
+/** @brief xorshift32, the same inputs on every platform. */
+static u32 bench_rng = 0x9E3779B9u;
+
+static f32 bench_rand(f32 lo, f32 hi) {
+        bench_rng ^= bench_rng << 13;
+        bench_rng ^= bench_rng >> 17;
+        bench_rng ^= bench_rng << 5;
+        return lo + (hi - lo) * (f32)(bench_rng >> 8) * (1.0f / 16777216.0f);
+}
+
+/**
+ * @brief Fill the first bytes of a buffer with floats in [0.5, 1.5].
+ *
+ * Positive so the in place square roots stay finite, unit is set for the
+ * quaternion functions, which expect normalized inputs.
+ */
+static void bench_fill(f32 *p, size_t bytes, int unit) {
+        size_t n = bytes / sizeof(f32) / 4 * 4;
+
+        for (size_t i = 0; i < n; i += 4) {
+                p[i] = bench_rand(0.5f, 1.5f);
+                p[i + 1] = bench_rand(0.5f, 1.5f);
+                p[i + 2] = bench_rand(0.5f, 1.5f);
+                p[i + 3] = bench_rand(0.5f, 1.5f);
+
+                if (unit) {
+                        f32 s = 1.0f / sqrtf(p[i] * p[i] + p[i + 1] * p[i + 1] + p[i + 2] * p[i + 2] + p[i + 3] * p[i + 3]);
+                        p[i] *= s;
+                        p[i + 1] *= s;
+                        p[i + 2] *= s;
+                        p[i + 3] *= s;
+                }
+        }
+}
+
+
+/** @brief "sse" for the _sse_ functions and for the value functions when vec4v is an __m128. */
+static const char *bench_variant(const bench *b) {
+#ifdef SMATH_SSE
+        if (b->kind == BENCH_VALUE || b->kind == BENCH_ARRAY)
+                return "sse";
+#endif
+        return strstr(b->name, "_sse_") ? "sse" : "scalar";
+}
+
+
+/** @brief Point the structure of arrays views at a buffer, n is a multiple of SMATH_SOA_WIDTH. */
+static void bench_views(bench_args *x) {
+        f32 *a = x->a, *b = x->b, *o = x->out;
+        size_t n = x->n;
+
+        x->a3 = (vec3_soa){ a, a + n, a + 2 * n, n, n };
+        x->b3 = (vec3_soa){ b, b + n, b + 2 * n, n, n };
+        x->o3 = (vec3_soa){ o, o + n, o + 2 * n, n, n };
+
+        x->a4 = (vec4_soa){ a, a + n, a + 2 * n, a + 3 * n, n, n };
+        x->b4 = (vec4_soa){ b, b + n, b + 2 * n, b + 3 * n, n, n };
+        x->o4 = (vec4_soa){ o, o + n, o + 2 * n, o + 3 * n, n, n };
+}
+
+
+static int bench_cmp(const void *a, const void *b) {
+        double x = *(const double*)a, y = *(const double*)b;
+        return (x > y) - (x < y);
+}
+
+/**
+ * @brief Warm up, pick the passes per repetition and measure.
+ *
+ * @param [ops] Takes the number of calls in one pass.
+ * @param [*ns] Takes a pointer to reps doubles for the samples.
+ */
+static bench_result bench_measure(const bench *b, const bench_args *x, size_t ops, int reps, double min_ns, double *ns, double *tsc) {
+        bench_result r;
+
+        // Warmup and calibration, double the passes until one repetition takes min_ns.
+        size_t passes = 1;
+        for (;;) {
+                double t0 = bench_now_ns();
+                for (size_t p = 0; p < passes; ++p)
+                        b->run(x);
+                double t = bench_now_ns() - t0;
+
+                if (t >= min_ns || passes >= ((size_t)1 << 30))
+                        break;
+
+                size_t want = (size_t)(min_ns / (t > 1.0 ? t : 1.0) * (double)passes) + 1;
+                passes = want > 2 * passes ? want : 2 * passes;
+        }
+
+        for (int i = 0; i < reps; ++i) {
+                u64 c0 = bench_tsc();
+                double t0 = bench_now_ns();
+
+                for (size_t p = 0; p < passes; ++p)
+                        b->run(x);
+
+                double t = bench_now_ns() - t0;
+                u64 c = bench_tsc() - c0;
+
+                bench_sink = ((volatile f32*)x->out)[0];
+                ns[i] = t / (double)(passes * ops);
+                tsc[i] = (double)c / (double)(passes * ops);
+        }
+
+        qsort(ns, (size_t)reps, sizeof(double), bench_cmp);
+        qsort(tsc, (size_t)reps, sizeof(double), bench_cmp);
+
+        size_t p99 = (size_t)ceil(0.99 * reps) - 1;
+
+        r.ns_median = reps % 2 ? ns[reps / 2] : 0.5 * (ns[reps / 2 - 1] + ns[reps / 2]);
+        r.ns_p99 = ns[p99];
+        r.ns_min = ns[0];
+        r.tsc_median = reps % 2 ? tsc[reps / 2] : 0.5 * (tsc[reps / 2 - 1] + tsc[reps / 2]);
+        r.passes = passes;
+
+        return r;
+}
+
+
+/** @brief The command line options. */
+typedef struct bench_options {
+        const char *filter;
+        const char *out;
+        int reps;
+        double min_ms;
+        size_t hot_bytes;
+        size_t cold_bytes;
+        int cold;
+        int list;
+        int threads;
+} bench_options;
+
+static void bench_usage(void) {
+        fprintf(stderr,
+                "usage: bench [--filter name] [--reps n] [--min-time-ms ms] [--hot-kib n]\n"
+                "             [--cold-mib n] [--no-cold] [--threads n] [--out file] [--list]\n");
+}
+
+static int bench_parse(int argc, char **argv, bench_options *o) {
+        for (int i = 1; i < argc; ++i) {
+                const char *a = argv[i];
+                const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+
+                if (strcmp(a, "--no-cold") == 0) {
+                        o->cold = 0;
+                } else if (strcmp(a, "--list") == 0) {
+                        o->list = 1;
+                } else if (!v) {
+                        bench_usage();
+                        return 0;
+                } else if (strcmp(a, "--filter") == 0) {
+                        o->filter = v, ++i;
+                } else if (strcmp(a, "--out") == 0) {
+                        o->out = v, ++i;
+                } else if (strcmp(a, "--reps") == 0) {
+                        o->reps = atoi(v), ++i;
+                } else if (strcmp(a, "--min-time-ms") == 0) {
+                        o->min_ms = atof(v), ++i;
+                } else if (strcmp(a, "--hot-kib") == 0) {
+                        o->hot_bytes = (size_t)atol(v) * 1024, ++i;
+                } else if (strcmp(a, "--cold-mib") == 0) {
+                        o->cold_bytes = (size_t)atol(v) * 1024 * 1024, ++i;
+                } else if (strcmp(a, "--threads") == 0) {
+                        o->threads = atoi(v), ++i;
+                } else {
+                        bench_usage();
+                        return 0;
+                }
+        }
+
+        if (o->reps < 1 || o->min_ms <= 0.0 || o->hot_bytes == 0 || o->cold_bytes == 0 || o->threads < 0) {
+                bench_usage();
+                return 0;
+        }
+
+        return 1;
+}
+
+
+int main(int argc, char **argv) {
+        bench_options o = { NULL, NULL, 31, 5.0, 16 * 1024, 64 * 1024 * 1024, 1, 0, 0 };
+
+        if (!bench_parse(argc, argv, &o))
+                return 2;
+
+        if (o.list) {
+                for (size_t i = 0; i < BENCH_COUNT; ++i)
+                        printf("%s (%s)\n", bench_table[i].name, bench_kind_names[bench_table[i].kind]);
+                return 0;
+        }
+
+        // The largest working set, every buffer has to hold all of it (plus the soa padding).
+        size_t max_bytes = o.cold && o.cold_bytes > o.hot_bytes ? o.cold_bytes : o.hot_bytes;
+        size_t buf_bytes = (max_bytes + 4096 + 63) / 64 * 64;
+
+        f32 *a = bench_alloc(buf_bytes);
+        f32 *b = bench_alloc(buf_bytes);
+        f32 *out = bench_alloc(2 * buf_bytes);
+        f32 *t = bench_alloc(buf_bytes);
+        bench_influences = bench_alloc(buf_bytes);
+        double *ns = malloc((size_t)o.reps * sizeof(double));
+        double *tsc = malloc((size_t)o.reps * sizeof(double));
+        FILE *f = o.out ? fopen(o.out, "w") : stdout;
+
+        if (!a || !b || !out || !t || !bench_influences || !ns || !tsc || !f) {
+                fprintf(stderr, "bench: out of memory or can not open %s\n", o.out ? o.out : "stdout");
+                return 1;
+        }
+
+        for (size_t i = 0; i < buf_bytes / sizeof(f32); ++i)
+                t[i] = bench_rand(0.0f, 1.0f);
+
+        smath_isa cpu = smath_cpu_isa();
+
+        mat4x4 identity = { { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } } };
+        frustum_from_mat4x4(&bench_frustum, &identity, SMATH_CLIP_DEPTH_NEG_ONE_TO_ONE);
+
+        bench_fill(&bench_palette[0].t[0].x, sizeof(bench_palette), 0);
+        skin_palette_to_dual_quat(bench_dual_palette, bench_palette, BENCH_BONES);
+        for (size_t i = 0; i < buf_bytes / sizeof(skin_influence); ++i) {
+                for (int j = 0; j < 4; ++j) {
+                        bench_influences[i].bone[j] = (u16)bench_rand(0.0f, (f32)BENCH_BONES);
+                        bench_influences[i].weight[j] = 0.25f;
+                }
+        }
+
+        if (!smath_pool_start((u32)o.threads))
+                fprintf(stderr, "bench: can not start the thread pool, the _parallel functions run on one thread\n");
+
+        fprintf(f, "{\n  \"library\": \"sonnetmath\",\n  \"cpu_isa\": \"%s\",\n", smath_isa_name(cpu));
+#if defined(_WIN32)
+        fprintf(f, "  \"timer\": \"QueryPerformanceCounter\",\n");
+#else
+        fprintf(f, "  \"timer\": \"clock_gettime(CLOCK_MONOTONIC)\",\n");
+#endif
+        fprintf(f, "  \"tsc\": %s,\n", bench_tsc() ? "true" : "false");
+        fprintf(f, "  \"reps\": %d,\n  \"min_time_ms\": %g,\n", o.reps, o.min_ms);
+        fprintf(f, "  \"threads\": %u,\n", smath_pool_threads());
+        fprintf(f, "  \"hot_bytes\": %zu,\n  \"cold_bytes\": %zu,\n", o.hot_bytes, o.cold ? o.cold_bytes : (size_t)0);
+        fprintf(f, "  \"results\": [");
+
+        int first = 1;
+
+        for (size_t i = 0; i < BENCH_COUNT; ++i) {
+                const bench *bn = &bench_table[i];
+
+                if (o.filter && !strstr(bn->name, o.filter))
+                        continue;
+
+                for (int cache = 0; cache < 1 + o.cold; ++cache) {
+                        size_t ws = cache ? o.cold_bytes : o.hot_bytes;
+                        size_t n = ws / bn->bytes / SMATH_SOA_WIDTH * SMATH_SOA_WIDTH;
+
+                        if (n == 0)
+                                n = SMATH_SOA_WIDTH;
+
+                        // The dispatched kernels run once for every instruction set, the rest once.
+                        smath_isa done = SMATH_ISA_COUNT;
+
+                        int dispatch = bn->kind == BENCH_DISPATCH;
+
+                        for (int isa = dispatch ? SMATH_ISA_SCALAR : (int)cpu; isa <= (int)cpu; ++isa) {
+                                smath_isa bound = smath_set_isa((smath_isa)isa);
+                                if (dispatch && bound == done)
+                                        continue;
+                                done = bound;
+
+                                bench_args x;
+                                x.a = a;
+                                x.b = b;
+                                x.out = out;
+                                x.t = t;
+                                x.n = n;
+                                bench_views(&x);
+
+                                // Refilled every time, the in place functions change their inputs.
+                                int unit = strncmp(bn->name, "quat", 4) == 0;
+                                size_t used = n * bn->bytes + 4096 < buf_bytes ? n * bn->bytes + 4096 : buf_bytes;
+                                bench_fill(a, used, unit);
+                                bench_fill(b, used, unit);
+                                bench_fill(out, used, unit);
+
+                                int batch = bn->kind == BENCH_ARRAY || dispatch;
+                                size_t ops = batch ? 1 : n;
+                                size_t elems = batch ? n : 1;
+                                bench_result r = bench_measure(bn, &x, ops, o.reps, o.min_ms * 1e6, ns, tsc);
+
+                                const char *variant = dispatch ? smath_isa_name(bound) : bench_variant(bn);
+
+                                fprintf(f, "%s\n    {\"name\": \"%s\", \"kind\": \"%s\", \"isa\": \"%s\", \"cache\": \"%s\", ",
+                                        first ? "" : ",", bn->name, bench_kind_names[bn->kind], variant, cache ? "cold" : "hot");
+                                fprintf(f, "\"elements\": %zu, \"bytes\": %zu, \"elements_per_op\": %zu, \"passes_per_rep\": %zu, ",
+                                        n, n * bn->bytes, elems, r.passes);
+                                fprintf(f, "\"ns_per_op_median\": %.6g, \"ns_per_op_p99\": %.6g, \"ns_per_op_min\": %.6g, ",
+                                        r.ns_median, r.ns_p99, r.ns_min);
+                                fprintf(f, "\"ns_per_element_median\": %.6g, \"elements_per_s\": %.6g, \"tsc_per_op_median\": %.6g}",
+                                        r.ns_median / (double)elems, (double)elems * 1e9 / r.ns_median, r.tsc_median);
+                                fflush(f);
+                                first = 0;
+
+                                fprintf(stderr, "%-32s %-7s %-4s %10zu elements %12.3f ns/op %12.3f ns/op p99\n",
+                                        bn->name, variant, cache ? "cold" : "hot", n, r.ns_median, r.ns_p99);
+                        }
+                }
+        }
+
+        fprintf(f, "\n  ]\n}\n");
+
+        if (f != stdout)
+                fclose(f);
+
+        smath_pool_stop();
+
+        bench_free(a);
+        bench_free(b);
+        bench_free(out);
+        bench_free(t);
+        bench_free(bench_influences);
+        free(ns);
+        free(tsc);
+
+        return 0;
+}
@@ -1,2 +1,2 @@
-cd . 
+cd . 
 mingw32-make
\ No newline at end of file
@@ -0,0 +1,295 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "math_types.h"
+#include "types.h"
+#include "mat4x4.h"
+
+/** @defgroup allocator_ Frame arenas, fixed size block pools and aligned buffer descriptors.
+ *
+ * An smath_arena hands out memory from one block by bumping an offset,
+ * it is meant for per frame scratch arrays: allocate during the frame,
+ * smath_arena_reset at its end. Nothing is freed one by one, a reset or a
+ * rewind to an earlier mark drops everything after it in O(1).
+ *
+ * An smath_block_pool hands out blocks of one size, e.g. mat4x4 or the nodes
+ * of a scene graph, and takes them back one by one. Alloc and free are
+ * O(1), freed blocks go on a list inside the blocks themselves and the
+ * blocks never handed out are taken in order, so creating and resetting
+ * a block pool does not touch its memory. (The job pool of parallel.h is
+ * unrelated, its functions are smath_pool_.)
+ *
+ * An smath_buffer describes an array of elements: pointer, count, the
+ * stride in bytes and the alignment every element has. smath_buffer_check
+ * validates it against what a function needs, the _buffer functions below
+ * check their buffers and take the dispatched batch kernels when the
+ * elements are packed.
+ *
+ * None of them lock, use one per thread or lock around them.
+ *
+ * @note Only available in the archive build, not with SMATH_HEADER_ONLY.
+ * @{
+ */
+
+
+/** @brief The alignment of the memory of smath_arena_create, smath_block_pool_create and smath_buffer_create, a cache line. */
+#define SMATH_ALLOC_ALIGNMENT 64
+
+/**
+ * @brief A linear allocator over one block of memory.
+ *
+ * Read the fields, change them only through the functions below.
+ */
+typedef struct smath_arena {
+        u8 *base;
+        size_t size;
+        size_t offset;          /**< the bytes in use, including the padding for the alignments */
+        size_t peak;            /**< the highest offset so far, to size the arena */
+        bool owned;             /**< the block was allocated by smath_arena_create */
+} smath_arena;
+
+/**
+ * @brief A fixed size block allocator.
+ *
+ * Read the fields, change them only through the functions below.
+ */
+typedef struct smath_block_pool {
+        u8 *base;
+        size_t block_size;      /**< the size rounded up to a multiple of 16 */
+        size_t capacity;
+        size_t used;            /**< the blocks handed out and not freed */
+        size_t fresh;           /**< the blocks from this one on were never handed out */
+        void *free_list;
+} smath_block_pool;
+
+/** @brief An array of count elements, element i starts at (u8*)data + i * stride. */
+typedef struct smath_buffer {
+        void *data;
+        size_t count;
+        size_t stride;          /**< the bytes from one element to the next */
+        size_t alignment;       /**< the alignment of data and of every element, a power of 2 */
+} smath_buffer;
+
+/** @brief The result of smath_buffer_check. */
+typedef enum smath_buffer_status {
+        SMATH_BUFFER_OK = 0,
+        SMATH_BUFFER_NULL,              /**< data is NULL and count is not 0 */
+        SMATH_BUFFER_BAD_ALIGNMENT,     /**< the alignment is not a power of 2 or lower than required */
+        SMATH_BUFFER_MISALIGNED,        /**< data is not aligned to the alignment */
+        SMATH_BUFFER_BAD_STRIDE,        /**< the stride is smaller than an element or not a multiple of the alignment */
+        SMATH_BUFFER_TOO_SMALL,         /**< fewer elements than required */
+        SMATH_BUFFER_STATUS_COUNT
+} smath_buffer_status;
+
+
+/**
+ * @brief Allocate the block of an arena.
+ *
+ * @param [*a] Takes a pointer to the smath_arena to initialize.
+ * @param [size] Takes the size in bytes, rounded up to a multiple of SMATH_ALLOC_ALIGNMENT.
+ * @return [bool] Returns false if the allocation failed.
+ */
+extern bool smath_arena_create(smath_arena *a, size_t size);
+
+/**
+ * @brief Put an arena over memory of the caller, e.g. a static or stack array.
+ *
+ * @param [*a] Takes a pointer to the smath_arena to initialize.
+ * @param [*memory] Takes a pointer to size bytes, it has to outlive the arena.
+ * @param [size] Takes the size in bytes.
+ */
+extern void smath_arena_init(smath_arena *a, void *memory, size_t size);
+
+/**
+ * @brief Free the block of an arena, memory of smath_arena_init is left alone.
+ *
+ * @param [*a] Takes a pointer to an smath_arena.
+ */
+extern void smath_arena_destroy(smath_arena *a);
+
+/**
+ * @brief Allocate from an arena.
+ *
+ * @param [*a] Takes a pointer to an smath_arena.
+ * @param [size] Takes the size in bytes.
+ * @param [alignment] Takes the alignment, a power of 2, 0 for SMATH_ALLOC_ALIGNMENT.
+ * @return [void*] Returns a pointer to the memory, NULL if the arena is full or the alignment is not a power of 2.
+ */
+extern void *smath_arena_alloc(smath_arena *a, size_t size, size_t alignment);
+
+/**
+ * @brief Allocate an array from an arena, count * size checked for overflow.
+ *
+ * @param [*a] Takes a pointer to an smath_arena.
+ * @param [count] Takes the number of elements.
+ * @param [size] Takes the size of an element in bytes.
+ * @param [alignment] Takes the alignment, a power of 2, 0 for SMATH_ALLOC_ALIGNMENT.
+ * @return [void*] Returns a pointer to the memory, NULL if the arena is full, the size overflows or the alignment is not a power of 2.
+ */
+extern void *smath_arena_alloc_array(smath_arena *a, size_t count, size_t size, size_t alignment);
+
+/**
+ * @brief Get the current offset of an arena, to rewind to it later.
+ *
+ * @param [*a] Takes a pointer to an smath_arena.
+ * @return [size_t] Returns the offset.
+ */
+extern size_t smath_arena_mark(const smath_arena *a);
+
+/**
+ * @brief Drop everything allocated since a mark.
+ *
+ * @param [*a] Takes a pointer to an smath_arena.
+ * @param [mark] Takes an offset of smath_arena_mark, not above the current one.
+ * @return [bool] Returns false and leaves the arena alone if mark is above the current offset.
+ */
+extern bool smath_arena_rewind(smath_arena *a, size_t mark);
+
+/**
+ * @brief Drop everything allocated from an arena.
+ *
+ * @param [*a] Takes a pointer to an smath_arena.
+ */
+extern void smath_arena_reset(smath_arena *a);
+
+/**
+ * @brief Allocate the blocks of a pool.
+ *
+ * The blocks are 16 byte aligned, 64 byte aligned when the rounded block
+ * size is a multiple of 64, as for mat4x4 and dmat4x4.
+ *
+ * @param [*p] Takes a pointer to the smath_block_pool to initialize.
+ * @param [block_size] Takes the size of a block in bytes.
+ * @param [capacity] Takes the number of blocks.
+ * @return [bool] Returns false if the allocation failed.
+ */
+extern bool smath_block_pool_create(smath_block_pool *p, size_t block_size, size_t capacity);
+
+/**
+ * @brief Free the blocks of a pool.
+ *
+ * @param [*p] Takes a pointer to an smath_block_pool.
+ */
+extern void smath_block_pool_destroy(smath_block_pool *p);
+
+/**
+ * @brief Take a block from a pool.
+ *
+ * @param [*p] Takes a pointer to an smath_block_pool.
+ * @return [void*] Returns a pointer to the block, NULL if all blocks are in use.
+ */
+extern void *smath_block_pool_alloc(smath_block_pool *p);
+
+/**
+ * @brief Give a block back to its pool.
+ *
+ * @param [*p] Takes a pointer to an smath_block_pool.
+ * @param [*block] Takes a pointer to a block of smath_block_pool_alloc of this pool, or NULL.
+ * @return [bool] Returns false and leaves the pool alone if block is not the start of a block
+ *                that was handed out or no block is in use, true for NULL.
+ */
+extern bool smath_block_pool_free(smath_block_pool *p, void *block);
+
+/**
+ * @brief Give all blocks back to a pool.
+ *
+ * @param [*p] Takes a pointer to an smath_block_pool.
+ */
+extern void smath_block_pool_reset(smath_block_pool *p);
+
+/**
+ * @brief Describe an array of the caller.
+ *
+ * @param [*data] Takes a pointer to the first element.
+ * @param [count] Takes the number of elements.
+ * @param [stride] Takes the bytes from one element to the next.
+ * @param [alignment] Takes the alignment of data and of every element.
+ * @return [smath_buffer] Returns the descriptor, check it with smath_buffer_check.
+ */
+extern smath_buffer smath_buffer_wrap(void *data, size_t count, size_t stride, size_t alignment);
+
+/**
+ * @brief Allocate a buffer of packed elements.
+ *
+ * @param [*b] Takes a pointer to the smath_buffer to initialize.
+ * @param [count] Takes the number of elements.
+ * @param [stride] Takes the size of an element, rounded up to a multiple of the alignment.
+ * @param [alignment] Takes the alignment, a power of 2, 0 for SMATH_ALLOC_ALIGNMENT.
+ * @return [bool] Returns false if the allocation failed.
+ */
+extern bool smath_buffer_create(smath_buffer *b, size_t count, size_t stride, size_t alignment);
+
+/**
+ * @brief Allocate a buffer of packed elements from an arena.
+ *
+ * Freed with the arena, not with smath_buffer_destroy.
+ *
+ * @param [*b] Takes a pointer to the smath_buffer to initialize.
+ * @param [*a] Takes a pointer to an smath_arena.
+ * @param [count] Takes the number of elements.
+ * @param [stride] Takes the size of an element, rounded up to a multiple of the alignment.
+ * @param [alignment] Takes the alignment, a power of 2, 0 for SMATH_ALLOC_ALIGNMENT.
+ * @return [bool] Returns false if the arena is full.
+ */
+extern bool smath_buffer_from_arena(smath_buffer *b, smath_arena *a, size_t count, size_t stride, size_t alignment);
+
+/**
+ * @brief Free a buffer of smath_buffer_create.
+ *
+ * @param [*b] Takes a pointer to an smath_buffer.
+ */
+extern void smath_buffer_destroy(smath_buffer *b);
+
+/**
+ * @brief Check a buffer against the elements a function reads or writes.
+ *
+ * @param [*b] Takes a pointer to an smath_buffer.
+ * @param [element_size] Takes the size of an element.
+ * @param [alignment] Takes the alignment the elements need, a power of 2, 1 for none.
+ * @param [count] Takes the number of elements needed.
+ * @return [smath_buffer_status] Returns SMATH_BUFFER_OK or the first problem found.
+ */
+extern smath_buffer_status smath_buffer_check(const smath_buffer *b, size_t element_size, size_t alignment, size_t count);
+
+/**
+ * @brief Get the name of a buffer status, for logs.
+ *
+ * @param [status] Takes an smath_buffer_status.
+ * @return [const char*] Returns the name, "unknown" for values out of range.
+ */
+extern const char *smath_buffer_status_name(smath_buffer_status status);
+
+/**
+ * @brief Multiply two buffers of mat4x4 pairwise, like mat4x4_mult_array (dispatch.h).
+ *
+ * The buffers need 64 byte aligned elements, the alignment of mat4x4,
+ * and dest needs m0->count of them. Packed buffers go through the dispatched kernel, strided ones
+ * through mat4x4_mult one by one.
+ *
+ * @param [*dest] Takes a pointer to an smath_buffer of mat4x4, can be m0 or m1.
+ * @param [*m0] Takes a pointer to an smath_buffer of mat4x4.
+ * @param [*m1] Takes a pointer to an smath_buffer of at least m0->count mat4x4.
+ * @return [smath_buffer_status] Returns SMATH_BUFFER_OK, or the problem of the first bad buffer and nothing is written.
+ */
+extern smath_buffer_status mat4x4_mult_buffer(smath_buffer *dest, const smath_buffer *m0, const smath_buffer *m1);
+
+/**
+ * @brief Transform a buffer of vec4 with a 4x4 matrix, like mat4x4_transform_vec4s (transform.h).
+ *
+ * The buffers need 16 byte aligned elements and out needs in->count of
+ * them. Packed buffers go through the dispatched kernel, strided ones
+ * through mat4x4_vec4_mult one by one.
+ *
+ * @param [*m] Takes a pointer to a mat4x4.
+ * @param [*in] Takes a pointer to an smath_buffer of vec4.
+ * @param [*out] Takes a pointer to an smath_buffer of vec4, can be in.
+ * @return [smath_buffer_status] Returns SMATH_BUFFER_OK, or the problem of the first bad buffer and nothing is written.
+ */
+extern smath_buffer_status mat4x4_transform_vec4s_buffer(const mat4x4 *m, const smath_buffer *in, smath_buffer *out);
+
+/** @}*/
+
+#endif // ALLOCATOR_H
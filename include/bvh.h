@@ -0,0 +1,157 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "math_types.h"
+#include "types.h"
+#include "culling.h"
+#include "ray.h"
+
+/** @defgroup bvh_ A bounding volume hierarchy over axis aligned boxes.
+ *
+ * smath_bvh_create builds the tree top down with a binned surface area
+ * heuristic and writes it depth first into one 64 byte aligned array of
+ * aabb_node (culling.h). The first child of an inner node follows it
+ * directly and the second one starts at the skip of the first, a leaf
+ * holds the slots [first, first + count). So the same array goes into
+ * frustum_cull_aabb_tree, which then sets the bits of the slots, and
+ * objects maps a slot back to the index of its box.
+ *
+ * The queries never allocate. The ray and nearest point queries visit
+ * the nearer child first with a small fixed stack, the overlap query and
+ * the packet query walk the array front to back and jump to skip over
+ * the subtrees they reject, without a stack.
+ *
+ * After the objects moved, smath_bvh_refit recomputes the boxes bottom up
+ * in one pass and keeps the tree. That is much cheaper than a rebuild but
+ * the tree gets worse the further the objects move from where it was
+ * built.
+ *
+ * @note Only available in the archive build, not with SMATH_HEADER_ONLY.
+ * @{
+ */
+
+
+/** @brief The object of a query without a hit. */
+#define SMATH_BVH_NONE 0xFFFFFFFFu
+
+/**
+ * @brief A bounding volume hierarchy.
+ *
+ * Read the fields, change them only through the functions below.
+ */
+typedef struct smath_bvh {
+        aabb_node *nodes;       /**< the nodes depth first, the root first, 64 byte aligned */
+        aabb *boxes;            /**< the box of every slot */
+        u32 *objects;           /**< the index of the box of every slot */
+
+        size_t node_count;
+        size_t count;           /**< the number of boxes and slots */
+} smath_bvh;
+
+/**
+ * @brief The exact test of an object against a ray.
+ *
+ * Same as the ray_intersect_ functions (ray.h), called after the box of the object was hit.
+ *
+ * @return [bool] Returns true and writes t if the ray hits the object closer than t_max.
+ */
+typedef bool (*smath_bvh_ray_fn)(void *user, u32 object, const ray *r, f32 t_max, f32 *t);
+
+/**
+ * @brief The exact squared distance of a point to an object.
+ *
+ * Called for an object whose box is closer than the nearest object so far.
+ */
+typedef f32 (*smath_bvh_distance_fn)(void *user, u32 object, const vec3 *p);
+
+
+/**
+ * @brief Build a hierarchy over boxes.
+ *
+ * @param [*bvh] Takes a pointer to the smath_bvh to initialize.
+ * @param [*boxes] Takes a pointer to count boxes.
+ * @param [count] Takes the number of boxes, less than 2^31.
+ * @return [bool] Returns false if the allocation failed.
+ */
+extern bool smath_bvh_create(smath_bvh *bvh, const aabb *boxes, size_t count);
+
+/**
+ * @brief Free the arrays of a hierarchy.
+ *
+ * @param [*bvh] Takes a pointer to a smath_bvh.
+ */
+extern void smath_bvh_destroy(smath_bvh *bvh);
+
+/**
+ * @brief Recompute the boxes of every slot and node, the tree stays the same.
+ *
+ * @param [*bvh] Takes a pointer to a smath_bvh.
+ * @param [*boxes] Takes a pointer to the new boxes, in the order of smath_bvh_create.
+ */
+extern void smath_bvh_refit(smath_bvh *bvh, const aabb *boxes);
+
+/**
+ * @brief Find the nearest object a ray hits.
+ *
+ * @param [*bvh] Takes a pointer to a smath_bvh.
+ * @param [*r] Takes a pointer to a ray.
+ * @param [t_max] Takes the distance a hit has to be closer than.
+ * @param [fn] Takes the exact test, NULL to hit the boxes.
+ * @param [*user] Takes a pointer that is passed on to fn.
+ * @param [*t] Takes a pointer to a float for the distance of the hit, only written on a hit.
+ * @param [*object] Takes a pointer for the index of the object, only written on a hit.
+ * @return [bool] Returns true if the ray hits any object.
+ */
+extern bool smath_bvh_intersect_ray(const smath_bvh *bvh, const ray *r, f32 t_max,
+                                    smath_bvh_ray_fn fn, void *user, f32 *t, u32 *object);
+
+/**
+ * @brief Find the nearest object of every ray of a structure of arrays.
+ *
+ * The rays go down the tree together in packets of 64, every node is
+ * tested against the whole packet with ray_soa_intersect_aabb (ray.h).
+ * Rays that start close together and point the same way share most of
+ * their nodes, for scattered rays smath_bvh_intersect_ray is faster.
+ *
+ * @param [*bvh] Takes a pointer to a smath_bvh.
+ * @param [*r] Takes a pointer to a ray_soa.
+ * @param [fn] Takes the exact test, NULL to hit the boxes.
+ * @param [*user] Takes a pointer that is passed on to fn.
+ * @param [*t] Takes a pointer to r->origin.count floats, the distance a hit has to be closer than, set to the distance of the hit.
+ * @param [*object] Takes a pointer to r->origin.count indices for the objects, SMATH_BVH_NONE for a miss.
+ */
+extern void smath_bvh_intersect_rays(const smath_bvh *bvh, const ray_soa *r,
+                                     smath_bvh_ray_fn fn, void *user, f32 *t, u32 *object);
+
+/**
+ * @brief Find the objects whose box overlaps a box.
+ *
+ * @param [*bvh] Takes a pointer to a smath_bvh.
+ * @param [*box] Takes a pointer to an aabb.
+ * @param [*out] Takes a pointer to max indices for the objects.
+ * @param [max] Takes the number of indices out can hold.
+ * @return [size_t] Returns the number of overlapping objects, only the first max are written.
+ */
+extern size_t smath_bvh_query_aabb(const smath_bvh *bvh, const aabb *box, u32 *out, size_t max);
+
+/**
+ * @brief Find the object nearest to a point.
+ *
+ * @param [*bvh] Takes a pointer to a smath_bvh.
+ * @param [*p] Takes a pointer to a vec3.
+ * @param [max_dist_sq] Takes the squared distance the object has to be closer than.
+ * @param [fn] Takes the exact squared distance, NULL for the distance to the boxes.
+ * @param [*user] Takes a pointer that is passed on to fn.
+ * @param [*dist_sq] Takes a pointer to a float for the squared distance, only written when an object was found.
+ * @param [*object] Takes a pointer for the index of the object, only written when an object was found.
+ * @return [bool] Returns true if an object is closer than max_dist_sq.
+ */
+extern bool smath_bvh_nearest(const smath_bvh *bvh, const vec3 *p, f32 max_dist_sq,
+                              smath_bvh_distance_fn fn, void *user, f32 *dist_sq, u32 *object);
+
+/** @}*/
+
+#endif // BVH_H
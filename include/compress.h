@@ -0,0 +1,253 @@
+#ifndef COMPRESS_H
+#define COMPRESS_H
+
+#include <stddef.h>
+
+#include "math_types.h"
+#include "types.h"
+
+/** @defgroup compress_ Compressed storage of floats, normals and quaternions.
+ *
+ * Scalars are packed to half floats or to signed/unsigned normalized
+ * integers, unit vectors to 10-10-10-2 or to octahedral coordinates and
+ * unit quaternions to their smallest three components. Every packed value
+ * unpacks to the nearest representable float, the pack and unpack
+ * functions of one element and the batch kernels give the same bits
+ * (NaN payloads aside).
+ *
+ * The batch functions go through the dispatched kernels (dispatch.h), half
+ * floats are converted by F16C/AVX-512 where the CPU has it.
+ *
+ * @note Only available in the archive build, not with SMATH_HEADER_ONLY.
+ * @{
+ */
+
+
+/** @brief The formats of smath_pack_array and smath_unpack_array. */
+typedef enum smath_pack_format {
+        SMATH_PACK_F16 = 0,     /**< u16 IEEE half float, rounded to nearest even */
+        SMATH_PACK_SNORM16,     /**< i16, [-1, 1] to [-32767, 32767] */
+        SMATH_PACK_UNORM16,     /**< u16, [0, 1] to [0, 65535] */
+        SMATH_PACK_SNORM8,      /**< i8, [-1, 1] to [-127, 127] */
+        SMATH_PACK_UNORM8       /**< u8, [0, 1] to [0, 255] */
+} smath_pack_format;
+
+/** @brief The largest the 3 smallest components of a unit quaternion can be, 1 / sqrt(2). */
+#define SMATH_SMALLEST3_MAX 0.70710678f
+
+
+/**
+ * @brief Convert a float to a half float.
+ *
+ * @param [f] Takes a float, too large ones become infinity.
+ * @return [u16] Returns the bits of the half float, rounded to nearest even.
+ */
+extern u16 f32_to_f16(f32 f);
+
+/**
+ * @brief Convert a half float to a float, exact.
+ *
+ * @param [h] Takes the bits of a half float.
+ * @return [f32] Returns the float.
+ */
+extern f32 f16_to_f32(u16 h);
+
+/**
+ * @brief Quantize a float in [-1, 1] to 16 bits, NaN becomes -1.
+ *
+ * @param [f] Takes a float, clamped to [-1, 1].
+ * @return [i16] Returns round(f * 32767).
+ */
+extern i16 f32_to_snorm16(f32 f);
+
+/**
+ * @brief Expand a signed normalized 16-bit integer.
+ *
+ * @param [s] Takes an i16.
+ * @return [f32] Returns s / 32767, -32768 becomes -1.
+ */
+extern f32 snorm16_to_f32(i16 s);
+
+/**
+ * @brief Quantize a float in [0, 1] to 16 bits, NaN becomes 0.
+ *
+ * @param [f] Takes a float, clamped to [0, 1].
+ * @return [u16] Returns round(f * 65535).
+ */
+extern u16 f32_to_unorm16(f32 f);
+
+/**
+ * @brief Expand an unsigned normalized 16-bit integer.
+ *
+ * @param [u] Takes a u16.
+ * @return [f32] Returns u / 65535.
+ */
+extern f32 unorm16_to_f32(u16 u);
+
+/**
+ * @brief Quantize a float in [-1, 1] to 8 bits, NaN becomes -1.
+ *
+ * @param [f] Takes a float, clamped to [-1, 1].
+ * @return [i8] Returns round(f * 127).
+ */
+extern i8 f32_to_snorm8(f32 f);
+
+/**
+ * @brief Expand a signed normalized 8-bit integer.
+ *
+ * @param [s] Takes an i8.
+ * @return [f32] Returns s / 127, -128 becomes -1.
+ */
+extern f32 snorm8_to_f32(i8 s);
+
+/**
+ * @brief Quantize a float in [0, 1] to 8 bits, NaN becomes 0.
+ *
+ * @param [f] Takes a float, clamped to [0, 1].
+ * @return [u8] Returns round(f * 255).
+ */
+extern u8 f32_to_unorm8(f32 f);
+
+/**
+ * @brief Expand an unsigned normalized 8-bit integer.
+ *
+ * @param [u] Takes a u8.
+ * @return [f32] Returns u / 255.
+ */
+extern f32 unorm8_to_f32(u8 u);
+
+/**
+ * @brief Pack a vector to 10-10-10-2 bits, signed normalized.
+ *
+ * x, y and z are 10 bits each (bit 0, 10 and 20) and w 2 bits (bit 30),
+ * like VK_FORMAT_A2B10G10R10_SNORM_PACK32. w is -1, 0 or 1, the sign of a
+ * tangent for example.
+ *
+ * @param [*v] Takes a pointer to a vec4, every component in [-1, 1].
+ * @return [u32] Returns the packed vector.
+ */
+extern u32 vec4_pack_10_10_10_2(const vec4 *v);
+
+/**
+ * @brief Unpack a 10-10-10-2 vector.
+ *
+ * @param [p] Takes a packed vector.
+ * @return [vec4] Returns the vector, not normalized.
+ */
+extern vec4 vec4_unpack_10_10_10_2(u32 p);
+
+/**
+ * @brief Encode a unit vector with octahedral coordinates, 16 bits each.
+ *
+ * The vector is projected on the octahedron |x| + |y| + |z| = 1 and the
+ * lower half folded over the upper one, x is in the low 16 bits.
+ *
+ * @param [*v] Takes a pointer to a vec3, the length does not matter.
+ * @return [u32] Returns the two snorm16 coordinates.
+ */
+extern u32 vec3_encode_octahedral(const vec3 *v);
+
+/**
+ * @brief Decode octahedral coordinates.
+ *
+ * @param [p] Takes the encoded vector.
+ * @return [vec3] Returns the unit vector.
+ */
+extern vec3 vec3_decode_octahedral(u32 p);
+
+/**
+ * @brief Pack a unit quaternion to its smallest three components.
+ *
+ * The largest component is left out and rebuilt from the unit length, its
+ * index is in bit 30 and 31 and the other three are 10 bits each, scaled
+ * by 1 / SMATH_SMALLEST3_MAX. The quaternion is negated first when the
+ * largest component is negative, q and -q are the same rotation.
+ *
+ * @param [*q] Takes a pointer to a unit quat.
+ * @return [u32] Returns the packed quaternion.
+ */
+extern u32 quat_pack_smallest3(const quat *q);
+
+/**
+ * @brief Unpack a smallest three quaternion.
+ *
+ * @param [p] Takes a packed quaternion.
+ * @return [quat] Returns the unit quaternion.
+ */
+extern quat quat_unpack_smallest3(u32 p);
+
+
+/**
+ * @brief Pack an array of floats.
+ *
+ * @param [*dest] Takes a pointer to n elements of the format.
+ * @param [*src] Takes a pointer to n f32.
+ * @param [n] Takes the number of elements.
+ * @param [fmt] Takes the format of dest.
+ */
+extern void smath_pack_array(void *dest, const f32 *src, size_t n, smath_pack_format fmt);
+
+/**
+ * @brief Unpack an array to floats.
+ *
+ * @param [*dest] Takes a pointer to n f32.
+ * @param [*src] Takes a pointer to n elements of the format.
+ * @param [n] Takes the number of elements.
+ * @param [fmt] Takes the format of src.
+ */
+extern void smath_unpack_array(f32 *dest, const void *src, size_t n, smath_pack_format fmt);
+
+/**
+ * @brief Pack a structure of arrays of vectors with vec4_pack_10_10_10_2.
+ *
+ * @param [*dest] Takes a pointer to v->count u32.
+ * @param [*v] Takes a pointer to a vec4_soa.
+ */
+extern void vec4_soa_pack_10_10_10_2(u32 *dest, const vec4_soa *v);
+
+/**
+ * @brief Unpack 10-10-10-2 vectors into a structure of arrays.
+ *
+ * @param [*dest] Takes a pointer to a vec4_soa with a capacity of at least n.
+ * @param [*src] Takes a pointer to n packed vectors.
+ * @param [n] Takes the number of vectors, it becomes the count of dest.
+ */
+extern void vec4_soa_unpack_10_10_10_2(vec4_soa *dest, const u32 *src, size_t n);
+
+/**
+ * @brief Encode a structure of arrays of vectors with vec3_encode_octahedral.
+ *
+ * @param [*dest] Takes a pointer to v->count u32.
+ * @param [*v] Takes a pointer to a vec3_soa.
+ */
+extern void vec3_soa_encode_octahedral(u32 *dest, const vec3_soa *v);
+
+/**
+ * @brief Decode octahedral vectors into a structure of arrays.
+ *
+ * @param [*dest] Takes a pointer to a vec3_soa with a capacity of at least n.
+ * @param [*src] Takes a pointer to n encoded vectors.
+ * @param [n] Takes the number of vectors, it becomes the count of dest.
+ */
+extern void vec3_soa_decode_octahedral(vec3_soa *dest, const u32 *src, size_t n);
+
+/**
+ * @brief Pack a structure of arrays of quaternions with quat_pack_smallest3.
+ *
+ * @param [*dest] Takes a pointer to q->count u32.
+ * @param [*q] Takes a pointer to a vec4_soa of unit quaternions.
+ */
+extern void quat_soa_pack_smallest3(u32 *dest, const vec4_soa *q);
+
+/**
+ * @brief Unpack smallest three quaternions into a structure of arrays.
+ *
+ * @param [*dest] Takes a pointer to a vec4_soa with a capacity of at least n.
+ * @param [*src] Takes a pointer to n packed quaternions.
+ * @param [n] Takes the number of quaternions, it becomes the count of dest.
+ */
+extern void quat_soa_unpack_smallest3(vec4_soa *dest, const u32 *src, size_t n);
+
+/** @}*/
+
+#endif // COMPRESS_H
@@ -0,0 +1,138 @@
+#ifndef CULLING_H
+#define CULLING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "math_types.h"
+#include "types.h"
+#include "mat4x4.h"
+
+/** @defgroup culling_ Frustum culling of bounding spheres and boxes.
+ *
+ * The frustum planes are extracted from a view-projection matrix (column
+ * vectors, clip = m * p) and normalized, the normals point inwards.
+ *
+ * The batch functions test a structure of arrays against all 6 planes and
+ * write a visibility bitmask, bit i % 32 of visible[i / 32] is set when
+ * object i may be visible. visible has to hold (count + 31) / 32 words, the
+ * bits past count are cleared. They go through the dispatched kernels
+ * (dispatch.h). The tests are conservative: an object near a corner of
+ * the frustum can be reported visible although it is outside.
+ *
+ * @note Only available in the archive build, not with SMATH_HEADER_ONLY.
+ * @{
+ */
+
+
+/** @brief The index of every plane in frustum.p. */
+enum {
+        FRUSTUM_LEFT = 0,
+        FRUSTUM_RIGHT,
+        FRUSTUM_BOTTOM,
+        FRUSTUM_TOP,
+        FRUSTUM_NEAR,
+        FRUSTUM_FAR
+};
+
+/**
+ * @brief A node of a bounding volume hierarchy in depth first order.
+ *
+ * The children of a node follow it directly, skip is the index of the
+ * first node after the whole subtree, so a traversal needs no stack.
+ * A leaf holds the objects [first, first + count), an inner node has a
+ * count of 0.
+ */
+typedef struct aabb_node {
+        aabb box;
+        u32 skip;
+        u32 first;
+        u32 count;
+} aabb_node;
+
+
+/**
+ * @brief Extract the 6 frustum planes of a view-projection matrix.
+ *
+ * An infinite far plane comes out as (0, 0, 0, w) with w > 0, which every
+ * point passes.
+ *
+ * @param [*f] Takes a pointer to the frustum for the planes.
+ * @param [*m] Takes a pointer to the view-projection mat4x4.
+ * @param [depth] Takes the clip space depth range of the projection.
+ */
+extern void frustum_from_mat4x4(frustum *f, const mat4x4 *m, smath_clip_depth depth);
+
+/**
+ * @brief Scale a plane so its normal has unit length, a zero normal is left as it is.
+ *
+ * @param [*p] Takes a pointer to a plane.
+ */
+extern void plane_normalize(plane *p);
+
+/**
+ * @brief Signed distance of a point to a plane with a unit normal.
+ *
+ * @param [*p] Takes a pointer to a plane.
+ * @param [*v] Takes a pointer to a vec3.
+ * @return [f32] Returns dot(normal, v) + w, positive on the inside.
+ */
+extern f32 plane_distance(const plane *p, const vec3 *v);
+
+/**
+ * @brief Test one bounding sphere against the frustum.
+ *
+ * @param [*f] Takes a pointer to a frustum.
+ * @param [*s] Takes a pointer to a sphere.
+ * @return [bool] Returns false if the sphere is completely outside a plane.
+ */
+extern bool frustum_test_sphere(const frustum *f, const sphere *s);
+
+/**
+ * @brief Test one bounding box against the frustum.
+ *
+ * @param [*f] Takes a pointer to a frustum.
+ * @param [*b] Takes a pointer to an aabb.
+ * @return [bool] Returns false if the box is completely outside a plane.
+ */
+extern bool frustum_test_aabb(const frustum *f, const aabb *b);
+
+/**
+ * @brief Test a structure of arrays of bounding spheres against the frustum.
+ *
+ * @param [*f] Takes a pointer to a frustum.
+ * @param [*s] Takes a pointer to a sphere_soa.
+ * @param [*visible] Takes a pointer to (s->count + 31) / 32 words for the bitmask.
+ */
+extern void frustum_cull_spheres(const frustum *f, const sphere_soa *s, u32 *visible);
+
+/**
+ * @brief Test a structure of arrays of bounding boxes against the frustum.
+ *
+ * @param [*f] Takes a pointer to a frustum.
+ * @param [*b] Takes a pointer to an aabb_soa.
+ * @param [*visible] Takes a pointer to (b->min.count + 31) / 32 words for the bitmask.
+ */
+extern void frustum_cull_aabbs(const frustum *f, const aabb_soa *b, u32 *visible);
+
+/**
+ * @brief Cull a bounding volume hierarchy against the frustum.
+ *
+ * A subtree outside a plane is skipped, a plane the node is completely
+ * inside of is not tested again below it, and a subtree inside all
+ * planes is accepted without further tests. The objects of a partially
+ * visible leaf are tested one by one when objects is given, otherwise
+ * they are all reported visible.
+ *
+ * @param [*f] Takes a pointer to a frustum.
+ * @param [*nodes] Takes a pointer to count aabb_node, the root first.
+ * @param [count] Takes the number of nodes.
+ * @param [*objects] Takes a pointer to the boxes of the objects, can be NULL.
+ * @param [*visible] Takes a pointer to the bitmask, cleared by the caller, the bits of the visible objects are set.
+ */
+extern void frustum_cull_aabb_tree(const frustum *f, const aabb_node *nodes, size_t count,
+                                   const aabb_soa *objects, u32 *visible);
+
+/** @}*/
+
+#endif // CULLING_H
@@ -0,0 +1,202 @@
+#ifndef DISPATCH_H
+#define DISPATCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "math_types.h"
+#include "types.h"
+#include "mat4x4.h"
+#include "mat4x3.h"
+#include "transcendental.h"
+#include "skinning.h"
+#include "compress.h"
+#include "dtransform.h"
+
+/** @defgroup dispatch_ Runtime CPU feature detection and kernel dispatch.
+ *
+ * The batch and matrix kernels are compiled once per instruction set
+ * (src/kernels_sse2.c, src/kernels_sse41.c, src/kernels_avx2.c,
+ * src/kernels_avx512.c) and the best one the CPU supports is bound into
+ * a table of function pointers the first time it is needed.
+ *
+ * The environment variable SMATH_ISA (scalar, sse2, sse41, avx2, avx512)
+ * lowers the selected instruction set for testing, it never selects one
+ * the CPU does not support. An unknown name is reported on stderr and the
+ * best instruction set is used as without it.
+ *
+ * @note Only available in the archive build, not with SMATH_HEADER_ONLY.
+ * @{
+ */
+
+
+/** @brief The instruction sets a kernel table can be bound to, in increasing order. */
+typedef enum smath_isa {
+        SMATH_ISA_SCALAR = 0,
+        SMATH_ISA_SSE2,
+        SMATH_ISA_SSE41,
+        SMATH_ISA_AVX2,         /**< AVX2 + FMA + F16C */
+        SMATH_ISA_AVX512,       /**< AVX-512F */
+        SMATH_ISA_COUNT
+} smath_isa;
+
+
+/** @brief A table with the best kernel of every dispatched function. */
+typedef struct smath_kernels {
+        /** @brief The instruction set the table is bound to. */
+        smath_isa isa;
+
+        /** @brief Same as mat4x4_mult. */
+        mat4x4 (*mat4x4_mult)(const mat4x4 *m0, const mat4x4 *m1);
+
+        /** @brief Same as mat4x4_vec4_mult. */
+        vec4 (*mat4x4_vec4_mult)(const mat4x4 *m, const vec4 *v);
+
+        /** @brief Same as mat4x4_mult_array. */
+        void (*mat4x4_mult_array)(mat4x4 *dest, const mat4x4 *m0, const mat4x4 *m1, size_t n);
+
+        /** @brief Same as mat4x4_transform_points (transform.h). */
+        void (*mat4x4_transform_points)(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n);
+
+        /** @brief Same as mat4x4_transform_directions (transform.h). */
+        void (*mat4x4_transform_directions)(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n);
+
+        /** @brief Same as mat4x4_transform_vec4s (transform.h). */
+        void (*mat4x4_transform_vec4s)(const mat4x4 *m, const vec4 *in, vec4 *out, size_t n);
+
+        /** @brief Same as mat4x4_transform_points_stream (transform.h). */
+        void (*mat4x4_transform_points_stream)(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n);
+
+        /** @brief Same as mat4x4_transform_vec4s_stream (transform.h). */
+        void (*mat4x4_transform_vec4s_stream)(const mat4x4 *m, const vec4 *in, vec4 *out, size_t n);
+
+        /** @brief Same as mat4x4_from_trs_array, mat4x4_from_trs_mult_array and mat4x3_from_trs_array (transform.h). */
+        void (*mat4x4_from_trs_array)(mat4x4 *dest, const vec3 *t, const quat *r, const vec3 *s, size_t n);
+        void (*mat4x4_from_trs_mult_array)(mat4x4 *dest, const mat4x4 *m, const vec3 *t, const quat *r, const vec3 *s, size_t n);
+        void (*mat4x3_from_trs_array)(mat4x3 *dest, const vec3 *t, const quat *r, const vec3 *s, size_t n);
+
+        /** @brief Same as the vec3_soa_ functions (vector_soa.h). */
+        void (*vec3_soa_from_aos)(vec3_soa *dest, const vec3 *src, size_t n);
+        void (*vec3_soa_to_aos)(vec3 *dest, const vec3_soa *src);
+        void (*vec3_soa_add)(vec3_soa *v, const vec3_soa *v1);
+        void (*vec3_soa_sub)(vec3_soa *v, const vec3_soa *v1);
+        void (*vec3_soa_scalar_mult)(vec3_soa *v, const f32 s);
+        void (*vec3_soa_magnitude)(const vec3_soa *v, f32 *out);
+        void (*vec3_soa_normalize)(vec3_soa *v);
+        void (*vec3_soa_fast_normalize)(vec3_soa *v);
+        void (*vec3_soa_dot)(const vec3_soa *v, const vec3_soa *v1, f32 *out);
+        void (*vec3_soa_cross_product)(vec3_soa *dest, const vec3_soa *v, const vec3_soa *v1);
+
+        /** @brief Same as the vec4_soa_ functions (vector_soa.h). */
+        void (*vec4_soa_from_aos)(vec4_soa *dest, const vec4 *src, size_t n);
+        void (*vec4_soa_to_aos)(vec4 *dest, const vec4_soa *src);
+        void (*vec4_soa_add)(vec4_soa *v, const vec4_soa *v1);
+        void (*vec4_soa_sub)(vec4_soa *v, const vec4_soa *v1);
+        void (*vec4_soa_scalar_mult)(vec4_soa *v, const f32 s);
+        void (*vec4_soa_magnitude)(const vec4_soa *v, f32 *out);
+        void (*vec4_soa_normalize)(vec4_soa *v);
+        void (*vec4_soa_fast_normalize)(vec4_soa *v);
+        void (*vec4_soa_dot)(const vec4_soa *v, const vec4_soa *v1, f32 *out);
+
+        /** @brief Same as quat_soa_nlerp and quat_soa_slerp (vector_soa.h). */
+        void (*quat_soa_nlerp)(vec4_soa *dest, const vec4_soa *q0, const vec4_soa *q1, const f32 *t);
+        void (*quat_soa_slerp)(vec4_soa *dest, const vec4_soa *q0, const vec4_soa *q1, const f32 *t);
+
+        /** @brief Same as the smath_<fn>_array functions (transcendental.h). */
+        void (*sin_array)(f32 *dest, const f32 *x, size_t n, smath_accuracy acc);
+        void (*cos_array)(f32 *dest, const f32 *x, size_t n, smath_accuracy acc);
+        void (*sincos_array)(f32 *dest_sin, f32 *dest_cos, const f32 *x, size_t n, smath_accuracy acc);
+        void (*atan2_array)(f32 *dest, const f32 *y, const f32 *x, size_t n, smath_accuracy acc);
+        void (*exp_array)(f32 *dest, const f32 *x, size_t n, smath_accuracy acc);
+        void (*log_array)(f32 *dest, const f32 *x, size_t n, smath_accuracy acc);
+        void (*pow_array)(f32 *dest, const f32 *x, const f32 *y, size_t n, smath_accuracy acc);
+
+        /** @brief Same as frustum_cull_spheres and frustum_cull_aabbs (culling.h). */
+        void (*frustum_cull_spheres)(const frustum *f, const sphere_soa *s, u32 *visible);
+        void (*frustum_cull_aabbs)(const frustum *f, const aabb_soa *b, u32 *visible);
+
+        /** @brief Same as the packet tests of ray.h. */
+        bool (*ray_intersect_triangles)(const ray *r, const triangle_soa *tris, f32 t_max, f32 *t, size_t *index);
+        bool (*ray_intersect_spheres)(const ray *r, const sphere_soa *s, f32 t_max, f32 *t, size_t *index);
+        bool (*ray_intersect_aabbs)(const ray *r, const aabb_soa *b, f32 t_max, f32 *t, size_t *index);
+        void (*ray_soa_intersect_aabb)(const ray_soa *r, const aabb *b, const f32 *t_max, f32 *t, u32 *hits);
+        void (*ray_soa_intersect_sphere)(const ray_soa *r, const sphere *s, const f32 *t_max, f32 *t, u32 *hits);
+        void (*ray_soa_intersect_plane)(const ray_soa *r, const plane *p, const f32 *t_max, f32 *t, u32 *hits);
+
+        /** @brief Same as skin_linear and skin_dual_quat (skinning.h). */
+        void (*skin_linear)(const mat3x4 *palette, const skin_influence *influences,
+                            const vec3 *positions, const vec3 *normals,
+                            vec3 *out_positions, vec3 *out_normals, size_t n);
+        void (*skin_dual_quat)(const dual_quat *palette, const skin_influence *influences,
+                               const vec3 *positions, const vec3 *normals,
+                               vec3 *out_positions, vec3 *out_normals, size_t n);
+
+        /** @brief Same as smath_pack_array, smath_unpack_array and the _soa_ pack functions (compress.h). */
+        void (*pack_array)(void *dest, const f32 *src, size_t n, smath_pack_format fmt);
+        void (*unpack_array)(f32 *dest, const void *src, size_t n, smath_pack_format fmt);
+        void (*vec4_soa_pack_10_10_10_2)(u32 *dest, const vec4_soa *v);
+        void (*vec4_soa_unpack_10_10_10_2)(vec4_soa *dest, const u32 *src, size_t n);
+        void (*vec3_soa_encode_octahedral)(u32 *dest, const vec3_soa *v);
+        void (*vec3_soa_decode_octahedral)(vec3_soa *dest, const u32 *src, size_t n);
+        void (*quat_soa_pack_smallest3)(u32 *dest, const vec4_soa *q);
+        void (*quat_soa_unpack_smallest3)(vec4_soa *dest, const u32 *src, size_t n);
+
+        /** @brief Same as dmat4x4_mult_array and the _relative_array conversions (dtransform.h). */
+        void (*dmat4x4_mult_array)(dmat4x4 *dest, const dmat4x4 *m0, const dmat4x4 *m1, size_t n);
+        void (*dmat4x4_to_mat4x4_relative_array)(mat4x4 *dest, const dmat4x4 *src, const dvec3 *origin, size_t n);
+        void (*dvec3_to_vec3_relative_array)(vec3 *dest, const dvec3 *src, const dvec3 *origin, size_t n);
+} smath_kernels;
+
+
+/**
+ * @brief Detect the best instruction set supported by the CPU (and OS).
+ *
+ * @return [smath_isa] Returns the detected instruction set, SMATH_ISA is not taken into account.
+ */
+extern smath_isa smath_cpu_isa(void);
+
+/**
+ * @brief Get the kernel table, it is bound on the first call.
+ *
+ * @return [const smath_kernels*] Returns a pointer to the bound table.
+ * @note Thread-safe, concurrent first calls bind the tables once.
+ */
+extern const smath_kernels *smath_get_kernels(void);
+
+/**
+ * @brief Bind the kernel table to a specific instruction set.
+ *
+ * The instruction set is lowered to what the CPU supports and to what
+ * the library was compiled with.
+ *
+ * @param [isa] Takes the wanted instruction set.
+ * @return [smath_isa] Returns the instruction set the table is bound to.
+ * @note Thread-safe, a batch call already running keeps the table it started with.
+ */
+extern smath_isa smath_set_isa(smath_isa isa);
+
+/**
+ * @brief Get the name of an instruction set, as used by SMATH_ISA.
+ *
+ * @param [isa] Takes an instruction set.
+ * @return [const char*] Returns the name.
+ */
+extern const char *smath_isa_name(smath_isa isa);
+
+
+/**
+ * @brief Multiply two arrays of 4x4 matrices pairwise.
+ *
+ * dest[i] = m0[i] * m1[i] for i in [0, n), using the dispatched kernel.
+ *
+ * @param [*dest] Takes a pointer to n mat4x4.
+ * @param [*m0] Takes a pointer to n mat4x4.
+ * @param [*m1] Takes a pointer to n mat4x4.
+ * @param [n] Takes the number of matrices.
+ * @note dest may be the same array as m0 or m1.
+ */
+extern void mat4x4_mult_array(mat4x4 *dest, const mat4x4 *m0, const mat4x4 *m1, size_t n);
+
+/** @}*/
+
+#endif // DISPATCH_H
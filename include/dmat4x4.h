@@ -0,0 +1,99 @@
+#ifndef DMAT4X4_H
+#define DMAT4X4_H
+
+#include "math_types.h"
+#include "types.h"
+#include "smath_config.h"
+#include "mat4x4.h"
+
+/** @defgroup dmat4x4_ 4x4 matrices in double precision.
+ *
+ * World transforms of large scenes, where the translation needs more
+ * precision than a float has. Every function does the same as the
+ * mat4x4_ function of the same name, both are built from one template
+ * (src/mat4x4_template.h). The layout is the one of mat4x4, t[n] is row
+ * n and the translation is in t[0..2][3].
+ *
+ * For rendering, dmat4x4_to_mat4x4_relative moves the matrix next to a
+ * camera (or any nearby origin) in double and only then rounds it to a
+ * mat4x4. The batch versions are in dtransform.h.
+ * @{
+ */
+
+
+/**
+ * @brief A structure for representing 4x4 matrices in double precision.
+ *
+ * Every row m.t[n] is 32 byte aligned (one AVX register) and the whole
+ * matrix takes two 64 byte cache lines.
+ */
+typedef struct SMATH_ALIGN(64) dmat4x4 {
+        f64 t[4][4];
+} dmat4x4;
+
+
+/** @brief Same as mat4x4_parse, the vectors are the columns. */
+SMATH_API void dmat4x4_parse(dmat4x4 *dest, const dvec4 *v0, const dvec4 *v1, const dvec4 *v2, const dvec4 *v3);
+
+/** @brief Same as mat4x4_create, the vectors are the columns. */
+SMATH_API dmat4x4 dmat4x4_create(const dvec4 *v0, const dvec4 *v1, const dvec4 *v2, const dvec4 *v3);
+
+/** @brief Multiply two 4x4 matrices, m0 * m1. */
+SMATH_API dmat4x4 dmat4x4_mult(const dmat4x4 *m0, const dmat4x4 *m1);
+
+/** @brief Multiply a 4x4 matrix with a 4D vector, m * v. */
+SMATH_API dvec4 dmat4x4_dvec4_mult(const dmat4x4 *m, const dvec4 *v);
+
+/** @brief The determinant of a 4x4 matrix. */
+SMATH_API f64 dmat4x4_determinant(const dmat4x4 *m);
+
+/** @brief Same as mat4x4_inverse, the determinant must not be 0. */
+SMATH_API dmat4x4 dmat4x4_inverse(const dmat4x4 *m);
+
+/** @brief Same as mat4x4_inverse_det, the inverse is only valid when *det is not 0. */
+SMATH_API dmat4x4 dmat4x4_inverse_det(const dmat4x4 *m, f64 *det);
+
+/** @brief Same as mat4x4_inverse_affine, the last row has to be (0, 0, 0, 1). */
+SMATH_API dmat4x4 dmat4x4_inverse_affine(const dmat4x4 *m);
+
+/** @brief Same as mat4x4_inverse_rigid, rotation and translation only. */
+SMATH_API dmat4x4 dmat4x4_inverse_rigid(const dmat4x4 *m);
+
+
+/**
+ * @brief Convert a 4x4 matrix to double precision.
+ *
+ * @param [*m] Takes a pointer to a mat4x4.
+ * @return [dmat4x4] Returns the same matrix as a dmat4x4, exact.
+ */
+SMATH_API dmat4x4 dmat4x4_from_mat4x4(const mat4x4 *m);
+
+/**
+ * @brief Round a double precision 4x4 matrix to floats.
+ *
+ * @param [*m] Takes a pointer to a dmat4x4.
+ * @return [mat4x4] Returns the nearest mat4x4.
+ */
+SMATH_API mat4x4 mat4x4_from_dmat4x4(const dmat4x4 *m);
+
+/**
+ * @brief A double precision transform relative to an origin, as floats.
+ *
+ * The result is translate(-origin) * m, computed in double and then
+ * rounded, so an object next to the origin keeps its precision however
+ * far both are from (0, 0, 0). For an affine m only the translation
+ * changes.
+ *
+ * @param [*m] Takes a pointer to a dmat4x4, e.g. the world matrix of an object.
+ * @param [*origin] Takes a pointer to the origin, e.g. the camera position.
+ * @return [mat4x4] Returns the camera relative matrix.
+ */
+SMATH_API mat4x4 dmat4x4_to_mat4x4_relative(const dmat4x4 *m, const dvec3 *origin);
+
+/** @}*/
+
+#ifdef SMATH_HEADER_ONLY
+#include "../src/dmat4x4.c"
+#endif
+
+#endif // DMAT4X4_H
@@ -0,0 +1,60 @@
+#ifndef DTRANSFORM_H
+#define DTRANSFORM_H
+
+#include <stddef.h>
+
+#include "math_types.h"
+#include "types.h"
+#include "mat4x4.h"
+#include "dmat4x4.h"
+
+/** @defgroup dtransform_ Batches of double precision matrices and positions.
+ *
+ * The array versions of dmat4x4_mult and of the camera relative
+ * conversions of dvector.h and dmat4x4.h, to update a large world in
+ * double and hand it to the renderer as floats once per frame. They go
+ * through the dispatched kernels (see dispatch.h), the AVX2 ones work on
+ * a whole row of 4 doubles per register.
+ *
+ * dest and src of the conversions must not overlap.
+ *
+ * @note Only available in the archive build, not with SMATH_HEADER_ONLY.
+ * @{
+ */
+
+
+/**
+ * @brief Multiply two arrays of double precision 4x4 matrices pairwise.
+ *
+ * dest[i] = m0[i] * m1[i] for i in [0, n).
+ *
+ * @param [*dest] Takes a pointer to n dmat4x4, can be m0 or m1.
+ * @param [*m0] Takes a pointer to n dmat4x4.
+ * @param [*m1] Takes a pointer to n dmat4x4.
+ * @param [n] Takes the number of matrices.
+ */
+extern void dmat4x4_mult_array(dmat4x4 *dest, const dmat4x4 *m0, const dmat4x4 *m1, size_t n);
+
+/**
+ * @brief dmat4x4_to_mat4x4_relative of every matrix with one origin.
+ *
+ * @param [*dest] Takes a pointer to n mat4x4.
+ * @param [*src] Takes a pointer to n dmat4x4.
+ * @param [*origin] Takes a pointer to the origin, e.g. the camera position.
+ * @param [n] Takes the number of matrices.
+ */
+extern void dmat4x4_to_mat4x4_relative_array(mat4x4 *dest, const dmat4x4 *src, const dvec3 *origin, size_t n);
+
+/**
+ * @brief vec3_from_dvec3_relative of every position with one origin.
+ *
+ * @param [*dest] Takes a pointer to n vec3.
+ * @param [*src] Takes a pointer to n dvec3.
+ * @param [*origin] Takes a pointer to the origin, e.g. the camera position.
+ * @param [n] Takes the number of positions.
+ */
+extern void dvec3_to_vec3_relative_array(vec3 *dest, const dvec3 *src, const dvec3 *origin, size_t n);
+
+/** @}*/
+
+#endif // DTRANSFORM_H
@@ -0,0 +1,130 @@
+#ifndef DVECTOR_H
+#define DVECTOR_H
+
+#include "math_types.h"
+#include "types.h"
+#include "smath_config.h"
+
+/** @defgroup dvec_ 2D, 3D and 4D vectors in double precision.
+ *
+ * For positions in large worlds, where a float has only centimeter
+ * precision some 100 km from the origin. Every function does the same as
+ * the vec2_/vec3_/vec4_ function of the same name, both are built from
+ * one template (src/vector_template.h).
+ *
+ * Convert to float vectors for rendering relative to a camera or another
+ * nearby origin with vec3_from_dvec3_relative, the difference is taken
+ * in double so the result keeps its precision. The batch versions are in
+ * dtransform.h.
+ * @{
+ */
+
+
+/** @brief Add v1 to v. */
+SMATH_API void dvec2_add(dvec2 *v, const dvec2 *v1);
+/** @brief Subtract v1 from v. */
+SMATH_API void dvec2_sub(dvec2 *v, const dvec2 *v1);
+/** @brief Multiply every component of v with s. */
+SMATH_API void dvec2_scalar_mult(dvec2 *v, const f64 s);
+/** @brief Divide every component of v by s. */
+SMATH_API void dvec2_scalar_div(dvec2 *v, f64 s);
+/** @brief Square root of every component of v. */
+SMATH_API void dvec2_square_root(dvec2 *v);
+/** @brief The dot product of v and v1. */
+SMATH_API f64 dvec2_dot(const dvec2 *v, const dvec2 *v1);
+/** @brief The length of v. */
+SMATH_API f64 dvec2_magnitude(const dvec2 *v);
+/** @brief Scale v to length 1. */
+SMATH_API void dvec2_normalize(dvec2 *v);
+
+/** @brief Add v1 to v. */
+SMATH_API void dvec3_add(dvec3 *v, const dvec3 *v1);
+/** @brief Subtract v1 from v. */
+SMATH_API void dvec3_sub(dvec3 *v, const dvec3 *v1);
+/** @brief Multiply every component of v with s. */
+SMATH_API void dvec3_scalar_mult(dvec3 *v, const f64 s);
+/** @brief Divide every component of v by s. */
+SMATH_API void dvec3_scalar_div(dvec3 *v, f64 s);
+/** @brief Square root of every component of v. */
+SMATH_API void dvec3_square_root(dvec3 *v);
+/** @brief The dot product of v and v1. */
+SMATH_API f64 dvec3_dot(const dvec3 *v, const dvec3 *v1);
+/** @brief The length of v. */
+SMATH_API f64 dvec3_magnitude(const dvec3 *v);
+/** @brief Scale v to length 1. */
+SMATH_API void dvec3_normalize(dvec3 *v);
+/** @brief The cross product v x v1. */
+SMATH_API dvec3 dvec3_cross_product(const dvec3 *v, const dvec3 *v1);
+/** @brief The length of the cross product v x v1. */
+SMATH_API f64 dvec3_cross_product_magnitude(const dvec3 *v, const dvec3 *v1);
+/** @brief The vector triple product v x (v1 x v2). */
+SMATH_API dvec3 dvec3_triple_product(const dvec3 *v, const dvec3 *v1, const dvec3 *v2);
+/** @brief The scalar triple product (v x v1) . v2. */
+SMATH_API f64 dvec3_scalar_triple_product(const dvec3 *v, const dvec3 *v1, const dvec3 *v2);
+
+/** @brief Add v1 to v. */
+SMATH_API void dvec4_add(dvec4 *v, const dvec4 *v1);
+/** @brief Subtract v1 from v. */
+SMATH_API void dvec4_sub(dvec4 *v, const dvec4 *v1);
+/** @brief Multiply every component of v with s. */
+SMATH_API void dvec4_scalar_mult(dvec4 *v, const f64 s);
+/** @brief Divide every component of v by s. */
+SMATH_API void dvec4_scalar_div(dvec4 *v, f64 s);
+/** @brief Square root of every component of v. */
+SMATH_API void dvec4_square_root(dvec4 *v);
+/** @brief The dot product of v and v1. */
+SMATH_API f64 dvec4_dot(const dvec4 *v, const dvec4 *v1);
+/** @brief The length of v. */
+SMATH_API f64 dvec4_magnitude(const dvec4 *v);
+/** @brief Scale v to length 1. */
+SMATH_API void dvec4_normalize(dvec4 *v);
+
+
+/**
+ * @brief Convert a 3D vector to double precision.
+ *
+ * @param [*v] Takes a pointer to a vec3.
+ * @return [dvec3] Returns the same vector as a dvec3, exact.
+ */
+SMATH_API dvec3 dvec3_from_vec3(const vec3 *v);
+
+/**
+ * @brief Round a double precision 3D vector to floats.
+ *
+ * @param [*v] Takes a pointer to a dvec3.
+ * @return [vec3] Returns the nearest vec3.
+ */
+SMATH_API vec3 vec3_from_dvec3(const dvec3 *v);
+
+/**
+ * @brief A double precision position relative to an origin, as floats.
+ *
+ * @param [*v] Takes a pointer to a dvec3.
+ * @param [*origin] Takes a pointer to the origin, e.g. the camera position.
+ * @return [vec3] Returns v - origin, subtracted in double and then rounded.
+ */
+SMATH_API vec3 vec3_from_dvec3_relative(const dvec3 *v, const dvec3 *origin);
+
+/**
+ * @brief Convert a 4D vector to double precision.
+ *
+ * @param [*v] Takes a pointer to a vec4.
+ * @return [dvec4] Returns the same vector as a dvec4, exact.
+ */
+SMATH_API dvec4 dvec4_from_vec4(const vec4 *v);
+
+/**
+ * @brief Round a double precision 4D vector to floats.
+ *
+ * @param [*v] Takes a pointer to a dvec4.
+ * @return [vec4] Returns the nearest vec4.
+ */
+SMATH_API vec4 vec4_from_dvec4(const dvec4 *v);
+
+/** @}*/
+
+#ifdef SMATH_HEADER_ONLY
+#include "../src/dvector.c"
+#endif
+
+#endif // DVECTOR_H
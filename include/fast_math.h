@@ -0,0 +1,114 @@
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#include "math_types.h"
+#include "types.h"
+#include "smath_config.h"
+
+/** @defgroup fast_ Approximate reciprocal, reciprocal square root and normalize.
+ *
+ * vec3_normalize and vec4_normalize take a sqrtf and a division for every
+ * vector. These take the 12 bit estimate of _mm_rsqrt_ps / _mm_rcp_ps and
+ * refine it with one Newton-Raphson step, which is close to float
+ * precision but not correctly rounded:
+ *
+ *   smath_fast_rsqrt   relative error below SMATH_FAST_RSQRT_ERROR
+ *   smath_fast_rcp     relative error below SMATH_FAST_RCP_ERROR
+ *   *_fast_normalize   magnitude of the result within SMATH_FAST_NORMALIZE_ERROR of 1
+ *
+ * Without SSE they fall back to 1.0f / sqrtf and 1.0f / x. The normalize
+ * functions need a squared magnitude that is a normal float, a magnitude
+ * in [2^-62, 2^62], the components themselves can be denormal. A zero
+ * vector gives NaN, like vec3_normalize. The structure of arrays versions are
+ * vec3_soa_fast_normalize and vec4_soa_fast_normalize (vector_soa.h).
+ * @{
+ */
+
+
+/** @brief Max relative error of smath_fast_rsqrt and the SoA normalize kernels. */
+#define SMATH_FAST_RSQRT_ERROR 5e-7f
+
+/** @brief Max relative error of smath_fast_rcp. */
+#define SMATH_FAST_RCP_ERROR 4e-7f
+
+/** @brief Max distance of the magnitude of a fast normalized vector from 1. */
+#define SMATH_FAST_NORMALIZE_ERROR 1e-6f
+
+
+/**
+ * @brief Approximate 1 / sqrt(x).
+ *
+ * @param [x] Takes a float/f32 value.
+ * @return [float/f32] Returns 1 / sqrt(x), within SMATH_FAST_RSQRT_ERROR for normal values greater than 0.
+ *         0 gives infinity with the sign of x, infinity gives 0 and negative values NaN.
+ * @note _mm_rsqrt_ss flushes denormals to 0, they give infinity as well.
+ */
+SMATH_API f32 smath_fast_rsqrt(f32 x);
+
+/**
+ * @brief Approximate 1 / x.
+ *
+ * @param [x] Takes a float/f32 value.
+ * @return [float/f32] Returns 1 / x, within SMATH_FAST_RCP_ERROR for a magnitude in [2^-126, 2^126).
+ * @note _mm_rcp_ss flushes outside of that range, a smaller magnitude gives
+ *       infinity and a larger one 0, both with the sign of x.
+ */
+SMATH_API f32 smath_fast_rcp(f32 x);
+
+/**
+ * @brief Approximately normalize the 3D vector.
+ *
+ * @param [*v] Takes a pointer to a vec3.
+ * @note The first input will be modified.
+ */
+SMATH_API void vec3_fast_normalize(vec3 *v);
+
+/**
+ * @brief Approximately normalize the 4D vector.
+ *
+ * @param [*v] Takes a pointer to a vec4.
+ * @note The first input will be modified.
+ */
+SMATH_API void vec4_fast_normalize(vec4 *v);
+
+/**
+ * @brief Scalar division with a 3D vector, through smath_fast_rcp.
+ *
+ * @param [*v] Takes a pointer to a vec3.
+ * @param [s] Takes a float/f32 value.
+ * @note The first input will be modified.
+ */
+SMATH_API void vec3_fast_scalar_div(vec3 *v, f32 s);
+
+/**
+ * @brief Scalar division with a 4D vector, through smath_fast_rcp.
+ *
+ * @param [*v] Takes a pointer to a vec4.
+ * @param [s] Takes a float/f32 value.
+ * @note The first input will be modified.
+ */
+SMATH_API void vec4_fast_scalar_div(vec4 *v, f32 s);
+
+/**
+ * @brief Approximately normalize a 4D vector, value version (vector_value.h).
+ *
+ * @param [v] Takes a vec4v.
+ * @return [vec4v] Returns v with a magnitude of about 1.
+ */
+SMATH_API vec4v SMATH_VECTORCALL vec4_fast_normalizev(vec4v v);
+
+/**
+ * @brief Approximately normalize x, y, z of a vector, value version (vector_value.h).
+ *
+ * @param [v] Takes a vec4v with w = 0.
+ * @return [vec4v] Returns v with a magnitude of about 1.
+ */
+SMATH_API vec4v SMATH_VECTORCALL vec3_fast_normalizev(vec4v v);
+
+/** @}*/
+
+#ifdef SMATH_HEADER_ONLY
+#include "../src/fast_math.c"
+#endif
+
+#endif // FAST_MATH_H
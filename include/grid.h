@@ -0,0 +1,155 @@
+#ifndef GRID_H
+#define GRID_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "math_types.h"
+#include "types.h"
+
+/** @defgroup grid_ A uniform spatial hash grid for neighbor queries on points.
+ *
+ * The points are bucketed by the hash of the cell they fall into, every
+ * build is a counting sort on that hash: one pass counts the points per
+ * bucket, a prefix sum turns the counts into ranges and a second pass
+ * scatters the points into them. So a rebuild every frame is O(n) with
+ * no allocation, and the points of a bucket end up next to each other
+ * in x, y and z, which the queries read front to back. The prefix sum
+ * runs over all buckets, so size the capacity for the usual count.
+ *
+ * Different cells can share a bucket, a query tests the distance of every
+ * point of the buckets it visits. With a cell size around the query radius
+ * a query visits at most 9 (2D) or 27 (3D) cells.
+ *
+ * A grid built from vec2 points lies in the z = 0 plane, its queries ignore
+ * the z of the query point.
+ *
+ * @note Only available in the archive build, not with SMATH_HEADER_ONLY.
+ * @{
+ */
+
+
+/** @brief The most buckets a query visits one by one, beyond that it reads all points. */
+#define SMATH_GRID_MAX_RANGES 64
+
+/**
+ * @brief A uniform spatial hash grid.
+ *
+ * Read the fields, change them only through the functions below. All
+ * arrays are 64 byte aligned and hold capacity entries, start holds
+ * buckets + 1.
+ */
+typedef struct smath_grid {
+        u32 *start;             /**< the points of bucket b are [start[b], start[b + 1]) */
+        u32 *indices;           /**< the index of every point in the order of the buckets */
+        f32 *x, *y, *z;         /**< the points in the order of the buckets */
+        u32 *bucket;            /**< the bucket of every point in input order, scratch of the build */
+
+        f32 cell_size;
+        f32 inv_cell_size;
+        u32 buckets;            /**< a power of 2, at least twice the capacity */
+        bool planar;            /**< built from vec2 points */
+
+        size_t count;
+        size_t capacity;
+} smath_grid;
+
+/** @brief The points [begin, end) of smath_grid.indices, x, y and z. */
+typedef struct smath_grid_range {
+        u32 begin;
+        u32 end;
+} smath_grid_range;
+
+
+/**
+ * @brief Allocate a grid for up to capacity points.
+ *
+ * @param [*g] Takes a pointer to the smath_grid to initialize.
+ * @param [cell_size] Takes the edge length of a cell, greater than 0.
+ * @param [capacity] Takes the most points of a build, less than 2^30.
+ * @return [bool] Returns false if the allocation failed.
+ */
+extern bool smath_grid_create(smath_grid *g, f32 cell_size, size_t capacity);
+
+/**
+ * @brief Free the arrays of a grid.
+ *
+ * @param [*g] Takes a pointer to a smath_grid.
+ */
+extern void smath_grid_destroy(smath_grid *g);
+
+/**
+ * @brief Bucket an array of vec3 points, replacing the previous build.
+ *
+ * @param [*g] Takes a pointer to a smath_grid.
+ * @param [*p] Takes a pointer to count vec3.
+ * @param [count] Takes the number of points.
+ * @return [bool] Returns false if count is larger than the capacity, the grid is then empty.
+ */
+extern bool smath_grid_build(smath_grid *g, const vec3 *p, size_t count);
+
+/**
+ * @brief Bucket a vec3_soa, replacing the previous build.
+ *
+ * @param [*g] Takes a pointer to a smath_grid.
+ * @param [*p] Takes a pointer to a vec3_soa.
+ * @return [bool] Returns false if p->count is larger than the capacity, the grid is then empty.
+ */
+extern bool smath_grid_build_soa(smath_grid *g, const vec3_soa *p);
+
+/**
+ * @brief Bucket an array of vec2 points in the z = 0 plane, replacing the previous build.
+ *
+ * @param [*g] Takes a pointer to a smath_grid.
+ * @param [*p] Takes a pointer to count vec2.
+ * @param [count] Takes the number of points.
+ * @return [bool] Returns false if count is larger than the capacity, the grid is then empty.
+ */
+extern bool smath_grid_build_vec2(smath_grid *g, const vec2 *p, size_t count);
+
+/**
+ * @brief Bucket 2D points given as separate x and y arrays in the z = 0 plane, replacing the previous build.
+ *
+ * @param [*g] Takes a pointer to a smath_grid.
+ * @param [*x] Takes a pointer to count floats.
+ * @param [*y] Takes a pointer to count floats.
+ * @param [count] Takes the number of points.
+ * @return [bool] Returns false if count is larger than the capacity, the grid is then empty.
+ */
+extern bool smath_grid_build_xy(smath_grid *g, const f32 *x, const f32 *y, size_t count);
+
+/**
+ * @brief Find the buckets of the cells a sphere overlaps.
+ *
+ * Every bucket is returned once and empty buckets are left out. The
+ * ranges hold candidates, the distances still have to be tested. When
+ * the sphere covers more than max cells one range over all points is
+ * returned.
+ *
+ * @param [*g] Takes a pointer to a smath_grid.
+ * @param [*p] Takes a pointer to the center.
+ * @param [radius] Takes the radius.
+ * @param [*ranges] Takes a pointer to max smath_grid_range.
+ * @param [max] Takes the number of ranges the array holds, at least 1.
+ * @return [size_t] Returns the number of ranges written.
+ */
+extern size_t smath_grid_query_ranges(const smath_grid *g, const vec3 *p, f32 radius,
+                                      smath_grid_range *ranges, size_t max);
+
+/**
+ * @brief Find the points within a radius of a point.
+ *
+ * A point at distance radius is included, so is a point at p itself.
+ *
+ * @param [*g] Takes a pointer to a smath_grid.
+ * @param [*p] Takes a pointer to the center.
+ * @param [radius] Takes the radius.
+ * @param [*out] Takes a pointer to max indices for the points, the entries past the returned count can be overwritten.
+ * @param [max] Takes the number of indices out can hold.
+ * @return [size_t] Returns the number of points within the radius, only the first max are stored.
+ */
+extern size_t smath_grid_query_radius(const smath_grid *g, const vec3 *p, f32 radius, u32 *out, size_t max);
+
+/** @}*/
+
+#endif // GRID_H
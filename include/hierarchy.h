@@ -0,0 +1,108 @@
+#ifndef HIERARCHY_H
+#define HIERARCHY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "math_types.h"
+#include "types.h"
+#include "mat4x4.h"
+
+/** @defgroup hierarchy_ A transform hierarchy with incremental world matrices.
+ *
+ * Every node has a local position, rotation (quat.h) and scale, and a
+ * cached world matrix, world = world of the parent * local. The local
+ * matrix is translation * rotation * scale.
+ *
+ * The nodes are kept in flat arrays in topological order, a parent always
+ * has a lower index than its children, so smath_hierarchy_update is one
+ * front to back sweep. Changing a local transform only flags the node, the
+ * update recomputes the flagged nodes and their subtrees and skips the
+ * clean nodes in between with a memchr over the flags. Every node knows
+ * the highest index in its subtree, so the sweep stops as soon as a subtree
+ * is done. Add the children of a node right after it (depth first) to keep
+ * the subtrees short index ranges, then the cost of an update follows the
+ * number of changed nodes, not the size of the hierarchy.
+ *
+ * The world matrices go through the dispatched mat4x4_mult (dispatch.h).
+ *
+ * @note Only available in the archive build, not with SMATH_HEADER_ONLY.
+ * @{
+ */
+
+
+/** @brief No parent, the node is a root. */
+#define SMATH_HIERARCHY_ROOT (-1)
+
+
+/**
+ * @brief The nodes of a hierarchy, one array per field.
+ *
+ * Read the fields directly, write the local transforms only through
+ * smath_hierarchy_set_local so the node gets flagged. world is valid for
+ * every node after smath_hierarchy_update.
+ */
+typedef struct smath_hierarchy {
+        mat4x4 *world;          /**< world matrix of every node, 64 byte aligned */
+        quat *rotation;         /**< local rotation */
+        vec3 *position;         /**< local position */
+        vec3 *scale;            /**< local scale */
+        i32 *parent;            /**< index of the parent, or SMATH_HIERARCHY_ROOT */
+        i32 *subtree_end;       /**< highest index in the subtree of the node */
+        u8 *dirty;              /**< 1 if the local transform changed since the last update */
+
+        size_t count;
+        size_t capacity;
+        size_t first_dirty;     /**< lowest flagged index, count if none */
+} smath_hierarchy;
+
+
+/**
+ * @brief Allocate an empty hierarchy.
+ *
+ * @param [*h] Takes a pointer to the smath_hierarchy to initialize.
+ * @param [capacity] Takes the number of nodes to reserve, it grows when needed.
+ * @return [bool] Returns false if the allocation failed.
+ */
+extern bool smath_hierarchy_create(smath_hierarchy *h, size_t capacity);
+
+/**
+ * @brief Free the arrays of a hierarchy.
+ *
+ * @param [*h] Takes a pointer to a smath_hierarchy.
+ */
+extern void smath_hierarchy_destroy(smath_hierarchy *h);
+
+/**
+ * @brief Add a node at the end.
+ *
+ * @param [*h] Takes a pointer to a smath_hierarchy.
+ * @param [parent] Takes the index of an existing node, or SMATH_HIERARCHY_ROOT.
+ * @param [*position] Takes a pointer to a vec3.
+ * @param [*rotation] Takes a pointer to a unit quat.
+ * @param [*scale] Takes a pointer to a vec3.
+ * @return [i32] Returns the index of the node, -1 if growing the arrays failed.
+ */
+extern i32 smath_hierarchy_add(smath_hierarchy *h, i32 parent, const vec3 *position, const quat *rotation, const vec3 *scale);
+
+/**
+ * @brief Change the local transform of a node and flag it.
+ *
+ * @param [*h] Takes a pointer to a smath_hierarchy.
+ * @param [node] Takes the index of the node.
+ * @param [*position] Takes a pointer to a vec3, NULL keeps the current one.
+ * @param [*rotation] Takes a pointer to a unit quat, NULL keeps the current one.
+ * @param [*scale] Takes a pointer to a vec3, NULL keeps the current one.
+ */
+extern void smath_hierarchy_set_local(smath_hierarchy *h, i32 node, const vec3 *position, const quat *rotation, const vec3 *scale);
+
+/**
+ * @brief Recompute the world matrices of the flagged nodes and their subtrees.
+ *
+ * @param [*h] Takes a pointer to a smath_hierarchy.
+ */
+extern void smath_hierarchy_update(smath_hierarchy *h);
+
+/** @}*/
+
+#endif // HIERARCHY_H
@@ -1,12 +1,73 @@
-#ifndef MAT2X2_H
-#define MAT2X2_H
-
-
-#include "../include/math_types.h"
-
-
-typedef struct mat2x2 {
-        vec2 t[2];
-} mat2x2;
-
-#endif //MAT2X2_H
\ No newline at end of file
+#ifndef MAT2X2_H
+#define MAT2X2_H
+
+
+#include "../include/math_types.h"
+#include "../include/smath_config.h"
+
+/** @defgroup mat2x2_ Contains all of the 2x2 matrix operations/functions.
+ * @{ 
+ */
+
+
+/** 
+ * @brief 2x2 matrix multiplication with a 2x2 matrix.
+ * 
+ * @param [*m0] Takes a pointer to a mat2x2.
+ * @param [*m1] Takes a pointer to a mat2x2.
+ * @return [mat2x2] Returns m0 * m1.
+ */
+SMATH_API mat2x2 mat2x2_mult(const mat2x2 *m0, const mat2x2 *m1);
+
+/** 
+ * @brief Transpose a 2x2 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat2x2.
+ * @return [mat2x2] Returns the transposed matrix.
+ */
+SMATH_API mat2x2 mat2x2_transpose(const mat2x2 *m);
+
+/** 
+ * @brief Multiply a 2x2 matrix with a 2D vector.
+ * 
+ * @param [*m] Takes a pointer to a mat2x2.
+ * @param [*v] Takes a pointer to a vec2.
+ * @return [vec2] Returns m * v.
+ */
+SMATH_API vec2 mat2x2_vec2_mult(const mat2x2 *m, const vec2 *v);
+
+/** 
+ * @brief Calculate the determinant of a 2x2 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat2x2.
+ * @return [float/f32] Returns the determinant.
+ */
+SMATH_API f32 mat2x2_determinant(const mat2x2 *m);
+
+/** 
+ * @brief Calculate the inverse of a 2x2 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat2x2.
+ * @return [mat2x2] Returns the inverse matrix.
+ * @note The determinant must not be 0, check it with mat2x2_determinant.
+ */
+SMATH_API mat2x2 mat2x2_inverse(const mat2x2 *m);
+
+
+#ifdef SMATH_SSE
+
+/** @brief SIMD SSE - 2x2 matrix multiplication, same result as mat2x2_mult. */
+SMATH_API mat2x2 mat2x2_sse_mult(const mat2x2 *m0, const mat2x2 *m1);
+
+/** @brief SIMD SSE - Inverse of a 2x2 matrix, same result as mat2x2_inverse. */
+SMATH_API mat2x2 mat2x2_sse_inverse(const mat2x2 *m);
+
+#endif // SMATH_SSE
+
+/** @}*/
+
+#ifdef SMATH_HEADER_ONLY
+#include "../src/mat2x2.c"
+#endif
+
+#endif //MAT2X2_H
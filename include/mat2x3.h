@@ -1,12 +1,45 @@
-#ifndef MAT2X3_H
-#define MAT2X3_H
-
-
-#include "../include/math_types.h"
-
-
-typedef struct mat2x3 {
-        vec2 t[3];
-} mat2x3;
-
-#endif //MAT2X3_H
\ No newline at end of file
+#ifndef MAT2X3_H
+#define MAT2X3_H
+
+
+#include "../include/math_types.h"
+#include "../include/smath_config.h"
+
+/** @defgroup mat2x3_ Contains all of the 2x3 matrix operations/functions (2 columns, 3 rows).
+ * @{ 
+ */
+
+
+/** 
+ * @brief Transpose a 2x3 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat2x3.
+ * @return [mat3x2] Returns the transposed matrix.
+ */
+SMATH_API mat3x2 mat2x3_transpose(const mat2x3 *m);
+
+/** 
+ * @brief Multiply a 2x3 matrix with a 2D vector.
+ * 
+ * @param [*m] Takes a pointer to a mat2x3.
+ * @param [*v] Takes a pointer to a vec2.
+ * @return [vec3] Returns m * v.
+ */
+SMATH_API vec3 mat2x3_vec2_mult(const mat2x3 *m, const vec2 *v);
+
+/** 
+ * @brief Multiply a 2x3 matrix with a 3x2 matrix.
+ * 
+ * @param [*m0] Takes a pointer to a mat2x3.
+ * @param [*m1] Takes a pointer to a mat3x2.
+ * @return [mat3x3] Returns m0 * m1.
+ */
+SMATH_API mat3x3 mat2x3_mult(const mat2x3 *m0, const mat3x2 *m1);
+
+/** @}*/
+
+#ifdef SMATH_HEADER_ONLY
+#include "../src/mat2x3.c"
+#endif
+
+#endif //MAT2X3_H
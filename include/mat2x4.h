@@ -1,12 +1,46 @@
-#ifndef MAT2X4_H
-#define MAT2X4_H
-
-
-#include "../include/math_types.h"
-
-
-typedef struct mat2x4 {
-        vec2 t[4];
-} mat2x4;
-
-#endif //MAT2X4_H
\ No newline at end of file
+#ifndef MAT2X4_H
+#define MAT2X4_H
+
+
+#include "../include/math_types.h"
+#include "../include/smath_config.h"
+#include "../include/mat4x4.h"
+
+/** @defgroup mat2x4_ Contains all of the 2x4 matrix operations/functions (2 columns, 4 rows).
+ * @{ 
+ */
+
+
+/** 
+ * @brief Transpose a 2x4 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat2x4.
+ * @return [mat4x2] Returns the transposed matrix.
+ */
+SMATH_API mat4x2 mat2x4_transpose(const mat2x4 *m);
+
+/** 
+ * @brief Multiply a 2x4 matrix with a 2D vector.
+ * 
+ * @param [*m] Takes a pointer to a mat2x4.
+ * @param [*v] Takes a pointer to a vec2.
+ * @return [vec4] Returns m * v.
+ */
+SMATH_API vec4 mat2x4_vec2_mult(const mat2x4 *m, const vec2 *v);
+
+/** 
+ * @brief Multiply a 2x4 matrix with a 4x2 matrix.
+ * 
+ * @param [*m0] Takes a pointer to a mat2x4.
+ * @param [*m1] Takes a pointer to a mat4x2.
+ * @return [mat4x4] Returns m0 * m1.
+ */
+SMATH_API mat4x4 mat2x4_mult(const mat2x4 *m0, const mat4x2 *m1);
+
+/** @}*/
+
+#ifdef SMATH_HEADER_ONLY
+#include "../src/mat2x4.c"
+#endif
+
+#endif //MAT2X4_H
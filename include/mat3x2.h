@@ -1,12 +1,45 @@
-#ifndef MAT3X2_H
-#define MAT3X2_H
-
-
-#include "../include/math_types.h"
-
-
-typedef struct mat3x2 {
-        vec3 t[2];
-} mat3x2;
-
-#endif //MAT3X2_H
\ No newline at end of file
+#ifndef MAT3X2_H
+#define MAT3X2_H
+
+
+#include "../include/math_types.h"
+#include "../include/smath_config.h"
+
+/** @defgroup mat3x2_ Contains all of the 3x2 matrix operations/functions (3 columns, 2 rows).
+ * @{ 
+ */
+
+
+/** 
+ * @brief Transpose a 3x2 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat3x2.
+ * @return [mat2x3] Returns the transposed matrix.
+ */
+SMATH_API mat2x3 mat3x2_transpose(const mat3x2 *m);
+
+/** 
+ * @brief Multiply a 3x2 matrix with a 3D vector.
+ * 
+ * @param [*m] Takes a pointer to a mat3x2.
+ * @param [*v] Takes a pointer to a vec3.
+ * @return [vec2] Returns m * v.
+ */
+SMATH_API vec2 mat3x2_vec3_mult(const mat3x2 *m, const vec3 *v);
+
+/** 
+ * @brief Multiply a 3x2 matrix with a 2x3 matrix.
+ * 
+ * @param [*m0] Takes a pointer to a mat3x2.
+ * @param [*m1] Takes a pointer to a mat2x3.
+ * @return [mat2x2] Returns m0 * m1.
+ */
+SMATH_API mat2x2 mat3x2_mult(const mat3x2 *m0, const mat2x3 *m1);
+
+/** @}*/
+
+#ifdef SMATH_HEADER_ONLY
+#include "../src/mat3x2.c"
+#endif
+
+#endif //MAT3X2_H
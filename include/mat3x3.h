@@ -1,13 +1,76 @@
-#ifndef MAT3X3_H
-#define MAT3X3_H
-
-
-#include "../include/math_types.h"
-
-
-typedef struct mat3x3 {
-        vec3 t[3];
-} mat3x3;
-
-#endif //MAT3X3_H
-
+#ifndef MAT3X3_H
+#define MAT3X3_H
+
+
+#include "../include/math_types.h"
+#include "../include/smath_config.h"
+
+/** @defgroup mat3x3_ Contains all of the 3x3 matrix operations/functions.
+ * @{ 
+ */
+
+
+/** 
+ * @brief 3x3 matrix multiplication with a 3x3 matrix.
+ * 
+ * @param [*m0] Takes a pointer to a mat3x3.
+ * @param [*m1] Takes a pointer to a mat3x3.
+ * @return [mat3x3] Returns m0 * m1.
+ */
+SMATH_API mat3x3 mat3x3_mult(const mat3x3 *m0, const mat3x3 *m1);
+
+/** 
+ * @brief Transpose a 3x3 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat3x3.
+ * @return [mat3x3] Returns the transposed matrix.
+ */
+SMATH_API mat3x3 mat3x3_transpose(const mat3x3 *m);
+
+/** 
+ * @brief Multiply a 3x3 matrix with a 3D vector.
+ * 
+ * @param [*m] Takes a pointer to a mat3x3.
+ * @param [*v] Takes a pointer to a vec3.
+ * @return [vec3] Returns m * v.
+ */
+SMATH_API vec3 mat3x3_vec3_mult(const mat3x3 *m, const vec3 *v);
+
+/** 
+ * @brief Calculate the determinant of a 3x3 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat3x3.
+ * @return [float/f32] Returns the determinant.
+ */
+SMATH_API f32 mat3x3_determinant(const mat3x3 *m);
+
+/** 
+ * @brief Calculate the inverse of a 3x3 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat3x3.
+ * @return [mat3x3] Returns the inverse matrix.
+ * @note The determinant must not be 0, check it with mat3x3_determinant.
+ */
+SMATH_API mat3x3 mat3x3_inverse(const mat3x3 *m);
+
+
+#ifdef SMATH_SSE
+
+/** @brief SIMD SSE - 3x3 matrix multiplication, same result as mat3x3_mult. */
+SMATH_API mat3x3 mat3x3_sse_mult(const mat3x3 *m0, const mat3x3 *m1);
+
+/** @brief SIMD SSE - Multiply a 3x3 matrix with a 3D vector, same result as mat3x3_vec3_mult. */
+SMATH_API vec3 mat3x3_sse_vec3_mult(const mat3x3 *m, const vec3 *v);
+
+/** @brief SIMD SSE - Inverse of a 3x3 matrix, same result as mat3x3_inverse. */
+SMATH_API mat3x3 mat3x3_sse_inverse(const mat3x3 *m);
+
+#endif // SMATH_SSE
+
+/** @}*/
+
+#ifdef SMATH_HEADER_ONLY
+#include "../src/mat3x3.c"
+#endif
+
+#endif //MAT3X3_H
@@ -1,12 +1,106 @@
-#ifndef MAT3X4_H
-#define MAT3X4_H
-
-
-#include "../include/math_types.h"
-
-
-typedef struct mat3x4 {
-        vec3 t[4];
-} mat3x4;
-
-#endif //MAT3X4_H
\ No newline at end of file
+#ifndef MAT3X4_H
+#define MAT3X4_H
+
+
+#include "../include/math_types.h"
+#include "../include/smath_config.h"
+#include "../include/mat4x4.h"
+
+/** @defgroup mat3x4_ Contains all of the 3x4 (transposed affine) matrix operations/functions.
+ * @{ 
+ */
+
+
+/** 
+ * @brief Transpose a 3x4 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat3x4.
+ * @return [mat4x3] Returns the transposed matrix.
+ */
+SMATH_API mat4x3 mat3x4_transpose(const mat3x4 *m);
+
+/** 
+ * @brief Multiply a 3x4 matrix with a 3D vector.
+ * 
+ * @param [*m] Takes a pointer to a mat3x4.
+ * @param [*v] Takes a pointer to a vec3.
+ * @return [vec4] Returns m * v.
+ */
+SMATH_API vec4 mat3x4_vec3_mult(const mat3x4 *m, const vec3 *v);
+
+/** 
+ * @brief Multiply a 3x4 matrix with a 4x3 matrix.
+ * 
+ * @param [*m0] Takes a pointer to a mat3x4.
+ * @param [*m1] Takes a pointer to a mat4x3.
+ * @return [mat4x4] Returns m0 * m1.
+ */
+SMATH_API mat4x4 mat3x4_mult(const mat3x4 *m0, const mat4x3 *m1);
+
+/** 
+ * @brief Combine two affine 3x4 matrices.
+ * 
+ * Same transform as mat4x3_mult_affine on the transposed matrices, m1 is applied first.
+ * 
+ * @param [*m0] Takes a pointer to a mat3x4.
+ * @param [*m1] Takes a pointer to a mat3x4.
+ * @return [mat3x4] Returns the combined affine matrix.
+ */
+SMATH_API mat3x4 mat3x4_mult_affine(const mat3x4 *m0, const mat3x4 *m1);
+
+/** 
+ * @brief Transform a point with an affine 3x4 matrix, x * t[0] + y * t[1] + z * t[2] + t[3].
+ * 
+ * @param [*m] Takes a pointer to a mat3x4.
+ * @param [*v] Takes a pointer to a vec3.
+ * @return [vec3] Returns the transformed point.
+ */
+SMATH_API vec3 mat3x4_transform_point(const mat3x4 *m, const vec3 *v);
+
+/** 
+ * @brief Transform a direction with an affine 3x4 matrix, x * t[0] + y * t[1] + z * t[2].
+ * 
+ * @param [*m] Takes a pointer to a mat3x4.
+ * @param [*v] Takes a pointer to a vec3.
+ * @return [vec3] Returns the transformed direction, the translation is ignored.
+ */
+SMATH_API vec3 mat3x4_transform_direction(const mat3x4 *m, const vec3 *v);
+
+/** 
+ * @brief Calculate the determinant of an affine 3x4 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat3x4.
+ * @return [float/f32] Returns the determinant of the 3x3 part.
+ */
+SMATH_API f32 mat3x4_determinant(const mat3x4 *m);
+
+/** 
+ * @brief Calculate the inverse of an affine 3x4 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat3x4.
+ * @return [mat3x4] Returns the inverse affine matrix.
+ * @note The determinant must not be 0, check it with mat3x4_determinant.
+ */
+SMATH_API mat3x4 mat3x4_inverse_affine(const mat3x4 *m);
+
+
+#ifdef SMATH_SSE
+
+/** @brief SIMD SSE - Combine two affine 3x4 matrices, same result as mat3x4_mult_affine. */
+SMATH_API mat3x4 mat3x4_sse_mult_affine(const mat3x4 *m0, const mat3x4 *m1);
+
+/** @brief SIMD SSE - Transform a point, same result as mat3x4_transform_point. */
+SMATH_API vec3 mat3x4_sse_transform_point(const mat3x4 *m, const vec3 *v);
+
+/** @brief SIMD SSE - Inverse of an affine 3x4 matrix, same result as mat3x4_inverse_affine. */
+SMATH_API mat3x4 mat3x4_sse_inverse_affine(const mat3x4 *m);
+
+#endif // SMATH_SSE
+
+/** @}*/
+
+#ifdef SMATH_HEADER_ONLY
+#include "../src/mat3x4.c"
+#endif
+
+#endif //MAT3X4_H
@@ -1,12 +1,45 @@
-#ifndef MAT4X2_H
-#define MAT4X2_H
-
-
-#include "../include/math_types.h"
-
-
-typedef struct mat4x2 {
-        vec4 t[2];
-} mat4x2;
-
-#endif //MAT4X2_H
\ No newline at end of file
+#ifndef MAT4X2_H
+#define MAT4X2_H
+
+
+#include "../include/math_types.h"
+#include "../include/smath_config.h"
+
+/** @defgroup mat4x2_ Contains all of the 4x2 matrix operations/functions (4 columns, 2 rows).
+ * @{ 
+ */
+
+
+/** 
+ * @brief Transpose a 4x2 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat4x2.
+ * @return [mat2x4] Returns the transposed matrix.
+ */
+SMATH_API mat2x4 mat4x2_transpose(const mat4x2 *m);
+
+/** 
+ * @brief Multiply a 4x2 matrix with a 4D vector.
+ * 
+ * @param [*m] Takes a pointer to a mat4x2.
+ * @param [*v] Takes a pointer to a vec4.
+ * @return [vec2] Returns m * v.
+ */
+SMATH_API vec2 mat4x2_vec4_mult(const mat4x2 *m, const vec4 *v);
+
+/** 
+ * @brief Multiply a 4x2 matrix with a 2x4 matrix.
+ * 
+ * @param [*m0] Takes a pointer to a mat4x2.
+ * @param [*m1] Takes a pointer to a mat2x4.
+ * @return [mat2x2] Returns m0 * m1.
+ */
+SMATH_API mat2x2 mat4x2_mult(const mat4x2 *m0, const mat2x4 *m1);
+
+/** @}*/
+
+#ifdef SMATH_HEADER_ONLY
+#include "../src/mat4x2.c"
+#endif
+
+#endif //MAT4X2_H
@@ -1,12 +1,126 @@
-#ifndef MAT4X3_H
-#define MAT4X3_H
-
-
-#include "../include/math_types.h"
-
-
-typedef struct mat4x3 {
-        vec4 t[3];
-} mat4x3;
-
-#endif //MAT4X3_H
\ No newline at end of file
+#ifndef MAT4X3_H
+#define MAT4X3_H
+
+
+#include "../include/math_types.h"
+#include "../include/smath_config.h"
+#include "../include/mat4x4.h"
+
+/** @defgroup mat4x3_ Contains all of the 4x3 (affine) matrix operations/functions.
+ * @{ 
+ */
+
+
+/** 
+ * @brief Create an affine 4x3 matrix from the first 3 rows of a 4x4 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat4x4.
+ * @return [mat4x3] Returns the affine matrix.
+ * @note The last row of the 4x4 matrix is lost, it should be (0, 0, 0, 1).
+ */
+SMATH_API mat4x3 mat4x3_from_mat4x4(const mat4x4 *m);
+
+/** 
+ * @brief Create a 4x4 matrix from an affine 4x3 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat4x3.
+ * @return [mat4x4] Returns the 4x4 matrix, the last row is (0, 0, 0, 1).
+ */
+SMATH_API mat4x4 mat4x3_to_mat4x4(const mat4x3 *m);
+
+/** 
+ * @brief Transpose a 4x3 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat4x3.
+ * @return [mat3x4] Returns the transposed matrix.
+ */
+SMATH_API mat3x4 mat4x3_transpose(const mat4x3 *m);
+
+/** 
+ * @brief Multiply a 4x3 matrix with a 4D vector.
+ * 
+ * @param [*m] Takes a pointer to a mat4x3.
+ * @param [*v] Takes a pointer to a vec4.
+ * @return [vec3] Returns m * v.
+ */
+SMATH_API vec3 mat4x3_vec4_mult(const mat4x3 *m, const vec4 *v);
+
+/** 
+ * @brief Multiply a 4x3 matrix with a 3x4 matrix.
+ * 
+ * @param [*m0] Takes a pointer to a mat4x3.
+ * @param [*m1] Takes a pointer to a mat3x4.
+ * @return [mat3x3] Returns m0 * m1.
+ */
+SMATH_API mat3x3 mat4x3_mult(const mat4x3 *m0, const mat3x4 *m1);
+
+/** 
+ * @brief Combine two affine 4x3 matrices.
+ * 
+ * Same as mat4x4_mult on the 4x4 matrices, m1 is applied first.
+ * 
+ * @param [*m0] Takes a pointer to a mat4x3.
+ * @param [*m1] Takes a pointer to a mat4x3.
+ * @return [mat4x3] Returns m0 * m1.
+ */
+SMATH_API mat4x3 mat4x3_mult_affine(const mat4x3 *m0, const mat4x3 *m1);
+
+/** 
+ * @brief Transform a point (w = 1) with an affine 4x3 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat4x3.
+ * @param [*v] Takes a pointer to a vec3.
+ * @return [vec3] Returns the transformed point.
+ */
+SMATH_API vec3 mat4x3_transform_point(const mat4x3 *m, const vec3 *v);
+
+/** 
+ * @brief Transform a direction (w = 0) with an affine 4x3 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat4x3.
+ * @param [*v] Takes a pointer to a vec3.
+ * @return [vec3] Returns the transformed direction, the translation is ignored.
+ */
+SMATH_API vec3 mat4x3_transform_direction(const mat4x3 *m, const vec3 *v);
+
+/** 
+ * @brief Calculate the determinant of an affine 4x3 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat4x3.
+ * @return [float/f32] Returns the determinant of the 3x3 part (and of the 4x4 matrix).
+ */
+SMATH_API f32 mat4x3_determinant(const mat4x3 *m);
+
+/** 
+ * @brief Calculate the inverse of an affine 4x3 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat4x3.
+ * @return [mat4x3] Returns the inverse affine matrix.
+ * @note The determinant must not be 0, check it with mat4x3_determinant.
+ */
+SMATH_API mat4x3 mat4x3_inverse_affine(const mat4x3 *m);
+
+
+#ifdef SMATH_SSE
+
+/** @brief SIMD SSE - Multiply a 4x3 matrix with a 4D vector, same result as mat4x3_vec4_mult. */
+SMATH_API vec3 mat4x3_sse_vec4_mult(const mat4x3 *m, const vec4 *v);
+
+/** @brief SIMD SSE - Combine two affine 4x3 matrices, same result as mat4x3_mult_affine. */
+SMATH_API mat4x3 mat4x3_sse_mult_affine(const mat4x3 *m0, const mat4x3 *m1);
+
+/** @brief SIMD SSE - Transform a point, same result as mat4x3_transform_point. */
+SMATH_API vec3 mat4x3_sse_transform_point(const mat4x3 *m, const vec3 *v);
+
+/** @brief SIMD SSE - Inverse of an affine 4x3 matrix, same result as mat4x3_inverse_affine. */
+SMATH_API mat4x3 mat4x3_sse_inverse_affine(const mat4x3 *m);
+
+#endif // SMATH_SSE
+
+/** @}*/
+
+#ifdef SMATH_HEADER_ONLY
+#include "../src/mat4x3.c"
+#endif
+
+#endif //MAT4X3_H
@@ -1,30 +1,227 @@
-#ifndef MAT4X4_H
-#define MAT4X4_H
-
-
-#include "../include/math_types.h"
-
-/** @brief Documentation will be added later. */
-
-typedef struct mat4x4 {
-        f32 t[4][4];
-} mat4x4;
-
-
-extern void mat4x4_parse(mat4x4 *dest,
-                         const vec4 *v0,
-                         const vec4 *v1,
-                         const vec4 *v2,
-                         const vec4 *v3);
-
-extern mat4x4 mat4x4_create(const vec4 *v0, 
-                            const vec4 *v1, 
-                            const vec4 *v2, 
-                            const vec4 *v3);
-
-extern mat4x4 mat4x4_mult(const mat4x4 *m0, const mat4x4 *m1);
-
-extern vec4 mat4x4_vec4_mult(const mat4x4 *m, const vec4 *v);
-
-
-#endif //MAT4X4_H
\ No newline at end of file
+#ifndef MAT4X4_H
+#define MAT4X4_H
+
+
+#include "../include/math_types.h"
+#include "../include/smath_config.h"
+
+/** @brief Documentation will be added later. */
+
+/** 
+ * @brief A structure for representing 4x4 matrices. 
+ * 
+ * Every row m.t[n] is 16 byte aligned and the whole matrix takes
+ * exactly one 64 byte cache line.
+ */
+typedef struct SMATH_ALIGN(64) mat4x4 {
+        f32 t[4][4];
+} mat4x4;
+
+
+SMATH_API void mat4x4_parse(mat4x4 *dest,
+                            const vec4 *v0,
+                            const vec4 *v1,
+                            const vec4 *v2,
+                            const vec4 *v3);
+
+SMATH_API mat4x4 mat4x4_create(const vec4 *v0, 
+                               const vec4 *v1, 
+                               const vec4 *v2, 
+                               const vec4 *v3);
+
+/** 
+ * @brief Multiply two 4x4 matrices.
+ * 
+ * @param [*m0] Takes a pointer to a mat4x4.
+ * @param [*m1] Takes a pointer to a mat4x4.
+ * @return [mat4x4] Returns m0 * m1.
+ * @note Runs mat4x4_sse_mult when SMATH_SSE is defined, the result is the same.
+ */
+SMATH_API mat4x4 mat4x4_mult(const mat4x4 *m0, const mat4x4 *m1);
+
+/** 
+ * @brief Multiply a 4x4 matrix with a 4D vector.
+ * 
+ * @param [*m] Takes a pointer to a mat4x4.
+ * @param [*v] Takes a pointer to a vec4.
+ * @return [vec4] Returns m * v.
+ * @note Runs mat4x4_sse_vec4_mult when SMATH_SSE is defined, the result is the same.
+ */
+SMATH_API vec4 mat4x4_vec4_mult(const mat4x4 *m, const vec4 *v);
+
+/** 
+ * @brief Calculate the determinant of a 4x4 matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat4x4.
+ * @return [float/f32] Returns the determinant.
+ */
+SMATH_API f32 mat4x4_determinant(const mat4x4 *m);
+
+/** 
+ * @brief Calculate the inverse of any 4x4 matrix with the cofactor method.
+ * 
+ * @param [*m] Takes a pointer to a mat4x4.
+ * @return [mat4x4] Returns the inverse matrix.
+ * @note The determinant must not be 0, use mat4x4_inverse_det to check it.
+ */
+SMATH_API mat4x4 mat4x4_inverse(const mat4x4 *m);
+
+/** 
+ * @brief Calculate the inverse of any 4x4 matrix and its determinant in one go.
+ * 
+ * @param [*m] Takes a pointer to a mat4x4.
+ * @param [*det] Takes a pointer to an f32, the determinant of m is written to it.
+ * @return [mat4x4] Returns the inverse matrix.
+ * @note The returned matrix is only valid when *det is not 0.
+ */
+SMATH_API mat4x4 mat4x4_inverse_det(const mat4x4 *m, f32 *det);
+
+/** 
+ * @brief Calculate the inverse of an affine 4x4 matrix.
+ * 
+ * Only inverts the 3x3 part and the translation, much cheaper than mat4x4_inverse.
+ * 
+ * @param [*m] Takes a pointer to a mat4x4.
+ * @return [mat4x4] Returns the inverse matrix.
+ * @note The last row has to be (0, 0, 0, 1) and the 3x3 part must be invertible.
+ */
+SMATH_API mat4x4 mat4x4_inverse_affine(const mat4x4 *m);
+
+/** 
+ * @brief Calculate the inverse of a rigid body 4x4 matrix (rotation and translation only).
+ * 
+ * The rotation is transposed and the translation rotated back and negated.
+ * 
+ * @param [*m] Takes a pointer to a mat4x4.
+ * @return [mat4x4] Returns the inverse matrix.
+ * @note The last row has to be (0, 0, 0, 1) and the 3x3 part a rotation without scale.
+ */
+SMATH_API mat4x4 mat4x4_inverse_rigid(const mat4x4 *m);
+
+
+/*
+ * The projections and the view matrix are right handed for column vectors
+ * like mat4x4_vec4_mult: the camera looks down -z and z_near, z_far are
+ * positive distances. Pass the same smath_clip_depth to frustum_from_mat4x4
+ * (culling.h), the reversed Z projections use SMATH_CLIP_DEPTH_ZERO_TO_ONE.
+ */
+
+/** 
+ * @brief Create a perspective projection.
+ * 
+ * @param [fovy] Takes the vertical field of view in radians.
+ * @param [aspect] Takes the width divided by the height.
+ * @param [z_near] Takes the distance of the near plane, greater than 0.
+ * @param [z_far] Takes the distance of the far plane, greater than z_near.
+ * @param [depth] Takes the clip space depth range z_near and z_far are mapped to.
+ * @return [mat4x4] Returns the projection matrix.
+ */
+SMATH_API mat4x4 mat4x4_perspective(f32 fovy, f32 aspect, f32 z_near, f32 z_far, smath_clip_depth depth);
+
+/** 
+ * @brief Create a perspective projection without a far plane.
+ * 
+ * The limit of mat4x4_perspective for z_far going to infinity, nothing
+ * behind the near plane is clipped.
+ * 
+ * @param [fovy] Takes the vertical field of view in radians.
+ * @param [aspect] Takes the width divided by the height.
+ * @param [z_near] Takes the distance of the near plane, greater than 0.
+ * @param [depth] Takes the clip space depth range.
+ * @return [mat4x4] Returns the projection matrix.
+ */
+SMATH_API mat4x4 mat4x4_perspective_infinite(f32 fovy, f32 aspect, f32 z_near, smath_clip_depth depth);
+
+/** 
+ * @brief Create a reversed Z perspective projection, z_near goes to depth 1 and z_far to 0.
+ * 
+ * With a float depth buffer the precision is then spread evenly over
+ * the distance. Use a depth test of greater and clear the depth to 0.
+ * 
+ * @param [fovy] Takes the vertical field of view in radians.
+ * @param [aspect] Takes the width divided by the height.
+ * @param [z_near] Takes the distance of the near plane, greater than 0.
+ * @param [z_far] Takes the distance of the far plane, greater than z_near.
+ * @return [mat4x4] Returns the projection matrix.
+ */
+SMATH_API mat4x4 mat4x4_perspective_reversed(f32 fovy, f32 aspect, f32 z_near, f32 z_far);
+
+/** 
+ * @brief Create a reversed Z perspective projection without a far plane.
+ * 
+ * The depth is z_near divided by the distance, it goes to 0 at infinity.
+ * 
+ * @param [fovy] Takes the vertical field of view in radians.
+ * @param [aspect] Takes the width divided by the height.
+ * @param [z_near] Takes the distance of the near plane, greater than 0.
+ * @return [mat4x4] Returns the projection matrix.
+ */
+SMATH_API mat4x4 mat4x4_perspective_reversed_infinite(f32 fovy, f32 aspect, f32 z_near);
+
+/** 
+ * @brief Create an orthographic projection.
+ * 
+ * @param [left] Takes the x mapped to -1.
+ * @param [right] Takes the x mapped to 1.
+ * @param [bottom] Takes the y mapped to -1.
+ * @param [top] Takes the y mapped to 1.
+ * @param [z_near] Takes the distance of the near plane.
+ * @param [z_far] Takes the distance of the far plane.
+ * @param [depth] Takes the clip space depth range z_near and z_far are mapped to.
+ * @return [mat4x4] Returns the projection matrix.
+ */
+SMATH_API mat4x4 mat4x4_ortho(f32 left, f32 right, f32 bottom, f32 top, f32 z_near, f32 z_far, smath_clip_depth depth);
+
+/** 
+ * @brief Create a view matrix for a camera at eye looking at center.
+ * 
+ * @param [*eye] Takes a pointer to the camera position.
+ * @param [*center] Takes a pointer to the point looked at.
+ * @param [*up] Takes a pointer to the up direction, not parallel to center - eye.
+ * @return [mat4x4] Returns the view matrix, a rigid transform.
+ */
+SMATH_API mat4x4 mat4x4_look_at(const vec3 *eye, const vec3 *center, const vec3 *up);
+
+/** 
+ * @brief Create the matrix translation * rotation * scale directly.
+ * 
+ * The same as multiplying the 3 matrices, without the multiplies. The
+ * batch versions are mat4x4_from_trs_array and mat4x4_from_trs_mult_array
+ * (transform.h).
+ * 
+ * @param [*t] Takes a pointer to the translation.
+ * @param [*r] Takes a pointer to the rotation, a unit quaternion.
+ * @param [*s] Takes a pointer to the scale on every axis.
+ * @return [mat4x4] Returns the affine matrix.
+ */
+SMATH_API mat4x4 mat4x4_from_trs(const vec3 *t, const quat *r, const vec3 *s);
+
+
+#ifdef SMATH_SSE
+
+/** @brief SIMD SSE - 4x4 matrix multiplication, same result as mat4x4_mult. */
+SMATH_API mat4x4 mat4x4_sse_mult(const mat4x4 *m0, const mat4x4 *m1);
+
+/** @brief SIMD SSE - Multiply a 4x4 matrix with a 4D vector, same result as mat4x4_vec4_mult. */
+SMATH_API vec4 mat4x4_sse_vec4_mult(const mat4x4 *m, const vec4 *v);
+
+/** @brief SIMD SSE - Inverse of any 4x4 matrix (2x2 block cofactors), within rounding of mat4x4_inverse. */
+SMATH_API mat4x4 mat4x4_sse_inverse(const mat4x4 *m);
+
+/** @brief SIMD SSE - Inverse and determinant of any 4x4 matrix, within rounding of mat4x4_inverse_det. */
+SMATH_API mat4x4 mat4x4_sse_inverse_det(const mat4x4 *m, f32 *det);
+
+/** @brief SIMD SSE - Inverse of an affine 4x4 matrix, same result as mat4x4_inverse_affine. */
+SMATH_API mat4x4 mat4x4_sse_inverse_affine(const mat4x4 *m);
+
+/** @brief SIMD SSE - Inverse of a rigid body 4x4 matrix, same result as mat4x4_inverse_rigid. */
+SMATH_API mat4x4 mat4x4_sse_inverse_rigid(const mat4x4 *m);
+
+#endif // SMATH_SSE
+
+
+#ifdef SMATH_HEADER_ONLY
+#include "../src/mat4x4.c"
+#endif
+
+#endif //MAT4X4_H
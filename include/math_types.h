@@ -1,30 +1,276 @@
-#ifndef MATH_TYPES_H
-#define MATH_TYPES_H
-
-#include "types.h"
-
-
-
-/** @brief A structure for representing 2D vectors */
-typedef struct vec2 {
-        f32 x, y;
-} vec2;
-
-/** @brief A structure for representing 3D vectors */
-typedef struct vec3 {
-        f32 x, y, z;
-} vec3;
-
-/** @brief A structure for representing 4D vectors */
-typedef struct vec4 {
-      f32 x, y, z, w;
-} vec4;
-
-// For SIMD purposes
-// /** @brief A structure for representing 4D vectors */
-// typedef struct __attribute__((aligned(16))) vec4 {
-//       f32 x, y, z, w;
-// } vec4;
-
-
+#ifndef MATH_TYPES_H
+#define MATH_TYPES_H
+
+#include <stddef.h>
+
+#include "types.h"
+#include "smath_config.h"
+
+#ifdef SMATH_SSE
+#include <xmmintrin.h>
+#endif
+
+
+
+/** @brief A structure for representing 2D vectors */
+typedef struct vec2 {
+        f32 x, y;
+} vec2;
+
+/** @brief A structure for representing 3D vectors */
+typedef struct vec3 {
+        f32 x, y, z;
+} vec3;
+
+/** 
+ * @brief A structure for representing 4D vectors 
+ * 
+ * Aligned to 16 bytes so it can be loaded straight into an SSE register.
+ */
+typedef struct SMATH_ALIGN(16) vec4 {
+      f32 x, y, z, w;
+} vec4;
+
+/** 
+ * @brief A quaternion for representing rotations, stored in a 4D vector.
+ * 
+ * x, y, z is the vector part and w the scalar part, (0, 0, 0, 1) is
+ * no rotation. All quat functions expect unit quaternions.
+ */
+typedef vec4 quat;
+
+/** 
+ * @brief A unit dual quaternion for representing rigid transforms.
+ * 
+ * real is the rotation and dual = 0.5 * (t, 0) * real for the translation
+ * t, the rotation is applied first.
+ */
+typedef struct dual_quat {
+        quat real;
+        quat dual;
+} dual_quat;
+
+
+/** @brief A 2D vector in double precision, see dvector.h. */
+typedef struct dvec2 {
+        f64 x, y;
+} dvec2;
+
+/** @brief A 3D vector in double precision, for positions far from the origin. */
+typedef struct dvec3 {
+        f64 x, y, z;
+} dvec3;
+
+/** 
+ * @brief A 4D vector in double precision.
+ * 
+ * Aligned to 32 bytes so it can be loaded straight into an AVX register.
+ */
+typedef struct SMATH_ALIGN(32) dvec4 {
+        f64 x, y, z, w;
+} dvec4;
+
+
+/** 
+ * @brief A 4D vector held in a register, for the value functions (vector_value.h).
+ * 
+ * An __m128 with the SSE functions, so it is passed and returned in an xmm
+ * register instead of through memory. A plain vec4 without them.
+ * The vec3 value functions use x, y, z and keep w at 0.
+ */
+#ifdef SMATH_SSE
+typedef __m128 vec4v;
+#else
+typedef vec4 vec4v;
+#endif
+
+/**
+ * @brief A 4x4 matrix as 4 vec4v, t[n] is row n like mat4x4.
+ *
+ * It stays in 4 registers across the inlined mat4x4v functions of
+ * vector_value.h. Passed to or returned from a function that is not
+ * inlined it only stays in registers with __vectorcall on Windows, the
+ * System V ABI passes and returns a structure over 16 bytes through memory.
+ */
+typedef struct mat4x4v {
+        vec4v t[4];
+} mat4x4v;
+
+
+/** 
+ * @brief A plane x * a + y * b + z * c + w = 0, stored in a 4D vector.
+ * 
+ * x, y, z is the normal and w the distance term, a point p is on the
+ * positive (inside) side when dot(normal, p) + w >= 0. With a unit normal
+ * that is the signed distance.
+ */
+typedef vec4 plane;
+
+/** @brief A bounding sphere. */
+typedef struct sphere {
+        vec3 center;
+        f32 radius;
+} sphere;
+
+/** @brief An axis aligned bounding box, min <= max on every axis. */
+typedef struct aabb {
+        vec3 min;
+        vec3 max;
+} aabb;
+
+/** 
+ * @brief A ray, the points origin + t * direction with t >= 0 (ray.h).
+ * 
+ * The direction does not have to be normalized, t is then measured in
+ * multiples of its length.
+ */
+typedef struct ray {
+        vec3 origin;
+        vec3 direction;
+} ray;
+
+/** @brief A triangle, hit from both sides (ray.h). */
+typedef struct triangle {
+        vec3 v0, v1, v2;
+} triangle;
+
+/** @brief The depth range of the clip space a projection maps to (mat4x4.h, culling.h). */
+typedef enum smath_clip_depth {
+        SMATH_CLIP_DEPTH_NEG_ONE_TO_ONE = 0,    /**< -w <= z <= w, OpenGL */
+        SMATH_CLIP_DEPTH_ZERO_TO_ONE            /**< 0 <= z <= w, Direct3D and Vulkan, also reversed Z */
+} smath_clip_depth;
+
+/** 
+ * @brief The 6 planes of a view frustum, the normals point inwards.
+ * 
+ * In the order left, right, bottom, top, near, far (culling.h).
+ */
+typedef struct frustum {
+        plane p[6];
+} frustum;
+
+
+/*
+ * The matrices are named matCxR, C columns and R rows (like GLSL), and
+ * are stored row by row like mat4x4: t[n] is row n and holds C floats.
+ */
+
+/** @brief A structure for representing 2x2 matrices. */
+typedef struct mat2x2 {
+        vec2 t[2];
+} mat2x2;
+
+/** @brief A structure for representing matrices with 2 columns and 3 rows. */
+typedef struct mat2x3 {
+        vec2 t[3];
+} mat2x3;
+
+/** @brief A structure for representing matrices with 2 columns and 4 rows. */
+typedef struct mat2x4 {
+        vec2 t[4];
+} mat2x4;
+
+/** @brief A structure for representing matrices with 3 columns and 2 rows. */
+typedef struct mat3x2 {
+        vec3 t[2];
+} mat3x2;
+
+/** @brief A structure for representing 3x3 matrices. */
+typedef struct mat3x3 {
+        vec3 t[3];
+} mat3x3;
+
+/** 
+ * @brief A structure for representing matrices with 3 columns and 4 rows.
+ * 
+ * As an affine transform it is a mat4x3 stored transposed: t[0], t[1]
+ * and t[2] are the x, y and z axis and t[3] is the translation.
+ */
+typedef struct mat3x4 {
+        vec3 t[4];
+} mat3x4;
+
+/** @brief A structure for representing matrices with 4 columns and 2 rows. */
+typedef struct mat4x2 {
+        vec4 t[2];
+} mat4x2;
+
+/** 
+ * @brief A structure for representing matrices with 4 columns and 3 rows.
+ * 
+ * As an affine transform it is a mat4x4 without the last row (0, 0, 0, 1),
+ * the rotation/scale is in x, y, z and the translation in w of every row.
+ * It takes 48 bytes instead of 64 and every row is 16 byte aligned.
+ */
+typedef struct mat4x3 {
+        vec4 t[3];
+} mat4x3;
+
+
+/** 
+ * @brief The capacity of a structure of arrays is a multiple of this (in floats).
+ * 
+ * 16 floats is one 64 byte cache line and one AVX-512 register, so the
+ * kernels can always load the last register whole. They only write the
+ * lanes below count, the padding past it keeps its value.
+ */
+#define SMATH_SOA_WIDTH 16
+
+/** 
+ * @brief A structure of arrays of 3D vectors, vector i is (x[i], y[i], z[i]).
+ * 
+ * Every array is 64 byte aligned and holds capacity floats.
+ */
+typedef struct vec3_soa {
+        f32 *x, *y, *z;
+        size_t count;
+        size_t capacity;
+} vec3_soa;
+
+/** 
+ * @brief A structure of arrays of 4D vectors, vector i is (x[i], y[i], z[i], w[i]).
+ * 
+ * Every array is 64 byte aligned and holds capacity floats.
+ */
+typedef struct vec4_soa {
+        f32 *x, *y, *z, *w;
+        size_t count;
+        size_t capacity;
+} vec4_soa;
+
+/** 
+ * @brief A structure of arrays of bounding spheres, the center in x, y, z and the radius in w.
+ */
+typedef vec4_soa sphere_soa;
+
+/** 
+ * @brief A structure of arrays of axis aligned bounding boxes, box i is (min[i], max[i]).
+ * 
+ * min and max hold the same count.
+ */
+typedef struct aabb_soa {
+        vec3_soa min;
+        vec3_soa max;
+} aabb_soa;
+
+/** 
+ * @brief A structure of arrays of rays, ray i is (origin[i], direction[i]).
+ * 
+ * origin and direction hold the same count.
+ */
+typedef struct ray_soa {
+        vec3_soa origin;
+        vec3_soa direction;
+} ray_soa;
+
+/** 
+ * @brief A structure of arrays of triangles, triangle i is (v0[i], v1[i], v2[i]).
+ * 
+ * v0, v1 and v2 hold the same count.
+ */
+typedef struct triangle_soa {
+        vec3_soa v0, v1, v2;
+} triangle_soa;
+
+
 #endif // MATH_TYPES_H
\ No newline at end of file
@@ -0,0 +1,172 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "math_types.h"
+#include "types.h"
+#include "mat4x4.h"
+
+/** @defgroup parallel_ Run the batch kernels over several threads.
+ *
+ * The _parallel functions split their arrays into chunks of about
+ * SMATH_PARALLEL_CHUNK_BYTES, a multiple of SMATH_SOA_WIDTH elements, and
+ * run the same dispatched kernel as the single threaded version on every
+ * chunk. The chunk boundaries only depend on n, never on the number of
+ * threads, and every element is computed on its own, so the results are
+ * bit for bit the same as the single threaded functions.
+ *
+ * The chunks run on the built-in pool (smath_pool_start), a work-stealing
+ * pool: every thread takes chunks from the front of its own range and
+ * steals from the back of the others when it runs out. The calling thread
+ * works as well and the call returns when every chunk is done.
+ * smath_set_scheduler replaces the pool with the scheduler of the
+ * application. Without either, or when called from inside a chunk, the
+ * chunks run one after the other on the calling thread.
+ *
+ * Calls from several threads at the same time are safe, they take turns
+ * on the built-in pool.
+ *
+ * @note Only available in the archive build, not with SMATH_HEADER_ONLY.
+ * @{
+ */
+
+
+/** @brief The bytes of input and output one chunk touches, about half of a typical L2. */
+#define SMATH_PARALLEL_CHUNK_BYTES (128 * 1024)
+
+/** @brief The most threads the built-in pool runs, the calling thread included. */
+#define SMATH_POOL_MAX_THREADS 64
+
+
+/**
+ * @brief One chunk of a parallel job.
+ *
+ * @param [*ctx] Takes the context given to smath_parallel_for.
+ * @param [chunk] Takes the index of the chunk, in [0, chunks).
+ */
+typedef void (*smath_task_fn)(void *ctx, size_t chunk);
+
+/**
+ * @brief A scheduler that runs task(ctx, c) for every c in [0, chunks).
+ *
+ * The chunks can run in any order and on any thread, the scheduler has
+ * to return only after all of them are done.
+ *
+ * @param [*user] Takes the pointer given to smath_set_scheduler.
+ * @param [task] Takes the function to run for every chunk.
+ * @param [*ctx] Takes the context of task.
+ * @param [chunks] Takes the number of chunks, at least 1.
+ */
+typedef void (*smath_scheduler_fn)(void *user, smath_task_fn task, void *ctx, size_t chunks);
+
+
+/**
+ * @brief Start the built-in pool.
+ *
+ * @param [threads] Takes the number of threads including the calling one, 0 for one per core.
+ * @return [bool] Returns false if a thread could not be created, the pool is then stopped.
+ * @note Not thread-safe, call it before the _parallel functions are used. It
+ * stops a running pool first.
+ */
+extern bool smath_pool_start(u32 threads);
+
+/**
+ * @brief Stop the built-in pool and join its threads.
+ *
+ * @note Not thread-safe, no _parallel function may be running.
+ */
+extern void smath_pool_stop(void);
+
+/**
+ * @brief Get the size of the built-in pool.
+ *
+ * @return [u32] Returns the number of threads including the calling one, 1 if the pool is stopped.
+ */
+extern u32 smath_pool_threads(void);
+
+/**
+ * @brief Run the parallel jobs on the scheduler of the application.
+ *
+ * @param [fn] Takes the scheduler, NULL goes back to the built-in pool.
+ * @param [*user] Takes a pointer given to every call of fn.
+ * @note Not thread-safe, no _parallel function may be running.
+ */
+extern void smath_set_scheduler(smath_scheduler_fn fn, void *user);
+
+/**
+ * @brief Run task(ctx, c) for every c in [0, chunks) on the scheduler or the pool.
+ *
+ * @param [task] Takes the function to run for every chunk.
+ * @param [*ctx] Takes the context of task.
+ * @param [chunks] Takes the number of chunks.
+ */
+extern void smath_parallel_for(smath_task_fn task, void *ctx, size_t chunks);
+
+/**
+ * @brief The chunk size for n elements of elem_bytes bytes of input and output each.
+ *
+ * @param [elem_bytes] Takes the bytes one element reads and writes.
+ * @return [size_t] Returns the elements per chunk, a multiple of SMATH_SOA_WIDTH.
+ */
+extern size_t smath_parallel_chunk(size_t elem_bytes);
+
+
+/**
+ * @brief mat4x4_mult_array (dispatch.h) over several threads.
+ *
+ * @param [*dest] Takes a pointer to n mat4x4.
+ * @param [*m0] Takes a pointer to n mat4x4.
+ * @param [*m1] Takes a pointer to n mat4x4.
+ * @param [n] Takes the number of matrices.
+ */
+extern void mat4x4_mult_array_parallel(mat4x4 *dest, const mat4x4 *m0, const mat4x4 *m1, size_t n);
+
+/**
+ * @brief mat4x4_transform_points (transform.h) over several threads.
+ *
+ * @param [*m] Takes a pointer to a mat4x4.
+ * @param [*in] Takes a pointer to n vec3.
+ * @param [*out] Takes a pointer to n vec3, can be in.
+ * @param [n] Takes the number of points.
+ */
+extern void mat4x4_transform_points_parallel(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n);
+
+/**
+ * @brief mat4x4_transform_directions (transform.h) over several threads.
+ *
+ * @param [*m] Takes a pointer to a mat4x4.
+ * @param [*in] Takes a pointer to n vec3.
+ * @param [*out] Takes a pointer to n vec3, can be in.
+ * @param [n] Takes the number of directions.
+ */
+extern void mat4x4_transform_directions_parallel(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n);
+
+/**
+ * @brief mat4x4_transform_vec4s (transform.h) over several threads.
+ *
+ * @param [*m] Takes a pointer to a mat4x4.
+ * @param [*in] Takes a pointer to n vec4.
+ * @param [*out] Takes a pointer to n vec4, can be in.
+ * @param [n] Takes the number of vectors.
+ */
+extern void mat4x4_transform_vec4s_parallel(const mat4x4 *m, const vec4 *in, vec4 *out, size_t n);
+
+/**
+ * @brief vec3_soa_normalize (vector_soa.h) over several threads.
+ *
+ * @param [*v] Takes a pointer to a vec3_soa.
+ */
+extern void vec3_soa_normalize_parallel(vec3_soa *v);
+
+/**
+ * @brief vec4_soa_normalize (vector_soa.h) over several threads.
+ *
+ * @param [*v] Takes a pointer to a vec4_soa.
+ */
+extern void vec4_soa_normalize_parallel(vec4_soa *v);
+
+/** @}*/
+
+#endif // PARALLEL_H
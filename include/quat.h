@@ -0,0 +1,112 @@
+#ifndef QUAT_H
+#define QUAT_H
+
+
+#include "../include/math_types.h"
+#include "../include/smath_config.h"
+#include "../include/vector3.h"
+#include "../include/mat4x4.h"
+
+/** @defgroup quat_ Contains all of the quaternion operations/functions.
+ * 
+ * The batched nlerp/slerp over structures of arrays are in vector_soa.h.
+ * @{ 
+ */
+
+
+/** 
+ * @brief Create a quaternion that rotates around an axis.
+ * 
+ * @param [*axis] Takes a pointer to a normalized vec3.
+ * @param [angle] Takes the angle in radians.
+ * @return [quat] Returns the unit quaternion.
+ */
+SMATH_API quat quat_create_from_axis_angle(const vec3 *axis, const f32 angle);
+
+/** 
+ * @brief Multiply two quaternions.
+ * 
+ * The result rotates by q1 first and then by q0.
+ * 
+ * @param [*q0] Takes a pointer to a quat.
+ * @param [*q1] Takes a pointer to a quat.
+ * @return [quat] Returns q0 * q1.
+ */
+SMATH_API quat quat_mult(const quat *q0, const quat *q1);
+
+/** 
+ * @brief Conjugate a quaternion, the inverse rotation of a unit quaternion.
+ * 
+ * @param [*q] Takes a pointer to a quat.
+ * @return [quat] Returns (-x, -y, -z, w).
+ */
+SMATH_API quat quat_conjugate(const quat *q);
+
+/** 
+ * @brief Rotate a 3D vector with a quaternion.
+ * 
+ * Uses v + w * t + u x t with t = 2 * (u x v), two cross products
+ * instead of q * v * q'.
+ * 
+ * @param [*q] Takes a pointer to a unit quat.
+ * @param [*v] Takes a pointer to a vec3.
+ * @return [vec3] Returns the rotated vector.
+ */
+SMATH_API vec3 quat_rotate_vec3(const quat *q, const vec3 *v);
+
+/** 
+ * @brief Blend two quaternions linearly and normalize the result.
+ * 
+ * Takes the shorter arc, q1 is negated when the dot product is negative.
+ * 
+ * @param [*q0] Takes a pointer to a unit quat, the result at t = 0.
+ * @param [*q1] Takes a pointer to a unit quat, the result at t = 1.
+ * @param [t] Takes the blend factor in [0, 1].
+ * @return [quat] Returns the blended unit quaternion.
+ */
+SMATH_API quat quat_nlerp(const quat *q0, const quat *q1, const f32 t);
+
+/** 
+ * @brief Blend two quaternions with a constant angular speed.
+ * 
+ * Takes the shorter arc, falls back to quat_nlerp when they are almost equal.
+ * 
+ * @param [*q0] Takes a pointer to a unit quat, the result at t = 0.
+ * @param [*q1] Takes a pointer to a unit quat, the result at t = 1.
+ * @param [t] Takes the blend factor in [0, 1].
+ * @return [quat] Returns the blended unit quaternion.
+ */
+SMATH_API quat quat_slerp(const quat *q0, const quat *q1, const f32 t);
+
+/** 
+ * @brief Create a rotation matrix from a quaternion.
+ * 
+ * @param [*q] Takes a pointer to a unit quat.
+ * @return [mat4x4] Returns the rotation matrix, without translation.
+ */
+SMATH_API mat4x4 quat_to_mat4x4(const quat *q);
+
+/** 
+ * @brief Create a quaternion from the rotation of a matrix.
+ * 
+ * @param [*m] Takes a pointer to a mat4x4.
+ * @return [quat] Returns the unit quaternion.
+ * @note The 3x3 part has to be a rotation without scale, the translation is ignored.
+ */
+SMATH_API quat quat_from_mat4x4(const mat4x4 *m);
+
+
+#ifdef SMATH_SSE
+
+/** @brief SIMD SSE - Multiply two quaternions, same result as quat_mult. */
+SMATH_API quat quat_sse_mult(const quat *q0, const quat *q1);
+
+#endif // SMATH_SSE
+
+/** @}*/
+
+#ifdef SMATH_HEADER_ONLY
+#include "../src/quat.c"
+#endif
+
+#endif //QUAT_H
@@ -0,0 +1,153 @@
+#ifndef RAY_H
+#define RAY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "math_types.h"
+#include "types.h"
+
+/** @defgroup ray_ Ray intersection tests against triangles, boxes, spheres and planes.
+ *
+ * A hit is reported for a distance 0 <= t < t_max along the ray, t_max
+ * can be INFINITY. Boxes and spheres are solid, a ray starting inside
+ * one hits it at t = 0.
+ *
+ * The packet functions go through the dispatched kernels (dispatch.h),
+ * one register holds 4 (SSE2), 8 (AVX2) or 16 (AVX-512) lanes:
+ * - ray_intersect_triangles, _spheres and _aabbs test one ray against a
+ *   structure of arrays and return the nearest hit, a lane per object.
+ * - ray_soa_intersect_aabb, _sphere and _plane test a structure of arrays
+ *   of rays against one object, a lane per ray, and write a hit bitmask
+ *   like the culling functions (culling.h): bit i % 32 of hits[i / 32] is
+ *   set when ray i hits, hits has to hold (count + 31) / 32 words and the
+ *   bits past count are cleared.
+ *
+ * Like the other structure of arrays kernels they read the padding up to
+ * the next SMATH_SOA_WIDTH, it is never reported as a hit.
+ *
+ * @note Only available in the archive build, not with SMATH_HEADER_ONLY.
+ * @{
+ */
+
+
+/**
+ * @brief Intersect a ray with a triangle (Moller-Trumbore).
+ *
+ * A degenerate triangle and a ray in the plane of the triangle miss.
+ *
+ * @param [*r] Takes a pointer to a ray.
+ * @param [*tri] Takes a pointer to a triangle.
+ * @param [t_max] Takes the distance a hit has to be closer than.
+ * @param [*t] Takes a pointer to a float for the distance of the hit, only written on a hit.
+ * @return [bool] Returns true if the ray hits the triangle.
+ */
+extern bool ray_intersect_triangle(const ray *r, const triangle *tri, f32 t_max, f32 *t);
+
+/**
+ * @brief Intersect a ray with a box (slab test).
+ *
+ * @param [*r] Takes a pointer to a ray.
+ * @param [*b] Takes a pointer to an aabb.
+ * @param [t_max] Takes the distance a hit has to be closer than.
+ * @param [*t] Takes a pointer to a float for the entry distance, only written on a hit.
+ * @return [bool] Returns true if the ray hits the box.
+ */
+extern bool ray_intersect_aabb(const ray *r, const aabb *b, f32 t_max, f32 *t);
+
+/**
+ * @brief Intersect a ray with a sphere.
+ *
+ * @param [*r] Takes a pointer to a ray.
+ * @param [*s] Takes a pointer to a sphere.
+ * @param [t_max] Takes the distance a hit has to be closer than.
+ * @param [*t] Takes a pointer to a float for the entry distance, only written on a hit.
+ * @return [bool] Returns true if the ray hits the sphere.
+ */
+extern bool ray_intersect_sphere(const ray *r, const sphere *s, f32 t_max, f32 *t);
+
+/**
+ * @brief Intersect a ray with a plane, from either side.
+ *
+ * A ray parallel to the plane misses, even when it lies in the plane.
+ *
+ * @param [*r] Takes a pointer to a ray.
+ * @param [*p] Takes a pointer to a plane.
+ * @param [t_max] Takes the distance a hit has to be closer than.
+ * @param [*t] Takes a pointer to a float for the distance of the hit, only written on a hit.
+ * @return [bool] Returns true if the ray hits the plane.
+ */
+extern bool ray_intersect_plane(const ray *r, const plane *p, f32 t_max, f32 *t);
+
+/**
+ * @brief Find the nearest triangle of a structure of arrays a ray hits.
+ *
+ * @param [*r] Takes a pointer to a ray.
+ * @param [*tris] Takes a pointer to a triangle_soa.
+ * @param [t_max] Takes the distance a hit has to be closer than.
+ * @param [*t] Takes a pointer to a float for the distance of the nearest hit, only written on a hit.
+ * @param [*index] Takes a pointer for the index of the nearest triangle, the lowest one on a tie.
+ * @return [bool] Returns true if the ray hits any triangle.
+ */
+extern bool ray_intersect_triangles(const ray *r, const triangle_soa *tris, f32 t_max, f32 *t, size_t *index);
+
+/**
+ * @brief Find the nearest sphere of a structure of arrays a ray hits.
+ *
+ * @param [*r] Takes a pointer to a ray.
+ * @param [*s] Takes a pointer to a sphere_soa.
+ * @param [t_max] Takes the distance a hit has to be closer than.
+ * @param [*t] Takes a pointer to a float for the distance of the nearest hit, only written on a hit.
+ * @param [*index] Takes a pointer for the index of the nearest sphere, the lowest one on a tie.
+ * @return [bool] Returns true if the ray hits any sphere.
+ */
+extern bool ray_intersect_spheres(const ray *r, const sphere_soa *s, f32 t_max, f32 *t, size_t *index);
+
+/**
+ * @brief Find the nearest box of a structure of arrays a ray hits.
+ *
+ * @param [*r] Takes a pointer to a ray.
+ * @param [*b] Takes a pointer to an aabb_soa.
+ * @param [t_max] Takes the distance a hit has to be closer than.
+ * @param [*t] Takes a pointer to a float for the distance of the nearest hit, only written on a hit.
+ * @param [*index] Takes a pointer for the index of the nearest box, the lowest one on a tie.
+ * @return [bool] Returns true if the ray hits any box.
+ */
+extern bool ray_intersect_aabbs(const ray *r, const aabb_soa *b, f32 t_max, f32 *t, size_t *index);
+
+/**
+ * @brief Intersect a structure of arrays of rays with one box.
+ *
+ * @param [*r] Takes a pointer to a ray_soa.
+ * @param [*b] Takes a pointer to an aabb.
+ * @param [*t_max] Takes a pointer to r->origin.count floats, the distance the hit of every ray has to be closer than.
+ * @param [*t] Takes a pointer to r->origin.count floats for the entry distances, INFINITY for a miss. Can be NULL.
+ * @param [*hits] Takes a pointer to (r->origin.count + 31) / 32 words for the bitmask.
+ */
+extern void ray_soa_intersect_aabb(const ray_soa *r, const aabb *b, const f32 *t_max, f32 *t, u32 *hits);
+
+/**
+ * @brief Intersect a structure of arrays of rays with one sphere.
+ *
+ * @param [*r] Takes a pointer to a ray_soa.
+ * @param [*s] Takes a pointer to a sphere.
+ * @param [*t_max] Takes a pointer to r->origin.count floats, the distance the hit of every ray has to be closer than.
+ * @param [*t] Takes a pointer to r->origin.count floats for the entry distances, INFINITY for a miss. Can be NULL.
+ * @param [*hits] Takes a pointer to (r->origin.count + 31) / 32 words for the bitmask.
+ */
+extern void ray_soa_intersect_sphere(const ray_soa *r, const sphere *s, const f32 *t_max, f32 *t, u32 *hits);
+
+/**
+ * @brief Intersect a structure of arrays of rays with one plane.
+ *
+ * @param [*r] Takes a pointer to a ray_soa.
+ * @param [*p] Takes a pointer to a plane.
+ * @param [*t_max] Takes a pointer to r->origin.count floats, the distance the hit of every ray has to be closer than.
+ * @param [*t] Takes a pointer to r->origin.count floats for the hit distances, INFINITY for a miss. Can be NULL.
+ * @param [*hits] Takes a pointer to (r->origin.count + 31) / 32 words for the bitmask.
+ */
+extern void ray_soa_intersect_plane(const ray_soa *r, const plane *p, const f32 *t_max, f32 *t, u32 *hits);
+
+/** @}*/
+
+#endif // RAY_H
@@ -0,0 +1,104 @@
+#ifndef SKINNING_H
+#define SKINNING_H
+
+#include <stddef.h>
+
+#include "math_types.h"
+#include "types.h"
+#include "mat4x4.h"
+
+/** @defgroup skinning_ Skinning of vertices with up to 4 bones each.
+ *
+ * The palette holds the skinning matrix of every bone, the bone's world
+ * transform times the inverse of its bind pose, as affine 3x4 matrices
+ * (mat3x4: the x, y, z axis and the translation) or as dual quaternions.
+ *
+ * Linear blend skinning sums the weighted matrices of the 4 bones and
+ * transforms the vertex once with the sum. Dual quaternion skinning blends
+ * rigid transforms instead, so joints that twist keep their volume, but
+ * the palette must not contain scale.
+ *
+ * positions and normals can be the same arrays as the output, normals are
+ * not normalized again. The skinning goes through the dispatched kernels
+ * (dispatch.h).
+ *
+ * @note Only available in the archive build, not with SMATH_HEADER_ONLY.
+ * @{
+ */
+
+
+/**
+ * @brief The bones that move a vertex.
+ *
+ * The weights should sum to 1, an unused bone has the weight 0 and any
+ * index inside the palette.
+ */
+typedef struct skin_influence {
+        u16 bone[4];
+        f32 weight[4];
+} skin_influence;
+
+
+/**
+ * @brief Build a skinning palette, dest[i] = world[i] * inverse_bind[i].
+ *
+ * @param [*dest] Takes a pointer to n mat3x4.
+ * @param [*world] Takes a pointer to the n affine world matrices of the bones.
+ * @param [*inverse_bind] Takes a pointer to the n inverse bind pose matrices.
+ * @param [n] Takes the number of bones.
+ */
+extern void skin_palette_from_mat4x4(mat3x4 *dest, const mat4x4 *world, const mat4x4 *inverse_bind, size_t n);
+
+/**
+ * @brief Convert a rigid affine matrix to a dual quaternion.
+ *
+ * @param [*m] Takes a pointer to a mat3x4, the axes are normalized first.
+ * @return [dual_quat] Returns the dual quaternion of the same transform.
+ */
+extern dual_quat dual_quat_from_mat3x4(const mat3x4 *m);
+
+/**
+ * @brief Convert a linear skinning palette for dual quaternion skinning.
+ *
+ * @param [*dest] Takes a pointer to n dual_quat.
+ * @param [*palette] Takes a pointer to n rigid mat3x4.
+ * @param [n] Takes the number of bones.
+ */
+extern void skin_palette_to_dual_quat(dual_quat *dest, const mat3x4 *palette, size_t n);
+
+/**
+ * @brief Linear blend skinning of n vertices.
+ *
+ * @param [*palette] Takes a pointer to the mat3x4 of every bone.
+ * @param [*influences] Takes a pointer to n skin_influence.
+ * @param [*positions] Takes a pointer to n vec3.
+ * @param [*normals] Takes a pointer to n vec3, can be NULL.
+ * @param [*out_positions] Takes a pointer to n vec3.
+ * @param [*out_normals] Takes a pointer to n vec3, NULL when normals is NULL.
+ * @param [n] Takes the number of vertices.
+ */
+extern void skin_linear(const mat3x4 *palette, const skin_influence *influences,
+                        const vec3 *positions, const vec3 *normals,
+                        vec3 *out_positions, vec3 *out_normals, size_t n);
+
+/**
+ * @brief Dual quaternion skinning of n vertices.
+ *
+ * The dual quaternions of a vertex are flipped to the same hemisphere as
+ * the first one before they are blended.
+ *
+ * @param [*palette] Takes a pointer to the dual_quat of every bone.
+ * @param [*influences] Takes a pointer to n skin_influence.
+ * @param [*positions] Takes a pointer to n vec3.
+ * @param [*normals] Takes a pointer to n vec3, can be NULL.
+ * @param [*out_positions] Takes a pointer to n vec3.
+ * @param [*out_normals] Takes a pointer to n vec3, NULL when normals is NULL.
+ * @param [n] Takes the number of vertices.
+ */
+extern void skin_dual_quat(const dual_quat *palette, const skin_influence *influences,
+                           const vec3 *positions, const vec3 *normals,
+                           vec3 *out_positions, vec3 *out_normals, size_t n);
+
+/** @}*/
+
+#endif // SKINNING_H
@@ -1,16 +1,52 @@
-#ifndef S_MATH_H
-#define S_MATH_H
-
-/** 
- * @brief A single headerfile to include all other headerfiles into one.
- */
-
-#include "math_types.h"
-#include "types.h"
-
-#include "vector4.h"
-#include "vector3.h"
-#include "vector2.h"
-#include "mat4x4.h"
-
+#ifndef S_MATH_H
+#define S_MATH_H
+
+/** 
+ * @brief A single headerfile to include all other headerfiles into one.
+ *
+ * Define SMATH_HEADER_ONLY before including this headerfile to use the
+ * library without linking the archives under libs/, every vector and
+ * matrix function is then a static inline definition (see smath_config.h).
+ * The dispatched kernels (dispatch.h, transform.h, vector_soa.h,
+ * transcendental.h, culling.h, ray.h, bvh.h, grid.h, skinning.h,
+ * compress.h, dtransform.h, allocator.h), hierarchy.h and parallel.h
+ * still need their archives in that mode.
+ */
+
+#include "smath_config.h"
+#include "math_types.h"
+#include "types.h"
+
+#include "vector4.h"
+#include "vector3.h"
+#include "vector2.h"
+#include "dvector.h"
+#include "mat2x2.h"
+#include "mat2x3.h"
+#include "mat2x4.h"
+#include "mat3x2.h"
+#include "mat3x3.h"
+#include "mat3x4.h"
+#include "mat4x2.h"
+#include "mat4x3.h"
+#include "mat4x4.h"
+#include "dmat4x4.h"
+#include "quat.h"
+#include "vector_value.h"
+#include "fast_math.h"
+#include "dispatch.h"
+#include "transform.h"
+#include "vector_soa.h"
+#include "transcendental.h"
+#include "culling.h"
+#include "ray.h"
+#include "bvh.h"
+#include "grid.h"
+#include "allocator.h"
+#include "skinning.h"
+#include "compress.h"
+#include "dtransform.h"
+#include "hierarchy.h"
+#include "parallel.h"
+
 #endif // S_MATH_H
\ No newline at end of file
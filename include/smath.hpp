@@ -0,0 +1,984 @@
+#ifndef SMATH_HPP
+#define SMATH_HPP
+
+/**
+ * @brief Optional C++20 layer over the C library.
+ *
+ * vec<N, T> and mat<R, C, T> with operators, everything constexpr so
+ * constant transforms and projections are folded by the compiler:
+ *
+ *   constexpr smath::mat4f proj = smath::perspective(1.0F, 16.0F / 9.0F, 0.1F, 100.0F);
+ *
+ * vec<2..4, f32/f64> and the mat<R, C, f32> (and mat<4, 4, f64>) convert to
+ * and from the C structures of the same size (vec3, dvec4, mat4x4, mat2x3,
+ * ...) with smath::from_c/smath::to_c, the vectors also implicitly. The
+ * layout is the one of the C types, t[n] is row n and vectors are columns,
+ * so m * v is mat4x4_vec4_mult.
+ *
+ * Expressions over batches are not evaluated until they are assigned,
+ * smath::eval runs the whole chain in one loop without temporary arrays:
+ *
+ *   smath::eval(out, smath::batch(a) * s + smath::batch(b) - smath::batch(c));
+ *
+ * batch() takes any contiguous range of vec<N, T>, the C vector types or
+ * scalars, batch(soa) a vec3_soa/vec4_soa. With structure of arrays on
+ * both sides the loop is vectorized by the compiler.
+ *
+ * The C functions are all declared with C linkage, so this headerfile can
+ * be used with the archives and with SMATH_HEADER_ONLY.
+ */
+
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+extern "C" {
+#include "smath.h"
+}
+
+
+namespace smath {
+
+template<std::size_t N, class T> struct vec;
+template<std::size_t R, std::size_t C, class T> struct mat;
+
+using vec2f = vec<2, f32>;
+using vec3f = vec<3, f32>;
+using vec4f = vec<4, f32>;
+using vec2d = vec<2, f64>;
+using vec3d = vec<3, f64>;
+using vec4d = vec<4, f64>;
+using mat2f = mat<2, 2, f32>;
+using mat3f = mat<3, 3, f32>;
+using mat4f = mat<4, 4, f32>;
+using mat4d = mat<4, 4, f64>;
+
+
+namespace detail {
+
+/** @brief Stands in for a C type that does not exist, e.g. a vec<3, int>. */
+struct no_c_type {};
+
+template<std::size_t N, class T> struct c_vec { using type = no_c_type; };
+template<> struct c_vec<2, f32> { using type = ::vec2; };
+template<> struct c_vec<3, f32> { using type = ::vec3; };
+template<> struct c_vec<4, f32> { using type = ::vec4; };
+template<> struct c_vec<2, f64> { using type = ::dvec2; };
+template<> struct c_vec<3, f64> { using type = ::dvec3; };
+template<> struct c_vec<4, f64> { using type = ::dvec4; };
+
+template<std::size_t N, class T> using c_vec_t = typename c_vec<N, T>::type;
+
+/** @brief The matCxR of the C library is C columns and R rows. */
+template<std::size_t R, std::size_t C, class T> struct c_mat { using type = no_c_type; };
+template<> struct c_mat<2, 2, f32> { using type = ::mat2x2; };
+template<> struct c_mat<3, 2, f32> { using type = ::mat2x3; };
+template<> struct c_mat<4, 2, f32> { using type = ::mat2x4; };
+template<> struct c_mat<2, 3, f32> { using type = ::mat3x2; };
+template<> struct c_mat<3, 3, f32> { using type = ::mat3x3; };
+template<> struct c_mat<4, 3, f32> { using type = ::mat3x4; };
+template<> struct c_mat<2, 4, f32> { using type = ::mat4x2; };
+template<> struct c_mat<3, 4, f32> { using type = ::mat4x3; };
+template<> struct c_mat<4, 4, f32> { using type = ::mat4x4; };
+template<> struct c_mat<4, 4, f64> { using type = ::dmat4x4; };
+
+template<std::size_t R, std::size_t C, class T> using c_mat_t = typename c_mat<R, C, T>::type;
+
+/** @brief The C++ type of a C vector, anything else stays as it is. */
+template<class T> struct cpp_type { using type = T; };
+template<> struct cpp_type<::vec2> { using type = vec2f; };
+template<> struct cpp_type<::vec3> { using type = vec3f; };
+template<> struct cpp_type<::vec4> { using type = vec4f; };
+template<> struct cpp_type<::dvec2> { using type = vec2d; };
+template<> struct cpp_type<::dvec3> { using type = vec3d; };
+template<> struct cpp_type<::dvec4> { using type = vec4d; };
+
+template<class T> using cpp_type_t = typename cpp_type<std::remove_cv_t<T>>::type;
+
+
+/** @brief Square root, Newton's method while constant evaluated. */
+template<std::floating_point T>
+constexpr T sqrt(T a) {
+        if (!std::is_constant_evaluated()) {
+                return std::sqrt(a);
+        }
+        if (a != a || a < T(0)) {
+                return std::numeric_limits<T>::quiet_NaN();
+        }
+        if (a == T(0) || a == std::numeric_limits<T>::infinity()) {
+                return a;
+        }
+
+        long double x = a < T(1) ? 1.0L : (long double)a;
+        long double prev = 0.0L;
+        while (x != prev) {
+                prev = x;
+                x = 0.5L * (x + (long double)a / x);
+        }
+        return (T)x;
+}
+
+/** @brief Sine and cosine, a Taylor series on [-pi, pi] while constant evaluated. */
+template<std::floating_point T>
+constexpr void sin_cos(T a, T *s, T *c) {
+        if (!std::is_constant_evaluated()) {
+                *s = std::sin(a);
+                *c = std::cos(a);
+                return;
+        }
+
+        constexpr long double pi = 3.141592653589793238462643383279502884L;
+        long double x = a;
+        long double k = x / (2.0L * pi);
+        k = (long double)(long long)(k < 0.0L ? k - 0.5L : k + 0.5L);
+        x -= k * 2.0L * pi;
+
+        long double sn = 0.0L, cs = 0.0L;
+        long double ts = x, tc = 1.0L;
+        for (int i = 0; i < 24; ++i) {
+                sn += ts;
+                cs += tc;
+                ts *= -x * x / ((2 * i + 2) * (2 * i + 3));
+                tc *= -x * x / ((2 * i + 1) * (2 * i + 2));
+        }
+        *s = (T)sn;
+        *c = (T)cs;
+}
+
+/** @brief Row j of a C matrix, the float array of mat4x4/dmat4x4 or a C vector. */
+template<class T, std::size_t N>
+constexpr T &c_at(T (&row)[N], std::size_t j) { return row[j]; }
+
+template<class V> requires requires(V v) { v.y; }
+constexpr auto &c_at(V &row, std::size_t j) {
+        if constexpr (requires { row.w; }) {
+                return j == 0 ? row.x : j == 1 ? row.y : j == 2 ? row.z : row.w;
+        } else if constexpr (requires { row.z; }) {
+                return j == 0 ? row.x : j == 1 ? row.y : row.z;
+        } else {
+                return j == 0 ? row.x : row.y;
+        }
+}
+
+template<std::size_t N, class T, class F, std::size_t... I>
+constexpr vec<N, T> make(F &&f, std::index_sequence<I...>) {
+        return vec<N, T>(f(I)...);
+}
+
+/** @brief A vec<N, T> with component i set to f(i). */
+template<std::size_t N, class T, class F>
+constexpr vec<N, T> make(F &&f) {
+        return make<N, T>(f, std::make_index_sequence<N>{});
+}
+
+template<class T> inline constexpr bool is_vec = false;
+template<std::size_t N, class T> inline constexpr bool is_vec<vec<N, T>> = true;
+
+template<class T> inline constexpr bool is_mat = false;
+template<std::size_t R, std::size_t C, class T> inline constexpr bool is_mat<mat<R, C, T>> = true;
+
+template<std::size_t R, std::size_t C, class T>
+constexpr std::size_t mat_align() {
+        return R == 4 && C == 4 ? 64 : alignof(vec<C, T>);
+}
+
+} // namespace detail
+
+
+/** @brief A vector of 2 components, x and y. */
+template<class T>
+struct vec<2, T> {
+        using value_type = T;
+        static constexpr std::size_t n = 2;
+
+        T x, y;
+
+        constexpr vec() : x(), y() {}
+        constexpr explicit vec(T s) : x(s), y(s) {}
+        constexpr vec(T x_, T y_) : x(x_), y(y_) {}
+        constexpr vec(const detail::c_vec_t<2, T> &c) : x(c.x), y(c.y) {}
+
+        constexpr T &operator[](std::size_t i) { return i == 0 ? x : y; }
+        constexpr const T &operator[](std::size_t i) const { return i == 0 ? x : y; }
+};
+
+/** @brief A vector of 3 components, x, y and z. */
+template<class T>
+struct vec<3, T> {
+        using value_type = T;
+        static constexpr std::size_t n = 3;
+
+        T x, y, z;
+
+        constexpr vec() : x(), y(), z() {}
+        constexpr explicit vec(T s) : x(s), y(s), z(s) {}
+        constexpr vec(T x_, T y_, T z_) : x(x_), y(y_), z(z_) {}
+        constexpr vec(const vec<2, T> &v, T z_) : x(v.x), y(v.y), z(z_) {}
+        constexpr vec(const detail::c_vec_t<3, T> &c) : x(c.x), y(c.y), z(c.z) {}
+
+        constexpr T &operator[](std::size_t i) { return i == 0 ? x : i == 1 ? y : z; }
+        constexpr const T &operator[](std::size_t i) const { return i == 0 ? x : i == 1 ? y : z; }
+};
+
+/** @brief A vector of 4 components, aligned like vec4/dvec4. */
+template<class T>
+struct alignas(4 * sizeof(T)) vec<4, T> {
+        using value_type = T;
+        static constexpr std::size_t n = 4;
+
+        T x, y, z, w;
+
+        constexpr vec() : x(), y(), z(), w() {}
+        constexpr explicit vec(T s) : x(s), y(s), z(s), w(s) {}
+        constexpr vec(T x_, T y_, T z_, T w_) : x(x_), y(y_), z(z_), w(w_) {}
+        constexpr vec(const vec<3, T> &v, T w_) : x(v.x), y(v.y), z(v.z), w(w_) {}
+        constexpr vec(const detail::c_vec_t<4, T> &c) : x(c.x), y(c.y), z(c.z), w(c.w) {}
+
+        constexpr T &operator[](std::size_t i) { return i == 0 ? x : i == 1 ? y : i == 2 ? z : w; }
+        constexpr const T &operator[](std::size_t i) const { return i == 0 ? x : i == 1 ? y : i == 2 ? z : w; }
+
+        /** @brief The first 3 components. */
+        constexpr vec<3, T> xyz() const { return vec<3, T>(x, y, z); }
+};
+
+
+/**
+ * @brief A matrix of R rows and C columns, t[n] is row n like the C matrices.
+ *
+ * An aggregate, mat4f m{} is all zero and mat4f::identity() the identity.
+ */
+template<std::size_t R, std::size_t C, class T>
+struct alignas(detail::mat_align<R, C, T>()) mat {
+        using value_type = T;
+        static constexpr std::size_t rows = R;
+        static constexpr std::size_t cols = C;
+
+        vec<C, T> t[R];
+
+        constexpr vec<C, T> &operator[](std::size_t i) { return t[i]; }
+        constexpr const vec<C, T> &operator[](std::size_t i) const { return t[i]; }
+
+        /** @brief Column j. */
+        constexpr vec<R, T> column(std::size_t j) const {
+                return detail::make<R, T>([&](std::size_t i) { return t[i][j]; });
+        }
+
+        static constexpr mat identity() requires (R == C) {
+                mat m{};
+                for (std::size_t i = 0; i < R; ++i) {
+                        m.t[i][i] = T(1);
+                }
+                return m;
+        }
+};
+
+
+/** @brief The C vector of a vec, e.g. a vec3 for a vec3f. */
+template<std::size_t N, class T>
+constexpr detail::c_vec_t<N, T> to_c(const vec<N, T> &v) {
+        detail::c_vec_t<N, T> c{};
+        for (std::size_t i = 0; i < N; ++i) {
+                detail::c_at(c, i) = v[i];
+        }
+        return c;
+}
+
+/** @brief The C matrix of a mat, e.g. a mat4x4 for a mat4f or a mat2x3 for a mat<3, 2, f32>. */
+template<std::size_t R, std::size_t C, class T>
+constexpr detail::c_mat_t<R, C, T> to_c(const mat<R, C, T> &m) {
+        detail::c_mat_t<R, C, T> c{};
+        for (std::size_t i = 0; i < R; ++i) {
+                for (std::size_t j = 0; j < C; ++j) {
+                        detail::c_at(c.t[i], j) = m.t[i][j];
+                }
+        }
+        return c;
+}
+
+/** @brief The vec of a C vector. */
+template<class V> requires detail::is_vec<detail::cpp_type_t<V>>
+constexpr detail::cpp_type_t<V> from_c(const V &c) {
+        return detail::cpp_type_t<V>(c);
+}
+
+/** @brief The mat of a C matrix, the type has to be given, e.g. from_c<4, 4, f32>(m). */
+template<std::size_t R, std::size_t C, class T>
+constexpr mat<R, C, T> from_c(const detail::c_mat_t<R, C, T> &c) {
+        mat<R, C, T> m{};
+        for (std::size_t i = 0; i < R; ++i) {
+                for (std::size_t j = 0; j < C; ++j) {
+                        m.t[i][j] = detail::c_at(c.t[i], j);
+                }
+        }
+        return m;
+}
+
+constexpr mat4f from_c(const ::mat4x4 &c) { return from_c<4, 4, f32>(c); }
+constexpr mat4d from_c(const ::dmat4x4 &c) { return from_c<4, 4, f64>(c); }
+constexpr mat3f from_c(const ::mat3x3 &c) { return from_c<3, 3, f32>(c); }
+
+
+// Vector operators, component wise.
+
+template<std::size_t N, class T>
+constexpr vec<N, T> operator+(const vec<N, T> &a, const vec<N, T> &b) {
+        return detail::make<N, T>([&](std::size_t i) { return a[i] + b[i]; });
+}
+
+template<std::size_t N, class T>
+constexpr vec<N, T> operator-(const vec<N, T> &a, const vec<N, T> &b) {
+        return detail::make<N, T>([&](std::size_t i) { return a[i] - b[i]; });
+}
+
+template<std::size_t N, class T>
+constexpr vec<N, T> operator*(const vec<N, T> &a, const vec<N, T> &b) {
+        return detail::make<N, T>([&](std::size_t i) { return a[i] * b[i]; });
+}
+
+template<std::size_t N, class T>
+constexpr vec<N, T> operator/(const vec<N, T> &a, const vec<N, T> &b) {
+        return detail::make<N, T>([&](std::size_t i) { return a[i] / b[i]; });
+}
+
+template<std::size_t N, class T>
+constexpr vec<N, T> operator-(const vec<N, T> &a) {
+        return detail::make<N, T>([&](std::size_t i) { return -a[i]; });
+}
+
+template<std::size_t N, class T>
+constexpr vec<N, T> operator*(const vec<N, T> &a, std::type_identity_t<T> s) {
+        return detail::make<N, T>([&](std::size_t i) { return a[i] * s; });
+}
+
+template<std::size_t N, class T>
+constexpr vec<N, T> operator*(std::type_identity_t<T> s, const vec<N, T> &a) {
+        return a * s;
+}
+
+/** @brief Multiplies with the reciprocal like vec3_scalar_div. */
+template<std::size_t N, class T>
+constexpr vec<N, T> operator/(const vec<N, T> &a, std::type_identity_t<T> s) {
+        return a * (T(1) / s);
+}
+
+template<std::size_t N, class T>
+constexpr vec<N, T> &operator+=(vec<N, T> &a, const vec<N, T> &b) { return a = a + b; }
+
+template<std::size_t N, class T>
+constexpr vec<N, T> &operator-=(vec<N, T> &a, const vec<N, T> &b) { return a = a - b; }
+
+template<std::size_t N, class T>
+constexpr vec<N, T> &operator*=(vec<N, T> &a, std::type_identity_t<T> s) { return a = a * s; }
+
+template<std::size_t N, class T>
+constexpr vec<N, T> &operator/=(vec<N, T> &a, std::type_identity_t<T> s) { return a = a / s; }
+
+template<std::size_t N, class T>
+constexpr bool operator==(const vec<N, T> &a, const vec<N, T> &b) {
+        for (std::size_t i = 0; i < N; ++i) {
+                if (a[i] != b[i]) {
+                        return false;
+                }
+        }
+        return true;
+}
+
+
+template<std::size_t N, class T>
+constexpr T dot(const vec<N, T> &a, const vec<N, T> &b) {
+        T d = a[0] * b[0];
+        for (std::size_t i = 1; i < N; ++i) {
+                d += a[i] * b[i];
+        }
+        return d;
+}
+
+template<class T>
+constexpr vec<3, T> cross(const vec<3, T> &a, const vec<3, T> &b) {
+        return vec<3, T>(a.y * b.z - a.z * b.y,
+                         a.z * b.x - a.x * b.z,
+                         a.x * b.y - a.y * b.x);
+}
+
+template<std::size_t N, class T>
+constexpr T length(const vec<N, T> &a) {
+        return detail::sqrt(dot(a, a));
+}
+
+template<std::size_t N, class T>
+constexpr vec<N, T> normalize(const vec<N, T> &a) {
+        return a / length(a);
+}
+
+/** @brief a + (b - a) * t. */
+template<std::size_t N, class T>
+constexpr vec<N, T> lerp(const vec<N, T> &a, const vec<N, T> &b, std::type_identity_t<T> t) {
+        return a + (b - a) * t;
+}
+
+
+// Matrix operators.
+
+template<std::size_t R, std::size_t C, class T>
+constexpr mat<R, C, T> operator+(const mat<R, C, T> &a, const mat<R, C, T> &b) {
+        mat<R, C, T> m{};
+        for (std::size_t i = 0; i < R; ++i) {
+                m.t[i] = a.t[i] + b.t[i];
+        }
+        return m;
+}
+
+template<std::size_t R, std::size_t C, class T>
+constexpr mat<R, C, T> operator-(const mat<R, C, T> &a, const mat<R, C, T> &b) {
+        mat<R, C, T> m{};
+        for (std::size_t i = 0; i < R; ++i) {
+                m.t[i] = a.t[i] - b.t[i];
+        }
+        return m;
+}
+
+template<std::size_t R, std::size_t C, class T>
+constexpr mat<R, C, T> operator*(const mat<R, C, T> &a, std::type_identity_t<T> s) {
+        mat<R, C, T> m{};
+        for (std::size_t i = 0; i < R; ++i) {
+                m.t[i] = a.t[i] * s;
+        }
+        return m;
+}
+
+/** @brief Row i of the product is the rows of b weighted by row i of a. */
+template<std::size_t R, std::size_t K, std::size_t C, class T>
+constexpr mat<R, C, T> operator*(const mat<R, K, T> &a, const mat<K, C, T> &b) {
+        mat<R, C, T> m{};
+        for (std::size_t i = 0; i < R; ++i) {
+                vec<C, T> r = b.t[0] * a.t[i][0];
+                for (std::size_t k = 1; k < K; ++k) {
+                        r += b.t[k] * a.t[i][k];
+                }
+                m.t[i] = r;
+        }
+        return m;
+}
+
+/** @brief The matrix times the column vector v, like mat4x4_vec4_mult. */
+template<std::size_t R, std::size_t C, class T>
+constexpr vec<R, T> operator*(const mat<R, C, T> &a, const vec<C, T> &v) {
+        return detail::make<R, T>([&](std::size_t i) { return dot(a.t[i], v); });
+}
+
+template<std::size_t R, std::size_t C, class T>
+constexpr bool operator==(const mat<R, C, T> &a, const mat<R, C, T> &b) {
+        for (std::size_t i = 0; i < R; ++i) {
+                if (!(a.t[i] == b.t[i])) {
+                        return false;
+                }
+        }
+        return true;
+}
+
+template<std::size_t R, std::size_t C, class T>
+constexpr mat<C, R, T> transpose(const mat<R, C, T> &a) {
+        mat<C, R, T> m{};
+        for (std::size_t i = 0; i < R; ++i) {
+                for (std::size_t j = 0; j < C; ++j) {
+                        m.t[j][i] = a.t[i][j];
+                }
+        }
+        return m;
+}
+
+template<class T>
+constexpr T determinant(const mat<2, 2, T> &m) {
+        return m.t[0][0] * m.t[1][1] - m.t[0][1] * m.t[1][0];
+}
+
+template<class T>
+constexpr T determinant(const mat<3, 3, T> &m) {
+        return dot(m.t[0], cross(m.t[1], m.t[2]));
+}
+
+/** @brief The 2x2 minors of the top and bottom two rows, like mat4x4_determinant. */
+template<class T>
+constexpr T determinant(const mat<4, 4, T> &m) {
+        const auto &a = m.t;
+        T s0 = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+        T s1 = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+        T s2 = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+        T s3 = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+        T s4 = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+        T s5 = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+
+        T c5 = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+        T c4 = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+        T c3 = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+        T c2 = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+        T c1 = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+        T c0 = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+
+        return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+}
+
+/** @brief The inverse, a singular matrix gives infinities or NaN. */
+template<class T>
+constexpr mat<2, 2, T> inverse(const mat<2, 2, T> &m) {
+        T inv = T(1) / determinant(m);
+        return mat<2, 2, T>{{vec<2, T>(m.t[1][1] * inv, -m.t[0][1] * inv),
+                             vec<2, T>(-m.t[1][0] * inv, m.t[0][0] * inv)}};
+}
+
+/** @brief The inverse, its columns are the cross products of the rows. */
+template<class T>
+constexpr mat<3, 3, T> inverse(const mat<3, 3, T> &m) {
+        vec<3, T> c0 = cross(m.t[1], m.t[2]);
+        vec<3, T> c1 = cross(m.t[2], m.t[0]);
+        vec<3, T> c2 = cross(m.t[0], m.t[1]);
+        T inv = T(1) / dot(m.t[0], c0);
+        return transpose(mat<3, 3, T>{{c0 * inv, c1 * inv, c2 * inv}});
+}
+
+/** @brief The inverse from the 2x2 minors, a singular matrix gives infinities or NaN. */
+template<class T>
+constexpr mat<4, 4, T> inverse(const mat<4, 4, T> &m) {
+        const auto &a = m.t;
+        T s0 = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+        T s1 = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+        T s2 = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+        T s3 = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+        T s4 = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+        T s5 = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+
+        T c5 = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+        T c4 = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+        T c3 = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+        T c2 = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+        T c1 = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+        T c0 = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+
+        T inv = T(1) / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+
+        mat<4, 4, T> r{};
+        r.t[0][0] = ( a[1][1] * c5 - a[1][2] * c4 + a[1][3] * c3) * inv;
+        r.t[0][1] = (-a[0][1] * c5 + a[0][2] * c4 - a[0][3] * c3) * inv;
+        r.t[0][2] = ( a[3][1] * s5 - a[3][2] * s4 + a[3][3] * s3) * inv;
+        r.t[0][3] = (-a[2][1] * s5 + a[2][2] * s4 - a[2][3] * s3) * inv;
+
+        r.t[1][0] = (-a[1][0] * c5 + a[1][2] * c2 - a[1][3] * c1) * inv;
+        r.t[1][1] = ( a[0][0] * c5 - a[0][2] * c2 + a[0][3] * c1) * inv;
+        r.t[1][2] = (-a[3][0] * s5 + a[3][2] * s2 - a[3][3] * s1) * inv;
+        r.t[1][3] = ( a[2][0] * s5 - a[2][2] * s2 + a[2][3] * s1) * inv;
+
+        r.t[2][0] = ( a[1][0] * c4 - a[1][1] * c2 + a[1][3] * c0) * inv;
+        r.t[2][1] = (-a[0][0] * c4 + a[0][1] * c2 - a[0][3] * c0) * inv;
+        r.t[2][2] = ( a[3][0] * s4 - a[3][1] * s2 + a[3][3] * s0) * inv;
+        r.t[2][3] = (-a[2][0] * s4 + a[2][1] * s2 - a[2][3] * s0) * inv;
+
+        r.t[3][0] = (-a[1][0] * c3 + a[1][1] * c1 - a[1][2] * c0) * inv;
+        r.t[3][1] = ( a[0][0] * c3 - a[0][1] * c1 + a[0][2] * c0) * inv;
+        r.t[3][2] = (-a[3][0] * s3 + a[3][1] * s1 - a[3][2] * s0) * inv;
+        r.t[3][3] = ( a[2][0] * s3 - a[2][1] * s1 + a[2][2] * s0) * inv;
+
+        return r;
+}
+
+
+// Transforms, for column vectors: the translation is in t[0..2][3].
+
+template<class T>
+constexpr mat<4, 4, T> translation(const vec<3, T> &v) {
+        mat<4, 4, T> m = mat<4, 4, T>::identity();
+        m.t[0][3] = v.x;
+        m.t[1][3] = v.y;
+        m.t[2][3] = v.z;
+        return m;
+}
+
+template<class T>
+constexpr mat<4, 4, T> scaling(const vec<3, T> &v) {
+        mat<4, 4, T> m{};
+        m.t[0][0] = v.x;
+        m.t[1][1] = v.y;
+        m.t[2][2] = v.z;
+        m.t[3][3] = T(1);
+        return m;
+}
+
+/** @brief Rotation of angle radians around a unit axis, counterclockwise looking down the axis. */
+template<class T>
+constexpr mat<4, 4, T> rotation(const vec<3, T> &axis, std::type_identity_t<T> angle) {
+        T s = T(0), c = T(0);
+        detail::sin_cos(angle, &s, &c);
+        T k = T(1) - c;
+        T x = axis.x, y = axis.y, z = axis.z;
+
+        mat<4, 4, T> m{};
+        m.t[0] = vec<4, T>(x * x * k + c,     x * y * k - z * s, x * z * k + y * s, T(0));
+        m.t[1] = vec<4, T>(y * x * k + z * s, y * y * k + c,     y * z * k - x * s, T(0));
+        m.t[2] = vec<4, T>(z * x * k - y * s, z * y * k + x * s, z * z * k + c,     T(0));
+        m.t[3] = vec<4, T>(T(0), T(0), T(0), T(1));
+        return m;
+}
+
+/**
+ * @brief A right handed perspective projection, the camera looks down -z.
+ *
+ * fovy is the vertical field of view in radians, z_near and z_far are positive
+ * distances. depth is the clip space range z is mapped to (culling.h).
+ */
+template<std::floating_point T>
+constexpr mat<4, 4, T> perspective(T fovy, std::type_identity_t<T> aspect, std::type_identity_t<T> z_near,
+                                   std::type_identity_t<T> z_far,
+                                   smath_clip_depth depth = SMATH_CLIP_DEPTH_NEG_ONE_TO_ONE) {
+        T s = T(0), c = T(0);
+        detail::sin_cos(fovy / T(2), &s, &c);
+        T f = c / s;
+        T inv = T(1) / (z_near - z_far);
+
+        mat<4, 4, T> m{};
+        m.t[0][0] = f / aspect;
+        m.t[1][1] = f;
+        if (depth == SMATH_CLIP_DEPTH_ZERO_TO_ONE) {
+                m.t[2][2] = z_far * inv;
+                m.t[2][3] = z_far * z_near * inv;
+        } else {
+                m.t[2][2] = (z_far + z_near) * inv;
+                m.t[2][3] = T(2) * z_far * z_near * inv;
+        }
+        m.t[3][2] = T(-1);
+        return m;
+}
+
+/** @brief A right handed orthographic projection of the box [l, r] x [b, t] x [-z_near, -z_far]. */
+template<std::floating_point T>
+constexpr mat<4, 4, T> ortho(T l, std::type_identity_t<T> r, std::type_identity_t<T> b, std::type_identity_t<T> t,
+                             std::type_identity_t<T> z_near, std::type_identity_t<T> z_far,
+                             smath_clip_depth depth = SMATH_CLIP_DEPTH_NEG_ONE_TO_ONE) {
+        T inv = T(1) / (z_near - z_far);
+
+        mat<4, 4, T> m{};
+        m.t[0][0] = T(2) / (r - l);
+        m.t[0][3] = (l + r) / (l - r);
+        m.t[1][1] = T(2) / (t - b);
+        m.t[1][3] = (b + t) / (b - t);
+        if (depth == SMATH_CLIP_DEPTH_ZERO_TO_ONE) {
+                m.t[2][2] = inv;
+                m.t[2][3] = z_near * inv;
+        } else {
+                m.t[2][2] = T(2) * inv;
+                m.t[2][3] = (z_far + z_near) * inv;
+        }
+        m.t[3][3] = T(1);
+        return m;
+}
+
+/** @brief A right handed view matrix, the camera at eye looks at center. */
+template<class T>
+constexpr mat<4, 4, T> look_at(const vec<3, T> &eye, const vec<3, T> &center, const vec<3, T> &up) {
+        vec<3, T> f = normalize(center - eye);
+        vec<3, T> s = normalize(cross(f, up));
+        vec<3, T> u = cross(s, f);
+
+        mat<4, 4, T> m{};
+        m.t[0] = vec<4, T>(s, -dot(s, eye));
+        m.t[1] = vec<4, T>(u, -dot(u, eye));
+        m.t[2] = vec<4, T>(-f, dot(f, eye));
+        m.t[3] = vec<4, T>(T(0), T(0), T(0), T(1));
+        return m;
+}
+
+/** @brief The point p transformed by an affine matrix, w = 1 and no divide. */
+template<class T>
+constexpr vec<3, T> transform_point(const mat<4, 4, T> &m, const vec<3, T> &p) {
+        return (m * vec<4, T>(p, T(1))).xyz();
+}
+
+
+/*
+ * Expression templates over batches.
+ *
+ * An expression has size() elements and operator[](i) computes element i
+ * from the elements i of its operands, nothing is computed before eval.
+ * The nodes hold their operands by value, the leaves only a pointer, so
+ * the arrays have to outlive the expression but a subexpression can be
+ * stored in an auto variable.
+ */
+
+namespace detail {
+
+struct expr_tag {};
+
+/*
+ * The loops of eval have no dependency between iterations, the
+ * destination is only allowed to be an operand at the same index. Without
+ * the hint the compiler gives up on the alias checks of a structure of
+ * arrays (3 or 4 destination arrays against every operand array).
+ */
+#if defined(__clang__)
+#define SMATH_IVDEP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define SMATH_IVDEP _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+#define SMATH_IVDEP __pragma(loop(ivdep))
+#else
+#define SMATH_IVDEP
+#endif
+
+/** @brief The size of an operand that is not an expression, it matches every size. */
+inline constexpr std::size_t any_size = std::numeric_limits<std::size_t>::max();
+
+} // namespace detail
+
+/** @brief A batch expression. */
+template<class E>
+concept expression = std::derived_from<std::remove_cvref_t<E>, detail::expr_tag>;
+
+/** @brief Anything an expression can be combined with, the same value is used for every element. */
+template<class E>
+concept operand = expression<E> || std::is_arithmetic_v<std::remove_cvref_t<E>> ||
+                  detail::is_vec<std::remove_cvref_t<E>> || detail::is_mat<std::remove_cvref_t<E>>;
+
+
+namespace detail {
+
+template<class E>
+constexpr decltype(auto) elem(const E &e, std::size_t i) {
+        if constexpr (expression<E>) {
+                return e[i];
+        } else {
+                return (e);
+        }
+}
+
+template<class E>
+constexpr std::size_t size_of(const E &e) {
+        if constexpr (expression<E>) {
+                return e.size();
+        } else {
+                return any_size;
+        }
+}
+
+template<class L, class R>
+constexpr std::size_t size_of(const L &l, const R &r) {
+        std::size_t a = size_of(l), b = size_of(r);
+        assert(a == any_size || b == any_size || a == b);
+        return a < b ? a : b;
+}
+
+/** @brief Reads element i of an array, as the C++ type of a C vector. */
+template<class T>
+struct view : expr_tag {
+        const T *p;
+        std::size_t n;
+
+        constexpr cpp_type_t<T> operator[](std::size_t i) const { return cpp_type_t<T>(p[i]); }
+        constexpr std::size_t size() const { return n; }
+};
+
+/** @brief Reads vector i of a vec3_soa/vec4_soa from its component arrays. */
+template<std::size_t N>
+struct soa_view : expr_tag {
+        const f32 *x, *y, *z, *w;
+        std::size_t n;
+
+        constexpr vec<N, f32> operator[](std::size_t i) const {
+                if constexpr (N == 3) {
+                        return vec<3, f32>(x[i], y[i], z[i]);
+                } else {
+                        return vec<4, f32>(x[i], y[i], z[i], w[i]);
+                }
+        }
+        constexpr std::size_t size() const { return n; }
+};
+
+template<class F, class E>
+struct unary : expr_tag {
+        [[no_unique_address]] F f;
+        E e;
+
+        constexpr auto operator[](std::size_t i) const { return f(elem(e, i)); }
+        constexpr std::size_t size() const { return size_of(e); }
+};
+
+template<class F, class L, class R>
+struct binary : expr_tag {
+        [[no_unique_address]] F f;
+        L l;
+        R r;
+
+        constexpr auto operator[](std::size_t i) const { return f(elem(l, i), elem(r, i)); }
+        constexpr std::size_t size() const { return size_of(l, r); }
+};
+
+template<class F, class E>
+constexpr unary<F, std::remove_cvref_t<E>> make_unary(F f, E &&e) {
+        return {{}, f, std::forward<E>(e)};
+}
+
+template<class F, class L, class R>
+constexpr binary<F, std::remove_cvref_t<L>, std::remove_cvref_t<R>> make_binary(F f, L &&l, R &&r) {
+        return {{}, f, std::forward<L>(l), std::forward<R>(r)};
+}
+
+struct add_fn { constexpr auto operator()(const auto &a, const auto &b) const { return a + b; } };
+struct sub_fn { constexpr auto operator()(const auto &a, const auto &b) const { return a - b; } };
+struct mul_fn { constexpr auto operator()(const auto &a, const auto &b) const { return a * b; } };
+struct div_fn { constexpr auto operator()(const auto &a, const auto &b) const { return a / b; } };
+struct neg_fn { constexpr auto operator()(const auto &a) const { return -a; } };
+struct dot_fn { constexpr auto operator()(const auto &a, const auto &b) const { return dot(a, b); } };
+struct cross_fn { constexpr auto operator()(const auto &a, const auto &b) const { return cross(a, b); } };
+struct length_fn { constexpr auto operator()(const auto &a) const { return length(a); } };
+struct normalize_fn { constexpr auto operator()(const auto &a) const { return normalize(a); } };
+
+/** @brief Stores v into a destination element, a C vector through to_c. */
+template<class D, class V>
+constexpr void store(D &d, const V &v) {
+        if constexpr (std::is_same_v<cpp_type_t<D>, D>) {
+                d = v;
+        } else {
+                d = to_c(cpp_type_t<D>(v));
+        }
+}
+
+} // namespace detail
+
+
+/** @brief A batch of n elements at p, a vec<N, T>, a C vector or a scalar. */
+template<class T>
+constexpr detail::view<T> batch(const T *p, std::size_t n) {
+        return {{}, p, n};
+}
+
+/** @brief A batch over a contiguous range, e.g. a std::vector<vec3> or a std::span<const vec3f>. */
+template<std::ranges::contiguous_range Range>
+        requires std::ranges::sized_range<Range> && (!expression<Range>)
+constexpr auto batch(const Range &r) {
+        return batch(std::ranges::data(r), (std::size_t)std::ranges::size(r));
+}
+
+/** @brief The count vectors of a vec3_soa as a batch of vec3f. */
+inline detail::soa_view<3> batch(const vec3_soa &soa) {
+        return {{}, soa.x, soa.y, soa.z, nullptr, soa.count};
+}
+
+/** @brief The count vectors of a vec4_soa as a batch of vec4f. */
+inline detail::soa_view<4> batch(const vec4_soa &soa) {
+        return {{}, soa.x, soa.y, soa.z, soa.w, soa.count};
+}
+
+
+template<operand L, operand R> requires (expression<L> || expression<R>)
+constexpr auto operator+(L &&l, R &&r) {
+        return detail::make_binary(detail::add_fn{}, std::forward<L>(l), std::forward<R>(r));
+}
+
+template<operand L, operand R> requires (expression<L> || expression<R>)
+constexpr auto operator-(L &&l, R &&r) {
+        return detail::make_binary(detail::sub_fn{}, std::forward<L>(l), std::forward<R>(r));
+}
+
+/** @brief Also a matrix times a batch of vectors. */
+template<operand L, operand R> requires (expression<L> || expression<R>)
+constexpr auto operator*(L &&l, R &&r) {
+        return detail::make_binary(detail::mul_fn{}, std::forward<L>(l), std::forward<R>(r));
+}
+
+template<operand L, operand R> requires (expression<L> || expression<R>)
+constexpr auto operator/(L &&l, R &&r) {
+        return detail::make_binary(detail::div_fn{}, std::forward<L>(l), std::forward<R>(r));
+}
+
+template<expression E>
+constexpr auto operator-(E &&e) {
+        return detail::make_unary(detail::neg_fn{}, std::forward<E>(e));
+}
+
+template<operand L, operand R> requires (expression<L> || expression<R>)
+constexpr auto dot(L &&l, R &&r) {
+        return detail::make_binary(detail::dot_fn{}, std::forward<L>(l), std::forward<R>(r));
+}
+
+template<operand L, operand R> requires (expression<L> || expression<R>)
+constexpr auto cross(L &&l, R &&r) {
+        return detail::make_binary(detail::cross_fn{}, std::forward<L>(l), std::forward<R>(r));
+}
+
+template<expression E>
+constexpr auto length(E &&e) {
+        return detail::make_unary(detail::length_fn{}, std::forward<E>(e));
+}
+
+template<expression E>
+constexpr auto normalize(E &&e) {
+        return detail::make_unary(detail::normalize_fn{}, std::forward<E>(e));
+}
+
+/** @brief f applied to every element, f has to return the same for the same element. */
+template<expression E, class F>
+constexpr auto map(E &&e, F f) {
+        return detail::make_unary(f, std::forward<E>(e));
+}
+
+
+/**
+ * @brief Evaluate the expression into dest in a single loop.
+ *
+ * dest is a contiguous range of the element type of the expression, its
+ * C type (vec3, ...) or anything the elements convert to. It may be one of
+ * the operands, but not overlap one at another index.
+ */
+template<std::ranges::contiguous_range Range, expression E>
+        requires std::ranges::sized_range<Range>
+constexpr void eval(Range &&dest, const E &e) {
+        auto *d = std::ranges::data(dest);
+        const std::size_t n = e.size();
+        assert(n == (std::size_t)std::ranges::size(dest));
+
+        SMATH_IVDEP
+        for (std::size_t i = 0; i < n; ++i) {
+                detail::store(d[i], e[i]);
+        }
+}
+
+/** @brief Evaluate the expression into the component arrays, the count of dest becomes its size. */
+template<expression E>
+void eval(vec3_soa &dest, const E &e) {
+        const std::size_t n = e.size();
+        assert(n <= dest.capacity);
+        f32 *x = dest.x, *y = dest.y, *z = dest.z;
+
+        SMATH_IVDEP
+        for (std::size_t i = 0; i < n; ++i) {
+                vec3f v = e[i];
+                x[i] = v.x;
+                y[i] = v.y;
+                z[i] = v.z;
+        }
+        dest.count = n;
+}
+
+/** @brief Evaluate the expression into the component arrays, the count of dest becomes its size. */
+template<expression E>
+void eval(vec4_soa &dest, const E &e) {
+        const std::size_t n = e.size();
+        assert(n <= dest.capacity);
+        f32 *x = dest.x, *y = dest.y, *z = dest.z, *w = dest.w;
+
+        SMATH_IVDEP
+        for (std::size_t i = 0; i < n; ++i) {
+                vec4f v = e[i];
+                x[i] = v.x;
+                y[i] = v.y;
+                z[i] = v.z;
+                w[i] = v.w;
+        }
+        dest.count = n;
+}
+
+} // namespace smath
+
+#endif // SMATH_HPP
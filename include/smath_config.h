@@ -0,0 +1,71 @@
+#ifndef SMATH_CONFIG_H
+#define SMATH_CONFIG_H
+
+/**
+ * @brief Build configuration shared by all headerfiles.
+ *
+ * By default every function is declared extern and linked from the
+ * static libraries (libvector2, libvector3, libvector4, libmat4x4).
+ *
+ * Define SMATH_HEADER_ONLY before including smath.h (or any of the
+ * vector/matrix headers) to get every function as a static inline
+ * definition instead. Nothing has to be linked in that mode and the
+ * compiler can inline and vectorize across the call sites.
+ */
+
+#ifdef SMATH_HEADER_ONLY
+
+/** @brief Storage class used on the declarations in the headerfiles. */
+#define SMATH_API static inline
+
+/** @brief Storage class used on the definitions in the source files. */
+#define SMATH_INLINE static inline
+
+#else
+
+#define SMATH_API extern
+#define SMATH_INLINE inline
+
+#endif // SMATH_HEADER_ONLY
+
+
+/** @brief Align a type or variable to n bytes. */
+#if defined(_MSC_VER)
+#define SMATH_ALIGN(n) __declspec(align(n))
+#else
+#define SMATH_ALIGN(n) __attribute__((aligned(n)))
+#endif
+
+
+/**
+ * @brief Defined when the SSE/SSE2 functions (vec4_sse_*, mat4x4_sse_*)
+ * are available, which is every x86-64 target.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SMATH_SSE 1
+#endif
+
+
+/**
+ * @brief Calling convention of the value functions (vector_value.h).
+ *
+ * __vectorcall passes __m128 arguments and structures of up to four of
+ * them in xmm registers on Windows, where they would be passed through
+ * memory otherwise. The System V ABI already does that for __m128, but
+ * not for a structure over 16 bytes such as mat4x4v.
+ */
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define SMATH_VECTORCALL __vectorcall
+#else
+#define SMATH_VECTORCALL
+#endif
+
+
+/** @brief restrict for the pointers of the batch functions, also in C++ and MSVC. */
+#if defined(__cplusplus) || defined(_MSC_VER)
+#define SMATH_RESTRICT __restrict
+#else
+#define SMATH_RESTRICT restrict
+#endif
+
+#endif // SMATH_CONFIG_H
@@ -0,0 +1,176 @@
+#ifndef TRANSCENDENTAL_H
+#define TRANSCENDENTAL_H
+
+#include <stddef.h>
+
+#include "types.h"
+#include "smath_config.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+/** @defgroup transc_ Vectorized sin, cos, atan2, exp, log and pow.
+ *
+ * Polynomial approximations evaluated on whole registers, for rotations
+ * and procedural animation that would otherwise call libm in a loop.
+ *
+ * The _array functions go through the dispatched kernels (dispatch.h),
+ * dest may be the same array as an input. The register versions are
+ * smath_<fn>_ps for __m128 and smath_<fn>_ps256 for __m256, the latter
+ * only declared when compiling for AVX2 + FMA.
+ *
+ * Max error against libm (in double), per accuracy tier:
+ *
+ *   function     SMATH_ACCURACY_HIGH                  SMATH_ACCURACY_FAST
+ *   sin, cos     2 ulp for |x| <= pi, 1e-7 absolute   5e-5 absolute
+ *   atan2        3 ulp                                3e-5 absolute
+ *   exp          2 ulp                                2e-5 relative
+ *   log          1 ulp                                5e-5 absolute
+ *   pow          grows with |y * log(x)|, see smath_pow_array
+ *
+ * sin and cos are reduced with 3 floats of pi / 2 (2 for the fast tier),
+ * so the absolute error holds for |x| up to 8192, past that they lose
+ * precision. atan2 gives what libm does for the zeros and infinities,
+ * atan2(+-0, -0) is +-pi. exp and log handle denormal outputs and inputs,
+ * NaN and the infinities. pow is exp(y * log(x)), a negative x gives NaN.
+ * tests/test_transcendental.c checks the table on every instruction set.
+ *
+ * @note Only available in the archive build, not with SMATH_HEADER_ONLY.
+ * @{
+ */
+
+
+/** @brief The accuracy tiers of the transcendental functions. */
+typedef enum smath_accuracy {
+        SMATH_ACCURACY_HIGH = 0,        /**< 1 to 3 ulp, Cephes polynomials */
+        SMATH_ACCURACY_FAST             /**< about 1e-4, shorter polynomials */
+} smath_accuracy;
+
+
+/**
+ * @brief Sine of every element.
+ *
+ * @param [*dest] Takes a pointer to n floats for the results.
+ * @param [*x] Takes a pointer to n floats, in radians.
+ * @param [n] Takes the number of elements.
+ * @param [acc] Takes the accuracy tier.
+ */
+extern void smath_sin_array(f32 *dest, const f32 *x, size_t n, smath_accuracy acc);
+
+/**
+ * @brief Cosine of every element.
+ *
+ * @param [*dest] Takes a pointer to n floats for the results.
+ * @param [*x] Takes a pointer to n floats, in radians.
+ * @param [n] Takes the number of elements.
+ * @param [acc] Takes the accuracy tier.
+ */
+extern void smath_cos_array(f32 *dest, const f32 *x, size_t n, smath_accuracy acc);
+
+/**
+ * @brief Sine and cosine of every element, cheaper than both on their own.
+ *
+ * @param [*dest_sin] Takes a pointer to n floats for the sines.
+ * @param [*dest_cos] Takes a pointer to n floats for the cosines.
+ * @param [*x] Takes a pointer to n floats, in radians.
+ * @param [n] Takes the number of elements.
+ * @param [acc] Takes the accuracy tier.
+ */
+extern void smath_sincos_array(f32 *dest_sin, f32 *dest_cos, const f32 *x, size_t n, smath_accuracy acc);
+
+/**
+ * @brief atan2(y[i], x[i]) of every pair, in [-pi, pi].
+ *
+ * @param [*dest] Takes a pointer to n floats for the results.
+ * @param [*y] Takes a pointer to n floats.
+ * @param [*x] Takes a pointer to n floats.
+ * @param [n] Takes the number of elements.
+ * @param [acc] Takes the accuracy tier.
+ */
+extern void smath_atan2_array(f32 *dest, const f32 *y, const f32 *x, size_t n, smath_accuracy acc);
+
+/**
+ * @brief e^x of every element.
+ *
+ * @param [*dest] Takes a pointer to n floats for the results.
+ * @param [*x] Takes a pointer to n floats.
+ * @param [n] Takes the number of elements.
+ * @param [acc] Takes the accuracy tier.
+ */
+extern void smath_exp_array(f32 *dest, const f32 *x, size_t n, smath_accuracy acc);
+
+/**
+ * @brief Natural logarithm of every element.
+ *
+ * @param [*dest] Takes a pointer to n floats for the results.
+ * @param [*x] Takes a pointer to n floats.
+ * @param [n] Takes the number of elements.
+ * @param [acc] Takes the accuracy tier.
+ */
+extern void smath_log_array(f32 *dest, const f32 *x, size_t n, smath_accuracy acc);
+
+/**
+ * @brief x[i]^y[i] of every pair, as exp(y * log(x)).
+ *
+ * An absolute error in y * log(x) becomes the same relative error of the
+ * result, so it is about 2 ulp * (1 + |y * log(x)|) with
+ * SMATH_ACCURACY_HIGH, 1e-5 near the overflow, and
+ * 1e-4 * (1 + |y * log(x)|) with SMATH_ACCURACY_FAST.
+ *
+ * @param [*dest] Takes a pointer to n floats for the results.
+ * @param [*x] Takes a pointer to n floats, not negative.
+ * @param [*y] Takes a pointer to n floats.
+ * @param [n] Takes the number of elements.
+ * @param [acc] Takes the accuracy tier.
+ */
+extern void smath_pow_array(f32 *dest, const f32 *x, const f32 *y, size_t n, smath_accuracy acc);
+
+
+#if defined(__SSE2__)
+
+/** @brief The 4 lane versions, SMATH_ACCURACY_HIGH and (_fast_) SMATH_ACCURACY_FAST. */
+extern __m128 smath_sin_ps(__m128 x);
+extern __m128 smath_sin_fast_ps(__m128 x);
+extern __m128 smath_cos_ps(__m128 x);
+extern __m128 smath_cos_fast_ps(__m128 x);
+extern __m128 smath_sincos_ps(__m128 x, __m128 *c);
+extern __m128 smath_sincos_fast_ps(__m128 x, __m128 *c);
+extern __m128 smath_atan2_ps(__m128 y, __m128 x);
+extern __m128 smath_atan2_fast_ps(__m128 y, __m128 x);
+extern __m128 smath_exp_ps(__m128 x);
+extern __m128 smath_exp_fast_ps(__m128 x);
+extern __m128 smath_log_ps(__m128 x);
+extern __m128 smath_log_fast_ps(__m128 x);
+extern __m128 smath_pow_ps(__m128 x, __m128 y);
+extern __m128 smath_pow_fast_ps(__m128 x, __m128 y);
+
+#endif // __SSE2__
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+/** @brief The 8 lane versions, the CPU has to support AVX2 and FMA. */
+extern __m256 smath_sin_ps256(__m256 x);
+extern __m256 smath_sin_fast_ps256(__m256 x);
+extern __m256 smath_cos_ps256(__m256 x);
+extern __m256 smath_cos_fast_ps256(__m256 x);
+extern __m256 smath_sincos_ps256(__m256 x, __m256 *c);
+extern __m256 smath_sincos_fast_ps256(__m256 x, __m256 *c);
+extern __m256 smath_atan2_ps256(__m256 y, __m256 x);
+extern __m256 smath_atan2_fast_ps256(__m256 y, __m256 x);
+extern __m256 smath_exp_ps256(__m256 x);
+extern __m256 smath_exp_fast_ps256(__m256 x);
+extern __m256 smath_log_ps256(__m256 x);
+extern __m256 smath_log_fast_ps256(__m256 x);
+extern __m256 smath_pow_ps256(__m256 x, __m256 y);
+extern __m256 smath_pow_fast_ps256(__m256 x, __m256 y);
+
+#endif // __AVX2__ && __FMA__
+
+/** @}*/
+
+#endif // TRANSCENDENTAL_H
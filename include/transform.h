@@ -0,0 +1,132 @@
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+#include <stddef.h>
+
+#include "math_types.h"
+#include "types.h"
+#include "mat4x4.h"
+#include "mat4x3.h"
+
+/** @defgroup transform_ Transform arrays of vectors with one 4x4 matrix.
+ *
+ * Batched versions of mat4x4_vec4_mult and mat4x4_from_trs, they go
+ * through the dispatched kernels (see dispatch.h) so the SSE2, AVX2 or
+ * AVX-512 loop is used.
+ *
+ * in and out can be the same array to transform in place, any other
+ * overlap between the two is not supported.
+ *
+ * The _stream versions write the output with non-temporal stores, which
+ * bypass the cache. Use them for outputs that are not read again soon
+ * (e.g. vertices copied to a GPU buffer), they are slower otherwise.
+ *
+ * @note Only available in the archive build, not with SMATH_HEADER_ONLY.
+ * @{
+ */
+
+
+/**
+ * @brief Transform an array of 3D points with a 4x4 matrix.
+ *
+ * Every point is multiplied as (x, y, z, 1), so the translation of the
+ * matrix is applied. The w of the result is dropped, there is no divide.
+ *
+ * @param [*m] Takes a pointer to a mat4x4.
+ * @param [*in] Takes a pointer to n vec3.
+ * @param [*out] Takes a pointer to n vec3, can be in.
+ * @param [n] Takes the number of points.
+ */
+extern void mat4x4_transform_points(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n);
+
+/**
+ * @brief Transform an array of 3D directions with a 4x4 matrix.
+ *
+ * Every direction is multiplied as (x, y, z, 0), so the translation of
+ * the matrix is not applied.
+ *
+ * @param [*m] Takes a pointer to a mat4x4.
+ * @param [*in] Takes a pointer to n vec3.
+ * @param [*out] Takes a pointer to n vec3, can be in.
+ * @param [n] Takes the number of directions.
+ */
+extern void mat4x4_transform_directions(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n);
+
+/**
+ * @brief Transform an array of 4D vectors with a 4x4 matrix.
+ *
+ * out[i] = mat4x4_vec4_mult(m, &in[i]) for every vector.
+ *
+ * @param [*m] Takes a pointer to a mat4x4.
+ * @param [*in] Takes a pointer to n vec4.
+ * @param [*out] Takes a pointer to n vec4, can be in.
+ * @param [n] Takes the number of vectors.
+ */
+extern void mat4x4_transform_vec4s(const mat4x4 *m, const vec4 *in, vec4 *out, size_t n);
+
+/**
+ * @brief Same as mat4x4_transform_points, with non-temporal stores.
+ *
+ * @param [*m] Takes a pointer to a mat4x4.
+ * @param [*in] Takes a pointer to n vec3.
+ * @param [*out] Takes a pointer to n vec3, can be in.
+ * @param [n] Takes the number of points.
+ */
+extern void mat4x4_transform_points_stream(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n);
+
+/**
+ * @brief Same as mat4x4_transform_vec4s, with non-temporal stores.
+ *
+ * @param [*m] Takes a pointer to a mat4x4.
+ * @param [*in] Takes a pointer to n vec4.
+ * @param [*out] Takes a pointer to n vec4, can be in.
+ * @param [n] Takes the number of vectors.
+ */
+extern void mat4x4_transform_vec4s_stream(const mat4x4 *m, const vec4 *in, vec4 *out, size_t n);
+
+/**
+ * @brief Build an array of matrices from translations, rotations and scales.
+ *
+ * dest[i] = mat4x4_from_trs(&t[i], &r[i], &s[i]), the model matrices of
+ * instanced rendering. 4 (SSE2) or 8 (AVX2) matrices are built at once
+ * with every element in its own register.
+ *
+ * @param [*dest] Takes a pointer to n mat4x4.
+ * @param [*t] Takes a pointer to n translations.
+ * @param [*r] Takes a pointer to n unit quaternions.
+ * @param [*s] Takes a pointer to n scales.
+ * @param [n] Takes the number of matrices.
+ */
+extern void mat4x4_from_trs_array(mat4x4 *dest, const vec3 *t, const quat *r, const vec3 *s, size_t n);
+
+/**
+ * @brief Build an array of matrices from translations, rotations and scales and multiply one matrix with them.
+ *
+ * dest[i] = m * mat4x4_from_trs(&t[i], &r[i], &s[i]) without the matrix in
+ * between, e.g. the view-projection times every model matrix or a parent
+ * transform times its children. The last row of the TRS matrix is
+ * (0, 0, 0, 1), so it takes 48 multiplies per matrix instead of 64.
+ *
+ * @param [*dest] Takes a pointer to n mat4x4.
+ * @param [*m] Takes a pointer to the mat4x4 on the left, not in dest.
+ * @param [*t] Takes a pointer to n translations.
+ * @param [*r] Takes a pointer to n unit quaternions.
+ * @param [*s] Takes a pointer to n scales.
+ * @param [n] Takes the number of matrices.
+ */
+extern void mat4x4_from_trs_mult_array(mat4x4 *dest, const mat4x4 *m, const vec3 *t, const quat *r, const vec3 *s, size_t n);
+
+/**
+ * @brief Same as mat4x4_from_trs_array without the last row, 48 bytes per matrix.
+ *
+ * @param [*dest] Takes a pointer to n mat4x3.
+ * @param [*t] Takes a pointer to n translations.
+ * @param [*r] Takes a pointer to n unit quaternions.
+ * @param [*s] Takes a pointer to n scales.
+ * @param [n] Takes the number of matrices.
+ */
+extern void mat4x3_from_trs_array(mat4x3 *dest, const vec3 *t, const quat *r, const vec3 *s, size_t n);
+
+/** @}*/
+
+#endif // TRANSFORM_H
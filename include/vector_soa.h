@@ -0,0 +1,266 @@
+#ifndef VECTOR_SOA_H
+#define VECTOR_SOA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "math_types.h"
+#include "types.h"
+
+/** @defgroup vec_soa_ Contains all of the structure of arrays vector operations/functions.
+ *
+ * vec3_soa and vec4_soa keep every component in its own array, so one
+ * SIMD register holds the same component of 4, 8 or 16 vectors and all
+ * lanes run the same operation. The bulk operations are the vec3_/vec4_
+ * functions applied to every vector and go through the dispatched kernels
+ * (see dispatch.h).
+ *
+ * The operations with two structures work on the count of the first one,
+ * the second one must hold at least as many vectors.
+ *
+ * @note Only available in the archive build, not with SMATH_HEADER_ONLY.
+ * @{
+ */
+
+
+/**
+ * @brief Allocate a structure of arrays for count 3D vectors.
+ *
+ * The capacity is rounded up to SMATH_SOA_WIDTH and all arrays are zeroed.
+ *
+ * @param [*soa] Takes a pointer to the vec3_soa to initialize.
+ * @param [count] Takes the number of vectors.
+ * @return [bool] Returns false if the allocation failed.
+ */
+extern bool vec3_soa_create(vec3_soa *soa, size_t count);
+
+/**
+ * @brief Free the arrays of a vec3_soa created with vec3_soa_create.
+ *
+ * @param [*soa] Takes a pointer to a vec3_soa.
+ */
+extern void vec3_soa_destroy(vec3_soa *soa);
+
+/**
+ * @brief Copy an array of 3D vectors into a structure of arrays.
+ *
+ * @param [*dest] Takes a pointer to a vec3_soa with a capacity of at least n.
+ * @param [*src] Takes a pointer to n vec3.
+ * @param [n] Takes the number of vectors, it becomes the count of dest.
+ */
+extern void vec3_soa_from_aos(vec3_soa *dest, const vec3 *src, size_t n);
+
+/**
+ * @brief Copy a structure of arrays back into an array of 3D vectors.
+ *
+ * @param [*dest] Takes a pointer to src->count vec3.
+ * @param [*src] Takes a pointer to a vec3_soa.
+ */
+extern void vec3_soa_to_aos(vec3 *dest, const vec3_soa *src);
+
+/**
+ * @brief Add the 3D vectors of the second structure to the first one.
+ *
+ * @param [*v] Takes a pointer to a vec3_soa.
+ * @param [*v1] Takes a pointer to a vec3_soa.
+ * @note The first input will be modified.
+ */
+extern void vec3_soa_add(vec3_soa *v, const vec3_soa *v1);
+
+/**
+ * @brief Subtract the 3D vectors of the second structure from the first one.
+ *
+ * @param [*v] Takes a pointer to a vec3_soa.
+ * @param [*v1] Takes a pointer to a vec3_soa.
+ * @note The first input will be modified.
+ */
+extern void vec3_soa_sub(vec3_soa *v, const vec3_soa *v1);
+
+/**
+ * @brief Scalar multiplication with all 3D vectors.
+ *
+ * @param [*v] Takes a pointer to a vec3_soa.
+ * @param [s] Takes a float/f32 value.
+ * @note The first input will be modified.
+ */
+extern void vec3_soa_scalar_mult(vec3_soa *v, const f32 s);
+
+/**
+ * @brief Calculate the magnitude of every 3D vector.
+ *
+ * @param [*v] Takes a pointer to a vec3_soa.
+ * @param [*out] Takes a pointer to v->count floats for the magnitudes.
+ */
+extern void vec3_soa_magnitude(const vec3_soa *v, f32 *out);
+
+/**
+ * @brief Normalize every 3D vector.
+ *
+ * @param [*v] Takes a pointer to a vec3_soa.
+ * @note The first input will be modified.
+ */
+extern void vec3_soa_normalize(vec3_soa *v);
+
+/**
+ * @brief Approximately normalize every 3D vector (fast_math.h).
+ *
+ * Multiplies with the reciprocal square root estimate refined with one
+ * Newton-Raphson step instead of dividing by the square root, the
+ * magnitudes are within SMATH_FAST_NORMALIZE_ERROR of 1.
+ *
+ * @param [*v] Takes a pointer to a vec3_soa.
+ * @note The first input will be modified.
+ */
+extern void vec3_soa_fast_normalize(vec3_soa *v);
+
+/**
+ * @brief Create the dot product of every pair of 3D vectors.
+ *
+ * @param [*v] Takes a pointer to a vec3_soa.
+ * @param [*v1] Takes a pointer to a vec3_soa.
+ * @param [*out] Takes a pointer to v->count floats for the dot products.
+ */
+extern void vec3_soa_dot(const vec3_soa *v, const vec3_soa *v1, f32 *out);
+
+/**
+ * @brief Create the cross product of every pair of 3D vectors.
+ *
+ * @param [*dest] Takes a pointer to a vec3_soa with a capacity of at least v->count, can be v or v1.
+ * @param [*v] Takes a pointer to a vec3_soa.
+ * @param [*v1] Takes a pointer to a vec3_soa.
+ */
+extern void vec3_soa_cross_product(vec3_soa *dest, const vec3_soa *v, const vec3_soa *v1);
+
+
+/**
+ * @brief Allocate a structure of arrays for count 4D vectors.
+ *
+ * The capacity is rounded up to SMATH_SOA_WIDTH and all arrays are zeroed.
+ *
+ * @param [*soa] Takes a pointer to the vec4_soa to initialize.
+ * @param [count] Takes the number of vectors.
+ * @return [bool] Returns false if the allocation failed.
+ */
+extern bool vec4_soa_create(vec4_soa *soa, size_t count);
+
+/**
+ * @brief Free the arrays of a vec4_soa created with vec4_soa_create.
+ *
+ * @param [*soa] Takes a pointer to a vec4_soa.
+ */
+extern void vec4_soa_destroy(vec4_soa *soa);
+
+/**
+ * @brief Copy an array of 4D vectors into a structure of arrays.
+ *
+ * @param [*dest] Takes a pointer to a vec4_soa with a capacity of at least n.
+ * @param [*src] Takes a pointer to n vec4.
+ * @param [n] Takes the number of vectors, it becomes the count of dest.
+ */
+extern void vec4_soa_from_aos(vec4_soa *dest, const vec4 *src, size_t n);
+
+/**
+ * @brief Copy a structure of arrays back into an array of 4D vectors.
+ *
+ * @param [*dest] Takes a pointer to src->count vec4.
+ * @param [*src] Takes a pointer to a vec4_soa.
+ */
+extern void vec4_soa_to_aos(vec4 *dest, const vec4_soa *src);
+
+/**
+ * @brief Add the 4D vectors of the second structure to the first one.
+ *
+ * @param [*v] Takes a pointer to a vec4_soa.
+ * @param [*v1] Takes a pointer to a vec4_soa.
+ * @note The first input will be modified.
+ */
+extern void vec4_soa_add(vec4_soa *v, const vec4_soa *v1);
+
+/**
+ * @brief Subtract the 4D vectors of the second structure from the first one.
+ *
+ * @param [*v] Takes a pointer to a vec4_soa.
+ * @param [*v1] Takes a pointer to a vec4_soa.
+ * @note The first input will be modified.
+ */
+extern void vec4_soa_sub(vec4_soa *v, const vec4_soa *v1);
+
+/**
+ * @brief Scalar multiplication with all 4D vectors.
+ *
+ * @param [*v] Takes a pointer to a vec4_soa.
+ * @param [s] Takes a float/f32 value.
+ * @note The first input will be modified.
+ */
+extern void vec4_soa_scalar_mult(vec4_soa *v, const f32 s);
+
+/**
+ * @brief Calculate the magnitude of every 4D vector.
+ *
+ * @param [*v] Takes a pointer to a vec4_soa.
+ * @param [*out] Takes a pointer to v->count floats for the magnitudes.
+ */
+extern void vec4_soa_magnitude(const vec4_soa *v, f32 *out);
+
+/**
+ * @brief Normalize every 4D vector.
+ *
+ * @param [*v] Takes a pointer to a vec4_soa.
+ * @note The first input will be modified.
+ */
+extern void vec4_soa_normalize(vec4_soa *v);
+
+/**
+ * @brief Approximately normalize every 4D vector (fast_math.h).
+ *
+ * Multiplies with the reciprocal square root estimate refined with one
+ * Newton-Raphson step instead of dividing by the square root, the
+ * magnitudes are within SMATH_FAST_NORMALIZE_ERROR of 1.
+ *
+ * @param [*v] Takes a pointer to a vec4_soa.
+ * @note The first input will be modified.
+ */
+extern void vec4_soa_fast_normalize(vec4_soa *v);
+
+/**
+ * @brief Create the dot product of every pair of 4D vectors.
+ *
+ * @param [*v] Takes a pointer to a vec4_soa.
+ * @param [*v1] Takes a pointer to a vec4_soa.
+ * @param [*out] Takes a pointer to v->count floats for the dot products.
+ */
+extern void vec4_soa_dot(const vec4_soa *v, const vec4_soa *v1, f32 *out);
+
+
+/**
+ * @brief Blend every pair of quaternions (quat.h) with quat_nlerp.
+ *
+ * dest[i] = nlerp(q0[i], q1[i], t[i]), for blending the keyframes of
+ * many animation channels at once.
+ *
+ * @param [*dest] Takes a pointer to a vec4_soa with a capacity of at least q0->count.
+ * @param [*q0] Takes a pointer to a vec4_soa of unit quaternions.
+ * @param [*q1] Takes a pointer to a vec4_soa of unit quaternions.
+ * @param [*t] Takes a pointer to q0->count blend factors in [0, 1].
+ * @note dest may be q0 or q1, dest->count is set to q0->count.
+ */
+extern void quat_soa_nlerp(vec4_soa *dest, const vec4_soa *q0, const vec4_soa *q1, const f32 *t);
+
+/**
+ * @brief Blend every pair of quaternions (quat.h) with a constant angular speed.
+ *
+ * Uses a polynomial approximation of the slerp weights instead of acos
+ * and sin, so it has no branches and vectorizes. The result differs from
+ * quat_slerp by less than 5e-5 per component, and is not normalized again.
+ *
+ * @param [*dest] Takes a pointer to a vec4_soa with a capacity of at least q0->count.
+ * @param [*q0] Takes a pointer to a vec4_soa of unit quaternions.
+ * @param [*q1] Takes a pointer to a vec4_soa of unit quaternions.
+ * @param [*t] Takes a pointer to q0->count blend factors in [0, 1].
+ * @note dest may be q0 or q1, dest->count is set to q0->count.
+ */
+extern void quat_soa_slerp(vec4_soa *dest, const vec4_soa *q0, const vec4_soa *q1, const f32 *t);
+
+/** @}*/
+
+#endif // VECTOR_SOA_H
@@ -0,0 +1,420 @@
+#ifndef VECTOR_VALUE_H
+#define VECTOR_VALUE_H
+
+#include <stddef.h>
+
+#include "../include/math_types.h"
+#include "../include/smath_config.h"
+#include "../include/mat4x4.h"
+
+/** @defgroup value_ Value versions of the vec3, vec4 and mat4x4 functions.
+ *
+ * The functions in vector3.h, vector4.h and mat4x4.h take pointers and
+ * write through them, so the compiler has to assume they alias and keeps
+ * storing and reloading the vectors between calls. These take and return
+ * vec4v/mat4x4v (math_types.h) by value. A vec4v is an __m128 with SSE and
+ * is passed in a register, on Windows through SMATH_VECTORCALL. A mat4x4v
+ * is only kept in registers when the call is inlined, which is why its
+ * functions are static inline in every build.
+ *
+ * Load a vec4/vec3/mat4x4 once with the _loadv functions, chain the
+ * operations and store the result once with the _storev functions.
+ *
+ * The _array functions are the batch versions, their pointers are
+ * SMATH_RESTRICT, so the arrays must not overlap.
+ * @{
+ */
+
+
+/**
+ * @brief Load a 4D vector into a register.
+ *
+ * @param [*v] Takes a pointer to a vec4.
+ * @return [vec4v] Returns the vector.
+ */
+SMATH_API vec4v SMATH_VECTORCALL vec4_loadv(const vec4 *v);
+
+/**
+ * @brief Store a register into a 4D vector.
+ *
+ * @param [*dest] Takes a pointer to a vec4.
+ * @param [v] Takes a vec4v.
+ */
+SMATH_API void SMATH_VECTORCALL vec4_storev(vec4 *dest, vec4v v);
+
+/**
+ * @brief Create a 4D vector from its components.
+ *
+ * @return [vec4v] Returns (x, y, z, w).
+ */
+SMATH_API vec4v SMATH_VECTORCALL vec4_setv(f32 x, f32 y, f32 z, f32 w);
+
+/**
+ * @brief Create a 4D vector with the same value in all components.
+ *
+ * @param [s] Takes a float/f32 value.
+ * @return [vec4v] Returns (s, s, s, s).
+ */
+SMATH_API vec4v SMATH_VECTORCALL vec4_splatv(f32 s);
+
+/**
+ * @brief Add two 4D vectors.
+ *
+ * @param [a] Takes a vec4v.
+ * @param [b] Takes a vec4v.
+ * @return [vec4v] Returns a + b.
+ */
+SMATH_API vec4v SMATH_VECTORCALL vec4_addv(vec4v a, vec4v b);
+
+/**
+ * @brief Subtract a 4D vector from another one.
+ *
+ * @param [a] Takes a vec4v.
+ * @param [b] Takes a vec4v.
+ * @return [vec4v] Returns a - b.
+ */
+SMATH_API vec4v SMATH_VECTORCALL vec4_subv(vec4v a, vec4v b);
+
+/**
+ * @brief Multiply two 4D vectors component by component.
+ *
+ * @param [a] Takes a vec4v.
+ * @param [b] Takes a vec4v.
+ * @return [vec4v] Returns (a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w).
+ */
+SMATH_API vec4v SMATH_VECTORCALL vec4_mulv(vec4v a, vec4v b);
+
+/**
+ * @brief Scalar multiplication with a 4D vector.
+ *
+ * @param [v] Takes a vec4v.
+ * @param [s] Takes a float/f32 value.
+ * @return [vec4v] Returns v * s.
+ */
+SMATH_API vec4v SMATH_VECTORCALL vec4_scalar_multv(vec4v v, f32 s);
+
+/**
+ * @brief Scalar division with a 4D vector.
+ *
+ * @param [v] Takes a vec4v.
+ * @param [s] Takes a float/f32 value.
+ * @return [vec4v] Returns v / s.
+ */
+SMATH_API vec4v SMATH_VECTORCALL vec4_scalar_divv(vec4v v, f32 s);
+
+/**
+ * @brief Square root of every component of a 4D vector.
+ *
+ * @param [v] Takes a vec4v.
+ * @return [vec4v] Returns the square roots.
+ */
+SMATH_API vec4v SMATH_VECTORCALL vec4_square_rootv(vec4v v);
+
+/**
+ * @brief Dot product of two 4D vectors.
+ *
+ * @param [a] Takes a vec4v.
+ * @param [b] Takes a vec4v.
+ * @return [f32] Returns the dot product.
+ */
+SMATH_API f32 SMATH_VECTORCALL vec4_dotv(vec4v a, vec4v b);
+
+/**
+ * @brief Magnitude of a 4D vector.
+ *
+ * @param [v] Takes a vec4v.
+ * @return [f32] Returns the magnitude.
+ */
+SMATH_API f32 SMATH_VECTORCALL vec4_magnitudev(vec4v v);
+
+/**
+ * @brief Normalize a 4D vector.
+ *
+ * @param [v] Takes a vec4v.
+ * @return [vec4v] Returns v with a magnitude of 1.
+ */
+SMATH_API vec4v SMATH_VECTORCALL vec4_normalizev(vec4v v);
+
+
+/**
+ * @brief Load a 3D vector into a register, w is 0.
+ *
+ * vec4_addv, vec4_subv, vec4_scalar_multv and the other component wise
+ * functions keep w at 0, so they work for 3D vectors as well.
+ *
+ * @param [*v] Takes a pointer to a vec3.
+ * @return [vec4v] Returns (x, y, z, 0).
+ */
+SMATH_API vec4v SMATH_VECTORCALL vec3_loadv(const vec3 *v);
+
+/**
+ * @brief Store x, y, z of a register into a 3D vector.
+ *
+ * @param [*dest] Takes a pointer to a vec3.
+ * @param [v] Takes a vec4v.
+ */
+SMATH_API void SMATH_VECTORCALL vec3_storev(vec3 *dest, vec4v v);
+
+/**
+ * @brief Dot product of x, y, z of two vectors.
+ *
+ * @param [a] Takes a vec4v.
+ * @param [b] Takes a vec4v.
+ * @return [f32] Returns the dot product.
+ */
+SMATH_API f32 SMATH_VECTORCALL vec3_dotv(vec4v a, vec4v b);
+
+/**
+ * @brief Cross product of x, y, z of two vectors.
+ *
+ * @param [a] Takes a vec4v.
+ * @param [b] Takes a vec4v.
+ * @return [vec4v] Returns a x b, w is 0.
+ */
+SMATH_API vec4v SMATH_VECTORCALL vec3_cross_productv(vec4v a, vec4v b);
+
+/**
+ * @brief Magnitude of x, y, z of a vector.
+ *
+ * @param [v] Takes a vec4v.
+ * @return [f32] Returns the magnitude.
+ */
+SMATH_API f32 SMATH_VECTORCALL vec3_magnitudev(vec4v v);
+
+/**
+ * @brief Normalize x, y, z of a vector.
+ *
+ * @param [v] Takes a vec4v with w = 0.
+ * @return [vec4v] Returns v with a magnitude of 1.
+ */
+SMATH_API vec4v SMATH_VECTORCALL vec3_normalizev(vec4v v);
+
+
+/*
+ * The mat4x4v functions are static inline in every build, not only with
+ * SMATH_HEADER_ONLY. A mat4x4v is 64 bytes, more than the System V ABI
+ * passes in registers, so an out of line call would store and reload all
+ * 4 rows of every argument and of the result. Their definitions are at
+ * the end of this headerfile.
+ */
+
+/**
+ * @brief Load a 4x4 matrix into 4 registers.
+ *
+ * @param [*m] Takes a pointer to a mat4x4.
+ * @return [mat4x4v] Returns the matrix.
+ */
+static inline mat4x4v SMATH_VECTORCALL mat4x4_loadv(const mat4x4 *m);
+
+/**
+ * @brief Store 4 registers into a 4x4 matrix.
+ *
+ * @param [*dest] Takes a pointer to a mat4x4.
+ * @param [m] Takes a mat4x4v.
+ */
+static inline void SMATH_VECTORCALL mat4x4_storev(mat4x4 *dest, mat4x4v m);
+
+/**
+ * @brief Multiply two 4x4 matrices.
+ *
+ * @param [m0] Takes a mat4x4v.
+ * @param [m1] Takes a mat4x4v.
+ * @return [mat4x4v] Returns m0 * m1, same as mat4x4_mult.
+ */
+static inline mat4x4v SMATH_VECTORCALL mat4x4_multv(mat4x4v m0, mat4x4v m1);
+
+/**
+ * @brief Multiply a 4x4 matrix with a 4D vector.
+ *
+ * @param [m] Takes a mat4x4v.
+ * @param [v] Takes a vec4v.
+ * @return [vec4v] Returns m * v, same as mat4x4_vec4_mult.
+ */
+static inline vec4v SMATH_VECTORCALL mat4x4_vec4_multv(mat4x4v m, vec4v v);
+
+/**
+ * @brief Transpose a 4x4 matrix.
+ *
+ * @param [m] Takes a mat4x4v.
+ * @return [mat4x4v] Returns the transposed matrix.
+ */
+static inline mat4x4v SMATH_VECTORCALL mat4x4_transposev(mat4x4v m);
+
+
+/**
+ * @brief Add two arrays of 4D vectors.
+ *
+ * @param [*dest] Takes a pointer to n vec4.
+ * @param [*a] Takes a pointer to n vec4.
+ * @param [*b] Takes a pointer to n vec4.
+ * @param [n] Takes the number of vectors.
+ * @note The arrays must not overlap.
+ */
+SMATH_API void vec4_add_array(vec4 *SMATH_RESTRICT dest, const vec4 *SMATH_RESTRICT a, const vec4 *SMATH_RESTRICT b, size_t n);
+
+/**
+ * @brief Subtract two arrays of 4D vectors.
+ *
+ * @param [*dest] Takes a pointer to n vec4.
+ * @param [*a] Takes a pointer to n vec4.
+ * @param [*b] Takes a pointer to n vec4.
+ * @param [n] Takes the number of vectors.
+ * @note The arrays must not overlap.
+ */
+SMATH_API void vec4_sub_array(vec4 *SMATH_RESTRICT dest, const vec4 *SMATH_RESTRICT a, const vec4 *SMATH_RESTRICT b, size_t n);
+
+/**
+ * @brief Multiply an array of 4D vectors with a scalar.
+ *
+ * @param [*dest] Takes a pointer to n vec4.
+ * @param [*a] Takes a pointer to n vec4.
+ * @param [s] Takes a float/f32 value.
+ * @param [n] Takes the number of vectors.
+ * @note The arrays must not overlap.
+ */
+SMATH_API void vec4_scalar_mult_array(vec4 *SMATH_RESTRICT dest, const vec4 *SMATH_RESTRICT a, f32 s, size_t n);
+
+/**
+ * @brief Dot products of two arrays of 4D vectors.
+ *
+ * @param [*dest] Takes a pointer to n floats.
+ * @param [*a] Takes a pointer to n vec4.
+ * @param [*b] Takes a pointer to n vec4.
+ * @param [n] Takes the number of vectors.
+ * @note The arrays must not overlap.
+ */
+SMATH_API void vec4_dot_array(f32 *SMATH_RESTRICT dest, const vec4 *SMATH_RESTRICT a, const vec4 *SMATH_RESTRICT b, size_t n);
+
+/** @}*/
+
+
+/* The definitions of the mat4x4v functions, inlined in every build. */
+
+#ifdef SMATH_SSE
+
+/** @brief Load the 4 rows of a 4x4 matrix. */
+static inline mat4x4v SMATH_VECTORCALL mat4x4_loadv(const mat4x4 *m) {
+        mat4x4v r;
+
+        r.t[0] = _mm_load_ps(m->t[0]);
+        r.t[1] = _mm_load_ps(m->t[1]);
+        r.t[2] = _mm_load_ps(m->t[2]);
+        r.t[3] = _mm_load_ps(m->t[3]);
+
+        return r;
+}
+
+/** @brief Store the 4 rows of a 4x4 matrix. */
+static inline void SMATH_VECTORCALL mat4x4_storev(mat4x4 *dest, mat4x4v m) {
+        _mm_store_ps(dest->t[0], m.t[0]);
+        _mm_store_ps(dest->t[1], m.t[1]);
+        _mm_store_ps(dest->t[2], m.t[2]);
+        _mm_store_ps(dest->t[3], m.t[3]);
+}
+
+/** @brief Multiply two 4x4 matrices, row n is the rows of m1 weighted by row n of m0. */
+static inline mat4x4v SMATH_VECTORCALL mat4x4_multv(mat4x4v m0, mat4x4v m1) {
+        mat4x4v r;
+
+        for (int i = 0; i < 4; ++i) {
+                __m128 a = m0.t[i];
+                __m128 row = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), m1.t[0]);
+                row = _mm_add_ps(row, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), m1.t[1]));
+                row = _mm_add_ps(row, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), m1.t[2]));
+                row = _mm_add_ps(row, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), m1.t[3]));
+                r.t[i] = row;
+        }
+
+        return r;
+}
+
+/** @brief Multiply a 4x4 matrix with a 4D vector, the 4 row products are transposed and summed. */
+static inline vec4v SMATH_VECTORCALL mat4x4_vec4_multv(mat4x4v m, vec4v v) {
+        __m128 p0 = _mm_mul_ps(m.t[0], v);
+        __m128 p1 = _mm_mul_ps(m.t[1], v);
+        __m128 p2 = _mm_mul_ps(m.t[2], v);
+        __m128 p3 = _mm_mul_ps(m.t[3], v);
+
+        _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+
+        return _mm_add_ps(_mm_add_ps(p0, p1), _mm_add_ps(p2, p3));
+}
+
+/** @brief Transpose a 4x4 matrix. */
+static inline mat4x4v SMATH_VECTORCALL mat4x4_transposev(mat4x4v m) {
+        _MM_TRANSPOSE4_PS(m.t[0], m.t[1], m.t[2], m.t[3]);
+        return m;
+}
+
+#else
+
+/** @brief Load the 4 rows of a 4x4 matrix. */
+static inline mat4x4v SMATH_VECTORCALL mat4x4_loadv(const mat4x4 *m) {
+        mat4x4v r;
+
+        for (int i = 0; i < 4; ++i) {
+                r.t[i].x = m->t[i][0];
+                r.t[i].y = m->t[i][1];
+                r.t[i].z = m->t[i][2];
+                r.t[i].w = m->t[i][3];
+        }
+
+        return r;
+}
+
+/** @brief Store the 4 rows of a 4x4 matrix. */
+static inline void SMATH_VECTORCALL mat4x4_storev(mat4x4 *dest, mat4x4v m) {
+        for (int i = 0; i < 4; ++i) {
+                dest->t[i][0] = m.t[i].x;
+                dest->t[i][1] = m.t[i].y;
+                dest->t[i][2] = m.t[i].z;
+                dest->t[i][3] = m.t[i].w;
+        }
+}
+
+/** @brief Multiply two 4x4 matrices, row n is the rows of m1 weighted by row n of m0. */
+static inline mat4x4v SMATH_VECTORCALL mat4x4_multv(mat4x4v m0, mat4x4v m1) {
+        mat4x4v r;
+
+        for (int i = 0; i < 4; ++i) {
+                vec4v a = m0.t[i];
+                r.t[i].x = a.x * m1.t[0].x + a.y * m1.t[1].x + a.z * m1.t[2].x + a.w * m1.t[3].x;
+                r.t[i].y = a.x * m1.t[0].y + a.y * m1.t[1].y + a.z * m1.t[2].y + a.w * m1.t[3].y;
+                r.t[i].z = a.x * m1.t[0].z + a.y * m1.t[1].z + a.z * m1.t[2].z + a.w * m1.t[3].z;
+                r.t[i].w = a.x * m1.t[0].w + a.y * m1.t[1].w + a.z * m1.t[2].w + a.w * m1.t[3].w;
+        }
+
+        return r;
+}
+
+/** @brief Multiply a 4x4 matrix with a 4D vector, a dot product per row. */
+static inline vec4v SMATH_VECTORCALL mat4x4_vec4_multv(mat4x4v m, vec4v v) {
+        vec4v r;
+
+        r.x = m.t[0].x * v.x + m.t[0].y * v.y + m.t[0].z * v.z + m.t[0].w * v.w;
+        r.y = m.t[1].x * v.x + m.t[1].y * v.y + m.t[1].z * v.z + m.t[1].w * v.w;
+        r.z = m.t[2].x * v.x + m.t[2].y * v.y + m.t[2].z * v.z + m.t[2].w * v.w;
+        r.w = m.t[3].x * v.x + m.t[3].y * v.y + m.t[3].z * v.z + m.t[3].w * v.w;
+
+        return r;
+}
+
+/** @brief Transpose a 4x4 matrix. */
+static inline mat4x4v SMATH_VECTORCALL mat4x4_transposev(mat4x4v m) {
+        mat4x4v r = {{
+                {m.t[0].x, m.t[1].x, m.t[2].x, m.t[3].x},
+                {m.t[0].y, m.t[1].y, m.t[2].y, m.t[3].y},
+                {m.t[0].z, m.t[1].z, m.t[2].z, m.t[3].z},
+                {m.t[0].w, m.t[1].w, m.t[2].w, m.t[3].w},
+        }};
+
+        return r;
+}
+
+#endif // SMATH_SSE
+
+#ifdef SMATH_HEADER_ONLY
+#include "../src/vector_value.c"
+#endif
+
+#endif // VECTOR_VALUE_H
@@ -1,12 +1,78 @@
-cd .
-x86_64-w64-mingw32-gcc -O3 -msse2 -c src/vector2.c -o obj/vector2.obj
-ar rcs libs/libvector2.lib obj/vector2.obj
-
-x86_64-w64-mingw32-gcc -O3 -msse2 -c src/vector3.c -o obj/vector3.obj
-ar rcs libs/libvector3.lib obj/vector3.obj
-
-x86_64-w64-mingw32-gcc -O3 -msse2 -c src/vector4.c -o obj/vector4.obj
-ar rcs libs/libvector4.lib obj/vector4.obj
-
-x86_64-w64-mingw32-gcc -O3 -msse2 -c src/mat4x4.c -o obj/mat4x4.obj
-ar rcs libs/libmat4x4.lib obj/mat4x4.obj
\ No newline at end of file
+cd .
+if not exist obj mkdir obj
+if not exist libs mkdir libs
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/vector2.c -o obj/vector2.obj
+ar rcs libs/libvector2.lib obj/vector2.obj
+
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/vector3.c -o obj/vector3.obj
+ar rcs libs/libvector3.lib obj/vector3.obj
+
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/vector4.c -o obj/vector4.obj
+ar rcs libs/libvector4.lib obj/vector4.obj
+
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/mat4x4.c -o obj/mat4x4.obj
+ar rcs libs/libmat4x4.lib obj/mat4x4.obj
+
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/dvector.c -o obj/dvector.obj
+ar rcs libs/libdvector.lib obj/dvector.obj
+
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/dmat4x4.c -o obj/dmat4x4.obj
+ar rcs libs/libdmat4x4.lib obj/dmat4x4.obj
+
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/mat2x2.c -o obj/mat2x2.obj
+ar rcs libs/libmat2x2.lib obj/mat2x2.obj
+
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/mat2x3.c -o obj/mat2x3.obj
+ar rcs libs/libmat2x3.lib obj/mat2x3.obj
+
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/mat2x4.c -o obj/mat2x4.obj
+ar rcs libs/libmat2x4.lib obj/mat2x4.obj
+
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/mat3x2.c -o obj/mat3x2.obj
+ar rcs libs/libmat3x2.lib obj/mat3x2.obj
+
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/mat3x3.c -o obj/mat3x3.obj
+ar rcs libs/libmat3x3.lib obj/mat3x3.obj
+
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/mat3x4.c -o obj/mat3x4.obj
+ar rcs libs/libmat3x4.lib obj/mat3x4.obj
+
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/mat4x2.c -o obj/mat4x2.obj
+ar rcs libs/libmat4x2.lib obj/mat4x2.obj
+
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/mat4x3.c -o obj/mat4x3.obj
+ar rcs libs/libmat4x3.lib obj/mat4x3.obj
+
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/quat.c -o obj/quat.obj
+ar rcs libs/libquat.lib obj/quat.obj
+
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/vector_value.c -o obj/vector_value.obj
+ar rcs libs/libvector_value.lib obj/vector_value.obj
+
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/fast_math.c -o obj/fast_math.obj
+ar rcs libs/libfast_math.lib obj/fast_math.obj
+
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/dispatch.c -o obj/dispatch.obj
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/transform.c -o obj/transform.obj
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/vector_soa.c -o obj/vector_soa.obj
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/transcendental.c -o obj/transcendental.obj
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/culling.c -o obj/culling.obj
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/ray.c -o obj/ray.obj
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/bvh.c -o obj/bvh.obj
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/grid.c -o obj/grid.obj
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/allocator.c -o obj/allocator.obj
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/skinning.c -o obj/skinning.obj
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/compress.c -o obj/compress.obj
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/dtransform.c -o obj/dtransform.obj
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/kernels_scalar.c -o obj/kernels_scalar.obj
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/kernels_sse2.c -o obj/kernels_sse2.obj
+x86_64-w64-mingw32-gcc -O3 -msse4.1 -c src/kernels_sse41.c -o obj/kernels_sse41.obj
+x86_64-w64-mingw32-gcc -O3 -mavx2 -mfma -mf16c -Wa,-muse-unaligned-vector-move -c src/kernels_avx2.c -o obj/kernels_avx2.obj
+x86_64-w64-mingw32-gcc -O3 -mavx512f -mavx2 -mfma -mf16c -Wa,-muse-unaligned-vector-move -c src/kernels_avx512.c -o obj/kernels_avx512.obj
+ar rcs libs/libdispatch.lib obj/dispatch.obj obj/transform.obj obj/vector_soa.obj obj/transcendental.obj obj/culling.obj obj/ray.obj obj/bvh.obj obj/grid.obj obj/allocator.obj obj/skinning.obj obj/compress.obj obj/dtransform.obj obj/kernels_scalar.obj obj/kernels_sse2.obj obj/kernels_sse41.obj obj/kernels_avx2.obj obj/kernels_avx512.obj
+
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/hierarchy.c -o obj/hierarchy.obj
+ar rcs libs/libhierarchy.lib obj/hierarchy.obj
+
+x86_64-w64-mingw32-gcc -O3 -msse2 -c src/parallel.c -o obj/parallel.obj
+ar rcs libs/libparallel.lib obj/parallel.obj
\ No newline at end of file
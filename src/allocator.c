@@ -0,0 +1,344 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/allocator.h"
+#include "../include/dispatch.h"
+#include "../include/transform.h"
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+
+/** @brief Allocate size bytes aligned to SMATH_ALLOC_ALIGNMENT, rounded up to a multiple of it. */
+static void *alloc_aligned(size_t size) {
+        size = size ? (size + SMATH_ALLOC_ALIGNMENT - 1) / SMATH_ALLOC_ALIGNMENT * SMATH_ALLOC_ALIGNMENT
+                    : SMATH_ALLOC_ALIGNMENT;
+#if defined(_WIN32)
+        return _aligned_malloc(size, SMATH_ALLOC_ALIGNMENT);
+#else
+        return aligned_alloc(SMATH_ALLOC_ALIGNMENT, size);
+#endif
+}
+
+/** @brief Free memory from alloc_aligned. */
+static void alloc_free(void *p) {
+#if defined(_WIN32)
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+}
+
+static inline bool alloc_is_pow2(size_t x) {
+        return x && !(x & (x - 1));
+}
+
+
+/** @brief Allocate the block of an arena. */
+bool smath_arena_create(smath_arena *a, size_t size) {
+        memset(a, 0, sizeof(*a));
+
+        if (size > SIZE_MAX - SMATH_ALLOC_ALIGNMENT)
+                return false;
+
+        size = (size + SMATH_ALLOC_ALIGNMENT - 1) / SMATH_ALLOC_ALIGNMENT * SMATH_ALLOC_ALIGNMENT;
+        a->base = alloc_aligned(size);
+
+        if (!a->base)
+                return false;
+
+        a->size = size;
+        a->owned = true;
+        return true;
+}
+
+/** @brief Put an arena over memory of the caller. */
+void smath_arena_init(smath_arena *a, void *memory, size_t size) {
+        memset(a, 0, sizeof(*a));
+        a->base = memory;
+        a->size = size;
+}
+
+/** @brief Free the block of an arena. */
+void smath_arena_destroy(smath_arena *a) {
+        if (a->owned)
+                alloc_free(a->base);
+        memset(a, 0, sizeof(*a));
+}
+
+/**
+ * @brief Bump the offset past the padding to the alignment and the allocation.
+ *
+ * The padding is computed on the address, so memory of smath_arena_init
+ * does not have to be aligned itself. An alignment that is not a power
+ * of 2 fails instead of giving a wrong mask.
+ */
+void *smath_arena_alloc(smath_arena *a, size_t size, size_t alignment) {
+        if (!alignment)
+                alignment = SMATH_ALLOC_ALIGNMENT;
+        if (!alloc_is_pow2(alignment))
+                return NULL;
+
+        uintptr_t address = (uintptr_t)a->base + a->offset;
+        size_t padding = (size_t)(-address & (alignment - 1));
+
+        if (padding > a->size - a->offset || size > a->size - a->offset - padding)
+                return NULL;
+
+        a->offset += padding + size;
+        if (a->offset > a->peak)
+                a->peak = a->offset;
+
+        return a->base + (a->offset - size);
+}
+
+/** @brief Allocate count * size bytes from an arena. */
+void *smath_arena_alloc_array(smath_arena *a, size_t count, size_t size, size_t alignment) {
+        if (size && count > SIZE_MAX / size)
+                return NULL;
+        return smath_arena_alloc(a, count * size, alignment);
+}
+
+/** @brief Get the current offset of an arena. */
+size_t smath_arena_mark(const smath_arena *a) {
+        return a->offset;
+}
+
+/** @brief Drop everything allocated since a mark, a mark above the offset is not one of this arena's. */
+bool smath_arena_rewind(smath_arena *a, size_t mark) {
+        if (mark > a->offset)
+                return false;
+
+        a->offset = mark;
+        return true;
+}
+
+/** @brief Drop everything allocated from an arena. */
+void smath_arena_reset(smath_arena *a) {
+        a->offset = 0;
+}
+
+
+/** @brief Allocate the blocks of a pool, a free block holds the pointer to the next free one. */
+bool smath_block_pool_create(smath_block_pool *p, size_t block_size, size_t capacity) {
+        memset(p, 0, sizeof(*p));
+
+        if (block_size < sizeof(void*))
+                block_size = sizeof(void*);
+        if (block_size > SIZE_MAX - 15)
+                return false;
+
+        block_size = (block_size + 15) / 16 * 16;
+
+        if (capacity && block_size > (SIZE_MAX - SMATH_ALLOC_ALIGNMENT) / capacity)
+                return false;
+
+        p->base = alloc_aligned(block_size * capacity);
+
+        if (!p->base)
+                return false;
+
+        p->block_size = block_size;
+        p->capacity = capacity;
+        return true;
+}
+
+/** @brief Free the blocks of a pool. */
+void smath_block_pool_destroy(smath_block_pool *p) {
+        alloc_free(p->base);
+        memset(p, 0, sizeof(*p));
+}
+
+/** @brief Pop the free list, or take the next block that was never handed out. */
+void *smath_block_pool_alloc(smath_block_pool *p) {
+        void *block = p->free_list;
+
+        if (block) {
+                memcpy(&p->free_list, block, sizeof(void*));
+        } else if (p->fresh < p->capacity) {
+                block = p->base + p->fresh++ * p->block_size;
+        } else {
+                return NULL;
+        }
+
+        ++p->used;
+        return block;
+}
+
+/**
+ * @brief Push a block on the free list.
+ *
+ * Only blocks that were handed out can be in use, so a pointer past
+ * fresh, between two blocks or a free with nothing in use is not pushed.
+ * A block freed twice is not caught, that needs a flag per block.
+ */
+bool smath_block_pool_free(smath_block_pool *p, void *block) {
+        if (!block)
+                return true;
+
+        uintptr_t offset = (uintptr_t)block - (uintptr_t)p->base;
+
+        if ((uintptr_t)block < (uintptr_t)p->base || offset >= p->fresh * p->block_size ||
+            offset % p->block_size != 0 || p->used == 0)
+                return false;
+
+        memcpy(block, &p->free_list, sizeof(void*));
+        p->free_list = block;
+        --p->used;
+        return true;
+}
+
+/** @brief Forget the free list and start over at the first block. */
+void smath_block_pool_reset(smath_block_pool *p) {
+        p->free_list = NULL;
+        p->used = 0;
+        p->fresh = 0;
+}
+
+
+/** @brief Describe an array of the caller. */
+smath_buffer smath_buffer_wrap(void *data, size_t count, size_t stride, size_t alignment) {
+        smath_buffer b = { data, count, stride, alignment };
+        return b;
+}
+
+/** @brief Round the stride up to the alignment, false on overflow. */
+static bool buffer_layout(size_t *stride, size_t *alignment, size_t count, size_t *size) {
+        if (!*alignment)
+                *alignment = SMATH_ALLOC_ALIGNMENT;
+        if (!alloc_is_pow2(*alignment) || *stride > SIZE_MAX - *alignment)
+                return false;
+
+        *stride = (*stride + *alignment - 1) & ~(*alignment - 1);
+
+        if (*stride && count > SIZE_MAX / *stride)
+                return false;
+
+        *size = count * *stride;
+        return true;
+}
+
+/** @brief Allocate a buffer of packed elements, at least SMATH_ALLOC_ALIGNMENT aligned. */
+bool smath_buffer_create(smath_buffer *b, size_t count, size_t stride, size_t alignment) {
+        size_t size;
+
+        memset(b, 0, sizeof(*b));
+
+        if (!buffer_layout(&stride, &alignment, count, &size) || alignment > SMATH_ALLOC_ALIGNMENT ||
+            size > SIZE_MAX - SMATH_ALLOC_ALIGNMENT)
+                return false;
+
+        void *data = alloc_aligned(size);
+
+        if (!data)
+                return false;
+
+        *b = smath_buffer_wrap(data, count, stride, alignment);
+        return true;
+}
+
+/** @brief Allocate a buffer of packed elements from an arena. */
+bool smath_buffer_from_arena(smath_buffer *b, smath_arena *a, size_t count, size_t stride, size_t alignment) {
+        size_t size;
+
+        memset(b, 0, sizeof(*b));
+
+        if (!buffer_layout(&stride, &alignment, count, &size))
+                return false;
+
+        void *data = smath_arena_alloc(a, size, alignment);
+
+        if (!data)
+                return false;
+
+        *b = smath_buffer_wrap(data, count, stride, alignment);
+        return true;
+}
+
+/** @brief Free a buffer of smath_buffer_create. */
+void smath_buffer_destroy(smath_buffer *b) {
+        alloc_free(b->data);
+        memset(b, 0, sizeof(*b));
+}
+
+/**
+ * @brief Check the descriptor first, then the pointer, the stride and the count.
+ *
+ * A stride that is a multiple of an alignment the data has keeps every
+ * element aligned.
+ */
+smath_buffer_status smath_buffer_check(const smath_buffer *b, size_t element_size, size_t alignment, size_t count) {
+        if (!b->data && b->count)
+                return SMATH_BUFFER_NULL;
+        if (!alloc_is_pow2(b->alignment) || b->alignment < alignment)
+                return SMATH_BUFFER_BAD_ALIGNMENT;
+        if ((uintptr_t)b->data & (b->alignment - 1))
+                return SMATH_BUFFER_MISALIGNED;
+        if (b->stride < element_size || b->stride & (b->alignment - 1))
+                return SMATH_BUFFER_BAD_STRIDE;
+        if (b->count < count)
+                return SMATH_BUFFER_TOO_SMALL;
+        return SMATH_BUFFER_OK;
+}
+
+static const char *smath_buffer_status_names[SMATH_BUFFER_STATUS_COUNT] = {
+        "ok", "null", "bad alignment", "misaligned", "bad stride", "too small"
+};
+
+/** @brief Get the name of a buffer status. */
+const char *smath_buffer_status_name(smath_buffer_status status) {
+        return (unsigned)status < SMATH_BUFFER_STATUS_COUNT ? smath_buffer_status_names[status] : "unknown";
+}
+
+
+/** @brief The alignment of mat4x4 and vec4, the same as their SMATH_ALIGN. */
+#define BUFFER_MAT4X4_ALIGNMENT 64
+#define BUFFER_VEC4_ALIGNMENT 16
+
+/** @brief Multiply two buffers of mat4x4 pairwise. */
+smath_buffer_status mat4x4_mult_buffer(smath_buffer *dest, const smath_buffer *m0, const smath_buffer *m1) {
+        size_t n = m0->count;
+        smath_buffer_status status;
+
+        if ((status = smath_buffer_check(m0, sizeof(mat4x4), BUFFER_MAT4X4_ALIGNMENT, 0)) ||
+            (status = smath_buffer_check(m1, sizeof(mat4x4), BUFFER_MAT4X4_ALIGNMENT, n)) ||
+            (status = smath_buffer_check(dest, sizeof(mat4x4), BUFFER_MAT4X4_ALIGNMENT, n)))
+                return status;
+
+        if (m0->stride == sizeof(mat4x4) && m1->stride == sizeof(mat4x4) && dest->stride == sizeof(mat4x4)) {
+                mat4x4_mult_array(dest->data, m0->data, m1->data, n);
+                return SMATH_BUFFER_OK;
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+                const mat4x4 *a = (const mat4x4*)((const u8*)m0->data + i * m0->stride);
+                const mat4x4 *b = (const mat4x4*)((const u8*)m1->data + i * m1->stride);
+                *(mat4x4*)((u8*)dest->data + i * dest->stride) = mat4x4_mult(a, b);
+        }
+
+        return SMATH_BUFFER_OK;
+}
+
+/** @brief Transform a buffer of vec4 with a 4x4 matrix. */
+smath_buffer_status mat4x4_transform_vec4s_buffer(const mat4x4 *m, const smath_buffer *in, smath_buffer *out) {
+        size_t n = in->count;
+        smath_buffer_status status;
+
+        if ((status = smath_buffer_check(in, sizeof(vec4), BUFFER_VEC4_ALIGNMENT, 0)) ||
+            (status = smath_buffer_check(out, sizeof(vec4), BUFFER_VEC4_ALIGNMENT, n)))
+                return status;
+
+        if (in->stride == sizeof(vec4) && out->stride == sizeof(vec4)) {
+                mat4x4_transform_vec4s(m, in->data, out->data, n);
+                return SMATH_BUFFER_OK;
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+                const vec4 *v = (const vec4*)((const u8*)in->data + i * in->stride);
+                *(vec4*)((u8*)out->data + i * out->stride) = mat4x4_vec4_mult(m, v);
+        }
+
+        return SMATH_BUFFER_OK;
+}
@@ -0,0 +1,628 @@
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/bvh.h"
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+
+/** @brief The number of bins of the surface area heuristic on every axis. */
+#define BVH_BINS 16
+
+/** @brief The most objects of a leaf, smaller leaves are made where the heuristic says a split does not pay. */
+#define BVH_LEAF_MAX 8
+
+/**
+ * @brief From this depth on the nodes are split at the median.
+ *
+ * The median halves the slots, so no leaf is deeper than
+ * BVH_SAH_DEPTH + 31 for less than 2^31 objects.
+ */
+#define BVH_SAH_DEPTH 48
+
+/** @brief The stack of the ordered traversals, one entry per level is enough. */
+#define BVH_STACK 96
+
+/** @brief The rays of smath_bvh_intersect_rays that go down the tree together. */
+#define BVH_PACKET 64
+
+
+/** @brief Allocate size bytes aligned to 64, rounded up to a multiple of 64. */
+static void *bvh_alloc(size_t size) {
+        size = size ? (size + 63) / 64 * 64 : 64;
+#if defined(_WIN32)
+        return _aligned_malloc(size, 64);
+#else
+        return aligned_alloc(64, size);
+#endif
+}
+
+/** @brief Free memory from bvh_alloc. */
+static void bvh_free(void *p) {
+#if defined(_WIN32)
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+}
+
+
+/** @brief Like minps, b when either one is NaN. */
+static inline f32 bvh_min(f32 a, f32 b) {
+        return a < b ? a : b;
+}
+
+/** @brief Like maxps, b when either one is NaN. */
+static inline f32 bvh_max(f32 a, f32 b) {
+        return a > b ? a : b;
+}
+
+static inline f32 bvh_axis(const vec3 *v, int axis) {
+        return axis == 0 ? v->x : axis == 1 ? v->y : v->z;
+}
+
+/** @brief The box that contains nothing, the union with it is the other box. */
+static const aabb bvh_empty = { { INFINITY, INFINITY, INFINITY }, { -INFINITY, -INFINITY, -INFINITY } };
+
+static inline aabb bvh_union(const aabb *a, const aabb *b) {
+        aabb c;
+        c.min.x = bvh_min(a->min.x, b->min.x);
+        c.min.y = bvh_min(a->min.y, b->min.y);
+        c.min.z = bvh_min(a->min.z, b->min.z);
+        c.max.x = bvh_max(a->max.x, b->max.x);
+        c.max.y = bvh_max(a->max.y, b->max.y);
+        c.max.z = bvh_max(a->max.z, b->max.z);
+        return c;
+}
+
+/** @brief Half the surface area, the heuristic only compares them. */
+static inline f32 bvh_area(const aabb *b) {
+        f32 dx = b->max.x - b->min.x, dy = b->max.y - b->min.y, dz = b->max.z - b->min.z;
+        return dx * dy + dy * dz + dz * dx;
+}
+
+static inline bool bvh_overlap(const aabb *a, const aabb *b) {
+        return a->min.x <= b->max.x && b->min.x <= a->max.x &&
+               a->min.y <= b->max.y && b->min.y <= a->max.y &&
+               a->min.z <= b->max.z && b->min.z <= a->max.z;
+}
+
+/** @brief The slab test of ray_intersect_aabb with the inverse direction, INFINITY when it misses or is not closer than t_max. */
+static inline f32 bvh_slab(const aabb *b, const vec3 *o, const vec3 *inv, f32 t_max) {
+        f32 x0 = (b->min.x - o->x) * inv->x, x1 = (b->max.x - o->x) * inv->x;
+        f32 y0 = (b->min.y - o->y) * inv->y, y1 = (b->max.y - o->y) * inv->y;
+        f32 z0 = (b->min.z - o->z) * inv->z, z1 = (b->max.z - o->z) * inv->z;
+
+        f32 t_near = bvh_max(bvh_max(bvh_min(x0, x1), bvh_min(y0, y1)), bvh_max(bvh_min(z0, z1), 0.0f));
+        f32 t_far = bvh_min(bvh_min(bvh_max(x0, x1), bvh_max(y0, y1)), bvh_max(z0, z1));
+
+        return t_far < t_near || !(t_near < t_max) ? INFINITY : t_near;
+}
+
+/** @brief The squared distance of a point to a box, 0 inside. */
+static inline f32 bvh_distance_sq(const aabb *b, const vec3 *p) {
+        f32 dx = bvh_max(bvh_max(b->min.x - p->x, p->x - b->max.x), 0.0f);
+        f32 dy = bvh_max(bvh_max(b->min.y - p->y, p->y - b->max.y), 0.0f);
+        f32 dz = bvh_max(bvh_max(b->min.z - p->z, p->z - b->max.z), 0.0f);
+        return dx * dx + dy * dy + dz * dz;
+}
+
+
+/** @brief The state of a build, the boxes and centroids are moved with the slots so they are read in order. */
+typedef struct bvh_builder {
+        smath_bvh *bvh;
+        vec3 *centroid;
+} bvh_builder;
+
+static inline void bvh_swap(bvh_builder *b, size_t i, size_t j) {
+        u32 o = b->bvh->objects[i];
+        b->bvh->objects[i] = b->bvh->objects[j];
+        b->bvh->objects[j] = o;
+
+        aabb box = b->bvh->boxes[i];
+        b->bvh->boxes[i] = b->bvh->boxes[j];
+        b->bvh->boxes[j] = box;
+
+        vec3 c = b->centroid[i];
+        b->centroid[i] = b->centroid[j];
+        b->centroid[j] = c;
+}
+
+/** @brief The bins of a node, fewer for small nodes where the sweeps would cost more than the binning. */
+static inline int bvh_bins(size_t count) {
+        return count < BVH_BINS ? (int)count : BVH_BINS;
+}
+
+/** @brief The bin of a centroid, clamped before the conversion for the upper end, infinities and NaN. */
+static inline int bvh_bin(f32 c, f32 lo, f32 scale, int bins) {
+        f32 k = (c - lo) * scale;
+        return k > 0.0f ? k < (f32)bins ? (int)k : bins - 1 : 0;
+}
+
+/**
+ * @brief Bin the centroids on every axis in one pass and find the cheapest split.
+ *
+ * A split between the bins k - 1 and k costs area * count of both sides,
+ * the sides are swept once from each end. An axis the centroids do not
+ * extend along has all of them in bin 0 and no split.
+ *
+ * @return [f32] Returns the cost of the best split, INFINITY if every side would be empty.
+ */
+static f32 bvh_sah(const bvh_builder *b, size_t first, size_t count, const aabb *cbox, int *axis, int *split) {
+        aabb box[3][BVH_BINS];
+        size_t n[3][BVH_BINS] = { { 0 } };
+        f32 lo[3], scale[3];
+        int bins = bvh_bins(count);
+
+        for (int a = 0; a < 3; ++a) {
+                f32 extent = bvh_axis(&cbox->max, a) - bvh_axis(&cbox->min, a);
+
+                lo[a] = bvh_axis(&cbox->min, a);
+                scale[a] = extent > 0.0f ? (f32)bins / extent : 0.0f;
+
+                for (int k = 0; k < bins; ++k)
+                        box[a][k] = bvh_empty;
+        }
+
+        for (size_t i = first; i < first + count; ++i) {
+                const aabb *object = &b->bvh->boxes[i];
+
+                for (int a = 0; a < 3; ++a) {
+                        int k = bvh_bin(bvh_axis(&b->centroid[i], a), lo[a], scale[a], bins);
+                        box[a][k] = bvh_union(&box[a][k], object);
+                        ++n[a][k];
+                }
+        }
+
+        f32 best = INFINITY;
+
+        for (int a = 0; a < 3; ++a) {
+                f32 right_area[BVH_BINS];
+                size_t right_count[BVH_BINS];
+                aabb acc = bvh_empty;
+                size_t m = 0;
+
+                for (int k = bins - 1; k > 0; --k) {
+                        acc = bvh_union(&acc, &box[a][k]);
+                        m += n[a][k];
+                        right_area[k] = bvh_area(&acc);
+                        right_count[k] = m;
+                }
+
+                acc = bvh_empty;
+                m = 0;
+
+                for (int k = 1; k < bins; ++k) {
+                        acc = bvh_union(&acc, &box[a][k - 1]);
+                        m += n[a][k - 1];
+
+                        if (m == 0 || right_count[k] == 0)
+                                continue;
+
+                        f32 cost = bvh_area(&acc) * (f32)m + right_area[k] * (f32)right_count[k];
+
+                        if (cost < best) {
+                                best = cost;
+                                *axis = a;
+                                *split = k;
+                        }
+                }
+        }
+
+        return best;
+}
+
+/** @brief Move the slot with the centroid of rank k on the axis to k, the lower ones before it (Hoare's selection). */
+static void bvh_select(bvh_builder *b, size_t first, size_t end, size_t k, int axis) {
+        ptrdiff_t l = (ptrdiff_t)first, r = (ptrdiff_t)end - 1, kk = (ptrdiff_t)k;
+
+        while (l < r) {
+                f32 pivot = bvh_axis(&b->centroid[kk], axis);
+                ptrdiff_t i = l, j = r;
+
+                do {
+                        while (bvh_axis(&b->centroid[i], axis) < pivot)
+                                ++i;
+                        while (pivot < bvh_axis(&b->centroid[j], axis))
+                                --j;
+                        if (i <= j) {
+                                bvh_swap(b, (size_t)i, (size_t)j);
+                                ++i;
+                                --j;
+                        }
+                } while (i <= j);
+
+                if (j < kk)
+                        l = i;
+                if (kk < i)
+                        r = j;
+        }
+}
+
+/**
+ * @brief Build the subtree of the slots [first, first + count) depth first.
+ *
+ * The node is written before its children, its skip once they are done.
+ * A split is made where the heuristic with a traversal as expensive as one
+ * object test says it pays, or when there are too many objects for a leaf.
+ * Without a usable split, e.g. when all centroids are the same, the slots
+ * are split at the median.
+ */
+static void bvh_build(bvh_builder *b, size_t first, size_t count, int depth) {
+        smath_bvh *bvh = b->bvh;
+        size_t index = bvh->node_count++;
+        aabb box = bvh_empty, cbox = bvh_empty;
+
+        for (size_t i = first; i < first + count; ++i) {
+                box = bvh_union(&box, &bvh->boxes[i]);
+                aabb c = { b->centroid[i], b->centroid[i] };
+                cbox = bvh_union(&cbox, &c);
+        }
+
+        aabb_node *node = &bvh->nodes[index];
+        node->box = box;
+
+        int axis = 0, split = 0;
+        f32 extent = cbox.max.x - cbox.min.x;
+
+        if (cbox.max.y - cbox.min.y > extent) {
+                axis = 1;
+                extent = cbox.max.y - cbox.min.y;
+        }
+        if (cbox.max.z - cbox.min.z > extent) {
+                axis = 2;
+                extent = cbox.max.z - cbox.min.z;
+        }
+
+        bool leaf = count == 1;
+        size_t mid = first + count / 2;
+
+        if (!leaf && depth < BVH_SAH_DEPTH) {
+                f32 area = bvh_area(&box);
+                f32 cost = bvh_sah(b, first, count, &cbox, &axis, &split);
+
+                if (count <= BVH_LEAF_MAX && !(area + cost < area * (f32)count)) {
+                        leaf = true;
+                } else if (cost < INFINITY) {
+                        f32 lo = bvh_axis(&cbox.min, axis);
+                        int bins = bvh_bins(count);
+                        f32 scale = (f32)bins / (bvh_axis(&cbox.max, axis) - lo);
+                        size_t i = first, j = first + count;
+
+                        while (i < j) {
+                                if (bvh_bin(bvh_axis(&b->centroid[i], axis), lo, scale, bins) < split)
+                                        ++i;
+                                else
+                                        bvh_swap(b, i, --j);
+                        }
+
+                        mid = i;
+                        split = 1;
+                } else {
+                        split = 0;
+                }
+        }
+
+        if (leaf) {
+                node->skip = (u32)(index + 1);
+                node->first = (u32)first;
+                node->count = (u32)count;
+                return;
+        }
+
+        if (!split)
+                bvh_select(b, first, first + count, mid, axis);
+
+        node->first = 0;
+        node->count = 0;
+
+        bvh_build(b, first, mid - first, depth + 1);
+        bvh_build(b, mid, first + count - mid, depth + 1);
+
+        bvh->nodes[index].skip = (u32)bvh->node_count;
+}
+
+
+/** @brief Build a hierarchy over boxes. */
+bool smath_bvh_create(smath_bvh *bvh, const aabb *boxes, size_t count) {
+        memset(bvh, 0, sizeof(*bvh));
+
+        if (count >= (size_t)1 << 31)
+                return false;
+
+        // Every inner node has two children and every leaf at least one object.
+        size_t max_nodes = count ? 2 * count - 1 : 0;
+
+        bvh->nodes = bvh_alloc(max_nodes * sizeof(aabb_node));
+        bvh->boxes = bvh_alloc(count * sizeof(aabb));
+        bvh->objects = bvh_alloc(count * sizeof(u32));
+        vec3 *centroid = malloc(count ? count * sizeof(vec3) : 1);
+
+        if (!bvh->nodes || !bvh->boxes || !bvh->objects || !centroid) {
+                free(centroid);
+                smath_bvh_destroy(bvh);
+                return false;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+                bvh->objects[i] = (u32)i;
+                bvh->boxes[i] = boxes[i];
+                centroid[i].x = 0.5f * (boxes[i].min.x + boxes[i].max.x);
+                centroid[i].y = 0.5f * (boxes[i].min.y + boxes[i].max.y);
+                centroid[i].z = 0.5f * (boxes[i].min.z + boxes[i].max.z);
+        }
+
+        if (count) {
+                bvh_builder b = { bvh, centroid };
+                bvh_build(&b, 0, count, 0);
+        }
+
+        bvh->count = count;
+        free(centroid);
+
+        return true;
+}
+
+/** @brief Free the arrays of a hierarchy. */
+void smath_bvh_destroy(smath_bvh *bvh) {
+        bvh_free(bvh->nodes);
+        bvh_free(bvh->boxes);
+        bvh_free(bvh->objects);
+        memset(bvh, 0, sizeof(*bvh));
+}
+
+/** @brief The children come after their parent, so one back to front pass sees them first. */
+void smath_bvh_refit(smath_bvh *bvh, const aabb *boxes) {
+        for (size_t i = 0; i < bvh->count; ++i)
+                bvh->boxes[i] = boxes[bvh->objects[i]];
+
+        for (size_t i = bvh->node_count; i-- > 0;) {
+                aabb_node *node = &bvh->nodes[i];
+
+                if (node->count) {
+                        aabb box = bvh_empty;
+                        for (size_t j = node->first; j < (size_t)node->first + node->count; ++j)
+                                box = bvh_union(&box, &bvh->boxes[j]);
+                        node->box = box;
+                } else {
+                        const aabb_node *left = &bvh->nodes[i + 1];
+                        node->box = bvh_union(&left->box, &bvh->nodes[left->skip].box);
+                }
+        }
+}
+
+
+/**
+ * @brief Nearest child first, the farther one goes on the stack with its entry distance.
+ *
+ * A popped node is dropped when a hit closer than its entry was found in
+ * the meantime.
+ */
+bool smath_bvh_intersect_ray(const smath_bvh *bvh, const ray *r, f32 t_max,
+                             smath_bvh_ray_fn fn, void *user, f32 *t, u32 *object) {
+        if (bvh->node_count == 0)
+                return false;
+
+        vec3 inv = { 1.0f / r->direction.x, 1.0f / r->direction.y, 1.0f / r->direction.z };
+        u32 stack[BVH_STACK];
+        f32 stack_t[BVH_STACK];
+        int top = 0;
+
+        f32 best = t_max;
+        bool hit = false;
+        u32 i = 0;
+
+        if (!(bvh_slab(&bvh->nodes[0].box, &r->origin, &inv, best) < best))
+                return false;
+
+        for (;;) {
+                const aabb_node *node = &bvh->nodes[i];
+
+                if (node->count) {
+                        for (u32 j = node->first; j < node->first + node->count; ++j) {
+                                f32 d = bvh_slab(&bvh->boxes[j], &r->origin, &inv, best);
+
+                                if (!(d < best) || (fn && !fn(user, bvh->objects[j], r, best, &d)))
+                                        continue;
+
+                                best = d;
+                                *object = bvh->objects[j];
+                                hit = true;
+                        }
+                } else {
+                        u32 a = i + 1, b = bvh->nodes[a].skip;
+                        f32 ta = bvh_slab(&bvh->nodes[a].box, &r->origin, &inv, best);
+                        f32 tb = bvh_slab(&bvh->nodes[b].box, &r->origin, &inv, best);
+
+                        if (tb < ta) {
+                                u32 s = a;
+                                f32 ts = ta;
+                                a = b;
+                                ta = tb;
+                                b = s;
+                                tb = ts;
+                        }
+
+                        if (ta < best) {
+                                if (tb < best) {
+                                        assert(top < BVH_STACK);
+                                        stack[top] = b;
+                                        stack_t[top++] = tb;
+                                }
+                                i = a;
+                                continue;
+                        }
+                }
+
+                while (top > 0 && !(stack_t[top - 1] < best))
+                        --top;
+                if (top == 0)
+                        break;
+                i = stack[--top];
+        }
+
+        if (hit)
+                *t = best;
+        return hit;
+}
+
+/**
+ * @brief Walk the tree once per packet, skipping the subtrees no ray of the packet hits.
+ *
+ * The packet is a view into the arrays of r, so the SoA kernel reads the
+ * padding of the rays after it, never past the capacity. The t of a ray
+ * shrinks with every hit and the next boxes are tested against it.
+ */
+void smath_bvh_intersect_rays(const smath_bvh *bvh, const ray_soa *r,
+                              smath_bvh_ray_fn fn, void *user, f32 *t, u32 *object) {
+        size_t count = r->origin.count;
+
+        for (size_t k = 0; k < count; ++k)
+                object[k] = SMATH_BVH_NONE;
+
+        for (size_t c = 0; c < count; c += BVH_PACKET) {
+                size_t n = count - c < BVH_PACKET ? count - c : BVH_PACKET;
+                const vec3_soa *o = &r->origin, *d = &r->direction;
+                ray_soa packet = {
+                        { o->x + c, o->y + c, o->z + c, n, o->capacity - c },
+                        { d->x + c, d->y + c, d->z + c, n, d->capacity - c }
+                };
+                size_t i = 0;
+
+                while (i < bvh->node_count) {
+                        const aabb_node *node = &bvh->nodes[i];
+                        u32 hits[BVH_PACKET / 32] = { 0 };
+
+                        ray_soa_intersect_aabb(&packet, &node->box, t + c, NULL, hits);
+
+                        if (!(hits[0] | hits[1])) {
+                                i = node->skip;
+                                continue;
+                        }
+
+                        for (size_t w = 0; node->count && w < BVH_PACKET / 32; ++w) {
+                                for (u32 bits = hits[w]; bits; bits &= bits - 1) {
+                                        size_t k = c + w * 32;
+                                        for (u32 m = bits; !(m & 1); m >>= 1)
+                                                ++k;
+
+                                        ray rk = { { o->x[k], o->y[k], o->z[k] }, { d->x[k], d->y[k], d->z[k] } };
+                                        vec3 inv = { 1.0f / rk.direction.x, 1.0f / rk.direction.y, 1.0f / rk.direction.z };
+
+                                        for (u32 j = node->first; j < node->first + node->count; ++j) {
+                                                f32 dist = bvh_slab(&bvh->boxes[j], &rk.origin, &inv, t[k]);
+
+                                                if (!(dist < t[k]) || (fn && !fn(user, bvh->objects[j], &rk, t[k], &dist)))
+                                                        continue;
+
+                                                t[k] = dist;
+                                                object[k] = bvh->objects[j];
+                                        }
+                                }
+                        }
+
+                        ++i;
+                }
+        }
+}
+
+/** @brief Walk the tree front to back, a subtree whose box does not overlap is skipped. */
+size_t smath_bvh_query_aabb(const smath_bvh *bvh, const aabb *box, u32 *out, size_t max) {
+        size_t found = 0;
+        size_t i = 0;
+
+        while (i < bvh->node_count) {
+                const aabb_node *node = &bvh->nodes[i];
+
+                if (!bvh_overlap(&node->box, box)) {
+                        i = node->skip;
+                        continue;
+                }
+
+                for (u32 j = node->first; j < node->first + node->count; ++j) {
+                        if (bvh_overlap(&bvh->boxes[j], box)) {
+                                if (found < max)
+                                        out[found] = bvh->objects[j];
+                                ++found;
+                        }
+                }
+
+                ++i;
+        }
+
+        return found;
+}
+
+/** @brief Nearest box first like smath_bvh_intersect_ray, with the squared distance to the boxes. */
+bool smath_bvh_nearest(const smath_bvh *bvh, const vec3 *p, f32 max_dist_sq,
+                       smath_bvh_distance_fn fn, void *user, f32 *dist_sq, u32 *object) {
+        if (bvh->node_count == 0)
+                return false;
+
+        u32 stack[BVH_STACK];
+        f32 stack_d[BVH_STACK];
+        int top = 0;
+
+        f32 best = max_dist_sq;
+        bool found = false;
+        u32 i = 0;
+
+        if (!(bvh_distance_sq(&bvh->nodes[0].box, p) < best))
+                return false;
+
+        for (;;) {
+                const aabb_node *node = &bvh->nodes[i];
+
+                if (node->count) {
+                        for (u32 j = node->first; j < node->first + node->count; ++j) {
+                                f32 d = bvh_distance_sq(&bvh->boxes[j], p);
+
+                                if (!(d < best))
+                                        continue;
+                                if (fn && !((d = fn(user, bvh->objects[j], p)) < best))
+                                        continue;
+
+                                best = d;
+                                *object = bvh->objects[j];
+                                found = true;
+                        }
+                } else {
+                        u32 a = i + 1, b = bvh->nodes[a].skip;
+                        f32 da = bvh_distance_sq(&bvh->nodes[a].box, p);
+                        f32 db = bvh_distance_sq(&bvh->nodes[b].box, p);
+
+                        if (db < da) {
+                                u32 s = a;
+                                f32 ds = da;
+                                a = b;
+                                da = db;
+                                b = s;
+                                db = ds;
+                        }
+
+                        if (da < best) {
+                                if (db < best) {
+                                        assert(top < BVH_STACK);
+                                        stack[top] = b;
+                                        stack_d[top++] = db;
+                                }
+                                i = a;
+                                continue;
+                        }
+                }
+
+                while (top > 0 && !(stack_d[top - 1] < best))
+                        --top;
+                if (top == 0)
+                        break;
+                i = stack[--top];
+        }
+
+        if (found)
+                *dist_sq = best;
+        return found;
+}
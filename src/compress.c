@@ -0,0 +1,269 @@
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#include "../include/compress.h"
+#include "../include/dispatch.h"
+
+
+/*
+ * The same operations as the kernels of kernels_pack.h, one lane wide,
+ * so a single element packs to the same bits as the batch functions.
+ */
+
+static inline u32 f32_bits(f32 f) {
+        u32 u;
+        memcpy(&u, &f, sizeof(u));
+        return u;
+}
+
+static inline f32 f32_from_bits(u32 u) {
+        f32 f;
+        memcpy(&f, &u, sizeof(f));
+        return f;
+}
+
+/** @brief round(clamp(f, -1, 1) * s), NaN becomes -s. */
+static inline i32 pack_snorm(f32 f, f32 s) {
+        f = f > -1.0f ? f : -1.0f;
+        f = f < 1.0f ? f : 1.0f;
+        return (i32)lrintf(f * s);
+}
+
+/** @brief round(clamp(f, 0, 1) * s), NaN becomes 0. */
+static inline i32 pack_unorm(f32 f, f32 s) {
+        f = f > 0.0f ? f : 0.0f;
+        f = f < 1.0f ? f : 1.0f;
+        return (i32)lrintf(f * s);
+}
+
+/** @brief max(i / s, -1). */
+static inline f32 unpack_snorm(i32 i, f32 s) {
+        f32 f = (f32)i * (1.0f / s);
+        return f > -1.0f ? f : -1.0f;
+}
+
+/** @brief The signed field of bits at shift, sign extended. */
+static inline i32 signed_field(u32 p, int bits, int shift) {
+        return (i32)(p << (32 - bits - shift)) >> (32 - bits);
+}
+
+
+/** @brief F. Giesen's float_to_half_fast3_rtne. */
+u16 f32_to_f16(f32 f) {
+        u32 u = f32_bits(f);
+        u32 sign = u & 0x80000000u;
+        u32 a = u ^ sign;
+        u32 h;
+
+        if (a >= (u32)(127 + 16) << 23) {
+                // Infinity, NaN stays a quiet NaN.
+                h = a > 0x7F800000u ? 0x7E00u : 0x7C00u;
+        } else if (a < (u32)113 << 23) {
+                f32 magic = f32_from_bits((u32)((127 - 15) + (23 - 10) + 1) << 23);
+                h = f32_bits(f32_from_bits(a) + magic) - f32_bits(magic);
+        } else {
+                u32 odd = (a >> 13) & 1;
+                h = (a + ((u32)-(112 << 23) + 0xFFF) + odd) >> 13;
+        }
+
+        return (u16)(h | (sign >> 16));
+}
+
+/** @brief F. Giesen's half_to_float_fast, subnormals are scaled with a float subtraction. */
+f32 f16_to_f32(u16 h) {
+        u32 o = (u32)(h & 0x7FFF) << 13;
+        u32 e = o & (0x7C00u << 13);
+        f32 f;
+
+        o += (u32)(127 - 15) << 23;
+        if (e == 0x7C00u << 13)
+                f = f32_from_bits(o + ((u32)(128 - 16) << 23));
+        else if (e == 0)
+                f = f32_from_bits(o + (1u << 23)) - f32_from_bits((u32)113 << 23);
+        else
+                f = f32_from_bits(o);
+
+        return f32_from_bits(f32_bits(f) | ((u32)(h & 0x8000) << 16));
+}
+
+/** @brief Quantize with round(clamp(f, -1, 1) * 32767). */
+i16 f32_to_snorm16(f32 f) {
+        return (i16)pack_snorm(f, 32767.0f);
+}
+
+/** @brief Expand with max(s / 32767, -1). */
+f32 snorm16_to_f32(i16 s) {
+        return unpack_snorm(s, 32767.0f);
+}
+
+/** @brief Quantize with round(clamp(f, 0, 1) * 65535). */
+u16 f32_to_unorm16(f32 f) {
+        return (u16)pack_unorm(f, 65535.0f);
+}
+
+/** @brief Expand with u / 65535. */
+f32 unorm16_to_f32(u16 u) {
+        return (f32)u * (1.0f / 65535.0f);
+}
+
+/** @brief Quantize with round(clamp(f, -1, 1) * 127). */
+i8 f32_to_snorm8(f32 f) {
+        return (i8)pack_snorm(f, 127.0f);
+}
+
+/** @brief Expand with max(s / 127, -1). */
+f32 snorm8_to_f32(i8 s) {
+        return unpack_snorm(s, 127.0f);
+}
+
+/** @brief Quantize with round(clamp(f, 0, 1) * 255). */
+u8 f32_to_unorm8(f32 f) {
+        return (u8)pack_unorm(f, 255.0f);
+}
+
+/** @brief Expand with u / 255. */
+f32 unorm8_to_f32(u8 u) {
+        return (f32)u * (1.0f / 255.0f);
+}
+
+
+/** @brief x, y, z as snorm10 and w as snorm2. */
+u32 vec4_pack_10_10_10_2(const vec4 *v) {
+        u32 p = (u32)pack_snorm(v->x, 511.0f) & 0x3FF;
+        p |= ((u32)pack_snorm(v->y, 511.0f) & 0x3FF) << 10;
+        p |= ((u32)pack_snorm(v->z, 511.0f) & 0x3FF) << 20;
+        return p | (u32)pack_snorm(v->w, 1.0f) << 30;
+}
+
+/** @brief Sign extend every field and expand it. */
+vec4 vec4_unpack_10_10_10_2(u32 p) {
+        vec4 v;
+        v.x = unpack_snorm(signed_field(p, 10, 0), 511.0f);
+        v.y = unpack_snorm(signed_field(p, 10, 10), 511.0f);
+        v.z = unpack_snorm(signed_field(p, 10, 20), 511.0f);
+        v.w = unpack_snorm((i32)p >> 30, 1.0f);
+        return v;
+}
+
+
+/** @brief Project on the octahedron, fold the lower half with (1 - |v|, 1 - |u|) and the signs of (u, v). */
+u32 vec3_encode_octahedral(const vec3 *v) {
+        f32 l = fabsf(v->x) + fabsf(v->y) + fabsf(v->z);
+        f32 s = 1.0f / (l > 1e-30f ? l : 1e-30f);
+        f32 u = v->x * s;
+        f32 w = v->y * s;
+
+        if (v->z < 0.0f) {
+                f32 fu = (1.0f - fabsf(w)) * copysignf(1.0f, u);
+                f32 fw = (1.0f - fabsf(u)) * copysignf(1.0f, w);
+                u = fu;
+                w = fw;
+        }
+
+        return ((u32)pack_snorm(u, 32767.0f) & 0xFFFF) | (u32)pack_snorm(w, 32767.0f) << 16;
+}
+
+/** @brief z = 1 - |u| - |v|, the folded half (z < 0) moves x and y back by -z towards the axes. */
+vec3 vec3_decode_octahedral(u32 p) {
+        f32 u = unpack_snorm(signed_field(p, 16, 0), 32767.0f);
+        f32 w = unpack_snorm((i32)p >> 16, 32767.0f);
+        f32 z = 1.0f - fabsf(u) - fabsf(w);
+        f32 t = -z > 0.0f ? -z : 0.0f;
+        f32 x = u - copysignf(1.0f, u) * t;
+        f32 y = w - copysignf(1.0f, w) * t;
+        f32 l = 1.0f / sqrtf(x * x + y * y + z * z);
+
+        vec3 r = { x * l, y * l, z * l };
+        return r;
+}
+
+
+/** @brief Leave out the largest component (the first one on a tie) and scale the others by its sign. */
+u32 quat_pack_smallest3(const quat *q) {
+        f32 c[4] = { q->x, q->y, q->z, q->w };
+        int k = 0;
+
+        for (int i = 1; i < 4; ++i) {
+                if (fabsf(c[k]) < fabsf(c[i]))
+                        k = i;
+        }
+
+        f32 s = copysignf(1.0f, c[k]) * (1.0f / SMATH_SMALLEST3_MAX);
+        u32 p = (u32)k << 30;
+        int shift = 0;
+
+        for (int i = 0; i < 4; ++i) {
+                if (i == k)
+                        continue;
+                p |= ((u32)pack_snorm(c[i] * s, 511.0f) & 0x3FF) << shift;
+                shift += 10;
+        }
+
+        return p;
+}
+
+/** @brief The left out component is sqrt(1 - a^2 - b^2 - c^2), put back at its index. */
+quat quat_unpack_smallest3(u32 p) {
+        f32 a = unpack_snorm(signed_field(p, 10, 0), 511.0f) * SMATH_SMALLEST3_MAX;
+        f32 b = unpack_snorm(signed_field(p, 10, 10), 511.0f) * SMATH_SMALLEST3_MAX;
+        f32 c = unpack_snorm(signed_field(p, 10, 20), 511.0f) * SMATH_SMALLEST3_MAX;
+        f32 d = 1.0f - a * a - b * b - c * c;
+        d = sqrtf(d > 0.0f ? d : 0.0f);
+
+        quat q;
+        switch (p >> 30) {
+        case 0: q.x = d; q.y = a; q.z = b; q.w = c; break;
+        case 1: q.x = a; q.y = d; q.z = b; q.w = c; break;
+        case 2: q.x = a; q.y = b; q.z = d; q.w = c; break;
+        default: q.x = a; q.y = b; q.z = c; q.w = d; break;
+        }
+        return q;
+}
+
+
+/** @brief Pack with the dispatched kernel. */
+void smath_pack_array(void *dest, const f32 *src, size_t n, smath_pack_format fmt) {
+        smath_get_kernels()->pack_array(dest, src, n, fmt);
+}
+
+/** @brief Unpack with the dispatched kernel. */
+void smath_unpack_array(f32 *dest, const void *src, size_t n, smath_pack_format fmt) {
+        smath_get_kernels()->unpack_array(dest, src, n, fmt);
+}
+
+/** @brief Pack with the dispatched kernel. */
+void vec4_soa_pack_10_10_10_2(u32 *dest, const vec4_soa *v) {
+        smath_get_kernels()->vec4_soa_pack_10_10_10_2(dest, v);
+}
+
+/** @brief Unpack with the dispatched kernel. */
+void vec4_soa_unpack_10_10_10_2(vec4_soa *dest, const u32 *src, size_t n) {
+        assert(n <= dest->capacity);
+        smath_get_kernels()->vec4_soa_unpack_10_10_10_2(dest, src, n);
+        dest->count = n;
+}
+
+/** @brief Encode with the dispatched kernel. */
+void vec3_soa_encode_octahedral(u32 *dest, const vec3_soa *v) {
+        smath_get_kernels()->vec3_soa_encode_octahedral(dest, v);
+}
+
+/** @brief Decode with the dispatched kernel. */
+void vec3_soa_decode_octahedral(vec3_soa *dest, const u32 *src, size_t n) {
+        assert(n <= dest->capacity);
+        smath_get_kernels()->vec3_soa_decode_octahedral(dest, src, n);
+        dest->count = n;
+}
+
+/** @brief Pack with the dispatched kernel. */
+void quat_soa_pack_smallest3(u32 *dest, const vec4_soa *q) {
+        smath_get_kernels()->quat_soa_pack_smallest3(dest, q);
+}
+
+/** @brief Unpack with the dispatched kernel. */
+void quat_soa_unpack_smallest3(vec4_soa *dest, const u32 *src, size_t n) {
+        assert(n <= dest->capacity);
+        smath_get_kernels()->quat_soa_unpack_smallest3(dest, src, n);
+        dest->count = n;
+}
@@ -0,0 +1,205 @@
+#include <math.h>
+
+#include "../include/culling.h"
+#include "../include/dispatch.h"
+
+
+/** @brief Row a + s * row b of a matrix as a plane. */
+static plane frustum_row_plane(const mat4x4 *m, int a, int b, f32 s) {
+        plane p;
+        p.x = m->t[a][0] + s * m->t[b][0];
+        p.y = m->t[a][1] + s * m->t[b][1];
+        p.z = m->t[a][2] + s * m->t[b][2];
+        p.w = m->t[a][3] + s * m->t[b][3];
+        return p;
+}
+
+/**
+ * @brief Extract the frustum planes of a view-projection matrix (Gribb and Hartmann).
+ *
+ * A point is inside when -w <= x <= w and so on, with w = row 3 * p every
+ * inequality is the plane (row 3 +- row n) * p >= 0. The near plane of a
+ * 0 to 1 depth range is row 2 alone.
+ */
+void frustum_from_mat4x4(frustum *f, const mat4x4 *m, smath_clip_depth depth) {
+        f->p[FRUSTUM_LEFT] = frustum_row_plane(m, 3, 0, 1.0f);
+        f->p[FRUSTUM_RIGHT] = frustum_row_plane(m, 3, 0, -1.0f);
+        f->p[FRUSTUM_BOTTOM] = frustum_row_plane(m, 3, 1, 1.0f);
+        f->p[FRUSTUM_TOP] = frustum_row_plane(m, 3, 1, -1.0f);
+        f->p[FRUSTUM_NEAR] = depth == SMATH_CLIP_DEPTH_ZERO_TO_ONE ?
+                             frustum_row_plane(m, 2, 0, 0.0f) : frustum_row_plane(m, 3, 2, 1.0f);
+        f->p[FRUSTUM_FAR] = frustum_row_plane(m, 3, 2, -1.0f);
+
+        for (int i = 0; i < 6; ++i)
+                plane_normalize(&f->p[i]);
+}
+
+/** @brief Divide the plane by the length of its normal. */
+void plane_normalize(plane *p) {
+        f32 l = sqrtf(p->x * p->x + p->y * p->y + p->z * p->z);
+
+        if (l > 0.0f) {
+                f32 s = 1.0f / l;
+                p->x *= s;
+                p->y *= s;
+                p->z *= s;
+                p->w *= s;
+        }
+}
+
+/** @brief dot(normal, v) + w. */
+f32 plane_distance(const plane *p, const vec3 *v) {
+        return p->x * v->x + p->y * v->y + p->z * v->z + p->w;
+}
+
+/** @brief The sphere is outside when it is completely behind one plane. */
+bool frustum_test_sphere(const frustum *f, const sphere *s) {
+        for (int i = 0; i < 6; ++i) {
+                if (plane_distance(&f->p[i], &s->center) < -s->radius)
+                        return false;
+        }
+
+        return true;
+}
+
+/** @brief Distance of the box corner furthest along the normal. */
+static f32 aabb_max_distance(const plane *p, const aabb *b) {
+        f32 x0 = p->x * b->min.x, x1 = p->x * b->max.x;
+        f32 y0 = p->y * b->min.y, y1 = p->y * b->max.y;
+        f32 z0 = p->z * b->min.z, z1 = p->z * b->max.z;
+
+        return p->w + (x0 > x1 ? x0 : x1) + (y0 > y1 ? y0 : y1) + (z0 > z1 ? z0 : z1);
+}
+
+/** @brief The box is outside when its furthest corner is behind one plane. */
+bool frustum_test_aabb(const frustum *f, const aabb *b) {
+        for (int i = 0; i < 6; ++i) {
+                if (aabb_max_distance(&f->p[i], b) < 0.0f)
+                        return false;
+        }
+
+        return true;
+}
+
+/** @brief Test the spheres with the dispatched kernel. */
+void frustum_cull_spheres(const frustum *f, const sphere_soa *s, u32 *visible) {
+        smath_get_kernels()->frustum_cull_spheres(f, s, visible);
+}
+
+/** @brief Test the boxes with the dispatched kernel. */
+void frustum_cull_aabbs(const frustum *f, const aabb_soa *b, u32 *visible) {
+        smath_get_kernels()->frustum_cull_aabbs(f, b, visible);
+}
+
+
+/** @brief Set the bits [first, first + count) of the mask. */
+static void cull_set_bits(u32 *visible, size_t first, size_t count) {
+        size_t end = first + count;
+
+        while (first < end && (first & 31)) {
+                visible[first / 32] |= 1u << (first & 31);
+                ++first;
+        }
+        while (first + 32 <= end) {
+                visible[first / 32] = ~0u;
+                first += 32;
+        }
+        while (first < end) {
+                visible[first / 32] |= 1u << (first & 31);
+                ++first;
+        }
+}
+
+/**
+ * @brief Test a box against the planes in the mask.
+ *
+ * With the center c and half extent e of the box, the box spans
+ * dot(n, c) + w -+ dot(|n|, e) along the normal n.
+ *
+ * @return [int] Returns -1 when the box is outside, otherwise the mask
+ * without the planes the box is completely inside of.
+ */
+static int cull_test_node(const frustum *f, const aabb *b, int planes) {
+        vec3 c = { 0.5f * (b->min.x + b->max.x), 0.5f * (b->min.y + b->max.y), 0.5f * (b->min.z + b->max.z) };
+        vec3 e = { 0.5f * (b->max.x - b->min.x), 0.5f * (b->max.y - b->min.y), 0.5f * (b->max.z - b->min.z) };
+
+        for (int i = 0; i < 6; ++i) {
+                if (!(planes & (1 << i)))
+                        continue;
+
+                const plane *p = &f->p[i];
+                f32 d = plane_distance(p, &c);
+                f32 r = fabsf(p->x) * e.x + fabsf(p->y) * e.y + fabsf(p->z) * e.z;
+
+                if (d + r < 0.0f)
+                        return -1;
+                if (d - r >= 0.0f)
+                        planes &= ~(1 << i);
+        }
+
+        return planes;
+}
+
+/** @brief The deepest subtree whose plane mask is remembered, deeper ones use the mask of their ancestor. */
+#define CULL_TREE_DEPTH 64
+
+/**
+ * @brief Walk the nodes in order, jumping over rejected and accepted subtrees.
+ *
+ * The plane mask of a node is what is left after its ancestors, a stack
+ * keeps the mask of every open subtree with the index where it ends.
+ */
+void frustum_cull_aabb_tree(const frustum *f, const aabb_node *nodes, size_t count,
+                            const aabb_soa *objects, u32 *visible) {
+        size_t end[CULL_TREE_DEPTH];
+        int mask[CULL_TREE_DEPTH];
+        int depth = 0;
+
+        end[0] = count;
+        mask[0] = 0x3F;
+
+        size_t i = 0;
+
+        while (i < count) {
+                while (depth > 0 && i >= end[depth])
+                        --depth;
+
+                const aabb_node *node = &nodes[i];
+                int planes = cull_test_node(f, &node->box, mask[depth]);
+
+                if (planes < 0) {
+                        i = node->skip;
+                        continue;
+                }
+
+                if (planes == 0) {
+                        // Completely inside, every object of the subtree is visible.
+                        for (size_t j = i; j < node->skip; ++j)
+                                cull_set_bits(visible, nodes[j].first, nodes[j].count);
+                        i = node->skip;
+                        continue;
+                }
+
+                if (node->count) {
+                        if (!objects) {
+                                cull_set_bits(visible, node->first, node->count);
+                        } else {
+                                for (size_t j = node->first; j < (size_t)node->first + node->count; ++j) {
+                                        aabb b = {
+                                                { objects->min.x[j], objects->min.y[j], objects->min.z[j] },
+                                                { objects->max.x[j], objects->max.y[j], objects->max.z[j] }
+                                        };
+
+                                        if (cull_test_node(f, &b, planes) >= 0)
+                                                visible[j / 32] |= 1u << (j & 31);
+                                }
+                        }
+                } else if (depth + 1 < CULL_TREE_DEPTH) {
+                        ++depth;
+                        end[depth] = node->skip;
+                        mask[depth] = planes;
+                }
+
+                ++i;
+        }
+}
@@ -0,0 +1,246 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/dispatch.h"
+#include "kernels.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#if !defined(_MSC_VER)
+#include <stdatomic.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define SMATH_X86 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define SMATH_X86 1
+#endif
+
+
+static const char *smath_isa_names[SMATH_ISA_COUNT] = {
+        "scalar", "sse2", "sse41", "avx2", "avx512"
+};
+
+/*
+ * One table per instruction set, all of them bound once on the first use
+ * and only read after that. smath_bound points to one of them and is
+ * published with a release store, a thread that loads it with acquire
+ * sees the table filled in.
+ */
+static smath_kernels smath_tables[SMATH_ISA_COUNT];
+
+#if defined(_MSC_VER)
+
+static void *volatile smath_bound = NULL;
+
+static const smath_kernels *smath_load_bound(void) {
+        return InterlockedCompareExchangePointer(&smath_bound, NULL, NULL);
+}
+
+static void smath_store_bound(const smath_kernels *k) {
+        InterlockedExchangePointer(&smath_bound, (void*)k);
+}
+
+#else
+
+static _Atomic(const smath_kernels*) smath_bound = NULL;
+
+static const smath_kernels *smath_load_bound(void) {
+        return atomic_load_explicit(&smath_bound, memory_order_acquire);
+}
+
+static void smath_store_bound(const smath_kernels *k) {
+        atomic_store_explicit(&smath_bound, k, memory_order_release);
+}
+
+#endif
+
+
+#ifdef SMATH_X86
+
+/** @brief Run cpuid for a leaf/subleaf, regs = eax, ebx, ecx, edx. */
+static void smath_cpuid(u32 leaf, u32 subleaf, u32 regs[4]) {
+#if defined(_MSC_VER)
+        int r[4];
+        __cpuidex(r, (int)leaf, (int)subleaf);
+        regs[0] = (u32)r[0];
+        regs[1] = (u32)r[1];
+        regs[2] = (u32)r[2];
+        regs[3] = (u32)r[3];
+#else
+        __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+/** @brief Read XCR0, the register states the OS saves on a context switch. */
+static u64 smath_xgetbv(void) {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        u32 lo, hi;
+        __asm__ volatile ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        return ((u64)hi << 32) | lo;
+#endif
+}
+
+#endif // SMATH_X86
+
+
+/** @brief Detect the best instruction set supported by the CPU (and OS). */
+smath_isa smath_cpu_isa(void) {
+#ifdef SMATH_X86
+        u32 r[4];
+        smath_cpuid(0, 0, r);
+        u32 max_leaf = r[0];
+
+        smath_cpuid(1, 0, r);
+        u32 ecx1 = r[2];
+        u32 edx1 = r[3];
+
+        if (!(edx1 & (1u << 26)))
+                return SMATH_ISA_SCALAR;
+        if (!(ecx1 & (1u << 19)))
+                return SMATH_ISA_SSE2;
+
+        // AVX needs the OS to save the ymm registers (XCR0 bit 1 and 2).
+        int osxsave = (ecx1 & (1u << 27)) != 0;
+        int avx = (ecx1 & (1u << 28)) != 0;
+        int fma = (ecx1 & (1u << 12)) != 0;
+        int f16c = (ecx1 & (1u << 29)) != 0;
+        u64 xcr0 = osxsave ? smath_xgetbv() : 0;
+
+        if (!avx || !fma || !f16c || (xcr0 & 0x6) != 0x6 || max_leaf < 7)
+                return SMATH_ISA_SSE41;
+
+        smath_cpuid(7, 0, r);
+        u32 ebx7 = r[1];
+
+        if (!(ebx7 & (1u << 5)))
+                return SMATH_ISA_SSE41;
+
+        // AVX-512 also needs the opmask and zmm states (XCR0 bit 5, 6 and 7).
+        if (!(ebx7 & (1u << 16)) || (xcr0 & 0xE6) != 0xE6)
+                return SMATH_ISA_AVX2;
+
+        return SMATH_ISA_AVX512;
+#else
+        return SMATH_ISA_SCALAR;
+#endif
+}
+
+
+/** @brief Bind a table to an instruction set the CPU supports, lowered to what the library was compiled with. */
+static void smath_bind(smath_kernels *k, smath_isa isa) {
+        k->isa = SMATH_ISA_SCALAR;
+        smath_kernels_bind_scalar(k);
+
+        if (isa >= SMATH_ISA_SSE2 && smath_kernels_bind_sse2(k))
+                k->isa = SMATH_ISA_SSE2;
+        if (isa >= SMATH_ISA_SSE41 && smath_kernels_bind_sse41(k))
+                k->isa = SMATH_ISA_SSE41;
+        if (isa >= SMATH_ISA_AVX2 && smath_kernels_bind_avx2(k))
+                k->isa = SMATH_ISA_AVX2;
+        if (isa >= SMATH_ISA_AVX512 && smath_kernels_bind_avx512(k))
+                k->isa = SMATH_ISA_AVX512;
+}
+
+/** @brief Bind every table and select the one of SMATH_ISA, runs once. */
+static void smath_init(void) {
+        smath_isa cpu = smath_cpu_isa();
+
+        for (int i = 0; i < SMATH_ISA_COUNT; ++i)
+                smath_bind(&smath_tables[i], (smath_isa)i < cpu ? (smath_isa)i : cpu);
+
+        smath_isa isa = SMATH_ISA_AVX512;
+        const char *env = getenv("SMATH_ISA");
+
+        if (env) {
+                int found = -1;
+
+                for (int i = 0; i < SMATH_ISA_COUNT; ++i) {
+                        if (strcmp(env, smath_isa_names[i]) == 0)
+                                found = i;
+                }
+
+                if (found < 0)
+                        fprintf(stderr, "smath: unknown SMATH_ISA \"%s\", using %s\n", env,
+                                smath_isa_names[smath_tables[isa].isa]);
+                else
+                        isa = (smath_isa)found;
+        }
+
+        smath_store_bound(&smath_tables[isa]);
+}
+
+#if defined(_WIN32)
+
+static INIT_ONCE smath_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK smath_init_win32(PINIT_ONCE once, PVOID param, PVOID *context) {
+        (void)once;
+        (void)param;
+        (void)context;
+        smath_init();
+        return TRUE;
+}
+
+#define SMATH_ONCE() InitOnceExecuteOnce(&smath_once, smath_init_win32, NULL, NULL)
+
+#else
+
+static pthread_once_t smath_once = PTHREAD_ONCE_INIT;
+
+#define SMATH_ONCE() pthread_once(&smath_once, smath_init)
+
+#endif
+
+
+/** @brief Point to the table of an instruction set, the tables are bound once and never change. */
+smath_isa smath_set_isa(smath_isa isa) {
+        SMATH_ONCE();
+
+        if (isa < SMATH_ISA_SCALAR)
+                isa = SMATH_ISA_SCALAR;
+        if (isa >= SMATH_ISA_COUNT)
+                isa = SMATH_ISA_AVX512;
+
+        smath_store_bound(&smath_tables[isa]);
+        return smath_tables[isa].isa;
+}
+
+
+/** @brief Get the kernel table, the first call binds them (SMATH_ISA can lower the instruction set). */
+const smath_kernels *smath_get_kernels(void) {
+        const smath_kernels *k = smath_load_bound();
+
+        if (k)
+                return k;
+
+        SMATH_ONCE();
+        return smath_load_bound();
+}
+
+
+/** @brief Get the name of an instruction set. */
+const char *smath_isa_name(smath_isa isa) {
+        if (isa < SMATH_ISA_SCALAR || isa >= SMATH_ISA_COUNT)
+                return "unknown";
+        return smath_isa_names[isa];
+}
+
+
+/** @brief Multiply two arrays of 4x4 matrices pairwise with the dispatched kernel. */
+void mat4x4_mult_array(mat4x4 *dest, const mat4x4 *m0, const mat4x4 *m1, size_t n) {
+        smath_get_kernels()->mat4x4_mult_array(dest, m0, m1, n);
+}
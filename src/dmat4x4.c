@@ -0,0 +1,55 @@
+#include "../include/dmat4x4.h"
+#include "../include/types.h"
+#include "../include/math_types.h"
+
+
+#define MT_S f64
+#define MT_M dmat4x4
+#define MT_V4 dvec4
+#define MT_FN(name) dmat4x4_##name
+#define MT_V4_MULT dmat4x4_dvec4_mult
+#include "mat4x4_template.h"
+
+
+/** @brief Convert a 4x4 matrix to double precision. */
+SMATH_INLINE dmat4x4 dmat4x4_from_mat4x4(const mat4x4 *m) {
+        dmat4x4 m1;
+
+        for (int i = 0; i < 4; ++i) {
+                for (int j = 0; j < 4; ++j) {
+                        m1.t[i][j] = m->t[i][j];
+                }
+        }
+
+        return m1;
+}
+
+/** @brief Round a double precision 4x4 matrix to floats. */
+SMATH_INLINE mat4x4 mat4x4_from_dmat4x4(const dmat4x4 *m) {
+        mat4x4 m1;
+
+        for (int i = 0; i < 4; ++i) {
+                for (int j = 0; j < 4; ++j) {
+                        m1.t[i][j] = (f32)m->t[i][j];
+                }
+        }
+
+        return m1;
+}
+
+/** @brief translate(-origin) * m, row i of the top 3 loses origin[i] times the last row. */
+SMATH_INLINE mat4x4 dmat4x4_to_mat4x4_relative(const dmat4x4 *m, const dvec3 *origin) {
+        mat4x4 m1;
+        const f64 o[3] = {origin->x, origin->y, origin->z};
+
+        for (int i = 0; i < 3; ++i) {
+                for (int j = 0; j < 4; ++j) {
+                        m1.t[i][j] = (f32)(m->t[i][j] - o[i] * m->t[3][j]);
+                }
+        }
+        for (int j = 0; j < 4; ++j) {
+                m1.t[3][j] = (f32)m->t[3][j];
+        }
+
+        return m1;
+}
@@ -0,0 +1,20 @@
+#include "../include/dtransform.h"
+#include "../include/dispatch.h"
+
+
+/** @brief Multiply two arrays of double precision matrices with the dispatched kernel. */
+void dmat4x4_mult_array(dmat4x4 *dest, const dmat4x4 *m0, const dmat4x4 *m1, size_t n) {
+        smath_get_kernels()->dmat4x4_mult_array(dest, m0, m1, n);
+}
+
+
+/** @brief Camera relative float matrices with the dispatched kernel. */
+void dmat4x4_to_mat4x4_relative_array(mat4x4 *dest, const dmat4x4 *src, const dvec3 *origin, size_t n) {
+        smath_get_kernels()->dmat4x4_to_mat4x4_relative_array(dest, src, origin, n);
+}
+
+
+/** @brief Camera relative float positions with the dispatched kernel. */
+void dvec3_to_vec3_relative_array(vec3 *dest, const dvec3 *src, const dvec3 *origin, size_t n) {
+        smath_get_kernels()->dvec3_to_vec3_relative_array(dest, src, origin, n);
+}
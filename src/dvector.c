@@ -0,0 +1,75 @@
+#include <math.h>
+
+#include "../include/dvector.h"
+#include "../include/types.h"
+#include "../include/math_types.h"
+
+
+#define VT_S f64
+#define VT_V dvec2
+#define VT_N 2
+#define VT_FN(name) dvec2_##name
+#define VT_SQRT(a) sqrt(a)
+#include "vector_template.h"
+
+#define VT_S f64
+#define VT_V dvec3
+#define VT_N 3
+#define VT_FN(name) dvec3_##name
+#define VT_SQRT(a) sqrt(a)
+#include "vector_template.h"
+
+#define VT_S f64
+#define VT_V dvec4
+#define VT_N 4
+#define VT_FN(name) dvec4_##name
+#define VT_SQRT(a) sqrt(a)
+#include "vector_template.h"
+
+
+/** @brief Convert a 3D vector to double precision. */
+SMATH_INLINE dvec3 dvec3_from_vec3(const vec3 *v) {
+        dvec3 v1;
+        v1.x = v->x;
+        v1.y = v->y;
+        v1.z = v->z;
+        return v1;
+}
+
+/** @brief Round a double precision 3D vector to floats. */
+SMATH_INLINE vec3 vec3_from_dvec3(const dvec3 *v) {
+        vec3 v1;
+        v1.x = (f32)v->x;
+        v1.y = (f32)v->y;
+        v1.z = (f32)v->z;
+        return v1;
+}
+
+/** @brief Subtract the origin in double, then round to floats. */
+SMATH_INLINE vec3 vec3_from_dvec3_relative(const dvec3 *v, const dvec3 *origin) {
+        vec3 v1;
+        v1.x = (f32)(v->x - origin->x);
+        v1.y = (f32)(v->y - origin->y);
+        v1.z = (f32)(v->z - origin->z);
+        return v1;
+}
+
+/** @brief Convert a 4D vector to double precision. */
+SMATH_INLINE dvec4 dvec4_from_vec4(const vec4 *v) {
+        dvec4 v1;
+        v1.x = v->x;
+        v1.y = v->y;
+        v1.z = v->z;
+        v1.w = v->w;
+        return v1;
+}
+
+/** @brief Round a double precision 4D vector to floats. */
+SMATH_INLINE vec4 vec4_from_dvec4(const dvec4 *v) {
+        vec4 v1;
+        v1.x = (f32)v->x;
+        v1.y = (f32)v->y;
+        v1.z = (f32)v->z;
+        v1.w = (f32)v->w;
+        return v1;
+}
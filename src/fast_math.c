@@ -0,0 +1,116 @@
+#include <math.h>
+
+#include "../include/fast_math.h"
+#include "../include/types.h"
+#include "../include/math_types.h"
+
+#include "mat_sse.h"
+
+
+#ifdef SMATH_SSE
+
+/**
+ * @brief 1 / sqrt(x) from _mm_rsqrt_ss and one Newton-Raphson step.
+ *
+ * An estimate of 0 or infinity (x is infinity, 0 or a denormal the
+ * estimate flushed) is already the result, the step would multiply it
+ * with infinity or 0 and give NaN.
+ */
+SMATH_INLINE f32 smath_fast_rsqrt(f32 x) {
+        __m128 a = _mm_set_ss(x);
+        f32 y = _mm_cvtss_f32(_mm_rsqrt_ss(a));
+        return y == 0.0f || isinf(y) ? y : _mm_cvtss_f32(mat_sse_rsqrt_nr(a));
+}
+
+/** @brief 1 / x from _mm_rcp_ss and one Newton-Raphson step, an estimate of 0 or infinity is kept. */
+SMATH_INLINE f32 smath_fast_rcp(f32 x) {
+        __m128 a = _mm_set_ss(x);
+        f32 y = _mm_cvtss_f32(_mm_rcp_ss(a));
+        return y == 0.0f || isinf(y) ? y : _mm_cvtss_f32(mat_sse_rcp_nr(a));
+}
+
+/** @brief Normalize the 3D Vector with the reciprocal square root of the squared magnitude. */
+SMATH_INLINE void vec3_fast_normalize(vec3 *v) {
+        __m128 a = mat_sse_load_vec3(v);
+        mat_sse_store_vec3(v, _mm_mul_ps(a, mat_sse_rsqrt_nr(mat_sse_dot3(a, a))));
+}
+
+/** @brief Normalize the 4D Vector with the reciprocal square root of the squared magnitude. */
+SMATH_INLINE void vec4_fast_normalize(vec4 *v) {
+        __m128 a = _mm_load_ps((const f32*)v);
+        _mm_store_ps((f32*)v, _mm_mul_ps(a, mat_sse_rsqrt_nr(mat_sse_dot4(a, a))));
+}
+
+/** @brief Normalize a 4D vector, value version. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_fast_normalizev(vec4v v) {
+        return _mm_mul_ps(v, mat_sse_rsqrt_nr(mat_sse_dot4(v, v)));
+}
+
+/** @brief Normalize x, y, z, w stays 0, value version. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec3_fast_normalizev(vec4v v) {
+        return _mm_mul_ps(v, mat_sse_rsqrt_nr(mat_sse_dot3(v, v)));
+}
+
+#else
+
+/** @brief 1 / sqrt(x), without SSE there is no estimate to start from. */
+SMATH_INLINE f32 smath_fast_rsqrt(f32 x) {
+        return 1.0f / sqrtf(x);
+}
+
+/** @brief 1 / x. */
+SMATH_INLINE f32 smath_fast_rcp(f32 x) {
+        return 1.0f / x;
+}
+
+/** @brief Normalize the 3D Vector with the reciprocal square root of the squared magnitude. */
+SMATH_INLINE void vec3_fast_normalize(vec3 *v) {
+        f32 s = smath_fast_rsqrt(v->x * v->x + v->y * v->y + v->z * v->z);
+        v->x *= s;
+        v->y *= s;
+        v->z *= s;
+}
+
+/** @brief Normalize the 4D Vector with the reciprocal square root of the squared magnitude. */
+SMATH_INLINE void vec4_fast_normalize(vec4 *v) {
+        f32 s = smath_fast_rsqrt(v->x * v->x + v->y * v->y + v->z * v->z + v->w * v->w);
+        v->x *= s;
+        v->y *= s;
+        v->z *= s;
+        v->w *= s;
+}
+
+/** @brief Normalize a 4D vector, value version. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_fast_normalizev(vec4v v) {
+        vec4_fast_normalize(&v);
+        return v;
+}
+
+/** @brief Normalize x, y, z, w stays 0, value version. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec3_fast_normalizev(vec4v v) {
+        f32 s = smath_fast_rsqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+        v.x *= s;
+        v.y *= s;
+        v.z *= s;
+        return v;
+}
+
+#endif // SMATH_SSE
+
+
+/** @brief Divide the 3D Vector by the scalar, as a multiplication with the approximate 1 / s. */
+SMATH_INLINE void vec3_fast_scalar_div(vec3 *v, f32 s) {
+        s = smath_fast_rcp(s);
+        v->x *= s;
+        v->y *= s;
+        v->z *= s;
+}
+
+/** @brief Divide the 4D Vector by the scalar, as a multiplication with the approximate 1 / s. */
+SMATH_INLINE void vec4_fast_scalar_div(vec4 *v, f32 s) {
+        s = smath_fast_rcp(s);
+        v->x *= s;
+        v->y *= s;
+        v->z *= s;
+        v->w *= s;
+}
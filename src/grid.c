@@ -0,0 +1,262 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/grid.h"
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+
+/** @brief Allocate size bytes aligned to 64, size is a multiple of 64. */
+static void *grid_alloc(size_t size) {
+#if defined(_WIN32)
+        return _aligned_malloc(size, 64);
+#else
+        return aligned_alloc(64, size);
+#endif
+}
+
+/** @brief Free memory from grid_alloc. */
+static void grid_free(void *p) {
+#if defined(_WIN32)
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+}
+
+/** @brief Round a number of 4 byte entries up to a multiple of 64 bytes. */
+#define GRID_PAD(n) (((n) + 15) / 16 * 16)
+
+/** @brief The largest cell coordinate, farther points share the outermost cells. */
+#define GRID_LIMIT 1073741824.0f
+
+
+/**
+ * @brief The cell coordinate of v, floor(v / cell size).
+ *
+ * Clamped before the conversion for huge values, infinities and NaN, the
+ * truncation is then corrected downwards for negative values instead of a
+ * call to floorf, which SSE2 has no instruction for.
+ */
+static inline i32 grid_cell(f32 v, f32 inv_cell_size) {
+        f32 c = v * inv_cell_size;
+        c = c > -GRID_LIMIT ? c < GRID_LIMIT ? c : GRID_LIMIT : -GRID_LIMIT;
+        i32 i = (i32)c;
+        return i - (c < (f32)i);
+}
+
+/**
+ * @brief Hash a cell (Teschner et al.) and mix the result.
+ *
+ * The buckets are the low bits, the final multiply and shifts spread the
+ * high bits of the products into them.
+ */
+static inline u32 grid_hash(i32 x, i32 y, i32 z, u32 mask) {
+        u32 h = (u32)x * 73856093u ^ (u32)y * 19349663u ^ (u32)z * 83492791u;
+        h ^= h >> 16;
+        h *= 0x7feb352du;
+        h ^= h >> 15;
+        return h & mask;
+}
+
+
+/** @brief Allocate a grid for up to capacity points, all arrays in one block. */
+bool smath_grid_create(smath_grid *g, f32 cell_size, size_t capacity) {
+        memset(g, 0, sizeof(*g));
+
+        if (capacity >= (size_t)1 << 30)
+                return false;
+
+        u32 buckets = 64;
+        while (buckets < 2 * capacity)
+                buckets *= 2;
+
+        size_t n = GRID_PAD(capacity);
+        size_t b = GRID_PAD((size_t)buckets + 1);
+        u32 *p = grid_alloc((b + 5 * n) * sizeof(u32));
+
+        if (!p)
+                return false;
+
+        g->start = p;
+        g->indices = p + b;
+        g->x = (f32*)(p + b + n);
+        g->y = (f32*)(p + b + 2 * n);
+        g->z = (f32*)(p + b + 3 * n);
+        g->bucket = p + b + 4 * n;
+
+        g->cell_size = cell_size;
+        g->inv_cell_size = 1.0f / cell_size;
+        g->buckets = buckets;
+        g->capacity = capacity;
+
+        return true;
+}
+
+/** @brief Free the block of a grid. */
+void smath_grid_destroy(smath_grid *g) {
+        grid_free(g->start);
+        memset(g, 0, sizeof(*g));
+}
+
+/**
+ * @brief Counting sort of strided points on the hash of their cell.
+ *
+ * The counts are summed up to the end of every bucket, the scatter then
+ * walks the points backwards and decrements the ends down to the starts,
+ * which keeps the input order within a bucket.
+ */
+static bool grid_build(smath_grid *g, const f32 *x, const f32 *y, const f32 *z, size_t stride, size_t count) {
+        g->count = 0;
+        g->planar = z == NULL;
+
+        if (count > g->capacity)
+                return false;
+
+        u32 mask = g->buckets - 1;
+        f32 inv = g->inv_cell_size;
+
+        memset(g->start, 0, ((size_t)g->buckets + 1) * sizeof(u32));
+
+        for (size_t i = 0; i < count; ++i) {
+                i32 cz = z ? grid_cell(z[i * stride], inv) : 0;
+                u32 b = grid_hash(grid_cell(x[i * stride], inv), grid_cell(y[i * stride], inv), cz, mask);
+                g->bucket[i] = b;
+                ++g->start[b];
+        }
+
+        u32 sum = 0;
+        for (u32 b = 0; b < g->buckets; ++b) {
+                sum += g->start[b];
+                g->start[b] = sum;
+        }
+        g->start[g->buckets] = sum;
+
+        for (size_t i = count; i-- > 0;) {
+                u32 k = --g->start[g->bucket[i]];
+                g->indices[k] = (u32)i;
+                g->x[k] = x[i * stride];
+                g->y[k] = y[i * stride];
+                g->z[k] = z ? z[i * stride] : 0.0f;
+        }
+
+        g->count = count;
+        return true;
+}
+
+/** @brief Bucket an array of vec3 points. */
+bool smath_grid_build(smath_grid *g, const vec3 *p, size_t count) {
+        return grid_build(g, &p->x, &p->y, &p->z, sizeof(vec3) / sizeof(f32), count);
+}
+
+/** @brief Bucket a vec3_soa. */
+bool smath_grid_build_soa(smath_grid *g, const vec3_soa *p) {
+        return grid_build(g, p->x, p->y, p->z, 1, p->count);
+}
+
+/** @brief Bucket an array of vec2 points. */
+bool smath_grid_build_vec2(smath_grid *g, const vec2 *p, size_t count) {
+        return grid_build(g, &p->x, &p->y, NULL, sizeof(vec2) / sizeof(f32), count);
+}
+
+/** @brief Bucket 2D points given as separate x and y arrays. */
+bool smath_grid_build_xy(smath_grid *g, const f32 *x, const f32 *y, size_t count) {
+        return grid_build(g, x, y, NULL, 1, count);
+}
+
+
+/**
+ * @brief Visit the cells of the bounding box of the sphere.
+ *
+ * Cells that share a bucket give the same range, a range is only added
+ * when no range so far starts where it does, which is a short scan as
+ * long as max is small.
+ */
+size_t smath_grid_query_ranges(const smath_grid *g, const vec3 *p, f32 radius,
+                               smath_grid_range *ranges, size_t max) {
+        if (g->count == 0)
+                return 0;
+
+        f32 inv = g->inv_cell_size;
+        i32 x0 = grid_cell(p->x - radius, inv), x1 = grid_cell(p->x + radius, inv);
+        i32 y0 = grid_cell(p->y - radius, inv), y1 = grid_cell(p->y + radius, inv);
+        i32 z0 = 0, z1 = 0;
+
+        if (!g->planar) {
+                z0 = grid_cell(p->z - radius, inv);
+                z1 = grid_cell(p->z + radius, inv);
+        }
+
+        if (x1 < x0 || y1 < y0 || z1 < z0)
+                return 0;
+
+        // Each extent is at most 2^31 + 1, the product of two still fits.
+        i64 nx = (i64)x1 - x0 + 1, ny = (i64)y1 - y0 + 1, nz = (i64)z1 - z0 + 1;
+        i64 limit = max < (size_t)INT32_MAX ? (i64)max : INT32_MAX;
+
+        if (nx * ny > limit || nx * ny * nz > limit) {
+                ranges[0].begin = 0;
+                ranges[0].end = (u32)g->count;
+                return 1;
+        }
+
+        u32 mask = g->buckets - 1;
+        size_t n = 0;
+
+        for (i32 z = z0; z <= z1; ++z) {
+                for (i32 y = y0; y <= y1; ++y) {
+                        for (i32 x = x0; x <= x1; ++x) {
+                                u32 b = grid_hash(x, y, z, mask);
+                                u32 begin = g->start[b], end = g->start[b + 1];
+
+                                if (begin == end)
+                                        continue;
+
+                                size_t i = 0;
+                                while (i < n && ranges[i].begin != begin)
+                                        ++i;
+
+                                if (i == n) {
+                                        ranges[n].begin = begin;
+                                        ranges[n].end = end;
+                                        ++n;
+                                }
+                        }
+                }
+        }
+
+        return n;
+}
+
+/**
+ * @brief Test the distance of every point in the ranges of smath_grid_query_ranges.
+ *
+ * The index of every candidate is stored at out[found] while found is
+ * below max, and found only moves on for a hit, so the distance test
+ * itself is no branch. A slot below max past the returned count can
+ * therefore be overwritten.
+ */
+size_t smath_grid_query_radius(const smath_grid *g, const vec3 *p, f32 radius, u32 *out, size_t max) {
+        smath_grid_range ranges[SMATH_GRID_MAX_RANGES];
+        size_t n = smath_grid_query_ranges(g, p, radius, ranges, SMATH_GRID_MAX_RANGES);
+        const f32 *x = g->x, *y = g->y, *z = g->z;
+        const u32 *indices = g->indices;
+        f32 px = p->x, py = p->y, pz = g->planar ? 0.0f : p->z;
+        f32 r2 = radius * radius;
+        size_t found = 0;
+
+        for (size_t i = 0; i < n; ++i) {
+                for (u32 j = ranges[i].begin; j < ranges[i].end; ++j) {
+                        f32 dx = x[j] - px, dy = y[j] - py, dz = z[j] - pz;
+
+                        if (found < max)
+                                out[found] = indices[j];
+                        found += dx * dx + dy * dy + dz * dz <= r2;
+                }
+        }
+
+        return found;
+}
@@ -0,0 +1,197 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/hierarchy.h"
+#include "../include/dispatch.h"
+#include "../include/mat4x4.h"
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+
+/** @brief Allocate size bytes aligned to 64, size is a multiple of 64. */
+static void *hierarchy_alloc(size_t size) {
+#if defined(_WIN32)
+        return _aligned_malloc(size, 64);
+#else
+        return aligned_alloc(64, size);
+#endif
+}
+
+/** @brief Free memory from hierarchy_alloc. */
+static void hierarchy_free(void *p) {
+#if defined(_WIN32)
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+}
+
+/** @brief Bytes of one node over all arrays. */
+#define HIERARCHY_NODE_SIZE (sizeof(mat4x4) + sizeof(quat) + 2 * sizeof(vec3) + 2 * sizeof(i32) + sizeof(u8))
+
+/**
+ * @brief Point the arrays into one block of capacity nodes.
+ *
+ * The capacity is a multiple of 64, so every array starts 64 byte aligned.
+ */
+static void hierarchy_carve(smath_hierarchy *h, u8 *p, size_t capacity) {
+        h->world = (mat4x4*)p;
+        p += capacity * sizeof(mat4x4);
+        h->rotation = (quat*)p;
+        p += capacity * sizeof(quat);
+        h->position = (vec3*)p;
+        p += capacity * sizeof(vec3);
+        h->scale = (vec3*)p;
+        p += capacity * sizeof(vec3);
+        h->parent = (i32*)p;
+        p += capacity * sizeof(i32);
+        h->subtree_end = (i32*)p;
+        p += capacity * sizeof(i32);
+        h->dirty = p;
+        h->capacity = capacity;
+}
+
+
+/** @brief Allocate an empty hierarchy. */
+bool smath_hierarchy_create(smath_hierarchy *h, size_t capacity) {
+        capacity = (capacity + 63) / 64 * 64;
+        if (capacity == 0)
+                capacity = 64;
+
+        u8 *p = hierarchy_alloc(capacity * HIERARCHY_NODE_SIZE);
+
+        if (!p)
+                return false;
+
+        hierarchy_carve(h, p, capacity);
+        h->count = 0;
+        h->first_dirty = 0;
+
+        return true;
+}
+
+/** @brief Free the arrays of a hierarchy. */
+void smath_hierarchy_destroy(smath_hierarchy *h) {
+        hierarchy_free(h->world);
+        memset(h, 0, sizeof(*h));
+}
+
+/** @brief Double the capacity, copying the nodes over. */
+static bool hierarchy_grow(smath_hierarchy *h) {
+        smath_hierarchy g;
+
+        if (!smath_hierarchy_create(&g, 2 * h->capacity))
+                return false;
+
+        memcpy(g.world, h->world, h->count * sizeof(mat4x4));
+        memcpy(g.rotation, h->rotation, h->count * sizeof(quat));
+        memcpy(g.position, h->position, h->count * sizeof(vec3));
+        memcpy(g.scale, h->scale, h->count * sizeof(vec3));
+        memcpy(g.parent, h->parent, h->count * sizeof(i32));
+        memcpy(g.subtree_end, h->subtree_end, h->count * sizeof(i32));
+        memcpy(g.dirty, h->dirty, h->count * sizeof(u8));
+
+        g.count = h->count;
+        g.first_dirty = h->first_dirty;
+
+        hierarchy_free(h->world);
+        *h = g;
+
+        return true;
+}
+
+/**
+ * @brief Add a node at the end, flagged so the next update computes its world matrix.
+ *
+ * The new node has the highest index, so it becomes the subtree end of
+ * every ancestor, which makes adding O(depth).
+ */
+i32 smath_hierarchy_add(smath_hierarchy *h, i32 parent, const vec3 *position, const quat *rotation, const vec3 *scale) {
+        assert(parent == SMATH_HIERARCHY_ROOT || (parent >= 0 && (size_t)parent < h->count));
+
+        if (h->count == h->capacity && !hierarchy_grow(h))
+                return -1;
+
+        size_t i = h->count++;
+
+        h->position[i] = *position;
+        h->rotation[i] = *rotation;
+        h->scale[i] = *scale;
+        h->parent[i] = parent;
+        h->subtree_end[i] = (i32)i;
+        h->dirty[i] = 1;
+
+        for (i32 p = parent; p >= 0; p = h->parent[p])
+                h->subtree_end[p] = (i32)i;
+
+        if (i < h->first_dirty)
+                h->first_dirty = i;
+
+        return (i32)i;
+}
+
+/** @brief Change the local transform of a node and flag it. */
+void smath_hierarchy_set_local(smath_hierarchy *h, i32 node, const vec3 *position, const quat *rotation, const vec3 *scale) {
+        assert(node >= 0 && (size_t)node < h->count);
+
+        if (position)
+                h->position[node] = *position;
+        if (rotation)
+                h->rotation[node] = *rotation;
+        if (scale)
+                h->scale[node] = *scale;
+
+        h->dirty[node] = 1;
+
+        if ((size_t)node < h->first_dirty)
+                h->first_dirty = (size_t)node;
+}
+
+/**
+ * @brief Recompute the flagged nodes and their subtrees.
+ *
+ * Walks the index range of a flagged subtree front to back. A node is
+ * recomputed when it or its parent is flagged and stays flagged so its own
+ * children see it, the parent always comes first. Past the end of the range
+ * its flags are cleared and memchr jumps to the next flagged node, so the
+ * clean parts of the hierarchy are never touched.
+ */
+void smath_hierarchy_update(smath_hierarchy *h) {
+        size_t n = h->count;
+        size_t i = h->first_dirty;
+
+        if (i >= n)
+                return;
+
+        mat4x4 (*mult)(const mat4x4 *m0, const mat4x4 *m1) = smath_get_kernels()->mat4x4_mult;
+
+        while (i < n) {
+                size_t start = i;
+                size_t end = (size_t)h->subtree_end[i];
+
+                for (; i <= end; ++i) {
+                        i32 p = h->parent[i];
+
+                        if (!h->dirty[i] && (p < 0 || !h->dirty[p]))
+                                continue;
+
+                        h->dirty[i] = 1;
+
+                        if ((size_t)h->subtree_end[i] > end)
+                                end = (size_t)h->subtree_end[i];
+
+                        mat4x4 local = mat4x4_from_trs(&h->position[i], &h->rotation[i], &h->scale[i]);
+                        h->world[i] = p < 0 ? local : mult(&h->world[p], &local);
+                }
+
+                memset(h->dirty + start, 0, i - start);
+
+                const u8 *next = i < n ? memchr(h->dirty + i, 1, n - i) : NULL;
+                i = next ? (size_t)(next - h->dirty) : n;
+        }
+
+        h->first_dirty = n;
+}
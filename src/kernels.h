@@ -0,0 +1,30 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include "../include/dispatch.h"
+
+/*
+ * Private to the library.
+ *
+ * Every kernels_<isa>.c is compiled with the flags of its instruction set
+ * and overwrites the entries of the table it has a faster version of.
+ * When it was compiled without those flags it does nothing and returns 0,
+ * so the table keeps the entries of the lower instruction set.
+ */
+
+/** @brief Fill the table with the scalar kernels, every entry is set. */
+void smath_kernels_bind_scalar(smath_kernels *k);
+
+/** @brief Bind the SSE2 kernels, returns 1 if they were compiled in. */
+int smath_kernels_bind_sse2(smath_kernels *k);
+
+/** @brief Bind the SSE4.1 kernels, returns 1 if they were compiled in. */
+int smath_kernels_bind_sse41(smath_kernels *k);
+
+/** @brief Bind the AVX2 + FMA + F16C kernels, returns 1 if they were compiled in. */
+int smath_kernels_bind_avx2(smath_kernels *k);
+
+/** @brief Bind the AVX-512F kernels (built with AVX2 + FMA + F16C too), returns 1 if they were compiled in. */
+int smath_kernels_bind_avx512(smath_kernels *k);
+
+#endif // KERNELS_H
@@ -0,0 +1,650 @@
+#include "kernels.h"
+
+/* Compiled with -mavx2 -mfma. */
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+
+/** @brief AVX2 - 4x4 matrix multiplication, two rows of the result per ymm register. */
+static inline void mat4x4_mult_avx2_to(mat4x4 *dest, const mat4x4 *m0, const mat4x4 *m1) {
+        __m256 r0 = _mm256_broadcast_ps((const __m128*)m1->t[0]);
+        __m256 r1 = _mm256_broadcast_ps((const __m128*)m1->t[1]);
+        __m256 r2 = _mm256_broadcast_ps((const __m128*)m1->t[2]);
+        __m256 r3 = _mm256_broadcast_ps((const __m128*)m1->t[3]);
+
+        __m256 a01 = _mm256_load_ps(m0->t[0]);
+        __m256 a23 = _mm256_load_ps(m0->t[2]);
+
+        __m256 d01 = _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(0, 0, 0, 0)), r0);
+        __m256 d23 = _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(0, 0, 0, 0)), r0);
+        d01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(1, 1, 1, 1)), r1, d01);
+        d23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(1, 1, 1, 1)), r1, d23);
+        d01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(2, 2, 2, 2)), r2, d01);
+        d23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(2, 2, 2, 2)), r2, d23);
+        d01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(3, 3, 3, 3)), r3, d01);
+        d23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(3, 3, 3, 3)), r3, d23);
+
+        _mm256_store_ps(dest->t[0], d01);
+        _mm256_store_ps(dest->t[2], d23);
+}
+
+/** @brief AVX2 - 4x4 matrix multiplication. */
+static mat4x4 mat4x4_mult_avx2(const mat4x4 *m0, const mat4x4 *m1) {
+        mat4x4 m;
+        mat4x4_mult_avx2_to(&m, m0, m1);
+        return m;
+}
+
+/** @brief AVX2 - Multiply a 4x4 matrix with a 4D vector, the row products are summed with two hadds. */
+static vec4 mat4x4_vec4_mult_avx2(const mat4x4 *m, const vec4 *v) {
+        vec4 v1;
+
+        __m256 x = _mm256_broadcast_ps((const __m128*)v);
+        __m256 p01 = _mm256_mul_ps(_mm256_load_ps(m->t[0]), x);
+        __m256 p23 = _mm256_mul_ps(_mm256_load_ps(m->t[2]), x);
+
+        // low lane: [d0, d2, d0, d2], high lane: [d1, d3, d1, d3]
+        __m256 h = _mm256_hadd_ps(p01, p23);
+        h = _mm256_hadd_ps(h, h);
+
+        __m128 r = _mm_unpacklo_ps(_mm256_castps256_ps128(h), _mm256_extractf128_ps(h, 1));
+        _mm_store_ps((f32*)&v1, r);
+
+        return v1;
+}
+
+/** @brief AVX2 - Multiply two arrays of 4x4 matrices pairwise. */
+static void mat4x4_mult_array_avx2(mat4x4 *dest, const mat4x4 *m0, const mat4x4 *m1, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                mat4x4_mult_avx2_to(&dest[i], &m0[i], &m1[i]);
+        }
+}
+
+/** @brief AVX2 - Put the same 4 floats into both 128-bit lanes. */
+static inline __m256 m256_dup_avx2(__m128 v) {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(v), v, 1);
+}
+
+/** @brief AVX2 - Load two 128-bit values into the low and high lane. */
+static inline __m256 m256_loadu2_avx2(const f32 *lo, const f32 *hi) {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(lo)), _mm_loadu_ps(hi), 1);
+}
+
+/** @brief AVX2 - Load the columns of a 4x4 matrix (the rows are what is stored). */
+static inline void mat4x4_columns_avx2(const mat4x4 *m, __m128 c[4]) {
+        c[0] = _mm_load_ps(m->t[0]);
+        c[1] = _mm_load_ps(m->t[1]);
+        c[2] = _mm_load_ps(m->t[2]);
+        c[3] = _mm_load_ps(m->t[3]);
+
+        _MM_TRANSPOSE4_PS(c[0], c[1], c[2], c[3]);
+}
+
+/**
+ * @brief AVX2 - Load 8 packed vec3 and split them into x, y and z registers.
+ *
+ * The low lane holds vectors 0-3 and the high lane vectors 4-7, the
+ * shuffles stay inside a lane so they are the same as the SSE2 ones.
+ */
+static inline void vec3x8_load_avx2(const vec3 *in, __m256 *x, __m256 *y, __m256 *z) {
+        const f32 *p = (const f32*)in;
+        __m256 a = m256_loadu2_avx2(p, p + 12);
+        __m256 b = m256_loadu2_avx2(p + 4, p + 16);
+        __m256 c = m256_loadu2_avx2(p + 8, p + 20);
+
+        __m256 t0 = _mm256_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 0, 0));
+        __m256 t1 = _mm256_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));
+        *x = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 2, 0));
+
+        t0 = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+        t1 = _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+        *y = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 2, 0));
+
+        t0 = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+        t1 = _mm256_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0));
+        *z = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+/** @brief AVX2 - Store 128 bits, non-temporal when stream is set (p is 16 byte aligned then). */
+static inline void m128_store_avx2(f32 *p, __m128 v, int stream) {
+        if (stream)
+                _mm_stream_ps(p, v);
+        else
+                _mm_storeu_ps(p, v);
+}
+
+/** @brief AVX2 - Interleave x, y and z registers back into 8 packed vec3. */
+static inline void vec3x8_store_avx2(vec3 *out, __m256 x, __m256 y, __m256 z, int stream) {
+        f32 *p = (f32*)out;
+
+        __m256 t0 = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0));
+        __m256 t1 = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));
+        __m256 a = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 2, 0));
+
+        t0 = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));
+        t1 = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2));
+        __m256 b = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 2, 0));
+
+        t0 = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2));
+        t1 = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3));
+        __m256 c = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 2, 0));
+
+        m128_store_avx2(p, _mm256_castps256_ps128(a), stream);
+        m128_store_avx2(p + 4, _mm256_castps256_ps128(b), stream);
+        m128_store_avx2(p + 8, _mm256_castps256_ps128(c), stream);
+        m128_store_avx2(p + 12, _mm256_extractf128_ps(a, 1), stream);
+        m128_store_avx2(p + 16, _mm256_extractf128_ps(b, 1), stream);
+        m128_store_avx2(p + 20, _mm256_extractf128_ps(c, 1), stream);
+}
+
+/** @brief AVX2 - Transform a single vec3 with the matrix columns, c3 is zero for directions. */
+static inline void vec3_transform_avx2(const __m128 c[3], __m128 c3, const vec3 *in, vec3 *out) {
+        __m128 r = _mm_fmadd_ps(c[0], _mm_set1_ps(in->x), c3);
+        r = _mm_fmadd_ps(c[1], _mm_set1_ps(in->y), r);
+        r = _mm_fmadd_ps(c[2], _mm_set1_ps(in->z), r);
+
+        _mm_storel_pi((__m64*)out, r);
+        _mm_store_ss(&out->z, _mm_movehl_ps(r, r));
+}
+
+/** @brief AVX2 - Transform 3D vectors, 8 at a time, see mat4x4_transform_vec3_sse2. */
+static inline void mat4x4_transform_vec3_avx2(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n, int point, int stream) {
+        __m128 c[4];
+        mat4x4_columns_avx2(m, c);
+
+        __m128 c3 = point ? c[3] : _mm_setzero_ps();
+        __m256 zero = _mm256_setzero_ps();
+
+        __m256 m00 = _mm256_set1_ps(m->t[0][0]), m01 = _mm256_set1_ps(m->t[0][1]), m02 = _mm256_set1_ps(m->t[0][2]);
+        __m256 m10 = _mm256_set1_ps(m->t[1][0]), m11 = _mm256_set1_ps(m->t[1][1]), m12 = _mm256_set1_ps(m->t[1][2]);
+        __m256 m20 = _mm256_set1_ps(m->t[2][0]), m21 = _mm256_set1_ps(m->t[2][1]), m22 = _mm256_set1_ps(m->t[2][2]);
+        __m256 m03 = point ? _mm256_set1_ps(m->t[0][3]) : zero;
+        __m256 m13 = point ? _mm256_set1_ps(m->t[1][3]) : zero;
+        __m256 m23 = point ? _mm256_set1_ps(m->t[2][3]) : zero;
+
+        size_t i = 0;
+
+        if (stream) {
+                for (; i < n && ((uintptr_t)&out[i] & 15); ++i) {
+                        vec3_transform_avx2(c, c3, &in[i], &out[i]);
+                }
+        }
+
+        for (; i + 8 <= n; i += 8) {
+                __m256 x, y, z;
+                vec3x8_load_avx2(&in[i], &x, &y, &z);
+
+                // The order of vec3_transform_avx2, so a vector gives the same bits at every index.
+                __m256 ox = _mm256_fmadd_ps(m02, z, _mm256_fmadd_ps(m01, y, _mm256_fmadd_ps(m00, x, m03)));
+                __m256 oy = _mm256_fmadd_ps(m12, z, _mm256_fmadd_ps(m11, y, _mm256_fmadd_ps(m10, x, m13)));
+                __m256 oz = _mm256_fmadd_ps(m22, z, _mm256_fmadd_ps(m21, y, _mm256_fmadd_ps(m20, x, m23)));
+
+                vec3x8_store_avx2(&out[i], ox, oy, oz, stream);
+        }
+
+        for (; i < n; ++i) {
+                vec3_transform_avx2(c, c3, &in[i], &out[i]);
+        }
+
+        if (stream)
+                _mm_sfence();
+}
+
+/** @brief AVX2 - Transform 4D vectors, two per ymm register. */
+static inline void mat4x4_transform_vec4_avx2(const mat4x4 *m, const vec4 *in, vec4 *out, size_t n, int stream) {
+        __m128 c[4];
+        mat4x4_columns_avx2(m, c);
+
+        __m256 c0 = m256_dup_avx2(c[0]);
+        __m256 c1 = m256_dup_avx2(c[1]);
+        __m256 c2 = m256_dup_avx2(c[2]);
+        __m256 c3 = m256_dup_avx2(c[3]);
+
+        size_t i = 0;
+
+        for (; i + 2 <= n; i += 2) {
+                __m256 v = _mm256_loadu_ps((const f32*)&in[i]);
+                __m256 r = _mm256_mul_ps(c0, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+                r = _mm256_fmadd_ps(c1, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), r);
+                r = _mm256_fmadd_ps(c2, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), r);
+                r = _mm256_fmadd_ps(c3, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), r);
+
+                m128_store_avx2((f32*)&out[i], _mm256_castps256_ps128(r), stream);
+                m128_store_avx2((f32*)&out[i + 1], _mm256_extractf128_ps(r, 1), stream);
+        }
+
+        if (i < n) {
+                __m128 v = _mm_load_ps((const f32*)&in[i]);
+                __m128 r = _mm_mul_ps(c[0], _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+                r = _mm_fmadd_ps(c[1], _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), r);
+                r = _mm_fmadd_ps(c[2], _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), r);
+                r = _mm_fmadd_ps(c[3], _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), r);
+
+                m128_store_avx2((f32*)&out[i], r, stream);
+        }
+
+        if (stream)
+                _mm_sfence();
+}
+
+static void mat4x4_transform_points_avx2(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n) {
+        mat4x4_transform_vec3_avx2(m, in, out, n, 1, 0);
+}
+
+static void mat4x4_transform_directions_avx2(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n) {
+        mat4x4_transform_vec3_avx2(m, in, out, n, 0, 0);
+}
+
+static void mat4x4_transform_vec4s_avx2(const mat4x4 *m, const vec4 *in, vec4 *out, size_t n) {
+        mat4x4_transform_vec4_avx2(m, in, out, n, 0);
+}
+
+static void mat4x4_transform_points_stream_avx2(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n) {
+        mat4x4_transform_vec3_avx2(m, in, out, n, 1, 1);
+}
+
+static void mat4x4_transform_vec4s_stream_avx2(const mat4x4 *m, const vec4 *in, vec4 *out, size_t n) {
+        mat4x4_transform_vec4_avx2(m, in, out, n, 1);
+}
+
+/** @brief AVX2 - _MM_TRANSPOSE4_PS inside both 128-bit lanes. */
+static inline void transpose4x2_avx2(__m256 *a, __m256 *b, __m256 *c, __m256 *d) {
+        __m256 t0 = _mm256_unpacklo_ps(*a, *b);
+        __m256 t1 = _mm256_unpacklo_ps(*c, *d);
+        __m256 t2 = _mm256_unpackhi_ps(*a, *b);
+        __m256 t3 = _mm256_unpackhi_ps(*c, *d);
+
+        *a = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+        *b = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+        *c = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        *d = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+/**
+ * @brief AVX2 - Transpose one element of 8 matrices into their rows and store them.
+ *
+ * d points at the row of matrix 0, the matrices are stride floats apart.
+ * The low lane holds matrices 0-3 and the high lane matrices 4-7.
+ */
+static inline void trs_store_rows_avx2(f32 *d, size_t stride, __m256 a, __m256 b, __m256 c, __m256 e) {
+        transpose4x2_avx2(&a, &b, &c, &e);
+
+        _mm_store_ps(d, _mm256_castps256_ps128(a));
+        _mm_store_ps(d + stride, _mm256_castps256_ps128(b));
+        _mm_store_ps(d + 2 * stride, _mm256_castps256_ps128(c));
+        _mm_store_ps(d + 3 * stride, _mm256_castps256_ps128(e));
+        _mm_store_ps(d + 4 * stride, _mm256_extractf128_ps(a, 1));
+        _mm_store_ps(d + 5 * stride, _mm256_extractf128_ps(b, 1));
+        _mm_store_ps(d + 6 * stride, _mm256_extractf128_ps(c, 1));
+        _mm_store_ps(d + 7 * stride, _mm256_extractf128_ps(e, 1));
+}
+
+/** @brief AVX2 - The top 3 rows of 8 TRS matrices, m[i][j] holds row i column j of every matrix. */
+static inline void trs8_avx2(const vec3 *t, const quat *r, const vec3 *s, __m256 m[3][4]) {
+        __m256 x = m256_loadu2_avx2(&r[0].x, &r[4].x);
+        __m256 y = m256_loadu2_avx2(&r[1].x, &r[5].x);
+        __m256 z = m256_loadu2_avx2(&r[2].x, &r[6].x);
+        __m256 w = m256_loadu2_avx2(&r[3].x, &r[7].x);
+        transpose4x2_avx2(&x, &y, &z, &w);
+
+        __m256 sx, sy, sz;
+        vec3x8_load_avx2(t, &m[0][3], &m[1][3], &m[2][3]);
+        vec3x8_load_avx2(s, &sx, &sy, &sz);
+
+        __m256 one = _mm256_set1_ps(1.0F), two = _mm256_set1_ps(2.0F);
+        __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+        __m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+        __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+
+        m[0][0] = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one), sx);
+        m[0][1] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy);
+        m[0][2] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz);
+
+        m[1][0] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx);
+        m[1][1] = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, zz), one), sy);
+        m[1][2] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz);
+
+        m[2][0] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx);
+        m[2][1] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy);
+        m[2][2] = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one), sz);
+}
+
+/** @brief AVX2 - 8 TRS matrices, rows is 3 for a mat4x3 and 4 for a mat4x4. */
+static inline void trs8_store_avx2(f32 *dest, size_t stride, int rows, const vec3 *t, const quat *r, const vec3 *s) {
+        __m256 m[3][4];
+        trs8_avx2(t, r, s, m);
+
+        for (int i = 0; i < 3; ++i) {
+                trs_store_rows_avx2(dest + 4 * i, stride, m[i][0], m[i][1], m[i][2], m[i][3]);
+        }
+
+        if (rows == 4) {
+                __m128 e3 = _mm_set_ps(1.0F, 0.0F, 0.0F, 0.0F);
+                for (int k = 0; k < 8; ++k) {
+                        _mm_store_ps(dest + k * stride + 12, e3);
+                }
+        }
+}
+
+/** @brief AVX2 - mat times 8 TRS matrices, the zeros of the last TRS row are skipped. */
+static inline void trs8_mult_store_avx2(mat4x4 *dest, const mat4x4 *mat, const vec3 *t, const quat *r, const vec3 *s) {
+        __m256 m[3][4];
+        trs8_avx2(t, r, s, m);
+
+        for (int i = 0; i < 4; ++i) {
+                __m256 a0 = _mm256_set1_ps(mat->t[i][0]);
+                __m256 a1 = _mm256_set1_ps(mat->t[i][1]);
+                __m256 a2 = _mm256_set1_ps(mat->t[i][2]);
+                __m256 o[4];
+
+                for (int j = 0; j < 4; ++j) {
+                        o[j] = _mm256_fmadd_ps(a2, m[2][j], _mm256_fmadd_ps(a1, m[1][j], _mm256_mul_ps(a0, m[0][j])));
+                }
+                o[3] = _mm256_add_ps(o[3], _mm256_set1_ps(mat->t[i][3]));
+
+                trs_store_rows_avx2(dest[0].t[i], 16, o[0], o[1], o[2], o[3]);
+        }
+}
+
+/** @brief AVX2 - Copy the last n < 8 TRS of the arrays into blocks of 8, the unused ones are the identity. */
+static inline void trs8_tail_avx2(vec3 t8[8], quat r8[8], vec3 s8[8], const vec3 *t, const quat *r, const vec3 *s, size_t n) {
+        for (size_t k = 0; k < 8; ++k) {
+                t8[k] = k < n ? t[k] : (vec3){ 0.0F, 0.0F, 0.0F };
+                r8[k] = k < n ? r[k] : (quat){ 0.0F, 0.0F, 0.0F, 1.0F };
+                s8[k] = k < n ? s[k] : (vec3){ 1.0F, 1.0F, 1.0F };
+        }
+}
+
+/** @brief AVX2 - Build TRS matrices, 8 at a time. */
+static void mat4x4_from_trs_array_avx2(mat4x4 *dest, const vec3 *t, const quat *r, const vec3 *s, size_t n) {
+        size_t i = 0;
+
+        for (; i + 8 <= n; i += 8) {
+                trs8_store_avx2(dest[i].t[0], 16, 4, &t[i], &r[i], &s[i]);
+        }
+
+        if (i < n) {
+                vec3 t8[8], s8[8];
+                quat r8[8];
+                mat4x4 m8[8];
+                trs8_tail_avx2(t8, r8, s8, &t[i], &r[i], &s[i], n - i);
+                trs8_store_avx2(m8[0].t[0], 16, 4, t8, r8, s8);
+                memcpy(&dest[i], m8, (n - i) * sizeof(mat4x4));
+        }
+}
+
+/** @brief AVX2 - mat times TRS matrices, 8 at a time. */
+static void mat4x4_from_trs_mult_array_avx2(mat4x4 *dest, const mat4x4 *m, const vec3 *t, const quat *r, const vec3 *s, size_t n) {
+        size_t i = 0;
+
+        for (; i + 8 <= n; i += 8) {
+                trs8_mult_store_avx2(&dest[i], m, &t[i], &r[i], &s[i]);
+        }
+
+        if (i < n) {
+                vec3 t8[8], s8[8];
+                quat r8[8];
+                mat4x4 m8[8];
+                trs8_tail_avx2(t8, r8, s8, &t[i], &r[i], &s[i], n - i);
+                trs8_mult_store_avx2(m8, m, t8, r8, s8);
+                memcpy(&dest[i], m8, (n - i) * sizeof(mat4x4));
+        }
+}
+
+/** @brief AVX2 - Build affine TRS matrices, 8 at a time. */
+static void mat4x3_from_trs_array_avx2(mat4x3 *dest, const vec3 *t, const quat *r, const vec3 *s, size_t n) {
+        size_t i = 0;
+
+        for (; i + 8 <= n; i += 8) {
+                trs8_store_avx2(&dest[i].t[0].x, 12, 3, &t[i], &r[i], &s[i]);
+        }
+
+        if (i < n) {
+                vec3 t8[8], s8[8];
+                quat r8[8];
+                mat4x3 m8[8];
+                trs8_tail_avx2(t8, r8, s8, &t[i], &r[i], &s[i], n - i);
+                trs8_store_avx2(&m8[0].t[0].x, 12, 3, t8, r8, s8);
+                memcpy(&dest[i], m8, (n - i) * sizeof(mat4x3));
+        }
+}
+
+/** @brief AVX2 - Store x, y, z of the low lane to lo and of the high lane to hi. */
+static inline void vec3x2_store_avx2(vec3 *lo, vec3 *hi, __m256 v) {
+        __m128 a = _mm256_castps256_ps128(v);
+        __m128 b = _mm256_extractf128_ps(v, 1);
+
+        _mm_storel_pi((__m64*)lo, a);
+        _mm_store_ss(&lo->z, _mm_movehl_ps(a, a));
+        _mm_storel_pi((__m64*)hi, b);
+        _mm_store_ss(&hi->z, _mm_movehl_ps(b, b));
+}
+
+/** @brief AVX2 - Transform two vec3 with the blended axes of their lanes, t is zero for directions. */
+static inline __m256 skin_transform_avx2(const __m256 c[3], __m256 t, const vec3 *v0, const vec3 *v1) {
+        __m256 v = _mm256_setr_ps(v0->x, v0->y, v0->z, 0.0f, v1->x, v1->y, v1->z, 0.0f);
+
+        t = _mm256_fmadd_ps(c[0], _mm256_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), t);
+        t = _mm256_fmadd_ps(c[1], _mm256_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), t);
+        return _mm256_fmadd_ps(c[2], _mm256_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), t);
+}
+
+/**
+ * @brief AVX2 - Linear blend skinning, two vertices at a time, one per 128-bit lane.
+ *
+ * Same overlapping palette loads as the SSE2 kernel. The last vertex of
+ * an odd count goes into both lanes and is stored twice.
+ */
+static void skin_linear_avx2(const mat3x4 *palette, const skin_influence *influences,
+                             const vec3 *positions, const vec3 *normals,
+                             vec3 *out_positions, vec3 *out_normals, size_t n) {
+        for (size_t i = 0; i < n; i += 2) {
+                size_t j = i + 1 < n ? i + 1 : i;
+                const skin_influence *s0 = &influences[i];
+                const skin_influence *s1 = &influences[j];
+                __m256 c[4];
+
+                c[0] = c[1] = c[2] = c[3] = _mm256_setzero_ps();
+
+                for (int b = 0; b < 4; ++b) {
+                        const f32 *p0 = &palette[s0->bone[b]].t[0].x;
+                        const f32 *p1 = &palette[s1->bone[b]].t[0].x;
+                        __m256 w = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(s0->weight[b])),
+                                                        _mm_set1_ps(s1->weight[b]), 1);
+
+                        c[0] = _mm256_fmadd_ps(w, m256_loadu2_avx2(p0, p1), c[0]);
+                        c[1] = _mm256_fmadd_ps(w, m256_loadu2_avx2(p0 + 3, p1 + 3), c[1]);
+                        c[2] = _mm256_fmadd_ps(w, m256_loadu2_avx2(p0 + 6, p1 + 6), c[2]);
+                        c[3] = _mm256_fmadd_ps(w, m256_loadu2_avx2(p0 + 8, p1 + 8), c[3]);
+                }
+
+                c[3] = _mm256_shuffle_ps(c[3], c[3], _MM_SHUFFLE(3, 3, 2, 1));
+
+                vec3x2_store_avx2(&out_positions[i], &out_positions[j],
+                                  skin_transform_avx2(c, c[3], &positions[i], &positions[j]));
+                if (normals)
+                        vec3x2_store_avx2(&out_normals[i], &out_normals[j],
+                                          skin_transform_avx2(c, _mm256_setzero_ps(), &normals[i], &normals[j]));
+        }
+}
+
+/** @brief AVX2 - Double precision 4x4 matrix multiplication, one row per register. */
+static inline void dmat4x4_mult_avx2_to(dmat4x4 *dest, const dmat4x4 *m0, const dmat4x4 *m1) {
+        __m256d r0 = _mm256_load_pd(m1->t[0]);
+        __m256d r1 = _mm256_load_pd(m1->t[1]);
+        __m256d r2 = _mm256_load_pd(m1->t[2]);
+        __m256d r3 = _mm256_load_pd(m1->t[3]);
+
+        for (int i = 0; i < 4; ++i) {
+                const f64 *a = m0->t[i];
+                __m256d d = _mm256_mul_pd(_mm256_broadcast_sd(&a[0]), r0);
+                d = _mm256_fmadd_pd(_mm256_broadcast_sd(&a[1]), r1, d);
+                d = _mm256_fmadd_pd(_mm256_broadcast_sd(&a[2]), r2, d);
+                d = _mm256_fmadd_pd(_mm256_broadcast_sd(&a[3]), r3, d);
+                _mm256_store_pd(dest->t[i], d);
+        }
+}
+
+/** @brief AVX2 - Multiply two arrays of double precision 4x4 matrices pairwise. */
+static void dmat4x4_mult_array_avx2(dmat4x4 *dest, const dmat4x4 *m0, const dmat4x4 *m1, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                dmat4x4_mult_avx2_to(&dest[i], &m0[i], &m1[i]);
+        }
+}
+
+/** @brief AVX2 - translate(-origin) * m of every matrix, one row per register. */
+static void dmat4x4_to_mat4x4_relative_array_avx2(mat4x4 *dest, const dmat4x4 *src, const dvec3 *origin, size_t n) {
+        __m256d ox = _mm256_set1_pd(origin->x);
+        __m256d oy = _mm256_set1_pd(origin->y);
+        __m256d oz = _mm256_set1_pd(origin->z);
+
+        for (size_t i = 0; i < n; ++i) {
+                const dmat4x4 *m = &src[i];
+                __m256d w = _mm256_load_pd(m->t[3]);
+
+                _mm_store_ps(dest[i].t[0], _mm256_cvtpd_ps(_mm256_fnmadd_pd(ox, w, _mm256_load_pd(m->t[0]))));
+                _mm_store_ps(dest[i].t[1], _mm256_cvtpd_ps(_mm256_fnmadd_pd(oy, w, _mm256_load_pd(m->t[1]))));
+                _mm_store_ps(dest[i].t[2], _mm256_cvtpd_ps(_mm256_fnmadd_pd(oz, w, _mm256_load_pd(m->t[2]))));
+                _mm_store_ps(dest[i].t[3], _mm256_cvtpd_ps(w));
+        }
+}
+
+/**
+ * @brief AVX2 - Double precision positions relative to an origin, as floats.
+ *
+ * 4 dvec3 are 3 registers, [x0 y0 z0 x1] [y1 z1 x2 y2] [z2 x3 y3 z3], the
+ * origin is rotated the same way so every register is one subtraction.
+ */
+static void dvec3_to_vec3_relative_array_avx2(vec3 *dest, const dvec3 *src, const dvec3 *origin, size_t n) {
+        f64 x = origin->x, y = origin->y, z = origin->z;
+        __m256d o0 = _mm256_setr_pd(x, y, z, x);
+        __m256d o1 = _mm256_setr_pd(y, z, x, y);
+        __m256d o2 = _mm256_setr_pd(z, x, y, z);
+        const f64 *p = (const f64*)src;
+        f32 *q = (f32*)dest;
+        size_t i = 0;
+
+        for (; i + 4 <= n; i += 4) {
+                __m128 a = _mm256_cvtpd_ps(_mm256_sub_pd(_mm256_loadu_pd(p + 3 * i), o0));
+                __m128 b = _mm256_cvtpd_ps(_mm256_sub_pd(_mm256_loadu_pd(p + 3 * i + 4), o1));
+                __m128 c = _mm256_cvtpd_ps(_mm256_sub_pd(_mm256_loadu_pd(p + 3 * i + 8), o2));
+
+                _mm_storeu_ps(q + 3 * i, a);
+                _mm_storeu_ps(q + 3 * i + 4, b);
+                _mm_storeu_ps(q + 3 * i + 8, c);
+        }
+
+        for (; i < n; ++i) {
+                dest[i].x = (f32)(src[i].x - x);
+                dest[i].y = (f32)(src[i].y - y);
+                dest[i].z = (f32)(src[i].z - z);
+        }
+}
+
+#define SOA_F __m256
+#define SOA_W 8
+#define SOA_FN(name) name##_avx2
+#define SOA_LOAD(p) _mm256_loadu_ps(p)
+#define SOA_STORE(p, v) _mm256_storeu_ps(p, v)
+#define SOA_SET1(s) _mm256_set1_ps(s)
+#define SOA_ADD(a, b) _mm256_add_ps(a, b)
+#define SOA_SUB(a, b) _mm256_sub_ps(a, b)
+#define SOA_MUL(a, b) _mm256_mul_ps(a, b)
+#define SOA_DIV(a, b) _mm256_div_ps(a, b)
+#define SOA_SQRT(a) _mm256_sqrt_ps(a)
+#define SOA_RSQRT(a) _mm256_rsqrt_ps(a)
+#define SOA_FMADD(a, b, c) _mm256_fmadd_ps(a, b, c)
+#define SOA_COPYSIGN1(a) _mm256_or_ps(_mm256_set1_ps(1.0f), _mm256_and_ps(a, _mm256_set1_ps(-0.0f)))
+#include "kernels_soa.h"
+
+#define SOA_I __m256i
+#define SOA_M __m256
+#define SOA_AND(a, b) _mm256_and_ps(a, b)
+#define SOA_ANDNOT(a, b) _mm256_andnot_ps(a, b)
+#define SOA_OR(a, b) _mm256_or_ps(a, b)
+#define SOA_XOR(a, b) _mm256_xor_ps(a, b)
+#define SOA_MIN(a, b) _mm256_min_ps(a, b)
+#define SOA_MAX(a, b) _mm256_max_ps(a, b)
+#define SOA_LT(a, b) _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+#define SOA_EQ(a, b) _mm256_cmp_ps(a, b, _CMP_EQ_OQ)
+#define SOA_SELECT(m, a, b) _mm256_blendv_ps(b, a, m)
+#define SOA_CVTI(a) _mm256_cvtps_epi32(a)
+#define SOA_CVTF(i) _mm256_cvtepi32_ps(i)
+#define SOA_CASTI(a) _mm256_castps_si256(a)
+#define SOA_CASTF(i) _mm256_castsi256_ps(i)
+#define SOA_ISET1(s) _mm256_set1_epi32(s)
+#define SOA_IADD(a, b) _mm256_add_epi32(a, b)
+#define SOA_ISUB(a, b) _mm256_sub_epi32(a, b)
+#define SOA_IAND(a, b) _mm256_and_si256(a, b)
+#define SOA_ISHL(a, n) _mm256_slli_epi32(a, n)
+#define SOA_ISRA(a, n) _mm256_srai_epi32(a, n)
+#define SOA_ITEST(a, bit) _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(a, _mm256_set1_epi32(bit)), _mm256_set1_epi32(bit)))
+#define SOA_LANE_FN(name) name##_ps256
+#include "kernels_math.h"
+
+#define SOA_MOVEMASK(m) _mm256_movemask_ps(m)
+#include "kernels_cull.h"
+#include "kernels_ray.h"
+
+/** @brief AVX2 - Store the low 16 bits of every lane, sign extended first so the saturating pack keeps them. */
+static inline void soa_istore16_avx2(void *p, __m256i i) {
+        i = _mm256_srai_epi32(_mm256_slli_epi32(i, 16), 16);
+        _mm_storeu_si128((__m128i*)p, _mm_packs_epi32(_mm256_castsi256_si128(i), _mm256_extracti128_si256(i, 1)));
+}
+
+/** @brief AVX2 - Store the low 8 bits of every lane. */
+static inline void soa_istore8_avx2(void *p, __m256i i) {
+        i = _mm256_srai_epi32(_mm256_slli_epi32(i, 24), 24);
+
+        __m128i s = _mm_packs_epi32(_mm256_castsi256_si128(i), _mm256_extracti128_si256(i, 1));
+        _mm_storel_epi64((__m128i*)p, _mm_packs_epi16(s, s));
+}
+
+#define SOA_ILOAD(p) _mm256_loadu_si256((const __m256i*)(p))
+#define SOA_ISTORE(p, i) _mm256_storeu_si256((__m256i*)(p), i)
+#define SOA_ILOAD16(p) _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(p)))
+#define SOA_ISTORE16(p, i) soa_istore16_avx2(p, i)
+#define SOA_ILOAD8(p) _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(p)))
+#define SOA_ISTORE8(p, i) soa_istore8_avx2(p, i)
+#ifdef __F16C__
+#define SOA_LOAD_F16(p) _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(p)))
+#define SOA_STORE_F16(p, a) _mm_storeu_si128((__m128i*)(p), _mm256_cvtps_ph(a, _MM_FROUND_TO_NEAREST_INT))
+#endif
+#include "kernels_pack.h"
+
+int smath_kernels_bind_avx2(smath_kernels *k) {
+        k->mat4x4_mult = mat4x4_mult_avx2;
+        k->mat4x4_vec4_mult = mat4x4_vec4_mult_avx2;
+        k->mat4x4_mult_array = mat4x4_mult_array_avx2;
+        k->mat4x4_transform_points = mat4x4_transform_points_avx2;
+        k->mat4x4_transform_directions = mat4x4_transform_directions_avx2;
+        k->mat4x4_transform_vec4s = mat4x4_transform_vec4s_avx2;
+        k->mat4x4_transform_points_stream = mat4x4_transform_points_stream_avx2;
+        k->mat4x4_transform_vec4s_stream = mat4x4_transform_vec4s_stream_avx2;
+        k->mat4x4_from_trs_array = mat4x4_from_trs_array_avx2;
+        k->mat4x4_from_trs_mult_array = mat4x4_from_trs_mult_array_avx2;
+        k->mat4x3_from_trs_array = mat4x3_from_trs_array_avx2;
+        k->skin_linear = skin_linear_avx2;
+        k->dmat4x4_mult_array = dmat4x4_mult_array_avx2;
+        k->dmat4x4_to_mat4x4_relative_array = dmat4x4_to_mat4x4_relative_array_avx2;
+        k->dvec3_to_vec3_relative_array = dvec3_to_vec3_relative_array_avx2;
+
+        smath_kernels_bind_soa_avx2(k);
+        smath_kernels_bind_math_avx2(k);
+        smath_kernels_bind_cull_avx2(k);
+        smath_kernels_bind_ray_avx2(k);
+        smath_kernels_bind_pack_avx2(k);
+        return 1;
+}
+
+#else
+
+int smath_kernels_bind_avx2(smath_kernels *k) {
+        (void)k;
+        return 0;
+}
+
+#endif // __AVX2__ && __FMA__
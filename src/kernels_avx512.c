@@ -0,0 +1,184 @@
+#include "kernels.h"
+
+/* Compiled with -mavx512f -mavx2 -mfma (every AVX-512 CPU has AVX2 and FMA), only the kernels that gain from AVX-512 are here.
+   The vec3 transforms stay on AVX2, splitting 16 packed vec3 costs more than it saves. */
+
+#if defined(__AVX512F__) && defined(__FMA__)
+
+#include <stdint.h>
+#include <immintrin.h>
+
+/** @brief AVX-512 - 4x4 matrix multiplication, the whole matrix is one zmm register. */
+static inline void mat4x4_mult_avx512_to(mat4x4 *dest, const mat4x4 *m0, const mat4x4 *m1) {
+        __m512 a = _mm512_load_ps(m0->t[0]);
+
+        __m512 d = _mm512_mul_ps(_mm512_permute_ps(a, _MM_SHUFFLE(0, 0, 0, 0)), _mm512_broadcast_f32x4(_mm_load_ps(m1->t[0])));
+        d = _mm512_fmadd_ps(_mm512_permute_ps(a, _MM_SHUFFLE(1, 1, 1, 1)), _mm512_broadcast_f32x4(_mm_load_ps(m1->t[1])), d);
+        d = _mm512_fmadd_ps(_mm512_permute_ps(a, _MM_SHUFFLE(2, 2, 2, 2)), _mm512_broadcast_f32x4(_mm_load_ps(m1->t[2])), d);
+        d = _mm512_fmadd_ps(_mm512_permute_ps(a, _MM_SHUFFLE(3, 3, 3, 3)), _mm512_broadcast_f32x4(_mm_load_ps(m1->t[3])), d);
+
+        _mm512_store_ps(dest->t[0], d);
+}
+
+/** @brief AVX-512 - 4x4 matrix multiplication. */
+static mat4x4 mat4x4_mult_avx512(const mat4x4 *m0, const mat4x4 *m1) {
+        mat4x4 m;
+        mat4x4_mult_avx512_to(&m, m0, m1);
+        return m;
+}
+
+/** @brief AVX-512 - Multiply two arrays of 4x4 matrices pairwise. */
+static void mat4x4_mult_array_avx512(mat4x4 *dest, const mat4x4 *m0, const mat4x4 *m1, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                mat4x4_mult_avx512_to(&dest[i], &m0[i], &m1[i]);
+        }
+}
+
+/** @brief AVX-512 - Transform a single vec4 with the matrix columns, for the stream alignment and the tail. */
+static inline void vec4_transform_avx512(const __m128 c[4], const vec4 *in, vec4 *out, int stream) {
+        __m128 v = _mm_load_ps((const f32*)in);
+        __m128 r = _mm_mul_ps(c[0], _mm_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)));
+        r = _mm_fmadd_ps(c[1], _mm_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)), r);
+        r = _mm_fmadd_ps(c[2], _mm_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)), r);
+        r = _mm_fmadd_ps(c[3], _mm_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3)), r);
+
+        if (stream)
+                _mm_stream_ps((f32*)out, r);
+        else
+                _mm_store_ps((f32*)out, r);
+}
+
+/**
+ * @brief AVX-512 - Transform 4D vectors, four per zmm register.
+ *
+ * With stream the output is first aligned to 64 bytes (at most 3 vectors)
+ * so every non-temporal store writes a whole cache line.
+ */
+static inline void mat4x4_transform_vec4_avx512(const mat4x4 *m, const vec4 *in, vec4 *out, size_t n, int stream) {
+        __m128 c[4];
+        c[0] = _mm_load_ps(m->t[0]);
+        c[1] = _mm_load_ps(m->t[1]);
+        c[2] = _mm_load_ps(m->t[2]);
+        c[3] = _mm_load_ps(m->t[3]);
+        _MM_TRANSPOSE4_PS(c[0], c[1], c[2], c[3]);
+
+        __m512 c0 = _mm512_broadcast_f32x4(c[0]);
+        __m512 c1 = _mm512_broadcast_f32x4(c[1]);
+        __m512 c2 = _mm512_broadcast_f32x4(c[2]);
+        __m512 c3 = _mm512_broadcast_f32x4(c[3]);
+
+        size_t i = 0;
+
+        if (stream) {
+                for (; i < n && ((uintptr_t)&out[i] & 63); ++i) {
+                        vec4_transform_avx512(c, &in[i], &out[i], stream);
+                }
+        }
+
+        for (; i + 4 <= n; i += 4) {
+                __m512 v = _mm512_loadu_ps((const f32*)&in[i]);
+                __m512 r = _mm512_mul_ps(c0, _mm512_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)));
+                r = _mm512_fmadd_ps(c1, _mm512_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)), r);
+                r = _mm512_fmadd_ps(c2, _mm512_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)), r);
+                r = _mm512_fmadd_ps(c3, _mm512_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3)), r);
+
+                if (stream)
+                        _mm512_stream_ps((f32*)&out[i], r);
+                else
+                        _mm512_storeu_ps((f32*)&out[i], r);
+        }
+
+        for (; i < n; ++i) {
+                vec4_transform_avx512(c, &in[i], &out[i], stream);
+        }
+
+        if (stream)
+                _mm_sfence();
+}
+
+static void mat4x4_transform_vec4s_avx512(const mat4x4 *m, const vec4 *in, vec4 *out, size_t n) {
+        mat4x4_transform_vec4_avx512(m, in, out, n, 0);
+}
+
+static void mat4x4_transform_vec4s_stream_avx512(const mat4x4 *m, const vec4 *in, vec4 *out, size_t n) {
+        mat4x4_transform_vec4_avx512(m, in, out, n, 1);
+}
+
+#define SOA_F __m512
+#define SOA_W 16
+#define SOA_FN(name) name##_avx512
+#define SOA_LOAD(p) _mm512_loadu_ps(p)
+#define SOA_STORE(p, v) _mm512_storeu_ps(p, v)
+#define SOA_SET1(s) _mm512_set1_ps(s)
+#define SOA_ADD(a, b) _mm512_add_ps(a, b)
+#define SOA_SUB(a, b) _mm512_sub_ps(a, b)
+#define SOA_MUL(a, b) _mm512_mul_ps(a, b)
+#define SOA_DIV(a, b) _mm512_div_ps(a, b)
+#define SOA_SQRT(a) _mm512_sqrt_ps(a)
+#define SOA_RSQRT(a) _mm512_rsqrt14_ps(a)
+#define SOA_FMADD(a, b, c) _mm512_fmadd_ps(a, b, c)
+// _mm512_or_ps/_mm512_and_ps need AVX-512DQ, use the integer versions.
+#define SOA_COPYSIGN1(a) _mm512_castsi512_ps(_mm512_or_epi32(_mm512_castps_si512(_mm512_set1_ps(1.0f)), \
+                _mm512_and_epi32(_mm512_castps_si512(a), _mm512_set1_epi32((int)0x80000000))))
+#include "kernels_soa.h"
+
+#define SOA_I __m512i
+#define SOA_M __mmask16
+#define SOA_AND(a, b) _mm512_castsi512_ps(_mm512_and_epi32(_mm512_castps_si512(a), _mm512_castps_si512(b)))
+#define SOA_ANDNOT(a, b) _mm512_castsi512_ps(_mm512_andnot_epi32(_mm512_castps_si512(a), _mm512_castps_si512(b)))
+#define SOA_OR(a, b) _mm512_castsi512_ps(_mm512_or_epi32(_mm512_castps_si512(a), _mm512_castps_si512(b)))
+#define SOA_XOR(a, b) _mm512_castsi512_ps(_mm512_xor_epi32(_mm512_castps_si512(a), _mm512_castps_si512(b)))
+#define SOA_MIN(a, b) _mm512_min_ps(a, b)
+#define SOA_MAX(a, b) _mm512_max_ps(a, b)
+#define SOA_LT(a, b) _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ)
+#define SOA_EQ(a, b) _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ)
+#define SOA_SELECT(m, a, b) _mm512_mask_blend_ps(m, b, a)
+#define SOA_CVTI(a) _mm512_cvtps_epi32(a)
+#define SOA_CVTF(i) _mm512_cvtepi32_ps(i)
+#define SOA_CASTI(a) _mm512_castps_si512(a)
+#define SOA_CASTF(i) _mm512_castsi512_ps(i)
+#define SOA_ISET1(s) _mm512_set1_epi32(s)
+#define SOA_IADD(a, b) _mm512_add_epi32(a, b)
+#define SOA_ISUB(a, b) _mm512_sub_epi32(a, b)
+#define SOA_IAND(a, b) _mm512_and_epi32(a, b)
+#define SOA_ISHL(a, n) _mm512_slli_epi32(a, n)
+#define SOA_ISRA(a, n) _mm512_srai_epi32(a, n)
+#define SOA_ITEST(a, bit) _mm512_test_epi32_mask(a, _mm512_set1_epi32(bit))
+#include "kernels_math.h"
+
+#define SOA_MOVEMASK(m) ((u32)(m))
+#include "kernels_cull.h"
+#include "kernels_ray.h"
+
+#define SOA_ILOAD(p) _mm512_loadu_si512(p)
+#define SOA_ISTORE(p, i) _mm512_storeu_si512(p, i)
+#define SOA_ILOAD16(p) _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)(p)))
+#define SOA_ISTORE16(p, i) _mm256_storeu_si256((__m256i*)(p), _mm512_cvtepi32_epi16(i))
+#define SOA_ILOAD8(p) _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*)(p)))
+#define SOA_ISTORE8(p, i) _mm_storeu_si128((__m128i*)(p), _mm512_cvtepi32_epi8(i))
+#define SOA_LOAD_F16(p) _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)(p)))
+#define SOA_STORE_F16(p, a) _mm256_storeu_si256((__m256i*)(p), _mm512_cvtps_ph(a, _MM_FROUND_TO_NEAREST_INT))
+#include "kernels_pack.h"
+
+int smath_kernels_bind_avx512(smath_kernels *k) {
+        k->mat4x4_mult = mat4x4_mult_avx512;
+        k->mat4x4_mult_array = mat4x4_mult_array_avx512;
+        k->mat4x4_transform_vec4s = mat4x4_transform_vec4s_avx512;
+        k->mat4x4_transform_vec4s_stream = mat4x4_transform_vec4s_stream_avx512;
+
+        smath_kernels_bind_soa_avx512(k);
+        smath_kernels_bind_math_avx512(k);
+        smath_kernels_bind_cull_avx512(k);
+        smath_kernels_bind_ray_avx512(k);
+        smath_kernels_bind_pack_avx512(k);
+        return 1;
+}
+
+#else
+
+int smath_kernels_bind_avx512(smath_kernels *k) {
+        (void)k;
+        return 0;
+}
+
+#endif // __AVX512F__ && __FMA__
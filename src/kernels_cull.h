@@ -0,0 +1,112 @@
+/*
+ * Private to the library, included by the kernels_<isa>.c files after
+ * kernels_math.h, with the macros of both still defined and:
+ *
+ *   SOA_MOVEMASK(m)     the lanes of a SOA_M as bits, lane 0 in bit 0
+ *
+ * Every plane is broadcast once, a register of objects is tested against
+ * all 6 of them with the smallest distance kept, so there is one compare
+ * per register. SOA_W divides 32, so the bits of a word are collected in
+ * whole registers. Like the other soa kernels they run over the count
+ * rounded up to a register, the padding is inside the capacity.
+ */
+
+#include "kernels.h"
+
+
+/** @brief The coefficients of the 6 planes, broadcast. */
+typedef struct SOA_FN(soa_planes) {
+        SOA_F x[6], y[6], z[6], w[6];
+} SOA_FN(soa_planes);
+
+static inline void SOA_FN(soa_planes_load)(SOA_FN(soa_planes) *p, const frustum *f) {
+        for (int i = 0; i < 6; ++i) {
+                p->x[i] = SOA_SET1(f->p[i].x);
+                p->y[i] = SOA_SET1(f->p[i].y);
+                p->z[i] = SOA_SET1(f->p[i].z);
+                p->w[i] = SOA_SET1(f->p[i].w);
+        }
+}
+
+/** @brief Collect the culled bits of a register and store the visible word when it is full. */
+#define SOA_CULL_STORE(visible, culled, bits, i, n) \
+        do { \
+                (bits) |= (u32)SOA_MOVEMASK(culled) << ((i) & 31); \
+                if ((((i) + SOA_W) & 31) == 0 || (i) + SOA_W >= (n)) { \
+                        (visible)[(i) / 32] = ~(bits); \
+                        (bits) = 0; \
+                } \
+        } while (0)
+
+/** @brief Clear the bits past count in the last word. */
+static inline void SOA_FN(soa_cull_tail)(u32 *visible, size_t count) {
+        if (count & 31)
+                visible[count / 32] &= (1u << (count & 31)) - 1;
+}
+
+
+/** @brief A sphere is culled when center distance + radius < 0 for a plane. */
+static void SOA_FN(frustum_cull_spheres)(const frustum *f, const sphere_soa *s, u32 *visible) {
+        SOA_FN(soa_planes) p;
+        SOA_FN(soa_planes_load)(&p, f);
+
+        size_t n = (s->count + SOA_W - 1) / SOA_W * SOA_W;
+        u32 bits = 0;
+
+        for (size_t i = 0; i < n; i += SOA_W) {
+                SOA_F x = SOA_LOAD(s->x + i);
+                SOA_F y = SOA_LOAD(s->y + i);
+                SOA_F z = SOA_LOAD(s->z + i);
+                SOA_F r = SOA_LOAD(s->w + i);
+                SOA_F d = SOA_SET1(INFINITY);
+
+                for (int k = 0; k < 6; ++k) {
+                        SOA_F e = SOA_FMADD(p.x[k], x, SOA_FMADD(p.y[k], y, SOA_FMADD(p.z[k], z, SOA_ADD(p.w[k], r))));
+                        d = SOA_MIN(d, e);
+                }
+
+                SOA_CULL_STORE(visible, SOA_LT(d, SOA_SET1(0.0f)), bits, i, n);
+        }
+
+        SOA_FN(soa_cull_tail)(visible, s->count);
+}
+
+/**
+ * @brief A box is culled when its corner furthest along the normal is outside a plane.
+ *
+ * max(a * min, a * max) picks the coordinate of that corner for either
+ * sign of the normal component a.
+ */
+static void SOA_FN(frustum_cull_aabbs)(const frustum *f, const aabb_soa *b, u32 *visible) {
+        SOA_FN(soa_planes) p;
+        SOA_FN(soa_planes_load)(&p, f);
+
+        size_t n = (b->min.count + SOA_W - 1) / SOA_W * SOA_W;
+        u32 bits = 0;
+
+        for (size_t i = 0; i < n; i += SOA_W) {
+                SOA_F x0 = SOA_LOAD(b->min.x + i), x1 = SOA_LOAD(b->max.x + i);
+                SOA_F y0 = SOA_LOAD(b->min.y + i), y1 = SOA_LOAD(b->max.y + i);
+                SOA_F z0 = SOA_LOAD(b->min.z + i), z1 = SOA_LOAD(b->max.z + i);
+                SOA_F d = SOA_SET1(INFINITY);
+
+                for (int k = 0; k < 6; ++k) {
+                        SOA_F e = SOA_ADD(p.w[k], SOA_MAX(SOA_MUL(p.x[k], x0), SOA_MUL(p.x[k], x1)));
+                        e = SOA_ADD(e, SOA_MAX(SOA_MUL(p.y[k], y0), SOA_MUL(p.y[k], y1)));
+                        e = SOA_ADD(e, SOA_MAX(SOA_MUL(p.z[k], z0), SOA_MUL(p.z[k], z1)));
+                        d = SOA_MIN(d, e);
+                }
+
+                SOA_CULL_STORE(visible, SOA_LT(d, SOA_SET1(0.0f)), bits, i, n);
+        }
+
+        SOA_FN(soa_cull_tail)(visible, b->min.count);
+}
+
+#undef SOA_CULL_STORE
+
+
+static void SOA_FN(smath_kernels_bind_cull)(smath_kernels *k) {
+        k->frustum_cull_spheres = SOA_FN(frustum_cull_spheres);
+        k->frustum_cull_aabbs = SOA_FN(frustum_cull_aabbs);
+}
@@ -0,0 +1,447 @@
+/*
+ * Private to the library, included by the kernels_<isa>.c files after
+ * kernels_soa.h, with the macros of kernels_soa.h still defined and:
+ *
+ *   SOA_I               the integer register type, SOA_W int32 wide
+ *   SOA_M               the mask type of the comparisons
+ *   SOA_AND, SOA_OR, SOA_XOR      bitwise on floats
+ *   SOA_ANDNOT(a, b)    ~a & b
+ *   SOA_MIN, SOA_MAX    like minps/maxps, b when either one is NaN
+ *   SOA_LT, SOA_EQ      ordered comparisons to a SOA_M
+ *   SOA_SELECT(m, a, b) a where m is set, b elsewhere
+ *   SOA_CVTI(a)         float to int32, rounded to nearest
+ *   SOA_CVTF(i)         int32 to float
+ *   SOA_CASTI, SOA_CASTF          reinterpret the bits
+ *   SOA_ISET1, SOA_IADD, SOA_ISUB, SOA_IAND
+ *   SOA_ISHL(a, n)      shift left by a constant
+ *   SOA_ISRA(a, n)      arithmetic shift right by a constant
+ *   SOA_ITEST(a, bit)   mask of the lanes with the bit set
+ *
+ * Optionally SOA_LANE_FN(name), then the register versions are exported
+ * under that name (transcendental.h).
+ *
+ * The approximations are the single precision ones of Cephes (S. Moshier)
+ * for SMATH_ACCURACY_HIGH, and lower degree polynomials fitted on the
+ * same reduced ranges for SMATH_ACCURACY_FAST. The fast flag is a
+ * constant at every call, so each tier compiles to its own loop.
+ */
+
+#include "kernels.h"
+
+
+/** @brief Mask of the lanes that are not NaN. */
+#define SOA_ORDERED(a) SOA_EQ(a, a)
+
+/** @brief a with the sign of s. */
+#define SOA_COPYSIGN(a, s) SOA_OR(SOA_ANDNOT(SOA_SET1(-0.0f), a), SOA_AND(SOA_SET1(-0.0f), s))
+
+
+/** @brief Sine and cosine, quadrant reduction with x - j * pi / 2 in 3 parts (2 for the fast tier). */
+static inline SOA_F SOA_FN(soa_sincos)(SOA_F x, SOA_F *c, const int fast) {
+        SOA_I j = SOA_CVTI(SOA_MUL(x, SOA_SET1(0.636619772367581f)));
+        SOA_F fj = SOA_CVTF(j);
+
+        SOA_F r;
+        if (fast) {
+                r = SOA_FMADD(fj, SOA_SET1(-1.5703125f), x);
+                r = SOA_FMADD(fj, SOA_SET1(-4.83826794897e-4f), r);
+        } else {
+                r = SOA_FMADD(fj, SOA_SET1(-1.5703125f), x);
+                r = SOA_FMADD(fj, SOA_SET1(-4.837512969970703125e-4f), r);
+                r = SOA_FMADD(fj, SOA_SET1(-7.54978995489188216e-8f), r);
+        }
+
+        SOA_F z = SOA_MUL(r, r);
+        SOA_F s, k;
+
+        if (fast) {
+                s = SOA_FMADD(z, SOA_SET1(8.21185531e-3f), SOA_SET1(-1.6665731e-1f));
+                s = SOA_FMADD(SOA_MUL(s, z), r, r);
+
+                k = SOA_FMADD(z, SOA_SET1(4.0818138e-2f), SOA_SET1(-4.99934663e-1f));
+                k = SOA_FMADD(k, z, SOA_SET1(1.0f));
+        } else {
+                s = SOA_FMADD(z, SOA_SET1(-1.9515295891e-4f), SOA_SET1(8.3321608736e-3f));
+                s = SOA_FMADD(s, z, SOA_SET1(-1.6666654611e-1f));
+                s = SOA_FMADD(SOA_MUL(s, z), r, r);
+
+                k = SOA_FMADD(z, SOA_SET1(2.443315711809948e-5f), SOA_SET1(-1.388731625493765e-3f));
+                k = SOA_FMADD(k, z, SOA_SET1(4.166664568298827e-2f));
+                k = SOA_FMADD(SOA_MUL(k, z), z, SOA_FMADD(z, SOA_SET1(-0.5f), SOA_SET1(1.0f)));
+        }
+
+        // Odd quadrants swap sine and cosine, the sine is negative in quadrant 2 and 3, the cosine in 1 and 2.
+        SOA_M swap = SOA_ITEST(j, 1);
+        SOA_F sin_sign = SOA_CASTF(SOA_ISHL(SOA_IAND(j, SOA_ISET1(2)), 30));
+        SOA_F cos_sign = SOA_CASTF(SOA_ISHL(SOA_IAND(SOA_IADD(j, SOA_ISET1(1)), SOA_ISET1(2)), 30));
+
+        *c = SOA_XOR(SOA_SELECT(swap, s, k), cos_sign);
+        return SOA_XOR(SOA_SELECT(swap, k, s), sin_sign);
+}
+
+/** @brief Sine. */
+static inline SOA_F SOA_FN(soa_sin)(SOA_F x, const int fast) {
+        SOA_F c;
+        return SOA_FN(soa_sincos)(x, &c, fast);
+}
+
+/** @brief Cosine. */
+static inline SOA_F SOA_FN(soa_cos)(SOA_F x, const int fast) {
+        SOA_F c;
+        SOA_FN(soa_sincos)(x, &c, fast);
+        return c;
+}
+
+
+/**
+ * @brief atan2, atan of min / max of |y| and |x| on [0, 1], reduced once more to [0, tan(pi / 8)].
+ *
+ * Above tan(pi / 8) the argument is (min - max) / (min + max), one
+ * division less than (a - 1) / (a + 1) on the rounded a, scaled down
+ * where the sum could overflow. pi / 4 is added in two parts, the float
+ * of pi / 4 alone is off by 0.7 ulp of the results near pi / 8.
+ */
+static inline SOA_F SOA_FN(soa_atan2)(SOA_F y, SOA_F x, const int fast) {
+        SOA_F ax = SOA_ANDNOT(SOA_SET1(-0.0f), x);
+        SOA_F ay = SOA_ANDNOT(SOA_SET1(-0.0f), y);
+        SOA_F mx = SOA_MAX(ax, ay);
+        SOA_F mn = SOA_MIN(ax, ay);
+        SOA_F a = SOA_DIV(mn, mx);
+
+        // 0 / 0 and inf / inf.
+        a = SOA_SELECT(SOA_ORDERED(a), a, SOA_SELECT(SOA_EQ(mx, SOA_SET1(0.0f)), SOA_SET1(0.0f), SOA_SET1(1.0f)));
+
+        SOA_M big = SOA_LT(SOA_SET1(0.414213562373095f), a);
+        SOA_F s = SOA_SELECT(SOA_LT(SOA_SET1(8.50705917e37f), mx), SOA_SET1(0.25f), SOA_SET1(1.0f));
+        SOA_F d = SOA_DIV(SOA_MUL(SOA_SUB(mn, mx), s), SOA_FMADD(mn, s, SOA_MUL(mx, s)));
+        a = SOA_SELECT(big, SOA_SELECT(SOA_ORDERED(d), d, SOA_SET1(0.0f)), a);
+
+        SOA_F z = SOA_MUL(a, a);
+        SOA_F p;
+
+        if (fast) {
+                p = SOA_FMADD(z, SOA_SET1(1.78044962e-1f), SOA_SET1(-3.32870135e-1f));
+        } else {
+                p = SOA_FMADD(z, SOA_SET1(8.05374449538e-2f), SOA_SET1(-1.38776856032e-1f));
+                p = SOA_FMADD(p, z, SOA_SET1(1.99777106478e-1f));
+                p = SOA_FMADD(p, z, SOA_SET1(-3.33329491539e-1f));
+        }
+
+        SOA_F r = SOA_FMADD(SOA_MUL(p, z), a, a);
+        r = SOA_ADD(r, SOA_SELECT(big, SOA_SET1(-2.18556950e-8f), SOA_SET1(0.0f)));
+        r = SOA_ADD(r, SOA_SELECT(big, SOA_SET1(7.85398185e-1f), SOA_SET1(0.0f)));
+
+        // The sign bit of x, not x < 0, so atan2(+-0, -0) is +-pi as in libm.
+        r = SOA_SELECT(SOA_LT(ax, ay), SOA_SUB(SOA_SET1(1.570796326794897f), r), r);
+        r = SOA_SELECT(SOA_ITEST(SOA_CASTI(x), INT32_MIN), SOA_SUB(SOA_SET1(3.141592653589793f), r), r);
+        r = SOA_COPYSIGN(r, y);
+
+        r = SOA_SELECT(SOA_ORDERED(x), r, x);
+        return SOA_SELECT(SOA_ORDERED(y), r, y);
+}
+
+
+/** @brief e^x, x = n * ln(2) + r with |r| <= ln(2) / 2, the 2^n is applied in two halves so n = 128 and the denormals work. */
+static inline SOA_F SOA_FN(soa_exp)(SOA_F x, const int fast) {
+        SOA_F xc = SOA_MAX(SOA_MIN(x, SOA_SET1(89.0f)), SOA_SET1(-104.0f));
+
+        SOA_I n = SOA_CVTI(SOA_MUL(xc, SOA_SET1(1.44269504088896341f)));
+        SOA_F fn = SOA_CVTF(n);
+        SOA_F r = SOA_FMADD(fn, SOA_SET1(-0.693359375f), xc);
+        r = SOA_FMADD(fn, SOA_SET1(2.12194440e-4f), r);
+
+        SOA_F p;
+
+        if (fast) {
+                p = SOA_FMADD(r, SOA_SET1(4.17927997e-2f), SOA_SET1(1.67418989e-1f));
+                p = SOA_FMADD(p, r, SOA_SET1(4.99999926e-1f));
+        } else {
+                p = SOA_FMADD(r, SOA_SET1(1.9875691500e-4f), SOA_SET1(1.3981999507e-3f));
+                p = SOA_FMADD(p, r, SOA_SET1(8.3334519073e-3f));
+                p = SOA_FMADD(p, r, SOA_SET1(4.1665795894e-2f));
+                p = SOA_FMADD(p, r, SOA_SET1(1.6666665459e-1f));
+                p = SOA_FMADD(p, r, SOA_SET1(5.0000001201e-1f));
+        }
+
+        p = SOA_FMADD(SOA_MUL(p, r), r, SOA_ADD(r, SOA_SET1(1.0f)));
+
+        SOA_I h = SOA_ISRA(n, 1);
+        SOA_F s0 = SOA_CASTF(SOA_ISHL(SOA_IADD(h, SOA_ISET1(127)), 23));
+        SOA_F s1 = SOA_CASTF(SOA_ISHL(SOA_IADD(SOA_ISUB(n, h), SOA_ISET1(127)), 23));
+
+        return SOA_SELECT(SOA_ORDERED(x), SOA_MUL(SOA_MUL(p, s0), s1), x);
+}
+
+
+/** @brief Natural logarithm, x = m * 2^e with m in [sqrt(0.5), sqrt(2)), log(x) = log(m) + e * ln(2). */
+static inline SOA_F SOA_FN(soa_log)(SOA_F x, const int fast) {
+        // Denormals are scaled into the normal range first.
+        SOA_M tiny = SOA_LT(x, SOA_SET1(1.17549435e-38f));
+        SOA_F xs = SOA_SELECT(tiny, SOA_MUL(x, SOA_SET1(8388608.0f)), x);
+
+        SOA_F e = SOA_CVTF(SOA_ISUB(SOA_ISRA(SOA_CASTI(xs), 23), SOA_ISET1(126)));
+        e = SOA_SELECT(tiny, SOA_SUB(e, SOA_SET1(23.0f)), e);
+
+        SOA_F m = SOA_OR(SOA_AND(xs, SOA_CASTF(SOA_ISET1(0x007fffff))), SOA_SET1(0.5f));
+
+        SOA_M low = SOA_LT(m, SOA_SET1(0.707106781186547524f));
+        e = SOA_SELECT(low, SOA_SUB(e, SOA_SET1(1.0f)), e);
+        m = SOA_SUB(SOA_SELECT(low, SOA_ADD(m, m), m), SOA_SET1(1.0f));
+
+        SOA_F z = SOA_MUL(m, m);
+        SOA_F r;
+
+        if (fast) {
+                SOA_F p = SOA_FMADD(m, SOA_SET1(1.78489884e-1f), SOA_SET1(-2.6693454e-1f));
+                p = SOA_FMADD(p, m, SOA_SET1(3.35261526e-1f));
+                p = SOA_FMADD(p, m, SOA_SET1(-4.99776211e-1f));
+                r = SOA_FMADD(p, z, m);
+                r = SOA_FMADD(e, SOA_SET1(0.693147180559945f), r);
+        } else {
+                SOA_F p = SOA_FMADD(m, SOA_SET1(7.0376836292e-2f), SOA_SET1(-1.1514610310e-1f));
+                p = SOA_FMADD(p, m, SOA_SET1(1.1676998740e-1f));
+                p = SOA_FMADD(p, m, SOA_SET1(-1.2420140846e-1f));
+                p = SOA_FMADD(p, m, SOA_SET1(1.4249322787e-1f));
+                p = SOA_FMADD(p, m, SOA_SET1(-1.6668057665e-1f));
+                p = SOA_FMADD(p, m, SOA_SET1(2.0000714765e-1f));
+                p = SOA_FMADD(p, m, SOA_SET1(-2.4999993993e-1f));
+                p = SOA_FMADD(p, m, SOA_SET1(3.3333331174e-1f));
+
+                SOA_F y = SOA_MUL(SOA_MUL(p, m), z);
+                y = SOA_FMADD(e, SOA_SET1(-2.12194440e-4f), y);
+                y = SOA_FMADD(z, SOA_SET1(-0.5f), y);
+                r = SOA_FMADD(e, SOA_SET1(0.693359375f), SOA_ADD(m, y));
+        }
+
+        r = SOA_SELECT(SOA_LT(x, SOA_SET1(0.0f)), SOA_SET1(NAN), r);
+        r = SOA_SELECT(SOA_EQ(x, SOA_SET1(0.0f)), SOA_SET1(-INFINITY), r);
+        r = SOA_SELECT(SOA_EQ(x, SOA_SET1(INFINITY)), x, r);
+        return SOA_SELECT(SOA_ORDERED(x), r, x);
+}
+
+
+/** @brief x^y as e^(y * log(x)), for x >= 0. */
+static inline SOA_F SOA_FN(soa_pow)(SOA_F x, SOA_F y, const int fast) {
+        SOA_F r = SOA_FN(soa_exp)(SOA_MUL(y, SOA_FN(soa_log)(x, fast)), fast);
+
+        // x^0 and 1^y are 1 even for NaN.
+        SOA_F one = SOA_SET1(1.0f);
+        r = SOA_SELECT(SOA_EQ(y, SOA_SET1(0.0f)), one, r);
+        return SOA_SELECT(SOA_EQ(x, one), one, r);
+}
+
+
+/*
+ * The array kernels. The last n % SOA_W elements go through a zero
+ * padded register, so nothing is read or written past the arrays.
+ */
+
+#define SOA_MATH_MAP1(dest, x, n, expr) do { \
+        size_t i_ = 0; \
+        for (; i_ + SOA_W <= (n); i_ += SOA_W) { \
+                SOA_F a = SOA_LOAD((x) + i_); \
+                SOA_STORE((dest) + i_, expr); \
+        } \
+        if (i_ < (n)) { \
+                f32 in_[SOA_W] = {0}, out_[SOA_W]; \
+                for (size_t j_ = 0; i_ + j_ < (n); ++j_) \
+                        in_[j_] = (x)[i_ + j_]; \
+                SOA_F a = SOA_LOAD(in_); \
+                SOA_STORE(out_, expr); \
+                for (size_t j_ = 0; i_ + j_ < (n); ++j_) \
+                        (dest)[i_ + j_] = out_[j_]; \
+        } \
+} while (0)
+
+#define SOA_MATH_MAP2(dest, x, y, n, expr) do { \
+        size_t i_ = 0; \
+        for (; i_ + SOA_W <= (n); i_ += SOA_W) { \
+                SOA_F a = SOA_LOAD((x) + i_); \
+                SOA_F b = SOA_LOAD((y) + i_); \
+                SOA_STORE((dest) + i_, expr); \
+        } \
+        if (i_ < (n)) { \
+                f32 in_[SOA_W] = {0}, in1_[SOA_W] = {0}, out_[SOA_W]; \
+                for (size_t j_ = 0; i_ + j_ < (n); ++j_) { \
+                        in_[j_] = (x)[i_ + j_]; \
+                        in1_[j_] = (y)[i_ + j_]; \
+                } \
+                SOA_F a = SOA_LOAD(in_); \
+                SOA_F b = SOA_LOAD(in1_); \
+                SOA_STORE(out_, expr); \
+                for (size_t j_ = 0; i_ + j_ < (n); ++j_) \
+                        (dest)[i_ + j_] = out_[j_]; \
+        } \
+} while (0)
+
+
+/** @brief Sine of every element. */
+static void SOA_FN(smath_sin_array)(f32 *dest, const f32 *x, size_t n, smath_accuracy acc) {
+        if (acc == SMATH_ACCURACY_FAST)
+                SOA_MATH_MAP1(dest, x, n, SOA_FN(soa_sin)(a, 1));
+        else
+                SOA_MATH_MAP1(dest, x, n, SOA_FN(soa_sin)(a, 0));
+}
+
+/** @brief Cosine of every element. */
+static void SOA_FN(smath_cos_array)(f32 *dest, const f32 *x, size_t n, smath_accuracy acc) {
+        if (acc == SMATH_ACCURACY_FAST)
+                SOA_MATH_MAP1(dest, x, n, SOA_FN(soa_cos)(a, 1));
+        else
+                SOA_MATH_MAP1(dest, x, n, SOA_FN(soa_cos)(a, 0));
+}
+
+/** @brief Sine and cosine of every element, one reduction for both. */
+static void SOA_FN(smath_sincos_array)(f32 *dest_sin, f32 *dest_cos, const f32 *x, size_t n, smath_accuracy acc) {
+        const int fast = acc == SMATH_ACCURACY_FAST;
+        size_t i = 0;
+
+        for (; i + SOA_W <= n; i += SOA_W) {
+                SOA_F c;
+                SOA_F s = fast ? SOA_FN(soa_sincos)(SOA_LOAD(x + i), &c, 1)
+                               : SOA_FN(soa_sincos)(SOA_LOAD(x + i), &c, 0);
+                SOA_STORE(dest_sin + i, s);
+                SOA_STORE(dest_cos + i, c);
+        }
+
+        if (i < n) {
+                f32 in[SOA_W] = {0}, out_sin[SOA_W], out_cos[SOA_W];
+
+                for (size_t j = 0; i + j < n; ++j)
+                        in[j] = x[i + j];
+
+                SOA_F c;
+                SOA_STORE(out_sin, SOA_FN(soa_sincos)(SOA_LOAD(in), &c, fast));
+                SOA_STORE(out_cos, c);
+
+                for (size_t j = 0; i + j < n; ++j) {
+                        dest_sin[i + j] = out_sin[j];
+                        dest_cos[i + j] = out_cos[j];
+                }
+        }
+}
+
+/** @brief atan2 of every pair. */
+static void SOA_FN(smath_atan2_array)(f32 *dest, const f32 *y, const f32 *x, size_t n, smath_accuracy acc) {
+        if (acc == SMATH_ACCURACY_FAST)
+                SOA_MATH_MAP2(dest, y, x, n, SOA_FN(soa_atan2)(a, b, 1));
+        else
+                SOA_MATH_MAP2(dest, y, x, n, SOA_FN(soa_atan2)(a, b, 0));
+}
+
+/** @brief e^x of every element. */
+static void SOA_FN(smath_exp_array)(f32 *dest, const f32 *x, size_t n, smath_accuracy acc) {
+        if (acc == SMATH_ACCURACY_FAST)
+                SOA_MATH_MAP1(dest, x, n, SOA_FN(soa_exp)(a, 1));
+        else
+                SOA_MATH_MAP1(dest, x, n, SOA_FN(soa_exp)(a, 0));
+}
+
+/** @brief Natural logarithm of every element. */
+static void SOA_FN(smath_log_array)(f32 *dest, const f32 *x, size_t n, smath_accuracy acc) {
+        if (acc == SMATH_ACCURACY_FAST)
+                SOA_MATH_MAP1(dest, x, n, SOA_FN(soa_log)(a, 1));
+        else
+                SOA_MATH_MAP1(dest, x, n, SOA_FN(soa_log)(a, 0));
+}
+
+/** @brief x^y of every pair. */
+static void SOA_FN(smath_pow_array)(f32 *dest, const f32 *x, const f32 *y, size_t n, smath_accuracy acc) {
+        if (acc == SMATH_ACCURACY_FAST)
+                SOA_MATH_MAP2(dest, x, y, n, SOA_FN(soa_pow)(a, b, 1));
+        else
+                SOA_MATH_MAP2(dest, x, y, n, SOA_FN(soa_pow)(a, b, 0));
+}
+
+#undef SOA_MATH_MAP1
+#undef SOA_MATH_MAP2
+
+
+/** @brief Put the transcendental kernels into the table. */
+static void SOA_FN(smath_kernels_bind_math)(smath_kernels *k) {
+        k->sin_array = SOA_FN(smath_sin_array);
+        k->cos_array = SOA_FN(smath_cos_array);
+        k->sincos_array = SOA_FN(smath_sincos_array);
+        k->atan2_array = SOA_FN(smath_atan2_array);
+        k->exp_array = SOA_FN(smath_exp_array);
+        k->log_array = SOA_FN(smath_log_array);
+        k->pow_array = SOA_FN(smath_pow_array);
+}
+
+
+#ifdef SOA_LANE_FN
+
+/** @brief Register version of the sine, SMATH_ACCURACY_HIGH. */
+SOA_F SOA_LANE_FN(smath_sin)(SOA_F x) {
+        return SOA_FN(soa_sin)(x, 0);
+}
+
+/** @brief Register version of the sine, SMATH_ACCURACY_FAST. */
+SOA_F SOA_LANE_FN(smath_sin_fast)(SOA_F x) {
+        return SOA_FN(soa_sin)(x, 1);
+}
+
+/** @brief Register version of the cosine, SMATH_ACCURACY_HIGH. */
+SOA_F SOA_LANE_FN(smath_cos)(SOA_F x) {
+        return SOA_FN(soa_cos)(x, 0);
+}
+
+/** @brief Register version of the cosine, SMATH_ACCURACY_FAST. */
+SOA_F SOA_LANE_FN(smath_cos_fast)(SOA_F x) {
+        return SOA_FN(soa_cos)(x, 1);
+}
+
+/** @brief Register version of the sine, the cosine is written to c, SMATH_ACCURACY_HIGH. */
+SOA_F SOA_LANE_FN(smath_sincos)(SOA_F x, SOA_F *c) {
+        return SOA_FN(soa_sincos)(x, c, 0);
+}
+
+/** @brief Register version of the sine, the cosine is written to c, SMATH_ACCURACY_FAST. */
+SOA_F SOA_LANE_FN(smath_sincos_fast)(SOA_F x, SOA_F *c) {
+        return SOA_FN(soa_sincos)(x, c, 1);
+}
+
+/** @brief Register version of atan2(y, x), SMATH_ACCURACY_HIGH. */
+SOA_F SOA_LANE_FN(smath_atan2)(SOA_F y, SOA_F x) {
+        return SOA_FN(soa_atan2)(y, x, 0);
+}
+
+/** @brief Register version of atan2(y, x), SMATH_ACCURACY_FAST. */
+SOA_F SOA_LANE_FN(smath_atan2_fast)(SOA_F y, SOA_F x) {
+        return SOA_FN(soa_atan2)(y, x, 1);
+}
+
+/** @brief Register version of e^x, SMATH_ACCURACY_HIGH. */
+SOA_F SOA_LANE_FN(smath_exp)(SOA_F x) {
+        return SOA_FN(soa_exp)(x, 0);
+}
+
+/** @brief Register version of e^x, SMATH_ACCURACY_FAST. */
+SOA_F SOA_LANE_FN(smath_exp_fast)(SOA_F x) {
+        return SOA_FN(soa_exp)(x, 1);
+}
+
+/** @brief Register version of the natural logarithm, SMATH_ACCURACY_HIGH. */
+SOA_F SOA_LANE_FN(smath_log)(SOA_F x) {
+        return SOA_FN(soa_log)(x, 0);
+}
+
+/** @brief Register version of the natural logarithm, SMATH_ACCURACY_FAST. */
+SOA_F SOA_LANE_FN(smath_log_fast)(SOA_F x) {
+        return SOA_FN(soa_log)(x, 1);
+}
+
+/** @brief Register version of x^y, SMATH_ACCURACY_HIGH. */
+SOA_F SOA_LANE_FN(smath_pow)(SOA_F x, SOA_F y) {
+        return SOA_FN(soa_pow)(x, y, 0);
+}
+
+/** @brief Register version of x^y, SMATH_ACCURACY_FAST. */
+SOA_F SOA_LANE_FN(smath_pow_fast)(SOA_F x, SOA_F y) {
+        return SOA_FN(soa_pow)(x, y, 1);
+}
+
+#endif // SOA_LANE_FN
+
+#undef SOA_ORDERED
+#undef SOA_COPYSIGN
@@ -0,0 +1,368 @@
+/*
+ * Private to the library, included by the kernels_<isa>.c files after
+ * kernels_math.h, with the macros of both still defined and:
+ *
+ *   SOA_ILOAD(p), SOA_ISTORE(p, i)        SOA_W int32 from/to memory
+ *   SOA_ILOAD16(p), SOA_ISTORE16(p, i)    SOA_W 16-bit, zero extended / the low 16 bits
+ *   SOA_ILOAD8(p), SOA_ISTORE8(p, i)      SOA_W 8-bit, zero extended / the low 8 bits
+ *
+ * Optionally SOA_LOAD_F16(p) and SOA_STORE_F16(p, a) when the instruction
+ * set converts half floats itself, otherwise it is done with the integer
+ * operations. The packed side of every array can be any length, the
+ * last partial register goes through a padded copy. Same results as the
+ * single element functions of compress.c, which use the same operations.
+ */
+
+#include "kernels.h"
+
+
+#define SOA_IOR(a, b) SOA_CASTI(SOA_OR(SOA_CASTF(a), SOA_CASTF(b)))
+
+/** @brief round(clamp(a, -1, 1) * s), NaN becomes -s. */
+#define SOA_SNORM(a, s) SOA_CVTI(SOA_MUL(SOA_MIN(SOA_MAX(a, SOA_SET1(-1.0f)), SOA_SET1(1.0f)), SOA_SET1(s)))
+
+/** @brief round(clamp(a, 0, 1) * s), NaN becomes 0. */
+#define SOA_UNORM(a, s) SOA_CVTI(SOA_MUL(SOA_MIN(SOA_MAX(a, SOA_SET1(0.0f)), SOA_SET1(1.0f)), SOA_SET1(s)))
+
+/** @brief max(i / s, -1) of a signed integer. */
+#define SOA_FROM_SNORM(i, s) SOA_MAX(SOA_MUL(SOA_CVTF(i), SOA_SET1(1.0f / (s))), SOA_SET1(-1.0f))
+
+/** @brief The signed field of bits at shift, sign extended. */
+#define SOA_IFIELD(i, bits, shift) SOA_ISRA(SOA_ISHL(i, 32 - (bits) - (shift)), 32 - (bits))
+
+
+/**
+ * @brief Float to half float bits (F. Giesen's float_to_half_fast3_rtne).
+ *
+ * Subnormal halves come from a float addition that rounds the mantissa
+ * into place, normal ones get the exponent rebiased and are rounded to
+ * nearest even by hand.
+ */
+static inline SOA_I SOA_FN(soa_to_f16)(SOA_F f) {
+        SOA_F sign = SOA_AND(f, SOA_SET1(-0.0f));
+        SOA_F a = SOA_XOR(f, sign);
+        SOA_I ai = SOA_CASTI(a);
+
+        SOA_F magic = SOA_CASTF(SOA_ISET1(((127 - 15) + (23 - 10) + 1) << 23));
+        SOA_I sub = SOA_ISUB(SOA_CASTI(SOA_ADD(a, magic)), SOA_CASTI(magic));
+
+        SOA_I odd = SOA_IAND(SOA_ISRA(ai, 13), SOA_ISET1(1));
+        SOA_I norm = SOA_ISRA(SOA_IADD(SOA_IADD(ai, SOA_ISET1(-(112 << 23) + 0xFFF)), odd), 13);
+
+        // Infinity, NaN stays a quiet NaN.
+        SOA_F big = SOA_SELECT(SOA_EQ(a, a), SOA_CASTF(SOA_ISET1(0x7C00)), SOA_CASTF(SOA_ISET1(0x7E00)));
+
+        SOA_F h = SOA_SELECT(SOA_LT(a, SOA_CASTF(SOA_ISET1(113 << 23))), SOA_CASTF(sub), SOA_CASTF(norm));
+        h = SOA_SELECT(SOA_LT(a, SOA_CASTF(SOA_ISET1((127 + 16) << 23))), h, big);
+
+        return SOA_IOR(SOA_CASTI(h), SOA_IAND(SOA_ISRA(SOA_CASTI(sign), 16), SOA_ISET1(0x8000)));
+}
+
+/** @brief Half float bits to float (F. Giesen's half_to_float_fast), subnormals are scaled with a float subtraction. */
+static inline SOA_F SOA_FN(soa_from_f16)(SOA_I h) {
+        SOA_I o = SOA_ISHL(SOA_IAND(h, SOA_ISET1(0x7FFF)), 13);
+        SOA_F e = SOA_CASTF(SOA_IAND(o, SOA_ISET1(0x7C00 << 13)));
+        o = SOA_IADD(o, SOA_ISET1((127 - 15) << 23));
+
+        SOA_F inf = SOA_CASTF(SOA_IADD(o, SOA_ISET1((128 - 16) << 23)));
+        SOA_F sub = SOA_SUB(SOA_CASTF(SOA_IADD(o, SOA_ISET1(1 << 23))), SOA_CASTF(SOA_ISET1(113 << 23)));
+
+        SOA_F f = SOA_SELECT(SOA_EQ(e, SOA_CASTF(SOA_ISET1(0x7C00 << 13))), inf, SOA_CASTF(o));
+        f = SOA_SELECT(SOA_EQ(e, SOA_SET1(0.0f)), sub, f);
+
+        return SOA_OR(f, SOA_CASTF(SOA_ISHL(SOA_IAND(h, SOA_ISET1(0x8000)), 16)));
+}
+
+#ifndef SOA_STORE_F16
+#define SOA_STORE_F16(p, a) SOA_ISTORE16(p, SOA_FN(soa_to_f16)(a))
+#define SOA_LOAD_F16(p) SOA_FN(soa_from_f16)(SOA_ILOAD16(p))
+#endif
+
+
+/** @brief Run store on every register of src with a pointing at the floats and p into dest. */
+#define SOA_PACK_MAP(type, dest, src, n, store) do { \
+        type *d_ = (type*)(dest); \
+        size_t i_ = 0; \
+        for (; i_ + SOA_W <= (n); i_ += SOA_W) { \
+                SOA_F a = SOA_LOAD((src) + i_); \
+                type *p = d_ + i_; \
+                store; \
+        } \
+        if (i_ < (n)) { \
+                f32 in_[SOA_W] = {0}; \
+                type out_[SOA_W]; \
+                for (size_t j_ = 0; i_ + j_ < (n); ++j_) \
+                        in_[j_] = (src)[i_ + j_]; \
+                SOA_F a = SOA_LOAD(in_); \
+                type *p = out_; \
+                store; \
+                for (size_t j_ = 0; i_ + j_ < (n); ++j_) \
+                        d_[i_ + j_] = out_[j_]; \
+        } \
+} while (0)
+
+/** @brief Store expr for every register of src, with p pointing into src. */
+#define SOA_UNPACK_MAP(type, dest, src, n, expr) do { \
+        const type *s_ = (const type*)(src); \
+        size_t i_ = 0; \
+        for (; i_ + SOA_W <= (n); i_ += SOA_W) { \
+                const type *p = s_ + i_; \
+                SOA_STORE((dest) + i_, expr); \
+        } \
+        if (i_ < (n)) { \
+                type in_[SOA_W] = {0}; \
+                f32 out_[SOA_W]; \
+                for (size_t j_ = 0; i_ + j_ < (n); ++j_) \
+                        in_[j_] = s_[i_ + j_]; \
+                const type *p = in_; \
+                SOA_STORE(out_, expr); \
+                for (size_t j_ = 0; i_ + j_ < (n); ++j_) \
+                        (dest)[i_ + j_] = out_[j_]; \
+        } \
+} while (0)
+
+
+/** @brief Pack every float, one loop per format. */
+static void SOA_FN(smath_pack_array)(void *dest, const f32 *src, size_t n, smath_pack_format fmt) {
+        switch (fmt) {
+        case SMATH_PACK_F16:
+                SOA_PACK_MAP(u16, dest, src, n, SOA_STORE_F16(p, a));
+                break;
+        case SMATH_PACK_SNORM16:
+                SOA_PACK_MAP(i16, dest, src, n, SOA_ISTORE16(p, SOA_SNORM(a, 32767.0f)));
+                break;
+        case SMATH_PACK_UNORM16:
+                SOA_PACK_MAP(u16, dest, src, n, SOA_ISTORE16(p, SOA_UNORM(a, 65535.0f)));
+                break;
+        case SMATH_PACK_SNORM8:
+                SOA_PACK_MAP(i8, dest, src, n, SOA_ISTORE8(p, SOA_SNORM(a, 127.0f)));
+                break;
+        case SMATH_PACK_UNORM8:
+                SOA_PACK_MAP(u8, dest, src, n, SOA_ISTORE8(p, SOA_UNORM(a, 255.0f)));
+                break;
+        }
+}
+
+/** @brief Unpack every element, one loop per format. */
+static void SOA_FN(smath_unpack_array)(f32 *dest, const void *src, size_t n, smath_pack_format fmt) {
+        switch (fmt) {
+        case SMATH_PACK_F16:
+                SOA_UNPACK_MAP(u16, dest, src, n, SOA_LOAD_F16(p));
+                break;
+        case SMATH_PACK_SNORM16:
+                SOA_UNPACK_MAP(i16, dest, src, n, SOA_FROM_SNORM(SOA_IFIELD(SOA_ILOAD16(p), 16, 0), 32767.0f));
+                break;
+        case SMATH_PACK_UNORM16:
+                SOA_UNPACK_MAP(u16, dest, src, n, SOA_MUL(SOA_CVTF(SOA_ILOAD16(p)), SOA_SET1(1.0f / 65535.0f)));
+                break;
+        case SMATH_PACK_SNORM8:
+                SOA_UNPACK_MAP(i8, dest, src, n, SOA_FROM_SNORM(SOA_IFIELD(SOA_ILOAD8(p), 8, 0), 127.0f));
+                break;
+        case SMATH_PACK_UNORM8:
+                SOA_UNPACK_MAP(u8, dest, src, n, SOA_MUL(SOA_CVTF(SOA_ILOAD8(p)), SOA_SET1(1.0f / 255.0f)));
+                break;
+        }
+}
+
+
+/** @brief Store block(i), the packed register of the vectors at i, for every register of a structure of arrays. */
+#define SOA_PACK_SOA(dest, count, block) do { \
+        size_t i_ = 0; \
+        for (; i_ + SOA_W <= (count); i_ += SOA_W) \
+                SOA_ISTORE((dest) + i_, block(i_)); \
+        if (i_ < (count)) { \
+                u32 out_[SOA_W]; \
+                SOA_ISTORE(out_, block(i_)); \
+                for (size_t j_ = 0; i_ + j_ < (count); ++j_) \
+                        (dest)[i_ + j_] = out_[j_]; \
+        } \
+} while (0)
+
+/** @brief Run block(i, packed) on every register of src, the structure of arrays is written into its padding. */
+#define SOA_UNPACK_SOA(src, n, block) do { \
+        size_t i_ = 0; \
+        for (; i_ + SOA_W <= (n); i_ += SOA_W) \
+                block(i_, SOA_ILOAD((src) + i_)); \
+        if (i_ < (n)) { \
+                u32 in_[SOA_W] = {0}; \
+                for (size_t j_ = 0; i_ + j_ < (n); ++j_) \
+                        in_[j_] = (src)[i_ + j_]; \
+                block(i_, SOA_ILOAD(in_)); \
+        } \
+} while (0)
+
+
+/** @brief x, y, z as snorm10 and w as snorm2. */
+static inline SOA_I SOA_FN(soa_pack_10_10_10_2)(SOA_F x, SOA_F y, SOA_F z, SOA_F w) {
+        SOA_I m = SOA_ISET1(0x3FF);
+        SOA_I p = SOA_IAND(SOA_SNORM(x, 511.0f), m);
+        p = SOA_IOR(p, SOA_ISHL(SOA_IAND(SOA_SNORM(y, 511.0f), m), 10));
+        p = SOA_IOR(p, SOA_ISHL(SOA_IAND(SOA_SNORM(z, 511.0f), m), 20));
+        return SOA_IOR(p, SOA_ISHL(SOA_SNORM(w, 1.0f), 30));
+}
+
+static void SOA_FN(vec4_soa_pack_10_10_10_2)(u32 *dest, const vec4_soa *v) {
+#define SOA_BLOCK(i) SOA_FN(soa_pack_10_10_10_2)(SOA_LOAD(v->x + (i)), SOA_LOAD(v->y + (i)), \
+                                                 SOA_LOAD(v->z + (i)), SOA_LOAD(v->w + (i)))
+        SOA_PACK_SOA(dest, v->count, SOA_BLOCK);
+#undef SOA_BLOCK
+}
+
+static inline void SOA_FN(soa_unpack_10_10_10_2)(vec4_soa *dest, size_t i, SOA_I p) {
+        SOA_STORE(dest->x + i, SOA_FROM_SNORM(SOA_IFIELD(p, 10, 0), 511.0f));
+        SOA_STORE(dest->y + i, SOA_FROM_SNORM(SOA_IFIELD(p, 10, 10), 511.0f));
+        SOA_STORE(dest->z + i, SOA_FROM_SNORM(SOA_IFIELD(p, 10, 20), 511.0f));
+        SOA_STORE(dest->w + i, SOA_FROM_SNORM(SOA_ISRA(p, 30), 1.0f));
+}
+
+static void SOA_FN(vec4_soa_unpack_10_10_10_2)(vec4_soa *dest, const u32 *src, size_t n) {
+#define SOA_BLOCK(i, p) SOA_FN(soa_unpack_10_10_10_2)(dest, i, p)
+        SOA_UNPACK_SOA(src, n, SOA_BLOCK);
+#undef SOA_BLOCK
+}
+
+
+/** @brief Project on the octahedron, fold the lower half with (1 - |v|, 1 - |u|) and the signs of (u, v). */
+static inline SOA_I SOA_FN(soa_encode_octahedral)(SOA_F x, SOA_F y, SOA_F z) {
+        SOA_F abs_mask = SOA_SET1(-0.0f);
+        SOA_F l = SOA_ADD(SOA_ADD(SOA_ANDNOT(abs_mask, x), SOA_ANDNOT(abs_mask, y)), SOA_ANDNOT(abs_mask, z));
+        SOA_F s = SOA_DIV(SOA_SET1(1.0f), SOA_MAX(l, SOA_SET1(1e-30f)));
+        SOA_F u = SOA_MUL(x, s);
+        SOA_F v = SOA_MUL(y, s);
+
+        SOA_F fu = SOA_MUL(SOA_SUB(SOA_SET1(1.0f), SOA_ANDNOT(abs_mask, v)), SOA_COPYSIGN1(u));
+        SOA_F fv = SOA_MUL(SOA_SUB(SOA_SET1(1.0f), SOA_ANDNOT(abs_mask, u)), SOA_COPYSIGN1(v));
+        SOA_M lower = SOA_LT(z, SOA_SET1(0.0f));
+        u = SOA_SELECT(lower, fu, u);
+        v = SOA_SELECT(lower, fv, v);
+
+        return SOA_IOR(SOA_IAND(SOA_SNORM(u, 32767.0f), SOA_ISET1(0xFFFF)), SOA_ISHL(SOA_SNORM(v, 32767.0f), 16));
+}
+
+static void SOA_FN(vec3_soa_encode_octahedral)(u32 *dest, const vec3_soa *v) {
+#define SOA_BLOCK(i) SOA_FN(soa_encode_octahedral)(SOA_LOAD(v->x + (i)), SOA_LOAD(v->y + (i)), SOA_LOAD(v->z + (i)))
+        SOA_PACK_SOA(dest, v->count, SOA_BLOCK);
+#undef SOA_BLOCK
+}
+
+/** @brief z = 1 - |u| - |v|, the folded half (z < 0) moves x and y back by -z towards the axes. */
+static inline void SOA_FN(soa_decode_octahedral)(vec3_soa *dest, size_t i, SOA_I p) {
+        SOA_F abs_mask = SOA_SET1(-0.0f);
+        SOA_F u = SOA_FROM_SNORM(SOA_IFIELD(p, 16, 0), 32767.0f);
+        SOA_F v = SOA_FROM_SNORM(SOA_ISRA(p, 16), 32767.0f);
+        SOA_F z = SOA_SUB(SOA_SUB(SOA_SET1(1.0f), SOA_ANDNOT(abs_mask, u)), SOA_ANDNOT(abs_mask, v));
+        SOA_F t = SOA_MAX(SOA_SUB(SOA_SET1(0.0f), z), SOA_SET1(0.0f));
+        SOA_F x = SOA_SUB(u, SOA_MUL(SOA_COPYSIGN1(u), t));
+        SOA_F y = SOA_SUB(v, SOA_MUL(SOA_COPYSIGN1(v), t));
+
+        SOA_F l = SOA_ADD(SOA_ADD(SOA_MUL(x, x), SOA_MUL(y, y)), SOA_MUL(z, z));
+        l = SOA_DIV(SOA_SET1(1.0f), SOA_SQRT(l));
+
+        SOA_STORE(dest->x + i, SOA_MUL(x, l));
+        SOA_STORE(dest->y + i, SOA_MUL(y, l));
+        SOA_STORE(dest->z + i, SOA_MUL(z, l));
+}
+
+static void SOA_FN(vec3_soa_decode_octahedral)(vec3_soa *dest, const u32 *src, size_t n) {
+#define SOA_BLOCK(i, p) SOA_FN(soa_decode_octahedral)(dest, i, p)
+        SOA_UNPACK_SOA(src, n, SOA_BLOCK);
+#undef SOA_BLOCK
+}
+
+
+/**
+ * @brief Leave out the largest component, the first one on a tie.
+ *
+ * The other three keep their order, so with the index k of the largest
+ * they are (x or y), (y or z) and (z or w), picked by k > 0, k > 1 and
+ * k > 2.
+ */
+static inline SOA_I SOA_FN(soa_pack_smallest3)(SOA_F x, SOA_F y, SOA_F z, SOA_F w) {
+        SOA_F abs_mask = SOA_SET1(-0.0f);
+        SOA_F m = SOA_ANDNOT(abs_mask, x);
+        SOA_F big = x;
+        SOA_F k = SOA_SET1(0.0f);
+
+        SOA_M gt = SOA_LT(m, SOA_ANDNOT(abs_mask, y));
+        m = SOA_SELECT(gt, SOA_ANDNOT(abs_mask, y), m);
+        big = SOA_SELECT(gt, y, big);
+        k = SOA_SELECT(gt, SOA_SET1(1.0f), k);
+
+        gt = SOA_LT(m, SOA_ANDNOT(abs_mask, z));
+        m = SOA_SELECT(gt, SOA_ANDNOT(abs_mask, z), m);
+        big = SOA_SELECT(gt, z, big);
+        k = SOA_SELECT(gt, SOA_SET1(2.0f), k);
+
+        gt = SOA_LT(m, SOA_ANDNOT(abs_mask, w));
+        big = SOA_SELECT(gt, w, big);
+        k = SOA_SELECT(gt, SOA_SET1(3.0f), k);
+
+        SOA_F s = SOA_MUL(SOA_COPYSIGN1(big), SOA_SET1(1.0f / SMATH_SMALLEST3_MAX));
+        SOA_F a = SOA_SELECT(SOA_LT(SOA_SET1(0.5f), k), x, y);
+        SOA_F b = SOA_SELECT(SOA_LT(SOA_SET1(1.5f), k), y, z);
+        SOA_F c = SOA_SELECT(SOA_LT(SOA_SET1(2.5f), k), z, w);
+
+        SOA_I mask = SOA_ISET1(0x3FF);
+        SOA_I p = SOA_IAND(SOA_SNORM(SOA_MUL(a, s), 511.0f), mask);
+        p = SOA_IOR(p, SOA_ISHL(SOA_IAND(SOA_SNORM(SOA_MUL(b, s), 511.0f), mask), 10));
+        p = SOA_IOR(p, SOA_ISHL(SOA_IAND(SOA_SNORM(SOA_MUL(c, s), 511.0f), mask), 20));
+        return SOA_IOR(p, SOA_ISHL(SOA_CVTI(k), 30));
+}
+
+static void SOA_FN(quat_soa_pack_smallest3)(u32 *dest, const vec4_soa *q) {
+#define SOA_BLOCK(i) SOA_FN(soa_pack_smallest3)(SOA_LOAD(q->x + (i)), SOA_LOAD(q->y + (i)), \
+                                                SOA_LOAD(q->z + (i)), SOA_LOAD(q->w + (i)))
+        SOA_PACK_SOA(dest, q->count, SOA_BLOCK);
+#undef SOA_BLOCK
+}
+
+/** @brief The left out component is sqrt(1 - a^2 - b^2 - c^2), put back at its index. */
+static inline void SOA_FN(soa_unpack_smallest3)(vec4_soa *dest, size_t i, SOA_I p) {
+        SOA_F s = SOA_SET1(SMATH_SMALLEST3_MAX);
+        SOA_F a = SOA_MUL(SOA_FROM_SNORM(SOA_IFIELD(p, 10, 0), 511.0f), s);
+        SOA_F b = SOA_MUL(SOA_FROM_SNORM(SOA_IFIELD(p, 10, 10), 511.0f), s);
+        SOA_F c = SOA_MUL(SOA_FROM_SNORM(SOA_IFIELD(p, 10, 20), 511.0f), s);
+        SOA_F k = SOA_CVTF(SOA_IAND(SOA_ISRA(p, 30), SOA_ISET1(3)));
+
+        SOA_F d = SOA_SUB(SOA_SUB(SOA_SUB(SOA_SET1(1.0f), SOA_MUL(a, a)), SOA_MUL(b, b)), SOA_MUL(c, c));
+        d = SOA_SQRT(SOA_MAX(d, SOA_SET1(0.0f)));
+
+        SOA_M k0 = SOA_LT(k, SOA_SET1(0.5f));
+        SOA_M k1 = SOA_LT(k, SOA_SET1(1.5f));
+        SOA_M k2 = SOA_LT(k, SOA_SET1(2.5f));
+
+        SOA_STORE(dest->x + i, SOA_SELECT(k0, d, a));
+        SOA_STORE(dest->y + i, SOA_SELECT(k0, a, SOA_SELECT(k1, d, b)));
+        SOA_STORE(dest->z + i, SOA_SELECT(k1, b, SOA_SELECT(k2, d, c)));
+        SOA_STORE(dest->w + i, SOA_SELECT(k2, c, d));
+}
+
+static void SOA_FN(quat_soa_unpack_smallest3)(vec4_soa *dest, const u32 *src, size_t n) {
+#define SOA_BLOCK(i, p) SOA_FN(soa_unpack_smallest3)(dest, i, p)
+        SOA_UNPACK_SOA(src, n, SOA_BLOCK);
+#undef SOA_BLOCK
+}
+
+
+static void SOA_FN(smath_kernels_bind_pack)(smath_kernels *k) {
+        k->pack_array = SOA_FN(smath_pack_array);
+        k->unpack_array = SOA_FN(smath_unpack_array);
+        k->vec4_soa_pack_10_10_10_2 = SOA_FN(vec4_soa_pack_10_10_10_2);
+        k->vec4_soa_unpack_10_10_10_2 = SOA_FN(vec4_soa_unpack_10_10_10_2);
+        k->vec3_soa_encode_octahedral = SOA_FN(vec3_soa_encode_octahedral);
+        k->vec3_soa_decode_octahedral = SOA_FN(vec3_soa_decode_octahedral);
+        k->quat_soa_pack_smallest3 = SOA_FN(quat_soa_pack_smallest3);
+        k->quat_soa_unpack_smallest3 = SOA_FN(quat_soa_unpack_smallest3);
+}
+
+#undef SOA_IOR
+#undef SOA_SNORM
+#undef SOA_UNORM
+#undef SOA_FROM_SNORM
+#undef SOA_IFIELD
+#undef SOA_PACK_MAP
+#undef SOA_UNPACK_MAP
+#undef SOA_PACK_SOA
+#undef SOA_UNPACK_SOA
+#undef SOA_STORE_F16
+#undef SOA_LOAD_F16
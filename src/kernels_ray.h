@@ -0,0 +1,325 @@
+/*
+ * Private to the library, included by the kernels_<isa>.c files after
+ * kernels_cull.h, with the macros of kernels_math.h and kernels_cull.h
+ * still defined.
+ *
+ * One ray against a structure of arrays has an object per lane and keeps
+ * the nearest hit of every lane with its index, the lanes are compared
+ * once at the end. A structure of arrays of rays against one object has a
+ * ray per lane, the hits are collected into a bitmask like the culling
+ * kernels. Every condition of a test is folded into the distance, a miss
+ * becomes INFINITY, so one compare with t_max decides the hit.
+ *
+ * The operations are the ones of the single ray tests in ray.c in the
+ * same order.
+ */
+
+#include <string.h>
+
+#include "kernels.h"
+
+
+/** @brief The lane numbers, the first SOA_W are loaded. */
+static const f32 SOA_FN(ray_lanes)[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+#define SOA_DOT3(ax, ay, az, bx, by, bz) SOA_FMADD(az, bz, SOA_FMADD(ay, by, SOA_MUL(ax, bx)))
+
+/** @brief INFINITY where m is set. */
+#define SOA_MISS(m, t) SOA_SELECT(m, SOA_SET1(INFINITY), t)
+
+
+/** @brief The nearest distance of every lane and the index of its object. */
+typedef struct SOA_FN(ray_nearest) {
+        SOA_F t;
+        SOA_F index;    // The bits of an i32, -1 without a hit
+        SOA_I lanes;
+} SOA_FN(ray_nearest);
+
+static inline void SOA_FN(ray_nearest_init)(SOA_FN(ray_nearest) *n, f32 t_max) {
+        n->t = SOA_SET1(t_max);
+        n->index = SOA_CASTF(SOA_ISET1(-1));
+        n->lanes = SOA_CVTI(SOA_LOAD(SOA_FN(ray_lanes)));
+}
+
+/**
+ * @brief Keep the distances of the objects [i, i + SOA_W) closer than the nearest one.
+ *
+ * The lanes past count are padding and miss. Within a lane the index
+ * grows, so the strict compare keeps the lowest index of equal distances.
+ */
+static inline void SOA_FN(ray_nearest_update)(SOA_FN(ray_nearest) *n, SOA_F t, size_t i, size_t count) {
+        t = SOA_MISS(SOA_LT(SOA_SET1((f32)(count - i) - 0.5f), SOA_LOAD(SOA_FN(ray_lanes))), t);
+
+        SOA_M closer = SOA_LT(t, n->t);
+        n->t = SOA_SELECT(closer, t, n->t);
+        n->index = SOA_SELECT(closer, SOA_CASTF(SOA_IADD(SOA_ISET1((i32)i), n->lanes)), n->index);
+}
+
+/** @brief The nearest hit of all lanes, the lowest index on a tie. */
+static inline bool SOA_FN(ray_nearest_result)(const SOA_FN(ray_nearest) *n, f32 *t, size_t *index) {
+        f32 lt[SOA_W], li[SOA_W];
+        SOA_STORE(lt, n->t);
+        SOA_STORE(li, n->index);
+
+        bool hit = false;
+        i32 best = 0;
+
+        for (int k = 0; k < SOA_W; ++k) {
+                i32 idx;
+                memcpy(&idx, &li[k], sizeof(idx));
+
+                if (idx < 0)
+                        continue;
+                if (!hit || lt[k] < *t || (lt[k] == *t && idx < best)) {
+                        *t = lt[k];
+                        best = idx;
+                        hit = true;
+                }
+        }
+
+        if (hit)
+                *index = (size_t)best;
+        return hit;
+}
+
+
+/** @brief Moller-Trumbore with a triangle per lane, see ray_intersect_triangle. */
+static bool SOA_FN(ray_intersect_triangles)(const ray *r, const triangle_soa *tris, f32 t_max, f32 *t, size_t *index) {
+        SOA_F ox = SOA_SET1(r->origin.x), oy = SOA_SET1(r->origin.y), oz = SOA_SET1(r->origin.z);
+        SOA_F dx = SOA_SET1(r->direction.x), dy = SOA_SET1(r->direction.y), dz = SOA_SET1(r->direction.z);
+        SOA_F zero = SOA_SET1(0.0f), one = SOA_SET1(1.0f);
+
+        SOA_FN(ray_nearest) n;
+        SOA_FN(ray_nearest_init)(&n, t_max);
+
+        size_t count = tris->v0.count;
+
+        for (size_t i = 0; i < count; i += SOA_W) {
+                SOA_F ax = SOA_LOAD(tris->v0.x + i), ay = SOA_LOAD(tris->v0.y + i), az = SOA_LOAD(tris->v0.z + i);
+                SOA_F e1x = SOA_SUB(SOA_LOAD(tris->v1.x + i), ax);
+                SOA_F e1y = SOA_SUB(SOA_LOAD(tris->v1.y + i), ay);
+                SOA_F e1z = SOA_SUB(SOA_LOAD(tris->v1.z + i), az);
+                SOA_F e2x = SOA_SUB(SOA_LOAD(tris->v2.x + i), ax);
+                SOA_F e2y = SOA_SUB(SOA_LOAD(tris->v2.y + i), ay);
+                SOA_F e2z = SOA_SUB(SOA_LOAD(tris->v2.z + i), az);
+
+                SOA_F px = SOA_SUB(SOA_MUL(dy, e2z), SOA_MUL(dz, e2y));
+                SOA_F py = SOA_SUB(SOA_MUL(dz, e2x), SOA_MUL(dx, e2z));
+                SOA_F pz = SOA_SUB(SOA_MUL(dx, e2y), SOA_MUL(dy, e2x));
+                SOA_F det = SOA_DOT3(e1x, e1y, e1z, px, py, pz);
+                SOA_F inv = SOA_DIV(one, det);
+
+                SOA_F sx = SOA_SUB(ox, ax), sy = SOA_SUB(oy, ay), sz = SOA_SUB(oz, az);
+                SOA_F qx = SOA_SUB(SOA_MUL(sy, e1z), SOA_MUL(sz, e1y));
+                SOA_F qy = SOA_SUB(SOA_MUL(sz, e1x), SOA_MUL(sx, e1z));
+                SOA_F qz = SOA_SUB(SOA_MUL(sx, e1y), SOA_MUL(sy, e1x));
+
+                SOA_F u = SOA_MUL(SOA_DOT3(sx, sy, sz, px, py, pz), inv);
+                SOA_F v = SOA_MUL(SOA_DOT3(dx, dy, dz, qx, qy, qz), inv);
+                SOA_F d = SOA_MUL(SOA_DOT3(e2x, e2y, e2z, qx, qy, qz), inv);
+
+                SOA_F m = SOA_MIN(SOA_MIN(u, v), SOA_MIN(SOA_SUB(one, SOA_ADD(u, v)), d));
+                d = SOA_MISS(SOA_LT(m, zero), d);
+                d = SOA_MISS(SOA_EQ(det, zero), d);
+
+                SOA_FN(ray_nearest_update)(&n, d, i, count);
+        }
+
+        return SOA_FN(ray_nearest_result)(&n, t, index);
+}
+
+/** @brief A sphere per lane, see ray_intersect_sphere. */
+static bool SOA_FN(ray_intersect_spheres)(const ray *r, const sphere_soa *s, f32 t_max, f32 *t, size_t *index) {
+        SOA_F ox = SOA_SET1(r->origin.x), oy = SOA_SET1(r->origin.y), oz = SOA_SET1(r->origin.z);
+        SOA_F dx = SOA_SET1(r->direction.x), dy = SOA_SET1(r->direction.y), dz = SOA_SET1(r->direction.z);
+        SOA_F a = SOA_SET1(r->direction.x * r->direction.x + r->direction.y * r->direction.y +
+                           r->direction.z * r->direction.z);
+        SOA_F zero = SOA_SET1(0.0f);
+
+        SOA_FN(ray_nearest) n;
+        SOA_FN(ray_nearest_init)(&n, t_max);
+
+        size_t count = s->count;
+
+        for (size_t i = 0; i < count; i += SOA_W) {
+                SOA_F cx = SOA_SUB(ox, SOA_LOAD(s->x + i));
+                SOA_F cy = SOA_SUB(oy, SOA_LOAD(s->y + i));
+                SOA_F cz = SOA_SUB(oz, SOA_LOAD(s->z + i));
+                SOA_F rad = SOA_LOAD(s->w + i);
+
+                SOA_F b = SOA_DOT3(cx, cy, cz, dx, dy, dz);
+                SOA_F c = SOA_SUB(SOA_DOT3(cx, cy, cz, cx, cy, cz), SOA_MUL(rad, rad));
+                SOA_F disc = SOA_SUB(SOA_MUL(b, b), SOA_MUL(a, c));
+                SOA_F sq = SOA_SQRT(disc);
+
+                SOA_F t0 = SOA_MAX(SOA_DIV(SOA_SUB(SOA_SUB(zero, b), sq), a), zero);
+                SOA_F t1 = SOA_DIV(SOA_SUB(sq, b), a);
+                t0 = SOA_MISS(SOA_LT(t1, zero), t0);
+                t0 = SOA_MISS(SOA_LT(disc, zero), t0);
+
+                SOA_FN(ray_nearest_update)(&n, t0, i, count);
+        }
+
+        return SOA_FN(ray_nearest_result)(&n, t, index);
+}
+
+/** @brief A box per lane, see ray_intersect_aabb. */
+static bool SOA_FN(ray_intersect_aabbs)(const ray *r, const aabb_soa *b, f32 t_max, f32 *t, size_t *index) {
+        SOA_F ox = SOA_SET1(r->origin.x), oy = SOA_SET1(r->origin.y), oz = SOA_SET1(r->origin.z);
+        SOA_F ix = SOA_SET1(1.0f / r->direction.x);
+        SOA_F iy = SOA_SET1(1.0f / r->direction.y);
+        SOA_F iz = SOA_SET1(1.0f / r->direction.z);
+        SOA_F zero = SOA_SET1(0.0f);
+
+        SOA_FN(ray_nearest) n;
+        SOA_FN(ray_nearest_init)(&n, t_max);
+
+        size_t count = b->min.count;
+
+        for (size_t i = 0; i < count; i += SOA_W) {
+                SOA_F x0 = SOA_MUL(SOA_SUB(SOA_LOAD(b->min.x + i), ox), ix);
+                SOA_F x1 = SOA_MUL(SOA_SUB(SOA_LOAD(b->max.x + i), ox), ix);
+                SOA_F y0 = SOA_MUL(SOA_SUB(SOA_LOAD(b->min.y + i), oy), iy);
+                SOA_F y1 = SOA_MUL(SOA_SUB(SOA_LOAD(b->max.y + i), oy), iy);
+                SOA_F z0 = SOA_MUL(SOA_SUB(SOA_LOAD(b->min.z + i), oz), iz);
+                SOA_F z1 = SOA_MUL(SOA_SUB(SOA_LOAD(b->max.z + i), oz), iz);
+
+                SOA_F t_near = SOA_MAX(SOA_MAX(SOA_MIN(x0, x1), SOA_MIN(y0, y1)), SOA_MAX(SOA_MIN(z0, z1), zero));
+                SOA_F t_far = SOA_MIN(SOA_MIN(SOA_MAX(x0, x1), SOA_MAX(y0, y1)), SOA_MAX(z0, z1));
+                t_near = SOA_MISS(SOA_LT(t_far, t_near), t_near);
+
+                SOA_FN(ray_nearest_update)(&n, t_near, i, count);
+        }
+
+        return SOA_FN(ray_nearest_result)(&n, t, index);
+}
+
+
+/**
+ * @brief Run a test over a structure of arrays of rays.
+ *
+ * TEST(i, d) computes the distances d of the rays [i, i + SOA_W) with
+ * INFINITY for a miss. A last partial register takes t_max from a copy
+ * padded with 0, so the rays past count miss, and t goes through a copy
+ * too.
+ */
+#define SOA_RAY_PACKET(count, t_max, t, hits, TEST) \
+        do { \
+                u32 bits = 0; \
+                for (size_t i = 0; i < (count); i += SOA_W) { \
+                        f32 tm[SOA_W] = { 0 }; \
+                        size_t left = (count) - i < SOA_W ? (count) - i : SOA_W; \
+                        const f32 *pm = (t_max) + i; \
+                        if (left < SOA_W) { \
+                                memcpy(tm, pm, left * sizeof(f32)); \
+                                pm = tm; \
+                        } \
+                        \
+                        SOA_F d; \
+                        TEST(i, d); \
+                        SOA_M hit = SOA_LT(d, SOA_LOAD(pm)); \
+                        \
+                        if (t) { \
+                                d = SOA_SELECT(hit, d, SOA_SET1(INFINITY)); \
+                                if (left < SOA_W) { \
+                                        SOA_STORE(tm, d); \
+                                        memcpy((t) + i, tm, left * sizeof(f32)); \
+                                } else { \
+                                        SOA_STORE((t) + i, d); \
+                                } \
+                        } \
+                        bits |= (u32)SOA_MOVEMASK(hit) << (i & 31); \
+                        if (((i + SOA_W) & 31) == 0 || i + SOA_W >= (count)) { \
+                                (hits)[i / 32] = bits; \
+                                bits = 0; \
+                        } \
+                } \
+                SOA_FN(soa_cull_tail)(hits, count); \
+        } while (0)
+
+/** @brief The ray origins and directions of the register at i. */
+#define SOA_RAY_LOAD(r, i) \
+        SOA_F ox = SOA_LOAD((r)->origin.x + (i)), oy = SOA_LOAD((r)->origin.y + (i)), oz = SOA_LOAD((r)->origin.z + (i)); \
+        SOA_F dx = SOA_LOAD((r)->direction.x + (i)), dy = SOA_LOAD((r)->direction.y + (i)), dz = SOA_LOAD((r)->direction.z + (i))
+
+
+/** @brief A ray per lane against one box, see ray_intersect_aabb. */
+static void SOA_FN(ray_soa_intersect_aabb)(const ray_soa *r, const aabb *b, const f32 *t_max, f32 *t, u32 *hits) {
+        SOA_F min_x = SOA_SET1(b->min.x), min_y = SOA_SET1(b->min.y), min_z = SOA_SET1(b->min.z);
+        SOA_F max_x = SOA_SET1(b->max.x), max_y = SOA_SET1(b->max.y), max_z = SOA_SET1(b->max.z);
+        SOA_F zero = SOA_SET1(0.0f), one = SOA_SET1(1.0f);
+
+#define SOA_RAY_AABB(i, d) \
+        do { \
+                SOA_RAY_LOAD(r, i); \
+                SOA_F ix = SOA_DIV(one, dx), iy = SOA_DIV(one, dy), iz = SOA_DIV(one, dz); \
+                SOA_F x0 = SOA_MUL(SOA_SUB(min_x, ox), ix), x1 = SOA_MUL(SOA_SUB(max_x, ox), ix); \
+                SOA_F y0 = SOA_MUL(SOA_SUB(min_y, oy), iy), y1 = SOA_MUL(SOA_SUB(max_y, oy), iy); \
+                SOA_F z0 = SOA_MUL(SOA_SUB(min_z, oz), iz), z1 = SOA_MUL(SOA_SUB(max_z, oz), iz); \
+                \
+                d = SOA_MAX(SOA_MAX(SOA_MIN(x0, x1), SOA_MIN(y0, y1)), SOA_MAX(SOA_MIN(z0, z1), zero)); \
+                SOA_F t_far = SOA_MIN(SOA_MIN(SOA_MAX(x0, x1), SOA_MAX(y0, y1)), SOA_MAX(z0, z1)); \
+                d = SOA_MISS(SOA_LT(t_far, d), d); \
+        } while (0)
+
+        SOA_RAY_PACKET(r->origin.count, t_max, t, hits, SOA_RAY_AABB);
+#undef SOA_RAY_AABB
+}
+
+/** @brief A ray per lane against one sphere, see ray_intersect_sphere. */
+static void SOA_FN(ray_soa_intersect_sphere)(const ray_soa *r, const sphere *s, const f32 *t_max, f32 *t, u32 *hits) {
+        SOA_F cx = SOA_SET1(s->center.x), cy = SOA_SET1(s->center.y), cz = SOA_SET1(s->center.z);
+        SOA_F rr = SOA_SET1(s->radius * s->radius);
+        SOA_F zero = SOA_SET1(0.0f);
+
+#define SOA_RAY_SPHERE(i, d) \
+        do { \
+                SOA_RAY_LOAD(r, i); \
+                SOA_F px = SOA_SUB(ox, cx), py = SOA_SUB(oy, cy), pz = SOA_SUB(oz, cz); \
+                SOA_F a = SOA_DOT3(dx, dy, dz, dx, dy, dz); \
+                SOA_F b = SOA_DOT3(px, py, pz, dx, dy, dz); \
+                SOA_F c = SOA_SUB(SOA_DOT3(px, py, pz, px, py, pz), rr); \
+                SOA_F disc = SOA_SUB(SOA_MUL(b, b), SOA_MUL(a, c)); \
+                SOA_F sq = SOA_SQRT(disc); \
+                \
+                d = SOA_MAX(SOA_DIV(SOA_SUB(SOA_SUB(zero, b), sq), a), zero); \
+                SOA_F t1 = SOA_DIV(SOA_SUB(sq, b), a); \
+                d = SOA_MISS(SOA_LT(t1, zero), d); \
+                d = SOA_MISS(SOA_LT(disc, zero), d); \
+        } while (0)
+
+        SOA_RAY_PACKET(r->origin.count, t_max, t, hits, SOA_RAY_SPHERE);
+#undef SOA_RAY_SPHERE
+}
+
+/** @brief A ray per lane against one plane, see ray_intersect_plane. */
+static void SOA_FN(ray_soa_intersect_plane)(const ray_soa *r, const plane *p, const f32 *t_max, f32 *t, u32 *hits) {
+        SOA_F nx = SOA_SET1(p->x), ny = SOA_SET1(p->y), nz = SOA_SET1(p->z), w = SOA_SET1(p->w);
+        SOA_F zero = SOA_SET1(0.0f);
+
+#define SOA_RAY_PLANE(i, d) \
+        do { \
+                SOA_RAY_LOAD(r, i); \
+                SOA_F dist = SOA_ADD(SOA_DOT3(nx, ny, nz, ox, oy, oz), w); \
+                d = SOA_DIV(SOA_SUB(zero, dist), SOA_DOT3(nx, ny, nz, dx, dy, dz)); \
+                d = SOA_MISS(SOA_LT(d, zero), d); \
+        } while (0)
+
+        SOA_RAY_PACKET(r->origin.count, t_max, t, hits, SOA_RAY_PLANE);
+#undef SOA_RAY_PLANE
+}
+
+#undef SOA_RAY_PACKET
+#undef SOA_RAY_LOAD
+#undef SOA_MISS
+#undef SOA_DOT3
+
+
+static void SOA_FN(smath_kernels_bind_ray)(smath_kernels *k) {
+        k->ray_intersect_triangles = SOA_FN(ray_intersect_triangles);
+        k->ray_intersect_spheres = SOA_FN(ray_intersect_spheres);
+        k->ray_intersect_aabbs = SOA_FN(ray_intersect_aabbs);
+        k->ray_soa_intersect_aabb = SOA_FN(ray_soa_intersect_aabb);
+        k->ray_soa_intersect_sphere = SOA_FN(ray_soa_intersect_sphere);
+        k->ray_soa_intersect_plane = SOA_FN(ray_soa_intersect_plane);
+}
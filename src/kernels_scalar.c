@@ -0,0 +1,336 @@
+#include "../include/mat4x4.h"
+#include "../include/dmat4x4.h"
+#include "../include/dvector.h"
+#include "kernels.h"
+
+#include <math.h>
+#include <string.h>
+
+/* Plain C kernels, every entry of the table has one so it is never NULL. */
+
+
+/*
+ * The plain C bodies of the matrix template. mat4x4_mult and
+ * mat4x4_vec4_mult call the SSE versions when the library is built with
+ * SMATH_SSE, so the scalar table gets its own static copies instead,
+ * named mat4x4_<name>_scalar.
+ */
+#undef SMATH_INLINE
+#define SMATH_INLINE static inline
+#define MT_S f32
+#define MT_M mat4x4
+#define MT_V4 vec4
+#define MT_FN(name) mat4x4_##name##_scalar
+#define MT_V4_MULT mat4x4_vec4_mult_scalar
+#include "mat4x4_template.h"
+#undef SMATH_INLINE
+#define SMATH_INLINE inline
+
+
+/** @brief Scalar - Multiply two arrays of 4x4 matrices pairwise. */
+static void mat4x4_mult_array_scalar(mat4x4 *dest, const mat4x4 *m0, const mat4x4 *m1, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                dest[i] = mat4x4_mult_scalar(&m0[i], &m1[i]);
+        }
+}
+
+/** @brief Scalar - Transform 3D vectors as (x, y, z, w), w is 1 for points and 0 for directions. */
+static inline void mat4x4_transform_vec3_scalar(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n, f32 w) {
+        for (size_t i = 0; i < n; ++i) {
+                f32 x = in[i].x;
+                f32 y = in[i].y;
+                f32 z = in[i].z;
+
+                out[i].x = m->t[0][0] * x + m->t[0][1] * y + m->t[0][2] * z + m->t[0][3] * w;
+                out[i].y = m->t[1][0] * x + m->t[1][1] * y + m->t[1][2] * z + m->t[1][3] * w;
+                out[i].z = m->t[2][0] * x + m->t[2][1] * y + m->t[2][2] * z + m->t[2][3] * w;
+        }
+}
+
+/** @brief Scalar - Transform an array of 3D points. */
+static void mat4x4_transform_points_scalar(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n) {
+        mat4x4_transform_vec3_scalar(m, in, out, n, 1.0f);
+}
+
+/** @brief Scalar - Transform an array of 3D directions. */
+static void mat4x4_transform_directions_scalar(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n) {
+        mat4x4_transform_vec3_scalar(m, in, out, n, 0.0f);
+}
+
+/** @brief Scalar - Transform an array of 4D vectors. */
+static void mat4x4_transform_vec4s_scalar(const mat4x4 *m, const vec4 *in, vec4 *out, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                out[i] = mat4x4_vec4_mult_scalar(m, &in[i]);
+        }
+}
+
+/** @brief Scalar - Copy an array of 3D vectors into a structure of arrays. */
+static void vec3_soa_from_aos_scalar(vec3_soa *dest, const vec3 *src, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                dest->x[i] = src[i].x;
+                dest->y[i] = src[i].y;
+                dest->z[i] = src[i].z;
+        }
+}
+
+/** @brief Scalar - Copy a structure of arrays into an array of 3D vectors. */
+static void vec3_soa_to_aos_scalar(vec3 *dest, const vec3_soa *src) {
+        for (size_t i = 0; i < src->count; ++i) {
+                dest[i].x = src->x[i];
+                dest[i].y = src->y[i];
+                dest[i].z = src->z[i];
+        }
+}
+
+/** @brief Scalar - Copy an array of 4D vectors into a structure of arrays. */
+static void vec4_soa_from_aos_scalar(vec4_soa *dest, const vec4 *src, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                dest->x[i] = src[i].x;
+                dest->y[i] = src[i].y;
+                dest->z[i] = src[i].z;
+                dest->w[i] = src[i].w;
+        }
+}
+
+/** @brief Scalar - Copy a structure of arrays into an array of 4D vectors. */
+static void vec4_soa_to_aos_scalar(vec4 *dest, const vec4_soa *src) {
+        for (size_t i = 0; i < src->count; ++i) {
+                dest[i].x = src->x[i];
+                dest[i].y = src->y[i];
+                dest[i].z = src->z[i];
+                dest[i].w = src->w[i];
+        }
+}
+
+/** @brief Scalar - Linear blend skinning, the weighted sum of the 4 bone matrices transforms the vertex. */
+static void skin_linear_scalar(const mat3x4 *palette, const skin_influence *influences,
+                               const vec3 *positions, const vec3 *normals,
+                               vec3 *out_positions, vec3 *out_normals, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                const skin_influence *s = &influences[i];
+                f32 m[12] = { 0 };
+
+                for (int b = 0; b < 4; ++b) {
+                        const f32 *p = &palette[s->bone[b]].t[0].x;
+                        f32 w = s->weight[b];
+
+                        for (int j = 0; j < 12; ++j)
+                                m[j] += w * p[j];
+                }
+
+                vec3 v = positions[i];
+                out_positions[i].x = m[0] * v.x + m[3] * v.y + m[6] * v.z + m[9];
+                out_positions[i].y = m[1] * v.x + m[4] * v.y + m[7] * v.z + m[10];
+                out_positions[i].z = m[2] * v.x + m[5] * v.y + m[8] * v.z + m[11];
+
+                if (normals) {
+                        v = normals[i];
+                        out_normals[i].x = m[0] * v.x + m[3] * v.y + m[6] * v.z;
+                        out_normals[i].y = m[1] * v.x + m[4] * v.y + m[7] * v.z;
+                        out_normals[i].z = m[2] * v.x + m[5] * v.y + m[8] * v.z;
+                }
+        }
+}
+
+/** @brief Scalar - Rotate a 3D vector with a unit quaternion, v + 2 * cross(q.xyz, cross(q.xyz, v) + w * v). */
+static inline vec3 skin_rotate_scalar(const quat *q, vec3 v) {
+        vec3 t = {
+                q->y * v.z - q->z * v.y + q->w * v.x,
+                q->z * v.x - q->x * v.z + q->w * v.y,
+                q->x * v.y - q->y * v.x + q->w * v.z
+        };
+
+        v.x += 2.0f * (q->y * t.z - q->z * t.y);
+        v.y += 2.0f * (q->z * t.x - q->x * t.z);
+        v.z += 2.0f * (q->x * t.y - q->y * t.x);
+        return v;
+}
+
+/**
+ * @brief Scalar - Dual quaternion skinning.
+ *
+ * The blend is normalized by the length of its real part, the translation
+ * is 2 * (w * d.xyz - d.w * r.xyz + cross(r.xyz, d.xyz)) with the blended
+ * real part r and dual part d.
+ */
+static void skin_dual_quat_scalar(const dual_quat *palette, const skin_influence *influences,
+                                  const vec3 *positions, const vec3 *normals,
+                                  vec3 *out_positions, vec3 *out_normals, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                const skin_influence *s = &influences[i];
+                const quat *r0 = &palette[s->bone[0]].real;
+                quat r = { 0 }, d = { 0 };
+
+                for (int b = 0; b < 4; ++b) {
+                        const dual_quat *q = &palette[s->bone[b]];
+                        f32 w = s->weight[b];
+
+                        if (r0->x * q->real.x + r0->y * q->real.y + r0->z * q->real.z + r0->w * q->real.w < 0.0f)
+                                w = -w;
+
+                        r.x += w * q->real.x; r.y += w * q->real.y; r.z += w * q->real.z; r.w += w * q->real.w;
+                        d.x += w * q->dual.x; d.y += w * q->dual.y; d.z += w * q->dual.z; d.w += w * q->dual.w;
+                }
+
+                f32 l = 1.0f / sqrtf(r.x * r.x + r.y * r.y + r.z * r.z + r.w * r.w);
+                r.x *= l; r.y *= l; r.z *= l; r.w *= l;
+                d.x *= l; d.y *= l; d.z *= l; d.w *= l;
+
+                vec3 p = skin_rotate_scalar(&r, positions[i]);
+                out_positions[i].x = p.x + 2.0f * (r.w * d.x - d.w * r.x + r.y * d.z - r.z * d.y);
+                out_positions[i].y = p.y + 2.0f * (r.w * d.y - d.w * r.y + r.z * d.x - r.x * d.z);
+                out_positions[i].z = p.z + 2.0f * (r.w * d.z - d.w * r.z + r.x * d.y - r.y * d.x);
+
+                if (normals)
+                        out_normals[i] = skin_rotate_scalar(&r, normals[i]);
+        }
+}
+
+/** @brief Scalar - Multiply two arrays of double precision 4x4 matrices pairwise. */
+static void dmat4x4_mult_array_scalar(dmat4x4 *dest, const dmat4x4 *m0, const dmat4x4 *m1, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                dest[i] = dmat4x4_mult(&m0[i], &m1[i]);
+        }
+}
+
+/** @brief Scalar - Build TRS matrices. */
+static void mat4x4_from_trs_array_scalar(mat4x4 *dest, const vec3 *t, const quat *r, const vec3 *s, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                dest[i] = mat4x4_from_trs(&t[i], &r[i], &s[i]);
+        }
+}
+
+/** @brief Scalar - m times TRS matrices, the zeros of the last TRS row are skipped. */
+static void mat4x4_from_trs_mult_array_scalar(mat4x4 *dest, const mat4x4 *m, const vec3 *t, const quat *r, const vec3 *s, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                mat4x4 l = mat4x4_from_trs(&t[i], &r[i], &s[i]);
+
+                for (int j = 0; j < 4; ++j) {
+                        const f32 *a = m->t[j];
+                        for (int k = 0; k < 4; ++k) {
+                                dest[i].t[j][k] = a[0] * l.t[0][k] + a[1] * l.t[1][k] + a[2] * l.t[2][k];
+                        }
+                        dest[i].t[j][3] += a[3];
+                }
+        }
+}
+
+/** @brief Scalar - Build affine TRS matrices, the top 3 rows of the mat4x4 are the mat4x3. */
+static void mat4x3_from_trs_array_scalar(mat4x3 *dest, const vec3 *t, const quat *r, const vec3 *s, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                mat4x4 m = mat4x4_from_trs(&t[i], &r[i], &s[i]);
+                memcpy(&dest[i], m.t, sizeof(mat4x3));
+        }
+}
+
+/** @brief Scalar - Double precision matrices relative to an origin, as floats. */
+static void dmat4x4_to_mat4x4_relative_array_scalar(mat4x4 *dest, const dmat4x4 *src, const dvec3 *origin, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                dest[i] = dmat4x4_to_mat4x4_relative(&src[i], origin);
+        }
+}
+
+/** @brief Scalar - Double precision positions relative to an origin, as floats. */
+static void dvec3_to_vec3_relative_array_scalar(vec3 *dest, const dvec3 *src, const dvec3 *origin, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                dest[i] = vec3_from_dvec3_relative(&src[i], origin);
+        }
+}
+
+#define SOA_F f32
+#define SOA_W 1
+#define SOA_FN(name) name##_scalar
+#define SOA_LOAD(p) (*(p))
+#define SOA_STORE(p, v) (*(p) = (v))
+#define SOA_SET1(s) (s)
+#define SOA_ADD(a, b) ((a) + (b))
+#define SOA_SUB(a, b) ((a) - (b))
+#define SOA_MUL(a, b) ((a) * (b))
+#define SOA_DIV(a, b) ((a) / (b))
+#define SOA_SQRT(a) sqrtf(a)
+#define SOA_RSQRT(a) (1.0f / sqrtf(a))
+#define SOA_FMADD(a, b, c) ((a) * (b) + (c))
+#define SOA_COPYSIGN1(a) copysignf(1.0f, a)
+#include "kernels_soa.h"
+
+/** @brief Scalar - The bits of a float, for the SOA_ bitwise macros. */
+static inline i32 soa_casti_scalar(f32 a) {
+        i32 i;
+        memcpy(&i, &a, sizeof(i));
+        return i;
+}
+
+/** @brief Scalar - The float of some bits. */
+static inline f32 soa_castf_scalar(i32 i) {
+        f32 a;
+        memcpy(&a, &i, sizeof(a));
+        return a;
+}
+
+#define SOA_I i32
+#define SOA_M int
+#define SOA_AND(a, b) soa_castf_scalar(soa_casti_scalar(a) & soa_casti_scalar(b))
+#define SOA_ANDNOT(a, b) soa_castf_scalar(~soa_casti_scalar(a) & soa_casti_scalar(b))
+#define SOA_OR(a, b) soa_castf_scalar(soa_casti_scalar(a) | soa_casti_scalar(b))
+#define SOA_XOR(a, b) soa_castf_scalar(soa_casti_scalar(a) ^ soa_casti_scalar(b))
+#define SOA_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define SOA_MAX(a, b) ((a) > (b) ? (a) : (b))
+#define SOA_LT(a, b) ((a) < (b))
+#define SOA_EQ(a, b) ((a) == (b))
+#define SOA_SELECT(m, a, b) ((m) ? (a) : (b))
+#define SOA_CVTI(a) ((i32)lrintf(a))
+#define SOA_CVTF(i) ((f32)(i))
+#define SOA_CASTI(a) soa_casti_scalar(a)
+#define SOA_CASTF(i) soa_castf_scalar(i)
+#define SOA_ISET1(s) ((i32)(s))
+#define SOA_IADD(a, b) ((a) + (b))
+#define SOA_ISUB(a, b) ((a) - (b))
+#define SOA_IAND(a, b) ((a) & (b))
+#define SOA_ISHL(a, n) ((i32)((u32)(a) << (n)))
+#define SOA_ISRA(a, n) ((a) >> (n))
+#define SOA_ITEST(a, bit) (((a) & (bit)) != 0)
+#include "kernels_math.h"
+
+#define SOA_MOVEMASK(m) ((u32)(m))
+#include "kernels_cull.h"
+#include "kernels_ray.h"
+
+#define SOA_ILOAD(p) (*(const i32*)(p))
+#define SOA_ISTORE(p, i) (*(i32*)(p) = (i))
+#define SOA_ILOAD16(p) ((i32)*(const u16*)(p))
+#define SOA_ISTORE16(p, i) (*(u16*)(p) = (u16)(i))
+#define SOA_ILOAD8(p) ((i32)*(const u8*)(p))
+#define SOA_ISTORE8(p, i) (*(u8*)(p) = (u8)(i))
+#include "kernels_pack.h"
+
+void smath_kernels_bind_scalar(smath_kernels *k) {
+        k->mat4x4_mult = mat4x4_mult_scalar;
+        k->mat4x4_vec4_mult = mat4x4_vec4_mult_scalar;
+        k->mat4x4_mult_array = mat4x4_mult_array_scalar;
+        k->mat4x4_transform_points = mat4x4_transform_points_scalar;
+        k->mat4x4_transform_directions = mat4x4_transform_directions_scalar;
+        k->mat4x4_transform_vec4s = mat4x4_transform_vec4s_scalar;
+
+        // There are no non-temporal stores without SIMD.
+        k->mat4x4_transform_points_stream = mat4x4_transform_points_scalar;
+        k->mat4x4_transform_vec4s_stream = mat4x4_transform_vec4s_scalar;
+
+        k->mat4x4_from_trs_array = mat4x4_from_trs_array_scalar;
+        k->mat4x4_from_trs_mult_array = mat4x4_from_trs_mult_array_scalar;
+        k->mat4x3_from_trs_array = mat4x3_from_trs_array_scalar;
+
+        k->vec3_soa_from_aos = vec3_soa_from_aos_scalar;
+        k->vec3_soa_to_aos = vec3_soa_to_aos_scalar;
+        k->vec4_soa_from_aos = vec4_soa_from_aos_scalar;
+        k->vec4_soa_to_aos = vec4_soa_to_aos_scalar;
+        k->skin_linear = skin_linear_scalar;
+        k->skin_dual_quat = skin_dual_quat_scalar;
+        k->dmat4x4_mult_array = dmat4x4_mult_array_scalar;
+        k->dmat4x4_to_mat4x4_relative_array = dmat4x4_to_mat4x4_relative_array_scalar;
+        k->dvec3_to_vec3_relative_array = dvec3_to_vec3_relative_array_scalar;
+        smath_kernels_bind_soa_scalar(k);
+        smath_kernels_bind_math_scalar(k);
+        smath_kernels_bind_cull_scalar(k);
+        smath_kernels_bind_ray_scalar(k);
+        smath_kernels_bind_pack_scalar(k);
+}
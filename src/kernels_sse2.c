@@ -0,0 +1,747 @@
+#include "kernels.h"
+
+/* Compiled with -msse2, which is the baseline of every x86-64 CPU.
+   The single matrix kernels are mat4x4_sse_mult and mat4x4_sse_vec4_mult. */
+
+#ifdef __SSE2__
+
+#include <stdint.h>
+#include <string.h>
+#include <emmintrin.h>
+
+/** @brief SSE2 - Same as mat4x4_sse_mult but written straight into dest. */
+static inline void mat4x4_mult_sse2_to(mat4x4 *dest, const mat4x4 *m0, const mat4x4 *m1) {
+        __m128 r0 = _mm_load_ps(m1->t[0]);
+        __m128 r1 = _mm_load_ps(m1->t[1]);
+        __m128 r2 = _mm_load_ps(m1->t[2]);
+        __m128 r3 = _mm_load_ps(m1->t[3]);
+
+        for (int i = 0; i < 4; ++i) {
+                __m128 a = _mm_load_ps(m0->t[i]);
+                __m128 r = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), r0);
+                r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), r1));
+                r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), r2));
+                r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), r3));
+                _mm_store_ps(dest->t[i], r);
+        }
+}
+
+/** @brief SSE2 - Multiply two arrays of 4x4 matrices pairwise. */
+static void mat4x4_mult_array_sse2(mat4x4 *dest, const mat4x4 *m0, const mat4x4 *m1, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                mat4x4_mult_sse2_to(&dest[i], &m0[i], &m1[i]);
+        }
+}
+
+/** @brief SSE2 - Load the columns of a 4x4 matrix (the rows are what is stored). */
+static inline void mat4x4_columns_sse2(const mat4x4 *m, __m128 c[4]) {
+        c[0] = _mm_load_ps(m->t[0]);
+        c[1] = _mm_load_ps(m->t[1]);
+        c[2] = _mm_load_ps(m->t[2]);
+        c[3] = _mm_load_ps(m->t[3]);
+
+        _MM_TRANSPOSE4_PS(c[0], c[1], c[2], c[3]);
+}
+
+/** @brief SSE2 - Load 4 packed vec3 (48 bytes) and split them into x, y and z registers. */
+static inline void vec3x4_load_sse2(const vec3 *in, __m128 *x, __m128 *y, __m128 *z) {
+        const f32 *p = (const f32*)in;
+        __m128 a = _mm_loadu_ps(p);             // x0 y0 z0 x1
+        __m128 b = _mm_loadu_ps(p + 4);         // y1 z1 x2 y2
+        __m128 c = _mm_loadu_ps(p + 8);         // z2 x3 y3 z3
+
+        __m128 t0 = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 0, 0));
+        __m128 t1 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));
+        *x = _mm_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 2, 0));
+
+        t0 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+        t1 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+        *y = _mm_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 2, 0));
+
+        t0 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+        t1 = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0));
+        *z = _mm_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+/** @brief SSE2 - Interleave x, y and z registers back into 4 packed vec3. */
+static inline void vec3x4_store_sse2(vec3 *out, __m128 x, __m128 y, __m128 z, int stream) {
+        f32 *p = (f32*)out;
+
+        __m128 t0 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0));
+        __m128 t1 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));
+        __m128 a = _mm_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 2, 0));
+
+        t0 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));
+        t1 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2));
+        __m128 b = _mm_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 2, 0));
+
+        t0 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2));
+        t1 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3));
+        __m128 c = _mm_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 2, 0));
+
+        if (stream) {
+                _mm_stream_ps(p, a);
+                _mm_stream_ps(p + 4, b);
+                _mm_stream_ps(p + 8, c);
+        } else {
+                _mm_storeu_ps(p, a);
+                _mm_storeu_ps(p + 4, b);
+                _mm_storeu_ps(p + 8, c);
+        }
+}
+
+/** @brief SSE2 - Transform a single vec3 with the matrix columns, c3 is zero for directions. */
+static inline void vec3_transform_sse2(const __m128 c[3], __m128 c3, const vec3 *in, vec3 *out) {
+        __m128 r = _mm_mul_ps(c[0], _mm_set1_ps(in->x));
+        r = _mm_add_ps(r, _mm_mul_ps(c[1], _mm_set1_ps(in->y)));
+        r = _mm_add_ps(r, _mm_mul_ps(c[2], _mm_set1_ps(in->z)));
+        r = _mm_add_ps(r, c3);
+
+        _mm_storel_pi((__m64*)out, r);
+        _mm_store_ss(&out->z, _mm_movehl_ps(r, r));
+}
+
+/**
+ * @brief SSE2 - Transform 3D vectors, 4 at a time as x, y and z registers.
+ *
+ * point selects w = 1 (translation applied) or w = 0. With stream the
+ * output is first aligned to 16 bytes, which takes at most 3 vectors.
+ */
+static inline void mat4x4_transform_vec3_sse2(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n, int point, int stream) {
+        __m128 c[4];
+        mat4x4_columns_sse2(m, c);
+
+        __m128 zero = _mm_setzero_ps();
+        __m128 c3 = point ? c[3] : zero;
+
+        __m128 m00 = _mm_set1_ps(m->t[0][0]), m01 = _mm_set1_ps(m->t[0][1]), m02 = _mm_set1_ps(m->t[0][2]);
+        __m128 m10 = _mm_set1_ps(m->t[1][0]), m11 = _mm_set1_ps(m->t[1][1]), m12 = _mm_set1_ps(m->t[1][2]);
+        __m128 m20 = _mm_set1_ps(m->t[2][0]), m21 = _mm_set1_ps(m->t[2][1]), m22 = _mm_set1_ps(m->t[2][2]);
+        __m128 m03 = point ? _mm_set1_ps(m->t[0][3]) : zero;
+        __m128 m13 = point ? _mm_set1_ps(m->t[1][3]) : zero;
+        __m128 m23 = point ? _mm_set1_ps(m->t[2][3]) : zero;
+
+        size_t i = 0;
+
+        if (stream) {
+                for (; i < n && ((uintptr_t)&out[i] & 15); ++i) {
+                        vec3_transform_sse2(c, c3, &in[i], &out[i]);
+                }
+        }
+
+        for (; i + 4 <= n; i += 4) {
+                __m128 x, y, z;
+                vec3x4_load_sse2(&in[i], &x, &y, &z);
+
+                // The order of vec3_transform_sse2, so a vector gives the same bits at every index.
+                __m128 ox = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m01, y)), _mm_mul_ps(m02, z)), m03);
+                __m128 oy = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, x), _mm_mul_ps(m11, y)), _mm_mul_ps(m12, z)), m13);
+                __m128 oz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m20, x), _mm_mul_ps(m21, y)), _mm_mul_ps(m22, z)), m23);
+
+                vec3x4_store_sse2(&out[i], ox, oy, oz, stream);
+        }
+
+        for (; i < n; ++i) {
+                vec3_transform_sse2(c, c3, &in[i], &out[i]);
+        }
+
+        if (stream)
+                _mm_sfence();
+}
+
+/** @brief SSE2 - Transform 4D vectors, every result is a sum of the 4 scaled matrix columns. */
+static inline void mat4x4_transform_vec4_sse2(const mat4x4 *m, const vec4 *in, vec4 *out, size_t n, int stream) {
+        __m128 c[4];
+        mat4x4_columns_sse2(m, c);
+
+        for (size_t i = 0; i < n; ++i) {
+                __m128 v = _mm_load_ps((const f32*)&in[i]);
+                __m128 r = _mm_mul_ps(c[0], _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+                r = _mm_add_ps(r, _mm_mul_ps(c[1], _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+                r = _mm_add_ps(r, _mm_mul_ps(c[2], _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+                r = _mm_add_ps(r, _mm_mul_ps(c[3], _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+
+                if (stream)
+                        _mm_stream_ps((f32*)&out[i], r);
+                else
+                        _mm_store_ps((f32*)&out[i], r);
+        }
+
+        if (stream)
+                _mm_sfence();
+}
+
+static void mat4x4_transform_points_sse2(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n) {
+        mat4x4_transform_vec3_sse2(m, in, out, n, 1, 0);
+}
+
+static void mat4x4_transform_directions_sse2(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n) {
+        mat4x4_transform_vec3_sse2(m, in, out, n, 0, 0);
+}
+
+static void mat4x4_transform_vec4s_sse2(const mat4x4 *m, const vec4 *in, vec4 *out, size_t n) {
+        mat4x4_transform_vec4_sse2(m, in, out, n, 0);
+}
+
+static void mat4x4_transform_points_stream_sse2(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n) {
+        mat4x4_transform_vec3_sse2(m, in, out, n, 1, 1);
+}
+
+static void mat4x4_transform_vec4s_stream_sse2(const mat4x4 *m, const vec4 *in, vec4 *out, size_t n) {
+        mat4x4_transform_vec4_sse2(m, in, out, n, 1);
+}
+
+/** @brief SSE2 - Transpose 4 registers of one element of 4 matrices into the rows of the matrices and store them. */
+static inline void trs_store_rows_sse2(f32 *d0, f32 *d1, f32 *d2, f32 *d3, __m128 a, __m128 b, __m128 c, __m128 d) {
+        _MM_TRANSPOSE4_PS(a, b, c, d);
+        _mm_store_ps(d0, a);
+        _mm_store_ps(d1, b);
+        _mm_store_ps(d2, c);
+        _mm_store_ps(d3, d);
+}
+
+/**
+ * @brief SSE2 - The top 3 rows of 4 TRS matrices, m[i][j] holds row i column j of every matrix.
+ *
+ * The same operations in the same order as mat4x4_from_trs, so the
+ * result is the same.
+ */
+static inline void trs4_sse2(const vec3 *t, const quat *r, const vec3 *s, __m128 m[3][4]) {
+        __m128 x = _mm_load_ps(&r[0].x);
+        __m128 y = _mm_load_ps(&r[1].x);
+        __m128 z = _mm_load_ps(&r[2].x);
+        __m128 w = _mm_load_ps(&r[3].x);
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+
+        __m128 sx, sy, sz;
+        vec3x4_load_sse2(t, &m[0][3], &m[1][3], &m[2][3]);
+        vec3x4_load_sse2(s, &sx, &sy, &sz);
+
+        __m128 one = _mm_set1_ps(1.0F), two = _mm_set1_ps(2.0F);
+        __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+        __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+        __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+        m[0][0] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+        m[0][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+        m[0][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+
+        m[1][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+        m[1][1] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+        m[1][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+
+        m[2][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+        m[2][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+        m[2][2] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+}
+
+/** @brief SSE2 - 4 TRS matrices, rows is 3 for a mat4x3 and 4 for a mat4x4. */
+static inline void trs4_store_sse2(f32 *dest, size_t stride, int rows, const vec3 *t, const quat *r, const vec3 *s) {
+        __m128 m[3][4];
+        trs4_sse2(t, r, s, m);
+
+        for (int i = 0; i < 3; ++i) {
+                trs_store_rows_sse2(dest + 4 * i, dest + stride + 4 * i, dest + 2 * stride + 4 * i, dest + 3 * stride + 4 * i,
+                                    m[i][0], m[i][1], m[i][2], m[i][3]);
+        }
+
+        if (rows == 4) {
+                __m128 e3 = _mm_set_ps(1.0F, 0.0F, 0.0F, 0.0F);
+                for (int k = 0; k < 4; ++k) {
+                        _mm_store_ps(dest + k * stride + 12, e3);
+                }
+        }
+}
+
+/**
+ * @brief SSE2 - mat times 4 TRS matrices.
+ *
+ * The last row of a TRS matrix is (0, 0, 0, 1), so every element is the
+ * sum of 3 products and row i column 3 also gets mat[i][3].
+ */
+static inline void trs4_mult_store_sse2(mat4x4 *dest, const mat4x4 *mat, const vec3 *t, const quat *r, const vec3 *s) {
+        __m128 m[3][4];
+        trs4_sse2(t, r, s, m);
+
+        for (int i = 0; i < 4; ++i) {
+                __m128 a0 = _mm_set1_ps(mat->t[i][0]);
+                __m128 a1 = _mm_set1_ps(mat->t[i][1]);
+                __m128 a2 = _mm_set1_ps(mat->t[i][2]);
+                __m128 o[4];
+
+                for (int j = 0; j < 4; ++j) {
+                        o[j] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, m[0][j]), _mm_mul_ps(a1, m[1][j])), _mm_mul_ps(a2, m[2][j]));
+                }
+                o[3] = _mm_add_ps(o[3], _mm_set1_ps(mat->t[i][3]));
+
+                trs_store_rows_sse2(dest[0].t[i], dest[1].t[i], dest[2].t[i], dest[3].t[i], o[0], o[1], o[2], o[3]);
+        }
+}
+
+/**
+ * @brief SSE2 - Copy the last n < 4 TRS of the arrays into blocks of 4.
+ *
+ * The unused ones are the identity, so the tail runs the same code.
+ */
+static inline void trs4_tail_sse2(vec3 t4[4], quat r4[4], vec3 s4[4], const vec3 *t, const quat *r, const vec3 *s, size_t n) {
+        for (size_t k = 0; k < 4; ++k) {
+                t4[k] = k < n ? t[k] : (vec3){ 0.0F, 0.0F, 0.0F };
+                r4[k] = k < n ? r[k] : (quat){ 0.0F, 0.0F, 0.0F, 1.0F };
+                s4[k] = k < n ? s[k] : (vec3){ 1.0F, 1.0F, 1.0F };
+        }
+}
+
+/** @brief SSE2 - Build TRS matrices, 4 at a time. */
+static void mat4x4_from_trs_array_sse2(mat4x4 *dest, const vec3 *t, const quat *r, const vec3 *s, size_t n) {
+        size_t i = 0;
+
+        for (; i + 4 <= n; i += 4) {
+                trs4_store_sse2(dest[i].t[0], 16, 4, &t[i], &r[i], &s[i]);
+        }
+
+        if (i < n) {
+                vec3 t4[4], s4[4];
+                quat r4[4];
+                mat4x4 m4[4];
+                trs4_tail_sse2(t4, r4, s4, &t[i], &r[i], &s[i], n - i);
+                trs4_store_sse2(m4[0].t[0], 16, 4, t4, r4, s4);
+                memcpy(&dest[i], m4, (n - i) * sizeof(mat4x4));
+        }
+}
+
+/** @brief SSE2 - mat times TRS matrices, 4 at a time. */
+static void mat4x4_from_trs_mult_array_sse2(mat4x4 *dest, const mat4x4 *m, const vec3 *t, const quat *r, const vec3 *s, size_t n) {
+        size_t i = 0;
+
+        for (; i + 4 <= n; i += 4) {
+                trs4_mult_store_sse2(&dest[i], m, &t[i], &r[i], &s[i]);
+        }
+
+        if (i < n) {
+                vec3 t4[4], s4[4];
+                quat r4[4];
+                mat4x4 m4[4];
+                trs4_tail_sse2(t4, r4, s4, &t[i], &r[i], &s[i], n - i);
+                trs4_mult_store_sse2(m4, m, t4, r4, s4);
+                memcpy(&dest[i], m4, (n - i) * sizeof(mat4x4));
+        }
+}
+
+/** @brief SSE2 - Build affine TRS matrices, 4 at a time. */
+static void mat4x3_from_trs_array_sse2(mat4x3 *dest, const vec3 *t, const quat *r, const vec3 *s, size_t n) {
+        size_t i = 0;
+
+        for (; i + 4 <= n; i += 4) {
+                trs4_store_sse2(&dest[i].t[0].x, 12, 3, &t[i], &r[i], &s[i]);
+        }
+
+        if (i < n) {
+                vec3 t4[4], s4[4];
+                quat r4[4];
+                mat4x3 m4[4];
+                trs4_tail_sse2(t4, r4, s4, &t[i], &r[i], &s[i], n - i);
+                trs4_store_sse2(&m4[0].t[0].x, 12, 3, t4, r4, s4);
+                memcpy(&dest[i], m4, (n - i) * sizeof(mat4x3));
+        }
+}
+
+/**
+ * @brief SSE2 - Blend the palette matrices of a vertex into its axes and translation.
+ *
+ * A mat3x4 is 12 packed floats, the loads at float 0, 3, 6 and 8 overlap
+ * so every register holds one axis in x, y, z and no shuffle is needed
+ * per bone. The translation is moved down once at the end.
+ */
+static inline void skin_blend_sse2(const mat3x4 *palette, const skin_influence *s, __m128 c[4]) {
+        c[0] = c[1] = c[2] = c[3] = _mm_setzero_ps();
+
+        for (int b = 0; b < 4; ++b) {
+                const f32 *p = &palette[s->bone[b]].t[0].x;
+                __m128 w = _mm_set1_ps(s->weight[b]);
+
+                c[0] = _mm_add_ps(c[0], _mm_mul_ps(w, _mm_loadu_ps(p)));
+                c[1] = _mm_add_ps(c[1], _mm_mul_ps(w, _mm_loadu_ps(p + 3)));
+                c[2] = _mm_add_ps(c[2], _mm_mul_ps(w, _mm_loadu_ps(p + 6)));
+                c[3] = _mm_add_ps(c[3], _mm_mul_ps(w, _mm_loadu_ps(p + 8)));
+        }
+
+        c[3] = _mm_shuffle_ps(c[3], c[3], _MM_SHUFFLE(3, 3, 2, 1));
+}
+
+/** @brief SSE2 - Linear blend skinning, one vertex at a time with the blended axes as matrix columns. */
+static void skin_linear_sse2(const mat3x4 *palette, const skin_influence *influences,
+                             const vec3 *positions, const vec3 *normals,
+                             vec3 *out_positions, vec3 *out_normals, size_t n) {
+        __m128 zero = _mm_setzero_ps();
+
+        for (size_t i = 0; i < n; ++i) {
+                __m128 c[4];
+                skin_blend_sse2(palette, &influences[i], c);
+
+                vec3_transform_sse2(c, c[3], &positions[i], &out_positions[i]);
+                if (normals)
+                        vec3_transform_sse2(c, zero, &normals[i], &out_normals[i]);
+        }
+}
+
+/** @brief SSE2 - cross(a, b) in x, y, z, with one shuffle less than the textbook form. */
+static inline __m128 vec3_cross_sse2(__m128 a, __m128 b) {
+        __m128 a1 = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 b1 = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 c = _mm_sub_ps(_mm_mul_ps(a, b1), _mm_mul_ps(a1, b));
+        return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+/** @brief SSE2 - The rotation part of a unit quaternion r applied to v, without v itself. */
+static inline __m128 skin_rotate_delta_sse2(__m128 r, __m128 rw, __m128 v) {
+        __m128 t = _mm_add_ps(vec3_cross_sse2(r, v), _mm_mul_ps(rw, v));
+        return vec3_cross_sse2(r, t);
+}
+
+/** @brief SSE2 - Store x, y, z of a register. */
+static inline void vec3_store_sse2(vec3 *out, __m128 v) {
+        _mm_storel_pi((__m64*)out, v);
+        _mm_store_ss(&out->z, _mm_movehl_ps(v, v));
+}
+
+/**
+ * @brief SSE2 - Dual quaternion skinning, one vertex at a time.
+ *
+ * p + 2 * (cross(r, cross(r, p) + w * p) + w * d - d.w * r + cross(r, d))
+ * with the normalized blend r, d.
+ */
+static void skin_dual_quat_sse2(const dual_quat *palette, const skin_influence *influences,
+                                const vec3 *positions, const vec3 *normals,
+                                vec3 *out_positions, vec3 *out_normals, size_t n) {
+        __m128 two = _mm_set1_ps(2.0f);
+
+        for (size_t i = 0; i < n; ++i) {
+                const skin_influence *s = &influences[i];
+                const quat *r0 = &palette[s->bone[0]].real;
+                __m128 r = _mm_setzero_ps(), d = _mm_setzero_ps();
+
+                for (int b = 0; b < 4; ++b) {
+                        const dual_quat *q = &palette[s->bone[b]];
+                        f32 w = s->weight[b];
+
+                        if (r0->x * q->real.x + r0->y * q->real.y + r0->z * q->real.z + r0->w * q->real.w < 0.0f)
+                                w = -w;
+
+                        __m128 wb = _mm_set1_ps(w);
+                        r = _mm_add_ps(r, _mm_mul_ps(wb, _mm_load_ps(&q->real.x)));
+                        d = _mm_add_ps(d, _mm_mul_ps(wb, _mm_load_ps(&q->dual.x)));
+                }
+
+                __m128 l = _mm_mul_ps(r, r);
+                l = _mm_add_ps(l, _mm_shuffle_ps(l, l, _MM_SHUFFLE(2, 3, 0, 1)));
+                l = _mm_add_ps(l, _mm_shuffle_ps(l, l, _MM_SHUFFLE(1, 0, 3, 2)));
+                l = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(l));
+                r = _mm_mul_ps(r, l);
+                d = _mm_mul_ps(d, l);
+
+                __m128 rw = _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3));
+                __m128 dw = _mm_shuffle_ps(d, d, _MM_SHUFFLE(3, 3, 3, 3));
+                __m128 p = _mm_setr_ps(positions[i].x, positions[i].y, positions[i].z, 0.0f);
+
+                __m128 t = _mm_add_ps(skin_rotate_delta_sse2(r, rw, p), vec3_cross_sse2(r, d));
+                t = _mm_add_ps(t, _mm_sub_ps(_mm_mul_ps(rw, d), _mm_mul_ps(dw, r)));
+                vec3_store_sse2(&out_positions[i], _mm_add_ps(p, _mm_mul_ps(two, t)));
+
+                if (normals) {
+                        __m128 v = _mm_setr_ps(normals[i].x, normals[i].y, normals[i].z, 0.0f);
+                        vec3_store_sse2(&out_normals[i], _mm_add_ps(v, _mm_mul_ps(two, skin_rotate_delta_sse2(r, rw, v))));
+                }
+        }
+}
+
+/** @brief SSE2 - Copy an array of 3D vectors into a structure of arrays, 4 at a time. */
+static void vec3_soa_from_aos_sse2(vec3_soa *dest, const vec3 *src, size_t n) {
+        size_t i = 0;
+
+        for (; i + 4 <= n; i += 4) {
+                __m128 x, y, z;
+                vec3x4_load_sse2(&src[i], &x, &y, &z);
+                _mm_storeu_ps(dest->x + i, x);
+                _mm_storeu_ps(dest->y + i, y);
+                _mm_storeu_ps(dest->z + i, z);
+        }
+
+        for (; i < n; ++i) {
+                dest->x[i] = src[i].x;
+                dest->y[i] = src[i].y;
+                dest->z[i] = src[i].z;
+        }
+}
+
+/** @brief SSE2 - Copy a structure of arrays into an array of 3D vectors, 4 at a time. */
+static void vec3_soa_to_aos_sse2(vec3 *dest, const vec3_soa *src) {
+        size_t n = src->count;
+        size_t i = 0;
+
+        for (; i + 4 <= n; i += 4) {
+                vec3x4_store_sse2(&dest[i], _mm_loadu_ps(src->x + i), _mm_loadu_ps(src->y + i), _mm_loadu_ps(src->z + i), 0);
+        }
+
+        for (; i < n; ++i) {
+                dest[i].x = src->x[i];
+                dest[i].y = src->y[i];
+                dest[i].z = src->z[i];
+        }
+}
+
+/** @brief SSE2 - Copy an array of 4D vectors into a structure of arrays, 4 at a time with a transpose. */
+static void vec4_soa_from_aos_sse2(vec4_soa *dest, const vec4 *src, size_t n) {
+        size_t i = 0;
+
+        for (; i + 4 <= n; i += 4) {
+                __m128 x = _mm_load_ps((const f32*)&src[i]);
+                __m128 y = _mm_load_ps((const f32*)&src[i + 1]);
+                __m128 z = _mm_load_ps((const f32*)&src[i + 2]);
+                __m128 w = _mm_load_ps((const f32*)&src[i + 3]);
+
+                _MM_TRANSPOSE4_PS(x, y, z, w);
+
+                _mm_storeu_ps(dest->x + i, x);
+                _mm_storeu_ps(dest->y + i, y);
+                _mm_storeu_ps(dest->z + i, z);
+                _mm_storeu_ps(dest->w + i, w);
+        }
+
+        for (; i < n; ++i) {
+                dest->x[i] = src[i].x;
+                dest->y[i] = src[i].y;
+                dest->z[i] = src[i].z;
+                dest->w[i] = src[i].w;
+        }
+}
+
+/** @brief SSE2 - Copy a structure of arrays into an array of 4D vectors, 4 at a time with a transpose. */
+static void vec4_soa_to_aos_sse2(vec4 *dest, const vec4_soa *src) {
+        size_t n = src->count;
+        size_t i = 0;
+
+        for (; i + 4 <= n; i += 4) {
+                __m128 v0 = _mm_loadu_ps(src->x + i);
+                __m128 v1 = _mm_loadu_ps(src->y + i);
+                __m128 v2 = _mm_loadu_ps(src->z + i);
+                __m128 v3 = _mm_loadu_ps(src->w + i);
+
+                _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+
+                _mm_store_ps((f32*)&dest[i], v0);
+                _mm_store_ps((f32*)&dest[i + 1], v1);
+                _mm_store_ps((f32*)&dest[i + 2], v2);
+                _mm_store_ps((f32*)&dest[i + 3], v3);
+        }
+
+        for (; i < n; ++i) {
+                dest[i].x = src->x[i];
+                dest[i].y = src->y[i];
+                dest[i].z = src->z[i];
+                dest[i].w = src->w[i];
+        }
+}
+
+/** @brief SSE2 - Double precision 4x4 matrix multiplication, every row of the result is 2 registers. */
+static inline void dmat4x4_mult_sse2_to(dmat4x4 *dest, const dmat4x4 *m0, const dmat4x4 *m1) {
+        __m128d r[4][2];
+
+        for (int k = 0; k < 4; ++k) {
+                r[k][0] = _mm_load_pd(&m1->t[k][0]);
+                r[k][1] = _mm_load_pd(&m1->t[k][2]);
+        }
+
+        for (int i = 0; i < 4; ++i) {
+                __m128d a = _mm_load1_pd(&m0->t[i][0]);
+                __m128d lo = _mm_mul_pd(a, r[0][0]);
+                __m128d hi = _mm_mul_pd(a, r[0][1]);
+
+                for (int k = 1; k < 4; ++k) {
+                        a = _mm_load1_pd(&m0->t[i][k]);
+                        lo = _mm_add_pd(lo, _mm_mul_pd(a, r[k][0]));
+                        hi = _mm_add_pd(hi, _mm_mul_pd(a, r[k][1]));
+                }
+
+                _mm_store_pd(&dest->t[i][0], lo);
+                _mm_store_pd(&dest->t[i][2], hi);
+        }
+}
+
+/** @brief SSE2 - Multiply two arrays of double precision 4x4 matrices pairwise. */
+static void dmat4x4_mult_array_sse2(dmat4x4 *dest, const dmat4x4 *m0, const dmat4x4 *m1, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                dmat4x4_mult_sse2_to(&dest[i], &m0[i], &m1[i]);
+        }
+}
+
+/** @brief SSE2 - Round 2 + 2 doubles to the 4 floats of one register. */
+static inline __m128 cvtpd2_ps_sse2(__m128d lo, __m128d hi) {
+        return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+}
+
+/** @brief SSE2 - translate(-origin) * m of every matrix, row i loses origin[i] times the last row. */
+static void dmat4x4_to_mat4x4_relative_array_sse2(mat4x4 *dest, const dmat4x4 *src, const dvec3 *origin, size_t n) {
+        const f64 o[3] = {origin->x, origin->y, origin->z};
+
+        for (size_t i = 0; i < n; ++i) {
+                const dmat4x4 *m = &src[i];
+                __m128d w0 = _mm_load_pd(&m->t[3][0]);
+                __m128d w1 = _mm_load_pd(&m->t[3][2]);
+
+                for (int r = 0; r < 3; ++r) {
+                        __m128d s = _mm_set1_pd(o[r]);
+                        __m128d lo = _mm_sub_pd(_mm_load_pd(&m->t[r][0]), _mm_mul_pd(s, w0));
+                        __m128d hi = _mm_sub_pd(_mm_load_pd(&m->t[r][2]), _mm_mul_pd(s, w1));
+                        _mm_store_ps(dest[i].t[r], cvtpd2_ps_sse2(lo, hi));
+                }
+                _mm_store_ps(dest[i].t[3], cvtpd2_ps_sse2(w0, w1));
+        }
+}
+
+/**
+ * @brief SSE2 - Double precision positions relative to an origin, as floats.
+ *
+ * 2 dvec3 are 3 registers, [x0 y0] [z0 x1] [y1 z1], the origin is
+ * rotated the same way so every register is one subtraction.
+ */
+static void dvec3_to_vec3_relative_array_sse2(vec3 *dest, const dvec3 *src, const dvec3 *origin, size_t n) {
+        __m128d oxy = _mm_set_pd(origin->y, origin->x);
+        __m128d ozx = _mm_set_pd(origin->x, origin->z);
+        __m128d oyz = _mm_set_pd(origin->z, origin->y);
+        const f64 *p = (const f64*)src;
+        f32 *q = (f32*)dest;
+        size_t i = 0;
+
+        for (; i + 2 <= n; i += 2) {
+                __m128 a = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(p + 3 * i), oxy));
+                __m128 b = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(p + 3 * i + 2), ozx));
+                __m128 c = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(p + 3 * i + 4), oyz));
+
+                _mm_storeu_ps(q + 3 * i, _mm_movelh_ps(a, b));
+                _mm_storel_pi((__m64*)(q + 3 * i + 4), c);
+        }
+
+        if (i < n) {
+                __m128 a = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(p + 3 * i), oxy));
+                __m128 b = _mm_cvtpd_ps(_mm_sub_sd(_mm_load_sd(p + 3 * i + 2), ozx));
+
+                _mm_storel_pi((__m64*)(q + 3 * i), a);
+                _mm_store_ss(q + 3 * i + 2, b);
+        }
+}
+
+#define SOA_F __m128
+#define SOA_W 4
+#define SOA_FN(name) name##_sse2
+#define SOA_LOAD(p) _mm_loadu_ps(p)
+#define SOA_STORE(p, v) _mm_storeu_ps(p, v)
+#define SOA_SET1(s) _mm_set1_ps(s)
+#define SOA_ADD(a, b) _mm_add_ps(a, b)
+#define SOA_SUB(a, b) _mm_sub_ps(a, b)
+#define SOA_MUL(a, b) _mm_mul_ps(a, b)
+#define SOA_DIV(a, b) _mm_div_ps(a, b)
+#define SOA_SQRT(a) _mm_sqrt_ps(a)
+#define SOA_RSQRT(a) _mm_rsqrt_ps(a)
+#define SOA_FMADD(a, b, c) _mm_add_ps(_mm_mul_ps(a, b), c)
+#define SOA_COPYSIGN1(a) _mm_or_ps(_mm_set1_ps(1.0f), _mm_and_ps(a, _mm_set1_ps(-0.0f)))
+#include "kernels_soa.h"
+
+#define SOA_I __m128i
+#define SOA_M __m128
+#define SOA_AND(a, b) _mm_and_ps(a, b)
+#define SOA_ANDNOT(a, b) _mm_andnot_ps(a, b)
+#define SOA_OR(a, b) _mm_or_ps(a, b)
+#define SOA_XOR(a, b) _mm_xor_ps(a, b)
+#define SOA_MIN(a, b) _mm_min_ps(a, b)
+#define SOA_MAX(a, b) _mm_max_ps(a, b)
+#define SOA_LT(a, b) _mm_cmplt_ps(a, b)
+#define SOA_EQ(a, b) _mm_cmpeq_ps(a, b)
+#define SOA_SELECT(m, a, b) _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b))
+#define SOA_CVTI(a) _mm_cvtps_epi32(a)
+#define SOA_CVTF(i) _mm_cvtepi32_ps(i)
+#define SOA_CASTI(a) _mm_castps_si128(a)
+#define SOA_CASTF(i) _mm_castsi128_ps(i)
+#define SOA_ISET1(s) _mm_set1_epi32(s)
+#define SOA_IADD(a, b) _mm_add_epi32(a, b)
+#define SOA_ISUB(a, b) _mm_sub_epi32(a, b)
+#define SOA_IAND(a, b) _mm_and_si128(a, b)
+#define SOA_ISHL(a, n) _mm_slli_epi32(a, n)
+#define SOA_ISRA(a, n) _mm_srai_epi32(a, n)
+#define SOA_ITEST(a, bit) _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(a, _mm_set1_epi32(bit)), _mm_set1_epi32(bit)))
+#define SOA_LANE_FN(name) name##_ps
+#include "kernels_math.h"
+
+#define SOA_MOVEMASK(m) _mm_movemask_ps(m)
+#include "kernels_cull.h"
+#include "kernels_ray.h"
+
+/** @brief SSE2 - Load 4 bytes, zero extended to 32 bits per byte. */
+static inline __m128i soa_iload8_sse2(const void *p) {
+        int v;
+        memcpy(&v, p, sizeof(v));
+
+        __m128i zero = _mm_setzero_si128();
+        return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(v), zero), zero);
+}
+
+/** @brief SSE2 - Store the low 16 bits of every lane, sign extended first so the saturating pack keeps them. */
+static inline void soa_istore16_sse2(void *p, __m128i i) {
+        i = _mm_srai_epi32(_mm_slli_epi32(i, 16), 16);
+        _mm_storel_epi64((__m128i*)p, _mm_packs_epi32(i, i));
+}
+
+/** @brief SSE2 - Store the low 8 bits of every lane, sign extended first like soa_istore16_sse2. */
+static inline void soa_istore8_sse2(void *p, __m128i i) {
+        i = _mm_srai_epi32(_mm_slli_epi32(i, 24), 24);
+        i = _mm_packs_epi32(i, i);
+
+        int v = _mm_cvtsi128_si32(_mm_packs_epi16(i, i));
+        memcpy(p, &v, sizeof(v));
+}
+
+#define SOA_ILOAD(p) _mm_loadu_si128((const __m128i*)(p))
+#define SOA_ISTORE(p, i) _mm_storeu_si128((__m128i*)(p), i)
+#define SOA_ILOAD16(p) _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(p)), _mm_setzero_si128())
+#define SOA_ISTORE16(p, i) soa_istore16_sse2(p, i)
+#define SOA_ILOAD8(p) soa_iload8_sse2(p)
+#define SOA_ISTORE8(p, i) soa_istore8_sse2(p, i)
+#include "kernels_pack.h"
+
+int smath_kernels_bind_sse2(smath_kernels *k) {
+        k->mat4x4_mult = mat4x4_sse_mult;
+        k->mat4x4_vec4_mult = mat4x4_sse_vec4_mult;
+        k->mat4x4_mult_array = mat4x4_mult_array_sse2;
+        k->mat4x4_transform_points = mat4x4_transform_points_sse2;
+        k->mat4x4_transform_directions = mat4x4_transform_directions_sse2;
+        k->mat4x4_transform_vec4s = mat4x4_transform_vec4s_sse2;
+        k->mat4x4_transform_points_stream = mat4x4_transform_points_stream_sse2;
+        k->mat4x4_transform_vec4s_stream = mat4x4_transform_vec4s_stream_sse2;
+        k->mat4x4_from_trs_array = mat4x4_from_trs_array_sse2;
+        k->mat4x4_from_trs_mult_array = mat4x4_from_trs_mult_array_sse2;
+        k->mat4x3_from_trs_array = mat4x3_from_trs_array_sse2;
+
+        k->vec3_soa_from_aos = vec3_soa_from_aos_sse2;
+        k->vec3_soa_to_aos = vec3_soa_to_aos_sse2;
+        k->vec4_soa_from_aos = vec4_soa_from_aos_sse2;
+        k->vec4_soa_to_aos = vec4_soa_to_aos_sse2;
+        k->skin_linear = skin_linear_sse2;
+        k->skin_dual_quat = skin_dual_quat_sse2;
+        k->dmat4x4_mult_array = dmat4x4_mult_array_sse2;
+        k->dmat4x4_to_mat4x4_relative_array = dmat4x4_to_mat4x4_relative_array_sse2;
+        k->dvec3_to_vec3_relative_array = dvec3_to_vec3_relative_array_sse2;
+        smath_kernels_bind_soa_sse2(k);
+        smath_kernels_bind_math_sse2(k);
+        smath_kernels_bind_cull_sse2(k);
+        smath_kernels_bind_ray_sse2(k);
+        smath_kernels_bind_pack_sse2(k);
+        return 1;
+}
+
+#else
+
+int smath_kernels_bind_sse2(smath_kernels *k) {
+        (void)k;
+        return 0;
+}
+
+#endif // __SSE2__
@@ -0,0 +1,36 @@
+#include "kernels.h"
+
+/* Compiled with -msse4.1, only the kernels that gain from SSE4.1 are here. */
+
+#ifdef __SSE4_1__
+
+#include <smmintrin.h>
+
+/** @brief SSE4.1 - Multiply a 4x4 matrix with a 4D vector, one dpps per row. */
+static vec4 mat4x4_vec4_mult_sse41(const mat4x4 *m, const vec4 *v) {
+        vec4 v1;
+
+        __m128 x = _mm_load_ps((const f32*)v);
+        __m128 d0 = _mm_dp_ps(_mm_load_ps(m->t[0]), x, 0xF1);
+        __m128 d1 = _mm_dp_ps(_mm_load_ps(m->t[1]), x, 0xF2);
+        __m128 d2 = _mm_dp_ps(_mm_load_ps(m->t[2]), x, 0xF4);
+        __m128 d3 = _mm_dp_ps(_mm_load_ps(m->t[3]), x, 0xF8);
+
+        _mm_store_ps((f32*)&v1, _mm_or_ps(_mm_or_ps(d0, d1), _mm_or_ps(d2, d3)));
+
+        return v1;
+}
+
+int smath_kernels_bind_sse41(smath_kernels *k) {
+        k->mat4x4_vec4_mult = mat4x4_vec4_mult_sse41;
+        return 1;
+}
+
+#else
+
+int smath_kernels_bind_sse41(smath_kernels *k) {
+        (void)k;
+        return 0;
+}
+
+#endif // __SSE4_1__
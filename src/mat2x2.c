@@ -1,2 +1,107 @@
-#include "../include/mat2x2.h"
-
+#include "../include/mat2x2.h"
+#include "../include/types.h"
+#include "../include/math_types.h"
+
+#ifdef SMATH_SSE
+#include <xmmintrin.h>
+#endif
+
+/** @brief 2x2 matrix multiplication with a 2x2 matrix and return a new 2x2 matrix. */
+SMATH_INLINE mat2x2 mat2x2_mult(const mat2x2 *m0, const mat2x2 *m1) {
+
+        mat2x2 m;
+
+        m.t[0].x = m0->t[0].x * m1->t[0].x + m0->t[0].y * m1->t[1].x;
+        m.t[0].y = m0->t[0].x * m1->t[0].y + m0->t[0].y * m1->t[1].y;
+
+        m.t[1].x = m0->t[1].x * m1->t[0].x + m0->t[1].y * m1->t[1].x;
+        m.t[1].y = m0->t[1].x * m1->t[0].y + m0->t[1].y * m1->t[1].y;
+
+        return m;
+}
+
+/** @brief Transpose a 2x2 matrix. */
+SMATH_INLINE mat2x2 mat2x2_transpose(const mat2x2 *m) {
+
+        mat2x2 m1;
+
+        m1.t[0].x = m->t[0].x;
+        m1.t[0].y = m->t[1].x;
+
+        m1.t[1].x = m->t[0].y;
+        m1.t[1].y = m->t[1].y;
+
+        return m1;
+}
+
+/** @brief Multiply a 2x2 matrix with a 2D vector and return a 2D vector. */
+SMATH_INLINE vec2 mat2x2_vec2_mult(const mat2x2 *m, const vec2 *v) {
+
+        vec2 v1;
+
+        v1.x = m->t[0].x * v->x + m->t[0].y * v->y;
+        v1.y = m->t[1].x * v->x + m->t[1].y * v->y;
+
+        return v1;
+}
+
+/** @brief Determinant of a 2x2 matrix, ad - bc. */
+SMATH_INLINE f32 mat2x2_determinant(const mat2x2 *m) {
+        return m->t[0].x * m->t[1].y - m->t[0].y * m->t[1].x;
+}
+
+/** @brief Inverse of a 2x2 matrix, swap the diagonal, negate the rest and divide by the determinant. */
+SMATH_INLINE mat2x2 mat2x2_inverse(const mat2x2 *m) {
+
+        mat2x2 m1;
+        f32 s = 1.0F / mat2x2_determinant(m);
+
+        m1.t[0].x =  m->t[1].y * s;
+        m1.t[0].y = -m->t[0].y * s;
+
+        m1.t[1].x = -m->t[1].x * s;
+        m1.t[1].y =  m->t[0].x * s;
+
+        return m1;
+}
+
+
+
+#ifdef SMATH_SSE
+
+/** @brief SIMD SSE - 2x2 matrix multiplication, the whole matrix is one register [a b c d]. */
+SMATH_INLINE mat2x2 mat2x2_sse_mult(const mat2x2 *m0, const mat2x2 *m1) {
+
+        mat2x2 m;
+
+        __m128 a = _mm_loadu_ps((const f32*)m0->t);
+        __m128 b = _mm_loadu_ps((const f32*)m1->t);
+
+        // [a a c c] * [e f e f] + [b b d d] * [g h g h]
+        __m128 r = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 0, 0)), _mm_movelh_ps(b, b));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 1, 1)), _mm_movehl_ps(b, b)));
+
+        _mm_storeu_ps((f32*)m.t, r);
+
+        return m;
+}
+
+/** @brief SIMD SSE - Inverse of a 2x2 matrix, [d b c a] * 1 / [det -det -det det], the reciprocal as in mat2x2_inverse. */
+SMATH_INLINE mat2x2 mat2x2_sse_inverse(const mat2x2 *m) {
+
+        mat2x2 m1;
+
+        __m128 a = _mm_loadu_ps((const f32*)m->t);
+
+        // [ad bc cb da] - [cb da ad bc]
+        __m128 p = _mm_mul_ps(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 1, 2, 3)));
+        __m128 det = _mm_sub_ps(p, _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 0, 3, 2)));
+
+        __m128 s = _mm_div_ps(_mm_set1_ps(1.0F), det);
+
+        _mm_storeu_ps((f32*)m1.t, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 2, 1, 3)), s));
+
+        return m1;
+}
+
+#endif // SMATH_SSE
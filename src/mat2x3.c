@@ -1 +1,47 @@
-#include "../include/mat2x3.h"
\ No newline at end of file
+#include "../include/mat2x3.h"
+#include "../include/types.h"
+#include "../include/math_types.h"
+
+/** @brief Transpose a 2x3 matrix into a 3x2 matrix. */
+SMATH_INLINE mat3x2 mat2x3_transpose(const mat2x3 *m) {
+
+        mat3x2 m1;
+
+        m1.t[0].x = m->t[0].x;
+        m1.t[0].y = m->t[1].x;
+        m1.t[0].z = m->t[2].x;
+
+        m1.t[1].x = m->t[0].y;
+        m1.t[1].y = m->t[1].y;
+        m1.t[1].z = m->t[2].y;
+
+        return m1;
+}
+
+/** @brief Multiply a 2x3 matrix with a 2D vector and return a 3D vector. */
+SMATH_INLINE vec3 mat2x3_vec2_mult(const mat2x3 *m, const vec2 *v) {
+
+        vec3 v1;
+
+        v1.x = m->t[0].x * v->x + m->t[0].y * v->y;
+        v1.y = m->t[1].x * v->x + m->t[1].y * v->y;
+        v1.z = m->t[2].x * v->x + m->t[2].y * v->y;
+
+        return v1;
+}
+
+/** @brief Multiply a 2x3 matrix with a 3x2 matrix and return a 3x3 matrix. */
+SMATH_INLINE mat3x3 mat2x3_mult(const mat2x3 *m0, const mat3x2 *m1) {
+
+        mat3x3 m;
+
+        for (int i = 0; i < 3; ++i) {
+                const vec2 *a = &m0->t[i];
+
+                m.t[i].x = a->x * m1->t[0].x + a->y * m1->t[1].x;
+                m.t[i].y = a->x * m1->t[0].y + a->y * m1->t[1].y;
+                m.t[i].z = a->x * m1->t[0].z + a->y * m1->t[1].z;
+        }
+
+        return m;
+}
@@ -1 +1,51 @@
-#include "../include/mat2x4.h"
\ No newline at end of file
+#include "../include/mat2x4.h"
+#include "../include/types.h"
+#include "../include/math_types.h"
+
+/** @brief Transpose a 2x4 matrix into a 4x2 matrix. */
+SMATH_INLINE mat4x2 mat2x4_transpose(const mat2x4 *m) {
+
+        mat4x2 m1;
+
+        m1.t[0].x = m->t[0].x;
+        m1.t[0].y = m->t[1].x;
+        m1.t[0].z = m->t[2].x;
+        m1.t[0].w = m->t[3].x;
+
+        m1.t[1].x = m->t[0].y;
+        m1.t[1].y = m->t[1].y;
+        m1.t[1].z = m->t[2].y;
+        m1.t[1].w = m->t[3].y;
+
+        return m1;
+}
+
+/** @brief Multiply a 2x4 matrix with a 2D vector and return a 4D vector. */
+SMATH_INLINE vec4 mat2x4_vec2_mult(const mat2x4 *m, const vec2 *v) {
+
+        vec4 v1;
+
+        v1.x = m->t[0].x * v->x + m->t[0].y * v->y;
+        v1.y = m->t[1].x * v->x + m->t[1].y * v->y;
+        v1.z = m->t[2].x * v->x + m->t[2].y * v->y;
+        v1.w = m->t[3].x * v->x + m->t[3].y * v->y;
+
+        return v1;
+}
+
+/** @brief Multiply a 2x4 matrix with a 4x2 matrix and return a 4x4 matrix. */
+SMATH_INLINE mat4x4 mat2x4_mult(const mat2x4 *m0, const mat4x2 *m1) {
+
+        mat4x4 m;
+
+        for (int i = 0; i < 4; ++i) {
+                const vec2 *a = &m0->t[i];
+
+                m.t[i][0] = a->x * m1->t[0].x + a->y * m1->t[1].x;
+                m.t[i][1] = a->x * m1->t[0].y + a->y * m1->t[1].y;
+                m.t[i][2] = a->x * m1->t[0].z + a->y * m1->t[1].z;
+                m.t[i][3] = a->x * m1->t[0].w + a->y * m1->t[1].w;
+        }
+
+        return m;
+}
@@ -1 +1,46 @@
-#include "../include/mat3x2.h"
\ No newline at end of file
+#include "../include/mat3x2.h"
+#include "../include/types.h"
+#include "../include/math_types.h"
+
+/** @brief Transpose a 3x2 matrix into a 2x3 matrix. */
+SMATH_INLINE mat2x3 mat3x2_transpose(const mat3x2 *m) {
+
+        mat2x3 m1;
+
+        m1.t[0].x = m->t[0].x;
+        m1.t[0].y = m->t[1].x;
+
+        m1.t[1].x = m->t[0].y;
+        m1.t[1].y = m->t[1].y;
+
+        m1.t[2].x = m->t[0].z;
+        m1.t[2].y = m->t[1].z;
+
+        return m1;
+}
+
+/** @brief Multiply a 3x2 matrix with a 3D vector and return a 2D vector. */
+SMATH_INLINE vec2 mat3x2_vec3_mult(const mat3x2 *m, const vec3 *v) {
+
+        vec2 v1;
+
+        v1.x = m->t[0].x * v->x + m->t[0].y * v->y + m->t[0].z * v->z;
+        v1.y = m->t[1].x * v->x + m->t[1].y * v->y + m->t[1].z * v->z;
+
+        return v1;
+}
+
+/** @brief Multiply a 3x2 matrix with a 2x3 matrix and return a 2x2 matrix. */
+SMATH_INLINE mat2x2 mat3x2_mult(const mat3x2 *m0, const mat2x3 *m1) {
+
+        mat2x2 m;
+
+        for (int i = 0; i < 2; ++i) {
+                const vec3 *a = &m0->t[i];
+
+                m.t[i].x = a->x * m1->t[0].x + a->y * m1->t[1].x + a->z * m1->t[2].x;
+                m.t[i].y = a->x * m1->t[0].y + a->y * m1->t[1].y + a->z * m1->t[2].y;
+        }
+
+        return m;
+}
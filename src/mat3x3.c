@@ -1 +1,162 @@
-#include "../include/mat3x3.h"
\ No newline at end of file
+#include "../include/mat3x3.h"
+#include "../include/types.h"
+#include "../include/math_types.h"
+
+#include "mat_sse.h"
+
+/** @brief 3x3 matrix multiplication with a 3x3 matrix and return a new 3x3 matrix. */
+SMATH_INLINE mat3x3 mat3x3_mult(const mat3x3 *m0, const mat3x3 *m1) {
+
+        mat3x3 m;
+
+        for (int i = 0; i < 3; ++i) {
+                const vec3 *a = &m0->t[i];
+
+                m.t[i].x = a->x * m1->t[0].x + a->y * m1->t[1].x + a->z * m1->t[2].x;
+                m.t[i].y = a->x * m1->t[0].y + a->y * m1->t[1].y + a->z * m1->t[2].y;
+                m.t[i].z = a->x * m1->t[0].z + a->y * m1->t[1].z + a->z * m1->t[2].z;
+        }
+
+        return m;
+}
+
+/** @brief Transpose a 3x3 matrix. */
+SMATH_INLINE mat3x3 mat3x3_transpose(const mat3x3 *m) {
+
+        mat3x3 m1;
+
+        m1.t[0].x = m->t[0].x;
+        m1.t[0].y = m->t[1].x;
+        m1.t[0].z = m->t[2].x;
+
+        m1.t[1].x = m->t[0].y;
+        m1.t[1].y = m->t[1].y;
+        m1.t[1].z = m->t[2].y;
+
+        m1.t[2].x = m->t[0].z;
+        m1.t[2].y = m->t[1].z;
+        m1.t[2].z = m->t[2].z;
+
+        return m1;
+}
+
+/** @brief Multiply a 3x3 matrix with a 3D vector and return a 3D vector. */
+SMATH_INLINE vec3 mat3x3_vec3_mult(const mat3x3 *m, const vec3 *v) {
+
+        vec3 v1;
+
+        v1.x = m->t[0].x * v->x + m->t[0].y * v->y + m->t[0].z * v->z;
+        v1.y = m->t[1].x * v->x + m->t[1].y * v->y + m->t[1].z * v->z;
+        v1.z = m->t[2].x * v->x + m->t[2].y * v->y + m->t[2].z * v->z;
+
+        return v1;
+}
+
+/** @brief Determinant of a 3x3 matrix, the scalar triple product of the rows. */
+SMATH_INLINE f32 mat3x3_determinant(const mat3x3 *m) {
+        return m->t[0].x * (m->t[1].y * m->t[2].z - m->t[1].z * m->t[2].y)
+             + m->t[0].y * (m->t[1].z * m->t[2].x - m->t[1].x * m->t[2].z)
+             + m->t[0].z * (m->t[1].x * m->t[2].y - m->t[1].y * m->t[2].x);
+}
+
+/** 
+ * @brief Inverse of a 3x3 matrix.
+ * 
+ * The columns of the inverse are the cross products of the rows
+ * (r1 x r2, r2 x r0, r0 x r1) divided by the determinant.
+ */
+SMATH_INLINE mat3x3 mat3x3_inverse(const mat3x3 *m) {
+
+        mat3x3 m1;
+        const vec3 *r0 = &m->t[0];
+        const vec3 *r1 = &m->t[1];
+        const vec3 *r2 = &m->t[2];
+
+        vec3 c0 = {r1->y * r2->z - r1->z * r2->y, r1->z * r2->x - r1->x * r2->z, r1->x * r2->y - r1->y * r2->x};
+        vec3 c1 = {r2->y * r0->z - r2->z * r0->y, r2->z * r0->x - r2->x * r0->z, r2->x * r0->y - r2->y * r0->x};
+        vec3 c2 = {r0->y * r1->z - r0->z * r1->y, r0->z * r1->x - r0->x * r1->z, r0->x * r1->y - r0->y * r1->x};
+
+        f32 s = 1.0F / (r0->x * c0.x + r0->y * c0.y + r0->z * c0.z);
+
+        m1.t[0].x = c0.x * s;
+        m1.t[0].y = c1.x * s;
+        m1.t[0].z = c2.x * s;
+
+        m1.t[1].x = c0.y * s;
+        m1.t[1].y = c1.y * s;
+        m1.t[1].z = c2.y * s;
+
+        m1.t[2].x = c0.z * s;
+        m1.t[2].y = c1.z * s;
+        m1.t[2].z = c2.z * s;
+
+        return m1;
+}
+
+
+
+#ifdef SMATH_SSE
+
+/** @brief SIMD SSE - 3x3 matrix multiplication, every row of the result is a sum of 3 scaled rows of m1. */
+SMATH_INLINE mat3x3 mat3x3_sse_mult(const mat3x3 *m0, const mat3x3 *m1) {
+
+        mat3x3 m;
+
+        __m128 r0 = mat_sse_load_vec3(&m1->t[0]);
+        __m128 r1 = mat_sse_load_vec3(&m1->t[1]);
+        __m128 r2 = mat_sse_load_vec3(&m1->t[2]);
+
+        for (int i = 0; i < 3; ++i) {
+                __m128 r = _mm_mul_ps(_mm_load1_ps(&m0->t[i].x), r0);
+                r = _mm_add_ps(r, _mm_mul_ps(_mm_load1_ps(&m0->t[i].y), r1));
+                r = _mm_add_ps(r, _mm_mul_ps(_mm_load1_ps(&m0->t[i].z), r2));
+                mat_sse_store_vec3(&m.t[i], r);
+        }
+
+        return m;
+}
+
+/** @brief SIMD SSE - Multiply a 3x3 matrix with a 3D vector, the 3 row products are transposed and summed. */
+SMATH_INLINE vec3 mat3x3_sse_vec3_mult(const mat3x3 *m, const vec3 *v) {
+
+        vec3 v1;
+
+        __m128 x = mat_sse_load_vec3(v);
+        __m128 p0 = _mm_mul_ps(mat_sse_load_vec3(&m->t[0]), x);
+        __m128 p1 = _mm_mul_ps(mat_sse_load_vec3(&m->t[1]), x);
+        __m128 p2 = _mm_mul_ps(mat_sse_load_vec3(&m->t[2]), x);
+        __m128 p3 = _mm_setzero_ps();
+
+        _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+
+        mat_sse_store_vec3(&v1, _mm_add_ps(_mm_add_ps(p0, p1), p2));
+
+        return v1;
+}
+
+/** @brief SIMD SSE - Inverse of a 3x3 matrix, the cross products of the rows are transposed and scaled. */
+SMATH_INLINE mat3x3 mat3x3_sse_inverse(const mat3x3 *m) {
+
+        mat3x3 m1;
+
+        __m128 r0 = mat_sse_load_vec3(&m->t[0]);
+        __m128 r1 = mat_sse_load_vec3(&m->t[1]);
+        __m128 r2 = mat_sse_load_vec3(&m->t[2]);
+
+        __m128 c0 = mat_sse_cross(r1, r2);
+        __m128 c1 = mat_sse_cross(r2, r0);
+        __m128 c2 = mat_sse_cross(r0, r1);
+        __m128 c3 = _mm_setzero_ps();
+
+        __m128 s = _mm_div_ps(_mm_set1_ps(1.0F), mat_sse_dot3(r0, c0));
+
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+        mat_sse_store_vec3(&m1.t[0], _mm_mul_ps(c0, s));
+        mat_sse_store_vec3(&m1.t[1], _mm_mul_ps(c1, s));
+        mat_sse_store_vec3(&m1.t[2], _mm_mul_ps(c2, s));
+
+        return m1;
+}
+
+#endif // SMATH_SSE
@@ -1 +1,225 @@
-#include "../include/mat3x4.h"
\ No newline at end of file
+#include "../include/mat3x4.h"
+#include "../include/types.h"
+#include "../include/math_types.h"
+
+#include "mat_sse.h"
+
+/** @brief Transpose a 3x4 matrix into a 4x3 matrix. */
+SMATH_INLINE mat4x3 mat3x4_transpose(const mat3x4 *m) {
+
+        mat4x3 m1;
+
+        m1.t[0].x = m->t[0].x;
+        m1.t[0].y = m->t[1].x;
+        m1.t[0].z = m->t[2].x;
+        m1.t[0].w = m->t[3].x;
+
+        m1.t[1].x = m->t[0].y;
+        m1.t[1].y = m->t[1].y;
+        m1.t[1].z = m->t[2].y;
+        m1.t[1].w = m->t[3].y;
+
+        m1.t[2].x = m->t[0].z;
+        m1.t[2].y = m->t[1].z;
+        m1.t[2].z = m->t[2].z;
+        m1.t[2].w = m->t[3].z;
+
+        return m1;
+}
+
+/** @brief Multiply a 3x4 matrix with a 3D vector and return a 4D vector. */
+SMATH_INLINE vec4 mat3x4_vec3_mult(const mat3x4 *m, const vec3 *v) {
+
+        vec4 v1;
+
+        v1.x = m->t[0].x * v->x + m->t[0].y * v->y + m->t[0].z * v->z;
+        v1.y = m->t[1].x * v->x + m->t[1].y * v->y + m->t[1].z * v->z;
+        v1.z = m->t[2].x * v->x + m->t[2].y * v->y + m->t[2].z * v->z;
+        v1.w = m->t[3].x * v->x + m->t[3].y * v->y + m->t[3].z * v->z;
+
+        return v1;
+}
+
+/** @brief Multiply a 3x4 matrix with a 4x3 matrix and return a 4x4 matrix. */
+SMATH_INLINE mat4x4 mat3x4_mult(const mat3x4 *m0, const mat4x3 *m1) {
+
+        mat4x4 m;
+
+        for (int i = 0; i < 4; ++i) {
+                const vec3 *a = &m0->t[i];
+
+                m.t[i][0] = a->x * m1->t[0].x + a->y * m1->t[1].x + a->z * m1->t[2].x;
+                m.t[i][1] = a->x * m1->t[0].y + a->y * m1->t[1].y + a->z * m1->t[2].y;
+                m.t[i][2] = a->x * m1->t[0].z + a->y * m1->t[1].z + a->z * m1->t[2].z;
+                m.t[i][3] = a->x * m1->t[0].w + a->y * m1->t[1].w + a->z * m1->t[2].w;
+        }
+
+        return m;
+}
+
+/** @brief Combine two affine 3x4 matrices, the axes of m1 are transformed as directions and its translation as a point. */
+SMATH_INLINE mat3x4 mat3x4_mult_affine(const mat3x4 *m0, const mat3x4 *m1) {
+
+        mat3x4 m;
+
+        for (int i = 0; i < 4; ++i) {
+                const vec3 *b = &m1->t[i];
+
+                m.t[i].x = b->x * m0->t[0].x + b->y * m0->t[1].x + b->z * m0->t[2].x;
+                m.t[i].y = b->x * m0->t[0].y + b->y * m0->t[1].y + b->z * m0->t[2].y;
+                m.t[i].z = b->x * m0->t[0].z + b->y * m0->t[1].z + b->z * m0->t[2].z;
+        }
+
+        m.t[3].x += m0->t[3].x;
+        m.t[3].y += m0->t[3].y;
+        m.t[3].z += m0->t[3].z;
+
+        return m;
+}
+
+/** @brief Transform a point with an affine 3x4 matrix. */
+SMATH_INLINE vec3 mat3x4_transform_point(const mat3x4 *m, const vec3 *v) {
+
+        vec3 v1;
+
+        v1.x = v->x * m->t[0].x + v->y * m->t[1].x + v->z * m->t[2].x + m->t[3].x;
+        v1.y = v->x * m->t[0].y + v->y * m->t[1].y + v->z * m->t[2].y + m->t[3].y;
+        v1.z = v->x * m->t[0].z + v->y * m->t[1].z + v->z * m->t[2].z + m->t[3].z;
+
+        return v1;
+}
+
+/** @brief Transform a direction with an affine 3x4 matrix. */
+SMATH_INLINE vec3 mat3x4_transform_direction(const mat3x4 *m, const vec3 *v) {
+
+        vec3 v1;
+
+        v1.x = v->x * m->t[0].x + v->y * m->t[1].x + v->z * m->t[2].x;
+        v1.y = v->x * m->t[0].y + v->y * m->t[1].y + v->z * m->t[2].y;
+        v1.z = v->x * m->t[0].z + v->y * m->t[1].z + v->z * m->t[2].z;
+
+        return v1;
+}
+
+/** @brief Determinant of the 3x3 part of an affine 3x4 matrix. */
+SMATH_INLINE f32 mat3x4_determinant(const mat3x4 *m) {
+        return m->t[0].x * (m->t[1].y * m->t[2].z - m->t[1].z * m->t[2].y)
+             + m->t[0].y * (m->t[1].z * m->t[2].x - m->t[1].x * m->t[2].z)
+             + m->t[0].z * (m->t[1].x * m->t[2].y - m->t[1].y * m->t[2].x);
+}
+
+/** 
+ * @brief Inverse of an affine 3x4 matrix.
+ * 
+ * The cross products of the axes are the rows of the new axes (so they
+ * are transposed) and the new translation is the old one transformed by
+ * the new axes and negated.
+ */
+SMATH_INLINE mat3x4 mat3x4_inverse_affine(const mat3x4 *m) {
+
+        mat3x4 m1;
+        const vec3 *r0 = &m->t[0];
+        const vec3 *r1 = &m->t[1];
+        const vec3 *r2 = &m->t[2];
+        const vec3 *p = &m->t[3];
+
+        vec3 c0 = {r1->y * r2->z - r1->z * r2->y, r1->z * r2->x - r1->x * r2->z, r1->x * r2->y - r1->y * r2->x};
+        vec3 c1 = {r2->y * r0->z - r2->z * r0->y, r2->z * r0->x - r2->x * r0->z, r2->x * r0->y - r2->y * r0->x};
+        vec3 c2 = {r0->y * r1->z - r0->z * r1->y, r0->z * r1->x - r0->x * r1->z, r0->x * r1->y - r0->y * r1->x};
+
+        f32 s = 1.0F / (r0->x * c0.x + r0->y * c0.y + r0->z * c0.z);
+
+        m1.t[0].x = c0.x * s;
+        m1.t[0].y = c1.x * s;
+        m1.t[0].z = c2.x * s;
+
+        m1.t[1].x = c0.y * s;
+        m1.t[1].y = c1.y * s;
+        m1.t[1].z = c2.y * s;
+
+        m1.t[2].x = c0.z * s;
+        m1.t[2].y = c1.z * s;
+        m1.t[2].z = c2.z * s;
+
+        m1.t[3].x = -(p->x * m1.t[0].x + p->y * m1.t[1].x + p->z * m1.t[2].x);
+        m1.t[3].y = -(p->x * m1.t[0].y + p->y * m1.t[1].y + p->z * m1.t[2].y);
+        m1.t[3].z = -(p->x * m1.t[0].z + p->y * m1.t[1].z + p->z * m1.t[2].z);
+
+        return m1;
+}
+
+
+
+#ifdef SMATH_SSE
+
+/** @brief SIMD SSE - Combine two affine 3x4 matrices, every row of m1 is a sum of 3 scaled axes of m0. */
+SMATH_INLINE mat3x4 mat3x4_sse_mult_affine(const mat3x4 *m0, const mat3x4 *m1) {
+
+        mat3x4 m;
+
+        __m128 a0 = mat_sse_load_vec3(&m0->t[0]);
+        __m128 a1 = mat_sse_load_vec3(&m0->t[1]);
+        __m128 a2 = mat_sse_load_vec3(&m0->t[2]);
+        __m128 a3 = mat_sse_load_vec3(&m0->t[3]);
+
+        for (int i = 0; i < 4; ++i) {
+                __m128 r = _mm_mul_ps(_mm_load1_ps(&m1->t[i].x), a0);
+                r = _mm_add_ps(r, _mm_mul_ps(_mm_load1_ps(&m1->t[i].y), a1));
+                r = _mm_add_ps(r, _mm_mul_ps(_mm_load1_ps(&m1->t[i].z), a2));
+
+                if (i == 3)
+                        r = _mm_add_ps(r, a3);
+
+                mat_sse_store_vec3(&m.t[i], r);
+        }
+
+        return m;
+}
+
+/** @brief SIMD SSE - Transform a point with an affine 3x4 matrix, broadcast and add the scaled axes. */
+SMATH_INLINE vec3 mat3x4_sse_transform_point(const mat3x4 *m, const vec3 *v) {
+
+        vec3 v1;
+
+        __m128 r = _mm_mul_ps(_mm_load1_ps(&v->x), mat_sse_load_vec3(&m->t[0]));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_load1_ps(&v->y), mat_sse_load_vec3(&m->t[1])));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_load1_ps(&v->z), mat_sse_load_vec3(&m->t[2])));
+        r = _mm_add_ps(r, mat_sse_load_vec3(&m->t[3]));
+
+        mat_sse_store_vec3(&v1, r);
+
+        return v1;
+}
+
+/** @brief SIMD SSE - Inverse of an affine 3x4 matrix, the scaled cross products of the axes are transposed. */
+SMATH_INLINE mat3x4 mat3x4_sse_inverse_affine(const mat3x4 *m) {
+
+        mat3x4 m1;
+
+        __m128 r0 = mat_sse_load_vec3(&m->t[0]);
+        __m128 r1 = mat_sse_load_vec3(&m->t[1]);
+        __m128 r2 = mat_sse_load_vec3(&m->t[2]);
+        __m128 p = mat_sse_load_vec3(&m->t[3]);
+
+        __m128 c0 = mat_sse_cross(r1, r2);
+        __m128 s = _mm_div_ps(_mm_set1_ps(1.0F), mat_sse_dot3(r0, c0));
+        c0 = _mm_mul_ps(c0, s);
+        __m128 c1 = _mm_mul_ps(mat_sse_cross(r2, r0), s);
+        __m128 c2 = _mm_mul_ps(mat_sse_cross(r0, r1), s);
+        __m128 c3 = _mm_setzero_ps();
+
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+        __m128 t = _mm_mul_ps(_mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0)), c0);
+        t = _mm_add_ps(t, _mm_mul_ps(_mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1)), c1));
+        t = _mm_add_ps(t, _mm_mul_ps(_mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2)), c2));
+
+        mat_sse_store_vec3(&m1.t[0], c0);
+        mat_sse_store_vec3(&m1.t[1], c1);
+        mat_sse_store_vec3(&m1.t[2], c2);
+        mat_sse_store_vec3(&m1.t[3], _mm_xor_ps(t, _mm_set1_ps(-0.0F)));
+
+        return m1;
+}
+
+#endif // SMATH_SSE
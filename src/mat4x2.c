@@ -1 +1,49 @@
-#include "../include/mat4x2.h"
\ No newline at end of file
+#include "../include/mat4x2.h"
+#include "../include/types.h"
+#include "../include/math_types.h"
+
+/** @brief Transpose a 4x2 matrix into a 2x4 matrix. */
+SMATH_INLINE mat2x4 mat4x2_transpose(const mat4x2 *m) {
+
+        mat2x4 m1;
+
+        m1.t[0].x = m->t[0].x;
+        m1.t[0].y = m->t[1].x;
+
+        m1.t[1].x = m->t[0].y;
+        m1.t[1].y = m->t[1].y;
+
+        m1.t[2].x = m->t[0].z;
+        m1.t[2].y = m->t[1].z;
+
+        m1.t[3].x = m->t[0].w;
+        m1.t[3].y = m->t[1].w;
+
+        return m1;
+}
+
+/** @brief Multiply a 4x2 matrix with a 4D vector and return a 2D vector. */
+SMATH_INLINE vec2 mat4x2_vec4_mult(const mat4x2 *m, const vec4 *v) {
+
+        vec2 v1;
+
+        v1.x = m->t[0].x * v->x + m->t[0].y * v->y + m->t[0].z * v->z + m->t[0].w * v->w;
+        v1.y = m->t[1].x * v->x + m->t[1].y * v->y + m->t[1].z * v->z + m->t[1].w * v->w;
+
+        return v1;
+}
+
+/** @brief Multiply a 4x2 matrix with a 2x4 matrix and return a 2x2 matrix. */
+SMATH_INLINE mat2x2 mat4x2_mult(const mat4x2 *m0, const mat2x4 *m1) {
+
+        mat2x2 m;
+
+        for (int i = 0; i < 2; ++i) {
+                const vec4 *a = &m0->t[i];
+
+                m.t[i].x = a->x * m1->t[0].x + a->y * m1->t[1].x + a->z * m1->t[2].x + a->w * m1->t[3].x;
+                m.t[i].y = a->x * m1->t[0].y + a->y * m1->t[1].y + a->z * m1->t[2].y + a->w * m1->t[3].y;
+        }
+
+        return m;
+}
@@ -1 +1,277 @@
-#include "../include/mat4x3.h"
\ No newline at end of file
+#include "../include/mat4x3.h"
+#include "../include/types.h"
+#include "../include/math_types.h"
+
+#include "mat_sse.h"
+
+/** @brief Create an affine 4x3 matrix from the first 3 rows of a 4x4 matrix. */
+SMATH_INLINE mat4x3 mat4x3_from_mat4x4(const mat4x4 *m) {
+
+        mat4x3 m1;
+
+        for (int i = 0; i < 3; ++i) {
+                m1.t[i].x = m->t[i][0];
+                m1.t[i].y = m->t[i][1];
+                m1.t[i].z = m->t[i][2];
+                m1.t[i].w = m->t[i][3];
+        }
+
+        return m1;
+}
+
+/** @brief Create a 4x4 matrix from an affine 4x3 matrix, the last row is (0, 0, 0, 1). */
+SMATH_INLINE mat4x4 mat4x3_to_mat4x4(const mat4x3 *m) {
+
+        mat4x4 m1;
+
+        for (int i = 0; i < 3; ++i) {
+                m1.t[i][0] = m->t[i].x;
+                m1.t[i][1] = m->t[i].y;
+                m1.t[i][2] = m->t[i].z;
+                m1.t[i][3] = m->t[i].w;
+        }
+
+        m1.t[3][0] = 0.0F;
+        m1.t[3][1] = 0.0F;
+        m1.t[3][2] = 0.0F;
+        m1.t[3][3] = 1.0F;
+
+        return m1;
+}
+
+/** @brief Transpose a 4x3 matrix into a 3x4 matrix. */
+SMATH_INLINE mat3x4 mat4x3_transpose(const mat4x3 *m) {
+
+        mat3x4 m1;
+
+        m1.t[0].x = m->t[0].x;
+        m1.t[0].y = m->t[1].x;
+        m1.t[0].z = m->t[2].x;
+
+        m1.t[1].x = m->t[0].y;
+        m1.t[1].y = m->t[1].y;
+        m1.t[1].z = m->t[2].y;
+
+        m1.t[2].x = m->t[0].z;
+        m1.t[2].y = m->t[1].z;
+        m1.t[2].z = m->t[2].z;
+
+        m1.t[3].x = m->t[0].w;
+        m1.t[3].y = m->t[1].w;
+        m1.t[3].z = m->t[2].w;
+
+        return m1;
+}
+
+/** @brief Multiply a 4x3 matrix with a 4D vector and return a 3D vector. */
+SMATH_INLINE vec3 mat4x3_vec4_mult(const mat4x3 *m, const vec4 *v) {
+
+        vec3 v1;
+
+        v1.x = m->t[0].x * v->x + m->t[0].y * v->y + m->t[0].z * v->z + m->t[0].w * v->w;
+        v1.y = m->t[1].x * v->x + m->t[1].y * v->y + m->t[1].z * v->z + m->t[1].w * v->w;
+        v1.z = m->t[2].x * v->x + m->t[2].y * v->y + m->t[2].z * v->z + m->t[2].w * v->w;
+
+        return v1;
+}
+
+/** @brief Multiply a 4x3 matrix with a 3x4 matrix and return a 3x3 matrix. */
+SMATH_INLINE mat3x3 mat4x3_mult(const mat4x3 *m0, const mat3x4 *m1) {
+
+        mat3x3 m;
+
+        for (int i = 0; i < 3; ++i) {
+                const vec4 *a = &m0->t[i];
+
+                m.t[i].x = a->x * m1->t[0].x + a->y * m1->t[1].x + a->z * m1->t[2].x + a->w * m1->t[3].x;
+                m.t[i].y = a->x * m1->t[0].y + a->y * m1->t[1].y + a->z * m1->t[2].y + a->w * m1->t[3].y;
+                m.t[i].z = a->x * m1->t[0].z + a->y * m1->t[1].z + a->z * m1->t[2].z + a->w * m1->t[3].z;
+        }
+
+        return m;
+}
+
+/** @brief Combine two affine 4x3 matrices like two 4x4 matrices with the row (0, 0, 0, 1). */
+SMATH_INLINE mat4x3 mat4x3_mult_affine(const mat4x3 *m0, const mat4x3 *m1) {
+
+        mat4x3 m;
+
+        for (int i = 0; i < 3; ++i) {
+                const vec4 *a = &m0->t[i];
+
+                m.t[i].x = a->x * m1->t[0].x + a->y * m1->t[1].x + a->z * m1->t[2].x;
+                m.t[i].y = a->x * m1->t[0].y + a->y * m1->t[1].y + a->z * m1->t[2].y;
+                m.t[i].z = a->x * m1->t[0].z + a->y * m1->t[1].z + a->z * m1->t[2].z;
+                m.t[i].w = a->x * m1->t[0].w + a->y * m1->t[1].w + a->z * m1->t[2].w + a->w;
+        }
+
+        return m;
+}
+
+/** @brief Transform a point (w = 1) with an affine 4x3 matrix. */
+SMATH_INLINE vec3 mat4x3_transform_point(const mat4x3 *m, const vec3 *v) {
+
+        vec3 v1;
+
+        v1.x = m->t[0].x * v->x + m->t[0].y * v->y + m->t[0].z * v->z + m->t[0].w;
+        v1.y = m->t[1].x * v->x + m->t[1].y * v->y + m->t[1].z * v->z + m->t[1].w;
+        v1.z = m->t[2].x * v->x + m->t[2].y * v->y + m->t[2].z * v->z + m->t[2].w;
+
+        return v1;
+}
+
+/** @brief Transform a direction (w = 0) with an affine 4x3 matrix. */
+SMATH_INLINE vec3 mat4x3_transform_direction(const mat4x3 *m, const vec3 *v) {
+
+        vec3 v1;
+
+        v1.x = m->t[0].x * v->x + m->t[0].y * v->y + m->t[0].z * v->z;
+        v1.y = m->t[1].x * v->x + m->t[1].y * v->y + m->t[1].z * v->z;
+        v1.z = m->t[2].x * v->x + m->t[2].y * v->y + m->t[2].z * v->z;
+
+        return v1;
+}
+
+/** @brief Determinant of the 3x3 part of an affine 4x3 matrix. */
+SMATH_INLINE f32 mat4x3_determinant(const mat4x3 *m) {
+        return m->t[0].x * (m->t[1].y * m->t[2].z - m->t[1].z * m->t[2].y)
+             + m->t[0].y * (m->t[1].z * m->t[2].x - m->t[1].x * m->t[2].z)
+             + m->t[0].z * (m->t[1].x * m->t[2].y - m->t[1].y * m->t[2].x);
+}
+
+/** 
+ * @brief Inverse of an affine 4x3 matrix.
+ * 
+ * The 3x3 part is inverted like mat3x3_inverse and the new translation
+ * is the old one transformed by that inverse and negated.
+ */
+SMATH_INLINE mat4x3 mat4x3_inverse_affine(const mat4x3 *m) {
+
+        mat4x3 m1;
+        const vec4 *r0 = &m->t[0];
+        const vec4 *r1 = &m->t[1];
+        const vec4 *r2 = &m->t[2];
+
+        vec3 c0 = {r1->y * r2->z - r1->z * r2->y, r1->z * r2->x - r1->x * r2->z, r1->x * r2->y - r1->y * r2->x};
+        vec3 c1 = {r2->y * r0->z - r2->z * r0->y, r2->z * r0->x - r2->x * r0->z, r2->x * r0->y - r2->y * r0->x};
+        vec3 c2 = {r0->y * r1->z - r0->z * r1->y, r0->z * r1->x - r0->x * r1->z, r0->x * r1->y - r0->y * r1->x};
+
+        f32 s = 1.0F / (r0->x * c0.x + r0->y * c0.y + r0->z * c0.z);
+
+        m1.t[0].x = c0.x * s;
+        m1.t[0].y = c1.x * s;
+        m1.t[0].z = c2.x * s;
+
+        m1.t[1].x = c0.y * s;
+        m1.t[1].y = c1.y * s;
+        m1.t[1].z = c2.y * s;
+
+        m1.t[2].x = c0.z * s;
+        m1.t[2].y = c1.z * s;
+        m1.t[2].z = c2.z * s;
+
+        for (int i = 0; i < 3; ++i)
+                m1.t[i].w = -(m1.t[i].x * r0->w + m1.t[i].y * r1->w + m1.t[i].z * r2->w);
+
+        return m1;
+}
+
+
+
+#ifdef SMATH_SSE
+
+/** @brief SIMD SSE - Multiply a 4x3 matrix with a 4D vector, the 3 row products are transposed and summed. */
+SMATH_INLINE vec3 mat4x3_sse_vec4_mult(const mat4x3 *m, const vec4 *v) {
+
+        vec3 v1;
+
+        __m128 x = _mm_load_ps((const f32*)v);
+        __m128 p0 = _mm_mul_ps(_mm_load_ps((const f32*)&m->t[0]), x);
+        __m128 p1 = _mm_mul_ps(_mm_load_ps((const f32*)&m->t[1]), x);
+        __m128 p2 = _mm_mul_ps(_mm_load_ps((const f32*)&m->t[2]), x);
+        __m128 p3 = _mm_setzero_ps();
+
+        _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+
+        mat_sse_store_vec3(&v1, _mm_add_ps(_mm_add_ps(p0, p1), _mm_add_ps(p2, p3)));
+
+        return v1;
+}
+
+/** @brief SIMD SSE - Combine two affine 4x3 matrices, every row is a sum of 3 scaled rows of m1 plus (0, 0, 0, w). */
+SMATH_INLINE mat4x3 mat4x3_sse_mult_affine(const mat4x3 *m0, const mat4x3 *m1) {
+
+        mat4x3 m;
+
+        __m128 r0 = _mm_load_ps((const f32*)&m1->t[0]);
+        __m128 r1 = _mm_load_ps((const f32*)&m1->t[1]);
+        __m128 r2 = _mm_load_ps((const f32*)&m1->t[2]);
+        __m128 r3 = _mm_set_ps(1.0F, 0.0F, 0.0F, 0.0F);
+
+        for (int i = 0; i < 3; ++i) {
+                __m128 a = _mm_load_ps((const f32*)&m0->t[i]);
+                __m128 r = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), r0);
+                r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), r1));
+                r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), r2));
+                r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), r3));
+                _mm_store_ps((f32*)&m.t[i], r);
+        }
+
+        return m;
+}
+
+/** @brief SIMD SSE - Transform a point (w = 1) with an affine 4x3 matrix. */
+SMATH_INLINE vec3 mat4x3_sse_transform_point(const mat4x3 *m, const vec3 *v) {
+
+        vec3 v1;
+
+        // (x, y, z, 1)
+        __m128 x = _mm_add_ps(mat_sse_load_vec3(v), _mm_set_ps(1.0F, 0.0F, 0.0F, 0.0F));
+        __m128 p0 = _mm_mul_ps(_mm_load_ps((const f32*)&m->t[0]), x);
+        __m128 p1 = _mm_mul_ps(_mm_load_ps((const f32*)&m->t[1]), x);
+        __m128 p2 = _mm_mul_ps(_mm_load_ps((const f32*)&m->t[2]), x);
+        __m128 p3 = _mm_setzero_ps();
+
+        _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+
+        mat_sse_store_vec3(&v1, _mm_add_ps(_mm_add_ps(p0, p1), _mm_add_ps(p2, p3)));
+
+        return v1;
+}
+
+/** 
+ * @brief SIMD SSE - Inverse of an affine 4x3 matrix.
+ * 
+ * The cross products of the rows are the columns of the inverse 3x3 part,
+ * the new translation is built from them before the one transpose.
+ */
+SMATH_INLINE mat4x3 mat4x3_sse_inverse_affine(const mat4x3 *m) {
+
+        mat4x3 m1;
+
+        __m128 r0 = _mm_load_ps((const f32*)&m->t[0]);
+        __m128 r1 = _mm_load_ps((const f32*)&m->t[1]);
+        __m128 r2 = _mm_load_ps((const f32*)&m->t[2]);
+
+        // The w of the cross products is 0, the translation drops out.
+        __m128 c0 = mat_sse_cross(r1, r2);
+        __m128 s = _mm_div_ps(_mm_set1_ps(1.0F), mat_sse_dot3(r0, c0));
+        c0 = _mm_mul_ps(c0, s);
+        __m128 c1 = _mm_mul_ps(mat_sse_cross(r2, r0), s);
+        __m128 c2 = _mm_mul_ps(mat_sse_cross(r0, r1), s);
+
+        __m128 c3 = _mm_mul_ps(c0, _mm_shuffle_ps(r0, r0, _MM_SHUFFLE(3, 3, 3, 3)));
+        c3 = _mm_add_ps(c3, _mm_mul_ps(c1, _mm_shuffle_ps(r1, r1, _MM_SHUFFLE(3, 3, 3, 3))));
+        c3 = _mm_add_ps(c3, _mm_mul_ps(c2, _mm_shuffle_ps(r2, r2, _MM_SHUFFLE(3, 3, 3, 3))));
+        c3 = _mm_xor_ps(c3, _mm_set1_ps(-0.0F));
+
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+        _mm_store_ps((f32*)&m1.t[0], c0);
+        _mm_store_ps((f32*)&m1.t[1], c1);
+        _mm_store_ps((f32*)&m1.t[2], c2);
+
+        return m1;
+}
+
+#endif // SMATH_SSE
@@ -1,108 +1,388 @@
-#include "../include/mat4x4.h"
-#include "../include/types.h"
-#include "../include/math_types.h"
-
-/** @brief 4x4 Matrix - 
- *  The Matrix takes input in row-major order. 
- *  But inside the function it will be transposed into a column-major order
- * 
- *  m.t[n] => 0 = x, 1 = y, 2 = z, 3 = w;
-*/
-inline void mat4x4_parse(mat4x4 *dest,
-                         const vec4 *v0,
-                         const vec4 *v1,
-                         const vec4 *v2,
-                         const vec4 *v3) {
-
-        dest->t[0][0] = v0->x;
-        dest->t[0][1] = v1->x;
-        dest->t[0][2] = v2->x;
-        dest->t[0][3] = v3->x;
-
-        dest->t[1][0] = v0->y;
-        dest->t[1][1] = v1->y;
-        dest->t[1][2] = v2->y;
-        dest->t[1][3] = v3->y;
-        
-        dest->t[2][0] = v0->z;
-        dest->t[2][1] = v1->z;
-        dest->t[2][2] = v2->z;
-        dest->t[2][3] = v3->z;
-
-        dest->t[3][0] = v0->w;
-        dest->t[3][1] = v1->w;
-        dest->t[3][2] = v2->w;
-        dest->t[3][3] = v3->w;
-}
-
-
-inline mat4x4 mat4x4_create(const vec4 *v0, 
-                            const vec4 *v1, 
-                            const vec4 *v2, 
-                            const vec4 *v3) {
-        
-        mat4x4 m;
-
-        m.t[0][0] = v0->x;
-        m.t[0][1] = v1->x;
-        m.t[0][2] = v2->x;
-        m.t[0][3] = v3->x;
-
-        m.t[1][0] = v0->y;
-        m.t[1][1] = v1->y;
-        m.t[1][2] = v2->y;
-        m.t[1][3] = v3->y;
-        
-        m.t[2][0] = v0->z;
-        m.t[2][1] = v1->z;
-        m.t[2][2] = v2->z;
-        m.t[2][3] = v3->z;
-
-        m.t[3][0] = v0->w;
-        m.t[3][1] = v1->w;
-        m.t[3][2] = v2->w;
-        m.t[3][3] = v3->w;
-
-        return m;
-}
-
-/** @brief 4x4 matrix multiplication with a 4x4 matrix and return a new 4x4 matrix. */
-inline mat4x4 mat4x4_mult(const mat4x4 *m0, const mat4x4 *m1) {
-        
-        mat4x4 m;
-
-        m.t[0][0] = m0->t[0][0] * m1->t[0][0] + m0->t[0][1] * m1->t[1][0] + m0->t[0][2] * m1->t[2][0] + m0->t[0][3] * m1->t[3][0]; 
-        m.t[0][1] = m0->t[0][0] * m1->t[0][1] + m0->t[0][1] * m1->t[1][1] + m0->t[0][2] * m1->t[2][1] + m0->t[0][3] * m1->t[3][1]; 
-        m.t[0][2] = m0->t[0][0] * m1->t[0][2] + m0->t[0][1] * m1->t[1][2] + m0->t[0][2] * m1->t[2][2] + m0->t[0][3] * m1->t[3][2]; 
-        m.t[0][3] = m0->t[0][0] * m1->t[0][3] + m0->t[0][1] * m1->t[1][3] + m0->t[0][2] * m1->t[2][3] + m0->t[0][3] * m1->t[3][3];
-        
-        m.t[1][0] = m0->t[1][0] * m1->t[0][0] + m0->t[1][1] * m1->t[1][0] + m0->t[1][2] * m1->t[2][0] + m0->t[1][3] * m1->t[3][0]; 
-        m.t[1][1] = m0->t[1][0] * m1->t[0][1] + m0->t[1][1] * m1->t[1][1] + m0->t[1][2] * m1->t[2][1] + m0->t[1][3] * m1->t[3][1]; 
-        m.t[1][2] = m0->t[1][0] * m1->t[0][2] + m0->t[1][1] * m1->t[1][2] + m0->t[1][2] * m1->t[2][2] + m0->t[1][3] * m1->t[3][2]; 
-        m.t[1][3] = m0->t[1][0] * m1->t[0][3] + m0->t[1][1] * m1->t[1][3] + m0->t[1][2] * m1->t[2][3] + m0->t[1][3] * m1->t[3][3];
-
-        m.t[2][0] = m0->t[2][0] * m1->t[0][0] + m0->t[2][1] * m1->t[1][0] + m0->t[2][2] * m1->t[2][0] + m0->t[2][3] * m1->t[3][0]; 
-        m.t[2][1] = m0->t[2][0] * m1->t[0][1] + m0->t[2][1] * m1->t[1][1] + m0->t[2][2] * m1->t[2][1] + m0->t[2][3] * m1->t[3][1]; 
-        m.t[2][2] = m0->t[2][0] * m1->t[0][2] + m0->t[2][1] * m1->t[1][2] + m0->t[2][2] * m1->t[2][2] + m0->t[2][3] * m1->t[3][2]; 
-        m.t[2][3] = m0->t[2][0] * m1->t[0][3] + m0->t[2][1] * m1->t[1][3] + m0->t[2][2] * m1->t[2][3] + m0->t[2][3] * m1->t[3][3];
-
-        m.t[3][0] = m0->t[3][0] * m1->t[0][0] + m0->t[3][1] * m1->t[1][0] + m0->t[3][2] * m1->t[2][0] + m0->t[3][3] * m1->t[3][0]; 
-        m.t[3][1] = m0->t[3][0] * m1->t[0][1] + m0->t[3][1] * m1->t[1][1] + m0->t[3][2] * m1->t[2][1] + m0->t[3][3] * m1->t[3][1]; 
-        m.t[3][2] = m0->t[3][0] * m1->t[0][2] + m0->t[3][1] * m1->t[1][2] + m0->t[3][2] * m1->t[2][2] + m0->t[3][3] * m1->t[3][2]; 
-        m.t[3][3] = m0->t[3][0] * m1->t[0][3] + m0->t[3][1] * m1->t[1][3] + m0->t[3][2] * m1->t[2][3] + m0->t[3][3] * m1->t[3][3];
-
-        return m;
-}
-
-/** @brief Multiply a 4x4 matrix with a 4D vector and return a 4D vector. */
-inline vec4 mat4x4_vec4_mult(const mat4x4 *m, const vec4 *v) {
-
-        vec4 v1;
-
-        v1.x = m->t[0][0] * v->x + m->t[0][1] * v->y + m->t[0][2] * v->z + m->t[0][3] * v->w; 
-        v1.y = m->t[1][0] * v->x + m->t[1][1] * v->y + m->t[1][2] * v->z + m->t[1][3] * v->w; 
-        v1.z = m->t[2][0] * v->x + m->t[2][1] * v->y + m->t[2][2] * v->z + m->t[2][3] * v->w; 
-        v1.w = m->t[3][0] * v->x + m->t[3][1] * v->y + m->t[3][2] * v->z + m->t[3][3] * v->w; 
-
-        return v1;
-}
\ No newline at end of file
+#include <math.h>
+
+#include "../include/mat4x4.h"
+#include "../include/types.h"
+#include "../include/math_types.h"
+
+#ifdef SMATH_SSE
+#include <xmmintrin.h>
+#endif
+
+#include "mat_sse.h"
+
+#define MT_S f32
+#define MT_M mat4x4
+#define MT_V4 vec4
+#define MT_FN(name) mat4x4_##name
+#define MT_V4_MULT mat4x4_vec4_mult
+#ifdef SMATH_SSE
+#define MT_SSE_MULT mat4x4_sse_mult
+#define MT_SSE_V4_MULT mat4x4_sse_vec4_mult
+#endif
+#include "mat4x4_template.h"
+
+
+/** @brief The projection without its depth rows, x and y scaled by the field of view, w = -z. */
+static inline mat4x4 mat4x4_perspective_xy(f32 fovy, f32 aspect) {
+        mat4x4 m = {{{0.0F}}};
+        f32 y = 1.0F / tanf(fovy * 0.5F);
+
+        m.t[0][0] = y / aspect;
+        m.t[1][1] = y;
+        m.t[3][2] = -1.0F;
+
+        return m;
+}
+
+/** @brief Right handed perspective projection, z_near and z_far are mapped to the ends of the depth range. */
+SMATH_INLINE mat4x4 mat4x4_perspective(f32 fovy, f32 aspect, f32 z_near, f32 z_far, smath_clip_depth depth) {
+        mat4x4 m = mat4x4_perspective_xy(fovy, aspect);
+        f32 inv = 1.0F / (z_near - z_far);
+
+        if (depth == SMATH_CLIP_DEPTH_ZERO_TO_ONE) {
+                m.t[2][2] = z_far * inv;
+                m.t[2][3] = z_far * z_near * inv;
+        } else {
+                m.t[2][2] = (z_far + z_near) * inv;
+                m.t[2][3] = 2.0F * z_far * z_near * inv;
+        }
+
+        return m;
+}
+
+/** @brief mat4x4_perspective with z_far going to infinity. */
+SMATH_INLINE mat4x4 mat4x4_perspective_infinite(f32 fovy, f32 aspect, f32 z_near, smath_clip_depth depth) {
+        mat4x4 m = mat4x4_perspective_xy(fovy, aspect);
+
+        m.t[2][2] = -1.0F;
+        m.t[2][3] = depth == SMATH_CLIP_DEPTH_ZERO_TO_ONE ? -z_near : -2.0F * z_near;
+
+        return m;
+}
+
+/** @brief Perspective projection with z_near at depth 1 and z_far at depth 0. */
+SMATH_INLINE mat4x4 mat4x4_perspective_reversed(f32 fovy, f32 aspect, f32 z_near, f32 z_far) {
+        mat4x4 m = mat4x4_perspective_xy(fovy, aspect);
+        f32 inv = 1.0F / (z_far - z_near);
+
+        m.t[2][2] = z_near * inv;
+        m.t[2][3] = z_far * z_near * inv;
+
+        return m;
+}
+
+/** @brief Reversed Z with the far plane at infinity, the depth is z_near / distance. */
+SMATH_INLINE mat4x4 mat4x4_perspective_reversed_infinite(f32 fovy, f32 aspect, f32 z_near) {
+        mat4x4 m = mat4x4_perspective_xy(fovy, aspect);
+
+        m.t[2][3] = z_near;
+
+        return m;
+}
+
+/** @brief Right handed orthographic projection of the box [left, right] x [bottom, top] x [-z_near, -z_far]. */
+SMATH_INLINE mat4x4 mat4x4_ortho(f32 left, f32 right, f32 bottom, f32 top, f32 z_near, f32 z_far, smath_clip_depth depth) {
+        mat4x4 m = {{{0.0F}}};
+        f32 inv = 1.0F / (z_near - z_far);
+
+        m.t[0][0] = 2.0F / (right - left);
+        m.t[0][3] = (left + right) / (left - right);
+        m.t[1][1] = 2.0F / (top - bottom);
+        m.t[1][3] = (bottom + top) / (bottom - top);
+
+        if (depth == SMATH_CLIP_DEPTH_ZERO_TO_ONE) {
+                m.t[2][2] = inv;
+                m.t[2][3] = z_near * inv;
+        } else {
+                m.t[2][2] = 2.0F * inv;
+                m.t[2][3] = (z_far + z_near) * inv;
+        }
+
+        m.t[3][3] = 1.0F;
+
+        return m;
+}
+
+/** @brief Right handed view matrix, the rows are the camera axes side, up and -forward. */
+SMATH_INLINE mat4x4 mat4x4_look_at(const vec3 *eye, const vec3 *center, const vec3 *up) {
+        f32 fx = center->x - eye->x, fy = center->y - eye->y, fz = center->z - eye->z;
+        f32 l = 1.0F / sqrtf(fx * fx + fy * fy + fz * fz);
+        fx *= l;
+        fy *= l;
+        fz *= l;
+
+        f32 sx = fy * up->z - fz * up->y;
+        f32 sy = fz * up->x - fx * up->z;
+        f32 sz = fx * up->y - fy * up->x;
+        l = 1.0F / sqrtf(sx * sx + sy * sy + sz * sz);
+        sx *= l;
+        sy *= l;
+        sz *= l;
+
+        f32 ux = sy * fz - sz * fy;
+        f32 uy = sz * fx - sx * fz;
+        f32 uz = sx * fy - sy * fx;
+
+        mat4x4 m;
+
+        m.t[0][0] = sx;
+        m.t[0][1] = sy;
+        m.t[0][2] = sz;
+        m.t[0][3] = -(sx * eye->x + sy * eye->y + sz * eye->z);
+
+        m.t[1][0] = ux;
+        m.t[1][1] = uy;
+        m.t[1][2] = uz;
+        m.t[1][3] = -(ux * eye->x + uy * eye->y + uz * eye->z);
+
+        m.t[2][0] = -fx;
+        m.t[2][1] = -fy;
+        m.t[2][2] = -fz;
+        m.t[2][3] = fx * eye->x + fy * eye->y + fz * eye->z;
+
+        m.t[3][0] = 0.0F;
+        m.t[3][1] = 0.0F;
+        m.t[3][2] = 0.0F;
+        m.t[3][3] = 1.0F;
+
+        return m;
+}
+
+/** @brief Translation * rotation * scale in one go, the scale multiplies the columns of the rotation. */
+SMATH_INLINE mat4x4 mat4x4_from_trs(const vec3 *t, const quat *r, const vec3 *s) {
+        mat4x4 m;
+
+        f32 xx = r->x * r->x, yy = r->y * r->y, zz = r->z * r->z;
+        f32 xy = r->x * r->y, xz = r->x * r->z, yz = r->y * r->z;
+        f32 wx = r->w * r->x, wy = r->w * r->y, wz = r->w * r->z;
+
+        m.t[0][0] = (1.0F - 2.0F * (yy + zz)) * s->x;
+        m.t[0][1] = 2.0F * (xy - wz) * s->y;
+        m.t[0][2] = 2.0F * (xz + wy) * s->z;
+        m.t[0][3] = t->x;
+
+        m.t[1][0] = 2.0F * (xy + wz) * s->x;
+        m.t[1][1] = (1.0F - 2.0F * (xx + zz)) * s->y;
+        m.t[1][2] = 2.0F * (yz - wx) * s->z;
+        m.t[1][3] = t->y;
+
+        m.t[2][0] = 2.0F * (xz - wy) * s->x;
+        m.t[2][1] = 2.0F * (yz + wx) * s->y;
+        m.t[2][2] = (1.0F - 2.0F * (xx + yy)) * s->z;
+        m.t[2][3] = t->z;
+
+        m.t[3][0] = 0.0F;
+        m.t[3][1] = 0.0F;
+        m.t[3][2] = 0.0F;
+        m.t[3][3] = 1.0F;
+
+        return m;
+}
+
+
+
+#ifdef SMATH_SSE
+
+/** @brief SIMD SSE - 4x4 matrix multiplication, every row of the result is a sum of 4 scaled rows of m1. */
+SMATH_INLINE mat4x4 mat4x4_sse_mult(const mat4x4 *m0, const mat4x4 *m1) {
+
+        mat4x4 m;
+
+        __m128 r0 = _mm_load_ps(m1->t[0]);
+        __m128 r1 = _mm_load_ps(m1->t[1]);
+        __m128 r2 = _mm_load_ps(m1->t[2]);
+        __m128 r3 = _mm_load_ps(m1->t[3]);
+
+        for (int i = 0; i < 4; ++i) {
+                __m128 a = _mm_load_ps(m0->t[i]);
+                __m128 r = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), r0);
+                r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), r1));
+                r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), r2));
+                r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), r3));
+                _mm_store_ps(m.t[i], r);
+        }
+
+        return m;
+}
+
+/** @brief SIMD SSE - Multiply a 4x4 matrix with a 4D vector, the 4 row products are transposed and summed. */
+SMATH_INLINE vec4 mat4x4_sse_vec4_mult(const mat4x4 *m, const vec4 *v) {
+
+        vec4 v1;
+
+        __m128 x = _mm_load_ps((const f32*)v);
+        __m128 p0 = _mm_mul_ps(_mm_load_ps(m->t[0]), x);
+        __m128 p1 = _mm_mul_ps(_mm_load_ps(m->t[1]), x);
+        __m128 p2 = _mm_mul_ps(_mm_load_ps(m->t[2]), x);
+        __m128 p3 = _mm_mul_ps(_mm_load_ps(m->t[3]), x);
+
+        _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+
+        // Summed in the order of the scalar version, so the results are the same bits.
+        _mm_store_ps((f32*)&v1, _mm_add_ps(_mm_add_ps(_mm_add_ps(p0, p1), p2), p3));
+
+        return v1;
+}
+
+/** @brief SIMD SSE - 2x2 matrix product A * B, a 2x2 matrix is one register [x y z w]. */
+static inline __m128 mat4x4_sse_mat2_mult(__m128 a, __m128 b) {
+        return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+                          _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+/** @brief SIMD SSE - 2x2 matrix product adj(A) * B. */
+static inline __m128 mat4x4_sse_mat2_adj_mult(__m128 a, __m128 b) {
+        return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+                          _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+/** @brief SIMD SSE - 2x2 matrix product A * adj(B). */
+static inline __m128 mat4x4_sse_mat2_mult_adj(__m128 a, __m128 b) {
+        return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+                          _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+/** 
+ * @brief SIMD SSE - Inverse and determinant of a 4x4 matrix.
+ * 
+ * The matrix is split into the 2x2 blocks | A B ; C D | and the inverse
+ * is built from the blockwise cofactors (adjugates) of them, every block
+ * takes one register.
+ */
+SMATH_INLINE mat4x4 mat4x4_sse_inverse_det(const mat4x4 *m, f32 *det) {
+
+        mat4x4 m1;
+
+        __m128 r0 = _mm_load_ps(m->t[0]);
+        __m128 r1 = _mm_load_ps(m->t[1]);
+        __m128 r2 = _mm_load_ps(m->t[2]);
+        __m128 r3 = _mm_load_ps(m->t[3]);
+
+        __m128 a = _mm_movelh_ps(r0, r1);
+        __m128 b = _mm_movehl_ps(r1, r0);
+        __m128 c = _mm_movelh_ps(r2, r3);
+        __m128 d = _mm_movehl_ps(r3, r2);
+
+        // (|A| |B| |C| |D|)
+        __m128 det_sub = _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3, 1, 3, 1))),
+                                    _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2, 0, 2, 0))));
+        __m128 det_a = _mm_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(0, 0, 0, 0));
+        __m128 det_b = _mm_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 det_c = _mm_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(2, 2, 2, 2));
+        __m128 det_d = _mm_shuffle_ps(det_sub, det_sub, _MM_SHUFFLE(3, 3, 3, 3));
+
+        __m128 d_c = mat4x4_sse_mat2_adj_mult(d, c);
+        __m128 a_b = mat4x4_sse_mat2_adj_mult(a, b);
+
+        // adj(X) = |D| A - B adj(D) C, adj(W) = |A| D - C adj(A) B
+        __m128 x = _mm_sub_ps(_mm_mul_ps(det_d, a), mat4x4_sse_mat2_mult(b, d_c));
+        __m128 w = _mm_sub_ps(_mm_mul_ps(det_a, d), mat4x4_sse_mat2_mult(c, a_b));
+
+        // adj(Y) = |B| C - D adj(adj(A) B), adj(Z) = |C| B - A adj(adj(D) C)
+        __m128 y = _mm_sub_ps(_mm_mul_ps(det_b, c), mat4x4_sse_mat2_mult_adj(d, a_b));
+        __m128 z = _mm_sub_ps(_mm_mul_ps(det_c, b), mat4x4_sse_mat2_mult_adj(a, d_c));
+
+        // |M| = |A| |D| + |B| |C| - tr(adj(A) B adj(D) C)
+        __m128 tr = _mm_mul_ps(a_b, _mm_shuffle_ps(d_c, d_c, _MM_SHUFFLE(3, 1, 2, 0)));
+        tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(2, 3, 0, 1)));
+        tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(1, 0, 3, 2)));
+
+        __m128 det_m = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c)), tr);
+        __m128 s = _mm_div_ps(_mm_setr_ps(1.0F, -1.0F, -1.0F, 1.0F), det_m);
+
+        x = _mm_mul_ps(x, s);
+        y = _mm_mul_ps(y, s);
+        z = _mm_mul_ps(z, s);
+        w = _mm_mul_ps(w, s);
+
+        // Undo the adjugates while putting the blocks back into rows.
+        _mm_store_ps(m1.t[0], _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_store_ps(m1.t[1], _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+        _mm_store_ps(m1.t[2], _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_store_ps(m1.t[3], _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+
+        *det = _mm_cvtss_f32(det_m);
+
+        return m1;
+}
+
+/** @brief SIMD SSE - Inverse of a 4x4 matrix with the 2x2 block cofactors. */
+SMATH_INLINE mat4x4 mat4x4_sse_inverse(const mat4x4 *m) {
+        f32 det;
+        return mat4x4_sse_inverse_det(m, &det);
+}
+
+/** 
+ * @brief SIMD SSE - Inverse of an affine 4x4 matrix.
+ * 
+ * The cross products of the rows are the columns of the inverse 3x3 part,
+ * the new translation and the last row are added as the fourth column
+ * before the one transpose.
+ */
+SMATH_INLINE mat4x4 mat4x4_sse_inverse_affine(const mat4x4 *m) {
+
+        mat4x4 m1;
+
+        __m128 r0 = _mm_load_ps(m->t[0]);
+        __m128 r1 = _mm_load_ps(m->t[1]);
+        __m128 r2 = _mm_load_ps(m->t[2]);
+
+        // The w of the cross products is 0, the translation drops out.
+        __m128 c0 = mat_sse_cross(r1, r2);
+        __m128 s = _mm_div_ps(_mm_set1_ps(1.0F), mat_sse_dot3(r0, c0));
+        c0 = _mm_mul_ps(c0, s);
+        __m128 c1 = _mm_mul_ps(mat_sse_cross(r2, r0), s);
+        __m128 c2 = _mm_mul_ps(mat_sse_cross(r0, r1), s);
+
+        __m128 c3 = _mm_mul_ps(c0, _mm_shuffle_ps(r0, r0, _MM_SHUFFLE(3, 3, 3, 3)));
+        c3 = _mm_add_ps(c3, _mm_mul_ps(c1, _mm_shuffle_ps(r1, r1, _MM_SHUFFLE(3, 3, 3, 3))));
+        c3 = _mm_add_ps(c3, _mm_mul_ps(c2, _mm_shuffle_ps(r2, r2, _MM_SHUFFLE(3, 3, 3, 3))));
+        c3 = _mm_xor_ps(c3, _mm_set1_ps(-0.0F));
+
+        // The w of the scaled cross products is -0 for a negative determinant, the last row is stored as is.
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+        _mm_store_ps(m1.t[0], c0);
+        _mm_store_ps(m1.t[1], c1);
+        _mm_store_ps(m1.t[2], c2);
+        _mm_store_ps(m1.t[3], _mm_setr_ps(0.0F, 0.0F, 0.0F, 1.0F));
+
+        return m1;
+}
+
+/** 
+ * @brief SIMD SSE - Inverse of a rigid body 4x4 matrix.
+ * 
+ * The rows with w = 0 and the rotated back translation with w = 1 are
+ * the transposed result.
+ */
+SMATH_INLINE mat4x4 mat4x4_sse_inverse_rigid(const mat4x4 *m) {
+
+        mat4x4 m1;
+
+        __m128 zero = _mm_setzero_ps();
+        __m128 r0 = _mm_load_ps(m->t[0]);
+        __m128 r1 = _mm_load_ps(m->t[1]);
+        __m128 r2 = _mm_load_ps(m->t[2]);
+
+        // (x, y, z, 0)
+        __m128 a0 = _mm_shuffle_ps(r0, _mm_unpackhi_ps(r0, zero), _MM_SHUFFLE(1, 0, 1, 0));
+        __m128 a1 = _mm_shuffle_ps(r1, _mm_unpackhi_ps(r1, zero), _MM_SHUFFLE(1, 0, 1, 0));
+        __m128 a2 = _mm_shuffle_ps(r2, _mm_unpackhi_ps(r2, zero), _MM_SHUFFLE(1, 0, 1, 0));
+
+        __m128 a3 = _mm_mul_ps(a0, _mm_shuffle_ps(r0, r0, _MM_SHUFFLE(3, 3, 3, 3)));
+        a3 = _mm_add_ps(a3, _mm_mul_ps(a1, _mm_shuffle_ps(r1, r1, _MM_SHUFFLE(3, 3, 3, 3))));
+        a3 = _mm_add_ps(a3, _mm_mul_ps(a2, _mm_shuffle_ps(r2, r2, _MM_SHUFFLE(3, 3, 3, 3))));
+        a3 = _mm_xor_ps(a3, _mm_set1_ps(-0.0F));
+
+        _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+
+        _mm_store_ps(m1.t[0], a0);
+        _mm_store_ps(m1.t[1], a1);
+        _mm_store_ps(m1.t[2], a2);
+        _mm_store_ps(m1.t[3], _mm_setr_ps(0.0F, 0.0F, 0.0F, 1.0F));
+
+        return m1;
+}
+
+#endif // SMATH_SSE
@@ -0,0 +1,270 @@
+/*
+ * Private to the library.
+ *
+ * The portable 4x4 matrix functions, shared by mat4x4 and dmat4x4 so the
+ * two precisions can not drift apart. Included by mat4x4.c and dmat4x4.c
+ * (and so by the headerfiles in SMATH_HEADER_ONLY mode), and without the
+ * SSE parameters by kernels_scalar.c for the scalar table, with:
+ *
+ *   MT_S            the scalar type, f32 or f64
+ *   MT_M            the matrix type, rows in t[4][4]
+ *   MT_V4           the 4D vector type of the same scalar
+ *   MT_FN(name)     the name of a function, e.g. mat4x4_##name
+ *   MT_V4_MULT      the name of the matrix times MT_V4 function
+ *
+ * and optionally, when the precision has SSE versions of them:
+ *
+ *   MT_SSE_MULT     the name of the SSE matrix product, MT_FN(mult) calls it
+ *   MT_SSE_V4_MULT  the name of the SSE matrix times MT_V4, MT_V4_MULT calls it
+ *
+ * No include guard, every parameter is undefined again at the end.
+ */
+
+/** @brief 4x4 Matrix - 
+ *  The Matrix takes input in row-major order. 
+ *  But inside the function it will be transposed into a column-major order
+ * 
+ *  m.t[n] => 0 = x, 1 = y, 2 = z, 3 = w;
+*/
+SMATH_INLINE void MT_FN(parse)(MT_M *dest, const MT_V4 *v0, const MT_V4 *v1, const MT_V4 *v2, const MT_V4 *v3) {
+
+        dest->t[0][0] = v0->x;
+        dest->t[0][1] = v1->x;
+        dest->t[0][2] = v2->x;
+        dest->t[0][3] = v3->x;
+
+        dest->t[1][0] = v0->y;
+        dest->t[1][1] = v1->y;
+        dest->t[1][2] = v2->y;
+        dest->t[1][3] = v3->y;
+        
+        dest->t[2][0] = v0->z;
+        dest->t[2][1] = v1->z;
+        dest->t[2][2] = v2->z;
+        dest->t[2][3] = v3->z;
+
+        dest->t[3][0] = v0->w;
+        dest->t[3][1] = v1->w;
+        dest->t[3][2] = v2->w;
+        dest->t[3][3] = v3->w;
+}
+
+
+SMATH_INLINE MT_M MT_FN(create)(const MT_V4 *v0, const MT_V4 *v1, const MT_V4 *v2, const MT_V4 *v3) {
+        
+        MT_M m;
+
+        m.t[0][0] = v0->x;
+        m.t[0][1] = v1->x;
+        m.t[0][2] = v2->x;
+        m.t[0][3] = v3->x;
+
+        m.t[1][0] = v0->y;
+        m.t[1][1] = v1->y;
+        m.t[1][2] = v2->y;
+        m.t[1][3] = v3->y;
+        
+        m.t[2][0] = v0->z;
+        m.t[2][1] = v1->z;
+        m.t[2][2] = v2->z;
+        m.t[2][3] = v3->z;
+
+        m.t[3][0] = v0->w;
+        m.t[3][1] = v1->w;
+        m.t[3][2] = v2->w;
+        m.t[3][3] = v3->w;
+
+        return m;
+}
+
+/** @brief 4x4 matrix multiplication with a 4x4 matrix and return a new 4x4 matrix. */
+SMATH_INLINE MT_M MT_FN(mult)(const MT_M *m0, const MT_M *m1) {
+#ifdef MT_SSE_MULT
+        return MT_SSE_MULT(m0, m1);
+#else
+        MT_M m;
+
+        m.t[0][0] = m0->t[0][0] * m1->t[0][0] + m0->t[0][1] * m1->t[1][0] + m0->t[0][2] * m1->t[2][0] + m0->t[0][3] * m1->t[3][0]; 
+        m.t[0][1] = m0->t[0][0] * m1->t[0][1] + m0->t[0][1] * m1->t[1][1] + m0->t[0][2] * m1->t[2][1] + m0->t[0][3] * m1->t[3][1]; 
+        m.t[0][2] = m0->t[0][0] * m1->t[0][2] + m0->t[0][1] * m1->t[1][2] + m0->t[0][2] * m1->t[2][2] + m0->t[0][3] * m1->t[3][2]; 
+        m.t[0][3] = m0->t[0][0] * m1->t[0][3] + m0->t[0][1] * m1->t[1][3] + m0->t[0][2] * m1->t[2][3] + m0->t[0][3] * m1->t[3][3];
+        
+        m.t[1][0] = m0->t[1][0] * m1->t[0][0] + m0->t[1][1] * m1->t[1][0] + m0->t[1][2] * m1->t[2][0] + m0->t[1][3] * m1->t[3][0]; 
+        m.t[1][1] = m0->t[1][0] * m1->t[0][1] + m0->t[1][1] * m1->t[1][1] + m0->t[1][2] * m1->t[2][1] + m0->t[1][3] * m1->t[3][1]; 
+        m.t[1][2] = m0->t[1][0] * m1->t[0][2] + m0->t[1][1] * m1->t[1][2] + m0->t[1][2] * m1->t[2][2] + m0->t[1][3] * m1->t[3][2]; 
+        m.t[1][3] = m0->t[1][0] * m1->t[0][3] + m0->t[1][1] * m1->t[1][3] + m0->t[1][2] * m1->t[2][3] + m0->t[1][3] * m1->t[3][3];
+
+        m.t[2][0] = m0->t[2][0] * m1->t[0][0] + m0->t[2][1] * m1->t[1][0] + m0->t[2][2] * m1->t[2][0] + m0->t[2][3] * m1->t[3][0]; 
+        m.t[2][1] = m0->t[2][0] * m1->t[0][1] + m0->t[2][1] * m1->t[1][1] + m0->t[2][2] * m1->t[2][1] + m0->t[2][3] * m1->t[3][1]; 
+        m.t[2][2] = m0->t[2][0] * m1->t[0][2] + m0->t[2][1] * m1->t[1][2] + m0->t[2][2] * m1->t[2][2] + m0->t[2][3] * m1->t[3][2]; 
+        m.t[2][3] = m0->t[2][0] * m1->t[0][3] + m0->t[2][1] * m1->t[1][3] + m0->t[2][2] * m1->t[2][3] + m0->t[2][3] * m1->t[3][3];
+
+        m.t[3][0] = m0->t[3][0] * m1->t[0][0] + m0->t[3][1] * m1->t[1][0] + m0->t[3][2] * m1->t[2][0] + m0->t[3][3] * m1->t[3][0]; 
+        m.t[3][1] = m0->t[3][0] * m1->t[0][1] + m0->t[3][1] * m1->t[1][1] + m0->t[3][2] * m1->t[2][1] + m0->t[3][3] * m1->t[3][1]; 
+        m.t[3][2] = m0->t[3][0] * m1->t[0][2] + m0->t[3][1] * m1->t[1][2] + m0->t[3][2] * m1->t[2][2] + m0->t[3][3] * m1->t[3][2]; 
+        m.t[3][3] = m0->t[3][0] * m1->t[0][3] + m0->t[3][1] * m1->t[1][3] + m0->t[3][2] * m1->t[2][3] + m0->t[3][3] * m1->t[3][3];
+
+        return m;
+#endif
+}
+
+/** @brief Multiply a 4x4 matrix with a 4D vector and return a 4D vector. */
+SMATH_INLINE MT_V4 MT_V4_MULT(const MT_M *m, const MT_V4 *v) {
+#ifdef MT_SSE_V4_MULT
+        return MT_SSE_V4_MULT(m, v);
+#else
+        MT_V4 v1;
+
+        v1.x = m->t[0][0] * v->x + m->t[0][1] * v->y + m->t[0][2] * v->z + m->t[0][3] * v->w; 
+        v1.y = m->t[1][0] * v->x + m->t[1][1] * v->y + m->t[1][2] * v->z + m->t[1][3] * v->w; 
+        v1.z = m->t[2][0] * v->x + m->t[2][1] * v->y + m->t[2][2] * v->z + m->t[2][3] * v->w; 
+        v1.w = m->t[3][0] * v->x + m->t[3][1] * v->y + m->t[3][2] * v->z + m->t[3][3] * v->w; 
+
+        return v1;
+#endif
+}
+
+/** @brief Determinant of a 4x4 matrix, expanded over the 2x2 determinants of the top and bottom 2 rows. */
+SMATH_INLINE MT_S MT_FN(determinant)(const MT_M *m) {
+
+        const MT_S (*a)[4] = m->t;
+
+        MT_S s0 = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+        MT_S s1 = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+        MT_S s2 = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+        MT_S s3 = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+        MT_S s4 = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+        MT_S s5 = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+
+        MT_S c5 = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+        MT_S c4 = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+        MT_S c3 = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+        MT_S c2 = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+        MT_S c1 = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+        MT_S c0 = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+
+        return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+}
+
+/** 
+ * @brief Inverse and determinant of a 4x4 matrix with the cofactor method.
+ * 
+ * The 12 2x2 determinants of the top (s) and bottom (c) 2 rows give the
+ * determinant and every cofactor.
+ */
+SMATH_INLINE MT_M MT_FN(inverse_det)(const MT_M *m, MT_S *det) {
+
+        MT_M m1;
+        const MT_S (*a)[4] = m->t;
+
+        MT_S s0 = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+        MT_S s1 = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+        MT_S s2 = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+        MT_S s3 = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+        MT_S s4 = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+        MT_S s5 = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+
+        MT_S c5 = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+        MT_S c4 = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+        MT_S c3 = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+        MT_S c2 = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+        MT_S c1 = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+        MT_S c0 = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+
+        MT_S d = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        MT_S s = (MT_S)1 / d;
+
+        m1.t[0][0] = ( a[1][1] * c5 - a[1][2] * c4 + a[1][3] * c3) * s;
+        m1.t[0][1] = (-a[0][1] * c5 + a[0][2] * c4 - a[0][3] * c3) * s;
+        m1.t[0][2] = ( a[3][1] * s5 - a[3][2] * s4 + a[3][3] * s3) * s;
+        m1.t[0][3] = (-a[2][1] * s5 + a[2][2] * s4 - a[2][3] * s3) * s;
+
+        m1.t[1][0] = (-a[1][0] * c5 + a[1][2] * c2 - a[1][3] * c1) * s;
+        m1.t[1][1] = ( a[0][0] * c5 - a[0][2] * c2 + a[0][3] * c1) * s;
+        m1.t[1][2] = (-a[3][0] * s5 + a[3][2] * s2 - a[3][3] * s1) * s;
+        m1.t[1][3] = ( a[2][0] * s5 - a[2][2] * s2 + a[2][3] * s1) * s;
+
+        m1.t[2][0] = ( a[1][0] * c4 - a[1][1] * c2 + a[1][3] * c0) * s;
+        m1.t[2][1] = (-a[0][0] * c4 + a[0][1] * c2 - a[0][3] * c0) * s;
+        m1.t[2][2] = ( a[3][0] * s4 - a[3][1] * s2 + a[3][3] * s0) * s;
+        m1.t[2][3] = (-a[2][0] * s4 + a[2][1] * s2 - a[2][3] * s0) * s;
+
+        m1.t[3][0] = (-a[1][0] * c3 + a[1][1] * c1 - a[1][2] * c0) * s;
+        m1.t[3][1] = ( a[0][0] * c3 - a[0][1] * c1 + a[0][2] * c0) * s;
+        m1.t[3][2] = (-a[3][0] * s3 + a[3][1] * s1 - a[3][2] * s0) * s;
+        m1.t[3][3] = ( a[2][0] * s3 - a[2][1] * s1 + a[2][2] * s0) * s;
+
+        *det = d;
+
+        return m1;
+}
+
+/** @brief Inverse of a 4x4 matrix with the cofactor method. */
+SMATH_INLINE MT_M MT_FN(inverse)(const MT_M *m) {
+        MT_S det;
+        return MT_FN(inverse_det)(m, &det);
+}
+
+/** 
+ * @brief Inverse of an affine 4x4 matrix.
+ * 
+ * The columns of the inverse 3x3 part are the cross products of its rows
+ * divided by the determinant, the new translation is the old one
+ * transformed by that inverse and negated.
+ */
+SMATH_INLINE MT_M MT_FN(inverse_affine)(const MT_M *m) {
+
+        MT_M m1;
+        const MT_S *r0 = m->t[0];
+        const MT_S *r1 = m->t[1];
+        const MT_S *r2 = m->t[2];
+
+        MT_S c0[3] = {r1[1] * r2[2] - r1[2] * r2[1], r1[2] * r2[0] - r1[0] * r2[2], r1[0] * r2[1] - r1[1] * r2[0]};
+        MT_S c1[3] = {r2[1] * r0[2] - r2[2] * r0[1], r2[2] * r0[0] - r2[0] * r0[2], r2[0] * r0[1] - r2[1] * r0[0]};
+        MT_S c2[3] = {r0[1] * r1[2] - r0[2] * r1[1], r0[2] * r1[0] - r0[0] * r1[2], r0[0] * r1[1] - r0[1] * r1[0]};
+
+        MT_S s = (MT_S)1 / (r0[0] * c0[0] + r0[1] * c0[1] + r0[2] * c0[2]);
+
+        for (int i = 0; i < 3; ++i) {
+                m1.t[i][0] = c0[i] * s;
+                m1.t[i][1] = c1[i] * s;
+                m1.t[i][2] = c2[i] * s;
+                m1.t[i][3] = -(m1.t[i][0] * r0[3] + m1.t[i][1] * r1[3] + m1.t[i][2] * r2[3]);
+        }
+
+        m1.t[3][0] = (MT_S)0;
+        m1.t[3][1] = (MT_S)0;
+        m1.t[3][2] = (MT_S)0;
+        m1.t[3][3] = (MT_S)1;
+
+        return m1;
+}
+
+/** @brief Inverse of a rigid body 4x4 matrix, transpose the rotation and rotate the negated translation back. */
+SMATH_INLINE MT_M MT_FN(inverse_rigid)(const MT_M *m) {
+
+        MT_M m1;
+
+        for (int i = 0; i < 3; ++i) {
+                m1.t[i][0] = m->t[0][i];
+                m1.t[i][1] = m->t[1][i];
+                m1.t[i][2] = m->t[2][i];
+                m1.t[i][3] = -(m->t[0][i] * m->t[0][3] + m->t[1][i] * m->t[1][3] + m->t[2][i] * m->t[2][3]);
+        }
+
+        m1.t[3][0] = (MT_S)0;
+        m1.t[3][1] = (MT_S)0;
+        m1.t[3][2] = (MT_S)0;
+        m1.t[3][3] = (MT_S)1;
+
+        return m1;
+}
+
+
+#undef MT_S
+#undef MT_M
+#undef MT_V4
+#undef MT_FN
+#undef MT_V4_MULT
+#undef MT_SSE_MULT
+#undef MT_SSE_V4_MULT
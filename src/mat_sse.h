@@ -0,0 +1,65 @@
+#ifndef MAT_SSE_H
+#define MAT_SSE_H
+
+/*
+ * Private to the library.
+ *
+ * SSE helpers shared by the matrix source files, for the rows that are
+ * not a 16 byte vec4. Included by the .c files only (and so by the
+ * headerfiles in SMATH_HEADER_ONLY mode).
+ */
+
+#include "../include/math_types.h"
+#include "../include/smath_config.h"
+
+#ifdef SMATH_SSE
+#include <xmmintrin.h>
+
+/** @brief SIMD SSE - Load a 3D vector into x, y, z of a register, w is 0. Never reads past the vec3. */
+static inline __m128 mat_sse_load_vec3(const vec3 *v) {
+        return _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), (const __m64*)v), _mm_load_ss(&v->z));
+}
+
+/** @brief SIMD SSE - Store x, y, z of a register into a 3D vector. */
+static inline void mat_sse_store_vec3(vec3 *v, __m128 r) {
+        _mm_storel_pi((__m64*)v, r);
+        _mm_store_ss(&v->z, _mm_movehl_ps(r, r));
+}
+
+/** @brief SIMD SSE - Cross product of x, y, z, the w of the result is 0. */
+static inline __m128 mat_sse_cross(__m128 a, __m128 b) {
+        __m128 c = _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1))),
+                              _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1)), b));
+        return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+/** @brief SIMD SSE - Dot product of x, y, z, w in every lane. */
+static inline __m128 mat_sse_dot4(__m128 a, __m128 b) {
+        __m128 d = _mm_mul_ps(a, b);
+        d = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+/** @brief SIMD SSE - Dot product of x, y, z in every lane. */
+static inline __m128 mat_sse_dot3(__m128 a, __m128 b) {
+        __m128 d = _mm_mul_ps(a, b);
+        d = _mm_add_ss(_mm_add_ss(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(1, 1, 1, 1))), _mm_movehl_ps(d, d));
+        return _mm_shuffle_ps(d, d, _MM_SHUFFLE(0, 0, 0, 0));
+}
+
+/** @brief SIMD SSE - 1 / sqrt(a) from _mm_rsqrt_ps with one Newton-Raphson step, see fast_math.h. */
+static inline __m128 mat_sse_rsqrt_nr(__m128 a) {
+        __m128 y = _mm_rsqrt_ps(a);
+        __m128 hyy = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), a), y), y);
+        return _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), hyy));
+}
+
+/** @brief SIMD SSE - 1 / a from _mm_rcp_ps with one Newton-Raphson step, see fast_math.h. */
+static inline __m128 mat_sse_rcp_nr(__m128 a) {
+        __m128 y = _mm_rcp_ps(a);
+        return _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(2.0f), _mm_mul_ps(a, y)));
+}
+
+#endif // SMATH_SSE
+
+#endif // MAT_SSE_H
@@ -0,0 +1,496 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "../include/parallel.h"
+#include "../include/dispatch.h"
+#include "../include/transform.h"
+#include "../include/vector_soa.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#if !defined(_MSC_VER)
+#include <stdatomic.h>
+#endif
+
+
+/*
+ * Threads, locks and the 64-bit atomic the chunk ranges live in, Win32 on
+ * Windows and pthreads everywhere else.
+ */
+#if defined(_WIN32)
+
+typedef HANDLE pool_thread;
+typedef SRWLOCK pool_mutex;
+typedef CONDITION_VARIABLE pool_cond;
+
+#define POOL_MUTEX_INIT(m) InitializeSRWLock(m)
+#define POOL_MUTEX_FREE(m) ((void)(m))
+#define POOL_LOCK(m) AcquireSRWLockExclusive(m)
+#define POOL_UNLOCK(m) ReleaseSRWLockExclusive(m)
+#define POOL_COND_INIT(c) InitializeConditionVariable(c)
+#define POOL_COND_FREE(c) ((void)(c))
+#define POOL_WAIT(c, m) SleepConditionVariableSRW(c, m, INFINITE, 0)
+#define POOL_SIGNAL(c) WakeConditionVariable(c)
+#define POOL_BROADCAST(c) WakeAllConditionVariable(c)
+
+#else
+
+typedef pthread_t pool_thread;
+typedef pthread_mutex_t pool_mutex;
+typedef pthread_cond_t pool_cond;
+
+#define POOL_MUTEX_INIT(m) pthread_mutex_init(m, NULL)
+#define POOL_MUTEX_FREE(m) pthread_mutex_destroy(m)
+#define POOL_LOCK(m) pthread_mutex_lock(m)
+#define POOL_UNLOCK(m) pthread_mutex_unlock(m)
+#define POOL_COND_INIT(c) pthread_cond_init(c, NULL)
+#define POOL_COND_FREE(c) pthread_cond_destroy(c)
+#define POOL_WAIT(c, m) pthread_cond_wait(c, m)
+#define POOL_SIGNAL(c) pthread_cond_signal(c)
+#define POOL_BROADCAST(c) pthread_cond_broadcast(c)
+
+#endif
+
+#if defined(_MSC_VER)
+
+typedef volatile LONG64 pool_atomic;
+
+#define POOL_THREAD_LOCAL __declspec(thread)
+
+static u64 pool_load(pool_atomic *a) {
+        return (u64)InterlockedCompareExchange64(a, 0, 0);
+}
+
+static void pool_store(pool_atomic *a, u64 v) {
+        InterlockedExchange64(a, (LONG64)v);
+}
+
+static bool pool_cas(pool_atomic *a, u64 *expected, u64 desired) {
+        u64 old = (u64)InterlockedCompareExchange64(a, (LONG64)desired, (LONG64)*expected);
+        bool ok = old == *expected;
+        *expected = old;
+        return ok;
+}
+
+#else
+
+typedef _Atomic u64 pool_atomic;
+
+#define POOL_THREAD_LOCAL _Thread_local
+
+static u64 pool_load(pool_atomic *a) {
+        return atomic_load(a);
+}
+
+static void pool_store(pool_atomic *a, u64 v) {
+        atomic_store(a, v);
+}
+
+static bool pool_cas(pool_atomic *a, u64 *expected, u64 desired) {
+        return atomic_compare_exchange_weak(a, expected, desired);
+}
+
+#endif
+
+
+/**
+ * @brief The chunks a thread still has to run, [low 32 bits, high 32 bits).
+ *
+ * The owner takes from the front, thieves from the back, both with a
+ * compare and swap of the whole range. One cache line each so the threads
+ * do not slow each other down.
+ */
+typedef struct SMATH_ALIGN(64) pool_range {
+        pool_atomic range;
+} pool_range;
+
+/** @brief The built-in pool, workers threads wait for a job, the calling thread is worker 0. */
+static struct {
+        pool_thread threads[SMATH_POOL_MAX_THREADS];
+        pool_range ranges[SMATH_POOL_MAX_THREADS];
+        u32 workers;            /**< threads besides the calling one */
+        bool started;
+
+        pool_mutex submit;      /**< one job at a time */
+        pool_mutex lock;        /**< protects everything below */
+        pool_cond wake;
+        pool_cond done;
+
+        smath_task_fn task;
+        void *ctx;
+        u64 generation;         /**< incremented for every job */
+        u32 finished;           /**< workers done with the current job */
+        bool quit;
+} pool;
+
+static smath_scheduler_fn pool_scheduler;
+static void *pool_scheduler_user;
+
+/** @brief Set on the pool threads and while the calling thread runs chunks, nested jobs run inline. */
+static POOL_THREAD_LOCAL bool pool_inside;
+
+
+/** @brief Take the next chunk from the front of the own range. */
+static bool pool_pop(pool_atomic *a, u32 *chunk) {
+        u64 r = pool_load(a);
+
+        for (;;) {
+                u32 lo = (u32)r, hi = (u32)(r >> 32);
+
+                if (lo >= hi)
+                        return false;
+                if (pool_cas(a, &r, ((u64)hi << 32) | (lo + 1))) {
+                        *chunk = lo;
+                        return true;
+                }
+        }
+}
+
+/** @brief Take the last chunk of the range of another thread. */
+static bool pool_steal(pool_atomic *a, u32 *chunk) {
+        u64 r = pool_load(a);
+
+        for (;;) {
+                u32 lo = (u32)r, hi = (u32)(r >> 32);
+
+                if (lo >= hi)
+                        return false;
+                if (pool_cas(a, &r, ((u64)(hi - 1) << 32) | lo)) {
+                        *chunk = hi - 1;
+                        return true;
+                }
+        }
+}
+
+/** @brief Run the own chunks, then steal until every range is empty. */
+static void pool_work(u32 self, smath_task_fn task, void *ctx) {
+        u32 n = pool.workers + 1;
+        u32 chunk;
+
+        while (pool_pop(&pool.ranges[self].range, &chunk))
+                task(ctx, chunk);
+
+        for (u32 i = 1; i < n; ++i) {
+                pool_atomic *victim = &pool.ranges[(self + i) % n].range;
+
+                while (pool_steal(victim, &chunk))
+                        task(ctx, chunk);
+        }
+}
+
+/** @brief The loop of a pool thread, one pass of pool_work per job. */
+static void pool_main(u32 self) {
+        u64 seen = 0;
+
+        pool_inside = true;
+
+        POOL_LOCK(&pool.lock);
+
+        for (;;) {
+                while (pool.generation == seen && !pool.quit)
+                        POOL_WAIT(&pool.wake, &pool.lock);
+
+                if (pool.quit)
+                        break;
+
+                seen = pool.generation;
+                smath_task_fn task = pool.task;
+                void *ctx = pool.ctx;
+
+                POOL_UNLOCK(&pool.lock);
+                pool_work(self, task, ctx);
+                POOL_LOCK(&pool.lock);
+
+                if (++pool.finished == pool.workers)
+                        POOL_SIGNAL(&pool.done);
+        }
+
+        POOL_UNLOCK(&pool.lock);
+}
+
+#if defined(_WIN32)
+
+static DWORD WINAPI pool_entry(LPVOID arg) {
+        pool_main((u32)(size_t)arg);
+        return 0;
+}
+
+static bool pool_spawn(pool_thread *t, u32 self) {
+        *t = CreateThread(NULL, 0, pool_entry, (LPVOID)(size_t)self, 0, NULL);
+        return *t != NULL;
+}
+
+static void pool_join(pool_thread t) {
+        WaitForSingleObject(t, INFINITE);
+        CloseHandle(t);
+}
+
+static u32 pool_cores(void) {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return (u32)info.dwNumberOfProcessors;
+}
+
+#else
+
+static void *pool_entry(void *arg) {
+        pool_main((u32)(size_t)arg);
+        return NULL;
+}
+
+static bool pool_spawn(pool_thread *t, u32 self) {
+        return pthread_create(t, NULL, pool_entry, (void*)(size_t)self) == 0;
+}
+
+static void pool_join(pool_thread t) {
+        pthread_join(t, NULL);
+}
+
+static u32 pool_cores(void) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        return n > 0 ? (u32)n : 1;
+}
+
+#endif
+
+
+/** @brief Start the built-in pool with threads - 1 workers. */
+bool smath_pool_start(u32 threads) {
+        smath_pool_stop();
+
+        if (threads == 0)
+                threads = pool_cores();
+        if (threads > SMATH_POOL_MAX_THREADS)
+                threads = SMATH_POOL_MAX_THREADS;
+        if (threads <= 1)
+                return true;
+
+        POOL_MUTEX_INIT(&pool.submit);
+        POOL_MUTEX_INIT(&pool.lock);
+        POOL_COND_INIT(&pool.wake);
+        POOL_COND_INIT(&pool.done);
+        pool.generation = 0;
+        pool.quit = false;
+        pool.started = true;
+
+        for (u32 i = 1; i < threads; ++i) {
+                if (!pool_spawn(&pool.threads[i], i)) {
+                        smath_pool_stop();
+                        return false;
+                }
+                pool.workers = i;
+        }
+
+        return true;
+}
+
+/** @brief Stop the built-in pool and join its threads. */
+void smath_pool_stop(void) {
+        if (!pool.started)
+                return;
+
+        POOL_LOCK(&pool.lock);
+        pool.quit = true;
+        POOL_BROADCAST(&pool.wake);
+        POOL_UNLOCK(&pool.lock);
+
+        for (u32 i = 1; i <= pool.workers; ++i)
+                pool_join(pool.threads[i]);
+
+        pool.workers = 0;
+        pool.started = false;
+
+        POOL_COND_FREE(&pool.done);
+        POOL_COND_FREE(&pool.wake);
+        POOL_MUTEX_FREE(&pool.lock);
+        POOL_MUTEX_FREE(&pool.submit);
+}
+
+/** @brief Get the size of the built-in pool. */
+u32 smath_pool_threads(void) {
+        return pool.workers + 1;
+}
+
+/** @brief Run the parallel jobs on the scheduler of the application. */
+void smath_set_scheduler(smath_scheduler_fn fn, void *user) {
+        pool_scheduler = fn;
+        pool_scheduler_user = user;
+}
+
+/**
+ * @brief Run task(ctx, c) for every chunk on the scheduler, the pool or inline.
+ *
+ * The chunks are dealt out in equal contiguous ranges, one per thread, so
+ * neighbouring chunks usually run on the same core.
+ */
+void smath_parallel_for(smath_task_fn task, void *ctx, size_t chunks) {
+        if (chunks == 0)
+                return;
+
+        if (pool_scheduler) {
+                pool_scheduler(pool_scheduler_user, task, ctx, chunks);
+                return;
+        }
+
+        if (pool.workers == 0 || chunks == 1 || chunks > UINT32_MAX || pool_inside) {
+                for (size_t c = 0; c < chunks; ++c)
+                        task(ctx, c);
+                return;
+        }
+
+        POOL_LOCK(&pool.submit);
+
+        u32 n = pool.workers + 1;
+
+        for (u32 i = 0; i < n; ++i) {
+                u64 lo = (u64)chunks * i / n, hi = (u64)chunks * (i + 1) / n;
+                pool_store(&pool.ranges[i].range, (hi << 32) | lo);
+        }
+
+        POOL_LOCK(&pool.lock);
+        pool.task = task;
+        pool.ctx = ctx;
+        pool.finished = 0;
+        ++pool.generation;
+        POOL_BROADCAST(&pool.wake);
+        POOL_UNLOCK(&pool.lock);
+
+        pool_inside = true;
+        pool_work(0, task, ctx);
+        pool_inside = false;
+
+        // Every chunk has been taken, wait for the ones still running.
+        POOL_LOCK(&pool.lock);
+        while (pool.finished != pool.workers)
+                POOL_WAIT(&pool.done, &pool.lock);
+        POOL_UNLOCK(&pool.lock);
+
+        POOL_UNLOCK(&pool.submit);
+}
+
+/** @brief Elements per chunk, about SMATH_PARALLEL_CHUNK_BYTES and a multiple of SMATH_SOA_WIDTH. */
+size_t smath_parallel_chunk(size_t elem_bytes) {
+        size_t n = SMATH_PARALLEL_CHUNK_BYTES / elem_bytes / SMATH_SOA_WIDTH * SMATH_SOA_WIDTH;
+        return n ? n : SMATH_SOA_WIDTH;
+}
+
+
+/** @brief The arguments of an array kernel split into chunks of size elements. */
+typedef struct parallel_job {
+        const smath_kernels *k;
+        const void *m;
+        const void *in0;
+        const void *in1;
+        void *out;
+        size_t n;
+        size_t size;
+} parallel_job;
+
+/** @brief Chunks for n elements, the last one may be shorter. */
+static size_t parallel_chunks(parallel_job *job, size_t n, size_t elem_bytes) {
+        job->n = n;
+        job->size = smath_parallel_chunk(elem_bytes);
+        return (n + job->size - 1) / job->size;
+}
+
+/** @brief First element and length of a chunk. */
+static size_t parallel_range(const parallel_job *job, size_t chunk, size_t *len) {
+        size_t begin = chunk * job->size;
+        *len = job->n - begin < job->size ? job->n - begin : job->size;
+        return begin;
+}
+
+
+static void mult_array_task(void *ctx, size_t chunk) {
+        const parallel_job *job = ctx;
+        size_t len, i = parallel_range(job, chunk, &len);
+        job->k->mat4x4_mult_array((mat4x4*)job->out + i, (const mat4x4*)job->in0 + i,
+                                               (const mat4x4*)job->in1 + i, len);
+}
+
+/** @brief mat4x4_mult_array over several threads. */
+void mat4x4_mult_array_parallel(mat4x4 *dest, const mat4x4 *m0, const mat4x4 *m1, size_t n) {
+        parallel_job job = { smath_get_kernels(), NULL, m0, m1, dest, 0, 0 };
+        smath_parallel_for(mult_array_task, &job, parallel_chunks(&job, n, 3 * sizeof(mat4x4)));
+}
+
+
+static void points_task(void *ctx, size_t chunk) {
+        const parallel_job *job = ctx;
+        size_t len, i = parallel_range(job, chunk, &len);
+        job->k->mat4x4_transform_points(job->m, (const vec3*)job->in0 + i, (vec3*)job->out + i, len);
+}
+
+/** @brief mat4x4_transform_points over several threads. */
+void mat4x4_transform_points_parallel(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n) {
+        parallel_job job = { smath_get_kernels(), m, in, NULL, out, 0, 0 };
+        smath_parallel_for(points_task, &job, parallel_chunks(&job, n, 2 * sizeof(vec3)));
+}
+
+
+static void directions_task(void *ctx, size_t chunk) {
+        const parallel_job *job = ctx;
+        size_t len, i = parallel_range(job, chunk, &len);
+        job->k->mat4x4_transform_directions(job->m, (const vec3*)job->in0 + i, (vec3*)job->out + i, len);
+}
+
+/** @brief mat4x4_transform_directions over several threads. */
+void mat4x4_transform_directions_parallel(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n) {
+        parallel_job job = { smath_get_kernels(), m, in, NULL, out, 0, 0 };
+        smath_parallel_for(directions_task, &job, parallel_chunks(&job, n, 2 * sizeof(vec3)));
+}
+
+
+static void vec4s_task(void *ctx, size_t chunk) {
+        const parallel_job *job = ctx;
+        size_t len, i = parallel_range(job, chunk, &len);
+        job->k->mat4x4_transform_vec4s(job->m, (const vec4*)job->in0 + i, (vec4*)job->out + i, len);
+}
+
+/** @brief mat4x4_transform_vec4s over several threads. */
+void mat4x4_transform_vec4s_parallel(const mat4x4 *m, const vec4 *in, vec4 *out, size_t n) {
+        parallel_job job = { smath_get_kernels(), m, in, NULL, out, 0, 0 };
+        smath_parallel_for(vec4s_task, &job, parallel_chunks(&job, n, 2 * sizeof(vec4)));
+}
+
+
+/*
+ * The soa kernels take a whole vec3_soa/vec4_soa, a chunk is a view into
+ * the arrays. The chunk size is a multiple of SMATH_SOA_WIDTH, so every
+ * view starts 64 byte aligned and the padding of the last one stays
+ * inside the capacity.
+ */
+static void vec3_soa_normalize_task(void *ctx, size_t chunk) {
+        const parallel_job *job = ctx;
+        const vec3_soa *v = job->out;
+        size_t len, i = parallel_range(job, chunk, &len);
+        vec3_soa view = { v->x + i, v->y + i, v->z + i, len, v->capacity - i };
+        job->k->vec3_soa_normalize(&view);
+}
+
+/** @brief vec3_soa_normalize over several threads. */
+void vec3_soa_normalize_parallel(vec3_soa *v) {
+        parallel_job job = { smath_get_kernels(), NULL, NULL, NULL, v, 0, 0 };
+        smath_parallel_for(vec3_soa_normalize_task, &job, parallel_chunks(&job, v->count, 2 * sizeof(vec3)));
+}
+
+
+static void vec4_soa_normalize_task(void *ctx, size_t chunk) {
+        const parallel_job *job = ctx;
+        const vec4_soa *v = job->out;
+        size_t len, i = parallel_range(job, chunk, &len);
+        vec4_soa view = { v->x + i, v->y + i, v->z + i, v->w + i, len, v->capacity - i };
+        job->k->vec4_soa_normalize(&view);
+}
+
+/** @brief vec4_soa_normalize over several threads. */
+void vec4_soa_normalize_parallel(vec4_soa *v) {
+        parallel_job job = { smath_get_kernels(), NULL, NULL, NULL, v, 0, 0 };
+        smath_parallel_for(vec4_soa_normalize_task, &job, parallel_chunks(&job, v->count, 2 * sizeof(vec4)));
+}
@@ -0,0 +1,222 @@
+#include <math.h>
+
+#include "../include/quat.h"
+#include "../include/types.h"
+#include "../include/math_types.h"
+
+#ifdef SMATH_SSE
+#include <xmmintrin.h>
+#endif
+
+/** @brief Create a quaternion that rotates around a normalized axis by angle radians. */
+SMATH_INLINE quat quat_create_from_axis_angle(const vec3 *axis, const f32 angle) {
+
+        quat q;
+        f32 s = sinf(angle * 0.5F);
+
+        q.x = axis->x * s;
+        q.y = axis->y * s;
+        q.z = axis->z * s;
+        q.w = cosf(angle * 0.5F);
+
+        return q;
+}
+
+/** @brief Multiply two quaternions and return a new quaternion. */
+SMATH_INLINE quat quat_mult(const quat *q0, const quat *q1) {
+
+        quat q;
+
+        q.x = q0->w * q1->x + q0->x * q1->w + q0->y * q1->z - q0->z * q1->y;
+        q.y = q0->w * q1->y - q0->x * q1->z + q0->y * q1->w + q0->z * q1->x;
+        q.z = q0->w * q1->z + q0->x * q1->y - q0->y * q1->x + q0->z * q1->w;
+        q.w = q0->w * q1->w - q0->x * q1->x - q0->y * q1->y - q0->z * q1->z;
+
+        return q;
+}
+
+/** @brief Conjugate a quaternion. */
+SMATH_INLINE quat quat_conjugate(const quat *q) {
+
+        quat q1;
+
+        q1.x = -q->x;
+        q1.y = -q->y;
+        q1.z = -q->z;
+        q1.w = q->w;
+
+        return q1;
+}
+
+/** @brief Rotate a 3D vector with a quaternion, v + w * t + u x t with t = 2 * (u x v). */
+SMATH_INLINE vec3 quat_rotate_vec3(const quat *q, const vec3 *v) {
+
+        vec3 u = {q->x, q->y, q->z};
+        vec3 t = vec3_cross_product(&u, v);
+
+        t.x += t.x;
+        t.y += t.y;
+        t.z += t.z;
+
+        vec3 c = vec3_cross_product(&u, &t);
+        vec3 v1;
+
+        v1.x = v->x + q->w * t.x + c.x;
+        v1.y = v->y + q->w * t.y + c.y;
+        v1.z = v->z + q->w * t.z + c.z;
+
+        return v1;
+}
+
+/** @brief Blend two quaternions linearly along the shorter arc and normalize. */
+SMATH_INLINE quat quat_nlerp(const quat *q0, const quat *q1, const f32 t) {
+
+        quat q;
+        f32 dot = q0->x * q1->x + q0->y * q1->y + q0->z * q1->z + q0->w * q1->w;
+        f32 a = 1.0F - t;
+        f32 b = dot < 0.0F ? -t : t;
+
+        q.x = a * q0->x + b * q1->x;
+        q.y = a * q0->y + b * q1->y;
+        q.z = a * q0->z + b * q1->z;
+        q.w = a * q0->w + b * q1->w;
+
+        f32 s = 1.0F / sqrtf(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+
+        q.x *= s;
+        q.y *= s;
+        q.z *= s;
+        q.w *= s;
+
+        return q;
+}
+
+/** @brief Blend two quaternions along the shorter arc with a constant angular speed. */
+SMATH_INLINE quat quat_slerp(const quat *q0, const quat *q1, const f32 t) {
+
+        quat q;
+        f32 dot = q0->x * q1->x + q0->y * q1->y + q0->z * q1->z + q0->w * q1->w;
+        f32 sign = 1.0F;
+
+        if (dot < 0.0F) {
+                dot = -dot;
+                sign = -1.0F;
+        }
+
+        // sin(angle) gets too small to divide by.
+        if (dot > 0.9995F)
+                return quat_nlerp(q0, q1, t);
+
+        f32 angle = acosf(dot);
+        f32 s = 1.0F / sinf(angle);
+        f32 a = sinf((1.0F - t) * angle) * s;
+        f32 b = sinf(t * angle) * s * sign;
+
+        q.x = a * q0->x + b * q1->x;
+        q.y = a * q0->y + b * q1->y;
+        q.z = a * q0->z + b * q1->z;
+        q.w = a * q0->w + b * q1->w;
+
+        return q;
+}
+
+/** @brief Create a rotation matrix from a unit quaternion. */
+SMATH_INLINE mat4x4 quat_to_mat4x4(const quat *q) {
+
+        mat4x4 m;
+
+        f32 xx = q->x * q->x, yy = q->y * q->y, zz = q->z * q->z;
+        f32 xy = q->x * q->y, xz = q->x * q->z, yz = q->y * q->z;
+        f32 wx = q->w * q->x, wy = q->w * q->y, wz = q->w * q->z;
+
+        m.t[0][0] = 1.0F - 2.0F * (yy + zz);
+        m.t[0][1] = 2.0F * (xy - wz);
+        m.t[0][2] = 2.0F * (xz + wy);
+        m.t[0][3] = 0.0F;
+
+        m.t[1][0] = 2.0F * (xy + wz);
+        m.t[1][1] = 1.0F - 2.0F * (xx + zz);
+        m.t[1][2] = 2.0F * (yz - wx);
+        m.t[1][3] = 0.0F;
+
+        m.t[2][0] = 2.0F * (xz - wy);
+        m.t[2][1] = 2.0F * (yz + wx);
+        m.t[2][2] = 1.0F - 2.0F * (xx + yy);
+        m.t[2][3] = 0.0F;
+
+        m.t[3][0] = 0.0F;
+        m.t[3][1] = 0.0F;
+        m.t[3][2] = 0.0F;
+        m.t[3][3] = 1.0F;
+
+        return m;
+}
+
+/** @brief Create a quaternion from a rotation matrix, starting from the largest of w, x, y, z to stay precise. */
+SMATH_INLINE quat quat_from_mat4x4(const mat4x4 *m) {
+
+        quat q;
+        const f32 (*a)[4] = m->t;
+        f32 trace = a[0][0] + a[1][1] + a[2][2];
+
+        if (trace > 0.0F) {
+                f32 s = 0.5F / sqrtf(trace + 1.0F);
+                q.w = 0.25F / s;
+                q.x = (a[2][1] - a[1][2]) * s;
+                q.y = (a[0][2] - a[2][0]) * s;
+                q.z = (a[1][0] - a[0][1]) * s;
+        } else if (a[0][0] > a[1][1] && a[0][0] > a[2][2]) {
+                f32 s = 0.5F / sqrtf(1.0F + a[0][0] - a[1][1] - a[2][2]);
+                q.w = (a[2][1] - a[1][2]) * s;
+                q.x = 0.25F / s;
+                q.y = (a[0][1] + a[1][0]) * s;
+                q.z = (a[0][2] + a[2][0]) * s;
+        } else if (a[1][1] > a[2][2]) {
+                f32 s = 0.5F / sqrtf(1.0F + a[1][1] - a[0][0] - a[2][2]);
+                q.w = (a[0][2] - a[2][0]) * s;
+                q.x = (a[0][1] + a[1][0]) * s;
+                q.y = 0.25F / s;
+                q.z = (a[1][2] + a[2][1]) * s;
+        } else {
+                f32 s = 0.5F / sqrtf(1.0F + a[2][2] - a[0][0] - a[1][1]);
+                q.w = (a[1][0] - a[0][1]) * s;
+                q.x = (a[0][2] + a[2][0]) * s;
+                q.y = (a[1][2] + a[2][1]) * s;
+                q.z = 0.25F / s;
+        }
+
+        return q;
+}
+
+
+
+#ifdef SMATH_SSE
+
+/** @brief SIMD SSE - Multiply two quaternions, w0 * q1 plus 3 shuffled and sign flipped copies of q1. */
+SMATH_INLINE quat quat_sse_mult(const quat *q0, const quat *q1) {
+
+        quat q;
+
+        __m128 a = _mm_load_ps((const f32*)q0);
+        __m128 b = _mm_load_ps((const f32*)q1);
+
+        __m128 r = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), b);
+
+        // x0 * ( w1, -z1,  y1, -x1)
+        __m128 t = _mm_mul_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 1, 2, 3)), _mm_setr_ps(1.0F, -1.0F, 1.0F, -1.0F));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), t));
+
+        // y0 * ( z1,  w1, -x1, -y1)
+        t = _mm_mul_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2)), _mm_setr_ps(1.0F, 1.0F, -1.0F, -1.0F));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), t));
+
+        // z0 * (-y1,  x1,  w1, -z1)
+        t = _mm_mul_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)), _mm_setr_ps(-1.0F, 1.0F, 1.0F, -1.0F));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), t));
+
+        _mm_store_ps((f32*)&q, r);
+
+        return q;
+}
+
+#endif // SMATH_SSE
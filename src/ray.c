@@ -0,0 +1,157 @@
+#include <math.h>
+
+#include "../include/ray.h"
+#include "../include/dispatch.h"
+
+
+/*
+ * The single ray tests use the same operations in the same order as the
+ * packet kernels (kernels_ray.h), so the scalar kernels give the same
+ * results bit for bit.
+ */
+
+static inline vec3 ray_sub(const vec3 *a, const vec3 *b) {
+        return (vec3){ a->x - b->x, a->y - b->y, a->z - b->z };
+}
+
+static inline f32 ray_dot(const vec3 *a, const vec3 *b) {
+        return a->x * b->x + a->y * b->y + a->z * b->z;
+}
+
+static inline vec3 ray_cross(const vec3 *a, const vec3 *b) {
+        return (vec3){ a->y * b->z - a->z * b->y, a->z * b->x - a->x * b->z, a->x * b->y - a->y * b->x };
+}
+
+/** @brief Like minps, b when either one is NaN. */
+static inline f32 ray_min(f32 a, f32 b) {
+        return a < b ? a : b;
+}
+
+/** @brief Like maxps, b when either one is NaN. */
+static inline f32 ray_max(f32 a, f32 b) {
+        return a > b ? a : b;
+}
+
+
+/**
+ * @brief Moller-Trumbore, solve origin + t * direction = v0 + u * e1 + v * e2 with Cramer's rule.
+ *
+ * The determinant is e1 . (direction x e2), it is 0 for a degenerate
+ * triangle or a ray parallel to it. The hit is inside when u >= 0,
+ * v >= 0 and u + v <= 1.
+ */
+bool ray_intersect_triangle(const ray *r, const triangle *tri, f32 t_max, f32 *t) {
+        vec3 e1 = ray_sub(&tri->v1, &tri->v0);
+        vec3 e2 = ray_sub(&tri->v2, &tri->v0);
+        vec3 p = ray_cross(&r->direction, &e2);
+        f32 det = ray_dot(&e1, &p);
+
+        if (det == 0.0f)
+                return false;
+
+        f32 inv = 1.0f / det;
+        vec3 s = ray_sub(&r->origin, &tri->v0);
+        vec3 q = ray_cross(&s, &e1);
+        f32 u = ray_dot(&s, &p) * inv;
+        f32 v = ray_dot(&r->direction, &q) * inv;
+        f32 d = ray_dot(&e2, &q) * inv;
+
+        if (ray_min(ray_min(u, v), ray_min(1.0f - (u + v), d)) < 0.0f || !(d < t_max))
+                return false;
+
+        *t = d;
+        return true;
+}
+
+/**
+ * @brief Clip the ray against the 3 slabs of the box.
+ *
+ * The entry is the last of the near slab distances and the exit the
+ * first of the far ones, clamped to 0 so a ray starting inside hits at 0.
+ */
+bool ray_intersect_aabb(const ray *r, const aabb *b, f32 t_max, f32 *t) {
+        f32 ix = 1.0f / r->direction.x, iy = 1.0f / r->direction.y, iz = 1.0f / r->direction.z;
+        f32 x0 = (b->min.x - r->origin.x) * ix, x1 = (b->max.x - r->origin.x) * ix;
+        f32 y0 = (b->min.y - r->origin.y) * iy, y1 = (b->max.y - r->origin.y) * iy;
+        f32 z0 = (b->min.z - r->origin.z) * iz, z1 = (b->max.z - r->origin.z) * iz;
+
+        f32 t_near = ray_max(ray_max(ray_min(x0, x1), ray_min(y0, y1)), ray_max(ray_min(z0, z1), 0.0f));
+        f32 t_far = ray_min(ray_min(ray_max(x0, x1), ray_max(y0, y1)), ray_max(z0, z1));
+
+        if (t_far < t_near || !(t_near < t_max))
+                return false;
+
+        *t = t_near;
+        return true;
+}
+
+/**
+ * @brief Solve |origin + t * direction - center|^2 = radius^2 for t.
+ *
+ * With oc = origin - center the roots are (-b -+ sqrt(b^2 - a * c)) / a,
+ * a = direction . direction, b = oc . direction and c = oc . oc - radius^2.
+ * The sphere is behind the ray when the far root is negative.
+ */
+bool ray_intersect_sphere(const ray *r, const sphere *s, f32 t_max, f32 *t) {
+        vec3 oc = ray_sub(&r->origin, &s->center);
+        f32 a = ray_dot(&r->direction, &r->direction);
+        f32 b = ray_dot(&oc, &r->direction);
+        f32 c = ray_dot(&oc, &oc) - s->radius * s->radius;
+        f32 disc = b * b - a * c;
+
+        if (disc < 0.0f)
+                return false;
+
+        f32 sq = sqrtf(disc);
+        f32 t0 = ray_max((-b - sq) / a, 0.0f);
+        f32 t1 = (sq - b) / a;
+
+        if (t1 < 0.0f || !(t0 < t_max))
+                return false;
+
+        *t = t0;
+        return true;
+}
+
+/** @brief t = -(normal . origin + w) / (normal . direction). */
+bool ray_intersect_plane(const ray *r, const plane *p, f32 t_max, f32 *t) {
+        vec3 n = { p->x, p->y, p->z };
+        f32 d = -(ray_dot(&n, &r->origin) + p->w) / ray_dot(&n, &r->direction);
+
+        if (d < 0.0f || !(d < t_max))
+                return false;
+
+        *t = d;
+        return true;
+}
+
+
+/** @brief Test the triangles with the dispatched kernel. */
+bool ray_intersect_triangles(const ray *r, const triangle_soa *tris, f32 t_max, f32 *t, size_t *index) {
+        return smath_get_kernels()->ray_intersect_triangles(r, tris, t_max, t, index);
+}
+
+/** @brief Test the spheres with the dispatched kernel. */
+bool ray_intersect_spheres(const ray *r, const sphere_soa *s, f32 t_max, f32 *t, size_t *index) {
+        return smath_get_kernels()->ray_intersect_spheres(r, s, t_max, t, index);
+}
+
+/** @brief Test the boxes with the dispatched kernel. */
+bool ray_intersect_aabbs(const ray *r, const aabb_soa *b, f32 t_max, f32 *t, size_t *index) {
+        return smath_get_kernels()->ray_intersect_aabbs(r, b, t_max, t, index);
+}
+
+/** @brief Test the rays with the dispatched kernel. */
+void ray_soa_intersect_aabb(const ray_soa *r, const aabb *b, const f32 *t_max, f32 *t, u32 *hits) {
+        smath_get_kernels()->ray_soa_intersect_aabb(r, b, t_max, t, hits);
+}
+
+/** @brief Test the rays with the dispatched kernel. */
+void ray_soa_intersect_sphere(const ray_soa *r, const sphere *s, const f32 *t_max, f32 *t, u32 *hits) {
+        smath_get_kernels()->ray_soa_intersect_sphere(r, s, t_max, t, hits);
+}
+
+/** @brief Test the rays with the dispatched kernel. */
+void ray_soa_intersect_plane(const ray_soa *r, const plane *p, const f32 *t_max, f32 *t, u32 *hits) {
+        smath_get_kernels()->ray_soa_intersect_plane(r, p, t_max, t, hits);
+}
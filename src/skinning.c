@@ -0,0 +1,65 @@
+#include <math.h>
+
+#include "../include/skinning.h"
+#include "../include/dispatch.h"
+#include "../include/quat.h"
+
+
+/** @brief The world matrix times the inverse bind pose, the rows of the product are the columns of the palette entry. */
+void skin_palette_from_mat4x4(mat3x4 *dest, const mat4x4 *world, const mat4x4 *inverse_bind, size_t n) {
+        const smath_kernels *k = smath_get_kernels();
+
+        for (size_t i = 0; i < n; ++i) {
+                mat4x4 m = k->mat4x4_mult(&world[i], &inverse_bind[i]);
+
+                for (int c = 0; c < 4; ++c) {
+                        dest[i].t[c].x = m.t[0][c];
+                        dest[i].t[c].y = m.t[1][c];
+                        dest[i].t[c].z = m.t[2][c];
+                }
+        }
+}
+
+/** @brief The rotation of the normalized axes, then dual = 0.5 * (t, 0) * real. */
+dual_quat dual_quat_from_mat3x4(const mat3x4 *m) {
+        mat4x4 r = { 0 };
+
+        for (int c = 0; c < 3; ++c) {
+                const vec3 *a = &m->t[c];
+                f32 l = sqrtf(a->x * a->x + a->y * a->y + a->z * a->z);
+                f32 s = l > 0.0f ? 1.0f / l : 0.0f;
+
+                r.t[0][c] = a->x * s;
+                r.t[1][c] = a->y * s;
+                r.t[2][c] = a->z * s;
+        }
+        r.t[3][3] = 1.0f;
+
+        dual_quat dq;
+        quat t = { 0.5f * m->t[3].x, 0.5f * m->t[3].y, 0.5f * m->t[3].z, 0.0f };
+
+        dq.real = quat_from_mat4x4(&r);
+        dq.dual = quat_mult(&t, &dq.real);
+        return dq;
+}
+
+/** @brief Convert every entry with dual_quat_from_mat3x4. */
+void skin_palette_to_dual_quat(dual_quat *dest, const mat3x4 *palette, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                dest[i] = dual_quat_from_mat3x4(&palette[i]);
+        }
+}
+
+/** @brief Skin with the dispatched kernel. */
+void skin_linear(const mat3x4 *palette, const skin_influence *influences,
+                 const vec3 *positions, const vec3 *normals,
+                 vec3 *out_positions, vec3 *out_normals, size_t n) {
+        smath_get_kernels()->skin_linear(palette, influences, positions, normals, out_positions, out_normals, n);
+}
+
+/** @brief Skin with the dispatched kernel. */
+void skin_dual_quat(const dual_quat *palette, const skin_influence *influences,
+                    const vec3 *positions, const vec3 *normals,
+                    vec3 *out_positions, vec3 *out_normals, size_t n) {
+        smath_get_kernels()->skin_dual_quat(palette, influences, positions, normals, out_positions, out_normals, n);
+}
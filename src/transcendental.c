@@ -0,0 +1,38 @@
+#include "../include/transcendental.h"
+#include "../include/dispatch.h"
+
+
+/** @brief Sine of every element. */
+void smath_sin_array(f32 *dest, const f32 *x, size_t n, smath_accuracy acc) {
+        smath_get_kernels()->sin_array(dest, x, n, acc);
+}
+
+/** @brief Cosine of every element. */
+void smath_cos_array(f32 *dest, const f32 *x, size_t n, smath_accuracy acc) {
+        smath_get_kernels()->cos_array(dest, x, n, acc);
+}
+
+/** @brief Sine and cosine of every element. */
+void smath_sincos_array(f32 *dest_sin, f32 *dest_cos, const f32 *x, size_t n, smath_accuracy acc) {
+        smath_get_kernels()->sincos_array(dest_sin, dest_cos, x, n, acc);
+}
+
+/** @brief atan2 of every pair. */
+void smath_atan2_array(f32 *dest, const f32 *y, const f32 *x, size_t n, smath_accuracy acc) {
+        smath_get_kernels()->atan2_array(dest, y, x, n, acc);
+}
+
+/** @brief e^x of every element. */
+void smath_exp_array(f32 *dest, const f32 *x, size_t n, smath_accuracy acc) {
+        smath_get_kernels()->exp_array(dest, x, n, acc);
+}
+
+/** @brief Natural logarithm of every element. */
+void smath_log_array(f32 *dest, const f32 *x, size_t n, smath_accuracy acc) {
+        smath_get_kernels()->log_array(dest, x, n, acc);
+}
+
+/** @brief x^y of every pair. */
+void smath_pow_array(f32 *dest, const f32 *x, const f32 *y, size_t n, smath_accuracy acc) {
+        smath_get_kernels()->pow_array(dest, x, y, n, acc);
+}
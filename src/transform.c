@@ -0,0 +1,50 @@
+#include "../include/transform.h"
+#include "../include/dispatch.h"
+
+
+/** @brief Transform an array of 3D points (w = 1) with the dispatched kernel. */
+void mat4x4_transform_points(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n) {
+        smath_get_kernels()->mat4x4_transform_points(m, in, out, n);
+}
+
+
+/** @brief Transform an array of 3D directions (w = 0) with the dispatched kernel. */
+void mat4x4_transform_directions(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n) {
+        smath_get_kernels()->mat4x4_transform_directions(m, in, out, n);
+}
+
+
+/** @brief Transform an array of 4D vectors with the dispatched kernel. */
+void mat4x4_transform_vec4s(const mat4x4 *m, const vec4 *in, vec4 *out, size_t n) {
+        smath_get_kernels()->mat4x4_transform_vec4s(m, in, out, n);
+}
+
+
+/** @brief Transform an array of 3D points with non-temporal stores. */
+void mat4x4_transform_points_stream(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n) {
+        smath_get_kernels()->mat4x4_transform_points_stream(m, in, out, n);
+}
+
+
+/** @brief Transform an array of 4D vectors with non-temporal stores. */
+void mat4x4_transform_vec4s_stream(const mat4x4 *m, const vec4 *in, vec4 *out, size_t n) {
+        smath_get_kernels()->mat4x4_transform_vec4s_stream(m, in, out, n);
+}
+
+
+/** @brief Build TRS matrices with the dispatched kernel. */
+void mat4x4_from_trs_array(mat4x4 *dest, const vec3 *t, const quat *r, const vec3 *s, size_t n) {
+        smath_get_kernels()->mat4x4_from_trs_array(dest, t, r, s, n);
+}
+
+
+/** @brief m times TRS matrices with the dispatched kernel. */
+void mat4x4_from_trs_mult_array(mat4x4 *dest, const mat4x4 *m, const vec3 *t, const quat *r, const vec3 *s, size_t n) {
+        smath_get_kernels()->mat4x4_from_trs_mult_array(dest, m, t, r, s, n);
+}
+
+
+/** @brief Build affine TRS matrices with the dispatched kernel. */
+void mat4x3_from_trs_array(mat4x3 *dest, const vec3 *t, const quat *r, const vec3 *s, size_t n) {
+        smath_get_kernels()->mat4x3_from_trs_array(dest, t, r, s, n);
+}
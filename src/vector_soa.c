@@ -0,0 +1,215 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/vector_soa.h"
+#include "../include/dispatch.h"
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+
+/** @brief Allocate size bytes aligned to 64, size is a multiple of 64. */
+static void *soa_alloc(size_t size) {
+#if defined(_WIN32)
+        return _aligned_malloc(size, 64);
+#else
+        return aligned_alloc(64, size);
+#endif
+}
+
+/** @brief Free memory from soa_alloc. */
+static void soa_free(void *p) {
+#if defined(_WIN32)
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+}
+
+/** @brief Round a count up to a multiple of SMATH_SOA_WIDTH, never 0. */
+static size_t soa_capacity(size_t count) {
+        size_t c = (count + SMATH_SOA_WIDTH - 1) / SMATH_SOA_WIDTH * SMATH_SOA_WIDTH;
+        return c ? c : SMATH_SOA_WIDTH;
+}
+
+
+/** @brief Allocate the 3 arrays of a vec3_soa in one block. */
+bool vec3_soa_create(vec3_soa *soa, size_t count) {
+        size_t capacity = soa_capacity(count);
+        f32 *p = soa_alloc(3 * capacity * sizeof(f32));
+
+        if (!p)
+                return false;
+
+        memset(p, 0, 3 * capacity * sizeof(f32));
+
+        soa->x = p;
+        soa->y = p + capacity;
+        soa->z = p + 2 * capacity;
+        soa->count = count;
+        soa->capacity = capacity;
+
+        return true;
+}
+
+/** @brief Free the arrays of a vec3_soa. */
+void vec3_soa_destroy(vec3_soa *soa) {
+        soa_free(soa->x);
+        soa->x = soa->y = soa->z = NULL;
+        soa->count = soa->capacity = 0;
+}
+
+/** @brief Copy an array of 3D vectors into a structure of arrays. */
+void vec3_soa_from_aos(vec3_soa *dest, const vec3 *src, size_t n) {
+        assert(n <= dest->capacity);
+        smath_get_kernels()->vec3_soa_from_aos(dest, src, n);
+        dest->count = n;
+}
+
+/** @brief Copy a structure of arrays back into an array of 3D vectors. */
+void vec3_soa_to_aos(vec3 *dest, const vec3_soa *src) {
+        smath_get_kernels()->vec3_soa_to_aos(dest, src);
+}
+
+/** @brief Add the 3D vectors of the second structure to the first one. */
+void vec3_soa_add(vec3_soa *v, const vec3_soa *v1) {
+        assert(v->count <= v1->count);
+        smath_get_kernels()->vec3_soa_add(v, v1);
+}
+
+/** @brief Subtract the 3D vectors of the second structure from the first one. */
+void vec3_soa_sub(vec3_soa *v, const vec3_soa *v1) {
+        assert(v->count <= v1->count);
+        smath_get_kernels()->vec3_soa_sub(v, v1);
+}
+
+/** @brief Multiply all 3D vectors with the scalar. */
+void vec3_soa_scalar_mult(vec3_soa *v, const f32 s) {
+        smath_get_kernels()->vec3_soa_scalar_mult(v, s);
+}
+
+/** @brief Calculate the magnitude of every 3D vector. */
+void vec3_soa_magnitude(const vec3_soa *v, f32 *out) {
+        smath_get_kernels()->vec3_soa_magnitude(v, out);
+}
+
+/** @brief Normalize every 3D vector. */
+void vec3_soa_normalize(vec3_soa *v) {
+        smath_get_kernels()->vec3_soa_normalize(v);
+}
+
+/** @brief Approximately normalize every 3D vector. */
+void vec3_soa_fast_normalize(vec3_soa *v) {
+        smath_get_kernels()->vec3_soa_fast_normalize(v);
+}
+
+/** @brief Create the dot product of every pair of 3D vectors. */
+void vec3_soa_dot(const vec3_soa *v, const vec3_soa *v1, f32 *out) {
+        assert(v->count <= v1->count);
+        smath_get_kernels()->vec3_soa_dot(v, v1, out);
+}
+
+/** @brief Create the cross product of every pair of 3D vectors. */
+void vec3_soa_cross_product(vec3_soa *dest, const vec3_soa *v, const vec3_soa *v1) {
+        assert(v->count <= v1->count);
+        assert(v->count <= dest->capacity);
+        smath_get_kernels()->vec3_soa_cross_product(dest, v, v1);
+        dest->count = v->count;
+}
+
+
+/** @brief Allocate the 4 arrays of a vec4_soa in one block. */
+bool vec4_soa_create(vec4_soa *soa, size_t count) {
+        size_t capacity = soa_capacity(count);
+        f32 *p = soa_alloc(4 * capacity * sizeof(f32));
+
+        if (!p)
+                return false;
+
+        memset(p, 0, 4 * capacity * sizeof(f32));
+
+        soa->x = p;
+        soa->y = p + capacity;
+        soa->z = p + 2 * capacity;
+        soa->w = p + 3 * capacity;
+        soa->count = count;
+        soa->capacity = capacity;
+
+        return true;
+}
+
+/** @brief Free the arrays of a vec4_soa. */
+void vec4_soa_destroy(vec4_soa *soa) {
+        soa_free(soa->x);
+        soa->x = soa->y = soa->z = soa->w = NULL;
+        soa->count = soa->capacity = 0;
+}
+
+/** @brief Copy an array of 4D vectors into a structure of arrays. */
+void vec4_soa_from_aos(vec4_soa *dest, const vec4 *src, size_t n) {
+        assert(n <= dest->capacity);
+        smath_get_kernels()->vec4_soa_from_aos(dest, src, n);
+        dest->count = n;
+}
+
+/** @brief Copy a structure of arrays back into an array of 4D vectors. */
+void vec4_soa_to_aos(vec4 *dest, const vec4_soa *src) {
+        smath_get_kernels()->vec4_soa_to_aos(dest, src);
+}
+
+/** @brief Add the 4D vectors of the second structure to the first one. */
+void vec4_soa_add(vec4_soa *v, const vec4_soa *v1) {
+        assert(v->count <= v1->count);
+        smath_get_kernels()->vec4_soa_add(v, v1);
+}
+
+/** @brief Subtract the 4D vectors of the second structure from the first one. */
+void vec4_soa_sub(vec4_soa *v, const vec4_soa *v1) {
+        assert(v->count <= v1->count);
+        smath_get_kernels()->vec4_soa_sub(v, v1);
+}
+
+/** @brief Multiply all 4D vectors with the scalar. */
+void vec4_soa_scalar_mult(vec4_soa *v, const f32 s) {
+        smath_get_kernels()->vec4_soa_scalar_mult(v, s);
+}
+
+/** @brief Calculate the magnitude of every 4D vector. */
+void vec4_soa_magnitude(const vec4_soa *v, f32 *out) {
+        smath_get_kernels()->vec4_soa_magnitude(v, out);
+}
+
+/** @brief Normalize every 4D vector. */
+void vec4_soa_normalize(vec4_soa *v) {
+        smath_get_kernels()->vec4_soa_normalize(v);
+}
+
+/** @brief Approximately normalize every 4D vector. */
+void vec4_soa_fast_normalize(vec4_soa *v) {
+        smath_get_kernels()->vec4_soa_fast_normalize(v);
+}
+
+/** @brief Create the dot product of every pair of 4D vectors. */
+void vec4_soa_dot(const vec4_soa *v, const vec4_soa *v1, f32 *out) {
+        assert(v->count <= v1->count);
+        smath_get_kernels()->vec4_soa_dot(v, v1, out);
+}
+
+
+/** @brief Blend every pair of quaternions with nlerp. */
+void quat_soa_nlerp(vec4_soa *dest, const vec4_soa *q0, const vec4_soa *q1, const f32 *t) {
+        assert(q0->count <= q1->count);
+        assert(q0->count <= dest->capacity);
+        smath_get_kernels()->quat_soa_nlerp(dest, q0, q1, t);
+        dest->count = q0->count;
+}
+
+/** @brief Blend every pair of quaternions with the slerp approximation. */
+void quat_soa_slerp(vec4_soa *dest, const vec4_soa *q0, const vec4_soa *q1, const f32 *t) {
+        assert(q0->count <= q1->count);
+        assert(q0->count <= dest->capacity);
+        smath_get_kernels()->quat_soa_slerp(dest, q0, q1, t);
+        dest->count = q0->count;
+}
@@ -0,0 +1,158 @@
+/*
+ * Private to the library.
+ *
+ * The vector functions that are the same for every dimension and scalar
+ * type, so vec2/vec3/vec4 and dvec2/dvec3/dvec4 can not drift apart.
+ * Included once per vector type by vector2.c, vector3.c, vector4.c and
+ * dvector.c (and so by the headerfiles in SMATH_HEADER_ONLY mode), with:
+ *
+ *   VT_S            the scalar type, f32 or f64
+ *   VT_V            the vector type
+ *   VT_N            the number of components, 2, 3 or 4
+ *   VT_FN(name)     the name of a function, e.g. vec3_##name
+ *   VT_SQRT(a)      the square root of a VT_S
+ *
+ * No include guard, every parameter is undefined again at the end.
+ */
+
+
+/** @brief Add the vector with another vector. */
+SMATH_INLINE void VT_FN(add)(VT_V *v, const VT_V *v1) {
+        v->x += v1->x;
+        v->y += v1->y;
+#if VT_N > 2
+        v->z += v1->z;
+#endif
+#if VT_N > 3
+        v->w += v1->w;
+#endif
+}
+
+
+/** @brief Subtract the vector with another vector. */
+SMATH_INLINE void VT_FN(sub)(VT_V *v, const VT_V *v1) {
+        v->x -= v1->x;
+        v->y -= v1->y;
+#if VT_N > 2
+        v->z -= v1->z;
+#endif
+#if VT_N > 3
+        v->w -= v1->w;
+#endif
+}
+
+
+/** @brief Multiply the vector with the scalar. */
+SMATH_INLINE void VT_FN(scalar_mult)(VT_V *v, const VT_S s) {
+        v->x *= s;
+        v->y *= s;
+#if VT_N > 2
+        v->z *= s;
+#endif
+#if VT_N > 3
+        v->w *= s;
+#endif
+}
+
+
+/** @brief Devide the vector by the scalar on each component. */
+SMATH_INLINE void VT_FN(scalar_div)(VT_V *v, VT_S s) {
+        s = (VT_S)1 / s;
+        v->x *= s;
+        v->y *= s;
+#if VT_N > 2
+        v->z *= s;
+#endif
+#if VT_N > 3
+        v->w *= s;
+#endif
+}
+
+
+/** @brief Calculate the square root of the vector on each component. */
+SMATH_INLINE void VT_FN(square_root)(VT_V *v) {
+        v->x = VT_SQRT(v->x);
+        v->y = VT_SQRT(v->y);
+#if VT_N > 2
+        v->z = VT_SQRT(v->z);
+#endif
+#if VT_N > 3
+        v->w = VT_SQRT(v->w);
+#endif
+}
+
+
+/** @brief Create a dot product between the two vectors. */
+SMATH_INLINE VT_S VT_FN(dot)(const VT_V *v, const VT_V *v1) {
+        return (v->x * v1->x + v->y * v1->y
+#if VT_N > 2
+                + v->z * v1->z
+#endif
+#if VT_N > 3
+                + v->w * v1->w
+#endif
+                );
+}
+
+
+/** @brief Calculate the magnitude of the vector. */
+SMATH_INLINE VT_S VT_FN(magnitude)(const VT_V *v) {
+        return VT_SQRT(VT_FN(dot)(v, v));
+}
+
+
+/** @brief Normalize the vector. */
+SMATH_INLINE void VT_FN(normalize)(VT_V *v) {
+        VT_S m = VT_FN(magnitude)(v);
+        VT_FN(scalar_div)(v, m);
+}
+
+
+#if VT_N == 3
+
+/** @brief Create a cross product from 2 3D vectors and return a 3D vector. */
+SMATH_INLINE VT_V VT_FN(cross_product)(const VT_V *v, const VT_V *v1) {
+        VT_V v2;
+        v2.x = v->y * v1->z - v->z * v1->y;
+        v2.y = v->z * v1->x - v->x * v1->z;
+        v2.z = v->x * v1->y - v->y * v1->x;
+
+        return v2;
+}
+
+
+/** @brief Calculate the magnitude of the cross product with 2 3D vectors. */
+SMATH_INLINE VT_S VT_FN(cross_product_magnitude)(const VT_V *v, const VT_V *v1) {
+        VT_V cp = VT_FN(cross_product)(v, v1);
+        return VT_FN(magnitude)(&cp);
+}
+
+
+/** @brief Calculate the vector triple product of 3 3D vectors, b * (a . c) - c * (a . b). */
+SMATH_INLINE VT_V VT_FN(triple_product)(const VT_V *v, const VT_V *v1, const VT_V *v2) {
+        VT_S dotvv2 = VT_FN(dot)(v, v2);
+        VT_S dotvv1 = VT_FN(dot)(v, v1);
+
+        VT_V v3;
+        v3.x = v1->x * dotvv2 - v2->x * dotvv1;
+        v3.y = v1->y * dotvv2 - v2->y * dotvv1;
+        v3.z = v1->z * dotvv2 - v2->z * dotvv1;
+
+        return v3;
+}
+
+
+/** @brief Calculate the scalar triple product with 3 3D vectors. */
+SMATH_INLINE VT_S VT_FN(scalar_triple_product)(const VT_V *v, const VT_V *v1, const VT_V *v2) {
+        VT_V v3 = VT_FN(cross_product)(v, v1);
+        return VT_FN(dot)(v2, &v3);
+}
+
+#endif // VT_N == 3
+
+
+#undef VT_S
+#undef VT_V
+#undef VT_N
+#undef VT_FN
+#undef VT_SQRT
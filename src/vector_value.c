@@ -0,0 +1,258 @@
+#include <math.h>
+
+#include "../include/vector_value.h"
+#include "../include/types.h"
+#include "../include/math_types.h"
+
+#include "mat_sse.h"
+
+
+#ifdef SMATH_SSE
+
+/** @brief Load a 4D vector into a register. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_loadv(const vec4 *v) {
+        return _mm_load_ps((const f32*)v);
+}
+
+/** @brief Store a register into a 4D vector. */
+SMATH_INLINE void SMATH_VECTORCALL vec4_storev(vec4 *dest, vec4v v) {
+        _mm_store_ps((f32*)dest, v);
+}
+
+/** @brief Create a 4D vector from its components. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_setv(f32 x, f32 y, f32 z, f32 w) {
+        return _mm_setr_ps(x, y, z, w);
+}
+
+/** @brief Create a 4D vector with s in all components. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_splatv(f32 s) {
+        return _mm_set1_ps(s);
+}
+
+/** @brief Add two 4D vectors. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_addv(vec4v a, vec4v b) {
+        return _mm_add_ps(a, b);
+}
+
+/** @brief Subtract a 4D vector from another one. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_subv(vec4v a, vec4v b) {
+        return _mm_sub_ps(a, b);
+}
+
+/** @brief Multiply two 4D vectors component by component. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_mulv(vec4v a, vec4v b) {
+        return _mm_mul_ps(a, b);
+}
+
+/** @brief Multiply the 4D vector with the scalar. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_scalar_multv(vec4v v, f32 s) {
+        return _mm_mul_ps(v, _mm_set1_ps(s));
+}
+
+/** @brief Divide the 4D vector by the scalar, as a multiplication with 1 / s like vec4_scalar_div. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_scalar_divv(vec4v v, f32 s) {
+        return _mm_mul_ps(v, _mm_set1_ps(1.0F / s));
+}
+
+/** @brief Square root of every component. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_square_rootv(vec4v v) {
+        return _mm_sqrt_ps(v);
+}
+
+/** @brief Dot product of two 4D vectors. */
+SMATH_INLINE f32 SMATH_VECTORCALL vec4_dotv(vec4v a, vec4v b) {
+        return _mm_cvtss_f32(mat_sse_dot4(a, b));
+}
+
+/** @brief Magnitude of a 4D vector. */
+SMATH_INLINE f32 SMATH_VECTORCALL vec4_magnitudev(vec4v v) {
+        return _mm_cvtss_f32(_mm_sqrt_ss(mat_sse_dot4(v, v)));
+}
+
+/** @brief Normalize a 4D vector. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_normalizev(vec4v v) {
+        return _mm_div_ps(v, _mm_sqrt_ps(mat_sse_dot4(v, v)));
+}
+
+
+/** @brief Load a 3D vector into a register, w is 0. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec3_loadv(const vec3 *v) {
+        return mat_sse_load_vec3(v);
+}
+
+/** @brief Store x, y, z of a register into a 3D vector. */
+SMATH_INLINE void SMATH_VECTORCALL vec3_storev(vec3 *dest, vec4v v) {
+        mat_sse_store_vec3(dest, v);
+}
+
+/** @brief Dot product of x, y, z. */
+SMATH_INLINE f32 SMATH_VECTORCALL vec3_dotv(vec4v a, vec4v b) {
+        return _mm_cvtss_f32(mat_sse_dot3(a, b));
+}
+
+/** @brief Cross product of x, y, z, w is 0. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec3_cross_productv(vec4v a, vec4v b) {
+        return mat_sse_cross(a, b);
+}
+
+/** @brief Magnitude of x, y, z. */
+SMATH_INLINE f32 SMATH_VECTORCALL vec3_magnitudev(vec4v v) {
+        return _mm_cvtss_f32(_mm_sqrt_ss(mat_sse_dot3(v, v)));
+}
+
+/** @brief Normalize x, y, z, w stays 0. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec3_normalizev(vec4v v) {
+        return _mm_div_ps(v, _mm_sqrt_ps(mat_sse_dot3(v, v)));
+}
+
+#else
+
+/** @brief Load a 4D vector, without SSE the register is a vec4. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_loadv(const vec4 *v) {
+        return *v;
+}
+
+/** @brief Store a 4D vector. */
+SMATH_INLINE void SMATH_VECTORCALL vec4_storev(vec4 *dest, vec4v v) {
+        *dest = v;
+}
+
+/** @brief Create a 4D vector from its components. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_setv(f32 x, f32 y, f32 z, f32 w) {
+        vec4v v = {x, y, z, w};
+        return v;
+}
+
+/** @brief Create a 4D vector with s in all components. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_splatv(f32 s) {
+        vec4v v = {s, s, s, s};
+        return v;
+}
+
+/** @brief Add two 4D vectors. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_addv(vec4v a, vec4v b) {
+        vec4v v = {a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w};
+        return v;
+}
+
+/** @brief Subtract a 4D vector from another one. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_subv(vec4v a, vec4v b) {
+        vec4v v = {a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w};
+        return v;
+}
+
+/** @brief Multiply two 4D vectors component by component. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_mulv(vec4v a, vec4v b) {
+        vec4v v = {a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w};
+        return v;
+}
+
+/** @brief Multiply the 4D vector with the scalar. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_scalar_multv(vec4v v, f32 s) {
+        vec4v r = {v.x * s, v.y * s, v.z * s, v.w * s};
+        return r;
+}
+
+/** @brief Divide the 4D vector by the scalar, as a multiplication with 1 / s like vec4_scalar_div. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_scalar_divv(vec4v v, f32 s) {
+        return vec4_scalar_multv(v, 1.0F / s);
+}
+
+/** @brief Square root of every component. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_square_rootv(vec4v v) {
+        vec4v r = {sqrtf(v.x), sqrtf(v.y), sqrtf(v.z), sqrtf(v.w)};
+        return r;
+}
+
+/** @brief Dot product of two 4D vectors. */
+SMATH_INLINE f32 SMATH_VECTORCALL vec4_dotv(vec4v a, vec4v b) {
+        return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+/** @brief Magnitude of a 4D vector. */
+SMATH_INLINE f32 SMATH_VECTORCALL vec4_magnitudev(vec4v v) {
+        return sqrtf(vec4_dotv(v, v));
+}
+
+/** @brief Normalize a 4D vector. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec4_normalizev(vec4v v) {
+        return vec4_scalar_divv(v, vec4_magnitudev(v));
+}
+
+
+/** @brief Load a 3D vector, w is 0. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec3_loadv(const vec3 *v) {
+        vec4v r = {v->x, v->y, v->z, 0.0F};
+        return r;
+}
+
+/** @brief Store x, y, z into a 3D vector. */
+SMATH_INLINE void SMATH_VECTORCALL vec3_storev(vec3 *dest, vec4v v) {
+        dest->x = v.x;
+        dest->y = v.y;
+        dest->z = v.z;
+}
+
+/** @brief Dot product of x, y, z. */
+SMATH_INLINE f32 SMATH_VECTORCALL vec3_dotv(vec4v a, vec4v b) {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+/** @brief Cross product of x, y, z, w is 0. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec3_cross_productv(vec4v a, vec4v b) {
+        vec4v r = {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x, 0.0F};
+        return r;
+}
+
+/** @brief Magnitude of x, y, z. */
+SMATH_INLINE f32 SMATH_VECTORCALL vec3_magnitudev(vec4v v) {
+        return sqrtf(vec3_dotv(v, v));
+}
+
+/** @brief Normalize x, y, z, w stays 0. */
+SMATH_INLINE vec4v SMATH_VECTORCALL vec3_normalizev(vec4v v) {
+        return vec4_scalar_divv(v, vec3_magnitudev(v));
+}
+
+#endif // SMATH_SSE
+
+
+/** @brief Add two arrays of 4D vectors that do not overlap. */
+SMATH_INLINE void vec4_add_array(vec4 *SMATH_RESTRICT dest, const vec4 *SMATH_RESTRICT a, const vec4 *SMATH_RESTRICT b, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+                vec4_storev(&dest[i], vec4_addv(vec4_loadv(&a[i]), vec4_loadv(&b[i])));
+}
+
+/** @brief Subtract two arrays of 4D vectors that do not overlap. */
+SMATH_INLINE void vec4_sub_array(vec4 *SMATH_RESTRICT dest, const vec4 *SMATH_RESTRICT a, const vec4 *SMATH_RESTRICT b, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+                vec4_storev(&dest[i], vec4_subv(vec4_loadv(&a[i]), vec4_loadv(&b[i])));
+}
+
+/** @brief Multiply an array of 4D vectors with a scalar, the arrays do not overlap. */
+SMATH_INLINE void vec4_scalar_mult_array(vec4 *SMATH_RESTRICT dest, const vec4 *SMATH_RESTRICT a, f32 s, size_t n) {
+        vec4v scalar = vec4_splatv(s);
+
+        for (size_t i = 0; i < n; ++i)
+                vec4_storev(&dest[i], vec4_mulv(vec4_loadv(&a[i]), scalar));
+}
+
+/** @brief Dot products of two arrays of 4D vectors, 4 at a time so the sums are one transpose. */
+SMATH_INLINE void vec4_dot_array(f32 *SMATH_RESTRICT dest, const vec4 *SMATH_RESTRICT a, const vec4 *SMATH_RESTRICT b, size_t n) {
+        size_t i = 0;
+
+#ifdef SMATH_SSE
+        for (; i + 4 <= n; i += 4) {
+                __m128 p0 = _mm_mul_ps(_mm_load_ps((const f32*)&a[i]), _mm_load_ps((const f32*)&b[i]));
+                __m128 p1 = _mm_mul_ps(_mm_load_ps((const f32*)&a[i + 1]), _mm_load_ps((const f32*)&b[i + 1]));
+                __m128 p2 = _mm_mul_ps(_mm_load_ps((const f32*)&a[i + 2]), _mm_load_ps((const f32*)&b[i + 2]));
+                __m128 p3 = _mm_mul_ps(_mm_load_ps((const f32*)&a[i + 3]), _mm_load_ps((const f32*)&b[i + 3]));
+
+                _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+                _mm_storeu_ps(dest + i, _mm_add_ps(_mm_add_ps(p0, p1), _mm_add_ps(p2, p3)));
+        }
+#endif
+
+        for (; i < n; ++i)
+                dest[i] = vec4_dotv(vec4_loadv(&a[i]), vec4_loadv(&b[i]));
+}
@@ -0,0 +1,114 @@
+#ifndef SMATH_TEST_H
+#define SMATH_TEST_H
+
+/*
+ * The helpers of the tests, every tests/test_<module>.c is one executable.
+ *
+ * CTest runs every test once per instruction set with SMATH_ISA set to it
+ * (tests/CMakeLists.txt). test_begin returns TEST_SKIP when the CPU or the
+ * build does not have that instruction set, CTest then reports the run as
+ * skipped instead of testing a lower instruction set a second time.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/smath.h"
+
+/** @brief The exit code CTest reports as skipped (SKIP_RETURN_CODE). */
+#define TEST_SKIP 77
+
+/** @brief The failures printed in full, the rest are only counted. */
+#define TEST_MAX_REPORTS 32
+
+static int test_checks = 0;
+static int test_failures = 0;
+
+/** @brief Count a check and report it with a printf style message if cond is false. */
+#define TEST_CHECK(cond, ...) do { \
+        ++test_checks; \
+        if (!(cond)) { \
+                if (test_failures++ < TEST_MAX_REPORTS) { \
+                        fprintf(stderr, "%s:%d: %s: ", __FILE__, __LINE__, #cond); \
+                        fprintf(stderr, __VA_ARGS__); \
+                        fputc('\n', stderr); \
+                } \
+        } \
+} while (0)
+
+
+/**
+ * @brief Bind the instruction set of SMATH_ISA.
+ *
+ * @param [*name] Takes the name of the test, for the output.
+ * @return [int] Returns 0, or TEST_SKIP if the instruction set is not available.
+ */
+static inline int test_begin(const char *name) {
+        const char *env = getenv("SMATH_ISA");
+        smath_isa isa = smath_get_kernels()->isa;
+
+        if (env && strcmp(env, smath_isa_name(isa)) != 0) {
+                printf("%s: %s is not available, skipped\n", name, env);
+                return TEST_SKIP;
+        }
+
+        printf("%s: %s\n", name, smath_isa_name(isa));
+        return 0;
+}
+
+/**
+ * @brief Print the result.
+ *
+ * @return [int] Returns the exit code, 1 if a check failed.
+ */
+static inline int test_end(void) {
+        printf("%d checks, %d failed\n", test_checks, test_failures);
+        return test_failures ? 1 : 0;
+}
+
+
+/** @brief A fixed xorshift sequence, every run tests the same inputs. */
+static u32 test_state = 0x9e3779b9u;
+
+static inline u32 test_rand(void) {
+        test_state ^= test_state << 13;
+        test_state ^= test_state >> 17;
+        test_state ^= test_state << 5;
+        return test_state;
+}
+
+/** @brief A uniform float in [lo, hi). */
+static inline f32 test_uniform(f32 lo, f32 hi) {
+        return lo + (hi - lo) * (f32)(test_rand() >> 8) * (1.0f / 16777216.0f);
+}
+
+/** @brief Fill n floats with test_uniform(lo, hi). */
+static inline void test_fill(f32 *f, size_t n, f32 lo, f32 hi) {
+        for (size_t i = 0; i < n; ++i)
+                f[i] = test_uniform(lo, hi);
+}
+
+/** @brief a and b are equal within tol, relative to the larger magnitude above 1 and absolute below. */
+static inline bool test_close(f32 a, f32 b, f32 tol) {
+        f32 scale = fmaxf(1.0f, fmaxf(fabsf(a), fabsf(b)));
+        return fabsf(a - b) <= tol * scale || (isnan(a) && isnan(b));
+}
+
+/** @brief test_close for n floats, e.g. two vectors or matrices. */
+static inline bool test_close_n(const f32 *a, const f32 *b, size_t n, f32 tol) {
+        for (size_t i = 0; i < n; ++i) {
+                if (!test_close(a[i], b[i], tol))
+                        return false;
+        }
+        return true;
+}
+
+/** @brief The bits of a and b are equal, NaN included. */
+static inline bool test_same_n(const f32 *a, const f32 *b, size_t n) {
+        return memcmp(a, b, n * sizeof(f32)) == 0;
+}
+
+#endif // SMATH_TEST_H
@@ -0,0 +1,271 @@
+/*
+ * The allocators of allocator.h: arena alignment, marks, rewinds and the
+ * full arena, block pool exhaustion, reuse and bad frees, every status of
+ * smath_buffer_check, and the _buffer functions against the kernels they
+ * stand for, packed, strided and with bad buffers that must not be written.
+ */
+
+#include "test.h"
+
+#define MATS 37
+#define VECS 101
+
+static u8 memory[4096 + 1];
+static mat4x4 m0[2 * MATS], m1[MATS], dest[2 * MATS], ref[MATS];
+static vec4 in[2 * VECS], out[2 * VECS], vref[VECS];
+
+static bool aligned(const void *p, size_t alignment) {
+        return ((uintptr_t)p & (alignment - 1)) == 0;
+}
+
+static void test_arena(void) {
+        smath_arena a;
+
+        TEST_CHECK(smath_arena_create(&a, 1000), "smath_arena_create");
+        TEST_CHECK(a.size == 1024 && aligned(a.base, SMATH_ALLOC_ALIGNMENT) && a.owned, "arena of %zu bytes", a.size);
+
+        // Every alignment, 0 is SMATH_ALLOC_ALIGNMENT.
+        for (size_t al = 1; al <= 256; al *= 2) {
+                u8 *p = smath_arena_alloc(&a, 3, al);
+                TEST_CHECK(p && aligned(p, al), "alignment %zu", al);
+        }
+        TEST_CHECK(aligned(smath_arena_alloc(&a, 1, 0), SMATH_ALLOC_ALIGNMENT), "alignment 0");
+
+        // Not a power of 2 fails and leaves the offset.
+        size_t offset = a.offset;
+        TEST_CHECK(smath_arena_alloc(&a, 8, 3) == NULL && smath_arena_alloc(&a, 8, 48) == NULL, "alignment 3 and 48");
+        TEST_CHECK(smath_arena_alloc_array(&a, 2, 8, 24) == NULL && a.offset == offset, "alloc_array alignment 24");
+
+        // Mark, fill up, rewind and get the same memory back.
+        size_t mark = smath_arena_mark(&a);
+        u8 *first = smath_arena_alloc(&a, 16, 16);
+        while (smath_arena_alloc(&a, 16, 16))
+                ;
+        TEST_CHECK(a.offset <= a.size && a.size - a.offset < 16, "full arena at %zu", a.offset);
+        TEST_CHECK(a.peak == a.offset, "peak %zu", a.peak);
+
+        size_t full = a.offset;
+        TEST_CHECK(smath_arena_rewind(&a, mark) && a.offset == mark, "rewind");
+        TEST_CHECK(smath_arena_alloc(&a, 16, 16) == first, "rewind gives the memory back");
+        TEST_CHECK(a.peak == full, "rewind keeps the peak");
+
+        // A mark above the offset is refused.
+        offset = a.offset;
+        TEST_CHECK(!smath_arena_rewind(&a, full) && a.offset == offset, "rewind forward");
+
+        // Overflowing sizes fail.
+        TEST_CHECK(smath_arena_alloc(&a, SIZE_MAX, 1) == NULL && smath_arena_alloc_array(&a, SIZE_MAX / 2, 4, 1) == NULL,
+                   "overflowing sizes");
+        TEST_CHECK(a.offset == offset, "failed allocations moved the offset");
+
+        smath_arena_reset(&a);
+        TEST_CHECK(a.offset == 0 && smath_arena_alloc(&a, a.size, 1) == a.base, "reset");
+        smath_arena_destroy(&a);
+        TEST_CHECK(a.base == NULL && a.size == 0, "destroy");
+
+        // Over misaligned memory of the caller the padding comes from the address.
+        smath_arena_init(&a, memory + 1, sizeof(memory) - 1);
+        u8 *p = smath_arena_alloc(&a, 10, 64);
+        TEST_CHECK(p && aligned(p, 64) && a.offset == (size_t)(p - (memory + 1)) + 10 && !a.owned, "arena over memory + 1");
+        smath_arena_destroy(&a);
+}
+
+static void test_block_pool(void) {
+        smath_block_pool p;
+        void *blocks[8];
+
+        TEST_CHECK(smath_block_pool_create(&p, sizeof(mat4x4), 8), "smath_block_pool_create");
+        TEST_CHECK(p.block_size == 64 && aligned(p.base, 64), "block size %zu", p.block_size);
+
+        for (int i = 0; i < 8; ++i) {
+                blocks[i] = smath_block_pool_alloc(&p);
+                TEST_CHECK(blocks[i] == p.base + (size_t)i * 64, "block %d in order", i);
+        }
+        TEST_CHECK(smath_block_pool_alloc(&p) == NULL && p.used == 8, "exhausted pool");
+
+        // Freed blocks come back last in, first out.
+        TEST_CHECK(smath_block_pool_free(&p, blocks[2]) && smath_block_pool_free(&p, blocks[5]) && p.used == 6, "free");
+        TEST_CHECK(smath_block_pool_alloc(&p) == blocks[5] && smath_block_pool_alloc(&p) == blocks[2], "reuse");
+        TEST_CHECK(smath_block_pool_alloc(&p) == NULL, "exhausted again");
+
+        // Pointers that are no block of the pool are refused.
+        u8 *base = p.base;
+        TEST_CHECK(!smath_block_pool_free(&p, base + 8), "free between blocks");
+        TEST_CHECK(!smath_block_pool_free(&p, base + 8 * 64), "free past the blocks");
+        TEST_CHECK(!smath_block_pool_free(&p, base - 64), "free before the blocks");
+        TEST_CHECK(!smath_block_pool_free(&p, &memory[0]), "free of other memory");
+        TEST_CHECK(smath_block_pool_free(&p, NULL), "free of NULL");
+        TEST_CHECK(p.used == 8 && p.free_list == NULL, "refused frees changed the pool");
+
+        // Reset hands the blocks out in order again, a block never handed out since is refused.
+        smath_block_pool_reset(&p);
+        TEST_CHECK(p.used == 0 && !smath_block_pool_free(&p, blocks[0]), "free after reset");
+        TEST_CHECK(smath_block_pool_alloc(&p) == blocks[0], "reset starts over");
+        TEST_CHECK(!smath_block_pool_free(&p, blocks[1]), "free of a block past fresh");
+        TEST_CHECK(smath_block_pool_free(&p, blocks[0]) && !smath_block_pool_free(&p, blocks[0]), "free with nothing in use");
+        smath_block_pool_destroy(&p);
+
+        // Small blocks still hold the free list pointer and are 16 byte aligned.
+        TEST_CHECK(smath_block_pool_create(&p, 1, 3), "smath_block_pool_create of 1 byte");
+        TEST_CHECK(p.block_size == 16, "block size %zu", p.block_size);
+        smath_block_pool_destroy(&p);
+}
+
+static void test_buffer_check(void) {
+        static const char *names[] = { "ok", "null", "bad alignment", "misaligned", "bad stride", "too small" };
+        smath_buffer b = smath_buffer_wrap(in, VECS, sizeof(vec4), 16);
+
+        TEST_CHECK(smath_buffer_check(&b, sizeof(vec4), 16, VECS) == SMATH_BUFFER_OK, "ok");
+        TEST_CHECK(smath_buffer_check(&b, sizeof(vec4), 16, VECS + 1) == SMATH_BUFFER_TOO_SMALL, "too small");
+        TEST_CHECK(smath_buffer_check(&b, sizeof(vec4), 64, 1) == SMATH_BUFFER_BAD_ALIGNMENT, "alignment below the required");
+        TEST_CHECK(smath_buffer_check(&b, 2 * sizeof(vec4), 16, 1) == SMATH_BUFFER_BAD_STRIDE, "stride below an element");
+
+        b.data = (u8*)in + 4;
+        TEST_CHECK(smath_buffer_check(&b, sizeof(vec4), 16, 1) == SMATH_BUFFER_MISALIGNED, "misaligned");
+        b.data = in;
+        b.stride = 24;
+        TEST_CHECK(smath_buffer_check(&b, sizeof(vec4), 16, 1) == SMATH_BUFFER_BAD_STRIDE, "stride not a multiple");
+        b.stride = 16;
+        b.alignment = 12;
+        TEST_CHECK(smath_buffer_check(&b, sizeof(vec4), 1, 1) == SMATH_BUFFER_BAD_ALIGNMENT, "alignment 12");
+
+        b = smath_buffer_wrap(NULL, 1, 16, 16);
+        TEST_CHECK(smath_buffer_check(&b, 16, 16, 0) == SMATH_BUFFER_NULL, "null");
+        b.count = 0;
+        TEST_CHECK(smath_buffer_check(&b, 16, 16, 0) == SMATH_BUFFER_OK, "empty null buffer");
+
+        for (int s = 0; s < SMATH_BUFFER_STATUS_COUNT; ++s)
+                TEST_CHECK(strcmp(smath_buffer_status_name((smath_buffer_status)s), names[s]) == 0, "name of status %d", s);
+        TEST_CHECK(strcmp(smath_buffer_status_name(SMATH_BUFFER_STATUS_COUNT), "unknown") == 0 &&
+                   strcmp(smath_buffer_status_name((smath_buffer_status)-1), "unknown") == 0, "name of a bad status");
+
+        // Created buffers round the stride up and pass their own check.
+        smath_buffer c;
+        TEST_CHECK(smath_buffer_create(&c, 10, 12, 16) && c.stride == 16 && aligned(c.data, 64), "smath_buffer_create");
+        TEST_CHECK(smath_buffer_check(&c, 12, 16, 10) == SMATH_BUFFER_OK, "created buffer");
+        smath_buffer_destroy(&c);
+        TEST_CHECK(!smath_buffer_create(&c, 10, 12, 24) && c.data == NULL, "smath_buffer_create alignment 24");
+
+        smath_arena a;
+        smath_arena_init(&a, memory, sizeof(memory));
+        TEST_CHECK(smath_buffer_from_arena(&c, &a, 5, 20, 0) && c.stride == 64 && aligned(c.data, 64), "smath_buffer_from_arena");
+        TEST_CHECK(!smath_buffer_from_arena(&c, &a, 1000, 64, 0) && c.data == NULL, "smath_buffer_from_arena full");
+}
+
+static void test_mult_buffer(void) {
+        mat4x4 poison;
+        memset(&poison, 0xff, sizeof(poison));
+        test_fill(&m0[0].t[0][0], 2 * MATS * 16, -2.0f, 2.0f);
+        test_fill(&m1[0].t[0][0], MATS * 16, -2.0f, 2.0f);
+
+        // Packed, the dispatched kernel.
+        smath_buffer bd = smath_buffer_wrap(dest, MATS, sizeof(mat4x4), 64);
+        smath_buffer b0 = smath_buffer_wrap(m0, MATS, sizeof(mat4x4), 64);
+        smath_buffer b1 = smath_buffer_wrap(m1, MATS, sizeof(mat4x4), 64);
+        mat4x4_mult_array(ref, m0, m1, MATS);
+        TEST_CHECK(mat4x4_mult_buffer(&bd, &b0, &b1) == SMATH_BUFFER_OK, "mat4x4_mult_buffer packed");
+        TEST_CHECK(memcmp(dest, ref, sizeof(ref)) == 0, "mat4x4_mult_buffer packed differs");
+
+        // Strided, every other matrix of m0 and dest, mat4x4_mult one by one.
+        for (int i = 0; i < 2 * MATS; ++i)
+                dest[i] = poison;
+        bd = smath_buffer_wrap(dest, MATS, 2 * sizeof(mat4x4), 64);
+        b0 = smath_buffer_wrap(m0, MATS, 2 * sizeof(mat4x4), 64);
+        TEST_CHECK(mat4x4_mult_buffer(&bd, &b0, &b1) == SMATH_BUFFER_OK, "mat4x4_mult_buffer strided");
+        bool same = true;
+        for (int i = 0; i < MATS; ++i) {
+                mat4x4 r = mat4x4_mult(&m0[2 * i], &m1[i]);
+                same = same && memcmp(&dest[2 * i], &r, sizeof(r)) == 0 && memcmp(&dest[2 * i + 1], &poison, sizeof(r)) == 0;
+        }
+        TEST_CHECK(same, "mat4x4_mult_buffer strided differs");
+
+        // In place into m0.
+        memcpy(ref, m0, sizeof(ref));
+        mat4x4_mult_array(ref, ref, m1, MATS);
+        b0 = smath_buffer_wrap(m0, MATS, sizeof(mat4x4), 64);
+        TEST_CHECK(mat4x4_mult_buffer(&b0, &b0, &b1) == SMATH_BUFFER_OK && memcmp(m0, ref, sizeof(ref)) == 0, "mat4x4_mult_buffer in place");
+
+        // Bad buffers return their status and write nothing.
+        for (int i = 0; i < MATS; ++i)
+                dest[i] = poison;
+        bd = smath_buffer_wrap(dest, MATS - 1, sizeof(mat4x4), 64);
+        TEST_CHECK(mat4x4_mult_buffer(&bd, &b0, &b1) == SMATH_BUFFER_TOO_SMALL, "dest too small");
+        bd = smath_buffer_wrap(dest, MATS, sizeof(mat4x4), 16);
+        TEST_CHECK(mat4x4_mult_buffer(&bd, &b0, &b1) == SMATH_BUFFER_BAD_ALIGNMENT, "dest alignment 16");
+        bd = smath_buffer_wrap(dest, MATS, sizeof(mat4x4), 64);
+        b1 = smath_buffer_wrap(NULL, MATS, sizeof(mat4x4), 64);
+        TEST_CHECK(mat4x4_mult_buffer(&bd, &b0, &b1) == SMATH_BUFFER_NULL, "m1 null");
+        b1 = smath_buffer_wrap((u8*)m1 + 16, MATS - 1, sizeof(mat4x4), 64);
+        TEST_CHECK(mat4x4_mult_buffer(&bd, &b0, &b1) == SMATH_BUFFER_MISALIGNED, "m1 misaligned");
+        same = true;
+        for (int i = 0; i < MATS; ++i)
+                same = same && memcmp(&dest[i], &poison, sizeof(poison)) == 0;
+        TEST_CHECK(same, "a failed mat4x4_mult_buffer wrote dest");
+}
+
+static void test_transform_buffer(void) {
+        mat4x4 m;
+        vec4 poison;
+        memset(&poison, 0xff, sizeof(poison));
+        test_fill(&m.t[0][0], 16, -2.0f, 2.0f);
+        test_fill(&in[0].x, 2 * VECS * 4, -10.0f, 10.0f);
+
+        // Packed, the dispatched kernel.
+        smath_buffer bi = smath_buffer_wrap(in, VECS, sizeof(vec4), 16);
+        smath_buffer bo = smath_buffer_wrap(out, VECS, sizeof(vec4), 16);
+        mat4x4_transform_vec4s(&m, in, vref, VECS);
+        TEST_CHECK(mat4x4_transform_vec4s_buffer(&m, &bi, &bo) == SMATH_BUFFER_OK, "mat4x4_transform_vec4s_buffer packed");
+        TEST_CHECK(memcmp(out, vref, sizeof(vref)) == 0, "mat4x4_transform_vec4s_buffer packed differs");
+
+        // Strided input and output, mat4x4_vec4_mult one by one.
+        for (int i = 0; i < 2 * VECS; ++i)
+                out[i] = poison;
+        bi = smath_buffer_wrap(in, VECS, 2 * sizeof(vec4), 16);
+        bo = smath_buffer_wrap(out, VECS, 2 * sizeof(vec4), 16);
+        TEST_CHECK(mat4x4_transform_vec4s_buffer(&m, &bi, &bo) == SMATH_BUFFER_OK, "mat4x4_transform_vec4s_buffer strided");
+        bool same = true;
+        for (int i = 0; i < VECS; ++i) {
+                vec4 r = mat4x4_vec4_mult(&m, &in[2 * i]);
+                same = same && memcmp(&out[2 * i], &r, sizeof(r)) == 0 && memcmp(&out[2 * i + 1], &poison, sizeof(r)) == 0;
+        }
+        TEST_CHECK(same, "mat4x4_transform_vec4s_buffer strided differs");
+
+        // In place.
+        mat4x4_transform_vec4s(&m, in, vref, VECS);
+        bi = smath_buffer_wrap(in, VECS, sizeof(vec4), 16);
+        TEST_CHECK(mat4x4_transform_vec4s_buffer(&m, &bi, &bi) == SMATH_BUFFER_OK && memcmp(in, vref, sizeof(vref)) == 0,
+                   "mat4x4_transform_vec4s_buffer in place");
+
+        // Bad buffers return their status and write nothing.
+        for (int i = 0; i < VECS; ++i)
+                out[i] = poison;
+        bo = smath_buffer_wrap(out, VECS - 1, sizeof(vec4), 16);
+        TEST_CHECK(mat4x4_transform_vec4s_buffer(&m, &bi, &bo) == SMATH_BUFFER_TOO_SMALL, "out too small");
+        bo = smath_buffer_wrap(out, VECS, 12, 4);
+        TEST_CHECK(mat4x4_transform_vec4s_buffer(&m, &bi, &bo) == SMATH_BUFFER_BAD_ALIGNMENT, "out alignment 4");
+        bo = smath_buffer_wrap(out, VECS, 16, 16);
+        bi = smath_buffer_wrap(in, VECS, 8, 8);
+        TEST_CHECK(mat4x4_transform_vec4s_buffer(&m, &bi, &bo) == SMATH_BUFFER_BAD_ALIGNMENT, "in alignment 8");
+        bi = smath_buffer_wrap(in, VECS, 8, 16);
+        for (int i = 0; i < VECS; ++i)
+                out[i] = poison;
+        TEST_CHECK(mat4x4_transform_vec4s_buffer(&m, &bi, &bo) == SMATH_BUFFER_BAD_STRIDE, "in stride 8");
+        same = true;
+        for (int i = 0; i < VECS; ++i)
+                same = same && memcmp(&out[i], &poison, sizeof(poison)) == 0;
+        TEST_CHECK(same, "a failed mat4x4_transform_vec4s_buffer wrote out");
+}
+
+int main(void) {
+        int skip = test_begin("allocator");
+        if (skip)
+                return skip;
+
+        test_arena();
+        test_block_pool();
+        test_buffer_check();
+        test_mult_buffer();
+        test_transform_buffer();
+
+        return test_end();
+}
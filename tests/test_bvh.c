@@ -0,0 +1,341 @@
+/*
+ * smath_bvh against brute force over random boxes, after the build and
+ * again after a refit: the nearest ray hit with and without an exact
+ * test, the overlap query, the nearest point and the packets of
+ * smath_bvh_intersect_rays against smath_bvh_intersect_ray.
+ */
+
+#include "test.h"
+
+#define N 1000
+#define RAYS 259
+#define QUERIES 200
+
+static aabb boxes[N];
+static sphere spheres[N];
+
+/** @brief Random spheres in [-50, 50]^3 and their boxes, a few large ones so leaves overlap. */
+static void random_scene(void) {
+        for (int i = 0; i < N; ++i) {
+                sphere *s = &spheres[i];
+
+                test_fill(&s->center.x, 3, -50.0f, 50.0f);
+                s->radius = i % 50 == 0 ? test_uniform(5.0f, 15.0f) : test_uniform(0.2f, 2.0f);
+                boxes[i].min = (vec3){ s->center.x - s->radius, s->center.y - s->radius, s->center.z - s->radius };
+                boxes[i].max = (vec3){ s->center.x + s->radius, s->center.y + s->radius, s->center.z + s->radius };
+        }
+}
+
+/** @brief Move every sphere a bit, the refit has to follow. */
+static void move_scene(void) {
+        for (int i = 0; i < N; ++i) {
+                vec3 d;
+                test_fill(&d.x, 3, -10.0f, 10.0f);
+
+                spheres[i].center.x += d.x;
+                spheres[i].center.y += d.y;
+                spheres[i].center.z += d.z;
+                boxes[i].min = (vec3){ boxes[i].min.x + d.x, boxes[i].min.y + d.y, boxes[i].min.z + d.z };
+                boxes[i].max = (vec3){ boxes[i].max.x + d.x, boxes[i].max.y + d.y, boxes[i].max.z + d.z };
+        }
+}
+
+static ray random_ray(void) {
+        ray r;
+
+        test_fill(&r.origin.x, 3, -60.0f, 60.0f);
+        do {
+                test_fill(&r.direction.x, 3, -1.0f, 1.0f);
+        } while (r.direction.x * r.direction.x + r.direction.y * r.direction.y + r.direction.z * r.direction.z < 0.01f);
+
+        return r;
+}
+
+static bool sphere_fn(void *user, u32 object, const ray *r, f32 t_max, f32 *t) {
+        const sphere *s = user;
+        return ray_intersect_sphere(r, &s[object], t_max, t);
+}
+
+static f32 sphere_distance_fn(void *user, u32 object, const vec3 *p) {
+        const sphere *s = user;
+        f32 dx = p->x - s[object].center.x, dy = p->y - s[object].center.y, dz = p->z - s[object].center.z;
+        f32 d = fmaxf(sqrtf(dx * dx + dy * dy + dz * dz) - s[object].radius, 0.0f);
+        return d * d;
+}
+
+static f32 box_distance_sq(const aabb *b, const vec3 *p) {
+        f32 dx = fmaxf(fmaxf(b->min.x - p->x, p->x - b->max.x), 0.0f);
+        f32 dy = fmaxf(fmaxf(b->min.y - p->y, p->y - b->max.y), 0.0f);
+        f32 dz = fmaxf(fmaxf(b->min.z - p->z, p->z - b->max.z), 0.0f);
+        return dx * dx + dy * dy + dz * dz;
+}
+
+/** @brief The nearest t over all objects, the box slab test or the sphere. */
+static bool brute_ray(const ray *r, f32 t_max, bool exact, f32 *t) {
+        f32 best = t_max;
+        bool hit = false;
+
+        for (int i = 0; i < N; ++i) {
+                f32 d;
+
+                if (!ray_intersect_aabb(r, &boxes[i], best, &d))
+                        continue;
+                if (exact && !ray_intersect_sphere(r, &spheres[i], best, &d))
+                        continue;
+
+                best = d;
+                hit = true;
+        }
+
+        if (hit)
+                *t = best;
+        return hit;
+}
+
+/** @brief The t of one object, to check the object of a hit on a tie. */
+static bool object_t(const ray *r, u32 object, bool exact, f32 *t) {
+        if (exact)
+                return ray_intersect_sphere(r, &spheres[object], INFINITY, t);
+        return ray_intersect_aabb(r, &boxes[object], INFINITY, t);
+}
+
+static void test_rays(const smath_bvh *bvh, const char *stage) {
+        for (int e = 0; e < 2; ++e) {
+                bool exact = e == 1;
+                smath_bvh_ray_fn fn = exact ? sphere_fn : NULL;
+
+                for (int i = 0; i < QUERIES; ++i) {
+                        ray r = random_ray();
+                        f32 t_max = i % 4 == 0 ? test_uniform(1.0f, 40.0f) : INFINITY;
+                        f32 t = -1.0f, t_ref = -1.0f, t_obj = -1.0f;
+                        u32 object = SMATH_BVH_NONE;
+
+                        bool hit = smath_bvh_intersect_ray(bvh, &r, t_max, fn, spheres, &t, &object);
+                        bool hit_ref = brute_ray(&r, t_max, exact, &t_ref);
+
+                        TEST_CHECK(hit == hit_ref, "%s intersect_ray exact %d %d: %d, expected %d", stage, e, i, hit, hit_ref);
+                        if (!hit || !hit_ref)
+                                continue;
+
+                        TEST_CHECK(t == t_ref, "%s intersect_ray exact %d %d: t %.9g, expected %.9g", stage, e, i, t, t_ref);
+                        TEST_CHECK(object < N && object_t(&r, object, exact, &t_obj) && t_obj == t,
+                                   "%s intersect_ray exact %d %d: object %u does not hit at %.9g", stage, e, i, object, t);
+                }
+        }
+}
+
+/** @brief The packets against the single ray, an odd count so the last packet and register are partial. */
+static void test_packets(const smath_bvh *bvh, const char *stage) {
+        static f32 t[RAYS];
+        static u32 object[RAYS];
+        ray_soa r;
+
+        TEST_CHECK(vec3_soa_create(&r.origin, RAYS) && vec3_soa_create(&r.direction, RAYS), "vec3_soa_create");
+
+        for (int e = 0; e < 2; ++e) {
+                smath_bvh_ray_fn fn = e ? sphere_fn : NULL;
+
+                // Coherent rays from one corner for the first packets, scattered ones for the rest.
+                vec3 eye = { -70.0f, -70.0f, -70.0f };
+                for (size_t k = 0; k < RAYS; ++k) {
+                        ray rk = random_ray();
+                        if (k < 128) {
+                                rk.origin = eye;
+                                rk.direction = (vec3){ 1.0f + test_uniform(-0.3f, 0.3f), 1.0f + test_uniform(-0.3f, 0.3f), 1.0f };
+                        }
+
+                        r.origin.x[k] = rk.origin.x;
+                        r.origin.y[k] = rk.origin.y;
+                        r.origin.z[k] = rk.origin.z;
+                        r.direction.x[k] = rk.direction.x;
+                        r.direction.y[k] = rk.direction.y;
+                        r.direction.z[k] = rk.direction.z;
+                        t[k] = k % 5 == 0 ? test_uniform(1.0f, 200.0f) : INFINITY;
+                }
+
+                f32 t_max[RAYS];
+                memcpy(t_max, t, sizeof(t));
+                smath_bvh_intersect_rays(bvh, &r, fn, spheres, t, object);
+
+                int hits = 0;
+                for (size_t k = 0; k < RAYS; ++k) {
+                        ray rk = { { r.origin.x[k], r.origin.y[k], r.origin.z[k] },
+                                   { r.direction.x[k], r.direction.y[k], r.direction.z[k] } };
+                        f32 t_ref = -1.0f, t_obj = -1.0f;
+                        u32 object_ref = SMATH_BVH_NONE;
+                        bool hit = smath_bvh_intersect_ray(bvh, &rk, t_max[k], fn, spheres, &t_ref, &object_ref);
+
+                        hits += hit;
+                        TEST_CHECK((object[k] != SMATH_BVH_NONE) == hit, "%s intersect_rays exact %d ray %zu: object %u, single ray hit %d",
+                                   stage, e, k, object[k], hit);
+                        if (!hit) {
+                                TEST_CHECK(t[k] == t_max[k], "%s intersect_rays exact %d ray %zu: t changed on a miss", stage, e, k);
+                                continue;
+                        }
+
+                        TEST_CHECK(t[k] == t_ref, "%s intersect_rays exact %d ray %zu: t %.9g, expected %.9g", stage, e, k, t[k], t_ref);
+                        TEST_CHECK(object[k] < N && object_t(&rk, object[k], e, &t_obj) && t_obj == t[k],
+                                   "%s intersect_rays exact %d ray %zu: object %u does not hit at %.9g", stage, e, k, object[k], t[k]);
+                }
+                TEST_CHECK(hits > RAYS / 8, "%s intersect_rays exact %d: only %d hits", stage, e, hits);
+        }
+
+        vec3_soa_destroy(&r.origin);
+        vec3_soa_destroy(&r.direction);
+}
+
+static int compare_u32(const void *a, const void *b) {
+        u32 x = *(const u32 *)a, y = *(const u32 *)b;
+        return (x > y) - (x < y);
+}
+
+static void test_overlap(const smath_bvh *bvh, const char *stage) {
+        static u32 out[N], ref[N];
+
+        for (int i = 0; i < QUERIES; ++i) {
+                vec3 c, e;
+                test_fill(&c.x, 3, -60.0f, 60.0f);
+                test_fill(&e.x, 3, 0.0f, i % 10 == 0 ? 40.0f : 8.0f);
+                aabb q = { { c.x - e.x, c.y - e.y, c.z - e.z }, { c.x + e.x, c.y + e.y, c.z + e.z } };
+
+                size_t count_ref = 0;
+                for (u32 j = 0; j < N; ++j) {
+                        const aabb *b = &boxes[j];
+                        if (b->min.x <= q.max.x && q.min.x <= b->max.x &&
+                            b->min.y <= q.max.y && q.min.y <= b->max.y &&
+                            b->min.z <= q.max.z && q.min.z <= b->max.z)
+                                ref[count_ref++] = j;
+                }
+
+                size_t count = smath_bvh_query_aabb(bvh, &q, out, N);
+                TEST_CHECK(count == count_ref, "%s query_aabb %d: %zu objects, expected %zu", stage, i, count, count_ref);
+                if (count != count_ref)
+                        continue;
+
+                qsort(out, count, sizeof(u32), compare_u32);
+                TEST_CHECK(memcmp(out, ref, count * sizeof(u32)) == 0, "%s query_aabb %d: different objects", stage, i);
+
+                // A short out still gets the total and only max entries.
+                if (count >= 2) {
+                        size_t max = count / 2;
+                        out[max] = SMATH_BVH_NONE;
+                        TEST_CHECK(smath_bvh_query_aabb(bvh, &q, out, max) == count, "%s query_aabb %d: total with max %zu", stage, i, max);
+                        TEST_CHECK(out[max] == SMATH_BVH_NONE, "%s query_aabb %d: wrote past max %zu", stage, i, max);
+                }
+        }
+}
+
+static void test_nearest(const smath_bvh *bvh, const char *stage) {
+        for (int e = 0; e < 2; ++e) {
+                smath_bvh_distance_fn fn = e ? sphere_distance_fn : NULL;
+
+                for (int i = 0; i < QUERIES; ++i) {
+                        vec3 p;
+                        test_fill(&p.x, 3, -70.0f, 70.0f);
+                        f32 max_dist_sq = i % 4 == 0 ? test_uniform(1.0f, 100.0f) : INFINITY;
+
+                        f32 ref = max_dist_sq;
+                        for (u32 j = 0; j < N; ++j) {
+                                f32 d = fn ? fn(spheres, j, &p) : box_distance_sq(&boxes[j], &p);
+                                if (d < ref)
+                                        ref = d;
+                        }
+
+                        f32 d = -1.0f;
+                        u32 object = SMATH_BVH_NONE;
+                        bool found = smath_bvh_nearest(bvh, &p, max_dist_sq, fn, spheres, &d, &object);
+
+                        TEST_CHECK(found == (ref < max_dist_sq), "%s nearest exact %d %d: found %d", stage, e, i, found);
+                        if (!found || !(ref < max_dist_sq))
+                                continue;
+
+                        f32 d_obj = object < N ? (fn ? fn(spheres, object, &p) : box_distance_sq(&boxes[object], &p)) : -1.0f;
+                        TEST_CHECK(d == ref && d_obj == d, "%s nearest exact %d %d: %.9g of object %u, expected %.9g",
+                                   stage, e, i, d, object, ref);
+                }
+        }
+}
+
+/** @brief Every slot once, a leaf holds boxes inside its node box and the inner boxes hold their children. */
+static void test_structure(const smath_bvh *bvh, const char *stage) {
+        static bool seen[N];
+        memset(seen, 0, sizeof(seen));
+
+        TEST_CHECK(bvh->count == N, "%s count %zu", stage, bvh->count);
+        for (size_t i = 0; i < bvh->count; ++i) {
+                u32 o = bvh->objects[i];
+                TEST_CHECK(o < N && !seen[o], "%s slot %zu: object %u twice or out of range", stage, i, o);
+                if (o < N) {
+                        seen[o] = true;
+                        TEST_CHECK(memcmp(&bvh->boxes[i], &boxes[o], sizeof(aabb)) == 0, "%s slot %zu: stale box", stage, i);
+                }
+        }
+
+        for (size_t i = 0; i < bvh->node_count; ++i) {
+                const aabb_node *n = &bvh->nodes[i];
+                const aabb *b = &n->box;
+
+                if (n->count) {
+                        for (u32 j = n->first; j < n->first + n->count; ++j) {
+                                const aabb *c = &bvh->boxes[j];
+                                TEST_CHECK(b->min.x <= c->min.x && b->min.y <= c->min.y && b->min.z <= c->min.z &&
+                                           c->max.x <= b->max.x && c->max.y <= b->max.y && c->max.z <= b->max.z,
+                                           "%s leaf %zu does not hold slot %u", stage, i, j);
+                        }
+                        continue;
+                }
+
+                u32 kids[2] = { (u32)i + 1, bvh->nodes[i + 1].skip };
+                for (int k = 0; k < 2; ++k) {
+                        const aabb *c = &bvh->nodes[kids[k]].box;
+                        TEST_CHECK(kids[k] < bvh->node_count &&
+                                   b->min.x <= c->min.x && b->min.y <= c->min.y && b->min.z <= c->min.z &&
+                                   c->max.x <= b->max.x && c->max.y <= b->max.y && c->max.z <= b->max.z,
+                                   "%s node %zu does not hold child %u", stage, i, kids[k]);
+                }
+        }
+}
+
+static void test_all(const smath_bvh *bvh, const char *stage) {
+        test_structure(bvh, stage);
+        test_rays(bvh, stage);
+        test_packets(bvh, stage);
+        test_overlap(bvh, stage);
+        test_nearest(bvh, stage);
+}
+
+static void test_empty(void) {
+        smath_bvh bvh;
+        ray r = random_ray();
+        vec3 p = { 0.0f, 0.0f, 0.0f };
+        f32 t;
+        u32 object;
+
+        TEST_CHECK(smath_bvh_create(&bvh, NULL, 0), "smath_bvh_create 0");
+        TEST_CHECK(!smath_bvh_intersect_ray(&bvh, &r, INFINITY, NULL, NULL, &t, &object), "empty intersect_ray");
+        TEST_CHECK(!smath_bvh_nearest(&bvh, &p, INFINITY, NULL, NULL, &t, &object), "empty nearest");
+        TEST_CHECK(smath_bvh_query_aabb(&bvh, &(aabb){ { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f } }, NULL, 0) == 0, "empty query_aabb");
+        smath_bvh_destroy(&bvh);
+}
+
+int main(void) {
+        int skip = test_begin("bvh");
+        if (skip)
+                return skip;
+
+        smath_bvh bvh;
+
+        random_scene();
+        TEST_CHECK(smath_bvh_create(&bvh, boxes, N), "smath_bvh_create");
+        test_all(&bvh, "build");
+
+        for (int i = 0; i < 2; ++i) {
+                move_scene();
+                smath_bvh_refit(&bvh, boxes);
+                test_all(&bvh, "refit");
+        }
+
+        smath_bvh_destroy(&bvh);
+        test_empty();
+        return test_end();
+}
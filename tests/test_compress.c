@@ -0,0 +1,408 @@
+/*
+ * The packed formats of compress.h: every half float and every snorm and
+ * unorm code round trips, floats pack to the nearest code, 10-10-10-2,
+ * octahedral and smallest three stay within their error bounds, and the
+ * batch kernels give the bits of the single element functions.
+ */
+
+#include "test.h"
+
+#define N 1029                  // Not a multiple of any register width
+#define OCT_ERROR 1e-4f         // |decoded - v|, about 0.006 degrees, the largest seen is 6.4e-5
+#define SMALLEST3_ERROR 3e-3f   // |unpacked - q| on the side of q, about 0.35 degrees, the largest seen is 2.1e-3
+
+static f32 src[N], out[N], ref[N];
+static u8 packed[4 * N], packed_ref[4 * N];
+
+static u32 f32_bits(f32 f) {
+        u32 u;
+        memcpy(&u, &f, sizeof(u));
+        return u;
+}
+
+/** @brief The value of a half float from its fields, in double. */
+static double f16_value(u16 h) {
+        int e = (h >> 10) & 0x1F;
+        int m = h & 0x3FF;
+        double v = e == 0 ? ldexp(m, -24) : ldexp(1024 + m, e - 25);
+        return h & 0x8000 ? -v : v;
+}
+
+static void test_f16_round_trip(void) {
+        for (u32 h = 0; h < 0x10000; ++h) {
+                f32 f = f16_to_f32((u16)h);
+                int e = (h >> 10) & 0x1F;
+
+                if (e == 0x1F && (h & 0x3FF)) {
+                        TEST_CHECK(isnan(f), "f16_to_f32(%04x) is %g, not NaN", h, f);
+                        u16 back = f32_to_f16(f);
+                        TEST_CHECK((back & 0x7C00) == 0x7C00 && (back & 0x3FF) && (back & 0x8000) == (h & 0x8000),
+                                   "f32_to_f16 of NaN %04x gives %04x", h, back);
+                        continue;
+                }
+
+                double v = e == 0x1F ? (h & 0x8000 ? -INFINITY : INFINITY) : f16_value((u16)h);
+                TEST_CHECK((double)f == v && !signbit(f) == !(h & 0x8000), "f16_to_f32(%04x) is %a, expected %a", h, f, v);
+                TEST_CHECK(f32_to_f16(f) == h, "f32_to_f16(f16_to_f32(%04x)) is %04x", h, f32_to_f16(f));
+        }
+}
+
+/** @brief The distance of f to h in double, the largest finite half rounds up to infinity at 65520. */
+static double f16_error(f32 f, u16 h) {
+        if ((h & 0x7FFF) == 0x7C00)
+                return fabs((double)f) >= 65520.0 ? 0.0 : INFINITY;
+        return fabs((double)f - f16_value(h));
+}
+
+/** @brief f32_to_f16 is the nearest half, ties to the even mantissa. */
+static void test_f16_rounding(void) {
+        static const f32 special[] = {
+                65504.0f, 65519.99f, 65520.0f, 1e10f, 0x1p-24f, 0x1p-25f, 0x1.000002p-25f, 0x1.8p-24f, 0x1.4p-24f,
+                0x1p-14f, 0x1.ffcp-15f, 0x1.002p0f, 0x1.006p0f, 1e-30f, 0.0f,
+        };
+
+        for (int i = 0; i < 100000 + (int)(2 * sizeof(special) / sizeof(special[0])); ++i) {
+                f32 f;
+                if (i < (int)(2 * sizeof(special) / sizeof(special[0])))
+                        f = i & 1 ? -special[i / 2] : special[i / 2];
+                else
+                        f = ldexpf(test_uniform(1.0f, 2.0f), (int)(test_rand() % 48) - 30) * (test_rand() & 1 ? -1.0f : 1.0f);
+
+                u16 h = f32_to_f16(f);
+                double e = f16_error(f, h);
+                bool nearest = (h & 0x8000) == (f32_bits(f) >> 16 & 0x8000);
+
+                // The neighbours on both sides, towards zero and away from it.
+                if ((h & 0x7FFF) != 0)
+                        nearest = nearest && e <= f16_error(f, h - 1) && (e < f16_error(f, h - 1) || !(h & 1));
+                if ((h & 0x7FFF) < 0x7C00)
+                        nearest = nearest && e <= f16_error(f, h + 1) && (e < f16_error(f, h + 1) || !(h & 1));
+                TEST_CHECK(nearest, "f32_to_f16(%a) is %04x", f, h);
+        }
+
+        TEST_CHECK(f32_to_f16(INFINITY) == 0x7C00 && f32_to_f16(-INFINITY) == 0xFC00, "f32_to_f16 of infinity");
+        TEST_CHECK(f32_to_f16(-0.0f) == 0x8000, "f32_to_f16(-0) is %04x", f32_to_f16(-0.0f));
+}
+
+static void test_norm_round_trip(void) {
+        for (i32 s = -32768; s <= 32767; ++s) {
+                f32 f = snorm16_to_f32((i16)s);
+                TEST_CHECK(fabsf(f - fmaxf((f32)s / 32767.0f, -1.0f)) <= 6e-8f, "snorm16_to_f32(%d) is %g", s, f);
+                TEST_CHECK(f32_to_snorm16(f) == (s == -32768 ? -32767 : s), "snorm16 %d round trips to %d", s, f32_to_snorm16(f));
+        }
+        for (i32 u = 0; u <= 65535; ++u) {
+                f32 f = unorm16_to_f32((u16)u);
+                TEST_CHECK(fabsf(f - (f32)u / 65535.0f) <= 6e-8f, "unorm16_to_f32(%d) is %g", u, f);
+                TEST_CHECK(f32_to_unorm16(f) == u, "unorm16 %d round trips to %d", u, f32_to_unorm16(f));
+        }
+        for (i32 s = -128; s <= 127; ++s) {
+                f32 f = snorm8_to_f32((i8)s);
+                TEST_CHECK(f32_to_snorm8(f) == (s == -128 ? -127 : s), "snorm8 %d round trips to %d", s, f32_to_snorm8(f));
+        }
+        for (i32 u = 0; u <= 255; ++u)
+                TEST_CHECK(f32_to_unorm8(unorm8_to_f32((u8)u)) == u, "unorm8 %d round trips", u);
+
+        TEST_CHECK(snorm16_to_f32(32767) == 1.0f && snorm16_to_f32(-32767) == -1.0f && snorm16_to_f32(0) == 0.0f, "snorm16 ends");
+        TEST_CHECK(unorm16_to_f32(65535) == 1.0f && unorm8_to_f32(255) == 1.0f && snorm8_to_f32(-127) == -1.0f, "norm ends");
+}
+
+/** @brief Floats clamp, round to the nearest code and NaN goes to the lowest one. */
+static void test_norm_quantize(void) {
+        for (int i = 0; i < 20000; ++i) {
+                f32 f = test_uniform(-1.5f, 1.5f);
+                f32 c = fminf(fmaxf(f, -1.0f), 1.0f), u = fminf(fmaxf(f, 0.0f), 1.0f);
+
+                TEST_CHECK(fabsf(snorm16_to_f32(f32_to_snorm16(f)) - c) <= 0.5f / 32767.0f + 1e-7f, "snorm16 of %g", f);
+                TEST_CHECK(fabsf(unorm16_to_f32(f32_to_unorm16(f)) - u) <= 0.5f / 65535.0f + 1e-7f, "unorm16 of %g", f);
+                TEST_CHECK(fabsf(snorm8_to_f32(f32_to_snorm8(f)) - c) <= 0.5f / 127.0f + 1e-7f, "snorm8 of %g", f);
+                TEST_CHECK(fabsf(unorm8_to_f32(f32_to_unorm8(f)) - u) <= 0.5f / 255.0f + 1e-7f, "unorm8 of %g", f);
+        }
+
+        TEST_CHECK(f32_to_snorm16(NAN) == -32767 && f32_to_snorm8(NAN) == -127, "snorm of NaN");
+        TEST_CHECK(f32_to_unorm16(NAN) == 0 && f32_to_unorm8(NAN) == 0, "unorm of NaN");
+        TEST_CHECK(f32_to_snorm16(INFINITY) == 32767 && f32_to_unorm8(-INFINITY) == 0, "norm of infinity");
+}
+
+static void test_10_10_10_2(void) {
+        // Every packed value without a -512 field or a w of -2 round trips.
+        for (int i = 0; i < 20000; ++i) {
+                u32 p = test_rand();
+                bool lowest = (p & 0x3FF) == 0x200 || (p >> 10 & 0x3FF) == 0x200 || (p >> 20 & 0x3FF) == 0x200 || p >> 30 == 2;
+                if (lowest)
+                        continue;
+                vec4 v = vec4_unpack_10_10_10_2(p);
+                TEST_CHECK(vec4_pack_10_10_10_2(&v) == p, "10-10-10-2 %08x round trips to %08x", p, vec4_pack_10_10_10_2(&v));
+        }
+
+        for (int i = 0; i < 20000; ++i) {
+                vec4 v;
+                test_fill(&v.x, 3, -1.0f, 1.0f);
+                v.w = (f32)((int)(test_rand() % 3) - 1);
+                vec4 r = vec4_unpack_10_10_10_2(vec4_pack_10_10_10_2(&v));
+                TEST_CHECK(test_close_n(&r.x, &v.x, 3, 0.5f / 511.0f + 1e-7f) && r.w == v.w, "10-10-10-2 of (%g %g %g %g)",
+                           v.x, v.y, v.z, v.w);
+        }
+
+        vec4 ones = { 1.0f, -1.0f, 0.0f, -1.0f };
+        vec4 r = vec4_unpack_10_10_10_2(vec4_pack_10_10_10_2(&ones));
+        TEST_CHECK(memcmp(&r, &ones, sizeof(r)) == 0, "10-10-10-2 of (1 -1 0 -1)");
+}
+
+static vec3 random_unit(void) {
+        vec3 v;
+        f32 len;
+
+        do {
+                test_fill(&v.x, 3, -1.0f, 1.0f);
+                len = sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
+        } while (len < 0.1f || len > 1.0f);
+
+        return (vec3){ v.x / len, v.y / len, v.z / len };
+}
+
+static quat random_quat(void) {
+        quat q;
+        f32 len;
+
+        do {
+                test_fill(&q.x, 4, -1.0f, 1.0f);
+                len = sqrtf(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+        } while (len < 0.1f || len > 1.0f);
+
+        return (quat){ q.x / len, q.y / len, q.z / len, q.w / len };
+}
+
+static void test_octahedral(void) {
+        static const vec3 axes[] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+
+        for (int i = 0; i < 6; ++i) {
+                vec3 r = vec3_decode_octahedral(vec3_encode_octahedral(&axes[i]));
+                TEST_CHECK(fabsf(r.x - axes[i].x) + fabsf(r.y - axes[i].y) + fabsf(r.z - axes[i].z) == 0.0f, "octahedral axis %d", i);
+        }
+
+        for (int i = 0; i < 100000; ++i) {
+                vec3 v = random_unit();
+                // A quarter of them near the fold at z = 0, where the error is the largest.
+                if (i % 4 == 0) {
+                        v.z = test_uniform(-1e-3f, 1e-3f);
+                        f32 l = sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
+                        v = (vec3){ v.x / l, v.y / l, v.z / l };
+                }
+
+                vec3 r = vec3_decode_octahedral(vec3_encode_octahedral(&v));
+                f32 len = r.x * r.x + r.y * r.y + r.z * r.z;
+                f32 err = sqrtf((r.x - v.x) * (r.x - v.x) + (r.y - v.y) * (r.y - v.y) + (r.z - v.z) * (r.z - v.z));
+                TEST_CHECK(fabsf(len - 1.0f) <= 1e-6f, "octahedral length %g", sqrtf(len));
+                TEST_CHECK(err <= OCT_ERROR, "octahedral of (%g %g %g) is off by %g", v.x, v.y, v.z, err);
+        }
+
+        // The length of the input does not matter.
+        vec3 v = { 3.0f, -4.0f, 12.0f }, u = { 3.0f / 13.0f, -4.0f / 13.0f, 12.0f / 13.0f };
+        TEST_CHECK(vec3_encode_octahedral(&v) == vec3_encode_octahedral(&u), "octahedral of a long vector");
+}
+
+static void test_smallest3(void) {
+        for (int i = 0; i < 100000; ++i) {
+                quat q = random_quat();
+                u32 p = quat_pack_smallest3(&q);
+                quat r = quat_unpack_smallest3(p);
+                f32 c[4] = { r.x, r.y, r.z, r.w };
+                f32 len = r.x * r.x + r.y * r.y + r.z * r.z + r.w * r.w;
+                f32 s = q.x * r.x + q.y * r.y + q.z * r.z + q.w * r.w < 0.0f ? -1.0f : 1.0f;
+                f32 err = sqrtf((r.x - s * q.x) * (r.x - s * q.x) + (r.y - s * q.y) * (r.y - s * q.y) +
+                                (r.z - s * q.z) * (r.z - s * q.z) + (r.w - s * q.w) * (r.w - s * q.w));
+
+                TEST_CHECK(c[p >> 30] >= 0.0f, "smallest three left out a negative component");
+                TEST_CHECK(fabsf(len - 1.0f) <= 1e-5f, "smallest three length %g", sqrtf(len));
+                TEST_CHECK(err <= SMALLEST3_ERROR, "smallest three of (%g %g %g %g) is off by %g", q.x, q.y, q.z, q.w, err);
+        }
+
+        // q and -q pack the same.
+        quat q = random_quat(), n = { -q.x, -q.y, -q.z, -q.w };
+        TEST_CHECK(quat_pack_smallest3(&q) == quat_pack_smallest3(&n), "smallest three of -q");
+}
+
+/** @brief Floats for the batch kernels with every special value in it. */
+static void fill_src(f32 lo, f32 hi) {
+        static const f32 special[] = { 0.0f, -0.0f, INFINITY, -INFINITY, NAN, 1.0f, -1.0f, 2.0f, 65520.0f, 0x1p-25f, 0x1p-20f };
+
+        test_fill(src, N, lo, hi);
+        for (size_t i = 0; i < sizeof(special) / sizeof(special[0]); ++i)
+                src[i * 37] = special[i];
+        src[N - 1] = -NAN;
+}
+
+/** @brief The bits of a and b are equal, or both are NaN. */
+static bool same_or_nan(const f32 *a, const f32 *b, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                if (f32_bits(a[i]) != f32_bits(b[i]) && !(isnan(a[i]) && isnan(b[i])))
+                        return false;
+        }
+        return true;
+}
+
+static void test_pack_array(size_t n) {
+        static const struct { smath_pack_format fmt; size_t size; f32 lo, hi; } formats[] = {
+                { SMATH_PACK_F16, 2, -70000.0f, 70000.0f }, { SMATH_PACK_F16, 2, -1e-4f, 1e-4f },
+                { SMATH_PACK_SNORM16, 2, -1.2f, 1.2f }, { SMATH_PACK_UNORM16, 2, -0.2f, 1.2f },
+                { SMATH_PACK_SNORM8, 1, -1.2f, 1.2f }, { SMATH_PACK_UNORM8, 1, -0.2f, 1.2f },
+        };
+
+        for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); ++f) {
+                smath_pack_format fmt = formats[f].fmt;
+                size_t size = formats[f].size;
+
+                fill_src(formats[f].lo, formats[f].hi);
+                for (size_t i = 0; i < n; ++i) {
+                        switch (fmt) {
+                        case SMATH_PACK_F16: ((u16*)packed_ref)[i] = f32_to_f16(src[i]); break;
+                        case SMATH_PACK_SNORM16: ((i16*)packed_ref)[i] = f32_to_snorm16(src[i]); break;
+                        case SMATH_PACK_UNORM16: ((u16*)packed_ref)[i] = f32_to_unorm16(src[i]); break;
+                        case SMATH_PACK_SNORM8: ((i8*)packed_ref)[i] = f32_to_snorm8(src[i]); break;
+                        case SMATH_PACK_UNORM8: ((u8*)packed_ref)[i] = f32_to_unorm8(src[i]); break;
+                        }
+                }
+
+                memset(packed, 0xAB, sizeof(packed));
+                smath_pack_array(packed, src, n, fmt);
+
+                // F16C packs NaN with its payload, only the NaN is the same.
+                bool same = true;
+                for (size_t i = 0; i < n; ++i) {
+                        bool equal = memcmp(packed + i * size, packed_ref + i * size, size) == 0;
+                        if (!equal && fmt == SMATH_PACK_F16 && isnan(src[i]))
+                                equal = (((u16*)packed)[i] & 0x7FFF) > 0x7C00 && (((u16*)packed)[i] & 0x8000) == (((u16*)packed_ref)[i] & 0x8000);
+                        same = same && equal;
+                }
+                TEST_CHECK(same, "smath_pack_array format %d n %zu", fmt, n);
+                TEST_CHECK(packed[n * size] == 0xAB, "smath_pack_array format %d n %zu wrote past n", fmt, n);
+
+                // Every code, unpacked.
+                for (size_t i = 0; i < n * size; ++i)
+                        packed_ref[i] = (u8)test_rand();
+                for (size_t i = 0; i < n; ++i) {
+                        switch (fmt) {
+                        case SMATH_PACK_F16: ref[i] = f16_to_f32(((u16*)packed_ref)[i]); break;
+                        case SMATH_PACK_SNORM16: ref[i] = snorm16_to_f32(((i16*)packed_ref)[i]); break;
+                        case SMATH_PACK_UNORM16: ref[i] = unorm16_to_f32(((u16*)packed_ref)[i]); break;
+                        case SMATH_PACK_SNORM8: ref[i] = snorm8_to_f32(((i8*)packed_ref)[i]); break;
+                        case SMATH_PACK_UNORM8: ref[i] = unorm8_to_f32(((u8*)packed_ref)[i]); break;
+                        }
+                }
+
+                out[n] = 42.0f;
+                smath_unpack_array(out, packed_ref, n, fmt);
+                TEST_CHECK(same_or_nan(out, ref, n), "smath_unpack_array format %d n %zu", fmt, n);
+                TEST_CHECK(out[n] == 42.0f, "smath_unpack_array format %d n %zu wrote past n", fmt, n);
+        }
+}
+
+static void test_soa(size_t n) {
+        vec4_soa v, r;
+        vec3_soa d, e;
+        u32 *p = (u32*)packed, *q = (u32*)packed_ref;
+
+        TEST_CHECK(vec4_soa_create(&v, n) && vec4_soa_create(&r, n), "vec4_soa_create");
+        TEST_CHECK(vec3_soa_create(&d, n) && vec3_soa_create(&e, n), "vec3_soa_create");
+        v.count = d.count = n;
+
+        // 10-10-10-2
+        for (size_t i = 0; i < n; ++i) {
+                v.x[i] = test_uniform(-1.2f, 1.2f);
+                v.y[i] = test_uniform(-1.2f, 1.2f);
+                v.z[i] = test_uniform(-1.0f, 1.0f);
+                v.w[i] = test_uniform(-1.5f, 1.5f);
+                q[i] = vec4_pack_10_10_10_2(&(vec4){ v.x[i], v.y[i], v.z[i], v.w[i] });
+        }
+        p[n] = 0xABABABAB;
+        vec4_soa_pack_10_10_10_2(p, &v);
+        TEST_CHECK(memcmp(p, q, n * sizeof(u32)) == 0 && p[n] == 0xABABABAB, "vec4_soa_pack_10_10_10_2 n %zu", n);
+
+        vec4_soa_unpack_10_10_10_2(&r, q, n);
+        bool same = r.count == n;
+        for (size_t i = 0; i < n; ++i) {
+                vec4 u = vec4_unpack_10_10_10_2(q[i]);
+                same = same && f32_bits(r.x[i]) == f32_bits(u.x) && f32_bits(r.y[i]) == f32_bits(u.y) &&
+                       f32_bits(r.z[i]) == f32_bits(u.z) && f32_bits(r.w[i]) == f32_bits(u.w);
+        }
+        TEST_CHECK(same, "vec4_soa_unpack_10_10_10_2 n %zu", n);
+
+        // Octahedral, a zero vector and the fold included.
+        for (size_t i = 0; i < n; ++i) {
+                vec3 u = random_unit();
+                if (i % 5 == 0)
+                        u.z = 0.0f;
+                if (i == 3)
+                        u = (vec3){ 0.0f, 0.0f, 0.0f };
+                d.x[i] = u.x;
+                d.y[i] = u.y;
+                d.z[i] = u.z;
+                q[i] = vec3_encode_octahedral(&u);
+        }
+        p[n] = 0xABABABAB;
+        vec3_soa_encode_octahedral(p, &d);
+        TEST_CHECK(memcmp(p, q, n * sizeof(u32)) == 0 && p[n] == 0xABABABAB, "vec3_soa_encode_octahedral n %zu", n);
+
+        for (size_t i = 0; i < n; ++i)
+                q[i] = test_rand();
+        vec3_soa_decode_octahedral(&e, q, n);
+        same = e.count == n;
+        for (size_t i = 0; i < n; ++i) {
+                vec3 u = vec3_decode_octahedral(q[i]);
+                same = same && f32_bits(e.x[i]) == f32_bits(u.x) && f32_bits(e.y[i]) == f32_bits(u.y) && f32_bits(e.z[i]) == f32_bits(u.z);
+        }
+        TEST_CHECK(same, "vec3_soa_decode_octahedral n %zu", n);
+
+        // Smallest three, ties between the largest components included.
+        for (size_t i = 0; i < n; ++i) {
+                quat u = random_quat();
+                if (i % 7 == 0)
+                        u = (quat){ 0.5f, -0.5f, 0.5f, -0.5f };
+                v.x[i] = u.x;
+                v.y[i] = u.y;
+                v.z[i] = u.z;
+                v.w[i] = u.w;
+                q[i] = quat_pack_smallest3(&u);
+        }
+        p[n] = 0xABABABAB;
+        quat_soa_pack_smallest3(p, &v);
+        TEST_CHECK(memcmp(p, q, n * sizeof(u32)) == 0 && p[n] == 0xABABABAB, "quat_soa_pack_smallest3 n %zu", n);
+
+        for (size_t i = 0; i < n; ++i)
+                q[i] = test_rand();
+        quat_soa_unpack_smallest3(&r, q, n);
+        same = r.count == n;
+        for (size_t i = 0; i < n; ++i) {
+                quat u = quat_unpack_smallest3(q[i]);
+                same = same && f32_bits(r.x[i]) == f32_bits(u.x) && f32_bits(r.y[i]) == f32_bits(u.y) &&
+                       f32_bits(r.z[i]) == f32_bits(u.z) && f32_bits(r.w[i]) == f32_bits(u.w);
+        }
+        TEST_CHECK(same, "quat_soa_unpack_smallest3 n %zu", n);
+
+        vec4_soa_destroy(&v);
+        vec4_soa_destroy(&r);
+        vec3_soa_destroy(&d);
+        vec3_soa_destroy(&e);
+}
+
+int main(void) {
+        int skip = test_begin("compress");
+        if (skip)
+                return skip;
+
+        test_f16_round_trip();
+        test_f16_rounding();
+        test_norm_round_trip();
+        test_norm_quantize();
+        test_10_10_10_2();
+        test_octahedral();
+        test_smallest3();
+
+        static const size_t counts[] = { 1, 3, 7, 8, 9, 15, 16, 17, 31, 33, N - 1 };
+        for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+                test_pack_array(counts[i]);
+                test_soa(counts[i]);
+        }
+
+        return test_end();
+}
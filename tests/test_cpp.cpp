@@ -0,0 +1,241 @@
+/*
+ * The C++20 layer (smath.hpp): constant evaluated projections, inverses
+ * and rotations, the same matrices as the C functions at run time and
+ * smath::eval over batches, structure of arrays and scalar operands
+ * against the C vector functions. Built twice, against the archive and
+ * with SMATH_HEADER_ONLY (tests/CMakeLists.txt).
+ */
+
+#include <vector>
+
+#include "../include/smath.hpp"
+#include "test.h"
+
+#define N 1001                  // Not a multiple of the vector width
+#define TOL 1e-5f
+#define FOVY 1.0471976f         // 60 degrees
+#define ASPECT 1.7777778f
+#define Z_NEAR 0.1f
+#define Z_FAR 1000.0f
+
+using namespace smath;
+
+/** @brief a and b within tol, usable in a static_assert. */
+static constexpr bool near(f32 a, f32 b, f32 tol) {
+        return (a > b ? a - b : b - a) <= tol;
+}
+
+template<std::size_t R, std::size_t C>
+static constexpr bool near(const mat<R, C, f32> &a, const mat<R, C, f32> &b, f32 tol) {
+        for (std::size_t i = 0; i < R; ++i) {
+                for (std::size_t j = 0; j < C; ++j) {
+                        if (!near(a.t[i][j], b.t[i][j], tol))
+                                return false;
+                }
+        }
+        return true;
+}
+
+/** @brief The depth of a point at distance d in front of the camera. */
+static constexpr f32 depth(const mat4f &m, f32 d) {
+        vec4f c = m * vec4f(0.0f, 0.0f, -d, 1.0f);
+        return c.z / c.w;
+}
+
+
+// Everything below is folded by the compiler, a wrong result does not build.
+
+constexpr mat4f proj = perspective(FOVY, ASPECT, Z_NEAR, Z_FAR);
+constexpr mat4f proj01 = perspective(FOVY, ASPECT, Z_NEAR, Z_FAR, SMATH_CLIP_DEPTH_ZERO_TO_ONE);
+
+static_assert(near(depth(proj, Z_NEAR), -1.0f, TOL) && near(depth(proj, Z_FAR), 1.0f, TOL));
+static_assert(near(depth(proj01, Z_NEAR), 0.0f, TOL) && near(depth(proj01, Z_FAR), 1.0f, TOL));
+static_assert(near(proj.t[1][1], 1.7320508f, TOL) && proj.t[3][2] == -1.0f);      // 1 / tan(30 degrees)
+
+constexpr mat4f rot_z = rotation(vec3f(0.0f, 0.0f, 1.0f), 1.5707964f);
+
+static_assert(near((rot_z * vec4f(1.0f, 0.0f, 0.0f, 1.0f)).x, 0.0f, TOL) &&
+              near((rot_z * vec4f(1.0f, 0.0f, 0.0f, 1.0f)).y, 1.0f, TOL));
+static_assert(near(determinant(rotation(normalize(vec3f(1.0f, 2.0f, 3.0f)), 0.7f)), 1.0f, TOL));
+
+constexpr mat4f model = translation(vec3f(1.0f, -2.0f, 3.0f)) * rotation(normalize(vec3f(1.0f, 1.0f, 0.0f)), 0.5f) *
+                        scaling(vec3f(2.0f, 0.5f, 4.0f));
+
+static_assert(near(inverse(model) * model, mat4f::identity(), TOL));
+static_assert(near(model * inverse(model), mat4f::identity(), TOL));
+static_assert(near(determinant(model), 4.0f, TOL));
+
+
+/** @brief The C++ matrices against the C functions. */
+static void test_matrices(void) {
+        static const smath_clip_depth depths[] = { SMATH_CLIP_DEPTH_NEG_ONE_TO_ONE, SMATH_CLIP_DEPTH_ZERO_TO_ONE };
+
+        for (smath_clip_depth d : depths) {
+                mat4x4 c = mat4x4_perspective(FOVY, ASPECT, Z_NEAR, Z_FAR, d);
+                mat4x4 p = to_c(perspective(FOVY, ASPECT, Z_NEAR, Z_FAR, d));
+                TEST_CHECK(test_close_n(&p.t[0][0], &c.t[0][0], 16, TOL), "perspective %d", (int)d);
+
+                c = mat4x4_ortho(-3.0f, 5.0f, -2.0f, 4.0f, 0.5f, 50.0f, d);
+                p = to_c(ortho(-3.0f, 5.0f, -2.0f, 4.0f, 0.5f, 50.0f, d));
+                TEST_CHECK(test_close_n(&p.t[0][0], &c.t[0][0], 16, TOL), "ortho %d", (int)d);
+        }
+
+        // The constant evaluated one is the same as the one computed at run time.
+        mat4x4 c = mat4x4_perspective(FOVY, ASPECT, Z_NEAR, Z_FAR, SMATH_CLIP_DEPTH_NEG_ONE_TO_ONE);
+        mat4x4 p = to_c(proj);
+        TEST_CHECK(test_close_n(&p.t[0][0], &c.t[0][0], 16, TOL), "constexpr perspective");
+
+        vec3 eye = { 3.0f, 4.0f, 5.0f }, center = { -1.0f, 0.5f, 2.0f }, up = { 0.0f, 1.0f, 0.0f };
+        c = mat4x4_look_at(&eye, &center, &up);
+        p = to_c(look_at(from_c(eye), from_c(center), from_c(up)));
+        TEST_CHECK(test_close_n(&p.t[0][0], &c.t[0][0], 16, TOL), "look_at");
+
+        mat4x4 m = to_c(model);
+        c = mat4x4_inverse(&m);
+        p = to_c(inverse(from_c(m)));
+        TEST_CHECK(test_close_n(&p.t[0][0], &c.t[0][0], 16, TOL), "inverse");
+
+        mat4x4 r = to_c(proj * model);
+        c = to_c(proj);
+        c = mat4x4_mult(&c, &m);
+        TEST_CHECK(test_close_n(&r.t[0][0], &c.t[0][0], 16, TOL), "mat4f * mat4f");
+
+        TEST_CHECK(from_c(to_c(model)) == model, "to_c and from_c");
+}
+
+static std::vector<vec3f> a(N), b(N);
+static std::vector<vec4f> a4(N);
+static std::vector<f32> s(N), fout(N);
+static std::vector<vec3> out(N);
+static std::vector<vec4> out4(N);
+
+/** @brief eval over arrays of vec3f, f32 and C vectors. */
+static void test_batch(void) {
+        test_fill(&a[0].x, 3 * N, -10.0f, 10.0f);
+        test_fill(&b[0].x, 3 * N, -10.0f, 10.0f);
+        test_fill(&a4[0].x, 4 * N, -10.0f, 10.0f);
+        test_fill(s.data(), N, -2.0f, 2.0f);
+
+        // A batch of scalars, a scalar and a vector operand, into C vectors.
+        eval(out, batch(a) * batch(s) + batch(b) * 3.0f - vec3f(1.0f, 2.0f, 3.0f));
+
+        bool same = true;
+        for (int i = 0; i < N; ++i) {
+                vec3 x = to_c(a[i]), y = to_c(b[i]), k = { 1.0f, 2.0f, 3.0f };
+                vec3_scalar_mult(&x, s[i]);
+                vec3_scalar_mult(&y, 3.0f);
+                vec3_add(&x, &y);
+                vec3_sub(&x, &k);
+                same = same && test_same_n(&out[i].x, &x.x, 3);
+        }
+        TEST_CHECK(same, "a * s + b * 3 - k");
+
+        eval(fout, dot(batch(a), batch(b)));
+        same = true;
+        for (int i = 0; i < N; ++i) {
+                vec3 x = to_c(a[i]), y = to_c(b[i]);
+                same = same && test_close(fout[i], vec3_dot(&x, &y), TOL);
+        }
+        TEST_CHECK(same, "dot");
+
+        eval(out, cross(batch(a), batch(b)));
+        same = true;
+        for (int i = 0; i < N; ++i) {
+                vec3 x = to_c(a[i]), y = to_c(b[i]);
+                vec3 z = vec3_cross_product(&x, &y);
+                same = same && test_close_n(&out[i].x, &z.x, 3, TOL);
+        }
+        TEST_CHECK(same, "cross");
+
+        eval(fout, length(batch(a)));
+        eval(out, normalize(batch(a)));
+        same = true;
+        for (int i = 0; i < N; ++i) {
+                vec3 x = to_c(a[i]);
+                same = same && test_close(fout[i], vec3_magnitude(&x), TOL);
+                vec3_normalize(&x);
+                same = same && test_close_n(&out[i].x, &x.x, 3, TOL);
+        }
+        TEST_CHECK(same, "length and normalize");
+
+        // A matrix operand, into C vectors.
+        eval(out4, model * batch(a4));
+        mat4x4 m = to_c(model);
+        same = true;
+        for (int i = 0; i < N; ++i) {
+                vec4 x = to_c(a4[i]);
+                vec4 y = mat4x4_vec4_mult(&m, &x);
+                same = same && test_close_n(&out4[i].x, &y.x, 4, TOL);
+        }
+        TEST_CHECK(same, "mat4f * batch");
+
+        // In place, the destination is an operand at the same index.
+        std::vector<vec3f> c = a;
+        eval(c, batch(c) + batch(b));
+        same = true;
+        for (int i = 0; i < N; ++i)
+                same = same && c[i] == a[i] + b[i];
+        TEST_CHECK(same, "in place");
+}
+
+/** @brief eval from and into vec3_soa/vec4_soa. */
+static void test_soa(void) {
+        vec3_soa sa, sd;
+        vec4_soa s4;
+        TEST_CHECK(vec3_soa_create(&sa, N) && vec3_soa_create(&sd, N) && vec4_soa_create(&s4, N), "soa_create");
+
+        for (int i = 0; i < N; ++i) {
+                sa.x[i] = a[i].x;
+                sa.y[i] = a[i].y;
+                sa.z[i] = a[i].z;
+                s4.x[i] = a4[i].x;
+                s4.y[i] = a4[i].y;
+                s4.z[i] = a4[i].z;
+                s4.w[i] = a4[i].w;
+        }
+        sa.count = N;
+        s4.count = N;
+
+        // Structure of arrays on both sides, the AoS batch b mixed in.
+        eval(sd, cross(batch(sa), batch(b)) + batch(sa) * batch(s));
+        TEST_CHECK(sd.count == N, "the count of the destination is %zu", (size_t)sd.count);
+
+        bool same = true;
+        for (int i = 0; i < N; ++i) {
+                vec3 x = to_c(a[i]), y = to_c(b[i]);
+                vec3 z = vec3_cross_product(&x, &y);
+                vec3_scalar_mult(&x, s[i]);
+                vec3_add(&z, &x);
+                vec3 d = { sd.x[i], sd.y[i], sd.z[i] };
+                same = same && test_close_n(&d.x, &z.x, 3, TOL);
+        }
+        TEST_CHECK(same, "vec3_soa cross + scale");
+
+        eval(fout, dot(batch(s4), batch(a4)));
+        same = true;
+        for (int i = 0; i < N; ++i) {
+                vec4 x = to_c(a4[i]);
+                same = same && test_close(fout[i], vec4_dot(&x, &x), TOL);
+        }
+        TEST_CHECK(same, "vec4_soa dot");
+
+        vec3_soa_destroy(&sa);
+        vec3_soa_destroy(&sd);
+        vec4_soa_destroy(&s4);
+}
+
+int main(void) {
+#ifdef SMATH_HEADER_ONLY
+        int skip = test_begin("cpp header only");
+#else
+        int skip = test_begin("cpp");
+#endif
+        if (skip)
+                return skip;
+
+        test_matrices();
+        test_batch();
+        test_soa();
+
+        return test_end();
+}
@@ -0,0 +1,282 @@
+/*
+ * Frustum culling: the planes of frustum_from_mat4x4 against the corners
+ * of the view volume for both clip depth ranges, reversed Z and an
+ * infinite far plane, the sphere and box kernels against the scalar
+ * plane tests, and frustum_cull_aabb_tree against the flat cull.
+ */
+
+#include "test.h"
+
+#define TOL 1e-4f
+#define OBJECTS 1000
+
+static bool bit(const u32 *mask, size_t i) {
+        return (mask[i / 32] >> (i % 32)) & 1;
+}
+
+/** @brief The 4 corners of the view volume at distance d, left/right in bit 0, bottom/top in bit 1. */
+static vec3 corner(f32 d, f32 tan_y, f32 aspect, int k) {
+        f32 y = d * tan_y, x = y * aspect;
+        return (vec3){ k & 1 ? x : -x, k & 2 ? y : -y, -d };
+}
+
+/** @brief From view space into the world with the inverse of the view matrix. */
+static vec3 to_world(const mat4x4 *inv_view, vec3 p) {
+        vec4 v = mat4x4_vec4_mult(inv_view, &(vec4){ p.x, p.y, p.z, 1.0f });
+        return (vec3){ v.x, v.y, v.z };
+}
+
+/**
+ * @brief Every plane goes through the 4 corners on its side, the center is inside.
+ *
+ * near_d and far_d are the distances of the planes FRUSTUM_NEAR and
+ * FRUSTUM_FAR end up at, swapped for reversed Z, 0 for a plane at infinity.
+ */
+static void check_planes(const char *name, const frustum *f, const mat4x4 *inv_view, f32 tan_y, f32 aspect,
+                         f32 z_near, f32 z_far, f32 near_d, f32 far_d) {
+        for (int i = 0; i < 6; ++i) {
+                const plane *p = &f->p[i];
+                f32 len = sqrtf(p->x * p->x + p->y * p->y + p->z * p->z);
+
+                if ((i == FRUSTUM_NEAR && near_d == 0.0f) || (i == FRUSTUM_FAR && far_d == 0.0f)) {
+                        TEST_CHECK(len == 0.0f && p->w > 0.0f, "%s plane %d at infinity: (%g %g %g %g)", name, i, p->x, p->y, p->z, p->w);
+                        continue;
+                }
+                TEST_CHECK(fabsf(len - 1.0f) < TOL, "%s plane %d normal length %g", name, i, len);
+        }
+
+        // The side planes through the corners at both distances, near and far through their own corners.
+        static const int side_bits[4][2] = { { 1, 0 }, { 1, 1 }, { 2, 0 }, { 2, 2 } };
+        f32 scale = 1.0f + z_far;
+
+        for (int k = 0; k < 4; ++k) {
+                for (int s = 0; s < 4; ++s) {
+                        if ((k & side_bits[s][0]) != side_bits[s][1])
+                                continue;
+                        vec3 a = to_world(inv_view, corner(z_near, tan_y, aspect, k));
+                        vec3 b = to_world(inv_view, corner(z_far, tan_y, aspect, k));
+                        f32 da = plane_distance(&f->p[s], &a), db = plane_distance(&f->p[s], &b);
+                        TEST_CHECK(fabsf(da) < TOL * scale && fabsf(db) < TOL * scale, "%s plane %d corner %d: %g %g", name, s, k, da, db);
+                }
+
+                if (near_d > 0.0f) {
+                        vec3 c = to_world(inv_view, corner(near_d, tan_y, aspect, k));
+                        f32 d = plane_distance(&f->p[FRUSTUM_NEAR], &c);
+                        TEST_CHECK(fabsf(d) < TOL * scale, "%s near plane corner %d: %g", name, k, d);
+                }
+                if (far_d > 0.0f) {
+                        vec3 c = to_world(inv_view, corner(far_d, tan_y, aspect, k));
+                        f32 d = plane_distance(&f->p[FRUSTUM_FAR], &c);
+                        TEST_CHECK(fabsf(d) < TOL * scale, "%s far plane corner %d: %g", name, k, d);
+                }
+        }
+
+        vec3 center = to_world(inv_view, (vec3){ 0.0f, 0.0f, -0.5f * (z_near + z_far) });
+        vec3 behind = to_world(inv_view, (vec3){ 0.0f, 0.0f, 0.5f * z_near });
+        for (int i = 0; i < 6; ++i)
+                TEST_CHECK(plane_distance(&f->p[i], &center) > 0.0f, "%s center outside plane %d", name, i);
+        TEST_CHECK(!frustum_test_sphere(f, &(sphere){ behind, 0.1f * z_near }), "%s a sphere behind the camera is visible", name);
+}
+
+static void test_planes(void) {
+        f32 fovy = 1.1f, aspect = 1.6f, z_near = 0.5f, z_far = 100.0f, tan_y = tanf(0.5f * fovy);
+        vec3 eye = { 3.0f, -2.0f, 5.0f }, center = { -1.0f, 4.0f, -7.0f }, up = { 0.0f, 0.0f, 1.0f };
+        mat4x4 view = mat4x4_look_at(&eye, &center, &up);
+        mat4x4 inv_view = mat4x4_inverse_rigid(&view);
+        mat4x4 identity = { { { 1.0f, 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f, 0.0f },
+                              { 0.0f, 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f } } };
+        frustum f;
+
+        const mat4x4 *views[2] = { &identity, &view }, *inv_views[2] = { &identity, &inv_view };
+
+        for (int v = 0; v < 2; ++v) {
+                for (int depth = 0; depth < 2; ++depth) {
+                        smath_clip_depth d = depth ? SMATH_CLIP_DEPTH_ZERO_TO_ONE : SMATH_CLIP_DEPTH_NEG_ONE_TO_ONE;
+                        char name[64];
+
+                        mat4x4 proj = mat4x4_perspective(fovy, aspect, z_near, z_far, d);
+                        mat4x4 vp = mat4x4_mult(&proj, views[v]);
+                        snprintf(name, sizeof(name), "perspective depth %d view %d", depth, v);
+                        frustum_from_mat4x4(&f, &vp, d);
+                        check_planes(name, &f, inv_views[v], tan_y, aspect, z_near, z_far, z_near, z_far);
+
+                        proj = mat4x4_perspective_infinite(fovy, aspect, z_near, d);
+                        vp = mat4x4_mult(&proj, views[v]);
+                        snprintf(name, sizeof(name), "perspective_infinite depth %d view %d", depth, v);
+                        frustum_from_mat4x4(&f, &vp, d);
+                        check_planes(name, &f, inv_views[v], tan_y, aspect, z_near, z_far, z_near, 0.0f);
+                }
+
+                // Reversed Z takes the 0 to 1 range with the near and far planes swapped.
+                char name[64];
+                mat4x4 proj = mat4x4_perspective_reversed(fovy, aspect, z_near, z_far);
+                mat4x4 vp = mat4x4_mult(&proj, views[v]);
+                snprintf(name, sizeof(name), "perspective_reversed view %d", v);
+                frustum_from_mat4x4(&f, &vp, SMATH_CLIP_DEPTH_ZERO_TO_ONE);
+                check_planes(name, &f, inv_views[v], tan_y, aspect, z_near, z_far, z_far, z_near);
+
+                proj = mat4x4_perspective_reversed_infinite(fovy, aspect, z_near);
+                vp = mat4x4_mult(&proj, views[v]);
+                snprintf(name, sizeof(name), "perspective_reversed_infinite view %d", v);
+                frustum_from_mat4x4(&f, &vp, SMATH_CLIP_DEPTH_ZERO_TO_ONE);
+                check_planes(name, &f, inv_views[v], tan_y, aspect, z_near, z_far, 0.0f, z_near);
+        }
+
+        // An orthographic box, the planes are the faces.
+        for (int depth = 0; depth < 2; ++depth) {
+                smath_clip_depth d = depth ? SMATH_CLIP_DEPTH_ZERO_TO_ONE : SMATH_CLIP_DEPTH_NEG_ONE_TO_ONE;
+                mat4x4 proj = mat4x4_ortho(-2.0f, 4.0f, -1.0f, 3.0f, 1.0f, 50.0f, d);
+                static const vec4 expected[6] = {
+                        { 1.0f, 0.0f, 0.0f, 2.0f }, { -1.0f, 0.0f, 0.0f, 4.0f }, { 0.0f, 1.0f, 0.0f, 1.0f },
+                        { 0.0f, -1.0f, 0.0f, 3.0f }, { 0.0f, 0.0f, -1.0f, -1.0f }, { 0.0f, 0.0f, 1.0f, 50.0f }
+                };
+
+                frustum_from_mat4x4(&f, &proj, d);
+                for (int i = 0; i < 6; ++i)
+                        TEST_CHECK(test_close_n(&f.p[i].x, &expected[i].x, 4, TOL), "ortho depth %d plane %d: (%g %g %g %g)",
+                                   depth, i, f.p[i].x, f.p[i].y, f.p[i].z, f.p[i].w);
+        }
+}
+
+
+/** @brief A view volume looking down -z and objects around it, a third of them across a plane. */
+static void scene_frustum(frustum *f) {
+        vec3 eye = { 0.0f, 0.0f, 0.0f }, center = { 0.3f, -0.2f, -1.0f }, up = { 0.0f, 1.0f, 0.0f };
+        mat4x4 view = mat4x4_look_at(&eye, &center, &up);
+        mat4x4 proj = mat4x4_perspective(1.0f, 1.5f, 1.0f, 60.0f, SMATH_CLIP_DEPTH_ZERO_TO_ONE);
+        mat4x4 vp = mat4x4_mult(&proj, &view);
+        frustum_from_mat4x4(f, &vp, SMATH_CLIP_DEPTH_ZERO_TO_ONE);
+}
+
+/** @brief The smallest distance of a sphere test to the decision, where the kernels with FMA may round the other way. */
+static f32 sphere_margin(const frustum *f, const sphere *s) {
+        f32 m = INFINITY;
+        for (int i = 0; i < 6; ++i)
+                m = fminf(m, fabsf(plane_distance(&f->p[i], &s->center) + s->radius));
+        return m;
+}
+
+static void test_kernels(void) {
+        static const size_t counts[] = { 1, 3, 4, 5, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 257 };
+        frustum f;
+        scene_frustum(&f);
+
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+                size_t count = counts[c], words = (count + 31) / 32;
+                sphere_soa s;
+                aabb_soa b;
+                u32 visible[10];
+
+                TEST_CHECK(vec4_soa_create(&s, count) && vec3_soa_create(&b.min, count) && vec3_soa_create(&b.max, count),
+                           "create %zu", count);
+
+                for (size_t i = 0; i < count; ++i) {
+                        s.x[i] = test_uniform(-60.0f, 60.0f);
+                        s.y[i] = test_uniform(-60.0f, 60.0f);
+                        s.z[i] = test_uniform(-70.0f, 10.0f);
+                        s.w[i] = test_uniform(0.1f, 8.0f);
+                        b.min.x[i] = s.x[i] - test_uniform(0.1f, 8.0f);
+                        b.min.y[i] = s.y[i] - test_uniform(0.1f, 8.0f);
+                        b.min.z[i] = s.z[i] - test_uniform(0.1f, 8.0f);
+                        b.max.x[i] = s.x[i] + test_uniform(0.1f, 8.0f);
+                        b.max.y[i] = s.y[i] + test_uniform(0.1f, 8.0f);
+                        b.max.z[i] = s.z[i] + test_uniform(0.1f, 8.0f);
+                }
+
+                memset(visible, 0xff, sizeof(visible));
+                frustum_cull_spheres(&f, &s, visible);
+                int shown = 0;
+                for (size_t i = 0; i < count; ++i) {
+                        sphere si = { { s.x[i], s.y[i], s.z[i] }, s.w[i] };
+                        bool ref = frustum_test_sphere(&f, &si);
+                        shown += ref;
+                        TEST_CHECK(bit(visible, i) == ref || sphere_margin(&f, &si) < TOL,
+                                   "frustum_cull_spheres count %zu sphere %zu: %d, expected %d", count, i, bit(visible, i), ref);
+                }
+                if (count % 32)
+                        TEST_CHECK(visible[words - 1] >> (count % 32) == 0, "frustum_cull_spheres count %zu: bits past count", count);
+                TEST_CHECK(visible[words] == 0xffffffffu, "frustum_cull_spheres count %zu: word past the mask", count);
+
+                // The box kernel adds in the order of frustum_test_aabb, so it agrees exactly.
+                memset(visible, 0xff, sizeof(visible));
+                frustum_cull_aabbs(&f, &b, visible);
+                for (size_t i = 0; i < count; ++i) {
+                        aabb bi = { { b.min.x[i], b.min.y[i], b.min.z[i] }, { b.max.x[i], b.max.y[i], b.max.z[i] } };
+                        bool ref = frustum_test_aabb(&f, &bi);
+                        shown += ref;
+                        TEST_CHECK(bit(visible, i) == ref, "frustum_cull_aabbs count %zu box %zu: %d, expected %d",
+                                   count, i, bit(visible, i), ref);
+                }
+                if (count % 32)
+                        TEST_CHECK(visible[words - 1] >> (count % 32) == 0, "frustum_cull_aabbs count %zu: bits past count", count);
+                TEST_CHECK(visible[words] == 0xffffffffu, "frustum_cull_aabbs count %zu: word past the mask", count);
+
+                if (count >= 64)
+                        TEST_CHECK(shown > 0 && shown < (int)(2 * count), "count %zu: %d of %zu visible", count, shown, 2 * count);
+
+                vec4_soa_destroy(&s);
+                vec3_soa_destroy(&b.min);
+                vec3_soa_destroy(&b.max);
+        }
+}
+
+
+/** @brief The tree over a BVH reports every box of the flat cull, with and without the objects. */
+static void test_tree(void) {
+        static aabb boxes[OBJECTS];
+        static u32 flat[(OBJECTS + 31) / 32], tree[(OBJECTS + 31) / 32], leaves[(OBJECTS + 31) / 32];
+        frustum f;
+        smath_bvh bvh;
+        aabb_soa slots;
+
+        scene_frustum(&f);
+
+        for (int i = 0; i < OBJECTS; ++i) {
+                vec3 c, e;
+                c = (vec3){ test_uniform(-80.0f, 80.0f), test_uniform(-80.0f, 80.0f), test_uniform(-90.0f, 20.0f) };
+                test_fill(&e.x, 3, 0.1f, 3.0f);
+                boxes[i] = (aabb){ { c.x - e.x, c.y - e.y, c.z - e.z }, { c.x + e.x, c.y + e.y, c.z + e.z } };
+        }
+
+        TEST_CHECK(smath_bvh_create(&bvh, boxes, OBJECTS), "smath_bvh_create");
+        TEST_CHECK(vec3_soa_create(&slots.min, OBJECTS) && vec3_soa_create(&slots.max, OBJECTS), "create slots");
+
+        // The bits of the tree cull are slots, the flat cull runs over the boxes in slot order.
+        for (size_t j = 0; j < OBJECTS; ++j) {
+                slots.min.x[j] = bvh.boxes[j].min.x; slots.min.y[j] = bvh.boxes[j].min.y; slots.min.z[j] = bvh.boxes[j].min.z;
+                slots.max.x[j] = bvh.boxes[j].max.x; slots.max.y[j] = bvh.boxes[j].max.y; slots.max.z[j] = bvh.boxes[j].max.z;
+        }
+
+        frustum_cull_aabbs(&f, &slots, flat);
+        memset(tree, 0, sizeof(tree));
+        memset(leaves, 0, sizeof(leaves));
+        frustum_cull_aabb_tree(&f, bvh.nodes, bvh.node_count, &slots, tree);
+        frustum_cull_aabb_tree(&f, bvh.nodes, bvh.node_count, NULL, leaves);
+
+        int visible = 0, extra = 0;
+        for (size_t j = 0; j < OBJECTS; ++j) {
+                visible += bit(flat, j);
+                extra += bit(tree, j) && !bit(flat, j);
+                TEST_CHECK(!bit(flat, j) || bit(tree, j), "frustum_cull_aabb_tree misses slot %zu", j);
+                TEST_CHECK(!bit(tree, j) || bit(leaves, j), "frustum_cull_aabb_tree without objects misses slot %zu", j);
+        }
+        TEST_CHECK(visible > 0 && visible < OBJECTS, "%d of %d boxes visible", visible, OBJECTS);
+
+        // Only boxes near a corner of the frustum may come out visible on top of the flat cull.
+        TEST_CHECK(extra <= visible / 4, "frustum_cull_aabb_tree reports %d boxes on top of %d", extra, visible);
+
+        vec3_soa_destroy(&slots.min);
+        vec3_soa_destroy(&slots.max);
+        smath_bvh_destroy(&bvh);
+}
+
+int main(void) {
+        int skip = test_begin("culling");
+        if (skip)
+                return skip;
+
+        test_planes();
+        test_kernels();
+        test_tree();
+        return test_end();
+}
@@ -0,0 +1,95 @@
+/*
+ * The kernel table SMATH_ISA selects against the scalar one, for the
+ * kernels every instruction set has its own object set of (kernels_<isa>.c).
+ */
+
+#include "test.h"
+
+#define N 67
+
+int main(void) {
+        int skip = test_begin("dispatch");
+        if (skip)
+                return skip;
+
+        const smath_kernels *k = smath_get_kernels();
+        smath_isa isa = k->isa;
+
+        static mat4x4 a[N], b[N], simd[N], ref[N];
+        static vec3 p[N], p_simd[N], p_ref[N], d_simd[N], d_ref[N];
+        static vec4 v[N], v_simd[N], v_ref[N];
+
+        test_fill(&a[0].t[0][0], N * 16, -4.0f, 4.0f);
+        test_fill(&b[0].t[0][0], N * 16, -4.0f, 4.0f);
+        test_fill(&p[0].x, N * 3, -100.0f, 100.0f);
+        test_fill(&v[0].x, N * 4, -100.0f, 100.0f);
+
+        TEST_CHECK(smath_set_isa(SMATH_ISA_SCALAR) == SMATH_ISA_SCALAR, "scalar table");
+        TEST_CHECK(smath_get_kernels()->isa == SMATH_ISA_SCALAR, "scalar table bound");
+
+        // The exported mat4x4_mult calls the SSE version in SSE builds, the scalar table has its own.
+        TEST_CHECK(smath_get_kernels()->mat4x4_mult != mat4x4_mult, "the scalar mat4x4_mult is the exported one");
+        TEST_CHECK(smath_get_kernels()->mat4x4_vec4_mult != mat4x4_vec4_mult,
+                   "the scalar mat4x4_vec4_mult is the exported one");
+
+        mat4x4_mult_array(ref, a, b, N);
+        mat4x4_transform_points(&a[0], p, p_ref, N);
+        mat4x4_transform_directions(&a[0], p, d_ref, N);
+        mat4x4_transform_vec4s(&a[0], v, v_ref, N);
+
+        TEST_CHECK(smath_set_isa(isa) == isa, "%s table", smath_isa_name(isa));
+        TEST_CHECK(smath_get_kernels() == k, "the same table is bound again");
+
+        mat4x4_mult_array(simd, a, b, N);
+        mat4x4_transform_points(&a[0], p, p_simd, N);
+        mat4x4_transform_directions(&a[0], p, d_simd, N);
+        mat4x4_transform_vec4s(&a[0], v, v_simd, N);
+
+        // The terms of the transforms reach 400, a result near 0 is only exact to about 1e-4.
+        for (int i = 0; i < N; ++i) {
+                TEST_CHECK(test_close_n(&simd[i].t[0][0], &ref[i].t[0][0], 16, 1e-5f), "mat4x4_mult_array %d", i);
+                TEST_CHECK(test_close_n(&p_simd[i].x, &p_ref[i].x, 3, 1e-4f), "mat4x4_transform_points %d", i);
+                TEST_CHECK(test_close_n(&d_simd[i].x, &d_ref[i].x, 3, 1e-4f), "mat4x4_transform_directions %d", i);
+                TEST_CHECK(test_close_n(&v_simd[i].x, &v_ref[i].x, 4, 1e-5f), "mat4x4_transform_vec4s %d", i);
+        }
+
+        // In place, the output overwrites the input.
+        mat4x4_transform_vec4s(&b[0], v, v_simd, N);
+        mat4x4_transform_vec4s(&b[0], v, v, N);
+        mat4x4_mult_array(a, a, b, N);
+
+        for (int i = 0; i < N; ++i) {
+                TEST_CHECK(test_close_n(&a[i].t[0][0], &ref[i].t[0][0], 16, 1e-5f), "mat4x4_mult_array in place %d", i);
+                TEST_CHECK(test_same_n(&v[i].x, &v_simd[i].x, 4), "mat4x4_transform_vec4s in place %d", i);
+        }
+
+        // One point at every index, block, stream prologue and tail give the same bits.
+        static vec3 same[N + 1], out[N + 1], out_stream[N + 1];
+        for (int trial = 0; trial < 200; ++trial) {
+                vec3 q;
+                test_fill(&a[0].t[0][0], 16, -4.0f, 4.0f);
+                test_fill(&q.x, 3, -100.0f, 100.0f);
+                for (int i = 0; i <= N; ++i)
+                        same[i] = q;
+
+                // out + 1 is not 16 byte aligned, the stream version starts with single vectors.
+                mat4x4_transform_points(&a[0], same, out, N);
+                mat4x4_transform_points_stream(&a[0], same, out_stream + 1, N);
+
+                bool points = true, stream = true, directions = true;
+                for (int i = 0; i < N; ++i) {
+                        points &= test_same_n(&out[i].x, &out[0].x, 3);
+                        stream &= test_same_n(&out_stream[i + 1].x, &out[0].x, 3);
+                }
+
+                mat4x4_transform_directions(&a[0], same, out, N);
+                for (int i = 0; i < N; ++i)
+                        directions &= test_same_n(&out[i].x, &out[0].x, 3);
+
+                TEST_CHECK(points, "mat4x4_transform_points depends on the index, trial %d", trial);
+                TEST_CHECK(stream, "mat4x4_transform_points_stream is not mat4x4_transform_points, trial %d", trial);
+                TEST_CHECK(directions, "mat4x4_transform_directions depends on the index, trial %d", trial);
+        }
+
+        return test_end();
+}
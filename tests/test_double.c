@@ -0,0 +1,325 @@
+/*
+ * The double precision types against the float ones and against double
+ * arithmetic done here: dvec and dmat4x4 give the float results on small
+ * integers, which every operation keeps exact in both, the dispatched
+ * dmat4x4 kernels match the scalar template and the camera relative
+ * conversions are (m - origin) rounded once.
+ */
+
+#include "test.h"
+
+#define N 103                   // Not a multiple of 4, the AVX2 dvec3 kernel has a tail
+#define ROUNDS 200
+#define TOL 1e-6f
+
+static dmat4x4 d0[N], d1[N], dd[N], dref[N];
+static mat4x4 fm[N], fref[N];
+static dvec3 dp[N];
+static vec3 fp[N];
+
+/** @brief An integer in [-8, 8], products and sums of a few stay exact in floats. */
+static f32 small_int(void) {
+        return (f32)((int)(test_rand() % 17) - 8);
+}
+
+static vec3 small_vec3(void) {
+        return (vec3){ small_int(), small_int(), small_int() };
+}
+
+static vec4 small_vec4(void) {
+        return (vec4){ small_int(), small_int(), small_int(), small_int() };
+}
+
+static mat4x4 small_mat4x4(void) {
+        mat4x4 m;
+        for (int i = 0; i < 16; ++i)
+                m.t[i / 4][i % 4] = small_int();
+        return m;
+}
+
+/** @brief The double rounded to float equals the float result. */
+static bool same3(const dvec3 *d, const vec3 *f) {
+        return (f32)d->x == f->x && (f32)d->y == f->y && (f32)d->z == f->z;
+}
+
+static bool same4(const dvec4 *d, const vec4 *f) {
+        return (f32)d->x == f->x && (f32)d->y == f->y && (f32)d->z == f->z && (f32)d->w == f->w;
+}
+
+static bool same_mat(const dmat4x4 *d, const mat4x4 *f) {
+        for (int i = 0; i < 16; ++i) {
+                if ((f32)d->t[i / 4][i % 4] != f->t[i / 4][i % 4])
+                        return false;
+        }
+        return true;
+}
+
+/** @brief a and b are equal within tol relative to the larger magnitude above 1. */
+static bool close_f64(f64 a, f64 b, f64 tol) {
+        f64 scale = fmax(1.0, fmax(fabs(a), fabs(b)));
+        return fabs(a - b) <= tol * scale;
+}
+
+static void test_dvec(void) {
+        for (int r = 0; r < ROUNDS; ++r) {
+                vec3 a = small_vec3(), b = small_vec3(), c = small_vec3();
+                dvec3 da = dvec3_from_vec3(&a), db = dvec3_from_vec3(&b), dc = dvec3_from_vec3(&c);
+                f32 s = small_int();
+
+                vec3 f = a;
+                dvec3 d = da;
+                vec3_add(&f, &b);
+                dvec3_add(&d, &db);
+                TEST_CHECK(same3(&d, &f), "dvec3_add");
+                vec3_sub(&f, &c);
+                dvec3_sub(&d, &dc);
+                TEST_CHECK(same3(&d, &f), "dvec3_sub");
+                vec3_scalar_mult(&f, s);
+                dvec3_scalar_mult(&d, s);
+                TEST_CHECK(same3(&d, &f), "dvec3_scalar_mult");
+                vec3_scalar_div(&f, 4.0f);
+                dvec3_scalar_div(&d, 4.0);
+                TEST_CHECK(same3(&d, &f), "dvec3_scalar_div");
+
+                TEST_CHECK((f32)dvec3_dot(&da, &db) == vec3_dot(&a, &b), "dvec3_dot");
+                vec3 fc = vec3_cross_product(&a, &b);
+                dvec3 dcp = dvec3_cross_product(&da, &db);
+                TEST_CHECK(same3(&dcp, &fc), "dvec3_cross_product");
+                vec3 ft = vec3_triple_product(&a, &b, &c);
+                dvec3 dt = dvec3_triple_product(&da, &db, &dc);
+                TEST_CHECK(same3(&dt, &ft), "dvec3_triple_product");
+                TEST_CHECK((f32)dvec3_scalar_triple_product(&da, &db, &dc) == vec3_scalar_triple_product(&a, &b, &c),
+                           "dvec3_scalar_triple_product");
+
+                // The square root of an exact integer, rounded to double and then to float, is the float square root.
+                TEST_CHECK((f32)dvec3_magnitude(&da) == vec3_magnitude(&a), "dvec3_magnitude of (%g %g %g)", a.x, a.y, a.z);
+                TEST_CHECK((f32)dvec3_cross_product_magnitude(&da, &db) == vec3_cross_product_magnitude(&a, &b),
+                           "dvec3_cross_product_magnitude");
+                vec3 fs = { fabsf(a.x), fabsf(a.y), fabsf(a.z) };
+                dvec3 ds = dvec3_from_vec3(&fs);
+                vec3_square_root(&fs);
+                dvec3_square_root(&ds);
+                TEST_CHECK(same3(&ds, &fs), "dvec3_square_root");
+
+                // The division by the rounded length differs, within a float rounding.
+                if (vec3_dot(&a, &a) > 0.0f) {
+                        f = a;
+                        d = da;
+                        vec3_normalize(&f);
+                        dvec3_normalize(&d);
+                        vec3 dn = vec3_from_dvec3(&d);
+                        TEST_CHECK(test_close_n(&dn.x, &f.x, 3, TOL), "dvec3_normalize");
+                }
+
+                vec4 a4 = small_vec4(), b4 = small_vec4();
+                dvec4 da4 = dvec4_from_vec4(&a4), db4 = dvec4_from_vec4(&b4);
+                vec4 f4 = a4;
+                dvec4 d4 = da4;
+                vec4_add(&f4, &b4);
+                dvec4_add(&d4, &db4);
+                TEST_CHECK(same4(&d4, &f4), "dvec4_add");
+                vec4_sub(&f4, &a4);
+                dvec4_sub(&d4, &da4);
+                vec4_scalar_mult(&f4, s);
+                dvec4_scalar_mult(&d4, s);
+                TEST_CHECK(same4(&d4, &f4), "dvec4_sub and dvec4_scalar_mult");
+                TEST_CHECK((f32)dvec4_dot(&da4, &db4) == vec4_dot(&a4, &b4), "dvec4_dot");
+                TEST_CHECK((f32)dvec4_magnitude(&da4) == vec4_magnitude(&a4), "dvec4_magnitude");
+
+                dvec2 d2 = { a.x, a.y }, e2 = { b.x, b.y };
+                vec2 f2 = { a.x, a.y }, g2 = { b.x, b.y };
+                TEST_CHECK((f32)dvec2_dot(&d2, &e2) == vec2_dot(&f2, &g2), "dvec2_dot");
+                TEST_CHECK((f32)dvec2_magnitude(&d2) == vec2_magnitude(&f2), "dvec2_magnitude");
+        }
+
+        // Rounding to float is to nearest.
+        dvec3 d = { 1.0 + 0x1p-24, 1.0 + 0x1.8p-24, -0.1 };
+        vec3 f = vec3_from_dvec3(&d);
+        TEST_CHECK(f.x == 1.0f && f.y == 1.0f + 0x1p-23f && f.z == -0.1f, "vec3_from_dvec3 rounding");
+}
+
+/** @brief A signed permutation, a rotation or reflection whose inverse is its transpose, exactly. */
+static mat4x4 signed_permutation(void) {
+        int p[3] = { 0, 1, 2 };
+        for (int i = 2; i > 0; --i) {
+                int j = (int)(test_rand() % (u32)(i + 1)), t = p[i];
+                p[i] = p[j];
+                p[j] = t;
+        }
+
+        mat4x4 m = { 0 };
+        for (int i = 0; i < 3; ++i) {
+                m.t[i][p[i]] = test_rand() & 1 ? -1.0f : 1.0f;
+                m.t[i][3] = small_int();
+        }
+        m.t[3][3] = 1.0f;
+        return m;
+}
+
+static void test_dmat(void) {
+        for (int r = 0; r < ROUNDS; ++r) {
+                mat4x4 a = small_mat4x4(), b = small_mat4x4();
+                dmat4x4 da = dmat4x4_from_mat4x4(&a), db = dmat4x4_from_mat4x4(&b);
+                vec4 v = small_vec4();
+                dvec4 dv = dvec4_from_vec4(&v);
+
+                mat4x4 fm0 = mat4x4_mult(&a, &b);
+                dmat4x4 dm0 = dmat4x4_mult(&da, &db);
+                TEST_CHECK(same_mat(&dm0, &fm0), "dmat4x4_mult");
+
+                vec4 fv = mat4x4_vec4_mult(&a, &v);
+                dvec4 ddv = dmat4x4_dvec4_mult(&da, &dv);
+                TEST_CHECK(same4(&ddv, &fv), "dmat4x4_dvec4_mult");
+
+                TEST_CHECK((f32)dmat4x4_determinant(&da) == mat4x4_determinant(&a), "dmat4x4_determinant");
+
+                // Diagonally dominant, the float inverse is within rounding of the double one.
+                for (int i = 0; i < 4; ++i)
+                        a.t[i][i] += a.t[i][i] < 0.0f ? -40.0f : 40.0f;
+                da = dmat4x4_from_mat4x4(&a);
+                mat4x4 fi = mat4x4_inverse(&a);
+                dmat4x4 di = dmat4x4_inverse(&da);
+                mat4x4 dfi = mat4x4_from_dmat4x4(&di);
+                TEST_CHECK(test_close_n(&dfi.t[0][0], &fi.t[0][0], 16, 1e-5f), "dmat4x4_inverse");
+
+                f64 det;
+                dmat4x4 dd0 = dmat4x4_inverse_det(&da, &det);
+                TEST_CHECK(memcmp(&dd0, &di, sizeof(di)) == 0 && close_f64(det, dmat4x4_determinant(&da), 1e-12), "dmat4x4_inverse_det");
+
+                // Exact inverses of exact rigid transforms.
+                mat4x4 rigid = signed_permutation();
+                dmat4x4 drigid = dmat4x4_from_mat4x4(&rigid);
+                mat4x4 fr = mat4x4_inverse_rigid(&rigid);
+                dmat4x4 dr = dmat4x4_inverse_rigid(&drigid);
+                TEST_CHECK(same_mat(&dr, &fr), "dmat4x4_inverse_rigid");
+                fr = mat4x4_inverse_affine(&rigid);
+                dr = dmat4x4_inverse_affine(&drigid);
+                TEST_CHECK(same_mat(&dr, &fr), "dmat4x4_inverse_affine");
+        }
+}
+
+/** @brief Random doubles that do not fit in floats. */
+static void fill_f64(f64 *d, size_t n, f64 lo, f64 hi) {
+        for (size_t i = 0; i < n; ++i)
+                d[i] = lo + (hi - lo) * ((f64)test_rand() / 4294967296.0 + (f64)test_rand() / 18446744073709551616.0);
+}
+
+/** @brief The dispatched kernel against dmat4x4_mult, exact unless the kernel fuses multiply and add. */
+static void test_mult_array(void) {
+        smath_isa isa = smath_get_kernels()->isa;
+        f64 tol = isa == SMATH_ISA_AVX2 || isa == SMATH_ISA_AVX512 ? 1e-14 : 0.0;
+
+        fill_f64(&d0[0].t[0][0], 16 * N, -10.0, 10.0);
+        fill_f64(&d1[0].t[0][0], 16 * N, -10.0, 10.0);
+        for (size_t i = 0; i < N; ++i)
+                dref[i] = dmat4x4_mult(&d0[i], &d1[i]);
+
+        for (size_t n = 0; n <= N; n += n < 9 ? 1 : 47) {
+                memset(dd, 0xff, sizeof(dd));
+                dmat4x4_mult_array(dd, d0, d1, n);
+
+                bool same = true;
+                for (size_t i = 0; i < n; ++i)
+                        for (int j = 0; j < 16; ++j)
+                                same = same && close_f64(dd[i].t[j / 4][j % 4], dref[i].t[j / 4][j % 4], tol);
+                TEST_CHECK(same, "dmat4x4_mult_array n %zu", n);
+                TEST_CHECK(n == N || isnan(dd[n].t[0][0]), "dmat4x4_mult_array n %zu wrote past n", n);
+        }
+
+        // In place into either operand.
+        memcpy(dd, d0, sizeof(dd));
+        dmat4x4_mult_array(dd, dd, d1, N);
+        bool same = true;
+        for (size_t i = 0; i < N; ++i)
+                for (int j = 0; j < 16; ++j)
+                        same = same && close_f64(dd[i].t[j / 4][j % 4], dref[i].t[j / 4][j % 4], tol);
+        TEST_CHECK(same, "dmat4x4_mult_array into m0");
+
+        memcpy(dd, d1, sizeof(dd));
+        dmat4x4_mult_array(dd, d0, dd, N);
+        same = true;
+        for (size_t i = 0; i < N; ++i)
+                for (int j = 0; j < 16; ++j)
+                        same = same && close_f64(dd[i].t[j / 4][j % 4], dref[i].t[j / 4][j % 4], tol);
+        TEST_CHECK(same, "dmat4x4_mult_array into m1");
+}
+
+/** @brief The camera relative conversions are (m - origin) in double, rounded once to float. */
+static void test_relative(void) {
+        smath_isa isa = smath_get_kernels()->isa;
+        bool fma = isa == SMATH_ISA_AVX2 || isa == SMATH_ISA_AVX512;
+        dvec3 origin;
+
+        // Far from (0, 0, 0), the objects within 1000 of the origin.
+        fill_f64(&origin.x, 3, -1e8, 1e8);
+
+        for (size_t i = 0; i < N; ++i) {
+                mat4x4 r = signed_permutation();
+                d0[i] = dmat4x4_from_mat4x4(&r);
+                fill_f64(&d0[i].t[0][0], 3, -1.0, 1.0);
+                d0[i].t[0][3] = origin.x + (f64)test_uniform(-1000.0f, 1000.0f) + 0.123456789;
+                d0[i].t[1][3] = origin.y + (f64)test_uniform(-1000.0f, 1000.0f);
+                d0[i].t[2][3] = origin.z + (f64)test_uniform(-1000.0f, 1000.0f);
+
+                fill_f64(&dp[i].x, 3, -1000.0, 1000.0);
+                dp[i].x += origin.x;
+                dp[i].y += origin.y;
+                dp[i].z += origin.z;
+        }
+
+        // Affine: the 3x3 rounds, the translation is the difference rounded once, on every ISA.
+        dmat4x4_to_mat4x4_relative_array(fm, d0, &origin, N);
+        bool same = true, single = true;
+        for (size_t i = 0; i < N; ++i) {
+                const f64 o[3] = { origin.x, origin.y, origin.z };
+                mat4x4 s = dmat4x4_to_mat4x4_relative(&d0[i], &origin);
+                for (int r = 0; r < 4; ++r) {
+                        for (int c = 0; c < 4; ++c) {
+                                f64 e = d0[i].t[r][c] - (r < 3 && c == 3 ? o[r] : 0.0);
+                                same = same && fm[i].t[r][c] == (f32)e;
+                                single = single && s.t[r][c] == (f32)e;
+                        }
+                }
+        }
+        TEST_CHECK(same, "dmat4x4_to_mat4x4_relative_array of affine matrices");
+        TEST_CHECK(single, "dmat4x4_to_mat4x4_relative of affine matrices");
+
+        // A full last row, the kernel against the scalar function.
+        for (size_t i = 0; i < N; ++i)
+                fill_f64(d0[i].t[3], 4, -1.0, 1.0);
+        dmat4x4_to_mat4x4_relative_array(fm, d0, &origin, N);
+        same = true;
+        for (size_t i = 0; i < N; ++i) {
+                fref[i] = dmat4x4_to_mat4x4_relative(&d0[i], &origin);
+                same = same && (fma ? test_close_n(&fm[i].t[0][0], &fref[i].t[0][0], 16, 1e-6f)
+                                    : memcmp(&fm[i], &fref[i], sizeof(mat4x4)) == 0);
+        }
+        TEST_CHECK(same, "dmat4x4_to_mat4x4_relative_array of projective matrices");
+
+        // Positions, every count up to 9 for the tail and then all.
+        for (size_t n = 0; n <= N; n += n < 9 ? 1 : N - 9) {
+                memset(fp, 0xff, sizeof(fp));
+                dvec3_to_vec3_relative_array(fp, dp, &origin, n);
+                same = true;
+                for (size_t i = 0; i < n; ++i) {
+                        vec3 e = { (f32)(dp[i].x - origin.x), (f32)(dp[i].y - origin.y), (f32)(dp[i].z - origin.z) };
+                        vec3 s = vec3_from_dvec3_relative(&dp[i], &origin);
+                        same = same && memcmp(&fp[i], &e, sizeof(e)) == 0 && memcmp(&s, &e, sizeof(e)) == 0;
+                }
+                TEST_CHECK(same, "dvec3_to_vec3_relative_array n %zu", n);
+                TEST_CHECK(n == N || isnan(fp[n].x), "dvec3_to_vec3_relative_array n %zu wrote past n", n);
+        }
+}
+
+int main(void) {
+        int skip = test_begin("double");
+        if (skip)
+                return skip;
+
+        test_dvec();
+        test_dmat();
+        test_mult_array();
+        test_relative();
+
+        return test_end();
+}
@@ -0,0 +1,220 @@
+/*
+ * The bounds of fast_math.h: SMATH_FAST_RSQRT_ERROR and SMATH_FAST_RCP_ERROR
+ * over the whole range of the inputs, SMATH_FAST_NORMALIZE_ERROR for the
+ * pointer, value and SoA normalize, and what 0, denormals and infinity give.
+ */
+
+#include <float.h>
+
+#include "test.h"
+
+#define N 1000
+#define COUNT 103
+
+/** @brief The float with the bits b. */
+static f32 bits(u32 b) {
+        f32 f;
+        memcpy(&f, &b, sizeof(f));
+        return f;
+}
+
+/** @brief The relative error of r against the double e. */
+static f64 rel_error(f32 r, f64 e) {
+        return fabs((f64)r - e) / fabs(e);
+}
+
+/** @brief A vector of random direction with a magnitude of 2^e, x can be made denormal. */
+static vec4 random_vec4(int e, bool denormal) {
+        vec4 v;
+        test_fill(&v.x, 4, -1.0f, 1.0f);
+        f32 s = ldexpf(1.0f, e) / sqrtf(v.x * v.x + v.y * v.y + v.z * v.z + v.w * v.w);
+        v.x *= s;
+        v.y *= s;
+        v.z *= s;
+        v.w *= s;
+        if (denormal)
+                v.x = 1e-40f;
+        return v;
+}
+
+static f64 magnitude3(const f32 *v) {
+        return sqrt((f64)v[0] * v[0] + (f64)v[1] * v[1] + (f64)v[2] * v[2]);
+}
+
+static f64 magnitude4(const f32 *v) {
+        return sqrt((f64)v[0] * v[0] + (f64)v[1] * v[1] + (f64)v[2] * v[2] + (f64)v[3] * v[3]);
+}
+
+static void test_rsqrt(void) {
+        f64 worst = 0.0;
+
+        // Every 251st normal float from FLT_MIN to FLT_MAX.
+        for (u32 b = 0x00800000u; b < 0x7f800000u; b += 251) {
+                f32 x = bits(b);
+                f64 e = rel_error(smath_fast_rsqrt(x), 1.0 / sqrt((f64)x));
+                worst = e > worst ? e : worst;
+        }
+        TEST_CHECK(worst <= SMATH_FAST_RSQRT_ERROR, "smath_fast_rsqrt error %g", worst);
+        TEST_CHECK(rel_error(smath_fast_rsqrt(FLT_MIN), 1.0 / sqrt((f64)FLT_MIN)) <= SMATH_FAST_RSQRT_ERROR, "FLT_MIN");
+        TEST_CHECK(rel_error(smath_fast_rsqrt(FLT_MAX), 1.0 / sqrt((f64)FLT_MAX)) <= SMATH_FAST_RSQRT_ERROR, "FLT_MAX");
+
+        TEST_CHECK(smath_fast_rsqrt(0.0f) == INFINITY, "smath_fast_rsqrt(0) %g", smath_fast_rsqrt(0.0f));
+        TEST_CHECK(smath_fast_rsqrt(-0.0f) == -INFINITY, "smath_fast_rsqrt(-0) %g", smath_fast_rsqrt(-0.0f));
+        TEST_CHECK(smath_fast_rsqrt(INFINITY) == 0.0f, "smath_fast_rsqrt(inf) %g", smath_fast_rsqrt(INFINITY));
+        TEST_CHECK(isnan(smath_fast_rsqrt(-1.0f)), "smath_fast_rsqrt(-1) %g", smath_fast_rsqrt(-1.0f));
+        TEST_CHECK(isnan(smath_fast_rsqrt(NAN)), "smath_fast_rsqrt(nan)");
+
+        // Flushed to 0 with SSE, exact without.
+        f32 denormals[] = { bits(1), 1e-40f, FLT_MIN * 0.5f, bits(0x007fffffu) };
+        for (int i = 0; i < 4; ++i) {
+                f32 r = smath_fast_rsqrt(denormals[i]);
+                TEST_CHECK(r == INFINITY || rel_error(r, 1.0 / sqrt((f64)denormals[i])) <= SMATH_FAST_RSQRT_ERROR,
+                           "smath_fast_rsqrt(%g) %g", denormals[i], r);
+        }
+}
+
+static void test_rcp(void) {
+        f64 worst = 0.0;
+
+        // Every 251st float of a magnitude in [2^-126, 2^126), both signs.
+        for (u32 b = 0x00800000u; b < 0x7e800000u; b += 251) {
+                f32 x = bits(b);
+                f64 e = rel_error(smath_fast_rcp(x), 1.0 / x);
+                f64 n = rel_error(smath_fast_rcp(-x), -1.0 / x);
+                worst = e > worst ? e : worst;
+                worst = n > worst ? n : worst;
+        }
+        TEST_CHECK(worst <= SMATH_FAST_RCP_ERROR, "smath_fast_rcp error %g", worst);
+        TEST_CHECK(rel_error(smath_fast_rcp(bits(0x7e7fffffu)), 1.0 / bits(0x7e7fffffu)) <= SMATH_FAST_RCP_ERROR, "below 2^126");
+
+        TEST_CHECK(smath_fast_rcp(0.0f) == INFINITY, "smath_fast_rcp(0) %g", smath_fast_rcp(0.0f));
+        TEST_CHECK(smath_fast_rcp(-0.0f) == -INFINITY, "smath_fast_rcp(-0) %g", smath_fast_rcp(-0.0f));
+        TEST_CHECK(smath_fast_rcp(INFINITY) == 0.0f && !signbit(smath_fast_rcp(INFINITY)), "smath_fast_rcp(inf)");
+        TEST_CHECK(smath_fast_rcp(-INFINITY) == 0.0f && signbit(smath_fast_rcp(-INFINITY)), "smath_fast_rcp(-inf)");
+        TEST_CHECK(isnan(smath_fast_rcp(NAN)), "smath_fast_rcp(nan)");
+
+        // Outside of the range: flushed with SSE, exact without, the sign is kept either way.
+        f32 huge[] = { 0x1p126f, 0x1p127f, FLT_MAX };
+        for (int i = 0; i < 3; ++i) {
+                f32 r = smath_fast_rcp(huge[i]), n = smath_fast_rcp(-huge[i]);
+                TEST_CHECK((r == 0.0f || rel_error(r, 1.0 / huge[i]) <= SMATH_FAST_RCP_ERROR) && !signbit(r),
+                           "smath_fast_rcp(%g) %g", huge[i], r);
+                TEST_CHECK((n == 0.0f || rel_error(n, -1.0 / huge[i]) <= SMATH_FAST_RCP_ERROR) && signbit(n),
+                           "smath_fast_rcp(%g) %g", -huge[i], n);
+        }
+
+        f32 denormals[] = { bits(1), 1e-40f, FLT_MIN * 0.5f };
+        for (int i = 0; i < 3; ++i) {
+                f32 r = smath_fast_rcp(denormals[i]), n = smath_fast_rcp(-denormals[i]);
+                TEST_CHECK(r > 0.0f && (r == INFINITY || rel_error(r, 1.0 / denormals[i]) <= SMATH_FAST_RCP_ERROR),
+                           "smath_fast_rcp(%g) %g", denormals[i], r);
+                TEST_CHECK(n < 0.0f && (n == -INFINITY || rel_error(n, -1.0 / denormals[i]) <= SMATH_FAST_RCP_ERROR),
+                           "smath_fast_rcp(%g) %g", -denormals[i], n);
+        }
+
+        vec4 v = { 1.0f, -2.0f, 3.0f, 4.0f };
+        vec4_fast_scalar_div(&v, 4.0f);
+        TEST_CHECK(rel_error(v.y, -0.5) <= SMATH_FAST_RCP_ERROR + FLT_EPSILON, "vec4_fast_scalar_div %g", v.y);
+}
+
+/** @brief The magnitude is within SMATH_FAST_NORMALIZE_ERROR of 1. */
+#define CHECK_UNIT(m, ...) TEST_CHECK(fabs((m) - 1.0) <= SMATH_FAST_NORMALIZE_ERROR, __VA_ARGS__)
+
+static void test_normalize(void) {
+        // Magnitudes of 2^-62 to 2^62, the squares stay normal floats.
+        for (int i = 0; i < N; ++i) {
+                int e = i % 125 - 62;
+                bool denormal = i % 5 == 0;
+                vec4 v = random_vec4(e, denormal), r;
+                vec3 v3 = { v.x, v.y, v.z }, r3;
+
+                r = v;
+                vec4_fast_normalize(&r);
+                CHECK_UNIT(magnitude4(&r.x), "vec4_fast_normalize 2^%d: %.9g", e, magnitude4(&r.x));
+
+                vec4_storev(&r, vec4_fast_normalizev(vec4_loadv(&v)));
+                CHECK_UNIT(magnitude4(&r.x), "vec4_fast_normalizev 2^%d: %.9g", e, magnitude4(&r.x));
+
+                // The vec3 is the vec4 without w, skip it when that took it below the range.
+                if (magnitude3(&v3.x) < ldexp(1.0, -62))
+                        continue;
+
+                r3 = v3;
+                vec3_fast_normalize(&r3);
+                CHECK_UNIT(magnitude3(&r3.x), "vec3_fast_normalize 2^%d: %.9g", e, magnitude3(&r3.x));
+
+                vec3_storev(&r3, vec3_fast_normalizev(vec3_loadv(&v3)));
+                CHECK_UNIT(magnitude3(&r3.x), "vec3_fast_normalizev 2^%d: %.9g", e, magnitude3(&r3.x));
+        }
+
+        vec4 zero = { 0 };
+        vec4_fast_normalize(&zero);
+        TEST_CHECK(isnan(zero.x) && isnan(zero.w), "vec4_fast_normalize of 0");
+
+        vec3 zero3 = { 0 };
+        vec3_fast_normalize(&zero3);
+        TEST_CHECK(isnan(zero3.x) && isnan(zero3.z), "vec3_fast_normalize of 0");
+}
+
+static void test_soa_normalize(void) {
+        vec3_soa s3;
+        vec4_soa s4;
+        static vec4 v[COUNT];
+
+        if (!vec3_soa_create(&s3, COUNT) || !vec4_soa_create(&s4, COUNT)) {
+                TEST_CHECK(false, "vec3_soa_create and vec4_soa_create");
+                return;
+        }
+
+        for (size_t i = 0; i < COUNT; ++i) {
+                v[i] = random_vec4((int)(i * 37 % 125) - 62, i % 5 == 0);
+                s4.x[i] = v[i].x;
+                s4.y[i] = v[i].y;
+                s4.z[i] = v[i].z;
+                s4.w[i] = v[i].w;
+
+                // x, y and z of the vec4 scaled to the same magnitude, a denormal x stays as it is.
+                f32 s = (f32)(magnitude4(&v[i].x) / magnitude3(&v[i].x));
+                s3.x[i] = i % 5 == 0 ? v[i].x : v[i].x * s;
+                s3.y[i] = v[i].y * s;
+                s3.z[i] = v[i].z * s;
+        }
+
+        // The last vector is zero.
+        s3.x[COUNT - 1] = s3.y[COUNT - 1] = s3.z[COUNT - 1] = 0.0f;
+        s4.x[COUNT - 1] = s4.y[COUNT - 1] = s4.z[COUNT - 1] = s4.w[COUNT - 1] = 0.0f;
+
+        vec3_soa_fast_normalize(&s3);
+        vec4_soa_fast_normalize(&s4);
+
+        for (size_t i = 0; i + 1 < COUNT; ++i) {
+                f32 a3[3] = { s3.x[i], s3.y[i], s3.z[i] };
+                f32 a4[4] = { s4.x[i], s4.y[i], s4.z[i], s4.w[i] };
+                CHECK_UNIT(magnitude3(a3), "vec3_soa_fast_normalize %zu: %.9g", i, magnitude3(a3));
+                CHECK_UNIT(magnitude4(a4), "vec4_soa_fast_normalize %zu: %.9g", i, magnitude4(a4));
+
+                // The direction is kept, every component within the error of the rsqrt.
+                f64 m = magnitude4(&v[i].x);
+                f64 tol = SMATH_FAST_RSQRT_ERROR + 2.0 * FLT_EPSILON;
+                TEST_CHECK(fabs(a4[1] - v[i].y / m) <= tol && fabs(a4[2] - v[i].z / m) <= tol &&
+                           fabs(a4[3] - v[i].w / m) <= tol, "vec4_soa_fast_normalize direction %zu", i);
+        }
+
+        TEST_CHECK(isnan(s3.x[COUNT - 1]) && isnan(s4.w[COUNT - 1]), "zero vectors of the SoA normalize");
+
+        vec3_soa_destroy(&s3);
+        vec4_soa_destroy(&s4);
+}
+
+int main(void) {
+        int skip = test_begin("fast_math");
+        if (skip)
+                return skip;
+
+        test_rsqrt();
+        test_rcp();
+        test_normalize();
+        test_soa_normalize();
+
+        return test_end();
+}
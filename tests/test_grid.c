@@ -0,0 +1,207 @@
+/*
+ * smath_grid queries against brute force over the points: vec3, vec3_soa
+ * and planar builds, points past the clamped outermost cells, radii that
+ * fall back to one range over all points and results cut off at max.
+ */
+
+#include "test.h"
+
+#define N 2000
+#define CELL 2.0f
+#define QUERIES 500
+
+static vec3 points[N];
+static vec2 points2[N];
+static f32 xs[N], ys[N];
+static u32 found[N], expected[N];
+
+static int compare_u32(const void *a, const void *b) {
+        u32 x = *(const u32*)a, y = *(const u32*)b;
+        return (x > y) - (x < y);
+}
+
+/** @brief The points within radius of p, with the same float arithmetic as the query, in index order. */
+static size_t brute_force(const vec3 *p, f32 radius, bool planar) {
+        f32 px = p->x, py = p->y, pz = planar ? 0.0f : p->z;
+        f32 r2 = radius * radius;
+        size_t n = 0;
+
+        for (u32 i = 0; i < N; ++i) {
+                f32 dx = points[i].x - px, dy = points[i].y - py, dz = (planar ? 0.0f : points[i].z) - pz;
+                if (dx * dx + dy * dy + dz * dz <= r2)
+                        expected[n++] = i;
+        }
+        return n;
+}
+
+/** @brief The ranges are non empty, cover distinct buckets and never overlap. */
+static bool ranges_valid(const smath_grid *g, const smath_grid_range *r, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                if (r[i].begin >= r[i].end || r[i].end > g->count)
+                        return false;
+                for (size_t j = 0; j < i; ++j) {
+                        if (r[i].begin < r[j].end && r[j].begin < r[i].end)
+                                return false;
+                }
+        }
+        return true;
+}
+
+/** @brief query_radius finds exactly the brute force points, then the first max of them. */
+static void check_query(const smath_grid *g, const vec3 *p, f32 radius, const char *name) {
+        size_t n = brute_force(p, radius, g->planar);
+        size_t k = smath_grid_query_radius(g, p, radius, found, N);
+
+        TEST_CHECK(k == n, "%s at (%g %g %g) radius %g: %zu points, expected %zu", name, p->x, p->y, p->z, radius, k, n);
+        if (k != n)
+                return;
+
+        qsort(found, k, sizeof(u32), compare_u32);
+        TEST_CHECK(memcmp(found, expected, n * sizeof(u32)) == 0, "%s at (%g %g %g) radius %g: other points", name, p->x, p->y,
+                   p->z, radius);
+
+        // Cut off at max the count stays, the stored indices are distinct hits.
+        size_t max = n / 3;
+        u32 sentinel = 0xDEADBEEF;
+        found[max] = sentinel;
+        TEST_CHECK(smath_grid_query_radius(g, p, radius, found, max) == n, "%s: count with max %zu", name, max);
+        TEST_CHECK(max == n || found[max] == sentinel, "%s: wrote past max %zu", name, max);
+
+        qsort(found, max, sizeof(u32), compare_u32);
+        bool subset = true;
+        for (size_t i = 0; i < max; ++i) {
+                subset = subset && bsearch(&found[i], expected, n, sizeof(u32), compare_u32) != NULL;
+                subset = subset && (i == 0 || found[i] != found[i - 1]);
+        }
+        TEST_CHECK(subset, "%s: the first %zu indices are not distinct hits", name, max);
+}
+
+static void random_queries(const smath_grid *g, const char *name) {
+        smath_grid_range ranges[SMATH_GRID_MAX_RANGES];
+
+        for (int q = 0; q < QUERIES; ++q) {
+                vec3 p;
+                f32 radius = test_uniform(0.0f, 2.5f * CELL);
+
+                // Half of them at a point, which is always found.
+                if (q & 1)
+                        p = points[test_rand() % N];
+                else
+                        test_fill(&p.x, 3, -25.0f, 25.0f);
+
+                check_query(g, &p, radius, name);
+
+                size_t n = smath_grid_query_ranges(g, &p, radius, ranges, SMATH_GRID_MAX_RANGES);
+                TEST_CHECK(n <= SMATH_GRID_MAX_RANGES && ranges_valid(g, ranges, n), "%s: ranges at query %d", name, q);
+        }
+}
+
+/** @brief Past the cell limit the points share the outermost cells and are still found. */
+static void test_clamped(smath_grid *g) {
+        static const f32 far[] = { 1e12f, -1e12f, INFINITY, -INFINITY, 3e9f, -3e9f };
+
+        test_fill(&points[0].x, 3 * N, -20.0f, 20.0f);
+        for (int i = 0; i < 60; ++i) {
+                points[i].x = far[i % 6];
+                points[i].y = i < 30 ? test_uniform(-3.0f, 3.0f) : far[(i + 1) % 6];
+        }
+        TEST_CHECK(smath_grid_build(g, points, N), "smath_grid_build clamped");
+
+        for (int i = 0; i < 60; ++i) {
+                vec3 p = points[i];
+                if (isinf(p.x) || isinf(p.y))
+                        continue;
+                check_query(g, &p, 0.0f, "clamped");
+                check_query(g, &p, 5.0f, "clamped");
+                check_query(g, &p, 1e10f, "clamped");
+        }
+
+        // A point beyond the limit with a small radius visits one clamped cell.
+        smath_grid_range ranges[SMATH_GRID_MAX_RANGES];
+        vec3 p = { 5e11f, 1.0f, 1.0f };
+        size_t n = smath_grid_query_ranges(g, &p, 0.5f, ranges, SMATH_GRID_MAX_RANGES);
+        TEST_CHECK(n <= 1 && ranges_valid(g, ranges, n), "clamped query visits %zu ranges", n);
+        check_query(g, &p, 0.5f, "clamped");
+}
+
+/** @brief More cells than max give one range over all points, the query stays exact. */
+static void test_fallback(const smath_grid *g) {
+        smath_grid_range ranges[SMATH_GRID_MAX_RANGES];
+        vec3 p = { 1.0f, -2.0f, 3.0f };
+
+        // 11 cells a side, far more than SMATH_GRID_MAX_RANGES.
+        size_t n = smath_grid_query_ranges(g, &p, 5.0f * CELL, ranges, SMATH_GRID_MAX_RANGES);
+        TEST_CHECK(n == 1 && ranges[0].begin == 0 && ranges[0].end == g->count, "fallback gives %zu ranges", n);
+        check_query(g, &p, 5.0f * CELL, "fallback");
+        check_query(g, &p, 100.0f, "fallback");
+
+        // With max 1 every query of more than one cell falls back.
+        n = smath_grid_query_ranges(g, &p, 0.5f * CELL, ranges, 1);
+        TEST_CHECK(n == 1 && ranges[0].begin == 0 && ranges[0].end == g->count, "fallback with max 1 gives %zu ranges", n);
+
+        // A negative radius is an empty box.
+        TEST_CHECK(smath_grid_query_ranges(g, &p, -1.0f, ranges, SMATH_GRID_MAX_RANGES) == 0, "negative radius");
+}
+
+int main(void) {
+        int skip = test_begin("grid");
+        if (skip)
+                return skip;
+
+        smath_grid g;
+        TEST_CHECK(smath_grid_create(&g, CELL, N), "smath_grid_create");
+        TEST_CHECK(g.buckets >= 2 * N && (g.buckets & (g.buckets - 1)) == 0, "%u buckets", g.buckets);
+
+        // The empty grid finds nothing.
+        vec3 origin = { 0.0f, 0.0f, 0.0f };
+        TEST_CHECK(smath_grid_query_radius(&g, &origin, 100.0f, found, N) == 0, "empty grid");
+
+        // vec3, clustered so some cells hold many points.
+        test_fill(&points[0].x, 3 * N, -20.0f, 20.0f);
+        for (int i = 0; i < N / 4; ++i)
+                test_fill(&points[i].x, 3, 0.0f, 1.5f * CELL);
+        TEST_CHECK(smath_grid_build(&g, points, N), "smath_grid_build");
+        TEST_CHECK(!g.planar && g.count == N && g.start[g.buckets] == N, "build count");
+        random_queries(&g, "vec3");
+        test_fallback(&g);
+
+        // The same points as a vec3_soa, the same queries.
+        vec3_soa soa;
+        TEST_CHECK(vec3_soa_create(&soa, N), "vec3_soa_create");
+        for (int i = 0; i < N; ++i) {
+                soa.x[i] = points[i].x;
+                soa.y[i] = points[i].y;
+                soa.z[i] = points[i].z;
+        }
+        soa.count = N;
+        TEST_CHECK(smath_grid_build_soa(&g, &soa), "smath_grid_build_soa");
+        random_queries(&g, "vec3_soa");
+        vec3_soa_destroy(&soa);
+
+        // Planar, the z of the query point is ignored.
+        for (int i = 0; i < N; ++i) {
+                points2[i] = (vec2){ points[i].x, points[i].y };
+                xs[i] = points[i].x;
+                ys[i] = points[i].y;
+        }
+        TEST_CHECK(smath_grid_build_vec2(&g, points2, N) && g.planar, "smath_grid_build_vec2");
+        random_queries(&g, "vec2");
+        test_fallback(&g);
+        TEST_CHECK(smath_grid_build_xy(&g, xs, ys, N) && g.planar, "smath_grid_build_xy");
+        random_queries(&g, "xy");
+
+        // 7 x 7 cells in the plane do not fall back, 7 x 7 x 7 would.
+        smath_grid_range ranges[SMATH_GRID_MAX_RANGES];
+        vec3 p = { 0.5f, 0.5f, 1000.0f };
+        size_t n = smath_grid_query_ranges(&g, &p, 3.0f * CELL, ranges, SMATH_GRID_MAX_RANGES);
+        TEST_CHECK(n > 1 && ranges_valid(&g, ranges, n), "planar query gives %zu ranges", n);
+
+        test_clamped(&g);
+
+        // Over the capacity the build fails and leaves the grid empty.
+        TEST_CHECK(!smath_grid_build(&g, points, N + 1), "build over capacity");
+        TEST_CHECK(g.count == 0 && smath_grid_query_radius(&g, &origin, 100.0f, found, N) == 0, "empty after a failed build");
+
+        smath_grid_destroy(&g);
+        return test_end();
+}
@@ -0,0 +1,177 @@
+/*
+ * smath_hierarchy_update against a full recompute of world = parent *
+ * local, on a tree whose children are added out of depth first order,
+ * with a few nodes changed per round. The nodes outside the changed
+ * subtrees must not be written.
+ */
+
+#include "test.h"
+
+#define NODES 300
+#define ROUNDS 40
+
+static mat4x4 ref[NODES + 64];
+
+static quat random_quat(void) {
+        quat q;
+        f32 len;
+
+        do {
+                test_fill(&q.x, 4, -1.0f, 1.0f);
+                len = sqrtf(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+        } while (len < 0.1f);
+
+        return (quat){ q.x / len, q.y / len, q.z / len, q.w / len };
+}
+
+static vec3 random_scale(void) {
+        vec3 s;
+        test_fill(&s.x, 3, 0.5f, 2.0f);
+        return s;
+}
+
+/** @brief A node under a random earlier one, every 16th a new root. */
+static i32 add_random(smath_hierarchy *h) {
+        i32 parent = h->count == 0 || test_rand() % 16 == 0 ? SMATH_HIERARCHY_ROOT : (i32)(test_rand() % h->count);
+        vec3 position, scale = random_scale();
+        quat rotation = random_quat();
+
+        test_fill(&position.x, 3, -5.0f, 5.0f);
+        return smath_hierarchy_add(h, parent, &position, &rotation, &scale);
+}
+
+/** @brief Every world matrix from scratch in index order with the same kernel as the update. */
+static void recompute(const smath_hierarchy *h) {
+        mat4x4 (*mult)(const mat4x4 *m0, const mat4x4 *m1) = smath_get_kernels()->mat4x4_mult;
+
+        for (size_t i = 0; i < h->count; ++i) {
+                i32 p = h->parent[i];
+                mat4x4 local = mat4x4_from_trs(&h->position[i], &h->rotation[i], &h->scale[i]);
+                ref[i] = p < 0 ? local : mult(&ref[p], &local);
+        }
+}
+
+/** @brief i is in the subtree of a changed node, itself included. */
+static bool affected(const smath_hierarchy *h, const bool *changed, size_t i) {
+        for (i32 p = (i32)i; p >= 0; p = h->parent[p])
+                if (changed[p])
+                        return true;
+        return false;
+}
+
+/** @brief The subtree_end of every node is its highest descendant. */
+static void test_subtree_end(const smath_hierarchy *h) {
+        for (size_t i = 0; i < h->count; ++i) {
+                i32 end = (i32)i;
+                for (size_t j = i + 1; j < h->count; ++j) {
+                        i32 p = h->parent[j];
+                        while (p > (i32)i)
+                                p = h->parent[p];
+                        if (p == (i32)i)
+                                end = (i32)j;
+                }
+                TEST_CHECK(h->subtree_end[i] == end, "subtree_end of %zu is %d, expected %d", i, h->subtree_end[i], end);
+        }
+}
+
+int main(void) {
+        int skip = test_begin("hierarchy");
+        if (skip)
+                return skip;
+
+        smath_hierarchy h;
+
+        // A small capacity so adding grows the arrays a few times.
+        TEST_CHECK(smath_hierarchy_create(&h, 10), "smath_hierarchy_create");
+
+        for (int i = 0; i < NODES; ++i)
+                TEST_CHECK(add_random(&h) == i, "smath_hierarchy_add %d", i);
+
+        // Random parents put the children of a node far apart, not depth first.
+        size_t interleaved = 0;
+        for (size_t i = 1; i < h.count; ++i)
+                interleaved += h.parent[i] >= 0 && (size_t)h.subtree_end[h.parent[i]] > i && h.parent[i] != (i32)i - 1;
+        TEST_CHECK(interleaved > 0, "the tree is depth first");
+
+        test_subtree_end(&h);
+
+        smath_hierarchy_update(&h);
+        recompute(&h);
+        TEST_CHECK(memcmp(h.world, ref, h.count * sizeof(mat4x4)) == 0, "first update");
+        TEST_CHECK(h.first_dirty == h.count, "first_dirty %zu after the update", h.first_dirty);
+
+        // An update without changes writes nothing.
+        mat4x4 poison;
+        memset(&poison, 0xff, sizeof(poison));
+        for (size_t i = 0; i < h.count; ++i)
+                h.world[i] = poison;
+        smath_hierarchy_update(&h);
+        bool untouched = true;
+        for (size_t i = 0; i < h.count; ++i)
+                untouched = untouched && memcmp(&h.world[i], &poison, sizeof(mat4x4)) == 0;
+        TEST_CHECK(untouched, "update without changes wrote a node");
+        memcpy(h.world, ref, h.count * sizeof(mat4x4));
+
+        static bool changed[NODES + 64];
+
+        for (int round = 0; round < ROUNDS; ++round) {
+                memset(changed, 0, sizeof(changed));
+
+                // 1 to 4 changed nodes, each with some of its fields.
+                int k = 1 + (int)(test_rand() % 4);
+                for (int j = 0; j < k; ++j) {
+                        i32 node = (i32)(test_rand() % h.count);
+                        u32 fields = 1 + test_rand() % 7;
+                        vec3 position, scale = random_scale();
+                        quat rotation = random_quat();
+
+                        test_fill(&position.x, 3, -5.0f, 5.0f);
+                        smath_hierarchy_set_local(&h, node, fields & 1 ? &position : NULL, fields & 2 ? &rotation : NULL,
+                                                  fields & 4 ? &scale : NULL);
+                        changed[node] = true;
+                }
+
+                // Every 8th round new nodes under random parents, they are flagged too.
+                if (round % 8 == 7 && h.count + 2 <= NODES + 64) {
+                        for (int j = 0; j < 2; ++j) {
+                                i32 node = add_random(&h);
+                                TEST_CHECK(node >= 0, "smath_hierarchy_add in round %d", round);
+                                if (node >= 0)
+                                        changed[node] = true;
+                        }
+                }
+
+                recompute(&h);
+
+                // Poison the clean nodes, except the parents of changed nodes the update reads.
+                static bool read[NODES + 64];
+                memset(read, 0, sizeof(read));
+                for (size_t i = 0; i < h.count; ++i)
+                        if (changed[i] && h.parent[i] >= 0)
+                                read[h.parent[i]] = true;
+
+                for (size_t i = 0; i < h.count; ++i)
+                        if (!affected(&h, changed, i) && !read[i])
+                                h.world[i] = poison;
+
+                smath_hierarchy_update(&h);
+
+                for (size_t i = 0; i < h.count; ++i) {
+                        if (affected(&h, changed, i)) {
+                                TEST_CHECK(memcmp(&h.world[i], &ref[i], sizeof(mat4x4)) == 0, "round %d: node %zu differs", round, i);
+                        } else if (!read[i]) {
+                                TEST_CHECK(memcmp(&h.world[i], &poison, sizeof(mat4x4)) == 0, "round %d: clean node %zu written",
+                                           round, i);
+                                h.world[i] = ref[i];
+                        } else {
+                                TEST_CHECK(memcmp(&h.world[i], &ref[i], sizeof(mat4x4)) == 0, "round %d: parent %zu differs", round, i);
+                        }
+                        TEST_CHECK(h.dirty[i] == 0, "round %d: node %zu still flagged", round, i);
+                }
+                TEST_CHECK(h.first_dirty == h.count, "round %d: first_dirty %zu", round, h.first_dirty);
+        }
+
+        test_subtree_end(&h);
+        smath_hierarchy_destroy(&h);
+        return test_end();
+}
@@ -0,0 +1,165 @@
+/*
+ * mat4x4_inverse, _inverse_det, _inverse_affine, _inverse_rigid and
+ * mat4x4_determinant against references, and their _sse_ versions
+ * against the portable ones.
+ */
+
+#include "test.h"
+
+#define N 1000
+#define TOL 1e-5f
+#define INV_TOL 2e-4f
+
+static const mat4x4 identity = {{
+        { 1.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 1.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 1.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 1.0f } }};
+
+static bool mat_close(const mat4x4 *a, const mat4x4 *b, f32 tol) {
+        return test_close_n(&a->t[0][0], &b->t[0][0], 16, tol);
+}
+
+/** @brief m * inv and inv * m are the identity. */
+static bool is_inverse(const mat4x4 *m, const mat4x4 *inv) {
+        mat4x4 a = mat4x4_mult(m, inv), b = mat4x4_mult(inv, m);
+        return mat_close(&a, &identity, INV_TOL) && mat_close(&b, &identity, INV_TOL);
+}
+
+/** @brief The determinant in double precision, Laplace expansion along the first row. */
+static f64 ref_det3(f64 a[3][3]) {
+        return a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1])
+             - a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0])
+             + a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+}
+
+static f64 ref_det(const mat4x4 *m) {
+        f64 d = 0.0;
+
+        for (int c = 0; c < 4; ++c) {
+                f64 minor[3][3];
+                for (int i = 1; i < 4; ++i) {
+                        for (int j = 0, k = 0; j < 4; ++j) {
+                                if (j != c)
+                                        minor[i - 1][k++] = m->t[i][j];
+                        }
+                }
+                d += (c & 1 ? -1.0 : 1.0) * m->t[0][c] * ref_det3(minor);
+        }
+
+        return d;
+}
+
+/** @brief A random matrix with a dominant diagonal, far from singular. */
+static mat4x4 random_matrix(void) {
+        mat4x4 m;
+        test_fill(&m.t[0][0], 16, -1.0f, 1.0f);
+        for (int i = 0; i < 4; ++i)
+                m.t[i][i] += test_uniform(0.0f, 1.0f) < 0.5f ? -3.0f : 3.0f;
+        return m;
+}
+
+/** @brief A rotation from three angles, then a translation. */
+static mat4x4 random_rigid(void) {
+        f32 a = test_uniform(-3.14f, 3.14f), b = test_uniform(-3.14f, 3.14f), c = test_uniform(-3.14f, 3.14f);
+        f32 ca = cosf(a), sa = sinf(a), cb = cosf(b), sb = sinf(b), cc = cosf(c), sc = sinf(c);
+        mat4x4 m = {{
+                { cb * cc, -cb * sc, sb, 0.0f },
+                { sa * sb * cc + ca * sc, -sa * sb * sc + ca * cc, -sa * cb, 0.0f },
+                { -ca * sb * cc + sa * sc, ca * sb * sc + sa * cc, ca * cb, 0.0f },
+                { 0.0f, 0.0f, 0.0f, 1.0f } }};
+
+        for (int i = 0; i < 3; ++i)
+                m.t[i][3] = test_uniform(-100.0f, 100.0f);
+
+        return m;
+}
+
+/** @brief A rigid transform with a random scale and shear in the 3x3 part. */
+static mat4x4 random_affine(void) {
+        mat4x4 m = random_rigid();
+
+        for (int i = 0; i < 3; ++i) {
+                for (int j = 0; j < 3; ++j)
+                        m.t[i][j] = m.t[i][j] * test_uniform(0.5f, 2.0f) + test_uniform(-0.2f, 0.2f);
+        }
+
+        return m;
+}
+
+int main(void) {
+        int skip = test_begin("inverse");
+        if (skip)
+                return skip;
+
+        for (int i = 0; i < N; ++i) {
+                mat4x4 m = random_matrix();
+                f32 det;
+                mat4x4 inv = mat4x4_inverse(&m), inv_det = mat4x4_inverse_det(&m, &det);
+                f64 ref = ref_det(&m);
+
+                TEST_CHECK(is_inverse(&m, &inv), "mat4x4_inverse %d", i);
+                TEST_CHECK(memcmp(&inv, &inv_det, sizeof(inv)) == 0, "mat4x4_inverse_det %d", i);
+                TEST_CHECK(fabs(det - ref) <= 1e-5 * fabs(ref), "mat4x4_inverse_det %d: %g %g", i, det, ref);
+                TEST_CHECK(fabs(mat4x4_determinant(&m) - ref) <= 1e-5 * fabs(ref), "mat4x4_determinant %d", i);
+
+                mat4x4 a = random_affine(), r = random_rigid();
+                mat4x4 ia = mat4x4_inverse_affine(&a), ir = mat4x4_inverse_rigid(&r);
+                mat4x4 ga = mat4x4_inverse(&a), gr = mat4x4_inverse(&r);
+
+                TEST_CHECK(is_inverse(&a, &ia), "mat4x4_inverse_affine %d", i);
+                TEST_CHECK(is_inverse(&r, &ir), "mat4x4_inverse_rigid %d", i);
+                TEST_CHECK(mat_close(&ia, &ga, INV_TOL), "mat4x4_inverse_affine against mat4x4_inverse %d", i);
+                TEST_CHECK(mat_close(&ir, &gr, INV_TOL), "mat4x4_inverse_rigid against mat4x4_inverse %d", i);
+                TEST_CHECK(ia.t[3][0] == 0.0f && ia.t[3][1] == 0.0f && ia.t[3][2] == 0.0f && ia.t[3][3] == 1.0f,
+                           "mat4x4_inverse_affine last row %d", i);
+
+                // The rotation of the rigid inverse is the transposed rotation.
+                bool transposed = true;
+                for (int j = 0; j < 3; ++j) {
+                        for (int k = 0; k < 3; ++k)
+                                transposed &= ir.t[j][k] == r.t[k][j];
+                }
+                TEST_CHECK(transposed, "mat4x4_inverse_rigid rotation %d", i);
+
+#ifdef SMATH_SSE
+                f32 sdet;
+                mat4x4 sinv = mat4x4_sse_inverse(&m), sinv_det = mat4x4_sse_inverse_det(&m, &sdet);
+                TEST_CHECK(mat_close(&sinv, &inv, TOL), "mat4x4_sse_inverse %d", i);
+                TEST_CHECK(memcmp(&sinv, &sinv_det, sizeof(sinv)) == 0, "mat4x4_sse_inverse_det %d", i);
+                TEST_CHECK(fabs(sdet - ref) <= 1e-5 * fabs(ref), "mat4x4_sse_inverse_det %d: %g %g", i, sdet, ref);
+
+                mat4x4 sia = mat4x4_sse_inverse_affine(&a), sir = mat4x4_sse_inverse_rigid(&r);
+                TEST_CHECK(mat_close(&sia, &ia, TOL), "mat4x4_sse_inverse_affine %d", i);
+                TEST_CHECK(mat_close(&sir, &ir, TOL), "mat4x4_sse_inverse_rigid %d", i);
+
+                // The fast paths do the same operations as the portable ones, the signs of the zeros included.
+                TEST_CHECK(memcmp(&sia, &ia, sizeof(sia)) == 0, "mat4x4_sse_inverse_affine is not mat4x4_inverse_affine %d", i);
+                TEST_CHECK(memcmp(&sir, &ir, sizeof(sir)) == 0, "mat4x4_sse_inverse_rigid is not mat4x4_inverse_rigid %d", i);
+                a.t[0][3] = a.t[1][3] = a.t[2][3] = 0.0f;
+                sia = mat4x4_sse_inverse_affine(&a);
+                ia = mat4x4_inverse_affine(&a);
+                TEST_CHECK(memcmp(&sia, &ia, sizeof(sia)) == 0, "mat4x4_sse_inverse_affine without translation %d", i);
+#endif
+        }
+
+        // Two equal rows, the 2x2 determinants of the top rows are exactly 0.
+        mat4x4 singular = random_matrix();
+        memcpy(singular.t[1], singular.t[0], sizeof(singular.t[0]));
+        f32 det = 1.0f;
+        mat4x4_inverse_det(&singular, &det);
+        TEST_CHECK(det == 0.0f, "mat4x4_inverse_det of a singular matrix: %g", det);
+        TEST_CHECK(mat4x4_determinant(&singular) == 0.0f, "mat4x4_determinant of a singular matrix");
+#ifdef SMATH_SSE
+        det = 1.0f;
+        mat4x4_sse_inverse_det(&singular, &det);
+        TEST_CHECK(det == 0.0f, "mat4x4_sse_inverse_det of a singular matrix: %g", det);
+#endif
+
+        mat4x4 id = mat4x4_inverse(&identity), id_affine = mat4x4_inverse_affine(&identity), id_rigid = mat4x4_inverse_rigid(&identity);
+        TEST_CHECK(mat_close(&id, &identity, 0.0f), "mat4x4_inverse of the identity");
+        TEST_CHECK(mat_close(&id_affine, &identity, 0.0f), "mat4x4_inverse_affine of the identity");
+        TEST_CHECK(mat_close(&id_rigid, &identity, 0.0f), "mat4x4_inverse_rigid of the identity");
+
+        return test_end();
+}
@@ -0,0 +1,313 @@
+/*
+ * The mat2x2 ... mat4x3 family: products, transposes and inverses against
+ * plain row times column references and the identities between them, and
+ * the _sse_ versions against the portable ones.
+ *
+ * A matCxR has R rows t[r] of C columns, so matCxR times a vecC is a vecR
+ * and a matCxR times a matRxC is an RxR matrix.
+ */
+
+#include "test.h"
+
+#define N 500
+#define TOL 1e-5f
+#define INV_TOL 1e-4f
+
+/** @brief Any matrix of the family as rows of floats, a[r][c]. */
+typedef struct ref_mat {
+        int rows, cols;
+        f32 a[4][4];
+} ref_mat;
+
+/** @brief Copy the R rows of C floats of a matrix of the family, every row is a vecC. */
+#define REF_LOAD(m, R, C) ref_load((const f32*)&(m).t[0], sizeof((m).t[0]), R, C)
+
+static ref_mat ref_load(const f32 *rows, size_t stride, int r, int c) {
+        ref_mat m = { r, c, {{0}} };
+
+        for (int i = 0; i < r; ++i)
+                memcpy(m.a[i], (const u8*)rows + i * stride, c * sizeof(f32));
+
+        return m;
+}
+
+static ref_mat ref_mult(const ref_mat *a, const ref_mat *b) {
+        ref_mat m = { a->rows, b->cols, {{0}} };
+
+        for (int i = 0; i < a->rows; ++i) {
+                for (int j = 0; j < b->cols; ++j) {
+                        f32 s = 0.0f;
+                        for (int k = 0; k < a->cols; ++k)
+                                s += a->a[i][k] * b->a[k][j];
+                        m.a[i][j] = s;
+                }
+        }
+
+        return m;
+}
+
+static ref_mat ref_transpose(const ref_mat *a) {
+        ref_mat m = { a->cols, a->rows, {{0}} };
+
+        for (int i = 0; i < a->rows; ++i) {
+                for (int j = 0; j < a->cols; ++j)
+                        m.a[j][i] = a->a[i][j];
+        }
+
+        return m;
+}
+
+static ref_mat ref_identity(int n) {
+        ref_mat m = { n, n, {{0}} };
+
+        for (int i = 0; i < n; ++i)
+                m.a[i][i] = 1.0f;
+
+        return m;
+}
+
+static bool ref_close(const ref_mat *a, const ref_mat *b, f32 tol) {
+        if (a->rows != b->rows || a->cols != b->cols)
+                return false;
+
+        for (int i = 0; i < a->rows; ++i) {
+                if (!test_close_n(a->a[i], b->a[i], a->cols, tol))
+                        return false;
+        }
+
+        return true;
+}
+
+/** @brief Fill the rows of a matrix of the family, square ones get a dominant diagonal so they invert well. */
+#define FILL(m, R, C) do { \
+        for (int r_ = 0; r_ < (R); ++r_) { \
+                test_fill((f32*)&(m).t[r_], (C), -2.0f, 2.0f); \
+                if (r_ < (C)) \
+                        ((f32*)&(m).t[r_])[r_] += 4.0f; \
+        } \
+} while (0)
+
+static bool ref_close_load(const f32 *rows, size_t stride, int r, int c, const ref_mat *ref, f32 tol) {
+        ref_mat m = ref_load(rows, stride, r, c);
+        return ref_close(&m, ref, tol);
+}
+
+/** @brief A matrix of the family equals a reference. */
+#define MAT_CLOSE(m, R, C, ref, tol) ref_close_load((const f32*)&(m).t[0], sizeof((m).t[0]), R, C, ref, tol)
+
+
+/** @brief A matrix times a vector equals the reference product with the vector as a column. */
+static bool vec_close(const f32 *v, const ref_mat *m, const f32 *x, f32 tol) {
+        for (int i = 0; i < m->rows; ++i) {
+                f32 s = 0.0f;
+                for (int k = 0; k < m->cols; ++k)
+                        s += m->a[i][k] * x[k];
+                if (!test_close(v[i], s, tol))
+                        return false;
+        }
+        return true;
+}
+
+
+static void test_square(void) {
+        for (int i = 0; i < N; ++i) {
+                mat2x2 a2, b2;
+                mat3x3 a3, b3;
+                FILL(a2, 2, 2);
+                FILL(b2, 2, 2);
+                FILL(a3, 3, 3);
+                FILL(b3, 3, 3);
+
+                ref_mat ra2 = REF_LOAD(a2, 2, 2), rb2 = REF_LOAD(b2, 2, 2);
+                ref_mat ra3 = REF_LOAD(a3, 3, 3), rb3 = REF_LOAD(b3, 3, 3);
+                ref_mat p2 = ref_mult(&ra2, &rb2), p3 = ref_mult(&ra3, &rb3);
+                ref_mat i2 = ref_identity(2), i3 = ref_identity(3);
+
+                mat2x2 m2 = mat2x2_mult(&a2, &b2);
+                mat3x3 m3 = mat3x3_mult(&a3, &b3);
+                TEST_CHECK(MAT_CLOSE(m2, 2, 2, &p2, TOL), "mat2x2_mult %d", i);
+                TEST_CHECK(MAT_CLOSE(m3, 3, 3, &p3, TOL), "mat3x3_mult %d", i);
+
+                // (AB)^T = B^T A^T
+                mat2x2 ta2 = mat2x2_transpose(&a2), tb2 = mat2x2_transpose(&b2);
+                mat3x3 ta3 = mat3x3_transpose(&a3), tb3 = mat3x3_transpose(&b3);
+                mat2x2 t2 = mat2x2_transpose(&m2), bt_at2 = mat2x2_mult(&tb2, &ta2);
+                mat3x3 t3 = mat3x3_transpose(&m3), bt_at3 = mat3x3_mult(&tb3, &ta3);
+                ref_mat rt2 = REF_LOAD(t2, 2, 2), rt3 = REF_LOAD(t3, 3, 3);
+                TEST_CHECK(MAT_CLOSE(bt_at2, 2, 2, &rt2, TOL), "mat2x2 (AB)^T = B^T A^T %d", i);
+                TEST_CHECK(MAT_CLOSE(bt_at3, 3, 3, &rt3, TOL), "mat3x3 (AB)^T = B^T A^T %d", i);
+
+                mat2x2 tt2 = mat2x2_transpose(&ta2);
+                mat3x3 tt3 = mat3x3_transpose(&ta3);
+                TEST_CHECK(memcmp(&tt2, &a2, sizeof(a2)) == 0, "mat2x2 transpose twice %d", i);
+                TEST_CHECK(memcmp(&tt3, &a3, sizeof(a3)) == 0, "mat3x3 transpose twice %d", i);
+
+                // det(AB) = det(A) det(B), det(A^T) = det(A)
+                f32 d2 = mat2x2_determinant(&a2), d3 = mat3x3_determinant(&a3);
+                TEST_CHECK(test_close(mat2x2_determinant(&m2), d2 * mat2x2_determinant(&b2), INV_TOL), "mat2x2 det(AB) %d", i);
+                TEST_CHECK(test_close(mat3x3_determinant(&m3), d3 * mat3x3_determinant(&b3), INV_TOL), "mat3x3 det(AB) %d", i);
+                TEST_CHECK(test_close(mat3x3_determinant(&ta3), d3, TOL), "mat3x3 det(A^T) %d", i);
+
+                // A inv(A) = inv(A) A = I
+                mat2x2 inv2 = mat2x2_inverse(&a2);
+                mat3x3 inv3 = mat3x3_inverse(&a3);
+                mat2x2 ai2 = mat2x2_mult(&a2, &inv2), ia2 = mat2x2_mult(&inv2, &a2);
+                mat3x3 ai3 = mat3x3_mult(&a3, &inv3), ia3 = mat3x3_mult(&inv3, &a3);
+                TEST_CHECK(MAT_CLOSE(ai2, 2, 2, &i2, INV_TOL) && MAT_CLOSE(ia2, 2, 2, &i2, INV_TOL), "mat2x2_inverse %d", i);
+                TEST_CHECK(MAT_CLOSE(ai3, 3, 3, &i3, INV_TOL) && MAT_CLOSE(ia3, 3, 3, &i3, INV_TOL), "mat3x3_inverse %d", i);
+                TEST_CHECK(test_close(mat3x3_determinant(&inv3) * d3, 1.0f, INV_TOL), "mat3x3 det(inv(A)) %d", i);
+
+                vec2 x2;
+                vec3 x3;
+                test_fill(&x2.x, 2, -10.0f, 10.0f);
+                test_fill(&x3.x, 3, -10.0f, 10.0f);
+                vec2 y2 = mat2x2_vec2_mult(&a2, &x2);
+                vec3 y3 = mat3x3_vec3_mult(&a3, &x3);
+                TEST_CHECK(vec_close(&y2.x, &ra2, &x2.x, TOL), "mat2x2_vec2_mult %d", i);
+                TEST_CHECK(vec_close(&y3.x, &ra3, &x3.x, TOL), "mat3x3_vec3_mult %d", i);
+
+#ifdef SMATH_SSE
+                mat2x2 s2 = mat2x2_sse_mult(&a2, &b2);
+                mat3x3 s3 = mat3x3_sse_mult(&a3, &b3);
+                TEST_CHECK(MAT_CLOSE(s2, 2, 2, &p2, TOL), "mat2x2_sse_mult %d", i);
+                TEST_CHECK(MAT_CLOSE(s3, 3, 3, &p3, TOL), "mat3x3_sse_mult %d", i);
+
+                ref_mat rinv2 = REF_LOAD(inv2, 2, 2), rinv3 = REF_LOAD(inv3, 3, 3);
+                mat2x2 si2 = mat2x2_sse_inverse(&a2);
+                mat3x3 si3 = mat3x3_sse_inverse(&a3);
+                TEST_CHECK(MAT_CLOSE(si2, 2, 2, &rinv2, TOL), "mat2x2_sse_inverse %d", i);
+                TEST_CHECK(MAT_CLOSE(si3, 3, 3, &rinv3, TOL), "mat3x3_sse_inverse %d", i);
+                TEST_CHECK(memcmp(&si2, &inv2, sizeof(si2)) == 0, "mat2x2_sse_inverse is not mat2x2_inverse %d", i);
+                TEST_CHECK(memcmp(&si3, &inv3, sizeof(si3)) == 0, "mat3x3_sse_inverse is not mat3x3_inverse %d", i);
+
+                vec3 sy3 = mat3x3_sse_vec3_mult(&a3, &x3);
+                TEST_CHECK(test_close_n(&sy3.x, &y3.x, 3, TOL), "mat3x3_sse_vec3_mult %d", i);
+#endif
+        }
+}
+
+/** @brief matCxR times matRxC and the transposes of both, for one pair of the rectangular types. */
+#define TEST_RECT(A, B, P, VA, VR, R, C) do { \
+        A a; \
+        B b; \
+        VA x; \
+        FILL(a, R, C); \
+        FILL(b, C, R); \
+        test_fill(&x.x, C, -10.0f, 10.0f); \
+        ref_mat ra = REF_LOAD(a, R, C), rb = REF_LOAD(b, C, R); \
+        ref_mat rp = ref_mult(&ra, &rb), rta = ref_transpose(&ra); \
+        P p = A##_mult(&a, &b); \
+        TEST_CHECK(MAT_CLOSE(p, R, R, &rp, TOL), #A "_mult %d", i); \
+        B ta = A##_transpose(&a); \
+        TEST_CHECK(MAT_CLOSE(ta, C, R, &rta, 0.0f), #A "_transpose %d", i); \
+        A tta = B##_transpose(&ta); \
+        TEST_CHECK(memcmp(&tta, &a, sizeof(a)) == 0, #A " transpose twice %d", i); \
+        A tb = B##_transpose(&b); \
+        P q = A##_mult(&tb, &ta); \
+        ref_mat rq = ref_transpose(&rp); \
+        TEST_CHECK(MAT_CLOSE(q, R, R, &rq, TOL), #A " (AB)^T = B^T A^T %d", i); \
+        VR y = A##_##VA##_mult(&a, &x); \
+        TEST_CHECK(vec_close(&y.x, &ra, &x.x, TOL), #A "_" #VA "_mult %d", i); \
+} while (0)
+
+static void test_rect(void) {
+        for (int i = 0; i < N; ++i) {
+                TEST_RECT(mat2x3, mat3x2, mat3x3, vec2, vec3, 3, 2);
+                TEST_RECT(mat3x2, mat2x3, mat2x2, vec3, vec2, 2, 3);
+                TEST_RECT(mat2x4, mat4x2, mat4x4, vec2, vec4, 4, 2);
+                TEST_RECT(mat4x2, mat2x4, mat2x2, vec4, vec2, 2, 4);
+                TEST_RECT(mat3x4, mat4x3, mat4x4, vec3, vec4, 4, 3);
+                TEST_RECT(mat4x3, mat3x4, mat3x3, vec4, vec3, 3, 4);
+        }
+}
+
+static void test_affine(void) {
+        for (int i = 0; i < N; ++i) {
+                mat4x3 a, b;
+                FILL(a, 3, 4);
+                FILL(b, 3, 4);
+
+                mat4x4 a4 = mat4x3_to_mat4x4(&a), b4 = mat4x3_to_mat4x4(&b);
+                mat4x3 back = mat4x3_from_mat4x4(&a4);
+                TEST_CHECK(memcmp(&back, &a, sizeof(a)) == 0, "mat4x3 to and from mat4x4 %d", i);
+                TEST_CHECK(a4.t[3][0] == 0.0f && a4.t[3][1] == 0.0f && a4.t[3][2] == 0.0f && a4.t[3][3] == 1.0f,
+                           "mat4x3_to_mat4x4 last row %d", i);
+
+                // The affine product is the 4x4 product without the last row.
+                mat4x4 p4 = mat4x4_mult(&a4, &b4);
+                mat4x3 p = mat4x3_mult_affine(&a, &b);
+                ref_mat rp = REF_LOAD(p4, 3, 4);
+                TEST_CHECK(MAT_CLOSE(p, 3, 4, &rp, TOL), "mat4x3_mult_affine %d", i);
+
+                vec3 pt;
+                test_fill(&pt.x, 3, -10.0f, 10.0f);
+                vec4 pw = { pt.x, pt.y, pt.z, 1.0f }, dw = { pt.x, pt.y, pt.z, 0.0f };
+                vec4 tp = mat4x4_vec4_mult(&a4, &pw), td = mat4x4_vec4_mult(&a4, &dw);
+                vec3 q = mat4x3_transform_point(&a, &pt), d = mat4x3_transform_direction(&a, &pt);
+                TEST_CHECK(test_close_n(&q.x, &tp.x, 3, TOL), "mat4x3_transform_point %d", i);
+                TEST_CHECK(test_close_n(&d.x, &td.x, 3, TOL), "mat4x3_transform_direction %d", i);
+
+                f32 det = mat4x3_determinant(&a);
+                TEST_CHECK(test_close(det, mat4x4_determinant(&a4), INV_TOL), "mat4x3_determinant %d", i);
+
+                // M inv(M) = I as affine matrices.
+                mat4x3 inv = mat4x3_inverse_affine(&a);
+                mat4x3 id = mat4x3_mult_affine(&a, &inv);
+                mat4x4 id4 = mat4x3_to_mat4x4(&id);
+                ref_mat ri = ref_identity(4);
+                TEST_CHECK(MAT_CLOSE(id4, 4, 4, &ri, INV_TOL), "mat4x3_inverse_affine %d", i);
+
+                // mat3x4 is the transposed layout of the same transforms.
+                mat3x4 ta = mat4x3_transpose(&a), tb = mat4x3_transpose(&b);
+                mat3x4 tp34 = mat3x4_mult_affine(&ta, &tb);
+                mat4x3 tp43 = mat3x4_transpose(&tp34);
+                TEST_CHECK(MAT_CLOSE(tp43, 3, 4, &rp, TOL), "mat3x4_mult_affine %d", i);
+
+                vec3 q34 = mat3x4_transform_point(&ta, &pt), d34 = mat3x4_transform_direction(&ta, &pt);
+                TEST_CHECK(test_close_n(&q34.x, &q.x, 3, TOL), "mat3x4_transform_point %d", i);
+                TEST_CHECK(test_close_n(&d34.x, &d.x, 3, TOL), "mat3x4_transform_direction %d", i);
+                TEST_CHECK(test_close(mat3x4_determinant(&ta), det, INV_TOL), "mat3x4_determinant %d", i);
+
+                mat3x4 tinv = mat3x4_inverse_affine(&ta);
+                mat4x3 tinv43 = mat3x4_transpose(&tinv);
+                ref_mat rinv = REF_LOAD(inv, 3, 4);
+                TEST_CHECK(MAT_CLOSE(tinv43, 3, 4, &rinv, INV_TOL), "mat3x4_inverse_affine %d", i);
+
+#ifdef SMATH_SSE
+                mat4x3 sp = mat4x3_sse_mult_affine(&a, &b);
+                TEST_CHECK(MAT_CLOSE(sp, 3, 4, &rp, TOL), "mat4x3_sse_mult_affine %d", i);
+
+                vec3 sq = mat4x3_sse_transform_point(&a, &pt), sv = mat4x3_sse_vec4_mult(&a, &pw);
+                TEST_CHECK(test_close_n(&sq.x, &q.x, 3, TOL), "mat4x3_sse_transform_point %d", i);
+                TEST_CHECK(test_close_n(&sv.x, &q.x, 3, TOL), "mat4x3_sse_vec4_mult %d", i);
+
+                mat4x3 sinv = mat4x3_sse_inverse_affine(&a);
+                TEST_CHECK(MAT_CLOSE(sinv, 3, 4, &rinv, INV_TOL), "mat4x3_sse_inverse_affine %d", i);
+                TEST_CHECK(memcmp(&sinv, &inv, sizeof(sinv)) == 0, "mat4x3_sse_inverse_affine is not mat4x3_inverse_affine %d", i);
+
+                mat3x4 stp = mat3x4_sse_mult_affine(&ta, &tb);
+                mat4x3 stp43 = mat3x4_transpose(&stp);
+                TEST_CHECK(MAT_CLOSE(stp43, 3, 4, &rp, TOL), "mat3x4_sse_mult_affine %d", i);
+
+                vec3 sq34 = mat3x4_sse_transform_point(&ta, &pt);
+                TEST_CHECK(test_close_n(&sq34.x, &q.x, 3, TOL), "mat3x4_sse_transform_point %d", i);
+
+                mat3x4 stinv = mat3x4_sse_inverse_affine(&ta);
+                mat4x3 stinv43 = mat3x4_transpose(&stinv);
+                TEST_CHECK(MAT_CLOSE(stinv43, 3, 4, &rinv, INV_TOL), "mat3x4_sse_inverse_affine %d", i);
+                TEST_CHECK(memcmp(&stinv, &tinv, sizeof(stinv)) == 0, "mat3x4_sse_inverse_affine is not mat3x4_inverse_affine %d", i);
+#endif
+        }
+}
+
+int main(void) {
+        int skip = test_begin("matrix");
+        if (skip)
+                return skip;
+
+        test_square();
+        test_rect();
+        test_affine();
+
+        return test_end();
+}
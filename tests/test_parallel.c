@@ -0,0 +1,297 @@
+/*
+ * The _parallel functions against their single threaded versions, bit for
+ * bit, with n around a chunk boundary: inline, on the built-in pool with
+ * several thread counts and on a custom scheduler, a call from inside a
+ * chunk and a chunk that only finishes when the others were stolen.
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "test.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+
+/** @brief Room for 4 chunks of elements of the given bytes of input and output. */
+#define MAX_N(bytes) (4 * SMATH_PARALLEL_CHUNK_BYTES / (bytes))
+
+#define MAT_N MAX_N(3 * sizeof(mat4x4))
+#define VEC3_N MAX_N(2 * sizeof(vec3))
+#define VEC4_N MAX_N(2 * sizeof(vec4))
+
+static mat4x4 m0[MAT_N], m1[MAT_N], mat_out[MAT_N], mat_ref[MAT_N];
+static vec3 v3_in[VEC3_N], v3_out[VEC3_N], v3_ref[VEC3_N];
+static vec4 v4_in[VEC4_N], v4_out[VEC4_N], v4_ref[VEC4_N];
+static mat4x4 transform;
+
+/** @brief chunk - 1, chunk and chunk + 1 elements, and a last chunk of 1 after 3 full ones. */
+static size_t sizes(size_t elem_bytes, size_t n[4]) {
+        size_t chunk = smath_parallel_chunk(elem_bytes);
+
+        n[0] = chunk - 1;
+        n[1] = chunk;
+        n[2] = chunk + 1;
+        n[3] = 3 * chunk + 1;
+        return 4;
+}
+
+static void test_mult_array(const char *mode) {
+        size_t n[4], count = sizes(3 * sizeof(mat4x4), n);
+
+        for (size_t s = 0; s < count; ++s) {
+                test_fill(&m0[0].t[0][0], 16 * n[s], -2.0f, 2.0f);
+                test_fill(&m1[0].t[0][0], 16 * n[s], -2.0f, 2.0f);
+
+                mat4x4_mult_array(mat_ref, m0, m1, n[s]);
+                memset(mat_out, 0, sizeof(mat_out));
+                mat4x4_mult_array_parallel(mat_out, m0, m1, n[s]);
+
+                TEST_CHECK(memcmp(mat_out, mat_ref, n[s] * sizeof(mat4x4)) == 0, "%s mat4x4_mult_array_parallel n %zu", mode, n[s]);
+                TEST_CHECK(test_same_n(&mat_out[n[s]].t[0][0], &(mat4x4){ 0 }.t[0][0], 16),
+                           "%s mat4x4_mult_array_parallel n %zu: wrote past n", mode, n[s]);
+        }
+}
+
+typedef void (*transform_vec3_fn)(const mat4x4 *m, const vec3 *in, vec3 *out, size_t n);
+
+/** @brief Into another array and in place. */
+static void test_vec3(const char *mode, const char *name, transform_vec3_fn serial, transform_vec3_fn parallel) {
+        size_t n[4], count = sizes(2 * sizeof(vec3), n);
+
+        for (size_t s = 0; s < count; ++s) {
+                test_fill(&v3_in[0].x, 3 * n[s], -100.0f, 100.0f);
+
+                serial(&transform, v3_in, v3_ref, n[s]);
+                memset(v3_out, 0, sizeof(v3_out));
+                parallel(&transform, v3_in, v3_out, n[s]);
+
+                TEST_CHECK(memcmp(v3_out, v3_ref, n[s] * sizeof(vec3)) == 0, "%s %s n %zu", mode, name, n[s]);
+                TEST_CHECK(v3_out[n[s]].x == 0.0f && v3_out[n[s]].y == 0.0f && v3_out[n[s]].z == 0.0f,
+                           "%s %s n %zu: wrote past n", mode, name, n[s]);
+
+                parallel(&transform, v3_in, v3_in, n[s]);
+                TEST_CHECK(memcmp(v3_in, v3_ref, n[s] * sizeof(vec3)) == 0, "%s %s n %zu in place", mode, name, n[s]);
+        }
+}
+
+static void test_vec4s(const char *mode) {
+        size_t n[4], count = sizes(2 * sizeof(vec4), n);
+
+        for (size_t s = 0; s < count; ++s) {
+                test_fill(&v4_in[0].x, 4 * n[s], -100.0f, 100.0f);
+
+                mat4x4_transform_vec4s(&transform, v4_in, v4_ref, n[s]);
+                memset(v4_out, 0, sizeof(v4_out));
+                mat4x4_transform_vec4s_parallel(&transform, v4_in, v4_out, n[s]);
+
+                TEST_CHECK(memcmp(v4_out, v4_ref, n[s] * sizeof(vec4)) == 0, "%s mat4x4_transform_vec4s_parallel n %zu", mode, n[s]);
+                TEST_CHECK(test_same_n(&v4_out[n[s]].x, &(vec4){ 0 }.x, 4), "%s mat4x4_transform_vec4s_parallel n %zu: wrote past n",
+                           mode, n[s]);
+
+                mat4x4_transform_vec4s_parallel(&transform, v4_in, v4_in, n[s]);
+                TEST_CHECK(memcmp(v4_in, v4_ref, n[s] * sizeof(vec4)) == 0, "%s mat4x4_transform_vec4s_parallel n %zu in place",
+                           mode, n[s]);
+        }
+}
+
+static void test_soa_normalize(const char *mode) {
+        size_t n[4], count = sizes(2 * sizeof(vec3), n);
+
+        for (size_t s = 0; s < count; ++s) {
+                vec3_soa a, b;
+                TEST_CHECK(vec3_soa_create(&a, n[s]) && vec3_soa_create(&b, n[s]), "vec3_soa_create %zu", n[s]);
+
+                test_fill(a.x, n[s], -10.0f, 10.0f);
+                test_fill(a.y, n[s], -10.0f, 10.0f);
+                test_fill(a.z, n[s], -10.0f, 10.0f);
+                memcpy(b.x, a.x, n[s] * sizeof(f32));
+                memcpy(b.y, a.y, n[s] * sizeof(f32));
+                memcpy(b.z, a.z, n[s] * sizeof(f32));
+
+                vec3_soa_normalize(&a);
+                vec3_soa_normalize_parallel(&b);
+                TEST_CHECK(test_same_n(a.x, b.x, n[s]) && test_same_n(a.y, b.y, n[s]) && test_same_n(a.z, b.z, n[s]),
+                           "%s vec3_soa_normalize_parallel n %zu", mode, n[s]);
+
+                vec3_soa_destroy(&a);
+                vec3_soa_destroy(&b);
+        }
+
+        count = sizes(2 * sizeof(vec4), n);
+        for (size_t s = 0; s < count; ++s) {
+                vec4_soa a, b;
+                TEST_CHECK(vec4_soa_create(&a, n[s]) && vec4_soa_create(&b, n[s]), "vec4_soa_create %zu", n[s]);
+
+                f32 *pa[4] = { a.x, a.y, a.z, a.w }, *pb[4] = { b.x, b.y, b.z, b.w };
+                for (int k = 0; k < 4; ++k) {
+                        test_fill(pa[k], n[s], -10.0f, 10.0f);
+                        memcpy(pb[k], pa[k], n[s] * sizeof(f32));
+                }
+
+                vec4_soa_normalize(&a);
+                vec4_soa_normalize_parallel(&b);
+                bool same = true;
+                for (int k = 0; k < 4; ++k)
+                        same = same && test_same_n(pa[k], pb[k], n[s]);
+                TEST_CHECK(same, "%s vec4_soa_normalize_parallel n %zu", mode, n[s]);
+
+                vec4_soa_destroy(&a);
+                vec4_soa_destroy(&b);
+        }
+}
+
+static void test_all(const char *mode) {
+        test_mult_array(mode);
+        test_vec3(mode, "mat4x4_transform_points_parallel", mat4x4_transform_points, mat4x4_transform_points_parallel);
+        test_vec3(mode, "mat4x4_transform_directions_parallel", mat4x4_transform_directions, mat4x4_transform_directions_parallel);
+        test_vec4s(mode);
+        test_soa_normalize(mode);
+}
+
+
+/** @brief A _parallel call from every chunk of an outer job, each on its own quarter of the points. */
+static void nested_task(void *ctx, size_t chunk) {
+        size_t quarter = *(const size_t *)ctx;
+        mat4x4_transform_points_parallel(&transform, v3_in + chunk * quarter, v3_out + chunk * quarter, quarter);
+}
+
+static void test_nested(const char *mode) {
+        size_t quarter = VEC3_N / 4;
+
+        test_fill(&v3_in[0].x, 3 * VEC3_N, -100.0f, 100.0f);
+        mat4x4_transform_points(&transform, v3_in, v3_ref, VEC3_N);
+        memset(v3_out, 0, sizeof(v3_out));
+
+        smath_parallel_for(nested_task, &quarter, 4);
+        TEST_CHECK(memcmp(v3_out, v3_ref, 4 * quarter * sizeof(vec3)) == 0, "%s nested call", mode);
+}
+
+
+/** @brief Every chunk once, chunk 0 waits until all the others are done. */
+typedef struct steal_job {
+        atomic_uint runs[64];
+        atomic_uint done;
+        bool waited;
+} steal_job;
+
+static void steal_task(void *ctx, size_t chunk) {
+        steal_job *job = ctx;
+
+        atomic_fetch_add(&job->runs[chunk], 1);
+
+        if (chunk == 0) {
+                // The rest of the range of the calling thread can only be run by thieves.
+                time_t start = time(NULL);
+                while (atomic_load(&job->done) != 63 && time(NULL) - start < 10)
+                        ;
+                job->waited = atomic_load(&job->done) == 63;
+                return;
+        }
+
+        atomic_fetch_add(&job->done, 1);
+}
+
+static void test_stealing(u32 threads) {
+        steal_job job = { .waited = false };
+
+        for (int i = 0; i < 64; ++i)
+                atomic_init(&job.runs[i], 0);
+        atomic_init(&job.done, 0);
+
+        smath_parallel_for(steal_task, &job, 64);
+
+        bool once = true;
+        for (int i = 0; i < 64; ++i)
+                once = once && atomic_load(&job.runs[i]) == 1;
+        TEST_CHECK(once, "%u threads: a chunk did not run exactly once", threads);
+        TEST_CHECK(job.waited, "%u threads: the chunks behind chunk 0 were not stolen", threads);
+}
+
+
+/** @brief A custom scheduler, the chunks in reverse order on the calling thread. */
+static void reverse_scheduler(void *user, smath_task_fn task, void *ctx, size_t chunks) {
+        ++*(int *)user;
+        for (size_t c = chunks; c-- > 0;)
+                task(ctx, c);
+}
+
+/** @brief A custom scheduler, the chunks dealt round robin to 3 threads of its own. */
+typedef struct thread_job {
+        smath_task_fn task;
+        void *ctx;
+        size_t chunks;
+        size_t first;
+} thread_job;
+
+static void *thread_job_main(void *arg) {
+        thread_job *job = arg;
+        for (size_t c = job->first; c < job->chunks; c += 3)
+                job->task(job->ctx, c);
+        return NULL;
+}
+
+static void thread_scheduler(void *user, smath_task_fn task, void *ctx, size_t chunks) {
+        pthread_t threads[3];
+        thread_job jobs[3];
+        bool started[3];
+
+        ++*(int *)user;
+        for (int i = 0; i < 3; ++i) {
+                jobs[i] = (thread_job){ task, ctx, chunks, (size_t)i };
+                started[i] = pthread_create(&threads[i], NULL, thread_job_main, &jobs[i]) == 0;
+        }
+
+        for (int i = 0; i < 3; ++i) {
+                if (started[i])
+                        pthread_join(threads[i], NULL);
+                else
+                        thread_job_main(&jobs[i]);
+        }
+}
+
+int main(void) {
+        int skip = test_begin("parallel");
+        if (skip)
+                return skip;
+
+        test_fill(&transform.t[0][0], 16, -4.0f, 4.0f);
+
+        smath_pool_stop();
+        TEST_CHECK(smath_pool_threads() == 1, "stopped pool has %u threads", smath_pool_threads());
+        test_all("inline");
+        test_nested("inline");
+
+        static const u32 threads[] = { 2, 3, 8 };
+        for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t) {
+                char mode[32];
+                snprintf(mode, sizeof(mode), "%u threads", threads[t]);
+
+                TEST_CHECK(smath_pool_start(threads[t]), "smath_pool_start %u", threads[t]);
+                TEST_CHECK(smath_pool_threads() == threads[t], "smath_pool_threads %u, expected %u", smath_pool_threads(), threads[t]);
+                test_all(mode);
+                test_nested(mode);
+                test_stealing(threads[t]);
+        }
+
+        // The scheduler takes over from the running pool.
+        int calls = 0;
+        smath_set_scheduler(reverse_scheduler, &calls);
+        test_all("reverse scheduler");
+        test_nested("reverse scheduler");
+        TEST_CHECK(calls > 0, "the reverse scheduler was not called");
+
+        calls = 0;
+        smath_set_scheduler(thread_scheduler, &calls);
+        test_all("thread scheduler");
+        test_nested("thread scheduler");
+        TEST_CHECK(calls > 0, "the thread scheduler was not called");
+
+        smath_set_scheduler(NULL, NULL);
+        test_all("pool again");
+        smath_pool_stop();
+
+        return test_end();
+}
@@ -0,0 +1,246 @@
+/*
+ * The projections map z_near and z_far to the ends of their depth range,
+ * reversed Z and the infinite far plane included, look_at moves the eye
+ * to the origin and the TRS builds match T * R * S multiplied out with
+ * mat4x4_mult, on every ISA.
+ */
+
+#include "test.h"
+
+#define N 37                    // Odd, the batch kernels have a tail
+#define TOL 1e-5f
+#define FOVY 1.0471976f         // 60 degrees
+#define ASPECT 1.7777778f
+#define Z_NEAR 0.1f
+#define Z_FAR 1000.0f
+
+static vec3 t[N], s[N];
+static quat r[N];
+static mat4x4 dest[N + 1], ref[N];
+static mat4x3 dest43[N + 1];
+
+/** @brief The clip space point of (x, y, z, 1) divided by w. */
+static vec4 project(const mat4x4 *m, f32 x, f32 y, f32 z) {
+        vec4 p = { x, y, z, 1.0f };
+        vec4 c = mat4x4_vec4_mult(m, &p);
+        return (vec4){ c.x / c.w, c.y / c.w, c.z / c.w, c.w };
+}
+
+/** @brief The depth of a point at distance d in front of the camera. */
+static f32 depth(const mat4x4 *m, f32 d) {
+        return project(m, 0.0f, 0.0f, -d).z;
+}
+
+/** @brief The corner of the frustum at distance d goes to (1, 1) and w is the distance. */
+static void check_frustum_edge(const mat4x4 *m, const char *name) {
+        f32 d = 7.0f;
+        f32 y = d * tanf(0.5f * FOVY), x = y * ASPECT;
+        vec4 c = project(m, x, -y, -d);
+
+        TEST_CHECK(test_close(c.x, 1.0f, TOL) && test_close(c.y, -1.0f, TOL) && test_close(c.w, d, TOL),
+                   "%s: the frustum corner goes to (%g %g) w %g", name, c.x, c.y, c.w);
+}
+
+static void test_perspective(void) {
+        static const struct { smath_clip_depth depth; f32 near_z; const char *name; } cases[] = {
+                { SMATH_CLIP_DEPTH_NEG_ONE_TO_ONE, -1.0f, "NEG_ONE_TO_ONE" },
+                { SMATH_CLIP_DEPTH_ZERO_TO_ONE, 0.0f, "ZERO_TO_ONE" },
+        };
+
+        for (int i = 0; i < 2; ++i) {
+                mat4x4 m = mat4x4_perspective(FOVY, ASPECT, Z_NEAR, Z_FAR, cases[i].depth);
+                f32 n = depth(&m, Z_NEAR), f = depth(&m, Z_FAR);
+
+                TEST_CHECK(test_close(n, cases[i].near_z, TOL) && test_close(f, 1.0f, TOL),
+                           "perspective %s: near %g far %g", cases[i].name, n, f);
+                TEST_CHECK(depth(&m, 1.0f) > n && depth(&m, 10.0f) > depth(&m, 1.0f), "perspective %s: depth not increasing",
+                           cases[i].name);
+                check_frustum_edge(&m, "perspective");
+
+                // Without a far plane the depth only gets to 1 at infinity.
+                m = mat4x4_perspective_infinite(FOVY, ASPECT, Z_NEAR, cases[i].depth);
+                n = depth(&m, Z_NEAR);
+                f = depth(&m, 1e6f);
+
+                TEST_CHECK(test_close(n, cases[i].near_z, TOL) && test_close(f, 1.0f, TOL) && f <= 1.0f,
+                           "perspective_infinite %s: near %g far %g", cases[i].name, n, f);
+                TEST_CHECK(depth(&m, 1e3f) < f, "perspective_infinite %s: depth not increasing", cases[i].name);
+                check_frustum_edge(&m, "perspective_infinite");
+        }
+}
+
+static void test_reversed(void) {
+        mat4x4 m = mat4x4_perspective_reversed(FOVY, ASPECT, Z_NEAR, Z_FAR);
+        f32 n = depth(&m, Z_NEAR), f = depth(&m, Z_FAR);
+
+        TEST_CHECK(test_close(n, 1.0f, TOL) && fabsf(f) <= TOL, "perspective_reversed: near %g far %g", n, f);
+        TEST_CHECK(depth(&m, 10.0f) < depth(&m, 1.0f), "perspective_reversed: depth not decreasing");
+        check_frustum_edge(&m, "perspective_reversed");
+
+        // Without a far plane the depth is z_near / d, 0 only at infinity.
+        m = mat4x4_perspective_reversed_infinite(FOVY, ASPECT, Z_NEAR);
+        n = depth(&m, Z_NEAR);
+        TEST_CHECK(test_close(n, 1.0f, TOL), "perspective_reversed_infinite: near %g", n);
+
+        for (f32 d = 1.0f; d <= 1e6f; d *= 10.0f) {
+                f = depth(&m, d);
+                TEST_CHECK(test_close(f, Z_NEAR / d, TOL) && f > 0.0f, "perspective_reversed_infinite: depth %g at %g", f, d);
+        }
+        check_frustum_edge(&m, "perspective_reversed_infinite");
+}
+
+static void test_ortho(void) {
+        static const struct { smath_clip_depth depth; f32 near_z; } cases[] = {
+                { SMATH_CLIP_DEPTH_NEG_ONE_TO_ONE, -1.0f },
+                { SMATH_CLIP_DEPTH_ZERO_TO_ONE, 0.0f },
+        };
+        f32 left = -3.0f, right = 5.0f, bottom = -2.0f, top = 4.0f, n = 0.5f, f = 50.0f;
+
+        for (int i = 0; i < 2; ++i) {
+                mat4x4 m = mat4x4_ortho(left, right, bottom, top, n, f, cases[i].depth);
+                vec4 lo = project(&m, left, bottom, -n), hi = project(&m, right, top, -f);
+
+                TEST_CHECK(test_close(lo.x, -1.0f, TOL) && test_close(lo.y, -1.0f, TOL) && test_close(lo.z, cases[i].near_z, TOL) &&
+                           lo.w == 1.0f, "ortho %d: near corner (%g %g %g) w %g", i, lo.x, lo.y, lo.z, lo.w);
+                TEST_CHECK(test_close(hi.x, 1.0f, TOL) && test_close(hi.y, 1.0f, TOL) && test_close(hi.z, 1.0f, TOL) &&
+                           hi.w == 1.0f, "ortho %d: far corner (%g %g %g) w %g", i, hi.x, hi.y, hi.z, hi.w);
+        }
+}
+
+static void test_look_at(void) {
+        for (int i = 0; i < 100; ++i) {
+                vec3 eye, center, up = { 0.0f, 1.0f, 0.0f };
+                test_fill(&eye.x, 3, -50.0f, 50.0f);
+                test_fill(&center.x, 3, -50.0f, 50.0f);
+
+                // The up vector must not be along the view direction.
+                vec3 dir = center;
+                vec3_sub(&dir, &eye);
+                f32 len = vec3_magnitude(&dir);
+                if (fabsf(dir.y) > 0.9f * len)
+                        continue;
+
+                mat4x4 m = mat4x4_look_at(&eye, &center, &up);
+                vec4 e = project(&m, eye.x, eye.y, eye.z);
+                vec4 c = project(&m, center.x, center.y, center.z);
+                f32 tol = TOL * 100.0f;          // the translation is a dot product of positions up to 50
+
+                TEST_CHECK(fabsf(e.x) <= tol && fabsf(e.y) <= tol && fabsf(e.z) <= tol, "look_at: the eye goes to (%g %g %g)", e.x,
+                           e.y, e.z);
+                TEST_CHECK(fabsf(c.x) <= tol && fabsf(c.y) <= tol && test_close(c.z, -len, TOL),
+                           "look_at: the center goes to (%g %g %g), expected (0 0 %g)", c.x, c.y, c.z, -len);
+
+                // The rotation rows are orthonormal, the last row is (0, 0, 0, 1).
+                bool orthonormal = m.t[3][0] == 0.0f && m.t[3][1] == 0.0f && m.t[3][2] == 0.0f && m.t[3][3] == 1.0f;
+                for (int a = 0; a < 3; ++a) {
+                        for (int b = 0; b < 3; ++b) {
+                                f32 dot = m.t[a][0] * m.t[b][0] + m.t[a][1] * m.t[b][1] + m.t[a][2] * m.t[b][2];
+                                orthonormal = orthonormal && fabsf(dot - (a == b ? 1.0f : 0.0f)) <= TOL;
+                        }
+                }
+                TEST_CHECK(orthonormal, "look_at: the rows are not orthonormal");
+        }
+}
+
+/** @brief T * R * S as three matrices. */
+static mat4x4 trs_reference(const vec3 *tr, const quat *q, const vec3 *sc) {
+        mat4x4 tm = { 0 }, sm = { 0 };
+
+        for (int i = 0; i < 4; ++i)
+                tm.t[i][i] = 1.0f;
+        tm.t[0][3] = tr->x;
+        tm.t[1][3] = tr->y;
+        tm.t[2][3] = tr->z;
+
+        sm.t[0][0] = sc->x;
+        sm.t[1][1] = sc->y;
+        sm.t[2][2] = sc->z;
+        sm.t[3][3] = 1.0f;
+
+        mat4x4 rm = quat_to_mat4x4(q);
+        mat4x4 rs = mat4x4_mult(&rm, &sm);
+        return mat4x4_mult(&tm, &rs);
+}
+
+/** @brief Exactly equal on the ISAs without FMA, within tol on the others. */
+static bool mat4x4_match(const mat4x4 *a, const mat4x4 *b, f32 tol) {
+        smath_isa isa = smath_get_kernels()->isa;
+        bool fma = isa == SMATH_ISA_AVX2 || isa == SMATH_ISA_AVX512;
+        return fma ? test_close_n(&a->t[0][0], &b->t[0][0], 16, tol) : test_same_n(&a->t[0][0], &b->t[0][0], 16);
+}
+
+static void test_trs(void) {
+        test_fill(&t[0].x, 3 * N, -100.0f, 100.0f);
+        test_fill(&s[0].x, 3 * N, 0.1f, 4.0f);
+        s[1] = (vec3){ -1.0f, 2.0f, 0.5f };             // a mirror
+
+        for (int i = 0; i < N; ++i) {
+                vec3 axis;
+                test_fill(&axis.x, 3, -1.0f, 1.0f);
+                vec3_normalize(&axis);
+                r[i] = quat_create_from_axis_angle(&axis, test_uniform(-3.1f, 3.1f));
+                ref[i] = trs_reference(&t[i], &r[i], &s[i]);
+        }
+
+        for (int i = 0; i < N; ++i) {
+                mat4x4 m = mat4x4_from_trs(&t[i], &r[i], &s[i]);
+                TEST_CHECK(mat4x4_match(&m, &ref[i], TOL), "mat4x4_from_trs %d", i);
+        }
+
+        for (size_t n = 1; n <= N; n += 6) {
+                u32 sentinel = 0xDEADBEEF;
+                memcpy(&dest[n], &sentinel, sizeof(sentinel));
+                memcpy(&dest43[n], &sentinel, sizeof(sentinel));
+
+                mat4x4_from_trs_array(dest, t, r, s, n);
+                mat4x3_from_trs_array(dest43, t, r, s, n);
+
+                bool same = true, same43 = true;
+                for (size_t i = 0; i < n; ++i) {
+                        same = same && mat4x4_match(&dest[i], &ref[i], TOL);
+
+                        mat4x4 m;
+                        memcpy(&m, &dest43[i], sizeof(mat4x3));
+                        memcpy(m.t[3], ref[i].t[3], sizeof(m.t[3]));
+                        same43 = same43 && mat4x4_match(&m, &ref[i], TOL);
+                }
+                TEST_CHECK(same, "mat4x4_from_trs_array with n %zu", n);
+                TEST_CHECK(same43, "mat4x3_from_trs_array with n %zu", n);
+                TEST_CHECK(memcmp(&dest[n], &sentinel, sizeof(sentinel)) == 0, "mat4x4_from_trs_array wrote past n %zu", n);
+                TEST_CHECK(memcmp(&dest43[n], &sentinel, sizeof(sentinel)) == 0, "mat4x3_from_trs_array wrote past n %zu", n);
+        }
+
+        // A parent with a projection row, dest = parent * T * R * S.
+        mat4x4 parent = mat4x4_perspective(FOVY, ASPECT, Z_NEAR, Z_FAR, SMATH_CLIP_DEPTH_ZERO_TO_ONE);
+        mat4x4 view = trs_reference(&t[0], &r[0], &s[0]);
+        parent = mat4x4_mult(&parent, &view);
+
+        for (size_t n = 1; n <= N; n += 6) {
+                u32 sentinel = 0xDEADBEEF;
+                memcpy(&dest[n], &sentinel, sizeof(sentinel));
+
+                mat4x4_from_trs_mult_array(dest, &parent, t, r, s, n);
+
+                bool close = true;
+                for (size_t i = 0; i < n; ++i) {
+                        mat4x4 m = mat4x4_mult(&parent, &ref[i]);
+                        close = close && test_close_n(&dest[i].t[0][0], &m.t[0][0], 16, TOL);
+                }
+                TEST_CHECK(close, "mat4x4_from_trs_mult_array with n %zu", n);
+                TEST_CHECK(memcmp(&dest[n], &sentinel, sizeof(sentinel)) == 0, "mat4x4_from_trs_mult_array wrote past n %zu", n);
+        }
+}
+
+int main(void) {
+        int skip = test_begin("projection");
+        if (skip)
+                return skip;
+
+        test_perspective();
+        test_reversed();
+        test_ortho();
+        test_look_at();
+        test_trs();
+
+        return test_end();
+}
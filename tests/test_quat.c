@@ -0,0 +1,173 @@
+/*
+ * The quat functions: the slerp and nlerp endpoints, the mat4x4 round
+ * trip and the composition order, and quat_soa_nlerp, quat_soa_slerp
+ * against quat_nlerp, quat_slerp.
+ */
+
+#include "test.h"
+
+#define N 1003
+#define TOL 2e-6f
+
+/** @brief The documented bound of quat_soa_slerp against quat_slerp (vector_soa.h). */
+#define SOA_SLERP_TOL 5e-5f
+
+static quat unit(quat q) {
+        f32 len = sqrtf(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+
+        q.x /= len;
+        q.y /= len;
+        q.z /= len;
+        q.w /= len;
+        return q;
+}
+
+static quat random_quat(void) {
+        quat q;
+
+        do {
+                test_fill(&q.x, 4, -1.0f, 1.0f);
+        } while (q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w < 0.01f);
+
+        return unit(q);
+}
+
+static f32 dot4(const quat *a, const quat *b) {
+        return a->x * b->x + a->y * b->y + a->z * b->z + a->w * b->w;
+}
+
+/** @brief a and b are the same rotation, q and -q included. */
+static bool same_rotation(const quat *a, const quat *b, f32 tol) {
+        quat n = { -b->x, -b->y, -b->z, -b->w };
+        return test_close_n(&a->x, &b->x, 4, tol) || test_close_n(&a->x, &n.x, 4, tol);
+}
+
+static bool is_unit(const quat *q, f32 tol) {
+        return fabsf(sqrtf(dot4(q, q)) - 1.0f) <= tol;
+}
+
+static void test_single(void) {
+        static const vec3 axes[3] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+
+        for (int i = 0; i < N; ++i) {
+                quat q0 = random_quat(), q1 = random_quat();
+                quat q1_near = dot4(&q0, &q1) < 0.0f ? (quat){ -q1.x, -q1.y, -q1.z, -q1.w } : q1;
+
+                // The endpoints, t = 1 gives q1 on the side of q0.
+                quat s0 = quat_slerp(&q0, &q1, 0.0f), s1 = quat_slerp(&q0, &q1, 1.0f);
+                quat n0 = quat_nlerp(&q0, &q1, 0.0f), n1 = quat_nlerp(&q0, &q1, 1.0f);
+                TEST_CHECK(test_close_n(&s0.x, &q0.x, 4, TOL), "quat_slerp t = 0 %d", i);
+                TEST_CHECK(test_close_n(&s1.x, &q1_near.x, 4, 1e-5f), "quat_slerp t = 1 %d", i);
+                TEST_CHECK(test_close_n(&n0.x, &q0.x, 4, TOL), "quat_nlerp t = 0 %d", i);
+                TEST_CHECK(test_close_n(&n1.x, &q1_near.x, 4, TOL), "quat_nlerp t = 1 %d", i);
+
+                // Constant angular speed: the middle is as far from both ends.
+                f32 t = test_uniform(0.0f, 1.0f);
+                quat s = quat_slerp(&q0, &q1, t), n = quat_nlerp(&q0, &q1, t), mid = quat_slerp(&q0, &q1, 0.5f);
+                TEST_CHECK(is_unit(&s, 1e-5f) && is_unit(&n, 1e-5f), "quat_slerp and quat_nlerp unit length %d", i);
+                TEST_CHECK(fabsf(dot4(&q0, &mid) - dot4(&mid, &q1_near)) <= 1e-5f, "quat_slerp midpoint %d", i);
+                TEST_CHECK(dot4(&s, &q0) >= dot4(&q1_near, &q0) - 1e-5f, "quat_slerp stays on the shorter arc %d", i);
+
+                // quat to mat4x4 and back, and the matrix rotates like the quaternion.
+                mat4x4 m = quat_to_mat4x4(&q0);
+                quat back = quat_from_mat4x4(&m);
+                TEST_CHECK(same_rotation(&back, &q0, 1e-5f), "quat_from_mat4x4 round trip %d", i);
+                TEST_CHECK(m.t[3][3] == 1.0f && m.t[0][3] == 0.0f && m.t[1][3] == 0.0f && m.t[2][3] == 0.0f,
+                           "quat_to_mat4x4 has no translation %d", i);
+
+                vec3 v;
+                test_fill(&v.x, 3, -10.0f, 10.0f);
+                vec4 v4 = { v.x, v.y, v.z, 0.0f };
+                vec3 r = quat_rotate_vec3(&q0, &v);
+                vec4 rm = mat4x4_vec4_mult(&m, &v4);
+                TEST_CHECK(test_close_n(&r.x, &rm.x, 3, 1e-5f), "quat_rotate_vec3 against quat_to_mat4x4 %d", i);
+
+                // q0 * q1 rotates by q1 first.
+                quat q01 = quat_mult(&q0, &q1);
+                vec3 r1 = quat_rotate_vec3(&q1, &v), r01 = quat_rotate_vec3(&q0, &r1), rq = quat_rotate_vec3(&q01, &v);
+                TEST_CHECK(test_close_n(&rq.x, &r01.x, 3, 1e-5f), "quat_mult order %d", i);
+
+                quat c = quat_conjugate(&q0), qc = quat_mult(&q0, &c), one = { 0.0f, 0.0f, 0.0f, 1.0f };
+                TEST_CHECK(test_close_n(&qc.x, &one.x, 4, TOL), "quat_conjugate %d", i);
+
+#ifdef SMATH_SSE
+                quat sq = quat_sse_mult(&q0, &q1);
+                TEST_CHECK(test_close_n(&sq.x, &q01.x, 4, TOL), "quat_sse_mult %d", i);
+#endif
+
+                // A rotation around an axis has w = cos(angle / 2).
+                f32 angle = test_uniform(-3.0f, 3.0f);
+                quat qa = quat_create_from_axis_angle(&axes[i % 3], angle);
+                TEST_CHECK(is_unit(&qa, TOL) && test_close(qa.w, cosf(0.5f * angle), TOL), "quat_create_from_axis_angle %d", i);
+        }
+
+        // Equal quaternions take the nlerp fallback and stay finite.
+        quat q = random_quat();
+        quat s = quat_slerp(&q, &q, 0.3f);
+        TEST_CHECK(test_close_n(&s.x, &q.x, 4, TOL), "quat_slerp of equal quaternions");
+}
+
+static void test_soa(void) {
+        static quat q0[N], q1[N], ref[N], out[N];
+        static f32 t[N];
+        vec4_soa a, b, dest;
+
+        TEST_CHECK(vec4_soa_create(&a, N) && vec4_soa_create(&b, N) && vec4_soa_create(&dest, N), "vec4_soa_create");
+
+        for (int i = 0; i < N; ++i) {
+                q0[i] = random_quat();
+                // Every 8th pair almost equal, every 5th in opposite hemispheres.
+                if (i % 8 == 0) {
+                        q1[i] = q0[i];
+                        q1[i].x += 1e-4f;
+                        q1[i] = unit(q1[i]);
+                } else {
+                        q1[i] = random_quat();
+                }
+                if (i % 5 == 0 && dot4(&q0[i], &q1[i]) > 0.0f)
+                        q1[i] = (quat){ -q1[i].x, -q1[i].y, -q1[i].z, -q1[i].w };
+                t[i] = i % 7 == 0 ? (f32)(i % 2) : test_uniform(0.0f, 1.0f);
+        }
+
+        vec4_soa_from_aos(&a, q0, N);
+        vec4_soa_from_aos(&b, q1, N);
+
+        quat_soa_slerp(&dest, &a, &b, t);
+        vec4_soa_to_aos(out, &dest);
+        TEST_CHECK(dest.count == N, "quat_soa_slerp count");
+
+        for (int i = 0; i < N; ++i) {
+                ref[i] = quat_slerp(&q0[i], &q1[i], t[i]);
+                TEST_CHECK(test_close_n(&out[i].x, &ref[i].x, 4, SOA_SLERP_TOL), "quat_soa_slerp %d: t %g", i, t[i]);
+        }
+
+        quat_soa_nlerp(&dest, &a, &b, t);
+        vec4_soa_to_aos(out, &dest);
+
+        for (int i = 0; i < N; ++i) {
+                ref[i] = quat_nlerp(&q0[i], &q1[i], t[i]);
+                TEST_CHECK(test_close_n(&out[i].x, &ref[i].x, 4, 1e-5f), "quat_soa_nlerp %d", i);
+        }
+
+        // dest is q0.
+        quat_soa_nlerp(&a, &a, &b, t);
+        vec4_soa_to_aos(out, &a);
+
+        for (int i = 0; i < N; ++i)
+                TEST_CHECK(test_close_n(&out[i].x, &ref[i].x, 4, 1e-5f), "quat_soa_nlerp in place %d", i);
+
+        vec4_soa_destroy(&a);
+        vec4_soa_destroy(&b);
+        vec4_soa_destroy(&dest);
+}
+
+int main(void) {
+        int skip = test_begin("quat");
+        if (skip)
+                return skip;
+
+        test_single();
+        test_soa();
+
+        return test_end();
+}
@@ -0,0 +1,341 @@
+/*
+ * The ray tests: the single ray functions against analytic hits and
+ * misses, rays parallel to a face, a slab or a plane included, and the
+ * packet kernels against the single ray functions with counts that end
+ * in a partial register.
+ */
+
+#include "test.h"
+
+#define TOL 1e-6f
+
+/** @brief The kernels with FMA round the dot products once less than ray.c. */
+#define FMA_TOL 1e-4f
+
+static f32 packet_tol;
+
+/** @brief t is read after the test wrote it, not in the argument list next to the call. */
+static bool hit_at(bool hit, const f32 *t, f32 expected) {
+        return hit && test_close(*t, expected, TOL);
+}
+
+static void test_triangle(void) {
+        triangle tri = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } };
+        f32 t = -1.0f;
+
+        // Straight down onto the triangle from z = 2, and from below.
+        ray down = { { 0.25f, 0.25f, 2.0f }, { 0.0f, 0.0f, -1.0f } };
+        ray up = { { 0.25f, 0.25f, -3.0f }, { 0.0f, 0.0f, 2.0f } };
+        TEST_CHECK(hit_at(ray_intersect_triangle(&down, &tri, INFINITY, &t), &t, 2.0f), "triangle from above: t %g", t);
+        TEST_CHECK(hit_at(ray_intersect_triangle(&up, &tri, INFINITY, &t), &t, 1.5f), "triangle from below: t %g", t);
+
+        // t_max is exclusive, the triangle behind the origin misses.
+        TEST_CHECK(!ray_intersect_triangle(&down, &tri, 2.0f, &t), "triangle at t_max");
+        ray away = { { 0.25f, 0.25f, 2.0f }, { 0.0f, 0.0f, 1.0f } };
+        TEST_CHECK(!ray_intersect_triangle(&away, &tri, INFINITY, &t), "triangle behind the ray");
+
+        // Outside each of the three edges.
+        static const vec3 outside[3] = { { -0.1f, 0.5f, 2.0f }, { 0.5f, -0.1f, 2.0f }, { 0.6f, 0.6f, 2.0f } };
+        for (int i = 0; i < 3; ++i) {
+                ray r = { outside[i], { 0.0f, 0.0f, -1.0f } };
+                TEST_CHECK(!ray_intersect_triangle(&r, &tri, INFINITY, &t), "triangle outside edge %d", i);
+        }
+
+        // Parallel to the triangle, in its plane and above it.
+        ray in_plane = { { -1.0f, 0.25f, 0.0f }, { 1.0f, 0.0f, 0.0f } };
+        ray above = { { -1.0f, 0.25f, 1.0f }, { 1.0f, 0.0f, 0.0f } };
+        TEST_CHECK(!ray_intersect_triangle(&in_plane, &tri, INFINITY, &t), "triangle ray in the plane");
+        TEST_CHECK(!ray_intersect_triangle(&above, &tri, INFINITY, &t), "triangle parallel ray");
+
+        // Degenerate, all three vertices on a line.
+        triangle line = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 2.0f, 0.0f, 0.0f } };
+        ray r = { { 0.5f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f } };
+        TEST_CHECK(!ray_intersect_triangle(&r, &line, INFINITY, &t), "degenerate triangle");
+}
+
+static void test_aabb(void) {
+        aabb b = { { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f } };
+        f32 t = -1.0f;
+
+        ray r = { { -5.0f, 0.5f, 0.25f }, { 2.0f, 0.0f, 0.0f } };
+        TEST_CHECK(hit_at(ray_intersect_aabb(&r, &b, INFINITY, &t), &t, 2.0f), "aabb along x: t %g", t);
+        TEST_CHECK(!ray_intersect_aabb(&r, &b, 2.0f, &t), "aabb at t_max");
+
+        ray diagonal = { { -3.0f, -3.0f, -3.0f }, { 1.0f, 1.0f, 1.0f } };
+        TEST_CHECK(hit_at(ray_intersect_aabb(&diagonal, &b, INFINITY, &t), &t, 2.0f), "aabb diagonal: t %g", t);
+
+        // Solid, a ray starting inside hits at 0 whatever the direction.
+        ray inside = { { 0.5f, -0.5f, 0.0f }, { 0.0f, -1.0f, 0.0f } };
+        TEST_CHECK(hit_at(ray_intersect_aabb(&inside, &b, INFINITY, &t), &t, 0.0f), "aabb from inside: t %g", t);
+
+        ray behind = { { -5.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f } };
+        TEST_CHECK(!ray_intersect_aabb(&behind, &b, INFINITY, &t), "aabb behind the ray");
+
+        // Parallel to the y and z slabs: a hit inside both, a miss outside either one.
+        ray in_slabs = { { -5.0f, 0.9f, -0.9f }, { 1.0f, 0.0f, 0.0f } };
+        ray out_y = { { -5.0f, 1.1f, 0.0f }, { 1.0f, 0.0f, 0.0f } };
+        ray out_z = { { -5.0f, 0.0f, -1.1f }, { 1.0f, 0.0f, 0.0f } };
+        TEST_CHECK(hit_at(ray_intersect_aabb(&in_slabs, &b, INFINITY, &t), &t, 4.0f), "aabb parallel inside the slabs: t %g", t);
+        TEST_CHECK(!ray_intersect_aabb(&out_y, &b, INFINITY, &t), "aabb parallel outside the y slab");
+        TEST_CHECK(!ray_intersect_aabb(&out_z, &b, INFINITY, &t), "aabb parallel outside the z slab");
+
+        // Negative zero directions take the same path.
+        ray neg_zero = { { 0.0f, -5.0f, 0.5f }, { -0.0f, 1.0f, -0.0f } };
+        TEST_CHECK(hit_at(ray_intersect_aabb(&neg_zero, &b, INFINITY, &t), &t, 4.0f), "aabb -0 direction: t %g", t);
+}
+
+static void test_sphere(void) {
+        sphere s = { { 1.0f, 2.0f, 3.0f }, 2.0f };
+        f32 t = -1.0f;
+
+        ray r = { { 1.0f, 2.0f, -7.0f }, { 0.0f, 0.0f, 1.0f } };
+        TEST_CHECK(hit_at(ray_intersect_sphere(&r, &s, INFINITY, &t), &t, 8.0f), "sphere head on: t %g", t);
+        TEST_CHECK(!ray_intersect_sphere(&r, &s, 8.0f, &t), "sphere at t_max");
+
+        // A longer direction scales t down.
+        ray scaled = { { 1.0f, 2.0f, -7.0f }, { 0.0f, 0.0f, 4.0f } };
+        TEST_CHECK(hit_at(ray_intersect_sphere(&scaled, &s, INFINITY, &t), &t, 2.0f), "sphere scaled direction: t %g", t);
+
+        ray inside = { { 1.5f, 2.0f, 3.0f }, { 0.0f, 1.0f, 0.0f } };
+        TEST_CHECK(hit_at(ray_intersect_sphere(&inside, &s, INFINITY, &t), &t, 0.0f), "sphere from inside: t %g", t);
+
+        ray behind = { { 1.0f, 2.0f, -7.0f }, { 0.0f, 0.0f, -1.0f } };
+        ray beside = { { 3.5f, 2.0f, -7.0f }, { 0.0f, 0.0f, 1.0f } };
+        TEST_CHECK(!ray_intersect_sphere(&behind, &s, INFINITY, &t), "sphere behind the ray");
+        TEST_CHECK(!ray_intersect_sphere(&beside, &s, INFINITY, &t), "sphere beside the ray");
+}
+
+static void test_plane(void) {
+        // z = 2, the normal does not have to be unit length.
+        plane p = { 0.0f, 0.0f, 2.0f, -4.0f };
+        f32 t = -1.0f;
+
+        ray down = { { 3.0f, -1.0f, 7.0f }, { 0.0f, 0.0f, -1.0f } };
+        ray up = { { 3.0f, -1.0f, -2.0f }, { 1.0f, 0.0f, 2.0f } };
+        TEST_CHECK(hit_at(ray_intersect_plane(&down, &p, INFINITY, &t), &t, 5.0f), "plane from above: t %g", t);
+        TEST_CHECK(hit_at(ray_intersect_plane(&up, &p, INFINITY, &t), &t, 2.0f), "plane from below: t %g", t);
+        TEST_CHECK(!ray_intersect_plane(&down, &p, 5.0f, &t), "plane at t_max");
+
+        ray away = { { 3.0f, -1.0f, 7.0f }, { 0.0f, 0.0f, 1.0f } };
+        ray parallel = { { 3.0f, -1.0f, 7.0f }, { 1.0f, 1.0f, 0.0f } };
+        ray in_plane = { { 3.0f, -1.0f, 2.0f }, { 1.0f, 1.0f, 0.0f } };
+        TEST_CHECK(!ray_intersect_plane(&away, &p, INFINITY, &t), "plane behind the ray");
+        TEST_CHECK(!ray_intersect_plane(&parallel, &p, INFINITY, &t), "plane parallel ray");
+        TEST_CHECK(!ray_intersect_plane(&in_plane, &p, INFINITY, &t), "plane ray in the plane");
+}
+
+static ray random_ray(void) {
+        ray r;
+
+        test_fill(&r.origin.x, 3, -4.0f, 4.0f);
+        test_fill(&r.direction.x, 3, -1.0f, 1.0f);
+
+        // Every 8th ray is parallel to a coordinate plane.
+        if ((test_rand() & 7) == 0)
+                (&r.direction.x)[test_rand() % 3] = 0.0f;
+        return r;
+}
+
+/** @brief A hit within the tolerance of the ISA, t is only compared on a hit. */
+static bool same_hit(bool hit, f32 t, bool hit_ref, f32 t_ref) {
+        if (hit != hit_ref)
+                return false;
+        return !hit || (packet_tol == 0.0f ? t == t_ref : test_close(t, t_ref, packet_tol));
+}
+
+/** @brief One ray against the structures of arrays, counts 1 to 37 end in every lane of a register. */
+static void test_nearest(void) {
+        for (size_t count = 1; count <= 37; ++count) {
+                triangle_soa tris;
+                sphere_soa spheres;
+                aabb_soa boxes;
+
+                TEST_CHECK(vec3_soa_create(&tris.v0, count) && vec3_soa_create(&tris.v1, count) && vec3_soa_create(&tris.v2, count) &&
+                           vec4_soa_create(&spheres, count) && vec3_soa_create(&boxes.min, count) && vec3_soa_create(&boxes.max, count),
+                           "create %zu", count);
+
+                triangle tri[37];
+                sphere sph[37];
+                aabb box[37];
+
+                for (size_t i = 0; i < count; ++i) {
+                        test_fill(&tri[i].v0.x, 9, -3.0f, 3.0f);
+                        test_fill(&sph[i].center.x, 3, -3.0f, 3.0f);
+                        sph[i].radius = test_uniform(0.1f, 1.0f);
+                        test_fill(&box[i].min.x, 3, -3.0f, 2.0f);
+                        box[i].max = (vec3){ box[i].min.x + test_uniform(0.1f, 1.0f), box[i].min.y + test_uniform(0.1f, 1.0f),
+                                             box[i].min.z + test_uniform(0.1f, 1.0f) };
+
+                        // A few duplicates, the lower index wins the tie.
+                        if (i > 0 && i % 5 == 0) {
+                                tri[i] = tri[i - 1];
+                                sph[i] = sph[i - 1];
+                                box[i] = box[i - 1];
+                        }
+
+                        tris.v0.x[i] = tri[i].v0.x; tris.v0.y[i] = tri[i].v0.y; tris.v0.z[i] = tri[i].v0.z;
+                        tris.v1.x[i] = tri[i].v1.x; tris.v1.y[i] = tri[i].v1.y; tris.v1.z[i] = tri[i].v1.z;
+                        tris.v2.x[i] = tri[i].v2.x; tris.v2.y[i] = tri[i].v2.y; tris.v2.z[i] = tri[i].v2.z;
+                        spheres.x[i] = sph[i].center.x; spheres.y[i] = sph[i].center.y;
+                        spheres.z[i] = sph[i].center.z; spheres.w[i] = sph[i].radius;
+                        boxes.min.x[i] = box[i].min.x; boxes.min.y[i] = box[i].min.y; boxes.min.z[i] = box[i].min.z;
+                        boxes.max.x[i] = box[i].max.x; boxes.max.y[i] = box[i].max.y; boxes.max.z[i] = box[i].max.z;
+                }
+
+                for (int k = 0; k < 64; ++k) {
+                        ray r = random_ray();
+                        f32 t_max = k % 4 == 0 ? test_uniform(0.5f, 4.0f) : INFINITY;
+
+                        f32 ref[3] = { t_max, t_max, t_max };
+                        size_t ref_index[3] = { 0, 0, 0 };
+                        bool ref_hit[3] = { false, false, false };
+                        for (size_t i = 0; i < count; ++i) {
+                                f32 d;
+                                if (ray_intersect_triangle(&r, &tri[i], ref[0], &d)) {
+                                        ref[0] = d;
+                                        ref_index[0] = i;
+                                        ref_hit[0] = true;
+                                }
+                                if (ray_intersect_sphere(&r, &sph[i], ref[1], &d)) {
+                                        ref[1] = d;
+                                        ref_index[1] = i;
+                                        ref_hit[1] = true;
+                                }
+                                if (ray_intersect_aabb(&r, &box[i], ref[2], &d)) {
+                                        ref[2] = d;
+                                        ref_index[2] = i;
+                                        ref_hit[2] = true;
+                                }
+                        }
+
+                        f32 t[3] = { -1.0f, -1.0f, -1.0f };
+                        size_t index[3] = { count, count, count };
+                        bool hit[3] = {
+                                ray_intersect_triangles(&r, &tris, t_max, &t[0], &index[0]),
+                                ray_intersect_spheres(&r, &spheres, t_max, &t[1], &index[1]),
+                                ray_intersect_aabbs(&r, &boxes, t_max, &t[2], &index[2])
+                        };
+
+                        static const char *names[3] = { "triangles", "spheres", "aabbs" };
+                        for (int j = 0; j < 3; ++j) {
+                                TEST_CHECK(same_hit(hit[j], t[j], ref_hit[j], ref[j]),
+                                           "ray_intersect_%s count %zu ray %d: hit %d t %.9g, expected %d %.9g",
+                                           names[j], count, k, hit[j], t[j], ref_hit[j], ref[j]);
+                                if (hit[j] && ref_hit[j] && packet_tol == 0.0f)
+                                        TEST_CHECK(index[j] == ref_index[j], "ray_intersect_%s count %zu ray %d: index %zu, expected %zu",
+                                                   names[j], count, k, index[j], ref_index[j]);
+                        }
+                }
+
+                vec3_soa_destroy(&tris.v0);
+                vec3_soa_destroy(&tris.v1);
+                vec3_soa_destroy(&tris.v2);
+                vec4_soa_destroy(&spheres);
+                vec3_soa_destroy(&boxes.min);
+                vec3_soa_destroy(&boxes.max);
+        }
+}
+
+/** @brief The rays of a packet against one object, misses give INFINITY and nothing is written past count. */
+static void test_packets(void) {
+        static const size_t counts[] = { 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100 };
+        aabb b = { { -1.0f, -0.5f, -2.0f }, { 1.5f, 1.0f, 0.5f } };
+        sphere s = { { 0.5f, -0.5f, 0.25f }, 1.5f };
+        plane p = { 0.3f, -0.6f, 0.5f, 0.7f };
+
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+                size_t count = counts[c];
+                ray_soa r;
+                ray rays[100];
+                f32 t_max[100], t[101];
+                u32 hits[5];
+                size_t words = (count + 31) / 32;
+
+                TEST_CHECK(vec3_soa_create(&r.origin, count) && vec3_soa_create(&r.direction, count), "create %zu", count);
+
+                for (size_t i = 0; i < count; ++i) {
+                        rays[i] = random_ray();
+                        t_max[i] = i % 3 == 0 ? test_uniform(0.5f, 6.0f) : INFINITY;
+                        r.origin.x[i] = rays[i].origin.x;
+                        r.origin.y[i] = rays[i].origin.y;
+                        r.origin.z[i] = rays[i].origin.z;
+                        r.direction.x[i] = rays[i].direction.x;
+                        r.direction.y[i] = rays[i].direction.y;
+                        r.direction.z[i] = rays[i].direction.z;
+                }
+
+                // Rays that hit the padding of the last register would set bits past count.
+                for (size_t i = count; i < r.origin.capacity; ++i) {
+                        r.origin.x[i] = 0.0f;
+                        r.direction.z[i] = 1.0f;
+                }
+
+                for (int o = 0; o < 3; ++o) {
+                        static const char *names[3] = { "aabb", "sphere", "plane" };
+
+                        for (size_t i = 0; i <= count; ++i)
+                                t[i] = -1.0f;
+                        memset(hits, 0xff, sizeof(hits));
+
+                        if (o == 0)
+                                ray_soa_intersect_aabb(&r, &b, t_max, t, hits);
+                        else if (o == 1)
+                                ray_soa_intersect_sphere(&r, &s, t_max, t, hits);
+                        else
+                                ray_soa_intersect_plane(&r, &p, t_max, t, hits);
+
+                        for (size_t i = 0; i < count; ++i) {
+                                f32 t_ref = -1.0f;
+                                bool hit_ref = o == 0 ? ray_intersect_aabb(&rays[i], &b, t_max[i], &t_ref)
+                                             : o == 1 ? ray_intersect_sphere(&rays[i], &s, t_max[i], &t_ref)
+                                             : ray_intersect_plane(&rays[i], &p, t_max[i], &t_ref);
+                                bool hit = (hits[i / 32] >> (i % 32)) & 1;
+
+                                TEST_CHECK(same_hit(hit, t[i], hit_ref, t_ref),
+                                           "ray_soa_intersect_%s count %zu ray %zu: hit %d t %.9g, expected %d %.9g",
+                                           names[o], count, i, hit, t[i], hit_ref, t_ref);
+                                if (!hit)
+                                        TEST_CHECK(t[i] == INFINITY, "ray_soa_intersect_%s count %zu ray %zu: miss t %.9g",
+                                                   names[o], count, i, t[i]);
+                        }
+
+                        TEST_CHECK(t[count] == -1.0f, "ray_soa_intersect_%s count %zu: t written past count", names[o], count);
+                        if (count % 32)
+                                TEST_CHECK((hits[words - 1] >> (count % 32)) == 0, "ray_soa_intersect_%s count %zu: bits past count",
+                                           names[o], count);
+                        TEST_CHECK(hits[words] == 0xffffffffu, "ray_soa_intersect_%s count %zu: word past the mask", names[o], count);
+
+                        // t can be NULL, the mask stays the same.
+                        u32 hits_only[5];
+                        memset(hits_only, 0xff, sizeof(hits_only));
+                        if (o == 0)
+                                ray_soa_intersect_aabb(&r, &b, t_max, NULL, hits_only);
+                        else if (o == 1)
+                                ray_soa_intersect_sphere(&r, &s, t_max, NULL, hits_only);
+                        else
+                                ray_soa_intersect_plane(&r, &p, t_max, NULL, hits_only);
+                        TEST_CHECK(memcmp(hits, hits_only, words * sizeof(u32)) == 0, "ray_soa_intersect_%s count %zu: mask without t",
+                                   names[o], count);
+                }
+
+                vec3_soa_destroy(&r.origin);
+                vec3_soa_destroy(&r.direction);
+        }
+}
+
+int main(void) {
+        int skip = test_begin("ray");
+        if (skip)
+                return skip;
+
+        smath_isa isa = smath_get_kernels()->isa;
+        packet_tol = isa == SMATH_ISA_AVX2 || isa == SMATH_ISA_AVX512 ? FMA_TOL : 0.0f;
+
+        test_triangle();
+        test_aabb();
+        test_sphere();
+        test_plane();
+        test_nearest();
+        test_packets();
+        return test_end();
+}
@@ -0,0 +1,242 @@
+/*
+ * Linear blend and dual quaternion skinning against a reference built
+ * from the mat4x4 and quat functions: the palette conversions, odd vertex
+ * counts so the kernels end in a partial step, without normals and in
+ * place.
+ */
+
+#include "test.h"
+
+#define BONES 24
+#define MAX_N 1001
+#define TOL 1e-4f
+
+static mat4x4 world[BONES], inverse_bind[BONES], skin[BONES];
+static quat rotation[BONES];            // The rotation of skin[i], for the dual quaternion reference
+static mat3x4 palette[BONES];
+static dual_quat dq_palette[BONES];
+
+static skin_influence influences[MAX_N];
+static vec3 positions[MAX_N], normals[MAX_N];
+static vec3 ref_positions[MAX_N], ref_normals[MAX_N];
+static vec3 out_positions[MAX_N], out_normals[MAX_N];
+
+static quat random_quat(void) {
+        quat q;
+        f32 len;
+
+        do {
+                test_fill(&q.x, 4, -1.0f, 1.0f);
+                len = sqrtf(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+        } while (len < 0.1f);
+
+        return (quat){ q.x / len, q.y / len, q.z / len, q.w / len };
+}
+
+/** @brief Bones with a random world and bind pose, scaled ones for linear skinning. */
+static void random_bones(bool scaled) {
+        for (int b = 0; b < BONES; ++b) {
+                vec3 tw, tb, s = { 1.0f, 1.0f, 1.0f }, one = { 1.0f, 1.0f, 1.0f };
+                quat rw = random_quat(), rb = random_quat();
+
+                test_fill(&tw.x, 3, -5.0f, 5.0f);
+                test_fill(&tb.x, 3, -5.0f, 5.0f);
+                if (scaled)
+                        test_fill(&s.x, 3, 0.5f, 2.0f);
+
+                mat4x4 bind = mat4x4_from_trs(&tb, &rb, &one);
+                world[b] = mat4x4_from_trs(&tw, &rw, &s);
+                inverse_bind[b] = mat4x4_inverse_rigid(&bind);
+                skin[b] = mat4x4_mult(&world[b], &inverse_bind[b]);
+
+                quat rb_inv = quat_conjugate(&rb);
+                rotation[b] = quat_mult(&rw, &rb_inv);
+        }
+
+        skin_palette_from_mat4x4(palette, world, inverse_bind, BONES);
+        skin_palette_to_dual_quat(dq_palette, palette, BONES);
+}
+
+/** @brief 1 to 4 bones per vertex with weights summing to 1, unused slots at weight 0 on any bone. */
+static void random_vertices(size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                skin_influence *s = &influences[i];
+                int used = 1 + (int)(test_rand() % 4);
+                f32 sum = 0.0f;
+
+                for (int k = 0; k < 4; ++k) {
+                        s->bone[k] = (u16)(test_rand() % BONES);
+                        s->weight[k] = k < used ? test_uniform(0.1f, 1.0f) : 0.0f;
+                        sum += s->weight[k];
+                }
+                for (int k = 0; k < 4; ++k)
+                        s->weight[k] /= sum;
+
+                test_fill(&positions[i].x, 3, -3.0f, 3.0f);
+                test_fill(&normals[i].x, 3, -1.0f, 1.0f);
+        }
+}
+
+static void test_palette(void) {
+        for (int b = 0; b < BONES; ++b) {
+                bool same = true;
+                for (int c = 0; c < 4; ++c) {
+                        vec3 col = { skin[b].t[0][c], skin[b].t[1][c], skin[b].t[2][c] };
+                        same = same && test_close_n(&palette[b].t[c].x, &col.x, 3, TOL);
+                }
+                TEST_CHECK(same, "skin_palette_from_mat4x4 bone %d", b);
+        }
+}
+
+/** @brief The real part is the rotation up to the sign, the dual part 0.5 * (t, 0) * real with the same sign. */
+static void test_dual_quat_palette(void) {
+        for (int b = 0; b < BONES; ++b) {
+                const dual_quat *dq = &dq_palette[b];
+                f32 sign = dq->real.x * rotation[b].x + dq->real.y * rotation[b].y + dq->real.z * rotation[b].z +
+                           dq->real.w * rotation[b].w < 0.0f ? -1.0f : 1.0f;
+                quat r = { sign * rotation[b].x, sign * rotation[b].y, sign * rotation[b].z, sign * rotation[b].w };
+                quat t = { 0.5f * skin[b].t[0][3], 0.5f * skin[b].t[1][3], 0.5f * skin[b].t[2][3], 0.0f };
+                quat d = quat_mult(&t, &r);
+
+                TEST_CHECK(test_close_n(&dq->real.x, &r.x, 4, TOL), "dual_quat_from_mat3x4 bone %d real", b);
+                TEST_CHECK(test_close_n(&dq->dual.x, &d.x, 4, TOL), "dual_quat_from_mat3x4 bone %d dual", b);
+        }
+}
+
+/** @brief The weighted sum of the mat4x4 skinning matrices times (p, 1) and (n, 0). */
+static void reference_linear(size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                const skin_influence *s = &influences[i];
+                mat4x4 m = { 0 };
+
+                for (int k = 0; k < 4; ++k)
+                        for (int r = 0; r < 4; ++r)
+                                for (int c = 0; c < 4; ++c)
+                                        m.t[r][c] += s->weight[k] * skin[s->bone[k]].t[r][c];
+
+                vec4 p = mat4x4_vec4_mult(&m, &(vec4){ positions[i].x, positions[i].y, positions[i].z, 1.0f });
+                vec4 d = mat4x4_vec4_mult(&m, &(vec4){ normals[i].x, normals[i].y, normals[i].z, 0.0f });
+                ref_positions[i] = (vec3){ p.x, p.y, p.z };
+                ref_normals[i] = (vec3){ d.x, d.y, d.z };
+        }
+}
+
+/**
+ * @brief Blend the dual quaternions on the side of the first bone and normalize.
+ *
+ * The position is the blended rotation applied to p plus the translation
+ * 2 * dual * conjugate(real), the normal only rotates.
+ */
+static void reference_dual_quat(size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+                const skin_influence *s = &influences[i];
+                const quat *q0 = &rotation[s->bone[0]];
+                quat r = { 0 }, d = { 0 };
+
+                for (int k = 0; k < 4; ++k) {
+                        const quat *q = &rotation[s->bone[k]];
+                        f32 w = q0->x * q->x + q0->y * q->y + q0->z * q->z + q0->w * q->w < 0.0f ? -s->weight[k] : s->weight[k];
+                        quat t = { 0.5f * skin[s->bone[k]].t[0][3], 0.5f * skin[s->bone[k]].t[1][3], 0.5f * skin[s->bone[k]].t[2][3], 0.0f };
+                        quat dual = quat_mult(&t, q);
+
+                        r.x += w * q->x; r.y += w * q->y; r.z += w * q->z; r.w += w * q->w;
+                        d.x += w * dual.x; d.y += w * dual.y; d.z += w * dual.z; d.w += w * dual.w;
+                }
+
+                f32 len = sqrtf(r.x * r.x + r.y * r.y + r.z * r.z + r.w * r.w);
+                r = (quat){ r.x / len, r.y / len, r.z / len, r.w / len };
+                d = (quat){ d.x / len, d.y / len, d.z / len, d.w / len };
+
+                quat rc = quat_conjugate(&r);
+                quat t = quat_mult(&d, &rc);
+                vec3 p = quat_rotate_vec3(&r, &positions[i]);
+
+                ref_positions[i] = (vec3){ p.x + 2.0f * t.x, p.y + 2.0f * t.y, p.z + 2.0f * t.z };
+                ref_normals[i] = quat_rotate_vec3(&r, &normals[i]);
+        }
+}
+
+static void run(bool dual, const vec3 *in_p, const vec3 *in_n, vec3 *out_p, vec3 *out_n, size_t n) {
+        if (dual)
+                skin_dual_quat(dq_palette, influences, in_p, in_n, out_p, out_n, n);
+        else
+                skin_linear(palette, influences, in_p, in_n, out_p, out_n, n);
+}
+
+static void test_skin(bool dual) {
+        static const size_t counts[] = { 1, 3, 5, 7, 17, 1001 };
+        const char *name = dual ? "skin_dual_quat" : "skin_linear";
+
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+                size_t n = counts[c];
+
+                random_vertices(n);
+                if (dual)
+                        reference_dual_quat(n);
+                else
+                        reference_linear(n);
+
+                // Into other arrays, the vertex after n stays untouched.
+                memset(out_positions, 0, sizeof(out_positions));
+                memset(out_normals, 0, sizeof(out_normals));
+                run(dual, positions, normals, out_positions, out_normals, n);
+
+                for (size_t i = 0; i < n; ++i) {
+                        TEST_CHECK(test_close_n(&out_positions[i].x, &ref_positions[i].x, 3, TOL), "%s n %zu vertex %zu position", name, n, i);
+                        TEST_CHECK(test_close_n(&out_normals[i].x, &ref_normals[i].x, 3, TOL), "%s n %zu vertex %zu normal", name, n, i);
+                }
+                if (n < MAX_N)
+                        TEST_CHECK(out_positions[n].x == 0.0f && out_normals[n].x == 0.0f, "%s n %zu: wrote past n", name, n);
+
+                // Without normals the positions are the same and the normals untouched.
+                vec3 with_normals[MAX_N];
+                memcpy(with_normals, out_positions, n * sizeof(vec3));
+                memset(out_normals, 0, sizeof(out_normals));
+                run(dual, positions, NULL, out_positions, out_normals, n);
+                TEST_CHECK(test_same_n(&out_positions[0].x, &with_normals[0].x, 3 * n), "%s n %zu without normals", name, n);
+                TEST_CHECK(out_normals[0].x == 0.0f && out_normals[n - 1].z == 0.0f, "%s n %zu: normals written", name, n);
+
+                // In place gives the same bits.
+                run(dual, positions, normals, positions, normals, n);
+                TEST_CHECK(test_same_n(&positions[0].x, &with_normals[0].x, 3 * n), "%s n %zu positions in place", name, n);
+                for (size_t i = 0; i < n; ++i)
+                        TEST_CHECK(test_close_n(&normals[i].x, &ref_normals[i].x, 3, TOL), "%s n %zu vertex %zu normal in place", name, n, i);
+        }
+}
+
+/** @brief With all the weight on one bone both skinnings are the rigid bone transform. */
+static void test_single_bone(void) {
+        size_t n = 33;
+
+        random_vertices(n);
+        for (size_t i = 0; i < n; ++i) {
+                influences[i].weight[0] = 1.0f;
+                influences[i].weight[1] = influences[i].weight[2] = influences[i].weight[3] = 0.0f;
+        }
+
+        reference_linear(n);
+        skin_dual_quat(dq_palette, influences, positions, normals, out_positions, out_normals, n);
+        for (size_t i = 0; i < n; ++i) {
+                TEST_CHECK(test_close_n(&out_positions[i].x, &ref_positions[i].x, 3, TOL), "skin_dual_quat one bone vertex %zu", i);
+                TEST_CHECK(test_close_n(&out_normals[i].x, &ref_normals[i].x, 3, TOL), "skin_dual_quat one bone normal %zu", i);
+        }
+}
+
+int main(void) {
+        int skip = test_begin("skinning");
+        if (skip)
+                return skip;
+
+        random_bones(true);
+        test_palette();
+        test_skin(false);
+
+        random_bones(false);
+        test_palette();
+        test_dual_quat_palette();
+        test_skin(false);
+        test_skin(true);
+        test_single_bone();
+
+        return test_end();
+}
@@ -0,0 +1,245 @@
+/*
+ * The structure of arrays vectors (vector_soa.h) against the vec3 and
+ * vec4 functions, for counts that end in a partial register. The padding
+ * past count is filled with a sentinel first, no kernel may write it and
+ * no kernel may write out[] past count.
+ */
+
+#include "test.h"
+
+#define MAX_N 1001
+#define TOL 1e-5f
+#define SENTINEL 12345.0f
+
+static const size_t counts[] = { 1, 3, 5, 7, 15, 17, 33, 100, MAX_N };
+
+static vec3 a3[MAX_N], b3[MAX_N], out3[MAX_N];
+static vec4 a4[MAX_N], b4[MAX_N], out4[MAX_N];
+static f32 s[MAX_N], out[MAX_N + 1];
+
+/** @brief Fill count to capacity of every array with SENTINEL. */
+static void fill_padding(f32 **arrays, int k, size_t count, size_t capacity) {
+        for (int c = 0; c < k; ++c) {
+                for (size_t i = count; i < capacity; ++i)
+                        arrays[c][i] = SENTINEL;
+        }
+}
+
+/** @brief count to capacity of every array is still SENTINEL. */
+static bool padding_kept(f32 **arrays, int k, size_t count, size_t capacity) {
+        for (int c = 0; c < k; ++c) {
+                for (size_t i = count; i < capacity; ++i) {
+                        if (arrays[c][i] != SENTINEL)
+                                return false;
+                }
+        }
+        return true;
+}
+
+static void test_vec3(size_t n) {
+        vec3_soa a, b;
+        TEST_CHECK(vec3_soa_create(&a, n) && vec3_soa_create(&b, n), "vec3_soa_create %zu", n);
+        TEST_CHECK(a.capacity % SMATH_SOA_WIDTH == 0 && a.capacity >= n, "vec3_soa capacity %zu", (size_t)a.capacity);
+
+        f32 *pa[] = { a.x, a.y, a.z };
+        size_t cap = a.capacity;
+
+        test_fill(&a3[0].x, 3 * n, -10.0f, 10.0f);
+        test_fill(&b3[0].x, 3 * n, -10.0f, 10.0f);
+        test_fill(s, n, -2.0f, 2.0f);
+
+        // Add, sub and scalar_mult do the same single operation, bit for bit.
+        vec3_soa_from_aos(&a, a3, n);
+        vec3_soa_from_aos(&b, b3, n);
+        fill_padding(pa, 3, n, cap);
+        vec3_soa_add(&a, &b);
+        vec3_soa_to_aos(out3, &a);
+        bool same = true;
+        for (size_t i = 0; i < n; ++i) {
+                vec3 r = a3[i];
+                vec3_add(&r, &b3[i]);
+                same = same && test_same_n(&out3[i].x, &r.x, 3);
+        }
+        TEST_CHECK(same, "vec3_soa_add %zu", n);
+        TEST_CHECK(padding_kept(pa, 3, n, cap), "vec3_soa_add %zu padding", n);
+
+        vec3_soa_from_aos(&a, a3, n);
+        vec3_soa_sub(&a, &b);
+        vec3_soa_to_aos(out3, &a);
+        same = true;
+        for (size_t i = 0; i < n; ++i) {
+                vec3 r = a3[i];
+                vec3_sub(&r, &b3[i]);
+                same = same && test_same_n(&out3[i].x, &r.x, 3);
+        }
+        TEST_CHECK(same, "vec3_soa_sub %zu", n);
+        TEST_CHECK(padding_kept(pa, 3, n, cap), "vec3_soa_sub %zu padding", n);
+
+        vec3_soa_from_aos(&a, a3, n);
+        vec3_soa_scalar_mult(&a, s[0]);
+        vec3_soa_to_aos(out3, &a);
+        same = true;
+        for (size_t i = 0; i < n; ++i) {
+                vec3 r = a3[i];
+                vec3_scalar_mult(&r, s[0]);
+                same = same && test_same_n(&out3[i].x, &r.x, 3);
+        }
+        TEST_CHECK(same, "vec3_soa_scalar_mult %zu", n);
+        TEST_CHECK(padding_kept(pa, 3, n, cap), "vec3_soa_scalar_mult %zu padding", n);
+
+        // Dot and magnitude may contract into FMA, out[n] is one past count.
+        vec3_soa_from_aos(&a, a3, n);
+        out[n] = SENTINEL;
+        vec3_soa_dot(&a, &b, out);
+        same = true;
+        for (size_t i = 0; i < n; ++i)
+                same = same && test_close(out[i], vec3_dot(&a3[i], &b3[i]), TOL);
+        TEST_CHECK(same, "vec3_soa_dot %zu", n);
+        TEST_CHECK(out[n] == SENTINEL, "vec3_soa_dot %zu wrote past count", n);
+
+        vec3_soa_magnitude(&a, out);
+        same = true;
+        for (size_t i = 0; i < n; ++i)
+                same = same && test_close(out[i], vec3_magnitude(&a3[i]), TOL);
+        TEST_CHECK(same, "vec3_soa_magnitude %zu", n);
+        TEST_CHECK(out[n] == SENTINEL, "vec3_soa_magnitude %zu wrote past count", n);
+
+        vec3_soa_cross_product(&a, &a, &b);
+        vec3_soa_to_aos(out3, &a);
+        same = true;
+        for (size_t i = 0; i < n; ++i) {
+                vec3 r = vec3_cross_product(&a3[i], &b3[i]);
+                same = same && test_close_n(&out3[i].x, &r.x, 3, TOL);
+        }
+        TEST_CHECK(same, "vec3_soa_cross_product %zu", n);
+        TEST_CHECK(padding_kept(pa, 3, n, cap), "vec3_soa_cross_product %zu padding", n);
+
+        // A zero padding normalized would be NaN, a sentinel one would be 1 / sqrt(3).
+        vec3_soa_from_aos(&a, a3, n);
+        vec3_soa_normalize(&a);
+        vec3_soa_to_aos(out3, &a);
+        same = true;
+        for (size_t i = 0; i < n; ++i) {
+                vec3 r = a3[i];
+                vec3_normalize(&r);
+                same = same && test_close_n(&out3[i].x, &r.x, 3, TOL);
+        }
+        TEST_CHECK(same, "vec3_soa_normalize %zu", n);
+        TEST_CHECK(padding_kept(pa, 3, n, cap), "vec3_soa_normalize %zu padding", n);
+
+        vec3_soa_from_aos(&a, a3, n);
+        vec3_soa_fast_normalize(&a);
+        TEST_CHECK(padding_kept(pa, 3, n, cap), "vec3_soa_fast_normalize %zu padding", n);
+
+        vec3_soa_destroy(&a);
+        vec3_soa_destroy(&b);
+}
+
+static void test_vec4(size_t n) {
+        vec4_soa a, b, d;
+        TEST_CHECK(vec4_soa_create(&a, n) && vec4_soa_create(&b, n) && vec4_soa_create(&d, n),
+                   "vec4_soa_create %zu", n);
+
+        f32 *pa[] = { a.x, a.y, a.z, a.w };
+        f32 *pd[] = { d.x, d.y, d.z, d.w };
+        size_t cap = a.capacity;
+
+        test_fill(&a4[0].x, 4 * n, -10.0f, 10.0f);
+        test_fill(&b4[0].x, 4 * n, -10.0f, 10.0f);
+        test_fill(s, n, 0.0f, 1.0f);
+
+        vec4_soa_from_aos(&a, a4, n);
+        vec4_soa_from_aos(&b, b4, n);
+        fill_padding(pa, 4, n, cap);
+        vec4_soa_add(&a, &b);
+        vec4_soa_to_aos(out4, &a);
+        bool same = true;
+        for (size_t i = 0; i < n; ++i) {
+                vec4 r = a4[i];
+                vec4_add(&r, &b4[i]);
+                same = same && test_same_n(&out4[i].x, &r.x, 4);
+        }
+        TEST_CHECK(same, "vec4_soa_add %zu", n);
+        TEST_CHECK(padding_kept(pa, 4, n, cap), "vec4_soa_add %zu padding", n);
+
+        vec4_soa_from_aos(&a, a4, n);
+        vec4_soa_sub(&a, &b);
+        vec4_soa_to_aos(out4, &a);
+        same = true;
+        for (size_t i = 0; i < n; ++i) {
+                vec4 r = a4[i];
+                vec4_sub(&r, &b4[i]);
+                same = same && test_same_n(&out4[i].x, &r.x, 4);
+        }
+        TEST_CHECK(same, "vec4_soa_sub %zu", n);
+        TEST_CHECK(padding_kept(pa, 4, n, cap), "vec4_soa_sub %zu padding", n);
+
+        vec4_soa_from_aos(&a, a4, n);
+        vec4_soa_scalar_mult(&a, -1.5f);
+        vec4_soa_to_aos(out4, &a);
+        same = true;
+        for (size_t i = 0; i < n; ++i) {
+                vec4 r = a4[i];
+                vec4_scalar_mult(&r, -1.5f);
+                same = same && test_same_n(&out4[i].x, &r.x, 4);
+        }
+        TEST_CHECK(same, "vec4_soa_scalar_mult %zu", n);
+        TEST_CHECK(padding_kept(pa, 4, n, cap), "vec4_soa_scalar_mult %zu padding", n);
+
+        vec4_soa_from_aos(&a, a4, n);
+        out[n] = SENTINEL;
+        vec4_soa_dot(&a, &b, out);
+        same = true;
+        for (size_t i = 0; i < n; ++i)
+                same = same && test_close(out[i], vec4_dot(&a4[i], &b4[i]), TOL);
+        TEST_CHECK(same, "vec4_soa_dot %zu", n);
+        TEST_CHECK(out[n] == SENTINEL, "vec4_soa_dot %zu wrote past count", n);
+
+        vec4_soa_magnitude(&a, out);
+        same = true;
+        for (size_t i = 0; i < n; ++i)
+                same = same && test_close(out[i], vec4_magnitude(&a4[i]), TOL);
+        TEST_CHECK(same, "vec4_soa_magnitude %zu", n);
+        TEST_CHECK(out[n] == SENTINEL, "vec4_soa_magnitude %zu wrote past count", n);
+
+        vec4_soa_normalize(&a);
+        vec4_soa_to_aos(out4, &a);
+        same = true;
+        for (size_t i = 0; i < n; ++i) {
+                vec4 r = a4[i];
+                vec4_normalize(&r);
+                same = same && test_close_n(&out4[i].x, &r.x, 4, TOL);
+        }
+        TEST_CHECK(same, "vec4_soa_normalize %zu", n);
+        TEST_CHECK(padding_kept(pa, 4, n, cap), "vec4_soa_normalize %zu padding", n);
+
+        vec4_soa_from_aos(&a, a4, n);
+        vec4_soa_fast_normalize(&a);
+        TEST_CHECK(padding_kept(pa, 4, n, cap), "vec4_soa_fast_normalize %zu padding", n);
+
+        // The blends write dest, its padding has to stay too. The values are tested in test_quat.c.
+        vec4_soa_normalize(&b);
+        d.count = n;
+        fill_padding(pd, 4, n, cap);
+        quat_soa_nlerp(&d, &a, &b, s);
+        TEST_CHECK(padding_kept(pd, 4, n, cap), "quat_soa_nlerp %zu padding", n);
+        quat_soa_slerp(&d, &a, &b, s);
+        TEST_CHECK(padding_kept(pd, 4, n, cap), "quat_soa_slerp %zu padding", n);
+
+        vec4_soa_destroy(&a);
+        vec4_soa_destroy(&b);
+        vec4_soa_destroy(&d);
+}
+
+int main(void) {
+        int skip = test_begin("soa");
+        if (skip)
+                return skip;
+
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+                test_vec3(counts[c]);
+                test_vec4(counts[c]);
+        }
+
+        return test_end();
+}
@@ -0,0 +1,132 @@
+/*
+ * The vec4_sse_ functions against their portable versions in vector4.c and
+ * mat4x4_mult, mat4x4_vec4_mult (which run the SSE bodies) against the
+ * plain row times column products.
+ */
+
+#include "test.h"
+
+#define N 1000
+
+static vec4 v4(f32 x, f32 y, f32 z, f32 w) {
+        vec4 v = { x, y, z, w };
+        return v;
+}
+
+/** @brief The products in the order of the scalar template. */
+static mat4x4 ref_mult(const mat4x4 *a, const mat4x4 *b) {
+        mat4x4 m;
+
+        for (int i = 0; i < 4; ++i) {
+                for (int j = 0; j < 4; ++j)
+                        m.t[i][j] = a->t[i][0] * b->t[0][j] + a->t[i][1] * b->t[1][j] + a->t[i][2] * b->t[2][j] + a->t[i][3] * b->t[3][j];
+        }
+
+        return m;
+}
+
+static vec4 ref_vec4_mult(const mat4x4 *m, const vec4 *v) {
+        f32 r[4];
+
+        for (int i = 0; i < 4; ++i)
+                r[i] = m->t[i][0] * v->x + m->t[i][1] * v->y + m->t[i][2] * v->z + m->t[i][3] * v->w;
+
+        return v4(r[0], r[1], r[2], r[3]);
+}
+
+int main(void) {
+        int skip = test_begin("sse");
+        if (skip)
+                return skip;
+
+#ifdef SMATH_SSE
+        for (int i = 0; i < N; ++i) {
+                vec4 a, b, sse, ref;
+                test_fill(&a.x, 4, -1000.0f, 1000.0f);
+                test_fill(&b.x, 4, -1000.0f, 1000.0f);
+                f32 s = test_uniform(0.001f, 100.0f);
+
+                sse = a; ref = a;
+                vec4_sse_add(&sse, &b);
+                vec4_add(&ref, &b);
+                TEST_CHECK(test_same_n(&sse.x, &ref.x, 4), "vec4_sse_add %d", i);
+
+                sse = a; ref = a;
+                vec4_sse_sub(&sse, &b);
+                vec4_sub(&ref, &b);
+                TEST_CHECK(test_same_n(&sse.x, &ref.x, 4), "vec4_sse_sub %d", i);
+
+                sse = a; ref = a;
+                vec4_sse_scalar_mult(&sse, s);
+                vec4_scalar_mult(&ref, s);
+                TEST_CHECK(test_same_n(&sse.x, &ref.x, 4), "vec4_sse_scalar_mult %d", i);
+
+                sse = a; ref = a;
+                vec4_sse_scalar_div(&sse, s);
+                vec4_scalar_div(&ref, s);
+                TEST_CHECK(test_same_n(&sse.x, &ref.x, 4), "vec4_sse_scalar_div %d", i);
+
+                vec4 p = v4(fabsf(a.x), fabsf(a.y), fabsf(a.z), fabsf(a.w));
+                sse = p; ref = p;
+                vec4_sse_square_root(&sse);
+                vec4_square_root(&ref);
+                TEST_CHECK(test_same_n(&sse.x, &ref.x, 4), "vec4_sse_square_root %d", i);
+
+                // The horizontal sums add the lanes in another order, a few ulp apart.
+                f32 dot = vec4_dot(&a, &b);
+                f32 bound = 4e-7f * (fabsf(a.x * b.x) + fabsf(a.y * b.y) + fabsf(a.z * b.z) + fabsf(a.w * b.w));
+                TEST_CHECK(fabsf(vec4_sse_dot(&a, &b) - dot) <= bound, "vec4_sse_dot %d: %g %g", i, vec4_sse_dot(&a, &b), dot);
+
+                TEST_CHECK(test_close(vec4_sse_magnitude(&a), vec4_magnitude(&a), 4e-7f), "vec4_sse_magnitude %d", i);
+
+                sse = a; ref = a;
+                vec4_sse_normalize(&sse);
+                vec4_normalize(&ref);
+                TEST_CHECK(test_close_n(&sse.x, &ref.x, 4, 6e-7f), "vec4_sse_normalize %d", i);
+        }
+
+        // Special values go through the lanes unchanged.
+        vec4 inf = v4(INFINITY, -INFINITY, NAN, 0.0f), one = v4(1.0f, 1.0f, 1.0f, -0.0f);
+        vec4 sse = inf, ref = inf;
+        vec4_sse_add(&sse, &one);
+        vec4_add(&ref, &one);
+        TEST_CHECK(test_same_n(&sse.x, &ref.x, 4), "vec4_sse_add special values");
+
+        sse = v4(0.0f, 0.0f, 0.0f, 0.0f);
+        vec4_sse_normalize(&sse);
+        TEST_CHECK(isnan(sse.x) && isnan(sse.w), "vec4_sse_normalize of 0 is NaN like vec4_normalize");
+#endif
+
+        // The SSE bodies sum in the scalar order, the results are the same bits.
+        for (int i = 0; i < N; ++i) {
+                mat4x4 a, b;
+                vec4 v;
+                test_fill(&a.t[0][0], 16, -10.0f, 10.0f);
+                test_fill(&b.t[0][0], 16, -10.0f, 10.0f);
+                test_fill(&v.x, 4, -10.0f, 10.0f);
+
+                mat4x4 m = mat4x4_mult(&a, &b), r = ref_mult(&a, &b);
+                TEST_CHECK(test_same_n(&m.t[0][0], &r.t[0][0], 16), "mat4x4_mult %d", i);
+
+                vec4 mv = mat4x4_vec4_mult(&a, &v), rv = ref_vec4_mult(&a, &v);
+                TEST_CHECK(test_same_n(&mv.x, &rv.x, 4), "mat4x4_vec4_mult %d", i);
+
+#ifdef SMATH_SSE
+                m = mat4x4_sse_mult(&a, &b);
+                TEST_CHECK(test_same_n(&m.t[0][0], &r.t[0][0], 16), "mat4x4_sse_mult %d", i);
+
+                mv = mat4x4_sse_vec4_mult(&a, &v);
+                TEST_CHECK(test_same_n(&mv.x, &rv.x, 4), "mat4x4_sse_vec4_mult %d", i);
+#endif
+        }
+
+        // dest aliasing an input, as in main.c.
+        mat4x4 a, b;
+        test_fill(&a.t[0][0], 16, -1.0f, 1.0f);
+        test_fill(&b.t[0][0], 16, -1.0f, 1.0f);
+        mat4x4 r = ref_mult(&a, &b);
+        b = mat4x4_mult(&a, &b);
+        TEST_CHECK(test_same_n(&b.t[0][0], &r.t[0][0], 16), "mat4x4_mult into an input");
+
+        return test_end();
+}
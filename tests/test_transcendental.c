@@ -0,0 +1,279 @@
+/*
+ * The bounds of transcendental.h: every _array function in both accuracy
+ * tiers against libm in double, over fixed sweeps of the inputs and the
+ * special values.
+ */
+
+#include <float.h>
+
+#include "test.h"
+
+/** @brief The points of a sweep. */
+#define SWEEP 100003
+
+#define PI 3.14159265358979323846
+
+static f32 in0[SWEEP], in1[SWEEP], out0[SWEEP], out1[SWEEP];
+
+/** @brief The spacing of the floats at the double r, the denormal spacing below FLT_MIN. */
+static f64 ulp(f64 r) {
+        r = fabs(r);
+        return r < FLT_MIN ? ldexp(1.0, -149) : ldexp(1.0, ilogb(r) - 23);
+}
+
+/** @brief The error of f against r in ulp of r. */
+static f64 ulp_error(f32 f, f64 r) {
+        if (isinf(r))
+                return f == r ? 0.0 : INFINITY;
+        return fabs((f64)f - r) / ulp(r);
+}
+
+/** @brief Fill n floats from lo to hi, both included. */
+static void sweep(f32 *f, size_t n, f64 lo, f64 hi) {
+        for (size_t i = 0; i < n; ++i)
+                f[i] = (f32)(lo + (hi - lo) * (f64)i / (f64)(n - 1));
+}
+
+/** @brief Fill n floats from lo to hi evenly spaced in the bits, so every exponent gets its share. */
+static void sweep_bits(f32 *f, size_t n, f32 lo, f32 hi) {
+        u32 a, b;
+        memcpy(&a, &lo, sizeof(a));
+        memcpy(&b, &hi, sizeof(b));
+        for (size_t i = 0; i < n; ++i) {
+                u32 u = a + (u32)((f64)(b - a) * (f64)i / (f64)(n - 1));
+                memcpy(&f[i], &u, sizeof(u));
+        }
+}
+
+static const char *tier_name(smath_accuracy acc) {
+        return acc == SMATH_ACCURACY_HIGH ? "high" : "fast";
+}
+
+/** @brief Keep the largest error and where it was. */
+typedef struct worst {
+        f64 error;
+        f32 x, y;
+} worst;
+
+static void update(worst *w, f64 error, f32 x, f32 y) {
+        if (error > w->error || isnan(error)) {
+                w->error = error;
+                w->x = x;
+                w->y = y;
+        }
+}
+
+static void test_sincos(smath_accuracy acc) {
+        const bool high = acc == SMATH_ACCURACY_HIGH;
+        worst s_ulp = { 0 }, c_ulp = { 0 }, s_abs = { 0 }, c_abs = { 0 };
+
+        // ulp on [-pi, pi] for the high tier, absolute up to 8192.
+        for (int pass = 0; pass < 2; ++pass) {
+                f64 range = pass == 0 ? PI : 8192.0;
+                sweep(in0, SWEEP, -range, range);
+                smath_sin_array(out0, in0, SWEEP, acc);
+                smath_cos_array(out1, in0, SWEEP, acc);
+
+                for (size_t i = 0; i < SWEEP; ++i) {
+                        f64 s = sin((f64)in0[i]), c = cos((f64)in0[i]);
+                        if (pass == 0) {
+                                update(&s_ulp, ulp_error(out0[i], s), in0[i], 0.0f);
+                                update(&c_ulp, ulp_error(out1[i], c), in0[i], 0.0f);
+                        }
+                        update(&s_abs, fabs(out0[i] - s), in0[i], 0.0f);
+                        update(&c_abs, fabs(out1[i] - c), in0[i], 0.0f);
+                }
+
+                // sincos is the same evaluation.
+                static f32 s[SWEEP], c[SWEEP];
+                smath_sincos_array(s, c, in0, SWEEP, acc);
+                TEST_CHECK(test_same_n(s, out0, SWEEP) && test_same_n(c, out1, SWEEP),
+                           "smath_sincos_array %s is not smath_sin_array and smath_cos_array", tier_name(acc));
+        }
+
+        printf("  sin %s: %.3g ulp at %g, %.3g absolute at %g\n", tier_name(acc), s_ulp.error, s_ulp.x, s_abs.error, s_abs.x);
+        printf("  cos %s: %.3g ulp at %g, %.3g absolute at %g\n", tier_name(acc), c_ulp.error, c_ulp.x, c_abs.error, c_abs.x);
+
+        if (high) {
+                TEST_CHECK(s_ulp.error <= 2.0, "sin high %g ulp at %g", s_ulp.error, s_ulp.x);
+                TEST_CHECK(c_ulp.error <= 2.0, "cos high %g ulp at %g", c_ulp.error, c_ulp.x);
+                TEST_CHECK(s_abs.error <= 1e-7, "sin high %g at %g", s_abs.error, s_abs.x);
+                TEST_CHECK(c_abs.error <= 1e-7, "cos high %g at %g", c_abs.error, c_abs.x);
+        } else {
+                TEST_CHECK(s_abs.error <= 5e-5, "sin fast %g at %g", s_abs.error, s_abs.x);
+                TEST_CHECK(c_abs.error <= 5e-5, "cos fast %g at %g", c_abs.error, c_abs.x);
+        }
+
+        f32 special[] = { 0.0f, -0.0f, NAN, INFINITY, -INFINITY };
+        smath_sin_array(out0, special, 5, acc);
+        smath_cos_array(out1, special, 5, acc);
+        TEST_CHECK(out0[0] == 0.0f && out0[1] == 0.0f, "sin(+-0) %s", tier_name(acc));
+        TEST_CHECK(out1[0] == 1.0f && out1[1] == 1.0f, "cos(+-0) %s", tier_name(acc));
+        TEST_CHECK(isnan(out0[2]) && isnan(out1[2]), "sin and cos of NaN %s", tier_name(acc));
+}
+
+static void test_atan2(smath_accuracy acc) {
+        const bool high = acc == SMATH_ACCURACY_HIGH;
+        worst w_ulp = { 0 }, w_abs = { 0 };
+
+        // Every angle on circles of radius 2^-60 to 2^60, then densely past
+        // pi / 8 + k * pi / 4, where the reduction adds pi / 4.
+        for (int e = -60; e <= 60; e += 15) {
+                f64 radius = ldexp(1.0, e);
+                for (size_t i = 0; i < SWEEP; ++i) {
+                        f64 t = -PI + 2.0 * PI * (f64)i / (f64)(SWEEP - 1);
+                        if (e % 2)
+                                t = PI / 8.0 + PI / 4.0 * (f64)(i % 8) + 0.05 * (f64)i / (f64)(SWEEP - 1);
+                        in0[i] = (f32)(radius * sin(t));
+                        in1[i] = (f32)(radius * cos(t));
+                }
+                smath_atan2_array(out0, in0, in1, SWEEP, acc);
+
+                for (size_t i = 0; i < SWEEP; ++i) {
+                        f64 r = atan2((f64)in0[i], (f64)in1[i]);
+                        update(&w_ulp, ulp_error(out0[i], r), in0[i], in1[i]);
+                        update(&w_abs, fabs(out0[i] - r), in0[i], in1[i]);
+                }
+        }
+
+        printf("  atan2 %s: %.3g ulp at (%g, %g), %.3g absolute\n", tier_name(acc), w_ulp.error, w_ulp.x, w_ulp.y, w_abs.error);
+
+        if (high)
+                TEST_CHECK(w_ulp.error <= 3.0, "atan2 high %g ulp at (%g, %g)", w_ulp.error, w_ulp.x, w_ulp.y);
+        else
+                TEST_CHECK(w_abs.error <= 3e-5, "atan2 fast %g at (%g, %g)", w_abs.error, w_abs.x, w_abs.y);
+
+        // The zeros, huge values where min + max overflows, the infinities and NaN, as libm has them.
+        f32 v[] = { 0.0f, -0.0f, 1.0f, -1.0f, 2e38f, -3e38f, FLT_MAX, INFINITY, -INFINITY, NAN };
+        const int n = (int)(sizeof(v) / sizeof(v[0]));
+        for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                        in0[i * n + j] = v[i];
+                        in1[i * n + j] = v[j];
+                }
+        }
+        smath_atan2_array(out0, in0, in1, (size_t)(n * n), acc);
+        for (int k = 0; k < n * n; ++k) {
+                f64 r = atan2((f64)in0[k], (f64)in1[k]);
+                bool ok = isnan(r) ? isnan(out0[k]) : fabs(out0[k] - r) <= (high ? 3.0 * ulp(r) : 3e-5) &&
+                                                       !signbit(out0[k]) == !signbit(r);
+                TEST_CHECK(ok, "atan2(%g, %g) %s: %g, not %g", in0[k], in1[k], tier_name(acc), out0[k], r);
+        }
+}
+
+static void test_exp(smath_accuracy acc) {
+        const bool high = acc == SMATH_ACCURACY_HIGH;
+        worst w_ulp = { 0 }, w_rel = { 0 };
+
+        // From the denormal results to the overflow.
+        sweep(in0, SWEEP, -103.9, 88.7);
+        smath_exp_array(out0, in0, SWEEP, acc);
+
+        for (size_t i = 0; i < SWEEP; ++i) {
+                f64 r = exp((f64)in0[i]);
+                update(&w_ulp, ulp_error(out0[i], r), in0[i], 0.0f);
+                if (r >= FLT_MIN)
+                        update(&w_rel, fabs(out0[i] - r) / r, in0[i], 0.0f);
+        }
+
+        printf("  exp %s: %.3g ulp at %g, %.3g relative at %g\n", tier_name(acc), w_ulp.error, w_ulp.x, w_rel.error, w_rel.x);
+
+        if (high)
+                TEST_CHECK(w_ulp.error <= 2.0, "exp high %g ulp at %g", w_ulp.error, w_ulp.x);
+        else
+                TEST_CHECK(w_rel.error <= 2e-5, "exp fast %g at %g", w_rel.error, w_rel.x);
+
+        f32 special[] = { 0.0f, -0.0f, NAN, INFINITY, -INFINITY, 89.0f, 1000.0f, -110.0f, -1000.0f };
+        smath_exp_array(out0, special, 9, acc);
+        TEST_CHECK(out0[0] == 1.0f && out0[1] == 1.0f, "exp(+-0) %s", tier_name(acc));
+        TEST_CHECK(isnan(out0[2]), "exp(NaN) %s", tier_name(acc));
+        TEST_CHECK(out0[3] == INFINITY && out0[4] == 0.0f, "exp(+-inf) %s: %g %g", tier_name(acc), out0[3], out0[4]);
+        TEST_CHECK(out0[5] == INFINITY && out0[6] == INFINITY, "exp overflow %s: %g %g", tier_name(acc), out0[5], out0[6]);
+        TEST_CHECK(out0[7] == 0.0f && out0[8] == 0.0f, "exp underflow %s: %g %g", tier_name(acc), out0[7], out0[8]);
+}
+
+static void test_log(smath_accuracy acc) {
+        const bool high = acc == SMATH_ACCURACY_HIGH;
+        worst w_ulp = { 0 }, w_abs = { 0 };
+
+        // Every exponent, the denormals included.
+        sweep_bits(in0, SWEEP, ldexpf(1.0f, -149), FLT_MAX);
+        smath_log_array(out0, in0, SWEEP, acc);
+
+        for (size_t i = 0; i < SWEEP; ++i) {
+                f64 r = log((f64)in0[i]);
+                update(&w_ulp, ulp_error(out0[i], r), in0[i], 0.0f);
+                update(&w_abs, fabs(out0[i] - r), in0[i], 0.0f);
+        }
+
+        // Around 1, where the result goes to 0.
+        sweep(in0, SWEEP, 0.5, 2.0);
+        smath_log_array(out0, in0, SWEEP, acc);
+
+        for (size_t i = 0; i < SWEEP; ++i) {
+                f64 r = log((f64)in0[i]);
+                update(&w_ulp, ulp_error(out0[i], r), in0[i], 0.0f);
+                update(&w_abs, fabs(out0[i] - r), in0[i], 0.0f);
+        }
+
+        printf("  log %s: %.3g ulp at %g, %.3g absolute at %g\n", tier_name(acc), w_ulp.error, w_ulp.x, w_abs.error, w_abs.x);
+
+        if (high)
+                TEST_CHECK(w_ulp.error <= 1.0, "log high %g ulp at %g", w_ulp.error, w_ulp.x);
+        else
+                TEST_CHECK(w_abs.error <= 5e-5, "log fast %g at %g", w_abs.error, w_abs.x);
+
+        f32 special[] = { 1.0f, 0.0f, -0.0f, -1.0f, NAN, INFINITY, -INFINITY };
+        smath_log_array(out0, special, 7, acc);
+        TEST_CHECK(out0[0] == 0.0f, "log(1) %s: %g", tier_name(acc), out0[0]);
+        TEST_CHECK(out0[1] == -INFINITY && out0[2] == -INFINITY, "log(+-0) %s: %g %g", tier_name(acc), out0[1], out0[2]);
+        TEST_CHECK(isnan(out0[3]) && isnan(out0[4]) && isnan(out0[6]), "log of NaN and negative values %s", tier_name(acc));
+        TEST_CHECK(out0[5] == INFINITY, "log(inf) %s: %g", tier_name(acc), out0[5]);
+}
+
+static void test_pow(smath_accuracy acc) {
+        const bool high = acc == SMATH_ACCURACY_HIGH;
+        worst w_rel = { 0 };
+
+        // x from 2^-20 to 2^20 against y from -6 to 6, the results stay in range.
+        sweep_bits(in0, SWEEP, ldexpf(1.0f, -20), ldexpf(1.0f, 20));
+        for (size_t i = 0; i < SWEEP; ++i)
+                in1[i] = (f32)(-6.0 + 12.0 * (f64)((i * 7919) % SWEEP) / (f64)(SWEEP - 1));
+        smath_pow_array(out0, in0, in1, SWEEP, acc);
+
+        for (size_t i = 0; i < SWEEP; ++i) {
+                f64 r = pow((f64)in0[i], (f64)in1[i]);
+                f64 scale = 1.0 + fabs((f64)in1[i] * log((f64)in0[i]));
+                f64 bound = high ? 2.0 * FLT_EPSILON * scale : 1e-4 * scale;
+                update(&w_rel, fabs(out0[i] - r) / r / bound, in0[i], in1[i]);
+        }
+
+        printf("  pow %s: %.3g of the bound at (%g, %g)\n", tier_name(acc), w_rel.error, w_rel.x, w_rel.y);
+        TEST_CHECK(w_rel.error <= 1.0, "pow %s %g of the bound at (%g, %g)", tier_name(acc), w_rel.error, w_rel.x, w_rel.y);
+
+        f32 x[] = { 2.0f, 1.0f, NAN, 1.0f, 0.0f, 0.0f, -2.0f, 4.0f };
+        f32 y[] = { 0.0f, NAN, 0.0f, INFINITY, 2.0f, -2.0f, 2.0f, 0.5f };
+        smath_pow_array(out0, x, y, 8, acc);
+        TEST_CHECK(out0[0] == 1.0f && out0[1] == 1.0f && out0[2] == 1.0f && out0[3] == 1.0f, "pow(x, 0) and pow(1, y) %s", tier_name(acc));
+        TEST_CHECK(out0[4] == 0.0f && out0[5] == INFINITY, "pow(0, y) %s: %g %g", tier_name(acc), out0[4], out0[5]);
+        TEST_CHECK(isnan(out0[6]), "pow of a negative x %s: %g", tier_name(acc), out0[6]);
+        TEST_CHECK(fabs(out0[7] - 2.0) <= (high ? 4.0 * FLT_EPSILON : 1e-4), "pow(4, 0.5) %s: %g", tier_name(acc), out0[7]);
+}
+
+int main(void) {
+        int skip = test_begin("transcendental");
+        if (skip)
+                return skip;
+
+        smath_accuracy tiers[] = { SMATH_ACCURACY_HIGH, SMATH_ACCURACY_FAST };
+
+        for (int t = 0; t < 2; ++t) {
+                test_sincos(tiers[t]);
+                test_atan2(tiers[t]);
+                test_exp(tiers[t]);
+                test_log(tiers[t]);
+                test_pow(tiers[t]);
+        }
+
+        return test_end();
+}
@@ -0,0 +1,203 @@
+/*
+ * The value functions of vector_value.h (vec4v, mat4x4v) against the
+ * pointer functions of vector3.h, vector4.h and mat4x4.h, and the _array
+ * functions against a loop over the single ones.
+ */
+
+#include "test.h"
+
+#define N 1000
+#define COUNT 103
+#define TOL 4e-7f
+
+static bool same4(vec4v v, const vec4 *ref) {
+        vec4 r;
+        vec4_storev(&r, v);
+        return test_same_n(&r.x, &ref->x, 4);
+}
+
+static bool close4(vec4v v, const vec4 *ref, f32 tol) {
+        vec4 r;
+        vec4_storev(&r, v);
+        return test_close_n(&r.x, &ref->x, 4, tol);
+}
+
+static bool close3(vec4v v, const vec3 *ref, f32 tol) {
+        vec3 r;
+        vec3_storev(&r, v);
+        return test_close_n(&r.x, &ref->x, 3, tol);
+}
+
+static void test_vec4(void) {
+        for (int i = 0; i < N; ++i) {
+                vec4 a, b, r;
+                test_fill(&a.x, 4, -100.0f, 100.0f);
+                test_fill(&b.x, 4, -100.0f, 100.0f);
+                f32 s = test_uniform(0.01f, 10.0f);
+                vec4v va = vec4_loadv(&a), vb = vec4_loadv(&b);
+
+                TEST_CHECK(same4(va, &a), "vec4_loadv and vec4_storev %d", i);
+                TEST_CHECK(same4(vec4_setv(a.x, a.y, a.z, a.w), &a), "vec4_setv %d", i);
+
+                vec4 splat = { s, s, s, s };
+                TEST_CHECK(same4(vec4_splatv(s), &splat), "vec4_splatv %d", i);
+
+                r = a;
+                vec4_add(&r, &b);
+                TEST_CHECK(same4(vec4_addv(va, vb), &r), "vec4_addv %d", i);
+
+                r = a;
+                vec4_sub(&r, &b);
+                TEST_CHECK(same4(vec4_subv(va, vb), &r), "vec4_subv %d", i);
+
+                vec4 mul = { a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w };
+                TEST_CHECK(same4(vec4_mulv(va, vb), &mul), "vec4_mulv %d", i);
+
+                r = a;
+                vec4_scalar_mult(&r, s);
+                TEST_CHECK(same4(vec4_scalar_multv(va, s), &r), "vec4_scalar_multv %d", i);
+
+                r = a;
+                vec4_scalar_div(&r, s);
+                TEST_CHECK(close4(vec4_scalar_divv(va, s), &r, TOL), "vec4_scalar_divv %d", i);
+
+                vec4 p = { fabsf(a.x), fabsf(a.y), fabsf(a.z), fabsf(a.w) };
+                r = p;
+                vec4_square_root(&r);
+                TEST_CHECK(same4(vec4_square_rootv(vec4_loadv(&p)), &r), "vec4_square_rootv %d", i);
+
+                f32 dot = vec4_dot(&a, &b);
+                f32 bound = TOL * 4.0f * (fabsf(a.x * b.x) + fabsf(a.y * b.y) + fabsf(a.z * b.z) + fabsf(a.w * b.w));
+                TEST_CHECK(fabsf(vec4_dotv(va, vb) - dot) <= bound, "vec4_dotv %d: %g %g", i, vec4_dotv(va, vb), dot);
+                TEST_CHECK(test_close(vec4_magnitudev(va), vec4_magnitude(&a), TOL), "vec4_magnitudev %d", i);
+
+                r = a;
+                vec4_normalize(&r);
+                TEST_CHECK(close4(vec4_normalizev(va), &r, 2.0f * TOL), "vec4_normalizev %d", i);
+        }
+}
+
+static void test_vec3(void) {
+        for (int i = 0; i < N; ++i) {
+                // A guard after the vec3, vec3_storev must not write past it.
+                struct { vec3 v; f32 guard; } a = { { 0 }, 7.0f }, b = { { 0 }, 7.0f };
+                test_fill(&a.v.x, 3, -100.0f, 100.0f);
+                test_fill(&b.v.x, 3, -100.0f, 100.0f);
+                vec4v va = vec3_loadv(&a.v), vb = vec3_loadv(&b.v);
+
+                vec4 loaded;
+                vec4_storev(&loaded, va);
+                TEST_CHECK(test_same_n(&loaded.x, &a.v.x, 3) && loaded.w == 0.0f, "vec3_loadv %d", i);
+
+                vec3_storev(&b.v, va);
+                TEST_CHECK(test_same_n(&b.v.x, &a.v.x, 3) && b.guard == 7.0f, "vec3_storev %d", i);
+                test_fill(&b.v.x, 3, -100.0f, 100.0f);
+                vb = vec3_loadv(&b.v);
+
+                f32 dot = vec3_dot(&a.v, &b.v);
+                f32 bound = TOL * 4.0f * (fabsf(a.v.x * b.v.x) + fabsf(a.v.y * b.v.y) + fabsf(a.v.z * b.v.z));
+                TEST_CHECK(fabsf(vec3_dotv(va, vb) - dot) <= bound, "vec3_dotv %d", i);
+                TEST_CHECK(test_close(vec3_magnitudev(va), vec3_magnitude(&a.v), TOL), "vec3_magnitudev %d", i);
+
+                vec3 cross = vec3_cross_product(&a.v, &b.v);
+                f32 scale = vec3_magnitude(&a.v) * vec3_magnitude(&b.v);
+                vec3 c;
+                vec3_storev(&c, vec3_cross_productv(va, vb));
+                TEST_CHECK(fabsf(c.x - cross.x) <= 1e-6f * scale && fabsf(c.y - cross.y) <= 1e-6f * scale &&
+                           fabsf(c.z - cross.z) <= 1e-6f * scale, "vec3_cross_productv %d", i);
+
+                vec3 n = a.v;
+                vec3_normalize(&n);
+                TEST_CHECK(close3(vec3_normalizev(va), &n, 2.0f * TOL), "vec3_normalizev %d", i);
+        }
+}
+
+static void test_mat4x4(void) {
+        for (int i = 0; i < N; ++i) {
+                mat4x4 a, b, r;
+                vec4 v;
+                test_fill(&a.t[0][0], 16, -10.0f, 10.0f);
+                test_fill(&b.t[0][0], 16, -10.0f, 10.0f);
+                test_fill(&v.x, 4, -10.0f, 10.0f);
+                mat4x4v ma = mat4x4_loadv(&a), mb = mat4x4_loadv(&b);
+
+                mat4x4_storev(&r, ma);
+                TEST_CHECK(memcmp(&r, &a, sizeof(a)) == 0, "mat4x4_loadv and mat4x4_storev %d", i);
+
+                mat4x4 p = mat4x4_mult(&a, &b);
+                mat4x4_storev(&r, mat4x4_multv(ma, mb));
+                TEST_CHECK(test_close_n(&r.t[0][0], &p.t[0][0], 16, 1e-6f), "mat4x4_multv %d", i);
+
+                // The rows are summed in another order, bound each by the size of its terms.
+                vec4 mv = mat4x4_vec4_mult(&a, &v), rv;
+                vec4_storev(&rv, mat4x4_vec4_multv(ma, vec4_loadv(&v)));
+                bool rows = true;
+                for (int j = 0; j < 4; ++j) {
+                        f32 bound = 0.0f;
+                        for (int k = 0; k < 4; ++k)
+                                bound += fabsf(a.t[j][k] * (&v.x)[k]);
+                        rows &= fabsf((&rv.x)[j] - (&mv.x)[j]) <= TOL * 4.0f * bound;
+                }
+                TEST_CHECK(rows, "mat4x4_vec4_multv %d", i);
+
+                mat4x4_storev(&r, mat4x4_transposev(ma));
+                bool transposed = true;
+                for (int j = 0; j < 4; ++j) {
+                        for (int k = 0; k < 4; ++k)
+                                transposed &= r.t[j][k] == a.t[k][j];
+                }
+                TEST_CHECK(transposed, "mat4x4_transposev %d", i);
+        }
+}
+
+static void test_arrays(void) {
+        static vec4 a[COUNT], b[COUNT], out[COUNT];
+        static f32 dots[COUNT];
+        f32 s = 1.5f;
+
+        test_fill(&a[0].x, COUNT * 4, -100.0f, 100.0f);
+        test_fill(&b[0].x, COUNT * 4, -100.0f, 100.0f);
+
+        // Odd counts leave a tail after the vector loops.
+        for (size_t n = COUNT - 4; n <= COUNT; ++n) {
+                vec4_add_array(out, a, b, n);
+                for (size_t i = 0; i < n; ++i) {
+                        vec4 r = a[i];
+                        vec4_add(&r, &b[i]);
+                        TEST_CHECK(test_same_n(&out[i].x, &r.x, 4), "vec4_add_array %zu of %zu", i, n);
+                }
+
+                vec4_sub_array(out, a, b, n);
+                for (size_t i = 0; i < n; ++i) {
+                        vec4 r = a[i];
+                        vec4_sub(&r, &b[i]);
+                        TEST_CHECK(test_same_n(&out[i].x, &r.x, 4), "vec4_sub_array %zu of %zu", i, n);
+                }
+
+                vec4_scalar_mult_array(out, a, s, n);
+                for (size_t i = 0; i < n; ++i) {
+                        vec4 r = a[i];
+                        vec4_scalar_mult(&r, s);
+                        TEST_CHECK(test_same_n(&out[i].x, &r.x, 4), "vec4_scalar_mult_array %zu of %zu", i, n);
+                }
+
+                vec4_dot_array(dots, a, b, n);
+                for (size_t i = 0; i < n; ++i) {
+                        f32 dot = vec4_dot(&a[i], &b[i]);
+                        TEST_CHECK(fabsf(dots[i] - dot) <= 1e-4f * (1.0f + fabsf(dot)), "vec4_dot_array %zu of %zu", i, n);
+                }
+        }
+}
+
+int main(void) {
+        int skip = test_begin("value");
+        if (skip)
+                return skip;
+
+        test_vec4();
+        test_vec3();
+        test_mat4x4();
+        test_arrays();
+
+        return test_end();
+}